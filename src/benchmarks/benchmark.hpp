@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2015-2020, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * benchmark.hpp -- This file contains interface for creating benchmarks to the
@@ -33,6 +33,7 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include "benchmark_perf.hpp"
 #include "benchmark_time.hpp"
 #include "os.h"
 #include "rand.h"
@@ -45,6 +46,7 @@
 #define RRAND_R(rng, max, min) (rnd64_r(rng) % ((max) - (min)) + (min))
 
 struct benchmark;
+struct benchmark_hist;
 
 /*
  * benchmark_args - Arguments for benchmark.
@@ -69,6 +71,9 @@ struct benchmark_args {
 	unsigned seed;		 /* PRNG seed */
 	unsigned repeats;	 /* number of repeats of one scenario */
 	unsigned min_exe_time;	 /* minimal execution time */
+	uint64_t rate;		 /* target ops per second of each thread */
+	unsigned interval;	 /* time-series interval in msecs */
+	bool perf;		 /* collect hardware performance counters */
 	bool help;		 /* print help for benchmark */
 	void *opts;		 /* benchmark specific arguments */
 };
@@ -104,6 +109,8 @@ struct latency {
 	uint64_t pctl50_0p;
 	uint64_t pctl99_0p;
 	uint64_t pctl99_9p;
+	uint64_t pctl99_99p;
+	uint64_t pctl99_999p;
 };
 
 /*
@@ -112,7 +119,6 @@ struct latency {
 struct thread_results {
 	benchmark_time_t beg;
 	benchmark_time_t end;
-	benchmark_time_t end_op[];
 };
 
 /*
@@ -120,6 +126,10 @@ struct thread_results {
  */
 struct bench_results {
 	struct thread_results **thres;
+	struct benchmark_hist *hist;	   /* latencies of all threads */
+	struct benchmark_hist **intervals; /* latencies in each interval */
+	size_t nintervals;
+	struct benchmark_perf_counts perf; /* counters of all threads */
 };
 
 /*
@@ -132,6 +142,7 @@ struct total_results {
 	double nopsps;
 	struct results total;
 	struct latency latency;
+	struct benchmark_perf_counts perf; /* counters per operation */
 	struct bench_results *res;
 };
 
@@ -220,12 +231,15 @@ struct benchmark_clo {
  * worker_info - Worker thread's information structure.
  */
 struct worker_info {
-	size_t index;		       /* index of worker thread */
-	struct operation_info *opinfo; /* operation info structure */
-	size_t nops;		       /* number of operations */
-	void *priv;		       /* worker's private data */
-	benchmark_time_t beg;	       /* start time */
-	benchmark_time_t end;	       /* end time */
+	size_t index;			   /* index of worker thread */
+	struct operation_info *opinfo;	   /* operation info structure */
+	size_t nops;			   /* number of operations */
+	void *priv;			   /* worker's private data */
+	benchmark_time_t beg;		   /* start time */
+	benchmark_time_t end;		   /* end time */
+	struct benchmark_hist *hist;	   /* latency histogram */
+	struct benchmark_hist **intervals; /* latency histograms per interval */
+	size_t nintervals;		   /* number of intervals */
 };
 
 /*
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * benchmark_hist.cpp -- benchmark_hist module definitions
+ *
+ * Values below 2^sub_bits are counted exactly. Above that every power of two
+ * range is split into 2^(sub_bits - 1) buckets, so the width of a bucket is
+ * never bigger than 2^-(sub_bits - 1) of its values. The minimum, the maximum
+ * and the mean are tracked exactly, not derived from the buckets.
+ */
+#include "benchmark_hist.hpp"
+#include "util.h"
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+/* values of 2^HIST_MAX_BITS and above (~18 minutes in nsecs) are clamped */
+#define HIST_MAX_BITS 40
+#define HIST_MAX_DIGITS 5
+
+struct benchmark_hist {
+	unsigned sub_bits; /* log2 of the number of exact values */
+	size_t ncounts;	   /* number of buckets */
+	uint64_t count;	   /* number of recorded values */
+	uint64_t min;
+	uint64_t max;
+	double mean;
+	double m2; /* sum of squared differences from the mean */
+	uint64_t counts[];
+};
+
+/*
+ * hist_index -- (internal) index of the bucket of the value
+ */
+static inline size_t
+hist_index(const struct benchmark_hist *hist, uint64_t value)
+{
+	if (value >> HIST_MAX_BITS)
+		value = (1ULL << HIST_MAX_BITS) - 1;
+
+	if ((value >> hist->sub_bits) == 0)
+		return (size_t)value;
+
+	uint64_t half = 1ULL << (hist->sub_bits - 1);
+	unsigned shift = util_mssb_index64(value) - (hist->sub_bits - 1);
+	uint64_t sub = value >> shift;
+
+	return (size_t)((1ULL << hist->sub_bits) + (shift - 1) * half +
+			(sub - half));
+}
+
+/*
+ * hist_highest -- (internal) the highest value counted in the bucket
+ */
+static uint64_t
+hist_highest(const struct benchmark_hist *hist, size_t index)
+{
+	uint64_t nexact = 1ULL << hist->sub_bits;
+	if (index < nexact)
+		return index;
+
+	uint64_t half = nexact / 2;
+	uint64_t j = index - nexact;
+	unsigned shift = (unsigned)(j / half) + 1;
+	uint64_t sub = j % half + half;
+
+	return ((sub + 1) << shift) - 1;
+}
+
+/*
+ * benchmark_hist_alloc -- allocate histogram which keeps the given number
+ * of significant decimal digits of the recorded values
+ */
+struct benchmark_hist *
+benchmark_hist_alloc(unsigned digits)
+{
+	assert(digits > 0 && digits <= HIST_MAX_DIGITS);
+
+	uint64_t unit = 1;
+	for (unsigned i = 0; i < digits; i++)
+		unit *= 10;
+
+	unsigned bits = 0;
+	while ((1ULL << bits) < unit)
+		bits++;
+
+	unsigned sub_bits = bits + 1;
+	size_t ncounts = ((size_t)1 << sub_bits) +
+		(HIST_MAX_BITS - sub_bits) * ((size_t)1 << (sub_bits - 1));
+
+	auto *hist = (struct benchmark_hist *)malloc(
+		sizeof(struct benchmark_hist) + ncounts * sizeof(uint64_t));
+	if (hist == nullptr)
+		return nullptr;
+
+	hist->sub_bits = sub_bits;
+	hist->ncounts = ncounts;
+	benchmark_hist_reset(hist);
+
+	return hist;
+}
+
+/*
+ * benchmark_hist_free -- release histogram
+ */
+void
+benchmark_hist_free(struct benchmark_hist *hist)
+{
+	free(hist);
+}
+
+/*
+ * benchmark_hist_reset -- remove all recorded values
+ */
+void
+benchmark_hist_reset(struct benchmark_hist *hist)
+{
+	hist->count = 0;
+	hist->min = UINT64_MAX;
+	hist->max = 0;
+	hist->mean = 0.0;
+	hist->m2 = 0.0;
+	memset(hist->counts, 0, hist->ncounts * sizeof(hist->counts[0]));
+}
+
+/*
+ * benchmark_hist_record -- record a single value
+ */
+void
+benchmark_hist_record(struct benchmark_hist *hist, uint64_t value)
+{
+	hist->counts[hist_index(hist, value)]++;
+	hist->count++;
+
+	if (value < hist->min)
+		hist->min = value;
+	if (value > hist->max)
+		hist->max = value;
+
+	double delta = (double)value - hist->mean;
+	hist->mean += delta / (double)hist->count;
+	hist->m2 += delta * ((double)value - hist->mean);
+}
+
+/*
+ * benchmark_hist_merge -- add all values recorded in src to dst, both
+ * histograms must have the same precision
+ */
+int
+benchmark_hist_merge(struct benchmark_hist *dst,
+		     const struct benchmark_hist *src)
+{
+	if (dst->sub_bits != src->sub_bits)
+		return -1;
+
+	if (src->count == 0)
+		return 0;
+
+	for (size_t i = 0; i < dst->ncounts; i++)
+		dst->counts[i] += src->counts[i];
+
+	double n = (double)(dst->count + src->count);
+	double delta = src->mean - dst->mean;
+	dst->mean += delta * (double)src->count / n;
+	dst->m2 += src->m2 +
+		delta * delta * (double)dst->count * (double)src->count / n;
+	dst->count += src->count;
+
+	if (src->min < dst->min)
+		dst->min = src->min;
+	if (src->max > dst->max)
+		dst->max = src->max;
+
+	return 0;
+}
+
+/*
+ * benchmark_hist_count -- number of recorded values
+ */
+uint64_t
+benchmark_hist_count(const struct benchmark_hist *hist)
+{
+	return hist->count;
+}
+
+/*
+ * benchmark_hist_min -- the smallest recorded value
+ */
+uint64_t
+benchmark_hist_min(const struct benchmark_hist *hist)
+{
+	return hist->count ? hist->min : 0;
+}
+
+/*
+ * benchmark_hist_max -- the biggest recorded value
+ */
+uint64_t
+benchmark_hist_max(const struct benchmark_hist *hist)
+{
+	return hist->max;
+}
+
+/*
+ * benchmark_hist_mean -- mean of the recorded values
+ */
+double
+benchmark_hist_mean(const struct benchmark_hist *hist)
+{
+	return hist->mean;
+}
+
+/*
+ * benchmark_hist_std_dev -- standard deviation of the recorded values
+ */
+double
+benchmark_hist_std_dev(const struct benchmark_hist *hist)
+{
+	if (hist->count == 0)
+		return 0.0;
+
+	return sqrt(hist->m2 / (double)hist->count);
+}
+
+/*
+ * benchmark_hist_percentile -- the value below or equal to which the given
+ * percentage of the recorded values are
+ */
+uint64_t
+benchmark_hist_percentile(const struct benchmark_hist *hist, double pctl)
+{
+	if (hist->count == 0)
+		return 0;
+
+	/* rank of the value, the epsilon absorbs the rounding of pctl */
+	double rank = ceil(pctl / 100.0 * (double)hist->count - 1e-6);
+	uint64_t target = rank < 1.0 ? 1 : (uint64_t)rank;
+	if (target > hist->count)
+		target = hist->count;
+
+	uint64_t cumulative = 0;
+	size_t i;
+	for (i = 0; i < hist->ncounts; i++) {
+		cumulative += hist->counts[i];
+		if (cumulative >= target)
+			break;
+	}
+	assert(i < hist->ncounts);
+
+	uint64_t value = hist_highest(hist, i);
+	if (value > hist->max)
+		value = hist->max;
+	if (value < hist->min)
+		value = hist->min;
+
+	return value;
+}
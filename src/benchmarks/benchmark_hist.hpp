@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+/*
+ * benchmark_hist.hpp -- declarations of benchmark_hist module
+ *
+ * High dynamic range histogram of latencies: the values are counted in
+ * log-linear buckets which keep the given number of significant decimal
+ * digits, so the memory used does not depend on the number of recorded
+ * values and histograms of the same precision can be merged.
+ */
+
+#ifndef BENCHMARK_HIST_HPP
+#define BENCHMARK_HIST_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+struct benchmark_hist;
+
+struct benchmark_hist *benchmark_hist_alloc(unsigned digits);
+void benchmark_hist_free(struct benchmark_hist *hist);
+void benchmark_hist_reset(struct benchmark_hist *hist);
+void benchmark_hist_record(struct benchmark_hist *hist, uint64_t value);
+int benchmark_hist_merge(struct benchmark_hist *dst,
+			 const struct benchmark_hist *src);
+uint64_t benchmark_hist_count(const struct benchmark_hist *hist);
+uint64_t benchmark_hist_min(const struct benchmark_hist *hist);
+uint64_t benchmark_hist_max(const struct benchmark_hist *hist);
+double benchmark_hist_mean(const struct benchmark_hist *hist);
+double benchmark_hist_std_dev(const struct benchmark_hist *hist);
+uint64_t benchmark_hist_percentile(const struct benchmark_hist *hist,
+				   double pctl);
+
+#endif
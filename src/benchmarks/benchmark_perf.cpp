@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * benchmark_perf.cpp -- benchmark_perf module definitions
+ */
+#include "benchmark_perf.hpp"
+#include "os.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define PERF_MAX_EVENTS 64
+#define SYSFS_PMU_DIR "/sys/bus/event_source/devices"
+#define UNCORE_IMC_PREFIX "uncore_imc_"
+
+/* every CAS command of the memory controller transfers a cache line */
+#define CAS_BYTES 64.0
+
+const char *benchmark_perf_names[PERF_NCOUNTERS] = {
+	"cycles-per-op",      "instructions-per-op", "llc-misses-per-op",
+	"dtlb-misses-per-op", "mem-read-per-op[B]",  "mem-write-per-op[B]",
+};
+
+struct perf_event {
+	int fd;
+	enum benchmark_perf_counter counter;
+	double scale;
+};
+
+struct benchmark_perf {
+	size_t nevents;
+	struct perf_event events[PERF_MAX_EVENTS];
+};
+
+/*
+ * perf_add -- (internal) open the counter, disabled
+ */
+static int
+perf_add(struct benchmark_perf *perf, struct perf_event_attr *attr, pid_t pid,
+	 int cpu, enum benchmark_perf_counter counter, double scale)
+{
+	if (perf->nevents == PERF_MAX_EVENTS)
+		return -1;
+
+	attr->size = sizeof(*attr);
+	attr->disabled = 1;
+	attr->read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+		PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	int fd = (int)syscall(__NR_perf_event_open, attr, pid, cpu, -1,
+			      PERF_FLAG_FD_CLOEXEC);
+	if (fd < 0 && pid == 0 && (errno == EACCES || errno == EPERM)) {
+		/* unprivileged users may count the user space only */
+		attr->exclude_kernel = 1;
+		attr->exclude_hv = 1;
+		fd = (int)syscall(__NR_perf_event_open, attr, pid, cpu, -1,
+				  PERF_FLAG_FD_CLOEXEC);
+	}
+	if (fd < 0)
+		return -1;
+
+	struct perf_event *ev = &perf->events[perf->nevents++];
+	ev->fd = fd;
+	ev->counter = counter;
+	ev->scale = scale;
+
+	return 0;
+}
+
+/*
+ * benchmark_perf_thread_open -- open the core counters of the calling thread,
+ * returns NULL if none of them is available
+ */
+struct benchmark_perf *
+benchmark_perf_thread_open(void)
+{
+	static const struct {
+		uint32_t type;
+		uint64_t config;
+		enum benchmark_perf_counter counter;
+	} events[] = {
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, PERF_CYCLES},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,
+		 PERF_INSTRUCTIONS},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,
+		 PERF_LLC_MISSES},
+		{PERF_TYPE_HW_CACHE,
+		 PERF_COUNT_HW_CACHE_DTLB |
+			 (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+		 PERF_DTLB_MISSES},
+	};
+
+	auto *perf = (struct benchmark_perf *)calloc(
+		1, sizeof(struct benchmark_perf));
+	if (perf == nullptr)
+		return nullptr;
+
+	for (size_t i = 0; i < sizeof(events) / sizeof(events[0]); i++) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = events[i].type;
+		attr.config = events[i].config;
+		(void)perf_add(perf, &attr, 0, -1, events[i].counter, 1.0);
+	}
+
+	if (perf->nevents == 0) {
+		free(perf);
+		return nullptr;
+	}
+
+	return perf;
+}
+
+/*
+ * sysfs_read -- (internal) read the contents of the sysfs file
+ */
+static int
+sysfs_read(const char *path, char *buf, size_t size)
+{
+	int fd = os_open(path, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	ssize_t len = read(fd, buf, size - 1);
+	close(fd);
+	if (len <= 0)
+		return -1;
+
+	buf[len] = '\0';
+	buf[strcspn(buf, "\n")] = '\0';
+	return 0;
+}
+
+/*
+ * pmu_event_config -- (internal) translate the event description, e.g.
+ * "event=0x04,umask=0x03", to the config using the format of the PMU
+ */
+static int
+pmu_event_config(const char *pmu, const char *event, uint64_t *config)
+{
+	char path[PATH_MAX];
+	char desc[256];
+	char format[64];
+
+	snprintf(path, sizeof(path), "%s/%s/events/%s", SYSFS_PMU_DIR, pmu,
+		 event);
+	if (sysfs_read(path, desc, sizeof(desc)))
+		return -1;
+
+	*config = 0;
+	char *saveptr = nullptr;
+	for (char *term = strtok_r(desc, ",", &saveptr); term != nullptr;
+	     term = strtok_r(nullptr, ",", &saveptr)) {
+		uint64_t value = 1;
+		char *eq = strchr(term, '=');
+		if (eq != nullptr) {
+			*eq = '\0';
+			value = strtoull(eq + 1, nullptr, 0);
+		}
+
+		snprintf(path, sizeof(path), "%s/%s/format/%s", SYSFS_PMU_DIR,
+			 pmu, term);
+		if (sysfs_read(path, format, sizeof(format)))
+			return -1;
+
+		/* only the fields of the config are supported */
+		unsigned lo, hi;
+		int n = sscanf(format, "config:%u-%u", &lo, &hi);
+		if (n < 1 || lo > 63)
+			return -1;
+
+		*config |= value << lo;
+	}
+
+	return 0;
+}
+
+/*
+ * uncore_add -- (internal) open the counter of the event of the memory
+ * controller on each CPU the PMU is accessible from
+ */
+static void
+uncore_add(struct benchmark_perf *perf, const char *pmu, uint32_t type,
+	   const char *cpus, const char *event,
+	   enum benchmark_perf_counter counter)
+{
+	uint64_t config;
+	if (pmu_event_config(pmu, event, &config))
+		return;
+
+	const char *p = cpus;
+	while (*p != '\0') {
+		char *end;
+		long first = strtol(p, &end, 10);
+		long last = first;
+		if (end == p)
+			return;
+		if (*end == '-')
+			last = strtol(end + 1, &end, 10);
+
+		for (long cpu = first; cpu <= last; cpu++) {
+			struct perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.type = type;
+			attr.config = config;
+			(void)perf_add(perf, &attr, -1, (int)cpu, counter,
+				       CAS_BYTES);
+		}
+
+		if (*end != ',')
+			return;
+		p = end + 1;
+	}
+}
+
+/*
+ * benchmark_perf_uncore_open -- open the system-wide counters of the memory
+ * traffic, returns NULL if they are not available
+ */
+struct benchmark_perf *
+benchmark_perf_uncore_open(void)
+{
+	DIR *dir = opendir(SYSFS_PMU_DIR);
+	if (dir == nullptr)
+		return nullptr;
+
+	auto *perf = (struct benchmark_perf *)calloc(
+		1, sizeof(struct benchmark_perf));
+	if (perf == nullptr) {
+		closedir(dir);
+		return nullptr;
+	}
+
+	struct dirent *d;
+	while ((d = readdir(dir)) != nullptr) {
+		if (strncmp(d->d_name, UNCORE_IMC_PREFIX,
+			    strlen(UNCORE_IMC_PREFIX)) != 0)
+			continue;
+
+		char path[PATH_MAX];
+		char buf[256];
+		snprintf(path, sizeof(path), "%s/%s/type", SYSFS_PMU_DIR,
+			 d->d_name);
+		if (sysfs_read(path, buf, sizeof(buf)))
+			continue;
+		auto type = (uint32_t)strtoul(buf, nullptr, 10);
+
+		snprintf(path, sizeof(path), "%s/%s/cpumask", SYSFS_PMU_DIR,
+			 d->d_name);
+		if (sysfs_read(path, buf, sizeof(buf)))
+			continue;
+
+		uncore_add(perf, d->d_name, type, buf, "cas_count_read",
+			   PERF_MEM_READ);
+		uncore_add(perf, d->d_name, type, buf, "cas_count_write",
+			   PERF_MEM_WRITE);
+	}
+	closedir(dir);
+
+	if (perf->nevents == 0) {
+		free(perf);
+		return nullptr;
+	}
+
+	return perf;
+}
+
+/*
+ * benchmark_perf_start -- reset and enable the counters, perf may be NULL
+ */
+void
+benchmark_perf_start(struct benchmark_perf *perf)
+{
+	if (perf == nullptr)
+		return;
+
+	for (size_t i = 0; i < perf->nevents; i++) {
+		ioctl(perf->events[i].fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(perf->events[i].fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+/*
+ * benchmark_perf_stop -- disable the counters, perf may be NULL
+ */
+void
+benchmark_perf_stop(struct benchmark_perf *perf)
+{
+	if (perf == nullptr)
+		return;
+
+	for (size_t i = 0; i < perf->nevents; i++)
+		ioctl(perf->events[i].fd, PERF_EVENT_IOC_DISABLE, 0);
+}
+
+/*
+ * benchmark_perf_read -- add values of the counters to counts, the values
+ * are scaled up if the counters had to be multiplexed, perf may be NULL
+ */
+void
+benchmark_perf_read(struct benchmark_perf *perf,
+		    struct benchmark_perf_counts *counts)
+{
+	if (perf == nullptr)
+		return;
+
+	for (size_t i = 0; i < perf->nevents; i++) {
+		struct perf_event *ev = &perf->events[i];
+
+		/* value, time enabled and time running */
+		uint64_t data[3];
+		if (read(ev->fd, data, sizeof(data)) != sizeof(data))
+			continue;
+		if (data[2] == 0)
+			continue;
+
+		double value = (double)data[0] * ev->scale;
+		if (data[2] < data[1])
+			value *= (double)data[1] / (double)data[2];
+
+		counts->val[ev->counter] += value;
+		counts->valid |= 1U << ev->counter;
+	}
+}
+
+/*
+ * benchmark_perf_close -- close the counters, perf may be NULL
+ */
+void
+benchmark_perf_close(struct benchmark_perf *perf)
+{
+	if (perf == nullptr)
+		return;
+
+	for (size_t i = 0; i < perf->nevents; i++)
+		close(perf->events[i].fd);
+	free(perf);
+}
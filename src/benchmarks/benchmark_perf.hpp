@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+/*
+ * benchmark_perf.hpp -- declarations of benchmark_perf module
+ *
+ * Hardware performance counters collected with perf_event_open(2): the core
+ * events are counted for the worker threads only, the memory traffic is
+ * counted system-wide by the memory controllers (uncore), if the platform
+ * exposes them and the user is allowed to use them.
+ */
+
+#ifndef BENCHMARK_PERF_HPP
+#define BENCHMARK_PERF_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+enum benchmark_perf_counter {
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_LLC_MISSES,
+	PERF_DTLB_MISSES,
+	PERF_MEM_READ,	/* bytes read from the memory */
+	PERF_MEM_WRITE, /* bytes written to the memory */
+
+	PERF_NCOUNTERS
+};
+
+/*
+ * benchmark_perf_counts -- values of the counters, only the ones which could
+ * be collected are valid
+ */
+struct benchmark_perf_counts {
+	double val[PERF_NCOUNTERS];
+	unsigned valid; /* bit mask of the valid counters */
+};
+
+struct benchmark_perf;
+
+struct benchmark_perf *benchmark_perf_thread_open(void);
+struct benchmark_perf *benchmark_perf_uncore_open(void);
+void benchmark_perf_start(struct benchmark_perf *perf);
+void benchmark_perf_stop(struct benchmark_perf *perf);
+void benchmark_perf_read(struct benchmark_perf *perf,
+			 struct benchmark_perf_counts *counts);
+void benchmark_perf_close(struct benchmark_perf *perf);
+
+extern const char *benchmark_perf_names[PERF_NCOUNTERS];
+
+#endif
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2017, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * benchmark_time.cpp -- benchmark_time module definitions
@@ -7,11 +7,15 @@
 #include "benchmark_time.hpp"
 #include "os.h"
 #include <cassert>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #define NSECPSEC 1000000000
 
+/* the rest of the wait is spent spinning, so the thread does not oversleep */
+#define WAIT_SPIN_NSECS 50000ULL
+
 /*
  * benchmark_time_get -- get timestamp from clock source
  */
@@ -79,6 +83,29 @@ benchmark_time_set(benchmark_time_t *time, unsigned long long nsecs)
 	time->tv_nsec = nsecs % NSECPSEC;
 }
 
+/*
+ * benchmark_time_wait_until -- wait until the given moment
+ */
+void
+benchmark_time_wait_until(benchmark_time_t *time)
+{
+	unsigned long long target = benchmark_time_get_nsecs(time);
+	benchmark_time_t now;
+
+	benchmark_time_get(&now);
+	if (target > benchmark_time_get_nsecs(&now) + WAIT_SPIN_NSECS) {
+		benchmark_time_t wake;
+		benchmark_time_set(&wake, target - WAIT_SPIN_NSECS);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake,
+				       nullptr) == EINTR)
+			;
+	}
+
+	do {
+		benchmark_time_get(&now);
+	} while (benchmark_time_get_nsecs(&now) < target);
+}
+
 /*
  * number of samples used to calculate average time required to get a current
  * time from the system
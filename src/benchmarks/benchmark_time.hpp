@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2015-2020, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 /*
  * benchmark_time.hpp -- declarations of benchmark_time module
  */
@@ -15,4 +15,5 @@ unsigned long long benchmark_time_get_nsecs(benchmark_time_t *t);
 int benchmark_time_compare(const benchmark_time_t *t1,
 			   const benchmark_time_t *t2);
 void benchmark_time_set(benchmark_time_t *time, unsigned long long nsecs);
+void benchmark_time_wait_until(benchmark_time_t *time);
 unsigned long long benchmark_get_avg_get_time(void);
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2019, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 /*
  * benchmark_worker.cpp -- benchmark_worker module definitions
  */
@@ -55,6 +55,10 @@ thread_func(void *arg)
 		worker->ret_init = worker->init(worker->bench, worker->args,
 						&worker->info);
 
+	/* the counters have to be opened by the thread they count */
+	if (!worker->ret_init && worker->args->perf)
+		worker->perf = benchmark_perf_thread_open();
+
 	worker_state_transition(worker, WORKER_STATE_INIT,
 				WORKER_STATE_INITIALIZED);
 
@@ -66,7 +70,9 @@ thread_func(void *arg)
 	worker_state_wait_for_transition(worker, WORKER_STATE_INITIALIZED,
 					 WORKER_STATE_RUN);
 
-	worker->ret = worker->func(worker->bench, &worker->info);
+	benchmark_perf_start(worker->perf);
+	worker->ret = worker->func(worker->bench, worker->args, &worker->info);
+	benchmark_perf_stop(worker->perf);
 
 	worker_state_transition(worker, WORKER_STATE_RUN, WORKER_STATE_END);
 
@@ -76,6 +82,9 @@ thread_func(void *arg)
 	if (worker->exit)
 		worker->exit(worker->bench, worker->args, &worker->info);
 
+	benchmark_perf_close(worker->perf);
+	worker->perf = nullptr;
+
 	worker_state_transition(worker, WORKER_STATE_EXIT, WORKER_STATE_DONE);
 
 	util_mutex_unlock(&worker->lock);
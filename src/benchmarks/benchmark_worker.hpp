@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2015-2020, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 /*
  * benchmark_worker.hpp -- benchmark_worker module declarations
  */
@@ -48,11 +48,13 @@ struct benchmark_worker {
 	struct worker_info info;
 	int ret;
 	int ret_init;
-	int (*func)(struct benchmark *bench, struct worker_info *info);
+	int (*func)(struct benchmark *bench, struct benchmark_args *args,
+		    struct worker_info *info);
 	int (*init)(struct benchmark *bench, struct benchmark_args *args,
 		    struct worker_info *info);
 	void (*exit)(struct benchmark *bench, struct benchmark_args *args,
 		     struct worker_info *info);
+	struct benchmark_perf *perf; /* hardware counters of the thread */
 	os_cond_t cond;
 	os_mutex_t lock;
 	enum benchmark_worker_state state;
@@ -1,25 +1,33 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2018, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 /*
- * map_bench.cpp -- benchmarks for: ctree, btree, rtree, rbtree, hashmap_atomic
- * and hashmap_tx from examples.
+ * map_bench.cpp -- benchmarks for: ctree, btree, fptree, art, rtree,
+ * rbtree, skiplist, hashmap_atomic, hashmap_tx, hashmap_rp and hashmap_mt from
+ * examples.
  */
 #include <cassert>
+#include <cinttypes>
+#include <cmath>
 
 #include "benchmark.hpp"
+#include "benchmark_hist.hpp"
 #include "file.h"
 #include "os.h"
 #include "os_thread.h"
 #include "poolset_util.hpp"
 
 #include "map.h"
+#include "map_art.h"
 #include "map_btree.h"
+#include "map_fptree.h"
 #include "map_ctree.h"
 #include "map_hashmap_atomic.h"
+#include "map_hashmap_mt.h"
 #include "map_hashmap_rp.h"
 #include "map_hashmap_tx.h"
 #include "map_rbtree.h"
 #include "map_rtree.h"
+#include "map_skiplist.h"
 
 /* Values less than 3 is not suitable for current rtree implementation */
 #define FACTOR 3
@@ -46,11 +54,20 @@ struct root {
 static const struct {
 	const char *str;
 	const struct map_ops *ops;
+	bool concurrent; /* the map does its own locking */
 } map_types[] = {
-	{"ctree", MAP_CTREE},		{"btree", MAP_BTREE},
-	{"rtree", MAP_RTREE},		{"rbtree", MAP_RBTREE},
-	{"hashmap_tx", MAP_HASHMAP_TX}, {"hashmap_atomic", MAP_HASHMAP_ATOMIC},
-	{"hashmap_rp", MAP_HASHMAP_RP}};
+	{"ctree", MAP_CTREE, false},
+	{"btree", MAP_BTREE, false},
+	{"fptree", MAP_FPTREE, false},
+	{"art", MAP_ART, true},
+	{"rtree", MAP_RTREE, false},
+	{"rbtree", MAP_RBTREE, false},
+	{"hashmap_tx", MAP_HASHMAP_TX, false},
+	{"hashmap_atomic", MAP_HASHMAP_ATOMIC, false},
+	{"hashmap_rp", MAP_HASHMAP_RP, false},
+	{"hashmap_mt", MAP_HASHMAP_MT, true},
+	{"skiplist", MAP_SKIPLIST, false},
+};
 
 #define MAP_TYPES_NUM (sizeof(map_types) / sizeof(map_types[0]))
 
@@ -60,16 +77,105 @@ struct map_bench_args {
 	char *type;
 	bool ext_tx;
 	bool alloc;
+
+	/* map_ycsb only */
+	char *workload;
+	char *key_dist;
+	char *value_dist;
+	uint64_t records;
+	size_t min_vsize;
+	unsigned scan_len; /* map_ycsb and map_range */
+
+	/* map_range only */
+	unsigned batch;
+};
+
+/*
+ * YCSB core workloads: the operations, their shares in percents and the
+ * default distribution of the keys
+ */
+enum ycsb_op {
+	YCSB_READ,
+	YCSB_UPDATE,
+	YCSB_INSERT,
+	YCSB_SCAN,
+	YCSB_RMW,
+
+	YCSB_NOPS
+};
+
+static const char *ycsb_op_names[YCSB_NOPS] = {"read", "update", "insert",
+					       "scan", "rmw"};
+
+enum ycsb_dist {
+	YCSB_DIST_CONSTANT,
+	YCSB_DIST_UNIFORM,
+	YCSB_DIST_ZIPFIAN,
+	YCSB_DIST_LATEST,
+};
+
+static const struct {
+	const char *name;
+	unsigned pct[YCSB_NOPS];
+	enum ycsb_dist dist;
+} ycsb_workloads[] = {
+	{"a", {50, 50, 0, 0, 0}, YCSB_DIST_ZIPFIAN},
+	{"b", {95, 5, 0, 0, 0}, YCSB_DIST_ZIPFIAN},
+	{"c", {100, 0, 0, 0, 0}, YCSB_DIST_ZIPFIAN},
+	{"d", {95, 0, 5, 0, 0}, YCSB_DIST_LATEST},
+	{"e", {0, 0, 5, 95, 0}, YCSB_DIST_ZIPFIAN},
+	{"f", {50, 0, 0, 0, 50}, YCSB_DIST_ZIPFIAN},
+};
+
+#define YCSB_WORKLOADS_NUM (sizeof(ycsb_workloads) / sizeof(ycsb_workloads[0]))
+
+/* number of the record locks of the concurrent maps, a power of two */
+#define YCSB_RECORD_LOCKS 1024
+
+/* skew of the zipfian distribution, the same as YCSB uses */
+#define ZIPFIAN_THETA 0.99
+
+/* number of records inserted in a single transaction when loading the map */
+#define YCSB_LOAD_BATCH 1024
+
+/*
+ * zipf -- generator of zipfian distributed ranks in [0, n), the most popular
+ * items have the lowest ranks (Gray et al., "Quickly Generating Billion-Record
+ * Synthetic Databases")
+ */
+struct zipf {
+	uint64_t n;
+	double alpha;
+	double zetan;
+	double eta;
+	double theta_half; /* 1 + 0.5^theta */
+};
+
+/*
+ * ycsb_value -- the record stored in the map
+ */
+struct ycsb_value {
+	uint64_t size;
+	char data[];
+};
+
+struct map_ycsb_worker {
+	rng_t rng;
+	char *buf; /* destination of the read records */
+	struct map_entry *entries; /* batch of a scan, if the map is ordered */
+	struct benchmark_hist *hist[YCSB_NOPS];
 };
 
 struct map_bench_worker {
 	uint64_t *keys;
 	size_t nkeys;
+	struct map_entry *entries; /* map_range only */
 };
 
 struct map_bench {
 	struct map_ctx *mapc;
 	os_mutex_t lock;
+	bool concurrent; /* the lock is not needed to access the map */
 	PMEMobjpool *pop;
 	size_t pool_size;
 
@@ -86,8 +192,20 @@ struct map_bench {
 	int (*insert)(struct map_bench *, uint64_t);
 	int (*remove)(struct map_bench *, uint64_t);
 	int (*get)(struct map_bench *, uint64_t);
+
+	/* map_ycsb only */
+	unsigned ycsb_pct[YCSB_NOPS]; /* cumulative shares of the operations */
+	enum ycsb_dist key_dist;
+	enum ycsb_dist value_dist;
+	struct zipf key_zipf;
+	struct zipf value_zipf;
+	uint64_t nrecords; /* keys 1 .. nrecords are in the map */
+	os_mutex_t *record_locks; /* serialize updates of the same record */
 };
 
+/* per operation latencies of map_ycsb, gathered from all repeats */
+static struct benchmark_hist *ycsb_hist[YCSB_NOPS];
+
 /*
  * mutex_lock_nofail -- locks mutex and aborts if locking failed
  */
@@ -114,6 +232,26 @@ mutex_unlock_nofail(os_mutex_t *lock)
 	}
 }
 
+/*
+ * map_lock -- locks the map unless it may be accessed concurrently
+ */
+static void
+map_lock(struct map_bench *map_bench)
+{
+	if (!map_bench->concurrent)
+		mutex_lock_nofail(&map_bench->lock);
+}
+
+/*
+ * map_unlock -- unlocks the map locked by map_lock
+ */
+static void
+map_unlock(struct map_bench *map_bench)
+{
+	if (!map_bench->concurrent)
+		mutex_unlock_nofail(&map_bench->lock);
+}
+
 /*
  * get_key -- return 64-bit random key
  */
@@ -134,11 +272,13 @@ get_key(unsigned *seed, uint64_t max_key)
  * parse_map_type -- parse type of map
  */
 static const struct map_ops *
-parse_map_type(const char *str)
+parse_map_type(const char *str, bool *concurrent)
 {
 	for (unsigned i = 0; i < MAP_TYPES_NUM; i++) {
-		if (strcmp(str, map_types[i].str) == 0)
+		if (strcmp(str, map_types[i].str) == 0) {
+			*concurrent = map_types[i].concurrent;
 			return map_types[i].ops;
+		}
 	}
 
 	return nullptr;
@@ -190,11 +330,11 @@ map_remove_op(struct benchmark *bench, struct operation_info *info)
 
 	uint64_t key = tworker->keys[info->index];
 
-	mutex_lock_nofail(&map_bench->lock);
+	map_lock(map_bench);
 
 	int ret = map_bench->remove(map_bench, key);
 
-	mutex_unlock_nofail(&map_bench->lock);
+	map_unlock(map_bench);
 
 	return ret;
 }
@@ -242,11 +382,11 @@ map_insert_op(struct benchmark *bench, struct operation_info *info)
 	auto *tworker = (struct map_bench_worker *)info->worker->priv;
 	uint64_t key = tworker->keys[info->index];
 
-	mutex_lock_nofail(&map_bench->lock);
+	map_lock(map_bench);
 
 	int ret = map_bench->insert(map_bench, key);
 
-	mutex_unlock_nofail(&map_bench->lock);
+	map_unlock(map_bench);
 
 	return ret;
 }
@@ -284,15 +424,43 @@ map_get_op(struct benchmark *bench, struct operation_info *info)
 
 	uint64_t key = tworker->keys[info->index];
 
-	mutex_lock_nofail(&map_bench->lock);
+	map_lock(map_bench);
 
 	int ret = map_bench->get(map_bench, key);
 
-	mutex_unlock_nofail(&map_bench->lock);
+	map_unlock(map_bench);
 
 	return ret;
 }
 
+/*
+ * map_range_op -- main operation for map_range benchmark
+ */
+static int
+map_range_op(struct benchmark *bench, struct operation_info *info)
+{
+	auto *map_bench = (struct map_bench *)pmembench_get_priv(bench);
+	auto *tworker = (struct map_bench_worker *)info->worker->priv;
+	unsigned len = map_bench->margs->scan_len;
+	unsigned batch = map_bench->margs->batch;
+
+	struct map_cursor cur;
+	map_cursor_init(&cur, tworker->keys[info->index], UINT64_MAX);
+
+	map_lock(map_bench);
+
+	size_t nread = 0;
+	while (nread < len && !cur.done) {
+		size_t n = len - nread < batch ? len - nread : batch;
+		nread += map_cursor_next(map_bench->mapc, map_bench->map, &cur,
+					 tworker->entries, n);
+	}
+
+	map_unlock(map_bench);
+
+	return 0;
+}
+
 /*
  * map_common_init_worker -- common init worker function for map_* benchmarks
  */
@@ -354,6 +522,7 @@ map_common_free_worker(struct benchmark *bench, struct benchmark_args *args,
 		pmemobj_tx_commit();
 		(void)pmemobj_tx_end();
 	}
+	free(tworker->entries);
 	free(tworker->keys);
 	free(tworker);
 }
@@ -451,6 +620,31 @@ err_common_free_worker:
 	return -1;
 }
 
+/*
+ * map_range_init_worker -- init worker function for map_range benchmark
+ */
+static int
+map_range_init_worker(struct benchmark *bench, struct benchmark_args *args,
+		      struct worker_info *worker)
+{
+	auto *targs = (struct map_bench_args *)args->opts;
+
+	int ret = map_bench_get_init_worker(bench, args, worker);
+	if (ret)
+		return ret;
+
+	auto *tworker = (struct map_bench_worker *)worker->priv;
+	tworker->entries = (struct map_entry *)malloc(
+		targs->batch * sizeof(*tworker->entries));
+	if (!tworker->entries) {
+		perror("malloc");
+		map_common_free_worker(bench, args, worker);
+		return -1;
+	}
+
+	return 0;
+}
+
 /*
  * map_common_init -- common init function for map_* benchmarks
  */
@@ -484,7 +678,8 @@ map_common_init(struct benchmark *bench, struct benchmark_args *args)
 	map_bench->args = args;
 	map_bench->margs = (struct map_bench_args *)args->opts;
 
-	const struct map_ops *ops = parse_map_type(map_bench->margs->type);
+	const struct map_ops *ops = parse_map_type(map_bench->margs->type,
+						   &map_bench->concurrent);
 	if (!ops) {
 		fprintf(stderr, "invalid map type value specified -- '%s'\n",
 			map_bench->margs->type);
@@ -507,7 +702,8 @@ map_common_init(struct benchmark *bench, struct benchmark_args *args)
 		map_bench->get = map_get_root_op;
 	}
 
-	map_bench->nkeys = args->n_threads * args->n_ops_per_thread;
+	map_bench->nkeys = args->n_threads * args->n_ops_per_thread +
+		map_bench->margs->records;
 	map_bench->init_nkeys = map_bench->nkeys;
 	size_per_key = map_bench->margs->alloc
 		? SIZE_PER_KEY + map_bench->args->dsize + ALLOC_OVERHEAD
@@ -733,11 +929,639 @@ map_get_exit(struct benchmark *bench, struct benchmark_args *args)
 	return map_common_exit(bench, args);
 }
 
+/*
+ * map_range_init -- init function for map_range benchmark
+ */
+static int
+map_range_init(struct benchmark *bench, struct benchmark_args *args)
+{
+	int ret = map_bench_get_init(bench, args);
+	if (ret)
+		return ret;
+
+	auto *map_bench = (struct map_bench *)pmembench_get_priv(bench);
+	if (map_bench->mapc->ops->range == nullptr) {
+		fprintf(stderr, "%s does not support range scans\n",
+			map_bench->margs->type);
+		map_get_exit(bench, args);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * zipf_zeta -- (internal) the sum of 1 / i^theta for i in [1, n]
+ */
+static double
+zipf_zeta(uint64_t n, double theta)
+{
+	double sum = 0.0;
+	for (uint64_t i = 1; i <= n; i++)
+		sum += 1.0 / pow((double)i, theta);
+
+	return sum;
+}
+
+/*
+ * zipf_init -- (internal) prepare generator of ranks in [0, n)
+ */
+static void
+zipf_init(struct zipf *z, uint64_t n)
+{
+	double theta = ZIPFIAN_THETA;
+
+	z->n = n;
+	z->alpha = 1.0 / (1.0 - theta);
+	z->zetan = zipf_zeta(n, theta);
+	z->eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) /
+		(1.0 - zipf_zeta(2, theta) / z->zetan);
+	z->theta_half = 1.0 + pow(0.5, theta);
+}
+
+/*
+ * rnd_double -- (internal) uniformly distributed double in [0, 1)
+ */
+static double
+rnd_double(rng_t *rng)
+{
+	return (double)(rnd64_r(rng) >> 11) / (double)(1ULL << 53);
+}
+
+/*
+ * zipf_next -- (internal) draw the next rank
+ */
+static uint64_t
+zipf_next(const struct zipf *z, rng_t *rng)
+{
+	double u = rnd_double(rng);
+	double uz = u * z->zetan;
+
+	if (uz < 1.0)
+		return 0;
+	if (uz < z->theta_half)
+		return 1;
+
+	auto rank = (uint64_t)((double)z->n *
+			       pow(z->eta * u - z->eta + 1.0, z->alpha));
+
+	return rank < z->n ? rank : z->n - 1;
+}
+
+/*
+ * parse_ycsb_dist -- (internal) parse name of the distribution
+ */
+static int
+parse_ycsb_dist(const char *str, enum ycsb_dist *dist)
+{
+	static const struct {
+		const char *str;
+		enum ycsb_dist dist;
+	} dists[] = {
+		{"constant", YCSB_DIST_CONSTANT},
+		{"uniform", YCSB_DIST_UNIFORM},
+		{"zipfian", YCSB_DIST_ZIPFIAN},
+		{"latest", YCSB_DIST_LATEST},
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(dists); i++) {
+		if (strcmp(str, dists[i].str) == 0) {
+			*dist = dists[i].dist;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * ycsb_next_key -- (internal) choose key of an existing record
+ *
+ * The keys start from 1, as ctree and btree use the key 0 for empty slots.
+ */
+static uint64_t
+ycsb_next_key(struct map_bench *map_bench, rng_t *rng)
+{
+	uint64_t n = __atomic_load_n(&map_bench->nrecords, __ATOMIC_ACQUIRE);
+	uint64_t rank;
+
+	switch (map_bench->key_dist) {
+		case YCSB_DIST_ZIPFIAN:
+			/* spread the popular keys over the whole map */
+			rank = zipf_next(&map_bench->key_zipf, rng);
+			return 1 + hash64(rank) % n;
+		case YCSB_DIST_LATEST:
+			rank = zipf_next(&map_bench->key_zipf, rng);
+			return rank < n ? n - rank : 1;
+		default:
+			return 1 + rnd64_r(rng) % n;
+	}
+}
+
+/*
+ * ycsb_value_size -- (internal) choose size of the value of a new record
+ */
+static size_t
+ycsb_value_size(struct map_bench *map_bench, rng_t *rng)
+{
+	size_t min = map_bench->margs->min_vsize;
+	size_t range = map_bench->args->dsize - min + 1;
+
+	switch (map_bench->value_dist) {
+		case YCSB_DIST_UNIFORM:
+			return min + rnd64_r(rng) % range;
+		case YCSB_DIST_ZIPFIAN:
+			return min + zipf_next(&map_bench->value_zipf, rng);
+		default:
+			return map_bench->args->dsize;
+	}
+}
+
+/*
+ * ycsb_fill -- (internal) fill the value of the record
+ */
+static void
+ycsb_fill(char *data, size_t size, rng_t *rng)
+{
+	uint64_t v = rnd64_r(rng);
+	for (size_t i = 0; i < size; i++)
+		data[i] = (char)(v >> (8 * (i % 8)));
+}
+
+/*
+ * ycsb_insert -- (internal) insert the record of the given key
+ */
+static int
+ycsb_insert(struct map_bench *map_bench, uint64_t key, rng_t *rng)
+{
+	size_t size = ycsb_value_size(map_bench, rng);
+	int ret = 0;
+
+	TX_BEGIN(map_bench->pop)
+	{
+		PMEMoid oid = pmemobj_tx_alloc(sizeof(struct ycsb_value) + size,
+					       OBJ_TYPE_NUM);
+		auto *val = (struct ycsb_value *)pmemobj_direct(oid);
+		val->size = size;
+		ycsb_fill(val->data, size, rng);
+		ret = map_insert(map_bench->mapc, map_bench->map, key, oid);
+	}
+	TX_ONABORT
+	{
+		ret = -1;
+	}
+	TX_END
+
+	return ret;
+}
+
+/*
+ * ycsb_read -- (internal) read the record of the given key
+ */
+static int
+ycsb_read(struct map_bench *map_bench, uint64_t key, char *buf)
+{
+	PMEMoid oid = map_get(map_bench->mapc, map_bench->map, key);
+	if (OID_IS_NULL(oid))
+		return -1;
+
+	auto *val = (struct ycsb_value *)pmemobj_direct(oid);
+	memcpy(buf, val->data, val->size);
+
+	return 0;
+}
+
+/*
+ * ycsb_update -- (internal) overwrite the record of the given key
+ */
+static int
+ycsb_update(struct map_bench *map_bench, uint64_t key, rng_t *rng)
+{
+	PMEMoid oid = map_get(map_bench->mapc, map_bench->map, key);
+	if (OID_IS_NULL(oid))
+		return -1;
+
+	auto *val = (struct ycsb_value *)pmemobj_direct(oid);
+	int ret = 0;
+
+	TX_BEGIN(map_bench->pop)
+	{
+		pmemobj_tx_add_range(oid, offsetof(struct ycsb_value, data),
+				     val->size);
+		ycsb_fill(val->data, val->size, rng);
+	}
+	TX_ONABORT
+	{
+		ret = -1;
+	}
+	TX_END
+
+	return ret;
+}
+
+/*
+ * ycsb_scan -- (internal) read the records of the consecutive keys
+ *
+ * The ordered maps return the whole scan in one batch, the others fall back
+ * to the point reads.
+ */
+static int
+ycsb_scan(struct map_bench *map_bench, uint64_t key, unsigned len,
+	  struct map_ycsb_worker *tworker)
+{
+	if (tworker->entries) {
+		struct map_cursor cur;
+		map_cursor_init(&cur, key, UINT64_MAX);
+		size_t n = map_cursor_next(map_bench->mapc, map_bench->map,
+					   &cur, tworker->entries, len);
+		if (n == 0)
+			return -1;
+
+		for (size_t i = 0; i < n; i++) {
+			auto *val = (struct ycsb_value *)pmemobj_direct(
+				tworker->entries[i].value);
+			memcpy(tworker->buf, val->data, val->size);
+		}
+
+		return 0;
+	}
+
+	char *buf = tworker->buf;
+	uint64_t end = key + len;
+	if (end > map_bench->nrecords + 1)
+		end = map_bench->nrecords + 1;
+
+	for (; key < end; key++) {
+		if (ycsb_read(map_bench, key, buf))
+			return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * map_ycsb_op -- main operation for map_ycsb benchmark
+ */
+static int
+map_ycsb_op(struct benchmark *bench, struct operation_info *info)
+{
+	auto *map_bench = (struct map_bench *)pmembench_get_priv(bench);
+	auto *tworker = (struct map_ycsb_worker *)info->worker->priv;
+
+	unsigned pct = (unsigned)(rnd64_r(&tworker->rng) % 100);
+	unsigned op = 0;
+	while (pct >= map_bench->ycsb_pct[op])
+		op++;
+
+	uint64_t key = 0;
+	unsigned len = 0;
+	if (op == YCSB_SCAN)
+		len = 1 +
+			(unsigned)(rnd64_r(&tworker->rng) %
+				   map_bench->margs->scan_len);
+	if (op != YCSB_INSERT)
+		key = ycsb_next_key(map_bench, &tworker->rng);
+
+	/*
+	 * The inserts are serialized even for the concurrent maps to keep the
+	 * keys dense. The updates of the concurrent maps lock only the record,
+	 * so that no two transactions snapshot and modify it at the same time.
+	 */
+	bool locked = op == YCSB_INSERT || !map_bench->concurrent;
+	os_mutex_t *record_lock = nullptr;
+	if (!locked && (op == YCSB_UPDATE || op == YCSB_RMW))
+		record_lock = &map_bench->record_locks[hash64(key) &
+						       (YCSB_RECORD_LOCKS - 1)];
+
+	benchmark_time_t beg, end;
+	benchmark_time_get(&beg);
+
+	if (locked)
+		mutex_lock_nofail(&map_bench->lock);
+	else if (record_lock)
+		mutex_lock_nofail(record_lock);
+
+	int ret = 0;
+	switch (op) {
+		case YCSB_READ:
+			ret = ycsb_read(map_bench, key, tworker->buf);
+			break;
+		case YCSB_UPDATE:
+			ret = ycsb_update(map_bench, key, &tworker->rng);
+			break;
+		case YCSB_INSERT:
+			key = map_bench->nrecords + 1;
+			ret = ycsb_insert(map_bench, key, &tworker->rng);
+			if (!ret)
+				__atomic_store_n(&map_bench->nrecords, key,
+						 __ATOMIC_RELEASE);
+			break;
+		case YCSB_SCAN:
+			ret = ycsb_scan(map_bench, key, len, tworker);
+			break;
+		case YCSB_RMW:
+			ret = ycsb_read(map_bench, key, tworker->buf);
+			if (!ret)
+				ret = ycsb_update(map_bench, key,
+						  &tworker->rng);
+			break;
+	}
+
+	if (locked)
+		mutex_unlock_nofail(&map_bench->lock);
+	else if (record_lock)
+		mutex_unlock_nofail(record_lock);
+
+	benchmark_time_get(&end);
+	benchmark_time_diff(&end, &beg, &end);
+	benchmark_hist_record(tworker->hist[op],
+			      benchmark_time_get_nsecs(&end));
+
+	return ret;
+}
+
+/*
+ * map_ycsb_init_worker -- init worker function for map_ycsb benchmark
+ */
+static int
+map_ycsb_init_worker(struct benchmark *bench, struct benchmark_args *args,
+		     struct worker_info *worker)
+{
+	auto *map_bench = (struct map_bench *)pmembench_get_priv(bench);
+	auto *targs = (struct map_bench_args *)args->opts;
+	struct map_ycsb_worker *tworker =
+		(struct map_ycsb_worker *)calloc(1, sizeof(*tworker));
+	if (!tworker) {
+		perror("calloc");
+		return -1;
+	}
+
+	randomize_r(&tworker->rng, targs->seed + worker->index + 1);
+
+	tworker->buf = (char *)malloc(args->dsize);
+	if (!tworker->buf) {
+		perror("malloc");
+		goto err;
+	}
+
+	if (map_bench->mapc->ops->range) {
+		tworker->entries = (struct map_entry *)malloc(
+			targs->scan_len * sizeof(*tworker->entries));
+		if (!tworker->entries) {
+			perror("malloc");
+			goto err;
+		}
+	}
+
+	for (unsigned i = 0; i < YCSB_NOPS; i++) {
+		tworker->hist[i] = benchmark_hist_alloc(3);
+		if (!tworker->hist[i]) {
+			perror("benchmark_hist_alloc");
+			goto err;
+		}
+	}
+
+	worker->priv = tworker;
+	return 0;
+err:
+	for (unsigned i = 0; i < YCSB_NOPS; i++)
+		benchmark_hist_free(tworker->hist[i]);
+	free(tworker->entries);
+	free(tworker->buf);
+	free(tworker);
+	return -1;
+}
+
+/*
+ * map_ycsb_free_worker -- cleanup worker function for map_ycsb benchmark
+ */
+static void
+map_ycsb_free_worker(struct benchmark *bench, struct benchmark_args *args,
+		     struct worker_info *worker)
+{
+	auto *tworker = (struct map_ycsb_worker *)worker->priv;
+
+	for (unsigned i = 0; i < YCSB_NOPS; i++) {
+		benchmark_hist_merge(ycsb_hist[i], tworker->hist[i]);
+		benchmark_hist_free(tworker->hist[i]);
+	}
+	free(tworker->entries);
+	free(tworker->buf);
+	free(tworker);
+}
+
+/*
+ * map_ycsb_load -- (internal) insert the initial records
+ */
+static int
+map_ycsb_load(struct map_bench *map_bench)
+{
+	rng_t rng;
+	randomize_r(&rng, map_bench->margs->seed);
+
+	uint64_t key = 1;
+	while (key <= map_bench->margs->records) {
+		uint64_t end = key + YCSB_LOAD_BATCH;
+		if (end > map_bench->margs->records + 1)
+			end = map_bench->margs->records + 1;
+
+		int ret = 0;
+		TX_BEGIN(map_bench->pop)
+		{
+			for (; key < end && !ret; key++)
+				ret = ycsb_insert(map_bench, key, &rng);
+		}
+		TX_ONABORT
+		{
+			ret = -1;
+		}
+		TX_END
+
+		if (ret)
+			return -1;
+	}
+
+	map_bench->nrecords = key - 1;
+	return 0;
+}
+
+/*
+ * map_ycsb_exit -- exit function for map_ycsb benchmark
+ */
+static int
+map_ycsb_exit(struct benchmark *bench, struct benchmark_args *args)
+{
+	auto *map_bench = (struct map_bench *)pmembench_get_priv(bench);
+
+	if (map_bench->record_locks) {
+		for (unsigned i = 0; i < YCSB_RECORD_LOCKS; i++)
+			os_mutex_destroy(&map_bench->record_locks[i]);
+		free(map_bench->record_locks);
+	}
+
+	return map_common_exit(bench, args);
+}
+
+/*
+ * map_ycsb_init -- init function for map_ycsb benchmark
+ */
+static int
+map_ycsb_init(struct benchmark *bench, struct benchmark_args *args)
+{
+	auto *targs = (struct map_bench_args *)args->opts;
+
+	size_t w;
+	for (w = 0; w < YCSB_WORKLOADS_NUM; w++) {
+		if (strcmp(targs->workload, ycsb_workloads[w].name) == 0)
+			break;
+	}
+	if (w == YCSB_WORKLOADS_NUM) {
+		fprintf(stderr, "invalid workload -- '%s'\n", targs->workload);
+		return -1;
+	}
+
+	enum ycsb_dist key_dist = ycsb_workloads[w].dist;
+	if (strcmp(targs->key_dist, "workload") != 0 &&
+	    (parse_ycsb_dist(targs->key_dist, &key_dist) ||
+	     key_dist == YCSB_DIST_CONSTANT)) {
+		fprintf(stderr, "invalid key distribution -- '%s'\n",
+			targs->key_dist);
+		return -1;
+	}
+
+	enum ycsb_dist value_dist;
+	if (parse_ycsb_dist(targs->value_dist, &value_dist) ||
+	    value_dist == YCSB_DIST_LATEST) {
+		fprintf(stderr, "invalid value size distribution -- '%s'\n",
+			targs->value_dist);
+		return -1;
+	}
+
+	if (targs->min_vsize > args->dsize) {
+		fprintf(stderr, "minimal value size bigger than data size\n");
+		return -1;
+	}
+
+	/* the records are allocated, their sizes are taken into account */
+	targs->alloc = true;
+
+	int ret = map_common_init(bench, args);
+	if (ret)
+		return ret;
+
+	auto *map_bench = (struct map_bench *)pmembench_get_priv(bench);
+
+	unsigned pct = 0;
+	for (unsigned i = 0; i < YCSB_NOPS; i++) {
+		pct += ycsb_workloads[w].pct[i];
+		map_bench->ycsb_pct[i] = pct;
+	}
+	assert(pct == 100);
+
+	map_bench->key_dist = key_dist;
+	map_bench->value_dist = value_dist;
+	zipf_init(&map_bench->key_zipf, targs->records);
+	if (value_dist == YCSB_DIST_ZIPFIAN)
+		zipf_init(&map_bench->value_zipf,
+			  args->dsize - targs->min_vsize + 1);
+
+	for (unsigned i = 0; i < YCSB_NOPS; i++) {
+		if (ycsb_hist[i])
+			continue;
+		ycsb_hist[i] = benchmark_hist_alloc(3);
+		if (!ycsb_hist[i]) {
+			perror("benchmark_hist_alloc");
+			goto err_exit_common;
+		}
+	}
+
+	if (map_bench->concurrent) {
+		map_bench->record_locks = (os_mutex_t *)malloc(
+			YCSB_RECORD_LOCKS * sizeof(*map_bench->record_locks));
+		if (!map_bench->record_locks) {
+			perror("malloc");
+			goto err_exit_common;
+		}
+
+		for (unsigned i = 0; i < YCSB_RECORD_LOCKS; i++) {
+			errno = os_mutex_init(&map_bench->record_locks[i]);
+			if (errno) {
+				perror("os_mutex_init");
+				while (i > 0)
+					os_mutex_destroy(
+						&map_bench->record_locks[--i]);
+				free(map_bench->record_locks);
+				map_bench->record_locks = nullptr;
+				goto err_exit_common;
+			}
+		}
+	}
+
+	if (map_ycsb_load(map_bench)) {
+		fprintf(stderr, "loading records failed\n");
+		goto err_exit_ycsb;
+	}
+
+	return 0;
+err_exit_ycsb:
+	map_ycsb_exit(bench, args);
+	return -1;
+err_exit_common:
+	map_common_exit(bench, args);
+	return -1;
+}
+
+/*
+ * map_ycsb_print_extra_headers -- print names of per operation latencies
+ */
+static void
+map_ycsb_print_extra_headers()
+{
+	for (unsigned i = 0; i < YCSB_NOPS; i++) {
+		const char *op = ycsb_op_names[i];
+		printf(";%s-ops;%s-latency-avg[nsec]"
+		       ";%s-latency-pctl-50.0%%[nsec]"
+		       ";%s-latency-pctl-99.0%%[nsec]"
+		       ";%s-latency-pctl-99.9%%[nsec]"
+		       ";%s-latency-pctl-99.99%%[nsec]",
+		       op, op, op, op, op, op);
+	}
+}
+
+/*
+ * map_ycsb_print_extra_values -- print per operation latencies of all
+ * repeats and release them
+ */
+static void
+map_ycsb_print_extra_values(struct benchmark *bench,
+			    struct benchmark_args *args,
+			    struct total_results *res)
+{
+	for (unsigned i = 0; i < YCSB_NOPS; i++) {
+		struct benchmark_hist *hist = ycsb_hist[i];
+		printf(";%" PRIu64 ";%" PRIu64 ";%" PRIu64 ";%" PRIu64
+		       ";%" PRIu64 ";%" PRIu64,
+		       benchmark_hist_count(hist),
+		       (uint64_t)llround(benchmark_hist_mean(hist)),
+		       benchmark_hist_percentile(hist, 50.0),
+		       benchmark_hist_percentile(hist, 99.0),
+		       benchmark_hist_percentile(hist, 99.9),
+		       benchmark_hist_percentile(hist, 99.99));
+
+		benchmark_hist_free(hist);
+		ycsb_hist[i] = nullptr;
+	}
+}
+
 static struct benchmark_clo map_bench_clos[5];
+static struct benchmark_clo map_ycsb_clos[8];
+static struct benchmark_clo map_range_clos[7];
 
 static struct benchmark_info map_insert_info;
 static struct benchmark_info map_remove_info;
 static struct benchmark_info map_get_info;
+static struct benchmark_info map_ycsb_info;
+static struct benchmark_info map_range_info;
 
 CONSTRUCTOR(map_bench_constructor)
 void
@@ -746,8 +1570,8 @@ map_bench_constructor(void)
 	map_bench_clos[0].opt_short = 'T';
 	map_bench_clos[0].opt_long = "type";
 	map_bench_clos[0].descr =
-		"Type of container "
-		"[ctree|btree|rtree|rbtree|hashmap_tx|hashmap_atomic]";
+		"Type of container [ctree|btree|fptree|art|rtree|rbtree|"
+		"skiplist|hashmap_tx|hashmap_atomic|hashmap_rp|hashmap_mt]";
 
 	map_bench_clos[0].off = clo_field_offset(struct map_bench_args, type);
 	map_bench_clos[0].type = CLO_TYPE_STR;
@@ -793,6 +1617,91 @@ map_bench_constructor(void)
 	map_bench_clos[4].off = clo_field_offset(struct map_bench_args, alloc);
 	map_bench_clos[4].type = CLO_TYPE_FLAG;
 
+	/* type and seed are the same as for the other map benchmarks */
+	map_ycsb_clos[0] = map_bench_clos[0];
+	map_ycsb_clos[1] = map_bench_clos[1];
+
+	map_ycsb_clos[2].opt_long = "workload";
+	map_ycsb_clos[2].descr = "YCSB core workload [a|b|c|d|e|f]";
+	map_ycsb_clos[2].off =
+		clo_field_offset(struct map_bench_args, workload);
+	map_ycsb_clos[2].type = CLO_TYPE_STR;
+	map_ycsb_clos[2].def = "a";
+
+	map_ycsb_clos[3].opt_long = "distribution";
+	map_ycsb_clos[3].descr = "Distribution of the keys "
+				 "[workload|zipfian|latest|uniform], "
+				 "workload uses the one of the workload";
+	map_ycsb_clos[3].off =
+		clo_field_offset(struct map_bench_args, key_dist);
+	map_ycsb_clos[3].type = CLO_TYPE_STR;
+	map_ycsb_clos[3].def = "workload";
+
+	map_ycsb_clos[4].opt_long = "records";
+	map_ycsb_clos[4].descr = "Number of records loaded before the run";
+	map_ycsb_clos[4].off =
+		clo_field_offset(struct map_bench_args, records);
+	map_ycsb_clos[4].type = CLO_TYPE_UINT;
+	map_ycsb_clos[4].def = "100000";
+	map_ycsb_clos[4].type_uint.size =
+		clo_field_size(struct map_bench_args, records);
+	map_ycsb_clos[4].type_uint.base = CLO_INT_BASE_DEC;
+	map_ycsb_clos[4].type_uint.min = 1;
+	map_ycsb_clos[4].type_uint.max = UINT64_MAX;
+
+	map_ycsb_clos[5].opt_long = "value-size-dist";
+	map_ycsb_clos[5].descr = "Distribution of the sizes of the values "
+				 "between min-value-size and data-size "
+				 "[constant|uniform|zipfian]";
+	map_ycsb_clos[5].off =
+		clo_field_offset(struct map_bench_args, value_dist);
+	map_ycsb_clos[5].type = CLO_TYPE_STR;
+	map_ycsb_clos[5].def = "constant";
+
+	map_ycsb_clos[6].opt_long = "min-value-size";
+	map_ycsb_clos[6].descr = "Minimal size of the values";
+	map_ycsb_clos[6].off =
+		clo_field_offset(struct map_bench_args, min_vsize);
+	map_ycsb_clos[6].type = CLO_TYPE_UINT;
+	map_ycsb_clos[6].def = "1";
+	map_ycsb_clos[6].type_uint.size =
+		clo_field_size(struct map_bench_args, min_vsize);
+	map_ycsb_clos[6].type_uint.base = CLO_INT_BASE_DEC;
+	map_ycsb_clos[6].type_uint.min = 1;
+	map_ycsb_clos[6].type_uint.max = ULONG_MAX;
+
+	map_ycsb_clos[7].opt_long = "scan-length";
+	map_ycsb_clos[7].descr = "Maximal number of records read by a scan";
+	map_ycsb_clos[7].off =
+		clo_field_offset(struct map_bench_args, scan_len);
+	map_ycsb_clos[7].type = CLO_TYPE_UINT;
+	map_ycsb_clos[7].def = "100";
+	map_ycsb_clos[7].type_uint.size =
+		clo_field_size(struct map_bench_args, scan_len);
+	map_ycsb_clos[7].type_uint.base = CLO_INT_BASE_DEC;
+	map_ycsb_clos[7].type_uint.min = 1;
+	map_ycsb_clos[7].type_uint.max = UINT_MAX;
+
+	/* the options of map_get and the length of the scans */
+	for (unsigned i = 0; i < ARRAY_SIZE(map_bench_clos); i++)
+		map_range_clos[i] = map_bench_clos[i];
+
+	map_range_clos[5] = map_ycsb_clos[7];
+	map_range_clos[5].descr = "Number of records read by a scan";
+	map_range_clos[5].def = "10";
+
+	map_range_clos[6].opt_long = "batch";
+	map_range_clos[6].descr = "Number of records returned by a single "
+				  "call of the cursor";
+	map_range_clos[6].off = clo_field_offset(struct map_bench_args, batch);
+	map_range_clos[6].type = CLO_TYPE_UINT;
+	map_range_clos[6].def = "16";
+	map_range_clos[6].type_uint.size =
+		clo_field_size(struct map_bench_args, batch);
+	map_range_clos[6].type_uint.base = CLO_INT_BASE_DEC;
+	map_range_clos[6].type_uint.min = 1;
+	map_range_clos[6].type_uint.max = UINT_MAX;
+
 	map_insert_info.name = "map_insert";
 	map_insert_info.brief = "Inserting to tree map";
 	map_insert_info.init = map_common_init;
@@ -843,4 +1752,40 @@ map_bench_constructor(void)
 	map_get_info.rm_file = true;
 	map_get_info.allow_poolset = true;
 	REGISTER_BENCHMARK(map_get_info);
+
+	map_ycsb_info.name = "map_ycsb";
+	map_ycsb_info.brief = "YCSB workloads on tree map";
+	map_ycsb_info.init = map_ycsb_init;
+	map_ycsb_info.exit = map_ycsb_exit;
+	map_ycsb_info.multithread = true;
+	map_ycsb_info.multiops = true;
+	map_ycsb_info.init_worker = map_ycsb_init_worker;
+	map_ycsb_info.free_worker = map_ycsb_free_worker;
+	map_ycsb_info.operation = map_ycsb_op;
+	map_ycsb_info.measure_time = true;
+	map_ycsb_info.clos = map_ycsb_clos;
+	map_ycsb_info.nclos = ARRAY_SIZE(map_ycsb_clos);
+	map_ycsb_info.opts_size = sizeof(struct map_bench_args);
+	map_ycsb_info.rm_file = true;
+	map_ycsb_info.allow_poolset = true;
+	map_ycsb_info.print_extra_headers = map_ycsb_print_extra_headers;
+	map_ycsb_info.print_extra_values = map_ycsb_print_extra_values;
+	REGISTER_BENCHMARK(map_ycsb_info);
+
+	map_range_info.name = "map_range";
+	map_range_info.brief = "Range scans of tree map";
+	map_range_info.init = map_range_init;
+	map_range_info.exit = map_get_exit;
+	map_range_info.multithread = true;
+	map_range_info.multiops = true;
+	map_range_info.init_worker = map_range_init_worker;
+	map_range_info.free_worker = map_common_free_worker;
+	map_range_info.operation = map_range_op;
+	map_range_info.measure_time = true;
+	map_range_info.clos = map_range_clos;
+	map_range_info.nclos = ARRAY_SIZE(map_range_clos);
+	map_range_info.opts_size = sizeof(struct map_bench_args);
+	map_range_info.rm_file = true;
+	map_range_info.allow_poolset = true;
+	REGISTER_BENCHMARK(map_range_info);
 }
@@ -0,0 +1,664 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * obj_recovery.cpp -- benchmark of the restart of a pool after a crash
+ *
+ * A template pool is filled with objects, a part of them is freed to
+ * fragment the heap and then a child process starts the given number of
+ * transactions and exits without finishing them. Every operation opens its
+ * own copy of the template, allocates a single object and closes the pool.
+ * The time of each of these steps is reported, with the open broken down
+ * into the recovery phases using the stats.boot CTLs.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "benchmark.hpp"
+#include "benchmark_hist.hpp"
+#include "file.h"
+#include "libpmemobj.h"
+#include "os_thread.h"
+
+#define LAYOUT_NAME "obj_recovery"
+#define TEMPLATE_NAME "template"
+#define POOL_NAME "pool%08zx"
+#define DIR_MODE 0700
+#define FACTOR 2
+#define COPY_BUF_SIZE (1 << 20)
+#define PHASE_HIST_DIGITS 3
+
+/* every transaction holds a lane until it is interrupted */
+#define MAX_IN_FLIGHT 1024
+
+/* snapshot cache allocated by each transaction, see tx.cache.size */
+#define TX_CACHE_SIZE ((size_t)1 << 15)
+
+/*
+ * recovery_args -- benchmark specific command line options
+ */
+struct recovery_args {
+	size_t pool_size;   /* size of the pool, 0 to fit the objects */
+	size_t n_objs;	    /* number of objects allocated in the pool */
+	unsigned frag;	    /* percentage of the objects freed */
+	unsigned in_flight; /* number of interrupted transactions */
+	unsigned tx_ranges; /* number of objects modified by each of them */
+};
+
+/*
+ * recovery_phase -- steps of the restart, the open is measured as a whole
+ * and split into the recovery phases, the other part of the open consists
+ * of mapping and checking the pool and of creating its runtime state
+ */
+enum recovery_phase {
+	PHASE_OPEN,
+	PHASE_OPEN_OTHER,
+	PHASE_REDO_RECOVERY,
+	PHASE_HEAP_BOOT,
+	PHASE_UNDO_RECOVERY,
+	PHASE_FIRST_ALLOC,
+	PHASE_ZONE_RECLAIM,
+	PHASE_CLOSE,
+
+	MAX_PHASE
+};
+
+static const char *phase_names[MAX_PHASE] = {
+	"open",		 "open-other",	 "redo-recovery", "heap-boot",
+	"undo-recovery", "first-alloc", "zone-reclaim",	 "close",
+};
+
+/*
+ * recovery_bench -- benchmark context
+ */
+struct recovery_bench {
+	struct recovery_args *pa; /* benchmark specific arguments */
+	char **paths;		  /* copies of the template, one per op */
+	size_t npaths;		  /* number of the copies */
+};
+
+/*
+ * in_flight_tx -- arguments of a thread of the crashing process
+ */
+struct in_flight_tx {
+	PMEMobjpool *pop;
+	PMEMoid *oids;	     /* objects left allocated */
+	size_t noids;	     /* number of the objects */
+	size_t first;	     /* first object modified by the transaction */
+	size_t dsize;	     /* size of the objects */
+	unsigned tx_ranges;  /* number of objects modified */
+	unsigned *nstarted;  /* number of transactions in progress */
+};
+
+/* times of the phases of all operations of all repeats */
+static struct benchmark_hist *phase_hist[MAX_PHASE];
+
+/*
+ * in_flight_tx_run -- start the transaction and never finish it
+ */
+static void *
+in_flight_tx_run(void *arg)
+{
+	auto *tx = (struct in_flight_tx *)arg;
+
+	TX_BEGIN(tx->pop)
+	{
+		for (unsigned i = 0; tx->noids && i < tx->tx_ranges; i++) {
+			PMEMoid oid = tx->oids[(tx->first + i) % tx->noids];
+			pmemobj_tx_add_range(oid, 0, tx->dsize);
+			memset(pmemobj_direct(oid), 0xcc, tx->dsize);
+		}
+		pmemobj_tx_alloc(tx->dsize, 0);
+
+		util_fetch_and_add32(tx->nstarted, 1);
+
+		/* the process exits while the transaction is in progress */
+		while (true)
+			pause();
+	}
+	TX_ONABORT
+	{
+		/* otherwise the process would wait for it forever */
+		fprintf(stderr, "interrupted transaction: %s\n",
+			pmemobj_errormsg());
+		_exit(1);
+	}
+	TX_END
+
+	return nullptr;
+}
+
+/*
+ * recovery_crash -- (internal) open the pool, start the transactions and
+ * exit the process without finishing them, called by the child process
+ */
+static void
+recovery_crash(const char *path, struct recovery_args *pa, PMEMoid *oids,
+	       size_t noids, size_t dsize)
+{
+	PMEMobjpool *pop = pmemobj_open(path, LAYOUT_NAME);
+	if (pop == nullptr) {
+		fprintf(stderr, "pmemobj_open: %s\n", pmemobj_errormsg());
+		_exit(1);
+	}
+
+	auto *txs = (struct in_flight_tx *)calloc(pa->in_flight,
+						  sizeof(struct in_flight_tx));
+	auto *threads =
+		(os_thread_t *)calloc(pa->in_flight, sizeof(os_thread_t));
+	if (txs == nullptr || threads == nullptr) {
+		perror("calloc");
+		_exit(1);
+	}
+
+	unsigned nstarted = 0;
+	for (unsigned i = 0; i < pa->in_flight; i++) {
+		txs[i].pop = pop;
+		txs[i].oids = oids;
+		txs[i].noids = noids;
+		txs[i].first = (size_t)i * pa->tx_ranges;
+		txs[i].dsize = dsize;
+		txs[i].tx_ranges = pa->tx_ranges;
+		txs[i].nstarted = &nstarted;
+		if (os_thread_create(&threads[i], nullptr, in_flight_tx_run,
+				     &txs[i])) {
+			perror("os_thread_create");
+			_exit(1);
+		}
+	}
+
+	unsigned started;
+	do {
+		util_atomic_load_explicit32(&nstarted, &started,
+					    memory_order_acquire);
+	} while (started < pa->in_flight);
+
+	/* leave the pool as it would be after a crash */
+	_exit(0);
+}
+
+/*
+ * recovery_prepare -- (internal) create the template pool
+ */
+static int
+recovery_prepare(struct benchmark_args *args, struct recovery_args *pa,
+		 const char *path)
+{
+	size_t psize = pa->pool_size;
+	if (psize == 0) {
+		size_t nallocs = pa->n_objs + pa->in_flight;
+		size_t tx_log = TX_CACHE_SIZE + pa->tx_ranges * args->dsize;
+		psize = PMEMOBJ_MIN_POOL + nallocs * args->dsize * FACTOR +
+			pa->in_flight * tx_log * FACTOR;
+	}
+
+	/*
+	 * The template is left sparse, so that its copies are sparse too,
+	 * a file created by pmemobj_create is always allocated.
+	 */
+	int fd = os_open(path, O_RDWR | O_CREAT | O_EXCL, args->fmode);
+	if (fd < 0) {
+		perror(path);
+		return -1;
+	}
+	if (os_ftruncate(fd, (os_off_t)psize)) {
+		perror(path);
+		close(fd);
+		return -1;
+	}
+	close(fd);
+
+	int fallocate = 0;
+	int sparse = 0;
+	if (pmemobj_ctl_get(nullptr, "fallocate.at_create", &fallocate) ||
+	    pmemobj_ctl_set(nullptr, "fallocate.at_create", &sparse)) {
+		fprintf(stderr, "fallocate.at_create: %s\n",
+			pmemobj_errormsg());
+		return -1;
+	}
+
+	PMEMobjpool *pop = pmemobj_create(path, LAYOUT_NAME, 0, args->fmode);
+	pmemobj_ctl_set(nullptr, "fallocate.at_create", &fallocate);
+	if (pop == nullptr) {
+		fprintf(stderr, "pmemobj_create: %s\n", pmemobj_errormsg());
+		return -1;
+	}
+
+	auto *oids = (PMEMoid *)malloc(pa->n_objs * sizeof(PMEMoid));
+	if (oids == nullptr) {
+		perror("malloc");
+		pmemobj_close(pop);
+		return -1;
+	}
+
+	/* free the given percentage of objects at random to fragment heap */
+	rng_t rng;
+	randomize_r(&rng, args->seed);
+	size_t noids = 0;
+	for (size_t i = 0; i < pa->n_objs; i++) {
+		if (pmemobj_alloc(pop, &oids[noids], args->dsize, 0, nullptr,
+				  nullptr)) {
+			fprintf(stderr, "pmemobj_alloc: %s\n",
+				pmemobj_errormsg());
+			goto err;
+		}
+		noids++;
+	}
+	for (size_t i = 0; i < noids;) {
+		if (rnd64_r(&rng) % 100 < pa->frag) {
+			pmemobj_free(&oids[i]);
+			oids[i] = oids[--noids];
+		} else {
+			i++;
+		}
+	}
+
+	pmemobj_close(pop);
+
+	if (pa->in_flight) {
+		pid_t pid = fork();
+		if (pid < 0) {
+			perror("fork");
+			free(oids);
+			return -1;
+		}
+		if (pid == 0)
+			recovery_crash(path, pa, oids, noids, args->dsize);
+
+		int status;
+		if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+		    WEXITSTATUS(status) != 0) {
+			fprintf(stderr, "preparing the transactions failed\n");
+			free(oids);
+			return -1;
+		}
+	}
+
+	free(oids);
+	return 0;
+
+err:
+	free(oids);
+	pmemobj_close(pop);
+	return -1;
+}
+
+/*
+ * recovery_copy -- (internal) copy the template pool, the holes of the file
+ * are kept so that the copies of a large pool do not take its whole size
+ */
+static int
+recovery_copy(const char *src, const char *dst, mode_t mode)
+{
+	int ret = -1;
+	int sfd = os_open(src, O_RDONLY);
+	if (sfd < 0) {
+		perror(src);
+		return -1;
+	}
+
+	int dfd = os_open(dst, O_WRONLY | O_CREAT | O_EXCL, mode);
+	if (dfd < 0) {
+		perror(dst);
+		close(sfd);
+		return -1;
+	}
+
+	char *buf = (char *)malloc(COPY_BUF_SIZE);
+	if (buf == nullptr) {
+		perror("malloc");
+		goto out;
+	}
+
+	os_stat_t st;
+	if (os_fstat(sfd, &st) || os_ftruncate(dfd, st.st_size)) {
+		perror(dst);
+		goto out;
+	}
+
+	for (os_off_t off = os_lseek(sfd, 0, SEEK_DATA); off >= 0;
+	     off = os_lseek(sfd, off, SEEK_DATA)) {
+		os_off_t hole = os_lseek(sfd, off, SEEK_HOLE);
+		if (hole < 0)
+			break;
+
+		while (off < hole) {
+			size_t len = (size_t)(hole - off) < COPY_BUF_SIZE
+				? (size_t)(hole - off)
+				: COPY_BUF_SIZE;
+			ssize_t n = pread(sfd, buf, len, off);
+			if (n <= 0) {
+				perror(src);
+				goto out;
+			}
+			if (pwrite(dfd, buf, (size_t)n, off) != n) {
+				perror(dst);
+				goto out;
+			}
+			off += n;
+		}
+	}
+
+	/* looking for the data past the last of it fails with ENXIO */
+	if (errno != ENXIO) {
+		perror(src);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	free(buf);
+	close(dfd);
+	close(sfd);
+	return ret;
+}
+
+/*
+ * recovery_exit -- benchmark cleanup
+ */
+static int
+recovery_exit(struct benchmark *bench, struct benchmark_args *args)
+{
+	auto *rb = (struct recovery_bench *)pmembench_get_priv(bench);
+
+	for (size_t i = 0; i < rb->npaths; i++)
+		free(rb->paths[i]);
+	free(rb->paths);
+	free(rb);
+
+	return 0;
+}
+
+/*
+ * recovery_init -- benchmark initialization, prepares a crashed pool for
+ * each operation
+ */
+static int
+recovery_init(struct benchmark *bench, struct benchmark_args *args)
+{
+	assert(bench != nullptr);
+	assert(args != nullptr);
+	assert(args->opts != nullptr);
+
+	enum file_type type = util_file_get_type(args->fname);
+	if (type == OTHER_ERROR) {
+		fprintf(stderr, "could not check type of file %s\n",
+			args->fname);
+		return -1;
+	}
+	if (type == TYPE_DEVDAX) {
+		fprintf(stderr, "%s: device dax is not supported\n",
+			args->fname);
+		return -1;
+	}
+
+	auto *rb = (struct recovery_bench *)calloc(
+		1, sizeof(struct recovery_bench));
+	if (rb == nullptr) {
+		perror("calloc");
+		return -1;
+	}
+	rb->pa = (struct recovery_args *)args->opts;
+	pmembench_set_priv(bench, rb);
+
+	for (unsigned i = 0; i < MAX_PHASE; i++) {
+		if (phase_hist[i] == nullptr)
+			phase_hist[i] = benchmark_hist_alloc(PHASE_HIST_DIGITS);
+		if (phase_hist[i] == nullptr) {
+			perror("benchmark_hist_alloc");
+			goto err;
+		}
+	}
+
+	if (util_file_mkdir(args->fname, DIR_MODE) != 0) {
+		perror(args->fname);
+		goto err;
+	}
+
+	char path[PATH_MAX];
+	if (util_snprintf(path, sizeof(path), "%s/" TEMPLATE_NAME,
+			  args->fname) < 0) {
+		perror("snprintf");
+		goto err;
+	}
+
+	if (recovery_prepare(args, rb->pa, path))
+		goto err;
+
+	rb->paths = (char **)calloc(args->n_ops_per_thread, sizeof(char *));
+	if (rb->paths == nullptr) {
+		perror("calloc");
+		goto err;
+	}
+
+	for (; rb->npaths < args->n_ops_per_thread; rb->npaths++) {
+		size_t len = strlen(args->fname) + sizeof(POOL_NAME) + 16;
+		char *pool = (char *)malloc(len);
+		if (pool == nullptr) {
+			perror("malloc");
+			goto err;
+		}
+		rb->paths[rb->npaths] = pool;
+
+		if (util_snprintf(pool, len, "%s/" POOL_NAME, args->fname,
+				  rb->npaths) < 0) {
+			perror("snprintf");
+			free(pool);
+			goto err;
+		}
+
+		if (recovery_copy(path, pool, args->fmode)) {
+			free(pool);
+			goto err;
+		}
+	}
+
+	return 0;
+
+err:
+	recovery_exit(bench, args);
+	return -1;
+}
+
+/*
+ * recovery_stat -- (internal) read the time statistic of the pool
+ */
+static uint64_t
+recovery_stat(PMEMobjpool *pop, const char *name)
+{
+	uint64_t value = 0;
+	if (pmemobj_ctl_get(pop, name, &value))
+		fprintf(stderr, "pmemobj_ctl_get %s: %s\n", name,
+			pmemobj_errormsg());
+
+	return value;
+}
+
+/*
+ * recovery_op -- open the crashed pool, allocate an object and close it
+ */
+static int
+recovery_op(struct benchmark *bench, struct operation_info *info)
+{
+	auto *rb = (struct recovery_bench *)pmembench_get_priv(bench);
+	assert(info->index < rb->npaths);
+
+	benchmark_time_t t[4];
+	uint64_t phase[MAX_PHASE];
+
+	benchmark_time_get(&t[0]);
+	PMEMobjpool *pop = pmemobj_open(rb->paths[info->index], LAYOUT_NAME);
+	benchmark_time_get(&t[1]);
+	if (pop == nullptr) {
+		fprintf(stderr, "pmemobj_open: %s\n", pmemobj_errormsg());
+		return -1;
+	}
+
+	phase[PHASE_REDO_RECOVERY] =
+		recovery_stat(pop, "stats.boot.redo_recovery_time");
+	phase[PHASE_HEAP_BOOT] = recovery_stat(pop, "stats.boot.heap_time");
+	phase[PHASE_UNDO_RECOVERY] =
+		recovery_stat(pop, "stats.boot.undo_recovery_time");
+
+	/* the zones of the heap are reclaimed by the first allocations */
+	benchmark_time_get(&t[2]);
+	int ret = pmemobj_alloc(pop, nullptr, info->args->dsize, 0, nullptr,
+				nullptr);
+	benchmark_time_get(&t[3]);
+	if (ret)
+		fprintf(stderr, "pmemobj_alloc: %s\n", pmemobj_errormsg());
+
+	phase[PHASE_ZONE_RECLAIM] =
+		recovery_stat(pop, "stats.heap.zone_reclaim_time");
+
+	benchmark_time_t close_beg, close_end;
+	benchmark_time_get(&close_beg);
+	pmemobj_close(pop);
+	benchmark_time_get(&close_end);
+
+	phase[PHASE_OPEN] = benchmark_time_get_nsecs(&t[1]) -
+		benchmark_time_get_nsecs(&t[0]);
+	uint64_t recovery = phase[PHASE_REDO_RECOVERY] +
+		phase[PHASE_HEAP_BOOT] + phase[PHASE_UNDO_RECOVERY];
+	phase[PHASE_OPEN_OTHER] = phase[PHASE_OPEN] > recovery
+		? phase[PHASE_OPEN] - recovery
+		: 0;
+	phase[PHASE_FIRST_ALLOC] = benchmark_time_get_nsecs(&t[3]) -
+		benchmark_time_get_nsecs(&t[2]);
+	phase[PHASE_CLOSE] = benchmark_time_get_nsecs(&close_end) -
+		benchmark_time_get_nsecs(&close_beg);
+
+	for (unsigned i = 0; i < MAX_PHASE; i++)
+		benchmark_hist_record(phase_hist[i], phase[i]);
+
+	return ret;
+}
+
+/*
+ * recovery_print_extra_headers -- print names of the phases
+ */
+static void
+recovery_print_extra_headers()
+{
+	for (unsigned i = 0; i < MAX_PHASE; i++) {
+		const char *name = phase_names[i];
+		printf(";%s-avg[nsec];%s-pctl-99.0%%[nsec]", name, name);
+	}
+}
+
+/*
+ * recovery_print_extra_values -- print times of the phases of all repeats
+ * and release them
+ */
+static void
+recovery_print_extra_values(struct benchmark *bench,
+			    struct benchmark_args *args,
+			    struct total_results *res)
+{
+	for (unsigned i = 0; i < MAX_PHASE; i++) {
+		struct benchmark_hist *hist = phase_hist[i];
+		printf(";%" PRIu64 ";%" PRIu64,
+		       (uint64_t)llround(benchmark_hist_mean(hist)),
+		       benchmark_hist_percentile(hist, 99.0));
+
+		benchmark_hist_free(hist);
+		phase_hist[i] = nullptr;
+	}
+}
+
+static struct benchmark_clo recovery_clo[5];
+static struct benchmark_info recovery_info;
+
+CONSTRUCTOR(obj_recovery_constructor)
+void
+obj_recovery_constructor(void)
+{
+	recovery_clo[0].opt_short = 0;
+	recovery_clo[0].opt_long = "pool-size";
+	recovery_clo[0].descr = "Size of the pool, 0 to fit the objects";
+	recovery_clo[0].type = CLO_TYPE_UINT;
+	recovery_clo[0].off = clo_field_offset(struct recovery_args, pool_size);
+	recovery_clo[0].def = "0";
+	recovery_clo[0].type_uint.size =
+		clo_field_size(struct recovery_args, pool_size);
+	recovery_clo[0].type_uint.base = CLO_INT_BASE_DEC | CLO_INT_BASE_HEX;
+	recovery_clo[0].type_uint.min = 0;
+	recovery_clo[0].type_uint.max = UINT64_MAX;
+
+	recovery_clo[1].opt_short = 'o';
+	recovery_clo[1].opt_long = "objects";
+	recovery_clo[1].descr = "Number of objects allocated in the pool";
+	recovery_clo[1].type = CLO_TYPE_UINT;
+	recovery_clo[1].off = clo_field_offset(struct recovery_args, n_objs);
+	recovery_clo[1].def = "10000";
+	recovery_clo[1].type_uint.size =
+		clo_field_size(struct recovery_args, n_objs);
+	recovery_clo[1].type_uint.base = CLO_INT_BASE_DEC;
+	recovery_clo[1].type_uint.min = 0;
+	recovery_clo[1].type_uint.max = UINT64_MAX;
+
+	recovery_clo[2].opt_short = 0;
+	recovery_clo[2].opt_long = "fragmentation";
+	recovery_clo[2].descr = "Percentage of the objects freed at random";
+	recovery_clo[2].type = CLO_TYPE_UINT;
+	recovery_clo[2].off = clo_field_offset(struct recovery_args, frag);
+	recovery_clo[2].def = "50";
+	recovery_clo[2].type_uint.size =
+		clo_field_size(struct recovery_args, frag);
+	recovery_clo[2].type_uint.base = CLO_INT_BASE_DEC;
+	recovery_clo[2].type_uint.min = 0;
+	recovery_clo[2].type_uint.max = 100;
+
+	recovery_clo[3].opt_short = 0;
+	recovery_clo[3].opt_long = "in-flight";
+	recovery_clo[3].descr = "Number of transactions interrupted by "
+				"the crash";
+	recovery_clo[3].type = CLO_TYPE_UINT;
+	recovery_clo[3].off = clo_field_offset(struct recovery_args, in_flight);
+	recovery_clo[3].def = "0";
+	recovery_clo[3].type_uint.size =
+		clo_field_size(struct recovery_args, in_flight);
+	recovery_clo[3].type_uint.base = CLO_INT_BASE_DEC;
+	recovery_clo[3].type_uint.min = 0;
+	recovery_clo[3].type_uint.max = MAX_IN_FLIGHT;
+
+	recovery_clo[4].opt_short = 0;
+	recovery_clo[4].opt_long = "tx-ranges";
+	recovery_clo[4].descr = "Number of objects modified by each "
+				"interrupted transaction";
+	recovery_clo[4].type = CLO_TYPE_UINT;
+	recovery_clo[4].off = clo_field_offset(struct recovery_args, tx_ranges);
+	recovery_clo[4].def = "1";
+	recovery_clo[4].type_uint.size =
+		clo_field_size(struct recovery_args, tx_ranges);
+	recovery_clo[4].type_uint.base = CLO_INT_BASE_DEC;
+	recovery_clo[4].type_uint.min = 0;
+	recovery_clo[4].type_uint.max = UINT_MAX;
+
+	recovery_info.name = "obj_recovery";
+	recovery_info.brief = "Pool open, recovery and first allocation "
+			      "after a crash";
+	recovery_info.init = recovery_init;
+	recovery_info.exit = recovery_exit;
+	recovery_info.multithread = false;
+	recovery_info.multiops = true;
+	recovery_info.operation = recovery_op;
+	recovery_info.measure_time = true;
+	recovery_info.clos = recovery_clo;
+	recovery_info.nclos = ARRAY_SIZE(recovery_clo);
+	recovery_info.opts_size = sizeof(struct recovery_args);
+	recovery_info.rm_file = true;
+	recovery_info.allow_poolset = false;
+	recovery_info.print_extra_headers = recovery_print_extra_headers;
+	recovery_info.print_extra_values = recovery_print_extra_values;
+	REGISTER_BENCHMARK(recovery_info);
+}
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2023, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * pmembench.cpp -- main source file for benchmark framework
@@ -21,6 +21,7 @@
 #include <unistd.h>
 
 #include "benchmark.hpp"
+#include "benchmark_hist.hpp"
 #include "benchmark_worker.hpp"
 #include "clo.hpp"
 #include "clo_vec.hpp"
@@ -40,6 +41,13 @@ unsigned long long Get_time_avg;
 
 #define MIN_EXE_TIME_E 0.5
 
+#define NSECPSEC 1000000000ULL
+#define NSECPMSEC 1000000ULL
+
+/* significant digits of the latencies of the whole run and of an interval */
+#define LATENCY_HIST_DIGITS 3
+#define INTERVAL_HIST_DIGITS 2
+
 /*
  * struct pmembench -- main context
  */
@@ -89,7 +97,7 @@ static struct version_s {
 static struct bench_list benchmarks;
 
 /* common arguments for benchmarks */
-static struct benchmark_clo pmembench_clos[13];
+static struct benchmark_clo pmembench_clos[16];
 
 /* list of arguments for pmembench */
 static struct benchmark_clo pmembench_opts[2];
@@ -260,6 +268,41 @@ pmembench_constructor(void)
 	pmembench_clos[12].off =
 		clo_field_offset(struct benchmark_args, is_dynamic_poolset);
 	pmembench_clos[12].ignore_in_res = true;
+
+	pmembench_clos[13].opt_long = "rate";
+	pmembench_clos[13].type = CLO_TYPE_UINT;
+	pmembench_clos[13].descr =
+		"Target number of operations per second of each thread, "
+		"0 runs the operations back to back";
+	pmembench_clos[13].off = clo_field_offset(struct benchmark_args, rate);
+	pmembench_clos[13].def = "0";
+	pmembench_clos[13].type_uint.size =
+		clo_field_size(struct benchmark_args, rate);
+	pmembench_clos[13].type_uint.base = CLO_INT_BASE_DEC;
+	pmembench_clos[13].type_uint.min = 0;
+	pmembench_clos[13].type_uint.max = ULONG_MAX;
+
+	pmembench_clos[14].opt_long = "interval";
+	pmembench_clos[14].type = CLO_TYPE_UINT;
+	pmembench_clos[14].descr =
+		"Print latencies of each interval of this many msecs";
+	pmembench_clos[14].off =
+		clo_field_offset(struct benchmark_args, interval);
+	pmembench_clos[14].def = "0";
+	pmembench_clos[14].ignore_in_res = true;
+	pmembench_clos[14].type_uint.size =
+		clo_field_size(struct benchmark_args, interval);
+	pmembench_clos[14].type_uint.base = CLO_INT_BASE_DEC;
+	pmembench_clos[14].type_uint.min = 0;
+	pmembench_clos[14].type_uint.max = UINT_MAX;
+
+	pmembench_clos[15].opt_long = "perf";
+	pmembench_clos[15].type = CLO_TYPE_FLAG;
+	pmembench_clos[15].descr =
+		"Print hardware performance counters per operation";
+	pmembench_clos[15].off = clo_field_offset(struct benchmark_args, perf);
+	pmembench_clos[15].def = "false";
+	pmembench_clos[15].ignore_in_res = true;
 }
 
 /*
@@ -357,17 +400,75 @@ pmembench_merge_clos(struct benchmark *bench)
 	bench->args_size = size;
 }
 
+/*
+ * pmembench_record_interval -- (internal) record latency of the operation
+ * in the histogram of the interval in which it ended
+ */
+static int
+pmembench_record_interval(struct worker_info *winfo, uint64_t interval,
+			  uint64_t end, uint64_t nsecs)
+{
+	size_t i = (size_t)(end / interval);
+	if (i >= winfo->nintervals) {
+		size_t size = (i + 1) * sizeof(struct benchmark_hist *);
+		auto *intervals = (struct benchmark_hist **)realloc(
+			winfo->intervals, size);
+		if (intervals == nullptr)
+			return -1;
+		winfo->intervals = intervals;
+
+		for (; winfo->nintervals <= i; winfo->nintervals++) {
+			intervals[winfo->nintervals] =
+				benchmark_hist_alloc(INTERVAL_HIST_DIGITS);
+			if (intervals[winfo->nintervals] == nullptr)
+				return -1;
+		}
+	}
+
+	benchmark_hist_record(winfo->intervals[i], nsecs);
+	return 0;
+}
+
 /*
  * pmembench_run_worker -- run worker with benchmark operation
+ *
+ * With the target rate set the operations are started on a fixed schedule,
+ * independently of how long the previous ones took, and the latency of
+ * an operation is measured from its scheduled start. This way a stall
+ * accounts for all the operations delayed by it, as it would for requests
+ * arriving at a server, instead of for a single one.
  */
 static int
-pmembench_run_worker(struct benchmark *bench, struct worker_info *winfo)
+pmembench_run_worker(struct benchmark *bench, struct benchmark_args *args,
+		     struct worker_info *winfo)
 {
+	uint64_t interval = (uint64_t)args->interval * NSECPMSEC;
+	benchmark_time_t start;
+
 	benchmark_time_get(&winfo->beg);
+	uint64_t beg = benchmark_time_get_nsecs(&winfo->beg);
+	uint64_t prev = beg;
 	for (size_t i = 0; i < winfo->nops; i++) {
+		if (args->rate) {
+			prev = beg + i / args->rate * NSECPSEC +
+				i % args->rate * NSECPSEC / args->rate;
+			benchmark_time_set(&start, prev);
+			benchmark_time_wait_until(&start);
+		}
+
 		if (bench->info->operation(bench, &winfo->opinfo[i]))
 			return -1;
 		benchmark_time_get(&winfo->opinfo[i].end);
+
+		uint64_t end = benchmark_time_get_nsecs(&winfo->opinfo[i].end);
+		uint64_t nsecs = end - prev;
+		benchmark_hist_record(winfo->hist, nsecs);
+		if (interval &&
+		    pmembench_record_interval(winfo, interval, end - beg,
+					      nsecs))
+			return -1;
+
+		prev = end;
 	}
 	benchmark_time_get(&winfo->end);
 
@@ -379,7 +480,7 @@ pmembench_run_worker(struct benchmark *bench, struct worker_info *winfo)
  */
 static void
 pmembench_print_header(struct pmembench *pb, struct benchmark *bench,
-		       struct clo_vec *clovec)
+		       struct clo_vec *clovec, struct benchmark_args *args)
 {
 	if (pb->scenario) {
 		printf("%s: %s [%" PRIu64 "]%s%s%s\n", pb->scenario->name,
@@ -402,7 +503,9 @@ pmembench_print_header(struct pmembench *pb, struct benchmark *bench,
 	       "latency-std-dev[nsec];"
 	       "latency-pctl-50.0%%[nsec];"
 	       "latency-pctl-99.0%%[nsec];"
-	       "latency-pctl-99.9%%[nsec]");
+	       "latency-pctl-99.9%%[nsec];"
+	       "latency-pctl-99.99%%[nsec];"
+	       "latency-pctl-99.999%%[nsec]");
 	size_t i;
 	for (i = 0; i < bench->nclos; i++) {
 		if (!bench->clos[i].ignore_in_res) {
@@ -413,6 +516,11 @@ pmembench_print_header(struct pmembench *pb, struct benchmark *bench,
 	if (bench->info->print_bandwidth)
 		printf(";bandwidth[MiB/s]");
 
+	if (args->perf) {
+		for (i = 0; i < PERF_NCOUNTERS; i++)
+			printf(";%s", benchmark_perf_names[i]);
+	}
+
 	if (bench->info->print_extra_headers)
 		bench->info->print_extra_headers();
 	printf("\n");
@@ -426,12 +534,14 @@ pmembench_print_results(struct benchmark *bench, struct benchmark_args *args,
 			struct total_results *res)
 {
 	printf("%f;%f;%f;%f;%f;%f;%" PRIu64 ";%" PRIu64 ";%" PRIu64
-	       ";%f;%" PRIu64 ";%" PRIu64 ";%" PRIu64,
+	       ";%f;%" PRIu64 ";%" PRIu64 ";%" PRIu64 ";%" PRIu64
+	       ";%" PRIu64,
 	       res->total.avg, res->nopsps, res->total.max, res->total.min,
 	       res->total.med, res->total.std_dev, res->latency.avg,
 	       res->latency.min, res->latency.max, res->latency.std_dev,
 	       res->latency.pctl50_0p, res->latency.pctl99_0p,
-	       res->latency.pctl99_9p);
+	       res->latency.pctl99_9p, res->latency.pctl99_99p,
+	       res->latency.pctl99_999p);
 
 	size_t i;
 	for (i = 0; i < bench->nclos; i++) {
@@ -444,11 +554,61 @@ pmembench_print_results(struct benchmark *bench, struct benchmark_args *args,
 	if (bench->info->print_bandwidth)
 		printf(";%f", res->nopsps * args->dsize / 1024 / 1024);
 
+	if (args->perf) {
+		/* the counters which could not be collected are left empty */
+		for (i = 0; i < PERF_NCOUNTERS; i++) {
+			if (res->perf.valid & (1U << i))
+				printf(";%f", res->perf.val[i]);
+			else
+				printf(";-");
+		}
+	}
+
 	if (bench->info->print_extra_values)
 		bench->info->print_extra_values(bench, args, res);
 	printf("\n");
 }
 
+/*
+ * pmembench_print_intervals -- print latencies of each interval of each
+ * repeat, the intervals are counted from the start of the workers
+ */
+static void
+pmembench_print_intervals(struct benchmark_args *args,
+			  struct total_results *res)
+{
+	printf("interval[msec];"
+	       "repeat;"
+	       "ops;"
+	       "ops-per-second[1/sec];"
+	       "latency-avg[nsec];"
+	       "latency-pctl-50.0%%[nsec];"
+	       "latency-pctl-99.0%%[nsec];"
+	       "latency-pctl-99.9%%[nsec];"
+	       "latency-pctl-99.99%%[nsec];"
+	       "latency-max[nsec]\n");
+
+	double secs = (double)args->interval / 1000.0;
+	for (size_t r = 0; r < res->nrepeats; r++) {
+		struct bench_results *bres = &res->res[r];
+		for (size_t i = 0; i < bres->nintervals; i++) {
+			struct benchmark_hist *hist = bres->intervals[i];
+			uint64_t nops = benchmark_hist_count(hist);
+			printf("%" PRIu64 ";%zu;%" PRIu64 ";%f;%" PRIu64
+			       ";%" PRIu64 ";%" PRIu64 ";%" PRIu64
+			       ";%" PRIu64 ";%" PRIu64 "\n",
+			       (uint64_t)(i + 1) * args->interval, r, nops,
+			       (double)nops / secs,
+			       (uint64_t)llround(benchmark_hist_mean(hist)),
+			       benchmark_hist_percentile(hist, 50.0),
+			       benchmark_hist_percentile(hist, 99.0),
+			       benchmark_hist_percentile(hist, 99.9),
+			       benchmark_hist_percentile(hist, 99.99),
+			       benchmark_hist_max(hist));
+		}
+	}
+}
+
 /*
  * pmembench_parse_clos -- parse command line arguments for benchmark
  */
@@ -581,6 +741,9 @@ pmembench_init_workers(struct benchmark_worker **workers,
 
 		workers[i]->info.index = i;
 		workers[i]->info.nops = args->n_ops_per_thread;
+		workers[i]->info.hist =
+			benchmark_hist_alloc(LATENCY_HIST_DIGITS);
+		assert(workers[i]->info.hist != nullptr);
 		workers[i]->info.opinfo = (struct operation_info *)calloc(
 			args->n_ops_per_thread, sizeof(struct operation_info));
 		size_t j;
@@ -612,18 +775,52 @@ end:
  */
 static void
 results_store(struct bench_results *res, struct benchmark_worker **workers,
-	      unsigned nthreads, size_t nops)
+	      unsigned nthreads)
 {
+	benchmark_hist_reset(res->hist);
+	for (size_t j = 0; j < res->nintervals; j++)
+		benchmark_hist_reset(res->intervals[j]);
+	memset(&res->perf, 0, sizeof(res->perf));
+
 	for (unsigned i = 0; i < nthreads; i++) {
-		res->thres[i]->beg = workers[i]->info.beg;
-		res->thres[i]->end = workers[i]->info.end;
-		for (size_t j = 0; j < nops; j++) {
-			res->thres[i]->end_op[j] =
-				workers[i]->info.opinfo[j].end;
+		struct worker_info *info = &workers[i]->info;
+		res->thres[i]->beg = info->beg;
+		res->thres[i]->end = info->end;
+		benchmark_hist_merge(res->hist, info->hist);
+		benchmark_perf_read(workers[i]->perf, &res->perf);
+
+		if (info->nintervals > res->nintervals) {
+			res->intervals = (struct benchmark_hist **)realloc(
+				res->intervals,
+				info->nintervals * sizeof(*res->intervals));
+			assert(res->intervals != nullptr);
+			for (; res->nintervals < info->nintervals;
+			     res->nintervals++) {
+				res->intervals[res->nintervals] =
+					benchmark_hist_alloc(
+						INTERVAL_HIST_DIGITS);
+				assert(res->intervals[res->nintervals] !=
+				       nullptr);
+			}
 		}
+
+		for (size_t j = 0; j < info->nintervals; j++)
+			benchmark_hist_merge(res->intervals[j],
+					     info->intervals[j]);
 	}
 }
 
+/*
+ * results_free_intervals -- release latencies of the intervals
+ */
+static void
+results_free_intervals(struct benchmark_hist **intervals, size_t nintervals)
+{
+	for (size_t i = 0; i < nintervals; i++)
+		benchmark_hist_free(intervals[i]);
+	free(intervals);
+}
+
 /*
  * compare_time -- compare time values
  */
@@ -647,17 +844,6 @@ compare_doubles(const void *a1, const void *b1)
 	return (*a > *b) - (*a < *b);
 }
 
-/*
- * compare_uint64t -- comparing function used for sorting
- */
-static int
-compare_uint64t(const void *a1, const void *b1)
-{
-	const auto *a = (const uint64_t *)a1;
-	const auto *b = (const uint64_t *)b1;
-	return (*a > *b) - (*a < *b);
-}
-
 /*
  * results_alloc -- prepare structure to store all benchmark results
  */
@@ -682,11 +868,13 @@ results_alloc(struct benchmark_args *args)
 		assert(res->thres != nullptr);
 		for (size_t j = 0; j < args->n_threads; j++) {
 			res->thres[j] = (struct thread_results *)malloc(
-				sizeof(*res->thres[j]) +
-				args->n_ops_per_thread *
-					sizeof(benchmark_time_t));
+				sizeof(*res->thres[j]));
 			assert(res->thres[j] != nullptr);
 		}
+		res->hist = benchmark_hist_alloc(LATENCY_HIST_DIGITS);
+		assert(res->hist != nullptr);
+		res->intervals = nullptr;
+		res->nintervals = 0;
 	}
 
 	return total;
@@ -702,6 +890,9 @@ results_free(struct total_results *total)
 		for (size_t j = 0; j < total->nthreads; j++)
 			free(total->res[i].thres[j]);
 		free(total->res[i].thres);
+		benchmark_hist_free(total->res[i].hist);
+		results_free_intervals(total->res[i].intervals,
+				       total->res[i].nintervals);
 	}
 	free(total->res);
 	free(total);
@@ -720,11 +911,10 @@ get_total_results(struct total_results *tres)
 	/* reset results */
 	memset(&tres->total, 0, sizeof(tres->total));
 	memset(&tres->latency, 0, sizeof(tres->latency));
+	memset(&tres->perf, 0, sizeof(tres->perf));
 
 	tres->total.min = DBL_MAX;
 	tres->total.max = DBL_MIN;
-	tres->latency.min = UINT64_MAX;
-	tres->latency.max = 0;
 
 	/* allocate helper arrays */
 	benchmark_time_t *tbeg =
@@ -806,76 +996,38 @@ get_total_results(struct total_results *tres)
 
 	tres->total.std_dev = sqrt(tres->total.std_dev / tres->nrepeats);
 
-	/* latency */
-	for (size_t i = 0; i < tres->nrepeats; i++) {
-		struct bench_results *res = &tres->res[i];
-		for (size_t j = 0; j < tres->nthreads; j++) {
-			struct thread_results *thres = res->thres[j];
-			benchmark_time_t *beg = &thres->beg;
-			for (size_t o = 0; o < tres->nops; o++) {
-				benchmark_time_t lat;
-				benchmark_time_diff(&lat, beg,
-						    &thres->end_op[o]);
-				uint64_t nsecs = benchmark_time_get_nsecs(&lat);
-
-				/* min, max latency */
-				if (nsecs > tres->latency.max)
-					tres->latency.max = nsecs;
-				if (nsecs < tres->latency.min)
-					tres->latency.min = nsecs;
-
-				tres->latency.avg += nsecs;
-
-				beg = &thres->end_op[o];
-			}
-		}
-	}
-
-	/* average latency */
-	size_t count = tres->nrepeats * tres->nthreads * tres->nops;
-	assert(count > 0);
-	tres->latency.avg /= count;
-
-	auto *ntotals = (uint64_t *)calloc(count, sizeof(uint64_t));
-	assert(ntotals != nullptr);
-	count = 0;
+	/* latency of all operations of all threads and repeats */
+	struct benchmark_hist *hist = benchmark_hist_alloc(LATENCY_HIST_DIGITS);
+	assert(hist != nullptr);
+	for (size_t i = 0; i < tres->nrepeats; i++)
+		benchmark_hist_merge(hist, tres->res[i].hist);
+	assert(benchmark_hist_count(hist) > 0);
+
+	tres->latency.min = benchmark_hist_min(hist);
+	tres->latency.max = benchmark_hist_max(hist);
+	tres->latency.avg = (uint64_t)llround(benchmark_hist_mean(hist));
+	tres->latency.std_dev = benchmark_hist_std_dev(hist);
+	tres->latency.pctl50_0p = benchmark_hist_percentile(hist, 50.0);
+	tres->latency.pctl99_0p = benchmark_hist_percentile(hist, 99.0);
+	tres->latency.pctl99_9p = benchmark_hist_percentile(hist, 99.9);
+	tres->latency.pctl99_99p = benchmark_hist_percentile(hist, 99.99);
+	tres->latency.pctl99_999p = benchmark_hist_percentile(hist, 99.999);
+	benchmark_hist_free(hist);
 
-	/* std deviation of latency and percentiles */
+	/*
+	 * performance counters per operation, valid only if they could be
+	 * collected in every repeat
+	 */
+	tres->perf.valid = ~0U;
 	for (size_t i = 0; i < tres->nrepeats; i++) {
-		struct bench_results *res = &tres->res[i];
-		for (size_t j = 0; j < tres->nthreads; j++) {
-			struct thread_results *thres = res->thres[j];
-			benchmark_time_t *beg = &thres->beg;
-			for (size_t o = 0; o < tres->nops; o++) {
-				benchmark_time_t lat;
-				benchmark_time_diff(&lat, beg,
-						    &thres->end_op[o]);
-				uint64_t nsecs = benchmark_time_get_nsecs(&lat);
-
-				uint64_t dev = (nsecs - tres->latency.avg);
-				dev *= dev;
-
-				tres->latency.std_dev += dev;
-
-				beg = &thres->end_op[o];
-
-				ntotals[count] = nsecs;
-				++count;
-			}
-		}
+		tres->perf.valid &= tres->res[i].perf.valid;
+		for (size_t j = 0; j < PERF_NCOUNTERS; j++)
+			tres->perf.val[j] += tres->res[i].perf.val[j];
 	}
-
-	tres->latency.std_dev = sqrt(tres->latency.std_dev / count);
-
-	/* find 50%, 99.0% and 99.9% percentiles */
-	qsort(ntotals, count, sizeof(uint64_t), compare_uint64t);
-	uint64_t p50_0 = count * 50 / 100;
-	uint64_t p99_0 = count * 99 / 100;
-	uint64_t p99_9 = count * 999 / 1000;
-	tres->latency.pctl50_0p = ntotals[p50_0];
-	tres->latency.pctl99_0p = ntotals[p99_0];
-	tres->latency.pctl99_9p = ntotals[p99_9];
-	free(ntotals);
+	double nops_total = (double)tres->nrepeats * (double)tres->nthreads *
+		(double)tres->nops;
+	for (size_t j = 0; j < PERF_NCOUNTERS; j++)
+		tres->perf.val[j] /= nops_total;
 
 	free(totals);
 	free(tend);
@@ -1158,6 +1310,10 @@ pmembench_single_repeat(struct benchmark *bench, struct benchmark_args *args,
 	}
 
 	unsigned j;
+	struct benchmark_perf *uncore;
+	uncore = args->perf ? benchmark_perf_uncore_open() : nullptr;
+	benchmark_perf_start(uncore);
+
 	for (j = 0; j < args->n_threads; j++) {
 		benchmark_worker_run(workers[j]);
 	}
@@ -1170,12 +1326,19 @@ pmembench_single_repeat(struct benchmark *bench, struct benchmark_args *args,
 		}
 	}
 
-	results_store(res, workers, args->n_threads, args->n_ops_per_thread);
+	benchmark_perf_stop(uncore);
+
+	results_store(res, workers, args->n_threads);
+	benchmark_perf_read(uncore, &res->perf);
+	benchmark_perf_close(uncore);
 
 	for (j = 0; j < args->n_threads; j++) {
 		benchmark_worker_exit(workers[j]);
 
 		free(workers[j]->info.opinfo);
+		benchmark_hist_free(workers[j]->info.hist);
+		results_free_intervals(workers[j]->info.intervals,
+				       workers[j]->info.nintervals);
 		benchmark_worker_free(workers[j]);
 	}
 
@@ -1338,7 +1501,7 @@ pmembench_run(struct pmembench *pb, struct benchmark *bench)
 		return -1;
 	}
 
-	pmembench_print_header(pb, bench, clovec);
+	pmembench_print_header(pb, bench, clovec, args);
 
 	size_t args_i;
 	for (args_i = 0; args_i < clovec->nargs; args_i++) {
@@ -1426,6 +1589,8 @@ pmembench_run(struct pmembench *pb, struct benchmark *bench)
 
 		get_total_results(total_res);
 		pmembench_print_results(bench, args, total_res);
+		if (args->interval)
+			pmembench_print_intervals(args, total_res);
 
 		args->n_ops_per_thread = n_ops_per_thread_copy;
 		args->n_threads = n_threads_copy;
@@ -0,0 +1,364 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * queue_bench.cpp -- benchmark of the multi-producer multi-consumer
+ * persistent queue
+ *
+ * The first of the threads are the producers, each operation of which
+ * enqueues a batch of entries, the other threads are the consumers, each
+ * operation of which dequeues a batch of entries. A consumer waits for
+ * the entries while any of the producers is running.
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sched.h>
+
+#include "benchmark.hpp"
+#include "file.h"
+#include "libpmemobj.h"
+
+#include "mpmc_queue.h"
+
+#define LAYOUT_NAME "queue_bench"
+#define FACTOR 2
+#define ALLOC_OVERHEAD 64
+
+/*
+ * queue_args -- benchmark specific command line options
+ */
+struct queue_args {
+	unsigned producers; /* number of the producer threads */
+	unsigned batch;	    /* number of entries of an operation */
+	size_t capacity;    /* number of the slots of the queue */
+};
+
+/*
+ * queue_root -- root object of the pool
+ */
+struct queue_root {
+	TOID(struct mpmc_queue) queue;
+};
+
+/*
+ * queue_bench -- benchmark context
+ */
+struct queue_bench {
+	PMEMobjpool *pop;
+	TOID(struct mpmc_queue) queue;
+	struct queue_args *qa;	 /* benchmark specific arguments */
+	unsigned producers_done; /* number of the finished producers */
+};
+
+/*
+ * queue_worker -- worker context
+ */
+struct queue_worker {
+	struct mpmc_queue_buf bufs[MPMC_QUEUE_MAX_BATCH];
+
+	/* data of the entries enqueued or dequeued by the worker */
+	char *data;
+	size_t dsize;
+	size_t ndequeued; /* number of the entries dequeued by an operation */
+};
+
+/*
+ * queue_init -- benchmark initialization
+ */
+static int
+queue_init(struct benchmark *bench, struct benchmark_args *args)
+{
+	assert(bench != nullptr);
+	assert(args != nullptr);
+	assert(args->opts != nullptr);
+
+	enum file_type type = util_file_get_type(args->fname);
+	if (type == OTHER_ERROR) {
+		fprintf(stderr, "could not check type of file %s\n",
+			args->fname);
+		return -1;
+	}
+
+	auto *qa = (struct queue_args *)args->opts;
+	if (qa->producers == 0 || qa->producers > args->n_threads) {
+		fprintf(stderr, "invalid number of producers\n");
+		return -1;
+	}
+
+	/* the entries left by the missing consumers must fit in the queue */
+	size_t consumers = args->n_threads - qa->producers;
+	size_t left = qa->producers > consumers
+		? (qa->producers - consumers) * args->n_ops_per_thread *
+			qa->batch
+		: 0;
+	if (left > qa->capacity) {
+		fprintf(stderr, "the capacity is too small for the entries "
+				"left by the consumers\n");
+		return -1;
+	}
+
+	auto *qb = (struct queue_bench *)calloc(1, sizeof(struct queue_bench));
+	if (qb == nullptr) {
+		perror("calloc");
+		return -1;
+	}
+	qb->qa = qa;
+	pmembench_set_priv(bench, qb);
+
+	/* the queue is full and every thread has a batch in progress */
+	size_t nentries = qa->capacity + args->n_threads * qa->batch;
+	size_t psize;
+	if (args->is_poolset || type == TYPE_DEVDAX)
+		psize = 0;
+	else
+		psize = PMEMOBJ_MIN_POOL +
+			(nentries * (args->dsize + ALLOC_OVERHEAD) +
+			 qa->capacity * sizeof(PMEMoid)) *
+				FACTOR;
+
+	qb->pop = pmemobj_create(args->fname, LAYOUT_NAME, psize, args->fmode);
+	if (qb->pop == nullptr) {
+		fprintf(stderr, "pmemobj_create: %s\n", pmemobj_errormsg());
+		goto err;
+	}
+
+	{
+		PMEMoid root = pmemobj_root(qb->pop, sizeof(struct queue_root));
+		if (OID_IS_NULL(root)) {
+			fprintf(stderr, "pmemobj_root: %s\n",
+				pmemobj_errormsg());
+			goto err_close;
+		}
+
+		auto *rootp = (struct queue_root *)pmemobj_direct(root);
+		if (mpmc_queue_create(qb->pop, &rootp->queue, qa->capacity)) {
+			perror("mpmc_queue_create");
+			goto err_close;
+		}
+		qb->queue = rootp->queue;
+	}
+
+	if (mpmc_queue_init(qb->pop, qb->queue)) {
+		perror("mpmc_queue_init");
+		goto err_close;
+	}
+
+	return 0;
+
+err_close:
+	pmemobj_close(qb->pop);
+err:
+	free(qb);
+	return -1;
+}
+
+/*
+ * queue_exit -- benchmark cleanup
+ */
+static int
+queue_exit(struct benchmark *bench, struct benchmark_args *args)
+{
+	auto *qb = (struct queue_bench *)pmembench_get_priv(bench);
+
+	pmemobj_close(qb->pop);
+	free(qb);
+
+	return 0;
+}
+
+/*
+ * queue_init_worker -- worker initialization
+ */
+static int
+queue_init_worker(struct benchmark *bench, struct benchmark_args *args,
+		  struct worker_info *worker)
+{
+	auto *qb = (struct queue_bench *)pmembench_get_priv(bench);
+
+	auto *qw = (struct queue_worker *)calloc(
+		1, sizeof(struct queue_worker));
+	if (qw == nullptr) {
+		perror("calloc");
+		return -1;
+	}
+
+	qw->dsize = args->dsize;
+	qw->data = (char *)malloc(qb->qa->batch * args->dsize);
+	if (qw->data == nullptr) {
+		perror("malloc");
+		free(qw);
+		return -1;
+	}
+	memset(qw->data, (int)worker->index, qb->qa->batch * args->dsize);
+
+	for (unsigned i = 0; i < qb->qa->batch; i++) {
+		qw->bufs[i].data = qw->data + i * args->dsize;
+		qw->bufs[i].len = args->dsize;
+	}
+
+	worker->priv = qw;
+
+	return 0;
+}
+
+/*
+ * queue_free_worker -- worker cleanup
+ */
+static void
+queue_free_worker(struct benchmark *bench, struct benchmark_args *args,
+		  struct worker_info *worker)
+{
+	auto *qw = (struct queue_worker *)worker->priv;
+
+	free(qw->data);
+	free(qw);
+}
+
+/*
+ * queue_entry_read -- (internal) copy the data of the dequeued entry
+ */
+static void
+queue_entry_read(const void *data, size_t len, void *arg)
+{
+	auto *qw = (struct queue_worker *)arg;
+
+	memcpy(qw->data, data, len < qw->dsize ? len : qw->dsize);
+	qw->ndequeued++;
+}
+
+/*
+ * queue_produce -- (internal) enqueue a batch of entries, wait for
+ * the consumers if the queue is full
+ */
+static int
+queue_produce(struct queue_bench *qb, struct operation_info *info)
+{
+	auto *qw = (struct queue_worker *)info->worker->priv;
+
+	while (mpmc_queue_enqueue(qb->pop, qb->queue, qw->bufs,
+				  qb->qa->batch)) {
+		if (errno != ENOBUFS) {
+			perror("mpmc_queue_enqueue");
+			return -1;
+		}
+		sched_yield();
+	}
+
+	if (info->index == info->worker->nops - 1)
+		util_fetch_and_add32(&qb->producers_done, 1);
+
+	return 0;
+}
+
+/*
+ * queue_consume -- (internal) dequeue a batch of entries, less of them only
+ * if all the producers are finished
+ */
+static int
+queue_consume(struct queue_bench *qb, struct operation_info *info)
+{
+	auto *qw = (struct queue_worker *)info->worker->priv;
+
+	qw->ndequeued = 0;
+	while (qw->ndequeued < qb->qa->batch) {
+		unsigned done;
+		util_atomic_load_explicit32(&qb->producers_done, &done,
+					    memory_order_acquire);
+
+		int ret = mpmc_queue_dequeue(qb->pop, qb->queue,
+					     qb->qa->batch - qw->ndequeued,
+					     queue_entry_read, qw);
+		if (ret < 0) {
+			perror("mpmc_queue_dequeue");
+			return -1;
+		}
+
+		if (ret == 0) {
+			if (done == qb->qa->producers)
+				break;
+			sched_yield();
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * queue_op -- enqueue or dequeue a batch of entries
+ */
+static int
+queue_op(struct benchmark *bench, struct operation_info *info)
+{
+	auto *qb = (struct queue_bench *)pmembench_get_priv(bench);
+
+	if (info->worker->index < qb->qa->producers)
+		return queue_produce(qb, info);
+
+	return queue_consume(qb, info);
+}
+
+static struct benchmark_clo queue_clo[3];
+static struct benchmark_info queue_info;
+
+CONSTRUCTOR(queue_bench_constructor)
+void
+queue_bench_constructor(void)
+{
+	queue_clo[0].opt_short = 0;
+	queue_clo[0].opt_long = "producers";
+	queue_clo[0].descr = "Number of the producer threads, the other "
+			     "threads are the consumers";
+	queue_clo[0].type = CLO_TYPE_UINT;
+	queue_clo[0].off = clo_field_offset(struct queue_args, producers);
+	queue_clo[0].def = "1";
+	queue_clo[0].type_uint.size =
+		clo_field_size(struct queue_args, producers);
+	queue_clo[0].type_uint.base = CLO_INT_BASE_DEC;
+	queue_clo[0].type_uint.min = 1;
+	queue_clo[0].type_uint.max = UINT_MAX;
+
+	queue_clo[1].opt_short = 0;
+	queue_clo[1].opt_long = "batch";
+	queue_clo[1].descr = "Number of the entries enqueued or dequeued "
+			     "by an operation";
+	queue_clo[1].type = CLO_TYPE_UINT;
+	queue_clo[1].off = clo_field_offset(struct queue_args, batch);
+	queue_clo[1].def = "8";
+	queue_clo[1].type_uint.size = clo_field_size(struct queue_args, batch);
+	queue_clo[1].type_uint.base = CLO_INT_BASE_DEC;
+	queue_clo[1].type_uint.min = 1;
+	queue_clo[1].type_uint.max = MPMC_QUEUE_MAX_BATCH;
+
+	queue_clo[2].opt_short = 0;
+	queue_clo[2].opt_long = "capacity";
+	queue_clo[2].descr = "Number of the slots of the queue, a power of 2";
+	queue_clo[2].type = CLO_TYPE_UINT;
+	queue_clo[2].off = clo_field_offset(struct queue_args, capacity);
+	queue_clo[2].def = "4096";
+	queue_clo[2].type_uint.size =
+		clo_field_size(struct queue_args, capacity);
+	queue_clo[2].type_uint.base = CLO_INT_BASE_DEC | CLO_INT_BASE_HEX;
+	queue_clo[2].type_uint.min = 1;
+	queue_clo[2].type_uint.max = UINT64_MAX;
+
+	queue_info.name = "mpmc_queue";
+	queue_info.brief = "Multi-producer multi-consumer persistent queue";
+	queue_info.init = queue_init;
+	queue_info.exit = queue_exit;
+	queue_info.multithread = true;
+	queue_info.multiops = true;
+	queue_info.init_worker = queue_init_worker;
+	queue_info.free_worker = queue_free_worker;
+	queue_info.operation = queue_op;
+	queue_info.measure_time = true;
+	queue_info.clos = queue_clo;
+	queue_info.nclos = ARRAY_SIZE(queue_clo);
+	queue_info.opts_size = sizeof(struct queue_args);
+	queue_info.rm_file = true;
+	queue_info.allow_poolset = true;
+	REGISTER_BENCHMARK(queue_info);
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * ctl_dirty_map.c -- implementation of the CTL dirty map namespace
+ */
+
+#include "ctl.h"
+#include "dirty_map.h"
+#include "out.h"
+#include "ctl_global.h"
+#include "util.h"
+
+/*
+ * CTL_READ_HANDLER(at_open) -- returns at_open field
+ */
+static int
+CTL_READ_HANDLER(at_open)(void *ctx,
+	enum ctl_query_source source, void *arg, struct ctl_indexes *indexes)
+{
+	/* suppress unused-parameter errors */
+	SUPPRESS_UNUSED(ctx, source, indexes);
+
+	int *arg_out = arg;
+	*arg_out = Dirty_map_at_open;
+	return 0;
+}
+
+/*
+ * CTL_WRITE_HANDLER(at_open) -- sets the at_open field in dirty_map
+ */
+static int
+CTL_WRITE_HANDLER(at_open)(void *ctx,
+	enum ctl_query_source source, void *arg, struct ctl_indexes *indexes)
+{
+	/* suppress unused-parameter errors */
+	SUPPRESS_UNUSED(ctx, source, indexes);
+
+	int arg_in = *(int *)arg;
+	Dirty_map_at_open = arg_in;
+	return 0;
+}
+
+static struct ctl_argument CTL_ARG(at_open) = CTL_ARG_BOOLEAN;
+
+static const struct ctl_node CTL_NODE(dirty_map)[] = {
+	CTL_LEAF_RW(at_open),
+
+	CTL_NODE_END
+};
+
+/*
+ * ctl_dirty_map_register -- registers ctl nodes for "dirty_map" module
+ */
+void
+ctl_dirty_map_register(void)
+{
+	CTL_REGISTER_MODULE(NULL, dirty_map);
+}
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2016-2020, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * ctl_global.h -- definitions for the global CTL namespace
@@ -16,6 +16,7 @@ extern void ctl_prefault_register(void);
 extern void ctl_sds_register(void);
 extern void ctl_fallocate_register(void);
 extern void ctl_cow_register(void);
+extern void ctl_dirty_map_register(void);
 
 static inline void
 ctl_global_register(void)
@@ -24,6 +25,7 @@ ctl_global_register(void)
 	ctl_sds_register();
 	ctl_fallocate_register();
 	ctl_cow_register();
+	ctl_dirty_map_register();
 }
 
 #ifdef __cplusplus
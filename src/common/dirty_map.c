@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * dirty_map.c -- map of the pool chunks modified since the last backup
+ *
+ * The map is stored in a file next to the pool and holds one bit for each
+ * chunk of the pool. A bit is set, and made persistent, before the first
+ * write to the chunk in the current generation reaches the pool, so after
+ * any crash all the chunks which may differ from the last backup are marked.
+ * The map is stored in little-endian byte order.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "dirty_map.h"
+#include "alloc.h"
+#include "libpmem.h"
+#include "mmap.h"
+#include "os.h"
+#include "out.h"
+#include "util.h"
+#include "util_pmem.h"
+
+/* tracking of the modified chunks, enabled with the dirty_map.at_open CTL */
+int Dirty_map_at_open = 0;
+
+/*
+ * dirty_map_file_size -- (internal) size of the map file for the pool
+ */
+static size_t
+dirty_map_file_size(uint64_t pool_size)
+{
+	uint64_t nchunks = (pool_size + DIRTY_MAP_CHUNK_SIZE - 1) /
+		DIRTY_MAP_CHUNK_SIZE;
+	size_t bitmap = (size_t)(nchunks + 63) / 64 * sizeof(uint64_t);
+
+	return DIRTY_MAP_HDR_SIZE + ALIGN_UP(bitmap, (size_t)Pagesize);
+}
+
+/*
+ * dirty_map_hdr_persist -- (internal) update the checksum of the header
+ *	and make it persistent
+ */
+static void
+dirty_map_hdr_persist(struct dirty_map *map)
+{
+	util_checksum(map->hdr, sizeof(*map->hdr), &map->hdr->checksum, 1, 0);
+	util_persist(map->is_pmem, map->hdr, sizeof(*map->hdr));
+}
+
+/*
+ * dirty_map_map -- (internal) map the dirty map file
+ */
+static struct dirty_map *
+dirty_map_map(int fd, size_t len)
+{
+	struct dirty_map *map = Malloc(sizeof(*map));
+	if (map == NULL) {
+		ERR_W_ERRNO("Malloc");
+		return NULL;
+	}
+
+	map->persisted = Zalloc(len - DIRTY_MAP_HDR_SIZE);
+	if (map->persisted == NULL) {
+		ERR_W_ERRNO("Zalloc");
+		Free(map);
+		return NULL;
+	}
+
+	void *addr = util_map(fd, 0, len, MAP_SHARED, 0, 0, NULL);
+	if (addr == NULL) {
+		Free(map->persisted);
+		Free(map);
+		return NULL;
+	}
+
+	map->hdr = addr;
+	map->bits = (uint64_t *)((char *)addr + DIRTY_MAP_HDR_SIZE);
+	map->mapped_len = len;
+	map->nchunks = 0;
+	map->pool_size = 0;
+	map->generation = 0;
+	map->is_pmem = pmem_is_pmem(addr, len);
+
+	return map;
+}
+
+/*
+ * util_dirty_map_path -- allocate the path of the dirty map of the pool,
+ *                        the allocated path has to be freed using Free()
+ */
+char *
+util_dirty_map_path(const char *path)
+{
+	LOG(3, "path %s", path);
+
+	size_t len = strlen(path) + strlen(DIRTY_MAP_SUFFIX);
+	char *map_path = Malloc(len + 1);
+	if (map_path == NULL) {
+		ERR_W_ERRNO("Malloc");
+		return NULL;
+	}
+
+	strcpy(map_path, path);
+	strcat(map_path, DIRTY_MAP_SUFFIX);
+
+	return map_path;
+}
+
+/*
+ * util_dirty_map_create -- create (or overwrite) the dirty map of the pool
+ *                          with no chunk marked as modified
+ */
+struct dirty_map *
+util_dirty_map_create(const char *path, const uuid_t uuid, uint64_t pool_size,
+		uint64_t generation)
+{
+	LOG(3, "path %s pool_size %" PRIu64 " generation %" PRIu64, path,
+		pool_size, generation);
+
+	COMPILE_ERROR_ON(sizeof(struct dirty_map_hdr) != DIRTY_MAP_HDR_SIZE);
+
+	size_t len = dirty_map_file_size(pool_size);
+
+	int fd = os_open(path, O_RDWR | O_CREAT, 0600);
+	if (fd < 0) {
+		ERR_W_ERRNO("open %s", path);
+		return NULL;
+	}
+
+	struct dirty_map *map = NULL;
+
+	/* the bitmap is cleared, as the file is truncated first */
+	if (os_ftruncate(fd, 0) || os_ftruncate(fd, (os_off_t)len)) {
+		ERR_W_ERRNO("ftruncate %s", path);
+		goto out;
+	}
+
+	map = dirty_map_map(fd, len);
+	if (map == NULL)
+		goto out;
+
+	struct dirty_map_hdr *hdr = map->hdr;
+	memcpy(hdr->signature, DIRTY_MAP_SIG, sizeof(DIRTY_MAP_SIG));
+	hdr->major = htole32(DIRTY_MAP_MAJOR);
+	memcpy(hdr->poolset_uuid, uuid, POOL_HDR_UUID_LEN);
+	hdr->generation = htole64(generation);
+	hdr->chunk_size = htole64(DIRTY_MAP_CHUNK_SIZE);
+	hdr->pool_size = htole64(pool_size);
+	map->nchunks = (pool_size + DIRTY_MAP_CHUNK_SIZE - 1) /
+		DIRTY_MAP_CHUNK_SIZE;
+	map->pool_size = pool_size;
+	map->generation = generation;
+
+	util_persist(map->is_pmem, map->bits, len - DIRTY_MAP_HDR_SIZE);
+	dirty_map_hdr_persist(map);
+
+out:
+	os_close(fd);
+	return map;
+}
+
+/*
+ * util_dirty_map_open -- open the dirty map of the pool
+ *
+ * Returns NULL with errno set to ENOENT if the pool has no dirty map and
+ * to EINVAL if the map is not valid or it belongs to a different pool.
+ */
+struct dirty_map *
+util_dirty_map_open(const char *path, const uuid_t uuid, uint64_t pool_size)
+{
+	LOG(3, "path %s pool_size %" PRIu64, path, pool_size);
+
+	int fd = os_open(path, O_RDWR);
+	if (fd < 0) {
+		if (errno != ENOENT)
+			ERR_W_ERRNO("open %s", path);
+		return NULL;
+	}
+
+	struct dirty_map *map = NULL;
+	size_t len = dirty_map_file_size(pool_size);
+
+	os_stat_t st;
+	if (os_fstat(fd, &st)) {
+		ERR_W_ERRNO("fstat %s", path);
+		goto out;
+	}
+
+	if ((size_t)st.st_size != len) {
+		ERR_WO_ERRNO("%s: invalid size of the dirty map", path);
+		errno = EINVAL;
+		goto out;
+	}
+
+	map = dirty_map_map(fd, len);
+	if (map == NULL)
+		goto out;
+
+	struct dirty_map_hdr *hdr = map->hdr;
+	if (memcmp(hdr->signature, DIRTY_MAP_SIG, sizeof(DIRTY_MAP_SIG)) ||
+			!util_checksum(hdr, sizeof(*hdr), &hdr->checksum,
+			0, 0)) {
+		ERR_WO_ERRNO("%s: invalid dirty map header", path);
+		goto err;
+	}
+
+	if (le32toh(hdr->major) != DIRTY_MAP_MAJOR ||
+			le64toh(hdr->chunk_size) != DIRTY_MAP_CHUNK_SIZE) {
+		ERR_WO_ERRNO("%s: unsupported dirty map version", path);
+		goto err;
+	}
+
+	if (memcmp(hdr->poolset_uuid, uuid, POOL_HDR_UUID_LEN) ||
+			le64toh(hdr->pool_size) != pool_size) {
+		ERR_WO_ERRNO("%s: dirty map of a different pool", path);
+		goto err;
+	}
+
+	/* generations are numbered from 1 by the first full backup */
+	if (hdr->reserved != 0 || le64toh(hdr->generation) == 0) {
+		ERR_WO_ERRNO("%s: invalid dirty map header", path);
+		goto err;
+	}
+
+	map->nchunks = (pool_size + DIRTY_MAP_CHUNK_SIZE - 1) /
+		DIRTY_MAP_CHUNK_SIZE;
+	map->pool_size = pool_size;
+	map->generation = le64toh(hdr->generation);
+
+	/* the transient copy of the bitmap is kept in host byte order */
+	size_t nwords = (len - DIRTY_MAP_HDR_SIZE) / sizeof(uint64_t);
+	for (size_t w = 0; w < nwords; ++w)
+		map->persisted[w] = le64toh(map->bits[w]);
+
+out:
+	os_close(fd);
+	return map;
+
+err:
+	util_dirty_map_close(map);
+	os_close(fd);
+	errno = EINVAL;
+	return NULL;
+}
+
+/*
+ * util_dirty_map_close -- unmap the dirty map
+ */
+void
+util_dirty_map_close(struct dirty_map *map)
+{
+	LOG(3, "map %p", map);
+
+	util_unmap(map->hdr, map->mapped_len);
+	Free(map->persisted);
+	Free(map);
+}
+
+/*
+ * util_dirty_map_mark -- mark the chunks of the given range of the pool
+ *                        as modified
+ *
+ * Only the first write to a chunk in a generation has to persist the map,
+ * any other write is a plain load of the transient copy of the bitmap word.
+ * The transient bit is set only once the persistent one is flushed, so
+ * a thread never skips a bit which another thread has set but not yet
+ * persisted.
+ */
+void
+util_dirty_map_mark(struct dirty_map *map, uint64_t off, size_t len)
+{
+	if (len == 0 || off >= map->pool_size)
+		return;
+
+	uint64_t first = off / DIRTY_MAP_CHUNK_SIZE;
+	uint64_t last = (off + len - 1) / DIRTY_MAP_CHUNK_SIZE;
+	if (last >= map->nchunks)
+		last = map->nchunks - 1;
+
+	uint64_t *lo = NULL;
+	uint64_t *hi = NULL;
+
+	for (uint64_t c = first; c <= last; ++c) {
+		uint64_t mask = 1ULL << (c % 64);
+
+		uint64_t val;
+		util_atomic_load_explicit64(&map->persisted[c / 64], &val,
+			memory_order_acquire);
+		if (val & mask)
+			continue;
+
+		uint64_t *word = &map->bits[c / 64];
+		util_fetch_and_or64(word, htole64(mask));
+		if (lo == NULL)
+			lo = word;
+		hi = word;
+	}
+
+	if (lo == NULL)
+		return;
+
+	util_persist(map->is_pmem, lo, (size_t)(hi - lo + 1) * sizeof(*lo));
+
+	for (uint64_t c = first; c <= last; ++c)
+		util_fetch_and_or64(&map->persisted[c / 64], 1ULL << (c % 64));
+}
+
+/*
+ * util_dirty_map_count -- count the chunks marked as modified
+ */
+uint64_t
+util_dirty_map_count(struct dirty_map *map)
+{
+	uint64_t count = 0;
+
+	/* the number of set bits does not depend on the byte order */
+	for (uint64_t w = 0; w < (map->nchunks + 63) / 64; ++w)
+		count += (uint64_t)__builtin_popcountll(map->bits[w]);
+
+	return count;
+}
+
+/*
+ * util_dirty_map_reset -- clear the map and start a new generation
+ *
+ * Has to be called while the pool is not in use, right after its contents
+ * have been copied to the backup.
+ */
+void
+util_dirty_map_reset(struct dirty_map *map, uint64_t generation)
+{
+	LOG(3, "map %p generation %" PRIu64, map, generation);
+
+	size_t len = map->mapped_len - DIRTY_MAP_HDR_SIZE;
+	memset(map->bits, 0, len);
+	util_persist(map->is_pmem, map->bits, len);
+	memset(map->persisted, 0, len);
+
+	map->hdr->generation = htole64(generation);
+	map->generation = generation;
+	dirty_map_hdr_persist(map);
+}
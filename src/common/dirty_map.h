@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * dirty_map.h -- map of the pool chunks modified since the last backup
+ */
+
+#ifndef PMDK_DIRTY_MAP_H
+#define PMDK_DIRTY_MAP_H 1
+
+#include <endian.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "uuid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DIRTY_MAP_SUFFIX ".dirty"
+#define DIRTY_MAP_SIG "PMEMDIRTY"
+#define DIRTY_MAP_SIG_LEN 16
+#define DIRTY_MAP_MAJOR 1
+#define DIRTY_MAP_HDR_SIZE 4096
+
+/* granularity of the tracking, equal to the size of the heap chunk */
+#define DIRTY_MAP_CHUNK_SIZE ((size_t)256 << 10)
+
+/*
+ * dirty_map_hdr -- header of the dirty map file, followed by the bitmap
+ *	with one bit for each chunk of the pool
+ *
+ * All the fields of the header and the words of the bitmap are stored
+ * in little-endian byte order.
+ */
+struct dirty_map_hdr {
+	char signature[DIRTY_MAP_SIG_LEN];
+	uint32_t major;
+	uint32_t reserved;
+	uuid_t poolset_uuid;	/* uuid of the tracked pool */
+	uint64_t generation;	/* generation of the last backup */
+	uint64_t chunk_size;
+	uint64_t pool_size;
+	unsigned char unused[DIRTY_MAP_HDR_SIZE - 72];
+	uint64_t checksum;
+};
+
+/*
+ * dirty_map -- runtime state of the mapped dirty map file
+ */
+struct dirty_map {
+	struct dirty_map_hdr *hdr;
+	uint64_t *bits;
+	uint64_t *persisted;	/* bits known to be persistent, transient */
+	uint64_t nchunks;
+	uint64_t pool_size;
+	uint64_t generation;	/* generation of the last backup */
+	size_t mapped_len;
+	int is_pmem;
+};
+
+extern int Dirty_map_at_open;
+
+char *util_dirty_map_path(const char *path);
+struct dirty_map *util_dirty_map_create(const char *path,
+	const uuid_t uuid, uint64_t pool_size, uint64_t generation);
+struct dirty_map *util_dirty_map_open(const char *path,
+	const uuid_t uuid, uint64_t pool_size);
+void util_dirty_map_close(struct dirty_map *map);
+void util_dirty_map_mark(struct dirty_map *map, uint64_t off, size_t len);
+uint64_t util_dirty_map_count(struct dirty_map *map);
+void util_dirty_map_reset(struct dirty_map *map, uint64_t generation);
+
+/*
+ * util_dirty_map_test -- check if the chunk has been modified
+ */
+static inline int
+util_dirty_map_test(const struct dirty_map *map, uint64_t chunk)
+{
+	return (le64toh(map->bits[chunk / 64]) & (1ULL << (chunk % 64))) != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* dirty_map.h */
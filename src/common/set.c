@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2024, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 /*
  * Copyright (c) 2016, Microsoft Corporation. All rights reserved.
  *
@@ -48,6 +48,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <endian.h>
 #include <errno.h>
 #include <stddef.h>
@@ -70,6 +71,7 @@
 #include "fs.h"
 #include "os_deep.h"
 #include "set_badblocks.h"
+#include "../libpmem2/prefault.h"
 
 #define SIZE_AUTODETECT_STR "AUTO"
 
@@ -81,6 +83,7 @@
 
 int Prefault_at_open = 0;
 int Prefault_at_create = 0;
+int Prefault_threads = 1;
 int SDS_at_create = POOL_FEAT_INCOMPAT_DEFAULT & POOL_E_FEAT_SDS ? 1 : 0;
 int Fallocate_at_create = 1;
 int COW_at_open = 0;
@@ -140,12 +143,10 @@ static const char *parser_errstr[PARSER_MAX_CODE] = {
 static void
 util_replica_force_page_allocation(struct pool_replica *rep)
 {
-	volatile char *cur_addr = rep->part[0].addr;
-	char *addr_end = (char *)cur_addr + rep->resvsize;
-	for (; cur_addr < addr_end; cur_addr += Pagesize) {
-		*cur_addr = *cur_addr;
-		VALGRIND_SET_CLEAN(cur_addr, 1);
-	}
+	int ret = pmem2_prefault_range(rep->part[0].addr, rep->resvsize, 1,
+		(unsigned)Prefault_threads);
+	if (ret)
+		LOG(2, "cannot prefault the replica: %s", strerror(-ret));
 }
 
 /*
@@ -3363,3 +3364,151 @@ util_replica_deep_drain(const void *addr, size_t len, struct pool_set *set,
 	int flush = 0;
 	return util_replica_deep_common(addr, len, set, replica_id, flush);
 }
+
+/*
+ * util_rebuild_file_alloc -- allocate name of the file marking the replica
+ *                            as being rebuilt, the allocated name has to
+ *                            be freed using Free()
+ */
+char *
+util_rebuild_file_alloc(const char *file, unsigned rep)
+{
+	LOG(3, "file %s rep %u", file, rep);
+
+	char suffix[64];
+	sprintf(suffix, "_r%u_rebuild.txt", rep);
+
+	size_t len_path = strlen(file) + strlen(suffix);
+	char *path = Malloc(len_path + 1);
+	if (path == NULL) {
+		ERR_W_ERRNO("Malloc");
+		return NULL;
+	}
+
+	strcpy(path, file);
+	strcat(path, suffix);
+
+	return path;
+}
+
+/*
+ * util_rebuild_get -- check if the replica is marked as being rebuilt and
+ *                     read the offset up to which its data is up to date
+ *
+ * Returns:
+ *    0 when the replica is not being rebuilt,
+ *    1 when the replica is being rebuilt,
+ *   -1 on error.
+ */
+int
+util_rebuild_get(struct pool_set *set, unsigned repidx, uint64_t *offset)
+{
+	LOG(3, "set %p repidx %u", set, repidx);
+
+	*offset = 0;
+
+	char *path = util_rebuild_file_alloc(set->path, repidx);
+	if (path == NULL)
+		return -1;
+
+	int ret = -1;
+	int fd = os_open(path, O_RDONLY);
+	if (fd < 0) {
+		if (errno == ENOENT)
+			ret = 0;
+		else
+			ERR_W_ERRNO("open %s", path);
+		goto out;
+	}
+
+	char buf[UTIL_REBUILD_OFFSET_LEN + 1];
+	ssize_t rd = read(fd, buf, UTIL_REBUILD_OFFSET_LEN);
+	os_close(fd);
+	if (rd < 0) {
+		ERR_W_ERRNO("read %s", path);
+		goto out;
+	}
+	buf[rd] = '\0';
+
+	/* an empty or malformed marker means nothing was copied yet */
+	char *end;
+	errno = 0;
+	unsigned long long val = strtoull(buf, &end, 10);
+	if (errno == 0 && end != buf)
+		*offset = val;
+
+	LOG(3, "replica %u is being rebuilt, offset %" PRIu64, repidx,
+		*offset);
+
+	ret = 1;
+out:
+	Free(path);
+	return ret;
+}
+
+/*
+ * util_rebuild_set -- mark the replica as being rebuilt and store the offset
+ *                     up to which its data is up to date
+ */
+int
+util_rebuild_set(struct pool_set *set, unsigned repidx, uint64_t offset)
+{
+	LOG(3, "set %p repidx %u offset %" PRIu64, set, repidx, offset);
+
+	char *path = util_rebuild_file_alloc(set->path, repidx);
+	if (path == NULL)
+		return -1;
+
+	int ret = -1;
+	int fd = os_open(path, O_WRONLY | O_CREAT, 0600);
+	if (fd < 0) {
+		ERR_W_ERRNO("open %s", path);
+		goto out;
+	}
+
+	/* fixed width, so that the record is always overwritten in place */
+	char buf[UTIL_REBUILD_OFFSET_LEN + 1];
+	util_snprintf(buf, sizeof(buf), "%0*" PRIu64 "\n",
+		UTIL_REBUILD_OFFSET_LEN - 1, offset);
+
+	if (pwrite(fd, buf, UTIL_REBUILD_OFFSET_LEN, 0) !=
+			UTIL_REBUILD_OFFSET_LEN) {
+		ERR_W_ERRNO("pwrite %s", path);
+		os_close(fd);
+		goto out;
+	}
+
+	if (os_fsync(fd)) {
+		ERR_W_ERRNO("fsync %s", path);
+		os_close(fd);
+		goto out;
+	}
+
+	os_close(fd);
+	ret = 0;
+out:
+	Free(path);
+	return ret;
+}
+
+/*
+ * util_rebuild_clear -- remove the mark of the replica being rebuilt
+ */
+int
+util_rebuild_clear(struct pool_set *set, unsigned repidx)
+{
+	LOG(3, "set %p repidx %u", set, repidx);
+
+	char *path = util_rebuild_file_alloc(set->path, repidx);
+	if (path == NULL)
+		return -1;
+
+	int ret = os_unlink(path);
+	if (ret && errno == ENOENT)
+		ret = 0;
+	else if (ret)
+		ERR_W_ERRNO("unlink %s", path);
+
+	Free(path);
+	return ret;
+}
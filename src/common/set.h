@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2014-2024, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 /*
  * Copyright (c) 2016, Microsoft Corporation. All rights reserved.
  *
@@ -309,6 +309,7 @@ HDRP(struct pool_replica *rep, unsigned p)
 
 extern int Prefault_at_open;
 extern int Prefault_at_create;
+extern int Prefault_threads;
 extern int SDS_at_create;
 extern int Fallocate_at_create;
 extern int COW_at_open;
@@ -375,6 +376,14 @@ void util_replica_fdclose(struct pool_replica *rep);
 int util_replica_close_local(struct pool_replica *rep, unsigned repn,
 		enum del_parts_mode del);
 
+/* length of the record stored in the replica rebuild marker file */
+#define UTIL_REBUILD_OFFSET_LEN 21
+
+char *util_rebuild_file_alloc(const char *file, unsigned rep);
+int util_rebuild_get(struct pool_set *set, unsigned repidx, uint64_t *offset);
+int util_rebuild_set(struct pool_set *set, unsigned repidx, uint64_t offset);
+int util_rebuild_clear(struct pool_set *set, unsigned repidx);
+
 #ifdef __cplusplus
 }
 #endif
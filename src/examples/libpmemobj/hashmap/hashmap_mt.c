@@ -0,0 +1,1441 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * Integer hash set implementation with separate chaining for concurrent use
+ * which uses action.h reserve/publish API.
+ *
+ * Writers of a bucket are serialized by the PMEMmutex of the bucket, readers
+ * take no locks at all. An entry removed from a bucket is put on the garbage
+ * list of the bucket and freed only when no reader may still see it, which is
+ * tracked with epochs.
+ *
+ * The table only grows and it does so incrementally: a table twice as big is
+ * published next to the current one and the writers copy a few buckets of
+ * the previous table to the new one after each of their operations. Once all
+ * of them are copied and nobody uses the previous table anymore, it's freed.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include <libpmemobj.h>
+#include "hashmap_mt.h"
+#include "hashmap_internal.h"
+
+/* layout definition */
+TOID_DECLARE(struct buckets, HASHMAP_MT_TYPE_OFFSET + 1);
+TOID_DECLARE(struct entry, HASHMAP_MT_TYPE_OFFSET + 2);
+
+/* initial number of buckets, must be a power of 2 */
+#define INIT_BUCKETS_NUM_MT 64
+
+/* number of buckets of the previous table processed after an operation */
+#define RESIZE_STEP 4
+
+/* maximum number of removed entries freed at once */
+#define COLLECT_MAX 16
+
+/* number of counters the number of entries is split into, a power of 2 */
+#define COUNTERS_NUM 64
+
+/* maximum number of threads using the hashmaps at the same time */
+#define MAX_THREADS 1024
+
+#define CACHELINE_SIZE 64
+
+/* states of the migration of a bucket */
+#define BUCKET_NOT_MIGRATED 0
+#define BUCKET_MIGRATING 1 /* the entries are being relinked */
+#define BUCKET_MIGRATED 2 /* the entries are in the next table */
+
+/* the table is being resized, the previous one may still be used */
+#define STATE_RESIZING 1ULL
+#define STATE_GEN_SHIFT 1
+
+struct entry {
+	uint64_t key;
+	PMEMoid value;
+
+	/* next entry in the bucket */
+	TOID(struct entry) next;
+
+	/* next removed entry waiting to be freed */
+	TOID(struct entry) gc_next;
+	/* epoch in which the entry was removed */
+	uint64_t epoch;
+};
+
+struct bucket {
+	/* serializes the writers of the bucket */
+	PMEMmutex lock;
+
+	/* entries of the bucket */
+	TOID(struct entry) head;
+	/* removed entries, the most recently removed first */
+	TOID(struct entry) garbage;
+
+	/* state of the migration of the entries to the next table */
+	uint64_t migrated;
+};
+
+struct buckets {
+	/* number of buckets, a power of 2 */
+	size_t nbuckets;
+	/* array of buckets */
+	struct bucket bucket[];
+};
+
+enum resize_phase {
+	RESIZE_IDLE,
+	/* buckets of the previous table are copied to the current one */
+	RESIZE_MIGRATE,
+	/* entries of the previous table are freed */
+	RESIZE_RELEASE,
+	/* the previous table is freed */
+	RESIZE_FREE,
+};
+
+struct counter {
+	int64_t value;
+	char padding[CACHELINE_SIZE - sizeof(int64_t)];
+};
+
+/* volatile state of the hashmap, rebuilt after the pool is opened */
+struct runtime {
+	/* number of entries, split to avoid contention of the writers */
+	struct counter count[COUNTERS_NUM];
+
+	/* protected by resize_lock, phase is read without it too */
+	enum resize_phase phase;
+	/* next bucket of the previous table to be processed */
+	size_t next;
+	/* epoch in which the current phase started */
+	uint64_t epoch;
+};
+
+struct hashmap_mt {
+	/* hash function seed */
+	uint64_t seed;
+
+	/* generation of the current table and STATE_RESIZING flag */
+	uint64_t state;
+	/* the current and the previous table, indexed by the generation */
+	TOID(struct buckets) table[2];
+
+	/* serializes the resize steps */
+	PMEMmutex resize_lock;
+
+	PMEMvlt(struct runtime) runtime;
+};
+
+/*
+ * Epochs: an operation announces the global epoch when it starts and clears
+ * the announcement when it finishes. The global epoch is advanced only when
+ * all of the running operations have announced the current one, so an entry
+ * unlinked in epoch e cannot be reached by anyone once the global epoch is
+ * e + 2. The epochs are shared by all of the hashmaps in the process.
+ */
+struct epoch_slot {
+	/* announced epoch, 0 outside of the operations */
+	uint64_t epoch;
+	/* the slot is assigned to a thread */
+	uint64_t used;
+	char padding[CACHELINE_SIZE - 2 * sizeof(uint64_t)];
+};
+
+static struct {
+	uint64_t epoch;
+	/* number of slots which have ever been assigned */
+	uint64_t nslots;
+	char padding[CACHELINE_SIZE - 2 * sizeof(uint64_t)];
+	struct epoch_slot slot[MAX_THREADS];
+} epochs = {.epoch = 1};
+
+static pthread_once_t epoch_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t epoch_key;
+
+static __thread struct epoch_slot *epoch_slot;
+static __thread unsigned epoch_depth;
+
+/*
+ * epoch_slot_release -- (internal) returns the slot of the exiting thread
+ */
+static void
+epoch_slot_release(void *arg)
+{
+	struct epoch_slot *slot = arg;
+
+	__atomic_store_n(&slot->used, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ * epoch_key_create -- (internal) creates the key used to release the slots
+ */
+static void
+epoch_key_create(void)
+{
+	if (pthread_key_create(&epoch_key, epoch_slot_release)) {
+		fprintf(stderr, "pthread_key_create failed\n");
+		abort();
+	}
+}
+
+/*
+ * epoch_slot_get -- (internal) returns the slot of the calling thread
+ */
+static struct epoch_slot *
+epoch_slot_get(void)
+{
+	if (epoch_slot != NULL)
+		return epoch_slot;
+
+	pthread_once(&epoch_key_once, epoch_key_create);
+
+	for (uint64_t i = 0; i < MAX_THREADS; ++i) {
+		struct epoch_slot *slot = &epochs.slot[i];
+		uint64_t unused = 0;
+		if (!__atomic_compare_exchange_n(&slot->used, &unused, 1, 0,
+				__ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+			continue;
+
+		/* make the slot visible to epoch_try_advance */
+		uint64_t n = __atomic_load_n(&epochs.nslots, __ATOMIC_ACQUIRE);
+		while (n < i + 1 && !__atomic_compare_exchange_n(&epochs.nslots,
+				&n, i + 1, 0, __ATOMIC_ACQ_REL,
+				__ATOMIC_ACQUIRE))
+			;
+
+		pthread_setspecific(epoch_key, slot);
+		epoch_slot = slot;
+
+		return slot;
+	}
+
+	fprintf(stderr, "too many threads use hashmap_mt\n");
+	abort();
+}
+
+/*
+ * epoch_now -- (internal) returns the global epoch
+ */
+static inline uint64_t
+epoch_now(void)
+{
+	return __atomic_load_n(&epochs.epoch, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * epoch_retire -- (internal) returns the epoch in which the objects unlinked
+ * by the preceding stores are retired
+ */
+static inline uint64_t
+epoch_retire(void)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	return epoch_now();
+}
+
+/*
+ * epoch_enter -- (internal) announces the global epoch, the entries
+ * reachable from now on are not freed until epoch_exit
+ */
+static void
+epoch_enter(void)
+{
+	if (epoch_depth++ != 0)
+		return;
+
+	struct epoch_slot *slot = epoch_slot_get();
+	uint64_t announced;
+	uint64_t e = epoch_now();
+	do {
+		announced = e;
+		__atomic_store_n(&slot->epoch, announced, __ATOMIC_SEQ_CST);
+		e = epoch_now();
+	} while (e != announced);
+}
+
+/*
+ * epoch_exit -- (internal) clears the announcement of epoch_enter
+ */
+static void
+epoch_exit(void)
+{
+	if (--epoch_depth != 0)
+		return;
+
+	__atomic_store_n(&epoch_slot->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ * epoch_try_advance -- (internal) advances the global epoch if all of the
+ * running operations have announced the current one
+ */
+static void
+epoch_try_advance(void)
+{
+	uint64_t e = epoch_now();
+	uint64_t n = __atomic_load_n(&epochs.nslots, __ATOMIC_ACQUIRE);
+
+	for (uint64_t i = 0; i < n; ++i) {
+		uint64_t s = __atomic_load_n(&epochs.slot[i].epoch,
+			__ATOMIC_SEQ_CST);
+		if (s != 0 && s != e)
+			return;
+	}
+
+	__atomic_compare_exchange_n(&epochs.epoch, &e, e + 1, 0,
+		__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * epoch_safe -- (internal) checks whether the objects unlinked in the epoch
+ * cannot be reached anymore
+ */
+static int
+epoch_safe(uint64_t epoch)
+{
+	if (epoch_now() >= epoch + 2)
+		return 1;
+
+	epoch_try_advance();
+
+	return epoch_now() >= epoch + 2;
+}
+
+/*
+ * hash -- hash function based on Austin Appleby MurmurHash3 64-bit finalizer
+ */
+static inline uint64_t
+hash(const struct hashmap_mt *hashmap, uint64_t key)
+{
+	key ^= hashmap->seed;
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccd;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53;
+	key ^= key >> 33;
+
+	return key;
+}
+
+/*
+ * off_ptr -- (internal) returns the pointer to the object at the offset,
+ * which may be modified concurrently, NULL if the offset is 0
+ */
+static inline void *
+off_ptr(PMEMobjpool *pop, uint64_t *off)
+{
+	uint64_t o = __atomic_load_n(off, __ATOMIC_ACQUIRE);
+
+	return o == 0 ? NULL : (char *)pop + o;
+}
+
+/*
+ * entry_get -- (internal) returns the entry pointed to by the link
+ */
+static inline struct entry *
+entry_get(PMEMobjpool *pop, TOID(struct entry) *link)
+{
+	return off_ptr(pop, &link->oid.off);
+}
+
+/*
+ * bucket_get -- (internal) returns the bucket of the table for the hash
+ */
+static inline struct bucket *
+bucket_get(struct buckets *table, uint64_t h)
+{
+	return &table->bucket[h & (table->nbuckets - 1)];
+}
+
+/*
+ * bucket_state -- (internal) returns the state of the migration of the bucket
+ */
+static inline uint64_t
+bucket_state(struct bucket *b)
+{
+	return __atomic_load_n(&b->migrated, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * bucket_lock -- (internal) locks the bucket
+ */
+static void
+bucket_lock(PMEMobjpool *pop, struct bucket *b)
+{
+	if (pmemobj_mutex_lock(pop, &b->lock)) {
+		fprintf(stderr, "bucket lock failed: %s\n",
+			pmemobj_errormsg());
+		abort();
+	}
+}
+
+/*
+ * bucket_unlock -- (internal) unlocks the bucket
+ */
+static void
+bucket_unlock(PMEMobjpool *pop, struct bucket *b)
+{
+	pmemobj_mutex_unlock(pop, &b->lock);
+}
+
+/*
+ * tables_get -- (internal) returns the current table and the previous one,
+ * which is NULL unless the hashmap is being resized
+ */
+static void
+tables_get(PMEMobjpool *pop, struct hashmap_mt *hashmap,
+	struct buckets **cur, struct buckets **prev)
+{
+	uint64_t state;
+	uint64_t gen;
+
+	/* the offset of the new table is published together with the state */
+	do {
+		state = __atomic_load_n(&hashmap->state, __ATOMIC_ACQUIRE);
+		gen = state >> STATE_GEN_SHIFT;
+		*cur = off_ptr(pop, &hashmap->table[gen & 1].oid.off);
+	} while (*cur == NULL);
+
+	*prev = NULL;
+	if (state & STATE_RESIZING)
+		*prev = off_ptr(pop, &hashmap->table[(gen + 1) & 1].oid.off);
+}
+
+/*
+ * bucket_wait -- (internal) waits for the migration of the bucket to finish
+ */
+static void
+bucket_wait(PMEMobjpool *pop, struct bucket *b)
+{
+	bucket_lock(pop, b);
+	bucket_unlock(pop, b);
+}
+
+/*
+ * bucket_find -- (internal) returns the bucket in which the key should be
+ * looked up, must be called in an epoch
+ */
+static struct bucket *
+bucket_find(PMEMobjpool *pop, struct hashmap_mt *hashmap, uint64_t h)
+{
+	struct buckets *cur;
+	struct buckets *prev;
+	struct bucket *b;
+
+	for (;;) {
+		tables_get(pop, hashmap, &cur, &prev);
+
+		b = NULL;
+		if (prev != NULL) {
+			b = bucket_get(prev, h);
+			if (bucket_state(b) == BUCKET_MIGRATED)
+				b = NULL;
+		}
+
+		if (b == NULL)
+			b = bucket_get(cur, h);
+
+		switch (bucket_state(b)) {
+		case BUCKET_NOT_MIGRATED:
+			return b;
+		case BUCKET_MIGRATING:
+			bucket_wait(pop, b);
+			break;
+		default:
+			/* a newer table has been published in the meantime */
+			break;
+		}
+	}
+}
+
+/*
+ * entry_find -- (internal) returns the entry with the key, must be called in
+ * an epoch
+ */
+static struct entry *
+entry_find(PMEMobjpool *pop, struct hashmap_mt *hashmap, uint64_t key)
+{
+	uint64_t h = hash(hashmap, key);
+
+	for (;;) {
+		struct bucket *b = bucket_find(pop, hashmap, h);
+
+		for (struct entry *e = entry_get(pop, &b->head); e != NULL;
+				e = entry_get(pop, &e->next)) {
+			if (e->key == key)
+				return e;
+		}
+
+		/*
+		 * The entries may have been relinked during the search, in
+		 * which case the key could have been missed.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (bucket_state(b) == BUCKET_NOT_MIGRATED)
+			return NULL;
+	}
+}
+
+/*
+ * bucket_lock_key -- (internal) locks and returns the bucket in which the key
+ * belongs, must be called in an epoch
+ */
+static struct bucket *
+bucket_lock_key(PMEMobjpool *pop, struct hashmap_mt *hashmap, uint64_t h)
+{
+	struct buckets *cur;
+	struct buckets *prev;
+	struct bucket *b;
+
+	for (;;) {
+		tables_get(pop, hashmap, &cur, &prev);
+
+		if (prev != NULL) {
+			b = bucket_get(prev, h);
+			bucket_lock(pop, b);
+			if (b->migrated == BUCKET_NOT_MIGRATED)
+				return b;
+			bucket_unlock(pop, b);
+		}
+
+		b = bucket_get(cur, h);
+		bucket_lock(pop, b);
+		if (b->migrated == BUCKET_NOT_MIGRATED)
+			return b;
+		bucket_unlock(pop, b);
+	}
+}
+
+/*
+ * bucket_collect -- (internal) frees the removed entries of the locked bucket
+ * which cannot be reached anymore, or all of them if all is set, at most
+ * COLLECT_MAX entries are freed at once
+ */
+static int
+bucket_collect(PMEMobjpool *pop, struct bucket *b, int all)
+{
+	uint64_t *link = &b->garbage.oid.off;
+	struct entry *e = entry_get(pop, &b->garbage);
+	if (e == NULL)
+		return 0;
+
+	/* the oldest entries are at the end of the list */
+	uint64_t now = epoch_now();
+	while (e != NULL && !all && e->epoch + 2 > now) {
+		link = &e->gc_next.oid.off;
+		e = entry_get(pop, &e->gc_next);
+	}
+
+	if (e == NULL) {
+		epoch_try_advance();
+		return 0;
+	}
+
+	struct pobj_action actv[COLLECT_MAX + 1];
+	size_t actv_cnt = 0;
+
+	for (; e != NULL && actv_cnt < COLLECT_MAX;
+			e = entry_get(pop, &e->gc_next))
+		pmemobj_defer_free(pop, pmemobj_oid(e), &actv[actv_cnt++]);
+
+	pmemobj_set_value(pop, &actv[actv_cnt++], link,
+		e == NULL ? 0 : pmemobj_oid(e).off);
+
+	return pmemobj_publish(pop, actv, actv_cnt);
+}
+
+/*
+ * bucket_collect_all -- (internal) frees all of the removed entries of
+ * the bucket, nobody else may use the hashmap
+ */
+static int
+bucket_collect_all(PMEMobjpool *pop, struct bucket *b)
+{
+	while (!TOID_IS_NULL(b->garbage)) {
+		if (bucket_collect(pop, b, 1))
+			return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * bucket_release -- (internal) frees all of the entries of the bucket, which
+ * is not used anymore
+ */
+static int
+bucket_release(PMEMobjpool *pop, struct bucket *b)
+{
+	size_t n = 0;
+	for (struct entry *e = entry_get(pop, &b->head); e != NULL;
+			e = entry_get(pop, &e->next))
+		n++;
+	for (struct entry *e = entry_get(pop, &b->garbage); e != NULL;
+			e = entry_get(pop, &e->gc_next))
+		n++;
+
+	if (n == 0)
+		return 0;
+
+	struct pobj_action *actv = malloc((n + 2) * sizeof(*actv));
+	if (actv == NULL)
+		return -1;
+
+	size_t actv_cnt = 0;
+	for (struct entry *e = entry_get(pop, &b->head); e != NULL;
+			e = entry_get(pop, &e->next))
+		pmemobj_defer_free(pop, pmemobj_oid(e), &actv[actv_cnt++]);
+	for (struct entry *e = entry_get(pop, &b->garbage); e != NULL;
+			e = entry_get(pop, &e->gc_next))
+		pmemobj_defer_free(pop, pmemobj_oid(e), &actv[actv_cnt++]);
+
+	pmemobj_set_value(pop, &actv[actv_cnt++], &b->head.oid.off, 0);
+	pmemobj_set_value(pop, &actv[actv_cnt++], &b->garbage.oid.off, 0);
+
+	int ret = pmemobj_publish(pop, actv, actv_cnt);
+	free(actv);
+
+	return ret;
+}
+
+/*
+ * table_reserve -- (internal) reserves a table with empty buckets
+ */
+static PMEMoid
+table_reserve(PMEMobjpool *pop, struct pobj_action *act, size_t nbuckets,
+	uint64_t pool_uuid_lo)
+{
+	size_t sz = sizeof(struct buckets) + nbuckets * sizeof(struct bucket);
+
+	PMEMoid oid = pmemobj_xreserve(pop, act, sz,
+		TOID_TYPE_NUM(struct buckets), POBJ_XALLOC_ZERO);
+	if (OID_IS_NULL(oid)) {
+		fprintf(stderr, "table alloc failed: %s\n",
+			pmemobj_errormsg());
+		return oid;
+	}
+
+	struct buckets *table = pmemobj_direct(oid);
+	table->nbuckets = nbuckets;
+	for (size_t i = 0; i < nbuckets; ++i) {
+		table->bucket[i].head.oid.pool_uuid_lo = pool_uuid_lo;
+		table->bucket[i].garbage.oid.pool_uuid_lo = pool_uuid_lo;
+	}
+	pmemobj_persist(pop, table, sz);
+
+	return oid;
+}
+
+/*
+ * table_grow -- (internal) publishes a table twice as big as the current one
+ * and starts the resize, called with resize_lock held
+ */
+static int
+table_grow(PMEMobjpool *pop, struct hashmap_mt *hashmap, struct runtime *rt)
+{
+	struct buckets *cur;
+	struct buckets *prev;
+	tables_get(pop, hashmap, &cur, &prev);
+
+	uint64_t gen = (hashmap->state >> STATE_GEN_SHIFT) + 1;
+	struct pobj_action actv[3];
+
+	PMEMoid table = table_reserve(pop, &actv[0], cur->nbuckets * 2,
+		hashmap->table[0].oid.pool_uuid_lo);
+	if (OID_IS_NULL(table))
+		return -1;
+
+	pmemobj_set_value(pop, &actv[1], &hashmap->table[gen & 1].oid.off,
+		table.off);
+	pmemobj_set_value(pop, &actv[2], &hashmap->state,
+		(gen << STATE_GEN_SHIFT) | STATE_RESIZING);
+
+	if (pmemobj_publish(pop, actv, 3))
+		return -1;
+
+	rt->next = 0;
+	__atomic_store_n(&rt->phase, RESIZE_MIGRATE, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/*
+ * bucket_migrate -- (internal) moves the entries of the bucket of the previous
+ * table to the current one, the entries of the bucket i can only go to the
+ * buckets i and i + nbuckets of the current table, which are empty
+ *
+ * The entries are relinked in place, so the lock-free readers may still be
+ * traversing them. The order of the entries is preserved, all of the links
+ * point forward at any time and a reader cannot loop, but it can miss an
+ * entry, which it detects by the state of the bucket.
+ */
+static int
+bucket_migrate(PMEMobjpool *pop, struct hashmap_mt *hashmap,
+	struct buckets *prev, struct buckets *cur, size_t i)
+{
+	struct bucket *src = &prev->bucket[i];
+	struct bucket *dst[2] = {
+		&cur->bucket[i],
+		&cur->bucket[i + prev->nbuckets],
+	};
+	struct entry *tail[2] = {NULL, NULL};
+	int ret = 0;
+
+	bucket_lock(pop, src);
+
+	size_t n = 0;
+	for (struct entry *e = entry_get(pop, &src->head); e != NULL;
+			e = entry_get(pop, &e->next))
+		n++;
+
+	/* a link per entry and the heads of the buckets at most */
+	struct pobj_action *actv = malloc((n + 3) * sizeof(*actv));
+	if (actv == NULL) {
+		ret = -1;
+		goto out;
+	}
+
+	/* has to be persistent in case the pool is closed after the publish */
+	__atomic_store_n(&src->migrated, BUCKET_MIGRATING, __ATOMIC_SEQ_CST);
+	pmemobj_persist(pop, &src->migrated, sizeof(src->migrated));
+
+	size_t actv_cnt = 0;
+	for (struct entry *e = entry_get(pop, &src->head); e != NULL;
+			e = entry_get(pop, &e->next)) {
+		int d = bucket_get(cur, hash(hashmap, e->key)) != dst[0];
+		uint64_t off = pmemobj_oid(e).off;
+
+		if (tail[d] == NULL)
+			pmemobj_set_value(pop, &actv[actv_cnt++],
+				&dst[d]->head.oid.off, off);
+		else if (tail[d]->next.oid.off != off)
+			pmemobj_set_value(pop, &actv[actv_cnt++],
+				&tail[d]->next.oid.off, off);
+		tail[d] = e;
+	}
+
+	for (int d = 0; d < 2; ++d) {
+		if (tail[d] != NULL && tail[d]->next.oid.off != 0)
+			pmemobj_set_value(pop, &actv[actv_cnt++],
+				&tail[d]->next.oid.off, 0);
+	}
+
+	if (actv_cnt != 0) {
+		pmemobj_set_value(pop, &actv[actv_cnt++], &src->head.oid.off,
+			0);
+
+		if (pmemobj_publish(pop, actv, actv_cnt)) {
+			__atomic_store_n(&src->migrated, BUCKET_NOT_MIGRATED,
+				__ATOMIC_RELEASE);
+			pmemobj_persist(pop, &src->migrated,
+				sizeof(src->migrated));
+			ret = -1;
+			goto out;
+		}
+	}
+
+	/* from now on the entries are looked up in the current table */
+	__atomic_store_n(&src->migrated, BUCKET_MIGRATED, __ATOMIC_RELEASE);
+	pmemobj_persist(pop, &src->migrated, sizeof(src->migrated));
+
+out:
+	bucket_unlock(pop, src);
+	free(actv);
+
+	return ret;
+}
+
+/*
+ * table_free -- (internal) frees the previous table
+ */
+static int
+table_free(PMEMobjpool *pop, struct hashmap_mt *hashmap)
+{
+	uint64_t gen = hashmap->state >> STATE_GEN_SHIFT;
+	TOID(struct buckets) *slot = &hashmap->table[(gen + 1) & 1];
+	struct pobj_action actv[2];
+
+	pmemobj_defer_free(pop, slot->oid, &actv[0]);
+	pmemobj_set_value(pop, &actv[1], &slot->oid.off, 0);
+
+	return pmemobj_publish(pop, actv, 2);
+}
+
+/*
+ * resize_advance -- (internal) performs a part of the resize in progress,
+ * called with resize_lock held
+ */
+static int
+resize_advance(PMEMobjpool *pop, struct hashmap_mt *hashmap,
+	struct runtime *rt)
+{
+	uint64_t gen = hashmap->state >> STATE_GEN_SHIFT;
+	struct buckets *cur = D_RW(hashmap->table[gen & 1]);
+	struct buckets *prev = D_RW(hashmap->table[(gen + 1) & 1]);
+
+	switch (rt->phase) {
+	case RESIZE_MIGRATE:
+		for (int i = 0; i < RESIZE_STEP &&
+				rt->next < prev->nbuckets; ++rt->next) {
+			/* already done before the pool was closed */
+			if (prev->bucket[rt->next].migrated == BUCKET_MIGRATED)
+				continue;
+			if (bucket_migrate(pop, hashmap, prev, cur, rt->next))
+				return -1;
+			++i;
+		}
+
+		if (rt->next == prev->nbuckets) {
+			rt->next = 0;
+			rt->epoch = epoch_retire();
+			__atomic_store_n(&rt->phase, RESIZE_RELEASE,
+				__ATOMIC_RELEASE);
+		}
+		break;
+	case RESIZE_RELEASE:
+		if (!epoch_safe(rt->epoch))
+			return 0;
+
+		/* the writers do not modify the migrated buckets */
+		for (int i = 0; i < RESIZE_STEP &&
+				rt->next < prev->nbuckets; ++i, ++rt->next) {
+			if (bucket_release(pop, &prev->bucket[rt->next]))
+				return -1;
+		}
+
+		if (rt->next == prev->nbuckets) {
+			__atomic_store_n(&hashmap->state,
+				hashmap->state & ~STATE_RESIZING,
+				__ATOMIC_RELEASE);
+			pmemobj_persist(pop, &hashmap->state,
+				sizeof(hashmap->state));
+			rt->epoch = epoch_retire();
+			__atomic_store_n(&rt->phase, RESIZE_FREE,
+				__ATOMIC_RELEASE);
+		}
+		break;
+	case RESIZE_FREE:
+		if (!epoch_safe(rt->epoch))
+			return 0;
+		if (table_free(pop, hashmap))
+			return -1;
+		__atomic_store_n(&rt->phase, RESIZE_IDLE, __ATOMIC_RELEASE);
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+/*
+ * counter_add -- (internal) adds the value to the number of entries
+ */
+static inline void
+counter_add(struct runtime *rt, uint64_t h, int64_t value)
+{
+	__atomic_fetch_add(&rt->count[h & (COUNTERS_NUM - 1)].value, value,
+		__ATOMIC_RELAXED);
+}
+
+/*
+ * runtime_count -- (internal) returns the number of entries
+ */
+static size_t
+runtime_count(struct runtime *rt)
+{
+	int64_t count = 0;
+	for (size_t i = 0; i < COUNTERS_NUM; ++i)
+		count += __atomic_load_n(&rt->count[i].value,
+			__ATOMIC_RELAXED);
+
+	/* the counters are not read atomically as a whole */
+	return count < 0 ? 0 : (size_t)count;
+}
+
+/*
+ * resize_step -- (internal) starts the resize if the bucket to which an
+ * entry was inserted is too long, or continues the resize in progress
+ */
+static void
+resize_step(PMEMobjpool *pop, struct hashmap_mt *hashmap,
+	struct runtime *rt, size_t num)
+{
+	if (__atomic_load_n(&rt->phase, __ATOMIC_ACQUIRE) == RESIZE_IDLE &&
+			num <= MIN_HASHSET_THRESHOLD)
+		return;
+
+	/* someone else is doing it already */
+	if (pmemobj_mutex_trylock(pop, &hashmap->resize_lock))
+		return;
+
+	if (rt->phase != RESIZE_IDLE) {
+		resize_advance(pop, hashmap, rt);
+	} else {
+		uint64_t gen = hashmap->state >> STATE_GEN_SHIFT;
+		size_t nbuckets = D_RO(hashmap->table[gen & 1])->nbuckets;
+		size_t count = runtime_count(rt);
+
+		if (num > MAX_HASHSET_THRESHOLD ||
+				(num > MIN_HASHSET_THRESHOLD &&
+				count > 2 * nbuckets))
+			table_grow(pop, hashmap, rt);
+	}
+
+	pmemobj_mutex_unlock(pop, &hashmap->resize_lock);
+}
+
+/*
+ * bucket_foreach -- (internal) calls the callback for each entry of the bucket
+ */
+static int
+bucket_foreach(PMEMobjpool *pop, struct bucket *b,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	int ret = 0;
+
+	for (struct entry *e = entry_get(pop, &b->head); e != NULL && !ret;
+			e = entry_get(pop, &e->next))
+		ret = cb(e->key, e->value, arg);
+
+	return ret;
+}
+
+/*
+ * entries_foreach -- (internal) calls the callback for each entry of the
+ * hashmap, must be called in an epoch with resize_lock held, so that the
+ * entries are not relinked in the meantime
+ */
+static int
+entries_foreach(PMEMobjpool *pop, struct hashmap_mt *hashmap,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	struct buckets *cur;
+	struct buckets *prev;
+	int ret = 0;
+
+	tables_get(pop, hashmap, &cur, &prev);
+
+	if (prev == NULL) {
+		for (size_t i = 0; i < cur->nbuckets && !ret; ++i)
+			ret = bucket_foreach(pop, &cur->bucket[i], cb, arg);
+
+		return ret;
+	}
+
+	for (size_t i = 0; i < prev->nbuckets && !ret; ++i) {
+		if (prev->bucket[i].migrated != BUCKET_MIGRATED) {
+			ret = bucket_foreach(pop, &prev->bucket[i], cb, arg);
+			continue;
+		}
+
+		ret = bucket_foreach(pop, &cur->bucket[i], cb, arg);
+		if (!ret)
+			ret = bucket_foreach(pop,
+				&cur->bucket[i + prev->nbuckets], cb, arg);
+	}
+
+	return ret;
+}
+
+/*
+ * count_entry -- (internal) foreach callback counting the entries
+ */
+static int
+count_entry(uint64_t key, PMEMoid value, void *arg)
+{
+	(*(int64_t *)arg)++;
+
+	return 0;
+}
+
+struct runtime_args {
+	PMEMobjpool *pop;
+	struct hashmap_mt *hashmap;
+};
+
+/*
+ * runtime_construct -- (internal) recovers the hashmap after the pool is
+ * opened, before any operation is performed on it
+ */
+static int
+runtime_construct(void *ptr, void *arg)
+{
+	struct runtime *rt = ptr;
+	struct runtime_args *args = arg;
+	PMEMobjpool *pop = args->pop;
+	struct hashmap_mt *hashmap = args->hashmap;
+
+	memset(rt, 0, sizeof(*rt));
+
+	uint64_t gen = hashmap->state >> STATE_GEN_SHIFT;
+	struct buckets *cur = D_RW(hashmap->table[gen & 1]);
+	struct buckets *prev = NULL;
+	if (!TOID_IS_NULL(hashmap->table[(gen + 1) & 1]))
+		prev = D_RW(hashmap->table[(gen + 1) & 1]);
+
+	if (prev != NULL && (hashmap->state & STATE_RESIZING)) {
+		size_t migrated = 0;
+		for (size_t i = 0; i < prev->nbuckets; ++i) {
+			struct bucket *b = &prev->bucket[i];
+
+			/* the head is cleared by the publish of migration */
+			if (b->migrated == BUCKET_MIGRATING) {
+				b->migrated = TOID_IS_NULL(b->head) ?
+					BUCKET_MIGRATED : BUCKET_NOT_MIGRATED;
+				pmemobj_persist(pop, &b->migrated,
+					sizeof(b->migrated));
+			}
+
+			if (b->migrated == BUCKET_MIGRATED)
+				migrated++;
+		}
+
+		rt->phase = migrated == prev->nbuckets ?
+			RESIZE_RELEASE : RESIZE_MIGRATE;
+	} else if (prev != NULL) {
+		rt->phase = RESIZE_FREE;
+	}
+
+	/* nobody can see the removed entries anymore */
+	for (size_t i = 0; i < cur->nbuckets; ++i) {
+		if (bucket_collect_all(pop, &cur->bucket[i]))
+			return -1;
+	}
+	if (rt->phase == RESIZE_MIGRATE) {
+		for (size_t i = 0; i < prev->nbuckets; ++i) {
+			if (prev->bucket[i].migrated != BUCKET_MIGRATED &&
+					bucket_collect_all(pop,
+					&prev->bucket[i]))
+				return -1;
+		}
+	}
+
+	epoch_enter();
+	entries_foreach(pop, hashmap, count_entry, &rt->count[0].value);
+	epoch_exit();
+
+	return 0;
+}
+
+/*
+ * runtime_get -- (internal) returns the volatile state of the hashmap
+ */
+static struct runtime *
+runtime_get(PMEMobjpool *pop, struct hashmap_mt *hashmap)
+{
+	struct runtime_args args = {pop, hashmap};
+
+	return pmemobj_volatile(pop, &hashmap->runtime.vlt,
+		&hashmap->runtime.value, sizeof(hashmap->runtime.value),
+		runtime_construct, &args);
+}
+
+/*
+ * hashmap_create -- hashmap initializer
+ */
+static int
+hashmap_create(PMEMobjpool *pop, TOID(struct hashmap_mt) *hashmap_p,
+	uint32_t seed)
+{
+	struct pobj_action actv[4];
+	size_t actv_cnt = 0;
+
+	TOID(struct hashmap_mt) hashmap =
+		POBJ_RESERVE_NEW(pop, struct hashmap_mt, &actv[actv_cnt]);
+	if (TOID_IS_NULL(hashmap))
+		goto reserve_err;
+	actv_cnt++;
+
+	uint64_t pool_uuid_lo = hashmap.oid.pool_uuid_lo;
+	struct hashmap_mt *h = D_RW(hashmap);
+	memset(h, 0, sizeof(*h));
+	h->seed = seed;
+
+	h->table[0].oid = table_reserve(pop, &actv[actv_cnt],
+		INIT_BUCKETS_NUM_MT, pool_uuid_lo);
+	if (TOID_IS_NULL(h->table[0]))
+		goto reserve_err;
+	actv_cnt++;
+	h->table[1].oid.pool_uuid_lo = pool_uuid_lo;
+
+	pmemobj_persist(pop, h, sizeof(*h));
+
+	pmemobj_set_value(pop, &actv[actv_cnt++], &hashmap_p->oid.pool_uuid_lo,
+		hashmap.oid.pool_uuid_lo);
+	pmemobj_set_value(pop, &actv[actv_cnt++], &hashmap_p->oid.off,
+		hashmap.oid.off);
+
+	return pmemobj_publish(pop, actv, actv_cnt);
+
+reserve_err:
+	fprintf(stderr, "hashmap alloc failed: %s\n", pmemobj_errormsg());
+	pmemobj_cancel(pop, actv, actv_cnt);
+	return -1;
+}
+
+/*
+ * hm_mt_create -- allocates new hashmap
+ */
+int
+hm_mt_create(PMEMobjpool *pop, TOID(struct hashmap_mt) *map, void *arg)
+{
+	struct hashmap_args *args = (struct hashmap_args *)arg;
+	uint32_t seed = args ? args->seed : 0;
+
+	return hashmap_create(pop, map, seed);
+}
+
+/*
+ * hm_mt_check -- checks if specified persistent object is an instance of
+ * hashmap
+ */
+int
+hm_mt_check(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap)
+{
+	return TOID_IS_NULL(hashmap) || !TOID_VALID(hashmap);
+}
+
+/*
+ * hm_mt_init -- recovers hashmap state, called after pmemobj_open
+ */
+int
+hm_mt_init(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap)
+{
+	srand((unsigned)D_RO(hashmap)->seed);
+
+	return runtime_get(pop, D_RW(hashmap)) == NULL ? -1 : 0;
+}
+
+/*
+ * hm_mt_insert -- inserts specified value into the hashmap,
+ * returns:
+ * - 0 if successful,
+ * - 1 if value already existed,
+ * - -1 if something bad happened
+ */
+int
+hm_mt_insert(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+		uint64_t key, PMEMoid value)
+{
+	struct hashmap_mt *h = D_RW(hashmap);
+	struct runtime *rt = runtime_get(pop, h);
+	if (rt == NULL)
+		return -1;
+
+	uint64_t hv = hash(h, key);
+	size_t num = 0;
+	int ret = 0;
+
+	epoch_enter();
+
+	struct bucket *b = bucket_lock_key(pop, h, hv);
+	bucket_collect(pop, b, 0);
+
+	for (struct entry *e = entry_get(pop, &b->head); e != NULL;
+			e = entry_get(pop, &e->next)) {
+		if (e->key == key) {
+			ret = 1;
+			break;
+		}
+		num++;
+	}
+
+	struct pobj_action actv[2];
+	PMEMoid oid = OID_NULL;
+	if (ret == 0) {
+		oid = pmemobj_reserve(pop, &actv[0], sizeof(struct entry),
+			TOID_TYPE_NUM(struct entry));
+		if (OID_IS_NULL(oid)) {
+			fprintf(stderr, "entry alloc failed: %s\n",
+				pmemobj_errormsg());
+			ret = -1;
+		}
+	}
+
+	if (ret == 0) {
+		struct entry *e = pmemobj_direct(oid);
+		e->key = key;
+		e->value = value;
+		e->next = b->head;
+		e->gc_next.oid.pool_uuid_lo = oid.pool_uuid_lo;
+		e->gc_next.oid.off = 0;
+		e->epoch = 0;
+		pmemobj_persist(pop, e, sizeof(*e));
+
+		pmemobj_set_value(pop, &actv[1], &b->head.oid.off, oid.off);
+		ret = pmemobj_publish(pop, actv, 2);
+	}
+
+	if (ret == 0)
+		counter_add(rt, hv, 1);
+
+	bucket_unlock(pop, b);
+	epoch_exit();
+
+	if (ret == 0)
+		resize_step(pop, h, rt, num + 1);
+
+	return ret;
+}
+
+/*
+ * hm_mt_remove -- removes specified value from the hashmap,
+ * returns:
+ * - key's value if successful,
+ * - OID_NULL if value didn't exist or if something bad happened
+ */
+PMEMoid
+hm_mt_remove(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap, uint64_t key)
+{
+	struct hashmap_mt *h = D_RW(hashmap);
+	struct runtime *rt = runtime_get(pop, h);
+	if (rt == NULL)
+		return OID_NULL;
+
+	uint64_t hv = hash(h, key);
+	PMEMoid ret = OID_NULL;
+
+	epoch_enter();
+
+	struct bucket *b = bucket_lock_key(pop, h, hv);
+	bucket_collect(pop, b, 0);
+
+	uint64_t *link = &b->head.oid.off;
+	struct entry *e;
+	for (e = entry_get(pop, &b->head); e != NULL;
+			e = entry_get(pop, &e->next)) {
+		if (e->key == key)
+			break;
+		link = &e->next.oid.off;
+	}
+
+	if (e != NULL) {
+		/* the removed entries are read only by the writers */
+		e->gc_next = b->garbage;
+		pmemobj_persist(pop, &e->gc_next, sizeof(e->gc_next));
+
+		struct pobj_action actv[2];
+		pmemobj_set_value(pop, &actv[0], link, e->next.oid.off);
+		pmemobj_set_value(pop, &actv[1], &b->garbage.oid.off,
+			pmemobj_oid(e).off);
+
+		if (pmemobj_publish(pop, actv, 2) == 0) {
+			/* readers which started before may still see it */
+			e->epoch = epoch_retire();
+			pmemobj_persist(pop, &e->epoch, sizeof(e->epoch));
+
+			counter_add(rt, hv, -1);
+			ret = e->value;
+		}
+	}
+
+	bucket_unlock(pop, b);
+	epoch_exit();
+
+	resize_step(pop, h, rt, 0);
+
+	return ret;
+}
+
+/*
+ * hm_mt_get -- checks whether specified value is in the hashmap
+ */
+PMEMoid
+hm_mt_get(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap, uint64_t key)
+{
+	struct hashmap_mt *h = D_RW(hashmap);
+	PMEMoid ret = OID_NULL;
+
+	/* the buckets may have to be recovered first */
+	if (runtime_get(pop, h) == NULL)
+		return ret;
+
+	epoch_enter();
+
+	struct entry *e = entry_find(pop, h, key);
+	if (e != NULL)
+		ret = e->value;
+
+	epoch_exit();
+
+	return ret;
+}
+
+/*
+ * hm_mt_lookup -- checks whether specified value exists
+ */
+int
+hm_mt_lookup(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap, uint64_t key)
+{
+	struct hashmap_mt *h = D_RW(hashmap);
+	if (runtime_get(pop, h) == NULL)
+		return 0;
+
+	epoch_enter();
+
+	int ret = entry_find(pop, h, key) != NULL;
+
+	epoch_exit();
+
+	return ret;
+}
+
+/*
+ * hm_mt_foreach -- prints all values from the hashmap, the entries inserted or
+ * removed in the meantime may or may not be visited, the resize is suspended
+ * until it returns
+ */
+int
+hm_mt_foreach(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	struct hashmap_mt *h = D_RW(hashmap);
+	if (runtime_get(pop, h) == NULL)
+		return -1;
+
+	if (pmemobj_mutex_lock(pop, &h->resize_lock))
+		return -1;
+	epoch_enter();
+
+	int ret = entries_foreach(pop, h, cb, arg);
+
+	epoch_exit();
+	pmemobj_mutex_unlock(pop, &h->resize_lock);
+
+	return ret;
+}
+
+/*
+ * hm_mt_count -- returns number of elements
+ */
+size_t
+hm_mt_count(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap)
+{
+	struct runtime *rt = runtime_get(pop, D_RW(hashmap));
+	if (rt == NULL)
+		return 0;
+
+	return runtime_count(rt);
+}
+
+/*
+ * hm_mt_rebuild -- doubles the number of buckets and waits for the resize to
+ * finish, must not be called in an epoch
+ */
+static int
+hm_mt_rebuild(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap)
+{
+	struct hashmap_mt *h = D_RW(hashmap);
+	struct runtime *rt = runtime_get(pop, h);
+	if (rt == NULL)
+		return -1;
+
+	if (pmemobj_mutex_lock(pop, &h->resize_lock))
+		return -1;
+
+	int ret = 0;
+	if (rt->phase == RESIZE_IDLE)
+		ret = table_grow(pop, h, rt);
+
+	while (ret == 0 && rt->phase != RESIZE_IDLE) {
+		ret = resize_advance(pop, h, rt);
+		epoch_try_advance();
+	}
+
+	pmemobj_mutex_unlock(pop, &h->resize_lock);
+
+	return ret;
+}
+
+/*
+ * bucket_debug -- (internal) prints the entries of the bucket
+ */
+static void
+bucket_debug(PMEMobjpool *pop, struct bucket *b, size_t i, FILE *out)
+{
+	struct entry *e = entry_get(pop, &b->head);
+	if (e == NULL)
+		return;
+
+	int num = 0;
+	fprintf(out, "%zu: ", i);
+	for (; e != NULL; e = entry_get(pop, &e->next)) {
+		fprintf(out, "%" PRIu64 " ", e->key);
+		num++;
+	}
+	fprintf(out, "(%d)\n", num);
+}
+
+/*
+ * hm_mt_debug -- prints complete hashmap state, the buckets of the previous
+ * table which have not been migrated yet are printed with their indexes in
+ * the previous table
+ */
+static void
+hm_mt_debug(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap, FILE *out)
+{
+	struct hashmap_mt *h = D_RW(hashmap);
+	struct buckets *cur;
+	struct buckets *prev;
+
+	if (runtime_get(pop, h) == NULL)
+		return;
+
+	if (pmemobj_mutex_lock(pop, &h->resize_lock))
+		return;
+	epoch_enter();
+
+	tables_get(pop, h, &cur, &prev);
+
+	fprintf(out, "seed: %" PRIu64 " generation: %" PRIu64 "%s\n", h->seed,
+		h->state >> STATE_GEN_SHIFT, prev ? " (resizing)" : "");
+	fprintf(out, "count: %zu, buckets: %zu\n", hm_mt_count(pop, hashmap),
+		cur->nbuckets);
+
+	if (prev == NULL) {
+		for (size_t i = 0; i < cur->nbuckets; ++i)
+			bucket_debug(pop, &cur->bucket[i], i, out);
+	} else {
+		size_t n = prev->nbuckets;
+		for (size_t i = 0; i < n; ++i) {
+			if (prev->bucket[i].migrated != BUCKET_MIGRATED) {
+				bucket_debug(pop, &prev->bucket[i], i, out);
+				continue;
+			}
+			bucket_debug(pop, &cur->bucket[i], i, out);
+			bucket_debug(pop, &cur->bucket[i + n], i + n, out);
+		}
+	}
+
+	epoch_exit();
+	pmemobj_mutex_unlock(pop, &h->resize_lock);
+}
+
+/*
+ * hm_mt_cmd -- execute cmd for hashmap
+ */
+int
+hm_mt_cmd(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+		unsigned cmd, uint64_t arg)
+{
+	switch (cmd) {
+		case HASHMAP_CMD_REBUILD:
+			return hm_mt_rebuild(pop, hashmap);
+		case HASHMAP_CMD_DEBUG:
+			if (!arg)
+				return -EINVAL;
+			hm_mt_debug(pop, hashmap, (FILE *)arg);
+			return 0;
+		default:
+			return -EINVAL;
+	}
+}
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+#ifndef HASHMAP_MT_H
+#define HASHMAP_MT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <hashmap.h>
+#include <libpmemobj.h>
+
+#ifndef HASHMAP_MT_TYPE_OFFSET
+#define HASHMAP_MT_TYPE_OFFSET 1024
+#endif
+
+struct hashmap_mt;
+TOID_DECLARE(struct hashmap_mt, HASHMAP_MT_TYPE_OFFSET + 0);
+
+int hm_mt_check(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap);
+int hm_mt_create(PMEMobjpool *pop, TOID(struct hashmap_mt) *map, void *arg);
+int hm_mt_init(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap);
+int hm_mt_insert(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+		uint64_t key, PMEMoid value);
+PMEMoid hm_mt_remove(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+		uint64_t key);
+PMEMoid hm_mt_get(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+		uint64_t key);
+int hm_mt_lookup(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+		uint64_t key);
+int hm_mt_foreach(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
+size_t hm_mt_count(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap);
+int hm_mt_cmd(PMEMobjpool *pop, TOID(struct hashmap_mt) hashmap,
+		unsigned cmd, uint64_t arg);
+
+#endif /* HASHMAP_MT_H */
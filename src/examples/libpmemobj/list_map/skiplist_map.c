@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * skiplist_map.c -- Skiplist implementation
@@ -274,6 +274,28 @@ skiplist_map_foreach(PMEMobjpool *pop, TOID(struct skiplist_map_node) map,
 	return 0;
 }
 
+/*
+ * skiplist_map_range -- calls function for each node with a key from
+ * the range
+ */
+int
+skiplist_map_range(PMEMobjpool *pop, TOID(struct skiplist_map_node) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	TOID(struct skiplist_map_node) path[SKIPLIST_LEVELS_NUM];
+	skiplist_map_find(start, map, path);
+
+	for (TOID(struct skiplist_map_node) next = D_RO(path[0])->next[0];
+			!TOID_EQUALS(next, NULL_NODE) &&
+			D_RO(next)->entry.key <= end;
+			next = D_RO(next)->next[0]) {
+		if (cb(D_RO(next)->entry.key, D_RO(next)->entry.value, arg))
+			return 1;
+	}
+	return 0;
+}
+
 /*
  * skiplist_map_is_empty -- checks whether the list map is empty
  */
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2016-2020, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * skiplist_map.h -- sorted list collection implementation
@@ -39,6 +39,9 @@ int skiplist_map_lookup(PMEMobjpool *pop, TOID(struct skiplist_map_node) map,
 		uint64_t key);
 int skiplist_map_foreach(PMEMobjpool *pop, TOID(struct skiplist_map_node) map,
 	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
+int skiplist_map_range(PMEMobjpool *pop, TOID(struct skiplist_map_node) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
 int skiplist_map_is_empty(PMEMobjpool *pop, TOID(struct skiplist_map_node) map);
 
 #endif /* SKIPLIST_MAP_H */
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2020, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * data_store.c -- tree_map example usage
@@ -15,10 +15,13 @@
 #include "map.h"
 #include "map_ctree.h"
 #include "map_btree.h"
+#include "map_fptree.h"
+#include "map_art.h"
 #include "map_rbtree.h"
 #include "map_hashmap_atomic.h"
 #include "map_hashmap_tx.h"
 #include "map_hashmap_rp.h"
+#include "map_hashmap_mt.h"
 #include "map_skiplist.h"
 
 POBJ_LAYOUT_BEGIN(data_store);
@@ -153,6 +156,12 @@ parse_map_type(const char *type, insert_rand_fn *insert)
 	} else if (strcmp(type, "btree") == 0) {
 		*insert = insert_rand_items_transact;
 		return MAP_BTREE;
+	} else if (strcmp(type, "fptree") == 0) {
+		*insert = insert_rand_items;
+		return MAP_FPTREE;
+	} else if (strcmp(type, "art") == 0) {
+		*insert = insert_rand_items;
+		return MAP_ART;
 	} else if (strcmp(type, "rbtree") == 0) {
 		*insert = insert_rand_items_transact;
 		return MAP_RBTREE;
@@ -165,6 +174,9 @@ parse_map_type(const char *type, insert_rand_fn *insert)
 	} else if (strcmp(type, "hashmap_rp") == 0) {
 		*insert = insert_rand_items;
 		return MAP_HASHMAP_RP;
+	} else if (strcmp(type, "hashmap_mt") == 0) {
+		*insert = insert_rand_items;
+		return MAP_HASHMAP_MT;
 	} else if (strcmp(type, "skiplist") == 0) {
 		*insert = insert_rand_items_transact;
 		return MAP_SKIPLIST;
@@ -176,8 +188,10 @@ parse_map_type(const char *type, insert_rand_fn *insert)
 int main(int argc, const char *argv[]) {
 	if (argc < 3) {
 		printf("usage: %s "
-			"<ctree|btree|rbtree|hashmap_atomic|hashmap_rp|"
-			"hashmap_tx|skiplist> file-name [nops]\n", argv[0]);
+			"<ctree|btree|fptree|art|rbtree|hashmap_atomic|"
+			"hashmap_rp|hashmap_mt|hashmap_tx|skiplist> "
+			"file-name [nops]\n",
+			argv[0]);
 		return 1;
 	}
 
@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * kv_bench.c -- pipelining benchmark client of the kv_server
+ *
+ * The client inserts, gets and removes the given number of keys, sending
+ * the messages in windows of the given depth and waiting for all their
+ * responses before sending the next window.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "kv_protocol.h"
+
+#define RESP_BUF_LEN 4096
+
+enum phase {
+	PHASE_INSERT,
+	PHASE_GET,
+	PHASE_REMOVE,
+
+	MAX_PHASE
+};
+
+static const char *phase_name[MAX_PHASE] = {
+	[PHASE_INSERT] = "insert",
+	[PHASE_GET] = "get",
+	[PHASE_REMOVE] = "remove"
+};
+
+static char *value;
+
+/*
+ * send_all -- sends the whole buffer
+ */
+static int
+send_all(int fd, const char *buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t ret = send(fd, buf, len, 0);
+		if (ret < 0) {
+			perror("send");
+			return -1;
+		}
+		buf += ret;
+		len -= (size_t)ret;
+	}
+
+	return 0;
+}
+
+/*
+ * resp_failed -- checks if the response is one of the failures
+ */
+static int
+resp_failed(const char *resp, size_t len)
+{
+	for (int i = 0; i < MAX_RESP_MSG; ++i) {
+		if (i == RESP_MSG_SUCCESS)
+			continue;
+		if (strlen(resp_msg[i]) == len &&
+				strncmp(resp_msg[i], resp, len) == 0)
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * recv_responses -- waits for n newline terminated responses, counts
+ * the failed ones
+ */
+static int
+recv_responses(int fd, unsigned n, uint64_t *nfailed)
+{
+	char buf[RESP_BUF_LEN];
+	char line[16]; /* beginning of the current response */
+	size_t len = 0;
+
+	while (n > 0) {
+		ssize_t ret = recv(fd, buf, sizeof(buf), 0);
+		if (ret <= 0) {
+			fprintf(stderr, "server closed the connection\n");
+			return -1;
+		}
+
+		for (ssize_t i = 0; i < ret; ++i) {
+			if (len < sizeof(line))
+				line[len] = buf[i];
+			len++;
+
+			if (buf[i] != '\n')
+				continue;
+
+			if (len <= sizeof(line) && resp_failed(line, len))
+				(*nfailed)++;
+			len = 0;
+			n--;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * msg_append -- appends the message of the phase for the given key
+ */
+static size_t
+msg_append(char *buf, enum phase phase, uint64_t key)
+{
+	switch (phase) {
+		case PHASE_INSERT:
+			return (size_t)sprintf(buf, "%s key%lu %s\n",
+				kv_cmsg_token[CMSG_INSERT],
+				(unsigned long)key, value);
+		case PHASE_GET:
+			return (size_t)sprintf(buf, "%s key%lu\n",
+				kv_cmsg_token[CMSG_GET], (unsigned long)key);
+		case PHASE_REMOVE:
+			return (size_t)sprintf(buf, "%s key%lu\n",
+				kv_cmsg_token[CMSG_REMOVE],
+				(unsigned long)key);
+		default:
+			return 0;
+	}
+}
+
+/*
+ * run_phase -- sends nops messages of the phase, depth of them at a time
+ */
+static int
+run_phase(int fd, enum phase phase, uint64_t nops, unsigned depth,
+	char *buf)
+{
+	struct timespec beg;
+	struct timespec end;
+	uint64_t nfailed = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &beg);
+
+	for (uint64_t i = 0; i < nops; ) {
+		size_t len = 0;
+		unsigned n;
+		for (n = 0; n < depth && i < nops; ++n, ++i) {
+			uint64_t key = phase == PHASE_GET ?
+				(uint64_t)rand() % nops : i;
+			len += msg_append(buf + len, phase, key);
+		}
+
+		if (send_all(fd, buf, len) || recv_responses(fd, n, &nfailed))
+			return -1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	double secs = (double)(end.tv_sec - beg.tv_sec) +
+		(double)(end.tv_nsec - beg.tv_nsec) / 1e9;
+	printf("%s: %lu ops in %.3f s, %.0f ops/s, %lu failed\n",
+		phase_name[phase], (unsigned long)nops, secs,
+		(double)nops / secs, (unsigned long)nfailed);
+
+	return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	if (argc < 4) {
+		printf("usage: %s address port nops [depth] [value-size]\n",
+				argv[0]);
+		return 1;
+	}
+
+	uint64_t nops = strtoull(argv[3], NULL, 10);
+	unsigned depth = argc > 4 ? (unsigned)atoi(argv[4]) : 1;
+	size_t vsize = argc > 5 ? (size_t)atoi(argv[5]) : 16;
+	if (nops == 0 || depth == 0 || vsize == 0) {
+		fprintf(stderr, "invalid arguments\n");
+		return 1;
+	}
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons((uint16_t)atoi(argv[2]));
+	if (inet_pton(AF_INET, argv[1], &addr.sin_addr) != 1) {
+		fprintf(stderr, "invalid address: %s\n", argv[1]);
+		return 1;
+	}
+
+	value = malloc(vsize + 1);
+	/* a message is the token, the key, the value and the separators */
+	char *buf = malloc(depth * (vsize + MAX_KEY_LEN + 16));
+	if (value == NULL || buf == NULL) {
+		perror("malloc");
+		return 1;
+	}
+	memset(value, 'v', vsize);
+	value[vsize] = '\0';
+
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		perror("socket");
+		return 1;
+	}
+
+	int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+		perror("connect");
+		return 1;
+	}
+
+	int ret = 0;
+	for (int p = 0; p < MAX_PHASE && ret == 0; ++p)
+		ret = run_phase(fd, (enum phase)p, nops, depth, buf);
+
+	char bye[16];
+	int len = sprintf(bye, "%s\n", kv_cmsg_token[CMSG_BYE]);
+	send_all(fd, bye, (size_t)len);
+
+	close(fd);
+	free(buf);
+	free(value);
+
+	return ret != 0;
+}
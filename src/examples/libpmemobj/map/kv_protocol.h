@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2015-2020, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * kv_protocol.h -- kv store text protocol
@@ -18,6 +18,10 @@
  *
  * Server responds with newline terminated string literals.
  * If invalid message token is received RESP_MSG_UNKNOWN is sent.
+ *
+ * A client can send more messages without waiting for the responses. They are
+ * processed in order and the responses to all the messages received at once
+ * are sent together.
  */
 
 enum kv_cmsg {
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2018, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * kv_server.c -- persistent tcp key-value store server
@@ -17,11 +17,14 @@
 #include "map.h"
 #include "map_ctree.h"
 #include "map_btree.h"
+#include "map_fptree.h"
+#include "map_art.h"
 #include "map_rtree.h"
 #include "map_rbtree.h"
 #include "map_hashmap_atomic.h"
 #include "map_hashmap_tx.h"
 #include "map_hashmap_rp.h"
+#include "map_hashmap_mt.h"
 #include "map_skiplist.h"
 
 #include "kv_protocol.h"
@@ -53,17 +56,51 @@ static uv_loop_t *loop;
 
 typedef int (*msg_handler)(uv_stream_t *client, const char *msg, size_t len);
 
+/* the maximum number of responses sent in a single write */
+#define MAX_PIPELINE 64
+
+/*
+ * write_req -- responses to the pipelined messages, sent in a single
+ * vectored write
+ */
 struct write_req {
 	uv_write_t req;
-	uv_buf_t buf;
+	unsigned nbufs;
+	uv_buf_t bufs[MAX_PIPELINE];
+
+	/*
+	 * The values are copied, a message processed after a GET can free
+	 * the object before the write completes. The buffers of the copies
+	 * point to NULL and their offsets in data are kept in offs until
+	 * the write is sent.
+	 */
+	size_t offs[MAX_PIPELINE];
+	char *data;
+	size_t data_len;
+	size_t data_size;
+};
+
+/*
+ * write_batch -- consecutive INSERT and REMOVE messages, processed in
+ * a single transaction
+ */
+struct write_batch {
+	int type[MAX_PIPELINE];
+	const char *msg[MAX_PIPELINE];
+	size_t len[MAX_PIPELINE];
+	unsigned n;
 };
 
 struct client_data {
-	char *buf; /* current message, always NULL terminated */
+	char *buf; /* received data, starts with an incomplete message */
 	size_t buf_len; /* sizeof(buf) */
-	size_t len; /* actual length of the message (while parsing) */
+	size_t len; /* actual length of the data (while parsing) */
+	struct write_req *resp; /* responses waiting for the write */
 };
 
+/* the operations of the map can be grouped in a transaction */
+static int batch_writes;
+
 /*
  * djb2_hash -- string hashing function by Dan Bernstein
  */
@@ -86,6 +123,7 @@ static void
 write_done_cb(uv_write_t *req, int status)
 {
 	struct write_req *wr = (struct write_req *)req;
+	free(wr->data);
 	free(wr);
 
 	if (status == -1) {
@@ -100,22 +138,84 @@ static void
 client_close_cb(uv_handle_t *handle)
 {
 	struct client_data *d = handle->data;
+	if (d->resp != NULL)
+		free(d->resp->data);
+	free(d->resp);
 	free(d->buf);
 	free(handle->data);
 	free(handle);
 }
 
 /*
- * response_write -- response writing helper
+ * response_flush -- sends all the pending responses of the client
  */
 static void
-response_write(uv_stream_t *client, char *resp, size_t len)
+response_flush(uv_stream_t *client)
 {
-	struct write_req *wr = malloc(sizeof(struct write_req));
-	assert(wr != NULL);
+	struct client_data *d = client->data;
+	struct write_req *wr = d->resp;
+
+	if (wr == NULL || wr->nbufs == 0)
+		return;
+
+	d->resp = NULL;
+
+	for (unsigned i = 0; i < wr->nbufs; ++i)
+		if (wr->bufs[i].base == NULL)
+			wr->bufs[i].base = wr->data + wr->offs[i];
+
+	if (uv_write(&wr->req, client, wr->bufs, wr->nbufs,
+			write_done_cb) != 0) {
+		printf("response failed");
+		free(wr->data);
+		free(wr);
+	}
+}
+
+/*
+ * response_get -- returns the pending responses of the client with room for
+ * another n of them
+ */
+static struct write_req *
+response_get(uv_stream_t *client, unsigned n)
+{
+	struct client_data *d = client->data;
+
+	if (d->resp != NULL && d->resp->nbufs + n > MAX_PIPELINE)
+		response_flush(client);
+
+	if (d->resp == NULL) {
+		d->resp = calloc(1, sizeof(struct write_req));
+		assert(d->resp != NULL);
+	}
+
+	return d->resp;
+}
+
+/*
+ * response_write -- response writing helper, the data is copied
+ */
+static void
+response_write(uv_stream_t *client, const char *resp, size_t len)
+{
+	struct write_req *wr = response_get(client, 1);
+
+	if (wr->data_len + len > wr->data_size) {
+		size_t size = 2 * wr->data_size;
+		if (size < wr->data_len + len)
+			size = wr->data_len + len;
+
+		char *data = realloc(wr->data, size);
+		assert(data != NULL);
+
+		wr->data = data;
+		wr->data_size = size;
+	}
 
-	wr->buf = uv_buf_init(resp, len);
-	uv_write(&wr->req, client, &wr->buf, 1, write_done_cb);
+	memcpy(wr->data + wr->data_len, resp, len);
+	wr->offs[wr->nbufs] = wr->data_len;
+	wr->bufs[wr->nbufs++] = uv_buf_init(NULL, len);
+	wr->data_len += len;
 }
 
 /*
@@ -124,7 +224,10 @@ response_write(uv_stream_t *client, char *resp, size_t len)
 static void
 response_msg(uv_stream_t *client, enum resp_messages msg)
 {
-	response_write(client, (char *)resp_msg[msg], strlen(resp_msg[msg]));
+	struct write_req *wr = response_get(client, 1);
+
+	wr->bufs[wr->nbufs++] = uv_buf_init((char *)resp_msg[msg],
+			strlen(resp_msg[msg]));
 }
 
 /*
@@ -146,10 +249,9 @@ cmsg_insert_handler(uv_stream_t *client, const char *msg, size_t len)
 		int ret = sscanf(msg, "INSERT %254s %s\n", key, D_RW(val)->buf);
 		assert(ret == 2);
 
-		D_RW(val)->len = len;
-
 		/* properly terminate the value */
-		D_RW(val)->buf[strlen(D_RO(val)->buf)] = '\n';
+		D_RW(val)->len = strlen(D_RO(val)->buf) + 1;
+		D_RW(val)->buf[D_RO(val)->len - 1] = '\n';
 
 		map_insert(mapc, map, djb2_hash(key), val.oid);
 	} TX_ONABORT {
@@ -200,7 +302,7 @@ cmsg_get_handler(uv_stream_t *client, const char *msg, size_t len)
 	if (TOID_IS_NULL(value)) {
 		response_msg(client, RESP_MSG_NULL);
 	} else {
-		response_write(client, D_RW(value)->buf, D_RO(value)->len);
+		response_write(client, D_RO(value)->buf, D_RO(value)->len);
 	}
 
 	return 0;
@@ -212,17 +314,19 @@ cmsg_get_handler(uv_stream_t *client, const char *msg, size_t len)
 static int
 cmsg_bye_handler(uv_stream_t *client, const char *msg, size_t len)
 {
+	response_flush(client);
 	uv_close((uv_handle_t *)client, client_close_cb);
 
 	return 0;
 }
 
 /*
- * cmsg_bye_handler -- handler of KILL client message
+ * cmsg_kill_handler -- handler of KILL client message
  */
 static int
 cmsg_kill_handler(uv_stream_t *client, const char *msg, size_t len)
 {
+	response_flush(client);
 	uv_close((uv_handle_t *)client, client_close_cb);
 	uv_close((uv_handle_t *)&server, NULL);
 
@@ -239,26 +343,85 @@ static msg_handler protocol_impl[MAX_CMSG] = {
 };
 
 /*
- * cmsg_handle -- handles current client message
+ * cmsg_write_batch -- processes the batched messages in a single transaction
+ */
+static int
+cmsg_write_batch(uv_stream_t *client, struct write_batch *batch)
+{
+	if (batch->n == 0)
+		return 0;
+
+	/* the responses of the whole batch must be discarded on abort */
+	struct write_req *wr = response_get(client, batch->n);
+	unsigned nbufs = wr->nbufs;
+	size_t data_len = wr->data_len;
+	int ret = 0;
+	int aborted = 0;
+
+	TX_BEGIN(pop) {
+		for (unsigned i = 0; i < batch->n && ret == 0; ++i)
+			ret = protocol_impl[batch->type[i]](client,
+					batch->msg[i], batch->len[i]);
+	} TX_ONABORT {
+		aborted = 1;
+	} TX_END
+
+	if (aborted) {
+		/*
+		 * One of the messages failed and took the whole transaction
+		 * down, so redo them one by one to find out which one it was.
+		 */
+		wr->nbufs = nbufs;
+		wr->data_len = data_len;
+		ret = 0;
+		for (unsigned i = 0; i < batch->n && ret == 0; ++i)
+			ret = protocol_impl[batch->type[i]](client,
+					batch->msg[i], batch->len[i]);
+	}
+
+	batch->n = 0;
+
+	return ret;
+}
+
+/*
+ * cmsg_handle -- handles a single client message, INSERT and REMOVE messages
+ * are only added to the batch
  */
 static int
-cmsg_handle(uv_stream_t *client, struct client_data *data)
+cmsg_handle(uv_stream_t *client, struct write_batch *batch,
+	const char *msg, size_t len)
 {
 	int ret = 0;
 	int i;
 	for (i = 0; i < MAX_CMSG; ++i)
-		if (strncmp(kv_cmsg_token[i], data->buf,
+		if (strncmp(kv_cmsg_token[i], msg,
 			strlen(kv_cmsg_token[i])) == 0)
 			break;
 
+	if (batch_writes && (i == CMSG_INSERT || i == CMSG_REMOVE)) {
+		if (batch->n == MAX_PIPELINE &&
+				(ret = cmsg_write_batch(client, batch)) != 0)
+			return ret;
+
+		batch->type[batch->n] = i;
+		batch->msg[batch->n] = msg;
+		batch->len[batch->n] = len;
+		batch->n++;
+
+		return 0;
+	}
+
+	/* keep the order of the messages */
+	if ((ret = cmsg_write_batch(client, batch)) != 0)
+		return ret;
+
 	if (i == MAX_CMSG) {
 		response_msg(client, RESP_MSG_UNKNOWN);
 	} else {
-		ret = protocol_impl[i](client, data->buf, data->len);
+		ret = protocol_impl[i](client, msg, len);
 	}
 
-	data->len = 0; /* reset the message length */
-
 	return ret;
 }
 
@@ -269,32 +432,47 @@ static int
 cmsg_handle_stream(uv_stream_t *client, struct client_data *data,
 	const char *buf, ssize_t nread)
 {
+	struct write_batch batch;
+	char *msg;
 	char *last;
-	int ret;
+	size_t left;
 	size_t len;
+	int ret = 0;
+
+	assert(data->len + nread <= data->buf_len);
+	memcpy(data->buf + data->len, buf, nread);
+	data->len += nread;
 
 	/*
 	 * A single read operation can contain zero or more operations, so this
 	 * has to be handled appropriately. Client messages are terminated by
-	 * newline character.
+	 * newline character. All the complete messages are processed before
+	 * any response is sent, so a client which pipelines its requests gets
+	 * the responses in a single write.
 	 */
-	while ((last = memchr(buf, '\n', nread)) != NULL) {
-		len = last - buf + 1;
-		nread -= len;
-		assert(data->len + len <= data->buf_len);
-		memcpy(data->buf + data->len, buf, len);
-		data->len += len;
-
-		if ((ret = cmsg_handle(client, data)) != 0)
+	batch.n = 0;
+	msg = data->buf;
+	left = data->len;
+	while (!uv_is_closing((uv_handle_t *)client) &&
+			(last = memchr(msg, '\n', left)) != NULL) {
+		len = last - msg + 1;
+
+		if ((ret = cmsg_handle(client, &batch, msg, len)) != 0)
 			return ret;
 
-		buf = last + 1;
+		msg = last + 1;
+		left -= len;
 	}
 
-	if (nread != 0) {
-		memcpy(data->buf + data->len, buf, nread);
-		data->len += nread;
-	}
+	if ((ret = cmsg_write_batch(client, &batch)) != 0)
+		return ret;
+
+	if (!uv_is_closing((uv_handle_t *)client))
+		response_flush(client);
+
+	/* keep the incomplete message for the next read */
+	memmove(data->buf, msg, left);
+	data->len = left;
 
 	return 0;
 }
@@ -317,7 +495,11 @@ get_read_buf_cb(uv_handle_t *handle, size_t size, uv_buf_t *buf)
 static void
 read_cb(uv_stream_t *client, ssize_t nread, const uv_buf_t *buf)
 {
-	if (nread <= 0) {
+	/* nothing was read, the buffer is just returned */
+	if (nread == 0)
+		return;
+
+	if (nread < 0) {
 		printf("client connection closed\n");
 		uv_close((uv_handle_t *)client, client_close_cb);
 
@@ -369,18 +551,26 @@ connection_cb(uv_stream_t *_server, int status)
 	}
 }
 
+/*
+ * The maps using the atomic or the action API cannot be modified in
+ * a transaction which may be aborted, so their writes are not batched.
+ */
 static const struct {
 	struct map_ops *ops;
 	const char *name;
+	int tx;
 } maps[] = {
-	{MAP_HASHMAP_TX, "hashmap_tx"},
-	{MAP_HASHMAP_ATOMIC, "hashmap_atomic"},
-	{MAP_HASHMAP_RP, "hashmap_rp"},
-	{MAP_CTREE, "ctree"},
-	{MAP_BTREE, "btree"},
-	{MAP_RTREE, "rtree"},
-	{MAP_RBTREE, "rbtree"},
-	{MAP_SKIPLIST, "skiplist"}
+	{MAP_HASHMAP_TX, "hashmap_tx", 1},
+	{MAP_HASHMAP_ATOMIC, "hashmap_atomic", 0},
+	{MAP_HASHMAP_RP, "hashmap_rp", 0},
+	{MAP_HASHMAP_MT, "hashmap_mt", 0},
+	{MAP_CTREE, "ctree", 1},
+	{MAP_BTREE, "btree", 1},
+	{MAP_FPTREE, "fptree", 1},
+	{MAP_ART, "art", 0},
+	{MAP_RTREE, "rtree", 1},
+	{MAP_RBTREE, "rbtree", 1},
+	{MAP_SKIPLIST, "skiplist", 1}
 };
 
 /*
@@ -390,8 +580,10 @@ static const struct map_ops *
 get_map_ops_by_string(const char *type)
 {
 	for (int i = 0; i < COUNT_OF(maps); ++i)
-		if (strcmp(maps[i].name, type) == 0)
+		if (strcmp(maps[i].name, type) == 0) {
+			batch_writes = maps[i].tx;
 			return maps[i].ops;
+		}
 
 	return NULL;
 }
@@ -405,7 +597,9 @@ main(int argc, char *argv[])
 {
 	if (argc < 4) {
 		printf("usage: %s hashmap_tx|hashmap_atomic|hashmap_rp|"
-				"ctree|btree|rtree|rbtree|skiplist file-name port\n",
+				"hashmap_mt|ctree|btree|fptree|art|rtree|"
+				"rbtree|skiplist "
+				"file-name port\n",
 				argv[0]);
 		return 1;
 	}
@@ -1,6 +1,6 @@
 #!/usr/bin/env bash
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2015-2016, Intel Corporation
+# Copyright 2015-2026, Intel Corporation
 
 set -euo pipefail
 
@@ -18,6 +18,17 @@ sleep 1
 RESP=`echo -e "INSERT foo bar\nGET foo\nBYE" | nc 127.0.0.1 $PORT`
 echo $RESP
 
+# send all of the messages at once, the value which does not fit in the pool
+# fails alone, the other messages of its batch succeed
+RESP=`{ printf "INSERT a 1\nINSERT b 2\nINSERT big "; \
+	head -c 16M /dev/zero | tr '\0' x; \
+	printf "\nINSERT c 3\nREMOVE a\nGET a\nGET b\nGET big\nGET c\nBYE\n"; } | \
+	nc 127.0.0.1 $PORT`
+echo $RESP
+
+# pipeline 16 messages at a time
+./kv_bench 127.0.0.1 $PORT 1000 16
+
 # remove previously inserted key value pair and shutdown the server
 RESP=`echo -e "GET foo\nREMOVE foo\nGET foo\nKILL" | nc 127.0.0.1 $PORT`
 echo $RESP
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2017, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * map.c -- common interface for maps
@@ -201,3 +201,72 @@ map_cmd(struct map_ctx *mapc, TOID(struct map) map, unsigned cmd, uint64_t arg)
 	ABORT_NOT_IMPLEMENTED(mapc, cmd);
 	return mapc->ops->cmd(mapc->pop, map, cmd, arg);
 }
+
+/*
+ * map_range -- iterate through the key value pairs with keys from start to
+ * end, in the order of the keys
+ */
+int
+map_range(struct map_ctx *mapc, TOID(struct map) map,
+		uint64_t start, uint64_t end,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	ABORT_NOT_IMPLEMENTED(mapc, range);
+	return mapc->ops->range(mapc->pop, map, start, end, cb, arg);
+}
+
+/*
+ * map_cursor_init -- set up a range scan of the keys from start to end
+ */
+void
+map_cursor_init(struct map_cursor *cur, uint64_t start, uint64_t end)
+{
+	cur->next = start;
+	cur->end = end;
+	cur->done = start > end;
+}
+
+struct map_batch {
+	struct map_entry *entries;
+	size_t n;
+	size_t count;
+};
+
+/*
+ * map_batch_add -- (internal) appends the pair to the batch, stops
+ * the traversal when it's full
+ */
+static int
+map_batch_add(uint64_t key, PMEMoid value, void *arg)
+{
+	struct map_batch *batch = arg;
+
+	batch->entries[batch->count].key = key;
+	batch->entries[batch->count].value = value;
+
+	return ++batch->count == batch->n;
+}
+
+/*
+ * map_cursor_next -- fill up to n next entries of the range scan, returns
+ * the number of them, 0 when the scan is done
+ */
+size_t
+map_cursor_next(struct map_ctx *mapc, TOID(struct map) map,
+	struct map_cursor *cur, struct map_entry *entries, size_t n)
+{
+	if (cur->done || n == 0)
+		return 0;
+
+	struct map_batch batch = {entries, n, 0};
+	map_range(mapc, map, cur->next, cur->end, map_batch_add, &batch);
+
+	/* the range is exhausted unless the batch was filled up */
+	if (batch.count < n || entries[n - 1].key >= cur->end)
+		cur->done = 1;
+	else
+		cur->next = entries[n - 1].key + 1;
+
+	return batch.count;
+}
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2015-2020, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * map.h -- common interface for maps
@@ -51,6 +51,10 @@ struct map_ops {
 	size_t(*count)(PMEMobjpool *pop, TOID(struct map) map);
 	int(*cmd)(PMEMobjpool *pop, TOID(struct map) map,
 		unsigned cmd, uint64_t arg);
+	int(*range)(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t start, uint64_t end,
+		int(*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg);
 };
 
 struct map_ctx {
@@ -58,6 +62,20 @@ struct map_ctx {
 	const struct map_ops *ops;
 };
 
+struct map_entry {
+	uint64_t key;
+	PMEMoid value;
+};
+
+/*
+ * map_cursor -- position of a range scan returning the entries in batches
+ */
+struct map_cursor {
+	uint64_t next; /* the lowest key of the next batch */
+	uint64_t end; /* the highest key of the range */
+	int done;
+};
+
 struct map_ctx *map_ctx_init(const struct map_ops *ops, PMEMobjpool *pop);
 void map_ctx_free(struct map_ctx *mapc);
 int map_check(struct map_ctx *mapc, TOID(struct map) map);
@@ -83,6 +101,13 @@ int map_is_empty(struct map_ctx *mapc, TOID(struct map) map);
 size_t map_count(struct map_ctx *mapc, TOID(struct map) map);
 int map_cmd(struct map_ctx *mapc, TOID(struct map) map,
 	unsigned cmd, uint64_t arg);
+int map_range(struct map_ctx *mapc, TOID(struct map) map,
+	uint64_t start, uint64_t end,
+	int(*cb)(uint64_t key, PMEMoid value, void *arg),
+	void *arg);
+void map_cursor_init(struct map_cursor *cur, uint64_t start, uint64_t end);
+size_t map_cursor_next(struct map_ctx *mapc, TOID(struct map) map,
+	struct map_cursor *cur, struct map_entry *entries, size_t n);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * map_art.c -- common interface for maps
+ */
+
+#include <map.h>
+#include <art_map.h>
+
+#include "map_art.h"
+
+/*
+ * map_art_check -- wrapper for art_map_check
+ */
+static int
+map_art_check(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_check(pop, art_map);
+}
+
+/*
+ * map_art_create -- wrapper for art_map_create
+ */
+static int
+map_art_create(PMEMobjpool *pop, TOID(struct map) *map, void *arg)
+{
+	TOID(struct art_map) *art_map = (TOID(struct art_map) *)map;
+
+	return art_map_create(pop, art_map, arg);
+}
+
+/*
+ * map_art_destroy -- wrapper for art_map_destroy
+ */
+static int
+map_art_destroy(PMEMobjpool *pop, TOID(struct map) *map)
+{
+	TOID(struct art_map) *art_map = (TOID(struct art_map) *)map;
+
+	return art_map_destroy(pop, art_map);
+}
+
+/*
+ * map_art_insert -- wrapper for art_map_insert
+ */
+static int
+map_art_insert(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t key, PMEMoid value)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_insert(pop, art_map, key, value);
+}
+
+/*
+ * map_art_insert_new -- wrapper for art_map_insert_new
+ */
+static int
+map_art_insert_new(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t key, size_t size,
+		unsigned type_num,
+		void (*constructor)(PMEMobjpool *pop, void *ptr, void *arg),
+		void *arg)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_insert_new(pop, art_map, key, size,
+			type_num, constructor, arg);
+}
+
+/*
+ * map_art_remove -- wrapper for art_map_remove
+ */
+static PMEMoid
+map_art_remove(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_remove(pop, art_map, key);
+}
+
+/*
+ * map_art_remove_free -- wrapper for art_map_remove_free
+ */
+static int
+map_art_remove_free(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_remove_free(pop, art_map, key);
+}
+
+/*
+ * map_art_clear -- wrapper for art_map_clear
+ */
+static int
+map_art_clear(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_clear(pop, art_map);
+}
+
+/*
+ * map_art_get -- wrapper for art_map_get
+ */
+static PMEMoid
+map_art_get(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_get(pop, art_map, key);
+}
+
+/*
+ * map_art_lookup -- wrapper for art_map_lookup
+ */
+static int
+map_art_lookup(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_lookup(pop, art_map, key);
+}
+
+/*
+ * map_art_foreach -- wrapper for art_map_foreach
+ */
+static int
+map_art_foreach(PMEMobjpool *pop, TOID(struct map) map,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_foreach(pop, art_map, cb, arg);
+}
+
+/*
+ * map_art_range -- wrapper for art_map_range
+ */
+static int
+map_art_range(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t start, uint64_t end,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_range(pop, art_map, start, end, cb, arg);
+}
+
+/*
+ * map_art_is_empty -- wrapper for art_map_is_empty
+ */
+static int
+map_art_is_empty(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_is_empty(pop, art_map);
+}
+
+/*
+ * map_art_init -- wrapper for art_map_init
+ */
+static int
+map_art_init(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_init(pop, art_map);
+}
+
+/*
+ * map_art_count -- wrapper for art_map_count
+ */
+static size_t
+map_art_count(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct art_map) art_map;
+	TOID_ASSIGN(art_map, map.oid);
+
+	return art_map_count(pop, art_map);
+}
+
+struct map_ops art_map_ops = {
+	/* .check	= */ map_art_check,
+	/* .create	= */ map_art_create,
+	/* .destroy	= */ map_art_destroy,
+	/* .init	= */ map_art_init,
+	/* .insert	= */ map_art_insert,
+	/* .insert_new	= */ map_art_insert_new,
+	/* .remove	= */ map_art_remove,
+	/* .remove_free	= */ map_art_remove_free,
+	/* .clear	= */ map_art_clear,
+	/* .get		= */ map_art_get,
+	/* .lookup	= */ map_art_lookup,
+	/* .foreach	= */ map_art_foreach,
+	/* .is_empty	= */ map_art_is_empty,
+	/* .count	= */ map_art_count,
+	/* .cmd		= */ NULL,
+	/* .range	= */ map_art_range,
+};
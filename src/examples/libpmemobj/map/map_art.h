@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * map_art.h -- common interface for maps
+ */
+
+#ifndef MAP_ART_H
+#define MAP_ART_H
+
+#include "map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct map_ops art_map_ops;
+
+#define MAP_ART (&art_map_ops)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAP_ART_H */
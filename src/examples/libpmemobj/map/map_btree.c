@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2021, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * map_btree.c -- common interface for maps
@@ -150,6 +150,21 @@ map_btree_foreach(PMEMobjpool *pop, TOID(struct map) map,
 	return btree_map_foreach(pop, btree_map, cb, arg);
 }
 
+/*
+ * map_btree_range -- wrapper for btree_map_range
+ */
+static int
+map_btree_range(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t start, uint64_t end,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct btree_map) btree_map;
+	TOID_ASSIGN(btree_map, map.oid);
+
+	return btree_map_range(pop, btree_map, start, end, cb, arg);
+}
+
 /*
  * map_btree_is_empty -- wrapper for btree_map_is_empty
  */
@@ -188,4 +203,5 @@ struct map_ops btree_map_ops = {
 	/* .is_empty	= */ map_btree_is_empty,
 	/* .count	= */ NULL,
 	/* .cmd		= */ NULL,
+	/* .range	= */ map_btree_range,
 };
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2021, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * map_ctree.c -- common interface for maps
@@ -150,6 +150,21 @@ map_ctree_foreach(PMEMobjpool *pop, TOID(struct map) map,
 	return ctree_map_foreach(pop, ctree_map, cb, arg);
 }
 
+/*
+ * map_ctree_range -- wrapper for ctree_map_range
+ */
+static int
+map_ctree_range(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t start, uint64_t end,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct ctree_map) ctree_map;
+	TOID_ASSIGN(ctree_map, map.oid);
+
+	return ctree_map_range(pop, ctree_map, start, end, cb, arg);
+}
+
 /*
  * map_ctree_is_empty -- wrapper for ctree_map_is_empty
  */
@@ -188,4 +203,5 @@ struct map_ops ctree_map_ops = {
 	/* .is_empty	= */ map_ctree_is_empty,
 	/* .count	= */ NULL,
 	/* .cmd		= */ NULL,
+	/* .range	= */ map_ctree_range,
 };
@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * map_fptree.c -- common interface for maps
+ */
+
+#include <map.h>
+#include <fptree_map.h>
+
+#include "map_fptree.h"
+
+/*
+ * map_fptree_check -- wrapper for fptree_map_check
+ */
+static int
+map_fptree_check(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_check(pop, fptree_map);
+}
+
+/*
+ * map_fptree_create -- wrapper for fptree_map_create
+ */
+static int
+map_fptree_create(PMEMobjpool *pop, TOID(struct map) *map, void *arg)
+{
+	TOID(struct fptree_map) *fptree_map =
+		(TOID(struct fptree_map) *)map;
+
+	return fptree_map_create(pop, fptree_map, arg);
+}
+
+/*
+ * map_fptree_destroy -- wrapper for fptree_map_destroy
+ */
+static int
+map_fptree_destroy(PMEMobjpool *pop, TOID(struct map) *map)
+{
+	TOID(struct fptree_map) *fptree_map =
+		(TOID(struct fptree_map) *)map;
+
+	return fptree_map_destroy(pop, fptree_map);
+}
+
+/*
+ * map_fptree_insert -- wrapper for fptree_map_insert
+ */
+static int
+map_fptree_insert(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t key, PMEMoid value)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_insert(pop, fptree_map, key, value);
+}
+
+/*
+ * map_fptree_insert_new -- wrapper for fptree_map_insert_new
+ */
+static int
+map_fptree_insert_new(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t key, size_t size,
+		unsigned type_num,
+		void (*constructor)(PMEMobjpool *pop, void *ptr, void *arg),
+		void *arg)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_insert_new(pop, fptree_map, key, size,
+			type_num, constructor, arg);
+}
+
+/*
+ * map_fptree_remove -- wrapper for fptree_map_remove
+ */
+static PMEMoid
+map_fptree_remove(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_remove(pop, fptree_map, key);
+}
+
+/*
+ * map_fptree_remove_free -- wrapper for fptree_map_remove_free
+ */
+static int
+map_fptree_remove_free(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_remove_free(pop, fptree_map, key);
+}
+
+/*
+ * map_fptree_clear -- wrapper for fptree_map_clear
+ */
+static int
+map_fptree_clear(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_clear(pop, fptree_map);
+}
+
+/*
+ * map_fptree_get -- wrapper for fptree_map_get
+ */
+static PMEMoid
+map_fptree_get(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_get(pop, fptree_map, key);
+}
+
+/*
+ * map_fptree_lookup -- wrapper for fptree_map_lookup
+ */
+static int
+map_fptree_lookup(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_lookup(pop, fptree_map, key);
+}
+
+/*
+ * map_fptree_foreach -- wrapper for fptree_map_foreach
+ */
+static int
+map_fptree_foreach(PMEMobjpool *pop, TOID(struct map) map,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_foreach(pop, fptree_map, cb, arg);
+}
+
+/*
+ * map_fptree_range -- wrapper for fptree_map_range
+ */
+static int
+map_fptree_range(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t start, uint64_t end,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_range(pop, fptree_map, start, end, cb, arg);
+}
+
+/*
+ * map_fptree_is_empty -- wrapper for fptree_map_is_empty
+ */
+static int
+map_fptree_is_empty(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_is_empty(pop, fptree_map);
+}
+
+/*
+ * map_fptree_init -- wrapper for fptree_map_init
+ */
+static int
+map_fptree_init(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_init(pop, fptree_map);
+}
+
+/*
+ * map_fptree_count -- wrapper for fptree_map_count
+ */
+static size_t
+map_fptree_count(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct fptree_map) fptree_map;
+	TOID_ASSIGN(fptree_map, map.oid);
+
+	return fptree_map_count(pop, fptree_map);
+}
+
+struct map_ops fptree_map_ops = {
+	/* .check	= */ map_fptree_check,
+	/* .create	= */ map_fptree_create,
+	/* .destroy	= */ map_fptree_destroy,
+	/* .init	= */ map_fptree_init,
+	/* .insert	= */ map_fptree_insert,
+	/* .insert_new	= */ map_fptree_insert_new,
+	/* .remove	= */ map_fptree_remove,
+	/* .remove_free	= */ map_fptree_remove_free,
+	/* .clear	= */ map_fptree_clear,
+	/* .get		= */ map_fptree_get,
+	/* .lookup	= */ map_fptree_lookup,
+	/* .foreach	= */ map_fptree_foreach,
+	/* .is_empty	= */ map_fptree_is_empty,
+	/* .count	= */ map_fptree_count,
+	/* .cmd		= */ NULL,
+	/* .range	= */ map_fptree_range,
+};
@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * map_fptree.h -- common interface for maps
+ */
+
+#ifndef MAP_FPTREE_H
+#define MAP_FPTREE_H
+
+#include "map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct map_ops fptree_map_ops;
+
+#define MAP_FPTREE (&fptree_map_ops)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAP_FPTREE_H */
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2017, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * map_hashmap_atomic.c -- common interface for maps
@@ -150,4 +150,5 @@ struct map_ops hashmap_atomic_ops = {
 	/* .is_empty	= */ NULL,
 	/* .count	= */ map_hm_atomic_count,
 	/* .cmd		= */ map_hm_atomic_cmd,
+	/* .range	= */ NULL,
 };
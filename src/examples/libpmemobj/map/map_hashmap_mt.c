@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * map_hashmap_mt.c -- common interface for maps
+ */
+
+#include <map.h>
+#include <hashmap_mt.h>
+
+#include "map_hashmap_mt.h"
+
+/*
+ * map_hm_mt_check -- wrapper for hm_mt_check
+ */
+static int
+map_hm_mt_check(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_check(pop, hashmap_mt);
+}
+
+/*
+ * map_hm_mt_count -- wrapper for hm_mt_count
+ */
+static size_t
+map_hm_mt_count(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_count(pop, hashmap_mt);
+}
+
+/*
+ * map_hm_mt_init -- wrapper for hm_mt_init
+ */
+static int
+map_hm_mt_init(PMEMobjpool *pop, TOID(struct map) map)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_init(pop, hashmap_mt);
+}
+
+/*
+ * map_hm_mt_create -- wrapper for hm_mt_create
+ */
+static int
+map_hm_mt_create(PMEMobjpool *pop, TOID(struct map) *map, void *arg)
+{
+	TOID(struct hashmap_mt) *hashmap_mt =
+		(TOID(struct hashmap_mt) *)map;
+
+	return hm_mt_create(pop, hashmap_mt, arg);
+}
+
+/*
+ * map_hm_mt_insert -- wrapper for hm_mt_insert
+ */
+static int
+map_hm_mt_insert(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t key, PMEMoid value)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_insert(pop, hashmap_mt, key, value);
+}
+
+/*
+ * map_hm_mt_remove -- wrapper for hm_mt_remove
+ */
+static PMEMoid
+map_hm_mt_remove(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_remove(pop, hashmap_mt, key);
+}
+
+/*
+ * map_hm_mt_get -- wrapper for hm_mt_get
+ */
+static PMEMoid
+map_hm_mt_get(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_get(pop, hashmap_mt, key);
+}
+
+/*
+ * map_hm_mt_lookup -- wrapper for hm_mt_lookup
+ */
+static int
+map_hm_mt_lookup(PMEMobjpool *pop, TOID(struct map) map, uint64_t key)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_lookup(pop, hashmap_mt, key);
+}
+
+/*
+ * map_hm_mt_foreach -- wrapper for hm_mt_foreach
+ */
+static int
+map_hm_mt_foreach(PMEMobjpool *pop, TOID(struct map) map,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_foreach(pop, hashmap_mt, cb, arg);
+}
+
+/*
+ * map_hm_mt_cmd -- wrapper for hm_mt_cmd
+ */
+static int
+map_hm_mt_cmd(PMEMobjpool *pop, TOID(struct map) map,
+		unsigned cmd, uint64_t arg)
+{
+	TOID(struct hashmap_mt) hashmap_mt;
+	TOID_ASSIGN(hashmap_mt, map.oid);
+
+	return hm_mt_cmd(pop, hashmap_mt, cmd, arg);
+}
+
+struct map_ops hashmap_mt_ops = {
+	/* .check	= */ map_hm_mt_check,
+	/* .create	= */ map_hm_mt_create,
+	/* .destroy	= */ NULL,
+	/* .init	= */ map_hm_mt_init,
+	/* .insert	= */ map_hm_mt_insert,
+	/* .insert_new	= */ NULL,
+	/* .remove	= */ map_hm_mt_remove,
+	/* .remove_free	= */ NULL,
+	/* .clear	= */ NULL,
+	/* .get		= */ map_hm_mt_get,
+	/* .lookup	= */ map_hm_mt_lookup,
+	/* .foreach	= */ map_hm_mt_foreach,
+	/* .is_empty	= */ NULL,
+	/* .count	= */ map_hm_mt_count,
+	/* .cmd		= */ map_hm_mt_cmd,
+	/* .range	= */ NULL,
+};
@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * map_hashmap_mt.h -- common interface for maps
+ */
+
+#ifndef MAP_HASHMAP_MT_H
+#define MAP_HASHMAP_MT_H
+
+#include "map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct map_ops hashmap_mt_ops;
+
+#define MAP_HASHMAP_MT (&hashmap_mt_ops)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAP_HASHMAP_MT_H */
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2018, Intel Corporation */
+/* Copyright 2018-2026, Intel Corporation */
 
 /*
  * map_hashmap_rp.c -- common interface for maps
@@ -150,4 +150,5 @@ struct map_ops hashmap_rp_ops = {
 	/* .is_empty	= */ NULL,
 	/* .count	= */ map_hm_rp_count,
 	/* .cmd		= */ map_hm_rp_cmd,
+	/* .range	= */ NULL,
 };
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2021, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * map_rbtree.c -- common interface for maps
@@ -150,6 +150,21 @@ map_rbtree_foreach(PMEMobjpool *pop, TOID(struct map) map,
 	return rbtree_map_foreach(pop, rbtree_map, cb, arg);
 }
 
+/*
+ * map_rbtree_range -- wrapper for rbtree_map_range
+ */
+static int
+map_rbtree_range(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t start, uint64_t end,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct rbtree_map) rbtree_map;
+	TOID_ASSIGN(rbtree_map, map.oid);
+
+	return rbtree_map_range(pop, rbtree_map, start, end, cb, arg);
+}
+
 /*
  * map_rbtree_is_empty -- wrapper for rbtree_map_is_empty
  */
@@ -188,4 +203,5 @@ struct map_ops rbtree_map_ops = {
 	/* .is_empty	= */ map_rbtree_is_empty,
 	/* .count	= */ NULL,
 	/* .cmd		= */ NULL,
+	/* .range	= */ map_rbtree_range,
 };
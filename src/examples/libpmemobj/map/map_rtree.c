@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2021, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * map_rtree.c -- common interface for maps
@@ -213,4 +213,5 @@ struct map_ops rtree_map_ops = {
 /*	.is_empty	= */map_rtree_is_empty,
 /*	.count		= */NULL,
 /*	.cmd		= */NULL,
+/*	.range		= */NULL,
 };
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2021, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * map_skiplist.c -- common interface for maps
@@ -150,6 +150,21 @@ map_skiplist_foreach(PMEMobjpool *pop, TOID(struct map) map,
 	return skiplist_map_foreach(pop, skiplist_map, cb, arg);
 }
 
+/*
+ * map_skiplist_range -- wrapper for skiplist_map_range
+ */
+static int
+map_skiplist_range(PMEMobjpool *pop, TOID(struct map) map,
+		uint64_t start, uint64_t end,
+		int (*cb)(uint64_t key, PMEMoid value, void *arg),
+		void *arg)
+{
+	TOID(struct skiplist_map_node) skiplist_map;
+	TOID_ASSIGN(skiplist_map, map.oid);
+
+	return skiplist_map_range(pop, skiplist_map, start, end, cb, arg);
+}
+
 /*
  * map_skiplist_is_empty -- wrapper for skiplist_map_is_empty
  */
@@ -188,4 +203,5 @@ struct map_ops skiplist_map_ops = {
 	/* .is_empty	= */ map_skiplist_is_empty,
 	/* .count	= */ NULL,
 	/* .cmd		= */ NULL,
+	/* .range	= */ map_skiplist_range,
 };
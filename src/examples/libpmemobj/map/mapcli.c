@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2021, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 #include <ex_common.h>
 #include <fcntl.h>
@@ -14,16 +14,22 @@
 #include "map.h"
 #include "map_ctree.h"
 #include "map_btree.h"
+#include "map_fptree.h"
+#include "map_art.h"
 #include "map_rtree.h"
 #include "map_rbtree.h"
 #include "map_hashmap_atomic.h"
 #include "map_hashmap_tx.h"
 #include "map_hashmap_rp.h"
+#include "map_hashmap_mt.h"
 #include "map_skiplist.h"
 #include "hashmap/hashmap.h"
 
 #define PM_HASHSET_POOL_SIZE	(160 * 1024 * 1024)
 
+/* number of values fetched at once by a scan */
+#define SCAN_BATCH 8
+
 POBJ_LAYOUT_BEGIN(map);
 POBJ_LAYOUT_ROOT(map, struct root);
 POBJ_LAYOUT_END(map);
@@ -82,6 +88,37 @@ str_check(const char *str)
 	}
 }
 
+/*
+ * str_scan -- map_cursor_next wrapper which prints the values from the range
+ */
+static void
+str_scan(const char *str)
+{
+	uint64_t start;
+	uint64_t end;
+	if (sscanf(str, "%" PRIu64 " %" PRIu64, &start, &end) != 2) {
+		fprintf(stderr, "scan: invalid syntax\n");
+		return;
+	}
+
+	if (mapc->ops->range == NULL) {
+		fprintf(stderr, "scan: not supported by the map\n");
+		return;
+	}
+
+	struct map_cursor cur;
+	struct map_entry entries[SCAN_BATCH];
+	size_t n;
+
+	map_cursor_init(&cur, start, end);
+	do {
+		n = map_cursor_next(mapc, map, &cur, entries, SCAN_BATCH);
+		for (size_t i = 0; i < n; ++i)
+			printf("%" PRIu64 " ", entries[i].key);
+	} while (n > 0);
+	printf("\n");
+}
+
 /*
  * str_insert_random -- inserts specified (as string) number of random numbers
  */
@@ -144,6 +181,7 @@ help(void)
 	printf("c $value - check $value, returns 0/1\n");
 	printf("n $value - insert $value random values\n");
 	printf("p - print all values\n");
+	printf("s $start $end - print values from $start to $end\n");
 	printf("d - print debug info\n");
 	printf("b [$value] - rebuild $value (default: 1) times\n");
 	printf("q - quit\n");
@@ -177,8 +215,8 @@ main(int argc, char *argv[])
 {
 	if (argc < 3 || argc > 4) {
 		printf("usage: %s "
-			"hashmap_tx|hashmap_atomic|hashmap_rp|"
-			"ctree|btree|rtree|rbtree|skiplist"
+			"hashmap_tx|hashmap_atomic|hashmap_rp|hashmap_mt|"
+			"ctree|btree|fptree|art|rtree|rbtree|skiplist"
 				" file-name [<seed>]\n", argv[0]);
 		return 1;
 	}
@@ -192,10 +230,16 @@ main(int argc, char *argv[])
 		ops = MAP_HASHMAP_ATOMIC;
 	} else if (strcmp(type, "hashmap_rp") == 0) {
 		ops = MAP_HASHMAP_RP;
+	} else if (strcmp(type, "hashmap_mt") == 0) {
+		ops = MAP_HASHMAP_MT;
 	} else if (strcmp(type, "ctree") == 0) {
 		ops = MAP_CTREE;
 	} else if (strcmp(type, "btree") == 0) {
 		ops = MAP_BTREE;
+	} else if (strcmp(type, "fptree") == 0) {
+		ops = MAP_FPTREE;
+	} else if (strcmp(type, "art") == 0) {
+		ops = MAP_ART;
 	} else if (strcmp(type, "rtree") == 0) {
 		ops = MAP_RTREE;
 	} else if (strcmp(type, "rbtree") == 0) {
@@ -289,6 +333,9 @@ main(int argc, char *argv[])
 			case 'p':
 				print_all();
 				break;
+			case 's':
+				str_scan(buf + 1);
+				break;
 			case 'd':
 				map_cmd(mapc, map, HASHMAP_CMD_DEBUG,
 						(uint64_t)stdout);
@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * mpmc.c -- multi-producer multi-consumer persistent queue example
+ *
+ * The producers enqueue the given number of items each, in batches, while
+ * the consumers dequeue them until all the producers are finished and the
+ * queue is empty. The items left in the queue by a previous run are
+ * dequeued before the threads are started.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <libpmemobj.h>
+
+#include "mpmc_queue.h"
+
+POBJ_LAYOUT_BEGIN(mpmc);
+POBJ_LAYOUT_ROOT(mpmc, struct root);
+POBJ_LAYOUT_END(mpmc);
+
+#define MPMC_POOL_SIZE (64 * 1024 * 1024)
+#define MPMC_CAPACITY 1024
+#define MPMC_BATCH 8
+
+struct root {
+	TOID(struct mpmc_queue) queue;
+};
+
+static PMEMobjpool *pop;
+static TOID(struct mpmc_queue) queue;
+
+static unsigned nproducers;
+static unsigned nconsumers;
+static uint64_t nitems;
+static unsigned producers_done;
+
+/* number of times each of the items was dequeued */
+static unsigned *seen;
+
+/*
+ * producer -- enqueues the items of a single producer
+ */
+static void *
+producer(void *arg)
+{
+	uint64_t first = (uint64_t)(uintptr_t)arg * nitems;
+	uint64_t values[MPMC_BATCH];
+	struct mpmc_queue_buf bufs[MPMC_BATCH];
+	void *ret = NULL;
+
+	for (uint64_t i = 0; i < nitems; ) {
+		size_t n;
+		for (n = 0; n < MPMC_BATCH && i + n < nitems; ++n) {
+			values[n] = first + i + n;
+			bufs[n].data = &values[n];
+			bufs[n].len = sizeof(values[n]);
+		}
+
+		if (mpmc_queue_enqueue(pop, queue, bufs, n) == 0) {
+			i += n;
+		} else if (errno == ENOBUFS && nconsumers > 0) {
+			/* wait for the consumers to make some space */
+			sched_yield();
+		} else {
+			perror("mpmc_queue_enqueue");
+			ret = (void *)1;
+			break;
+		}
+	}
+
+	__atomic_fetch_add(&producers_done, 1, __ATOMIC_RELEASE);
+
+	return ret;
+}
+
+/*
+ * item_consume -- marks the dequeued item as seen
+ */
+static void
+item_consume(const void *data, size_t len, void *arg)
+{
+	uint64_t *nconsumed = arg;
+	uint64_t value;
+
+	if (len != sizeof(value)) {
+		fprintf(stderr, "invalid item length %zu\n", len);
+		return;
+	}
+
+	memcpy(&value, data, sizeof(value));
+	if (value < nproducers * nitems)
+		__atomic_fetch_add(&seen[value], 1, __ATOMIC_RELAXED);
+	(*nconsumed)++;
+}
+
+/*
+ * consumer -- dequeues the items until the producers are finished
+ */
+static void *
+consumer(void *arg)
+{
+	uint64_t *nconsumed = arg;
+
+	while (1) {
+		unsigned done = __atomic_load_n(&producers_done,
+			__ATOMIC_ACQUIRE);
+
+		int n = mpmc_queue_dequeue(pop, queue, MPMC_BATCH,
+			item_consume, nconsumed);
+		if (n < 0) {
+			perror("mpmc_queue_dequeue");
+			return (void *)1;
+		}
+
+		if (n == 0) {
+			if (done == nproducers)
+				break;
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * item_count -- counts the items left in the queue by a previous run
+ */
+static void
+item_count(const void *data, size_t len, void *arg)
+{
+	(*(uint64_t *)arg)++;
+}
+
+int
+main(int argc, char *argv[])
+{
+	if (argc != 5) {
+		printf("usage: %s file-name producers consumers items\n",
+				argv[0]);
+		return 1;
+	}
+
+	const char *path = argv[1];
+	nproducers = (unsigned)atoi(argv[2]);
+	nconsumers = (unsigned)atoi(argv[3]);
+	nitems = strtoull(argv[4], NULL, 10);
+
+	if (access(path, F_OK) != 0) {
+		pop = pmemobj_create(path, POBJ_LAYOUT_NAME(mpmc),
+				MPMC_POOL_SIZE, 0666);
+		if (pop == NULL) {
+			fprintf(stderr, "failed to create pool: %s\n",
+					pmemobj_errormsg());
+			return 1;
+		}
+	} else {
+		pop = pmemobj_open(path, POBJ_LAYOUT_NAME(mpmc));
+		if (pop == NULL) {
+			fprintf(stderr, "failed to open pool: %s\n",
+					pmemobj_errormsg());
+			return 1;
+		}
+	}
+
+	TOID(struct root) root = POBJ_ROOT(pop, struct root);
+	if (TOID_IS_NULL(D_RO(root)->queue) &&
+			mpmc_queue_create(pop, &D_RW(root)->queue,
+				MPMC_CAPACITY) != 0) {
+		perror("mpmc_queue_create");
+		pmemobj_close(pop);
+		return 1;
+	}
+	queue = D_RO(root)->queue;
+
+	if (mpmc_queue_init(pop, queue) != 0) {
+		perror("mpmc_queue_init");
+		pmemobj_close(pop);
+		return 1;
+	}
+
+	uint64_t nrecovered = 0;
+	while (mpmc_queue_dequeue(pop, queue, MPMC_BATCH, item_count,
+			&nrecovered) > 0)
+		;
+	printf("recovered %lu\n", (unsigned long)nrecovered);
+
+	uint64_t total = nproducers * nitems;
+	pthread_t *threads = calloc(nproducers + nconsumers,
+		sizeof(pthread_t));
+	uint64_t *nconsumed = calloc(nconsumers + 1, sizeof(uint64_t));
+	seen = calloc(total + 1, sizeof(unsigned));
+	if (threads == NULL || nconsumed == NULL || seen == NULL) {
+		perror("calloc");
+		pmemobj_close(pop);
+		return 1;
+	}
+
+	for (unsigned i = 0; i < nproducers; ++i)
+		pthread_create(&threads[i], NULL, producer,
+			(void *)(uintptr_t)i);
+	for (unsigned i = 0; i < nconsumers; ++i)
+		pthread_create(&threads[nproducers + i], NULL, consumer,
+			&nconsumed[i]);
+
+	int ret = 0;
+	for (unsigned i = 0; i < nproducers + nconsumers; ++i) {
+		void *tret;
+		pthread_join(threads[i], &tret);
+		if (tret != NULL)
+			ret = 1;
+	}
+
+	uint64_t consumed = 0;
+	for (unsigned i = 0; i < nconsumers; ++i)
+		consumed += nconsumed[i];
+
+	uint64_t missing = 0;
+	uint64_t duplicated = 0;
+	for (uint64_t i = 0; i < total && nconsumers > 0; ++i) {
+		if (seen[i] == 0)
+			missing++;
+		else if (seen[i] > 1)
+			duplicated++;
+	}
+
+	printf("produced %lu consumed %lu missing %lu duplicated %lu\n",
+		(unsigned long)total, (unsigned long)consumed,
+		(unsigned long)missing, (unsigned long)duplicated);
+	printf("left %zu\n", mpmc_queue_count(pop, queue));
+
+	free(seen);
+	free(nconsumed);
+	free(threads);
+	pmemobj_close(pop);
+
+	return ret;
+}
@@ -0,0 +1,391 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * mpmc_queue.c -- multi-producer multi-consumer persistent queue
+ *
+ * The queue is a ring of slots pointing to the entries, which are allocated
+ * separately. The entries in the positions from the persistent head to the
+ * persistent tail are in the queue, a position is mapped to the slot with
+ * the index equal to the position modulo the capacity.
+ *
+ * A producer reserves and fills in a batch of entries with the action API
+ * first, then takes the positions for them in the volatile index, stores the
+ * entries in the slots and publishes the reservations together with the new
+ * tail. A consumer takes the positions, reads the entries and publishes
+ * the deferred frees of the entries together with the new head. Only the
+ * publishing of the batches is done in the order of their positions, the
+ * rest of the work of the producers and the consumers runs in parallel.
+ *
+ * An entry is read before it's freed, so after a crash the entries of the
+ * batches which were being dequeued are returned again.
+ */
+
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libpmemobj.h>
+#include "mpmc_queue.h"
+
+TOID_DECLARE(struct entry, MPMC_QUEUE_TYPE_OFFSET + 1);
+
+#define CACHELINE_SIZE 64
+
+struct entry {
+	uint64_t len;
+	char data[];
+};
+
+struct position {
+	uint64_t value;
+	char padding[CACHELINE_SIZE - sizeof(uint64_t)];
+};
+
+/* volatile index of the queue, rebuilt after the pool is opened */
+struct runtime {
+	/* positions taken by the producers and by the consumers */
+	struct position tail_claimed;
+	struct position head_claimed;
+
+	/* positions published by the producers and by the consumers */
+	struct position tail_done;
+	struct position head_done;
+};
+
+struct mpmc_queue {
+	/* the first position in the queue, written by the consumers */
+	struct position head;
+	/* the position after the last one in the queue, by the producers */
+	struct position tail;
+
+	/* number of the slots, a power of 2 */
+	uint64_t capacity;
+
+	PMEMvlt(struct runtime) runtime;
+
+	/* entries of the positions, NULL if the position is empty */
+	TOID(struct entry) slot[];
+};
+
+/*
+ * runtime_construct -- (internal) rebuilds the index after the pool is
+ * opened
+ */
+static int
+runtime_construct(void *ptr, void *arg)
+{
+	struct runtime *rt = ptr;
+	struct mpmc_queue *q = arg;
+
+	memset(rt, 0, sizeof(*rt));
+	rt->tail_claimed.value = rt->tail_done.value = q->tail.value;
+	rt->head_claimed.value = rt->head_done.value = q->head.value;
+
+	return 0;
+}
+
+/*
+ * runtime_get -- (internal) returns the volatile index of the queue
+ */
+static struct runtime *
+runtime_get(PMEMobjpool *pop, struct mpmc_queue *q)
+{
+	return pmemobj_volatile(pop, &q->runtime.vlt,
+		&q->runtime.value, sizeof(q->runtime.value),
+		runtime_construct, q);
+}
+
+/*
+ * slots_persist -- (internal) persists the slots of the positions
+ */
+static void
+slots_persist(PMEMobjpool *pop, struct mpmc_queue *q, uint64_t pos, size_t n)
+{
+	uint64_t first = pos & (q->capacity - 1);
+	uint64_t len = q->capacity - first < n ? q->capacity - first : n;
+
+	pmemobj_flush(pop, &q->slot[first], len * sizeof(q->slot[0]));
+	if (len < n)
+		pmemobj_flush(pop, &q->slot[0], (n - len) * sizeof(q->slot[0]));
+	pmemobj_drain(pop);
+}
+
+/*
+ * position_wait -- (internal) waits until the previous batches are published
+ */
+static void
+position_wait(uint64_t *done, uint64_t pos)
+{
+	while (__atomic_load_n(done, __ATOMIC_ACQUIRE) != pos)
+		sched_yield();
+}
+
+/*
+ * mpmc_queue_create -- allocates a new queue, the capacity must be a power
+ * of 2
+ */
+int
+mpmc_queue_create(PMEMobjpool *pop, TOID(struct mpmc_queue) *queue,
+	size_t capacity)
+{
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	struct pobj_action actv[3];
+	size_t size = sizeof(struct mpmc_queue) +
+		capacity * sizeof(TOID(struct entry));
+
+	PMEMoid oid = pmemobj_reserve(pop, &actv[0], size,
+		TOID_TYPE_NUM(struct mpmc_queue));
+	if (OID_IS_NULL(oid))
+		return -1;
+
+	/* the slots are not used before they are written */
+	struct mpmc_queue *q = pmemobj_direct(oid);
+	memset(q, 0, sizeof(*q));
+	q->capacity = capacity;
+	pmemobj_persist(pop, q, sizeof(*q));
+
+	pmemobj_set_value(pop, &actv[1], &queue->oid.pool_uuid_lo,
+		oid.pool_uuid_lo);
+	pmemobj_set_value(pop, &actv[2], &queue->oid.off, oid.off);
+
+	return pmemobj_publish(pop, actv, 3);
+}
+
+/*
+ * mpmc_queue_destroy -- frees the queue and its entries, it cannot be used
+ * concurrently
+ */
+int
+mpmc_queue_destroy(PMEMobjpool *pop, TOID(struct mpmc_queue) *queue)
+{
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		struct mpmc_queue *q = D_RW(*queue);
+		for (uint64_t pos = q->head.value; pos != q->tail.value;
+				++pos) {
+			TOID(struct entry) e = q->slot[pos & (q->capacity - 1)];
+			if (!TOID_IS_NULL(e))
+				TX_FREE(e);
+		}
+
+		TX_FREE(*queue);
+		TX_SET_DIRECT(queue, oid, OID_NULL);
+	} TX_ONABORT {
+		ret = -1;
+	} TX_END
+
+	return ret;
+}
+
+/*
+ * mpmc_queue_init -- rebuilds the volatile index of the queue
+ */
+int
+mpmc_queue_init(PMEMobjpool *pop, TOID(struct mpmc_queue) queue)
+{
+	return runtime_get(pop, D_RW(queue)) == NULL ? -1 : 0;
+}
+
+/*
+ * mpmc_queue_enqueue -- appends n entries to the queue, either all of them or
+ * none, sets errno to ENOBUFS if there is not enough space in the queue
+ */
+int
+mpmc_queue_enqueue(PMEMobjpool *pop, TOID(struct mpmc_queue) queue,
+	const struct mpmc_queue_buf *bufs, size_t n)
+{
+	if (n == 0)
+		return 0;
+
+	if (n > MPMC_QUEUE_MAX_BATCH) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	struct mpmc_queue *q = D_RW(queue);
+	struct runtime *rt = runtime_get(pop, q);
+	if (rt == NULL)
+		return -1;
+
+	struct pobj_action actv[MPMC_QUEUE_MAX_BATCH + 1];
+	TOID(struct entry) entries[MPMC_QUEUE_MAX_BATCH];
+
+	/* the entries are prepared before any position is taken */
+	for (size_t i = 0; i < n; ++i) {
+		entries[i].oid = pmemobj_reserve(pop, &actv[i],
+			sizeof(struct entry) + bufs[i].len,
+			TOID_TYPE_NUM(struct entry));
+		if (TOID_IS_NULL(entries[i])) {
+			pmemobj_cancel(pop, actv, i);
+			return -1;
+		}
+
+		struct entry *e = D_RW(entries[i]);
+		e->len = bufs[i].len;
+		memcpy(e->data, bufs[i].data, bufs[i].len);
+		pmemobj_flush(pop, e, sizeof(*e) + bufs[i].len);
+	}
+	pmemobj_drain(pop);
+
+	uint64_t tail = __atomic_load_n(&rt->tail_claimed.value,
+		__ATOMIC_RELAXED);
+	do {
+		uint64_t head = __atomic_load_n(&rt->head_done.value,
+			__ATOMIC_ACQUIRE);
+		if (tail + n - head > q->capacity) {
+			pmemobj_cancel(pop, actv, n);
+			errno = ENOBUFS;
+			return -1;
+		}
+	} while (!__atomic_compare_exchange_n(&rt->tail_claimed.value, &tail,
+			tail + n, 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	/* nobody reads the slots after the persistent tail */
+	for (size_t i = 0; i < n; ++i)
+		q->slot[(tail + i) & (q->capacity - 1)] = entries[i];
+	slots_persist(pop, q, tail, n);
+
+	position_wait(&rt->tail_done.value, tail);
+
+	int ret = 0;
+	pmemobj_set_value(pop, &actv[n], &q->tail.value, tail + n);
+	if (pmemobj_publish(pop, actv, n + 1) != 0) {
+		/*
+		 * The positions cannot be given back, so they are left empty
+		 * and the consumers skip them.
+		 */
+		pmemobj_cancel(pop, actv, n);
+		for (size_t i = 0; i < n; ++i)
+			TOID_ASSIGN(q->slot[(tail + i) & (q->capacity - 1)],
+				OID_NULL);
+		slots_persist(pop, q, tail, n);
+
+		q->tail.value = tail + n;
+		pmemobj_persist(pop, &q->tail.value, sizeof(q->tail.value));
+		ret = -1;
+	}
+
+	__atomic_store_n(&rt->tail_done.value, tail + n, __ATOMIC_RELEASE);
+
+	return ret;
+}
+
+/*
+ * queue_take -- (internal) takes up to n positions from the head of the queue
+ * and passes their entries to the callback, returns the number of the
+ * entries
+ */
+static int
+queue_take(PMEMobjpool *pop, struct mpmc_queue *q, struct runtime *rt,
+	size_t n, void (*cb)(const void *data, size_t len, void *arg),
+	void *arg, uint64_t *ntaken)
+{
+	uint64_t head = __atomic_load_n(&rt->head_claimed.value,
+		__ATOMIC_RELAXED);
+	uint64_t count;
+	do {
+		uint64_t tail = __atomic_load_n(&rt->tail_done.value,
+			__ATOMIC_ACQUIRE);
+		if (head == tail) {
+			*ntaken = 0;
+			return 0;
+		}
+		count = tail - head < n ? tail - head : n;
+	} while (!__atomic_compare_exchange_n(&rt->head_claimed.value, &head,
+			head + count, 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	struct pobj_action actv[MPMC_QUEUE_MAX_BATCH + 1];
+	size_t nactv = 0;
+
+	for (uint64_t pos = head; pos != head + count; ++pos) {
+		TOID(struct entry) e = q->slot[pos & (q->capacity - 1)];
+		if (TOID_IS_NULL(e))
+			continue;
+
+		cb(D_RO(e)->data, D_RO(e)->len, arg);
+		pmemobj_defer_free(pop, e.oid, &actv[nactv++]);
+	}
+	int nentries = (int)nactv;
+
+	position_wait(&rt->head_done.value, head);
+
+	int ret = 0;
+	pmemobj_set_value(pop, &actv[nactv++], &q->head.value, head + count);
+	if (pmemobj_publish(pop, actv, nactv) != 0) {
+		/* the freed entries are skipped if the head is not moved */
+		pmemobj_cancel(pop, actv, nactv);
+		for (uint64_t pos = head; pos != head + count; ++pos) {
+			PMEMoid *slot = &q->slot[pos & (q->capacity - 1)].oid;
+			if (!OID_IS_NULL(*slot))
+				pmemobj_free(slot);
+		}
+
+		q->head.value = head + count;
+		pmemobj_persist(pop, &q->head.value, sizeof(q->head.value));
+		ret = -1;
+	}
+
+	__atomic_store_n(&rt->head_done.value, head + count,
+		__ATOMIC_RELEASE);
+
+	*ntaken = count;
+
+	return ret ? ret : nentries;
+}
+
+/*
+ * mpmc_queue_dequeue -- removes up to n entries from the queue, the callback
+ * is called for each of them before it's removed, returns the number of
+ * the entries or 0 if the queue is empty
+ */
+int
+mpmc_queue_dequeue(PMEMobjpool *pop, TOID(struct mpmc_queue) queue,
+	size_t n, void (*cb)(const void *data, size_t len, void *arg),
+	void *arg)
+{
+	if (n > MPMC_QUEUE_MAX_BATCH) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	struct mpmc_queue *q = D_RW(queue);
+	struct runtime *rt = runtime_get(pop, q);
+	if (rt == NULL)
+		return -1;
+
+	int ret;
+	uint64_t ntaken;
+
+	/* the positions left empty by the failed producers are skipped */
+	do {
+		ret = queue_take(pop, q, rt, n, cb, arg, &ntaken);
+	} while (ret == 0 && ntaken != 0);
+
+	return ret;
+}
+
+/*
+ * mpmc_queue_count -- returns the number of entries in the queue
+ */
+size_t
+mpmc_queue_count(PMEMobjpool *pop, TOID(struct mpmc_queue) queue)
+{
+	struct mpmc_queue *q = D_RW(queue);
+	struct runtime *rt = runtime_get(pop, q);
+	if (rt == NULL)
+		return 0;
+
+	uint64_t head = __atomic_load_n(&rt->head_done.value,
+		__ATOMIC_ACQUIRE);
+	uint64_t tail = __atomic_load_n(&rt->tail_done.value,
+		__ATOMIC_ACQUIRE);
+
+	return tail - head;
+}
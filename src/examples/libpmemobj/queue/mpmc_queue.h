@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * mpmc_queue.h -- multi-producer multi-consumer persistent queue
+ */
+
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <libpmemobj.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MPMC_QUEUE_TYPE_OFFSET
+#define MPMC_QUEUE_TYPE_OFFSET 1036
+#endif
+
+/* the maximum number of entries enqueued or dequeued at once */
+#define MPMC_QUEUE_MAX_BATCH 32
+
+struct mpmc_queue;
+TOID_DECLARE(struct mpmc_queue, MPMC_QUEUE_TYPE_OFFSET + 0);
+
+/* data of a single entry */
+struct mpmc_queue_buf {
+	const void *data;
+	size_t len;
+};
+
+int mpmc_queue_create(PMEMobjpool *pop, TOID(struct mpmc_queue) *queue,
+		size_t capacity);
+int mpmc_queue_destroy(PMEMobjpool *pop, TOID(struct mpmc_queue) *queue);
+int mpmc_queue_init(PMEMobjpool *pop, TOID(struct mpmc_queue) queue);
+int mpmc_queue_enqueue(PMEMobjpool *pop, TOID(struct mpmc_queue) queue,
+		const struct mpmc_queue_buf *bufs, size_t n);
+int mpmc_queue_dequeue(PMEMobjpool *pop, TOID(struct mpmc_queue) queue,
+		size_t n, void (*cb)(const void *data, size_t len, void *arg),
+		void *arg);
+size_t mpmc_queue_count(PMEMobjpool *pop, TOID(struct mpmc_queue) queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MPMC_QUEUE_H */
@@ -0,0 +1,2274 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * art_map.c -- adaptive radix tree for concurrent use which uses action.h
+ * reserve/publish API
+ *
+ * The inner nodes have room for 4, 16, 48 or 256 children and a full node is
+ * replaced by a node of the next bigger type. The header of a node takes
+ * exactly one cache line and the nodes are allocated from allocation classes
+ * aligned to the cache line size. The part of the keys common to all of the
+ * children of a node is stored in its header, up to MAX_PREFIX bytes, a
+ * longer one takes a chain of nodes. A leaf holds the whole key, it's pointed
+ * to by a child slot of a node or, if the key ends at the node, by its
+ * header.
+ *
+ * The nodes are synchronized with the optimistic lock coupling. Each node has
+ * a version, kept in a volatile variable, which is bumped by the writers of
+ * the node. The readers take no locks, they check that the version of a node
+ * hasn't changed after reading it and start over if it has. A writer locks
+ * only the nodes it modifies, which are the node and its parent at most.
+ *
+ * The tree is never modified in a transaction. A new child is written to
+ * a free slot of the node in place, and it becomes visible together with the
+ * new leaf and nodes when the 8-byte word marking the slots in use is updated
+ * by pmemobj_publish. The nodes replaced by bigger ones and the removed leaves
+ * are put on a garbage list by the same publish and they are freed only when
+ * no reader may still see them, which is tracked with epochs. Apart from the
+ * slots and the prefix of a node nothing is modified after it's published.
+ * The nodes are not shrunk, a node is unlinked only once it's empty.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "art_map.h"
+
+/* the longest common part of the keys stored in a node */
+#define MAX_PREFIX 22
+
+/* marks the offset of a leaf in a child slot */
+#define LEAF_TAG 1ULL
+
+/* bits of the version of a node, the counter is above them */
+#define VERSION_OBSOLETE 1ULL
+#define VERSION_LOCKED 2ULL
+
+/* number of the garbage lists, a power of 2 */
+#define GC_SHARDS 16
+
+/* maximum number of removed objects freed at once */
+#define COLLECT_MAX 16
+
+/* number of counters the number of entries is split into, a power of 2 */
+#define COUNTERS_NUM 64
+
+/* maximum number of threads using the maps at the same time */
+#define MAX_THREADS 1024
+
+#define CACHELINE_SIZE 64
+
+/* size of a block of the allocation class of the nodes */
+#define NODE_BLOCK_SIZE (256 * 1024)
+
+/* a chain of nodes holding the longest key and a few more */
+#define ACTIONS_MAX (ART_MAP_MAX_KEY_LEN / (MAX_PREFIX + 1) + 16)
+
+/* maximum number of the nodes on the path to a key */
+#define PATH_MAX_NODES (ART_MAP_MAX_KEY_LEN + 1)
+
+/* length of the keys of the integer interface */
+#define KEY64_LEN 8
+
+#define NODE_TYPE_NUM(type) (ART_MAP_TYPE_OFFSET + 1 + (type))
+#define LEAF_TYPE_NUM (ART_MAP_TYPE_OFFSET + 5)
+
+enum node_type {
+	NODE4,
+	NODE16,
+	NODE48,
+	NODE256,
+
+	MAX_NODE_TYPE
+};
+
+/* link of an object waiting to be freed */
+struct gc {
+	/* offset of the next object on the garbage list */
+	uint64_t next;
+	/* epoch in which the object was unlinked */
+	uint64_t epoch;
+};
+
+/* type and prefix of a node, a split of the prefix rewrites the words */
+union node_path {
+	struct {
+		uint8_t type;
+		uint8_t prefix_len;
+		uint8_t prefix[MAX_PREFIX];
+	};
+	uint64_t word[3];
+};
+
+struct node {
+	struct gc gc;
+
+	/* obsolete and locked flags and the counter of the writers */
+	PMEMvlt(uint64_t) version;
+
+	union node_path path;
+
+	/* offset of the leaf of the key which ends at the node */
+	uint64_t leaf;
+};
+
+/*
+ * node16 -- node with up to 16 children, the keys are not sorted, a node4 is
+ * the same with only the first 4 child slots
+ */
+struct node16 {
+	struct node n;
+	/* slots in use */
+	uint64_t bitmap;
+	uint8_t key[16];
+	/* offsets of the children, the leaves are tagged with LEAF_TAG */
+	uint64_t child[16];
+};
+
+struct node48 {
+	struct node n;
+	/* slots in use */
+	uint64_t bitmap;
+	/* slot of each key plus one, 0 if there is none */
+	union {
+		uint8_t slot[256];
+		uint64_t word[32];
+	} index;
+	uint64_t child[48];
+};
+
+struct node256 {
+	struct node n;
+	/* number of the children */
+	uint64_t count;
+	uint64_t child[256];
+};
+
+struct leaf {
+	struct gc gc;
+
+	PMEMoid value;
+	uint64_t key_len;
+	uint8_t key[];
+};
+
+/* list of the unlinked objects */
+struct shard {
+	/* serializes the writers of the list */
+	PMEMmutex lock;
+	/* offset of the most recently unlinked object */
+	uint64_t head;
+	char padding[CACHELINE_SIZE - sizeof(uint64_t)];
+};
+
+struct counter {
+	int64_t value;
+	char padding[CACHELINE_SIZE - sizeof(int64_t)];
+};
+
+/* volatile state of the map, rebuilt after the pool is opened */
+struct runtime {
+	/* number of entries, split to avoid contention of the writers */
+	struct counter count[COUNTERS_NUM];
+
+	/* flags of the allocation of the nodes of each type */
+	uint64_t node_flags[MAX_NODE_TYPE];
+};
+
+struct art_map {
+	/* offset of the root, a node256 which is never replaced */
+	uint64_t root;
+
+	/* garbage lists, each thread uses one of them */
+	struct shard garbage[GC_SHARDS];
+
+	PMEMvlt(struct runtime) runtime;
+};
+
+/* node on the path to a key and its version */
+struct level {
+	struct node *n;
+	uint64_t *ver;
+	uint64_t v;
+	/* byte of the key of the next node on the path */
+	uint8_t byte;
+};
+
+/* changes of the tree made visible by a single publish */
+struct op {
+	PMEMobjpool *pop;
+	struct art_map *map;
+	struct runtime *rt;
+
+	struct pobj_action actv[ACTIONS_MAX];
+	size_t actv_cnt;
+
+	/* objects reserved by the operation, persisted before the publish */
+	void *obj[ACTIONS_MAX];
+	size_t obj_size[ACTIONS_MAX];
+	size_t obj_cnt;
+
+	/* objects unlinked by the operation */
+	struct gc *retired[PATH_MAX_NODES + 1];
+	unsigned retired_cnt;
+
+	/* nodes on the path of a removed key which may be left empty */
+	struct level run[PATH_MAX_NODES];
+};
+
+static const size_t node_size[MAX_NODE_TYPE] = {
+	offsetof(struct node16, child) + 4 * sizeof(uint64_t),
+	sizeof(struct node16),
+	sizeof(struct node48),
+	sizeof(struct node256),
+};
+
+static const unsigned node_capacity[MAX_NODE_TYPE] = {4, 16, 48, 256};
+
+/*
+ * Epochs: an operation announces the global epoch when it starts and clears
+ * the announcement when it finishes. The global epoch is advanced only when
+ * all of the running operations have announced the current one, so an object
+ * unlinked in epoch e cannot be reached by anyone once the global epoch is
+ * e + 2. The epochs are shared by all of the maps in the process.
+ */
+struct epoch_slot {
+	/* announced epoch, 0 outside of the operations */
+	uint64_t epoch;
+	/* the slot is assigned to a thread */
+	uint64_t used;
+	char padding[CACHELINE_SIZE - 2 * sizeof(uint64_t)];
+};
+
+static struct {
+	uint64_t epoch;
+	/* number of slots which have ever been assigned */
+	uint64_t nslots;
+	char padding[CACHELINE_SIZE - 2 * sizeof(uint64_t)];
+	struct epoch_slot slot[MAX_THREADS];
+} epochs = {.epoch = 1};
+
+static pthread_once_t epoch_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t epoch_key;
+
+static __thread struct epoch_slot *epoch_slot;
+static __thread unsigned epoch_depth;
+
+/*
+ * epoch_slot_release -- (internal) returns the slot of the exiting thread
+ */
+static void
+epoch_slot_release(void *arg)
+{
+	struct epoch_slot *slot = arg;
+
+	__atomic_store_n(&slot->used, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ * epoch_key_create -- (internal) creates the key used to release the slots
+ */
+static void
+epoch_key_create(void)
+{
+	if (pthread_key_create(&epoch_key, epoch_slot_release)) {
+		fprintf(stderr, "pthread_key_create failed\n");
+		abort();
+	}
+}
+
+/*
+ * epoch_slot_get -- (internal) returns the slot of the calling thread
+ */
+static struct epoch_slot *
+epoch_slot_get(void)
+{
+	if (epoch_slot != NULL)
+		return epoch_slot;
+
+	pthread_once(&epoch_key_once, epoch_key_create);
+
+	for (uint64_t i = 0; i < MAX_THREADS; ++i) {
+		struct epoch_slot *slot = &epochs.slot[i];
+		uint64_t unused = 0;
+		if (!__atomic_compare_exchange_n(&slot->used, &unused, 1, 0,
+				__ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+			continue;
+
+		/* make the slot visible to epoch_try_advance */
+		uint64_t n = __atomic_load_n(&epochs.nslots, __ATOMIC_ACQUIRE);
+		while (n < i + 1 && !__atomic_compare_exchange_n(&epochs.nslots,
+				&n, i + 1, 0, __ATOMIC_ACQ_REL,
+				__ATOMIC_ACQUIRE))
+			;
+
+		pthread_setspecific(epoch_key, slot);
+		epoch_slot = slot;
+
+		return slot;
+	}
+
+	fprintf(stderr, "too many threads use art_map\n");
+	abort();
+}
+
+/*
+ * epoch_index -- (internal) returns the index of the slot of the calling
+ * thread, used to spread the threads over the shared structures
+ */
+static inline unsigned
+epoch_index(void)
+{
+	return (unsigned)(epoch_slot_get() - epochs.slot);
+}
+
+/*
+ * epoch_now -- (internal) returns the global epoch
+ */
+static inline uint64_t
+epoch_now(void)
+{
+	return __atomic_load_n(&epochs.epoch, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * epoch_retire -- (internal) returns the epoch in which the objects unlinked
+ * by the preceding stores are retired
+ */
+static inline uint64_t
+epoch_retire(void)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	return epoch_now();
+}
+
+/*
+ * epoch_enter -- (internal) announces the global epoch, the objects
+ * reachable from now on are not freed until epoch_exit
+ */
+static void
+epoch_enter(void)
+{
+	if (epoch_depth++ != 0)
+		return;
+
+	struct epoch_slot *slot = epoch_slot_get();
+	uint64_t announced;
+	uint64_t e = epoch_now();
+	do {
+		announced = e;
+		__atomic_store_n(&slot->epoch, announced, __ATOMIC_SEQ_CST);
+		e = epoch_now();
+	} while (e != announced);
+}
+
+/*
+ * epoch_exit -- (internal) clears the announcement of epoch_enter
+ */
+static void
+epoch_exit(void)
+{
+	if (--epoch_depth != 0)
+		return;
+
+	__atomic_store_n(&epoch_slot->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ * epoch_try_advance -- (internal) advances the global epoch if all of the
+ * running operations have announced the current one
+ */
+static void
+epoch_try_advance(void)
+{
+	uint64_t e = epoch_now();
+	uint64_t n = __atomic_load_n(&epochs.nslots, __ATOMIC_ACQUIRE);
+
+	for (uint64_t i = 0; i < n; ++i) {
+		uint64_t s = __atomic_load_n(&epochs.slot[i].epoch,
+			__ATOMIC_SEQ_CST);
+		if (s != 0 && s != e)
+			return;
+	}
+
+	__atomic_compare_exchange_n(&epochs.epoch, &e, e + 1, 0,
+		__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * obj_get -- (internal) returns the object at the offset, which may be
+ * tagged with LEAF_TAG
+ */
+static inline void *
+obj_get(PMEMobjpool *pop, uint64_t off)
+{
+	return (char *)pop + (off & ~LEAF_TAG);
+}
+
+/*
+ * obj_off -- (internal) returns the offset of the object
+ */
+static inline uint64_t
+obj_off(PMEMobjpool *pop, const void *ptr)
+{
+	return (uint64_t)((const char *)ptr - (const char *)pop);
+}
+
+/*
+ * gc_get -- (internal) returns the object on a garbage list at the offset,
+ * NULL if the offset is 0
+ */
+static inline struct gc *
+gc_get(PMEMobjpool *pop, uint64_t off)
+{
+	return off == 0 ? NULL : obj_get(pop, off);
+}
+
+/*
+ * shard_lock -- (internal) locks the garbage list
+ */
+static void
+shard_lock(PMEMobjpool *pop, struct shard *s)
+{
+	if (pmemobj_mutex_lock(pop, &s->lock)) {
+		fprintf(stderr, "garbage lock failed: %s\n",
+			pmemobj_errormsg());
+		abort();
+	}
+}
+
+/*
+ * shard_unlock -- (internal) unlocks the garbage list
+ */
+static void
+shard_unlock(PMEMobjpool *pop, struct shard *s)
+{
+	pmemobj_mutex_unlock(pop, &s->lock);
+}
+
+/*
+ * shard_collect -- (internal) frees the unlinked objects of the locked
+ * garbage list which cannot be reached anymore, or all of them if all is set
+ */
+static void
+shard_collect(PMEMobjpool *pop, struct shard *s, int all)
+{
+	uint64_t *link = &s->head;
+	struct gc *g = gc_get(pop, s->head);
+	if (g == NULL)
+		return;
+
+	/* the oldest objects are at the end of the list */
+	uint64_t now = epoch_now();
+	while (g != NULL && !all && g->epoch + 2 > now) {
+		link = &g->next;
+		g = gc_get(pop, g->next);
+	}
+
+	if (g == NULL) {
+		epoch_try_advance();
+		return;
+	}
+
+	struct pobj_action actv[COLLECT_MAX + 1];
+	size_t actv_cnt = 0;
+
+	for (; g != NULL && actv_cnt < COLLECT_MAX; g = gc_get(pop, g->next))
+		pmemobj_defer_free(pop, pmemobj_oid(g), &actv[actv_cnt++]);
+
+	pmemobj_set_value(pop, &actv[actv_cnt++], link,
+		g == NULL ? 0 : obj_off(pop, g));
+
+	pmemobj_publish(pop, actv, actv_cnt);
+}
+
+/*
+ * version_construct -- (internal) initializes the version of a node after
+ * the pool is opened
+ */
+static int
+version_construct(void *ptr, void *arg)
+{
+	*(uint64_t *)ptr = 0;
+
+	return 0;
+}
+
+/*
+ * node_version -- (internal) returns the version of the node
+ */
+static inline uint64_t *
+node_version(PMEMobjpool *pop, struct node *n)
+{
+	uint64_t *version = pmemobj_volatile(pop, &n->version.vlt,
+		&n->version.value, sizeof(n->version.value),
+		version_construct, NULL);
+	if (version == NULL) {
+		fprintf(stderr, "node version failed: %s\n",
+			pmemobj_errormsg());
+		abort();
+	}
+
+	return version;
+}
+
+/*
+ * node_read_lock -- (internal) waits until the node is not locked and returns
+ * its version, the node is obsolete if VERSION_OBSOLETE is set
+ */
+static uint64_t
+node_read_lock(uint64_t *version)
+{
+	uint64_t v;
+
+	while ((v = __atomic_load_n(version, __ATOMIC_ACQUIRE)) &
+			VERSION_LOCKED)
+		sched_yield();
+
+	return v;
+}
+
+/*
+ * node_read_check -- (internal) checks whether the node hasn't been modified
+ * since its version was read
+ */
+static inline int
+node_read_check(uint64_t *version, uint64_t v)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return __atomic_load_n(version, __ATOMIC_RELAXED) == v;
+}
+
+/*
+ * node_upgrade -- (internal) locks the node if it hasn't been modified since
+ * its version was read
+ */
+static inline int
+node_upgrade(uint64_t *version, uint64_t v)
+{
+	if (v & VERSION_OBSOLETE)
+		return 0;
+
+	return __atomic_compare_exchange_n(version, &v, v + VERSION_LOCKED, 0,
+		__ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/*
+ * node_unlock -- (internal) unlocks the node and bumps its version
+ */
+static inline void
+node_unlock(uint64_t *version)
+{
+	__atomic_fetch_add(version, VERSION_LOCKED, __ATOMIC_RELEASE);
+}
+
+/*
+ * node_unlock_obsolete -- (internal) unlocks the node which has been unlinked
+ * and marks it obsolete, it's not modified anymore
+ */
+static inline void
+node_unlock_obsolete(uint64_t *version)
+{
+	__atomic_fetch_add(version, VERSION_LOCKED | VERSION_OBSOLETE,
+		__ATOMIC_RELEASE);
+}
+
+/*
+ * node_prefix_len -- (internal) returns the length of the prefix of the node
+ */
+static inline size_t
+node_prefix_len(const struct node *n)
+{
+	size_t len = __atomic_load_n(&n->path.prefix_len, __ATOMIC_RELAXED);
+
+	/* may be read while the prefix is being split */
+	return len > MAX_PREFIX ? MAX_PREFIX : len;
+}
+
+/*
+ * prefix_match -- (internal) returns the number of the bytes of the prefix
+ * matching the key from the depth
+ */
+static inline size_t
+prefix_match(const struct node *n, size_t prefix_len, const uint8_t *key,
+	size_t key_len, size_t depth)
+{
+	size_t max = key_len - depth < prefix_len ? key_len - depth :
+		prefix_len;
+	size_t i = 0;
+
+	while (i < max && n->path.prefix[i] == key[depth + i])
+		++i;
+
+	return i;
+}
+
+/*
+ * node16_match -- (internal) returns the slots in use with the key
+ */
+static inline unsigned
+node16_match(const struct node16 *n, uint8_t b)
+{
+	uint64_t bitmap = __atomic_load_n(&n->bitmap, __ATOMIC_ACQUIRE);
+#ifdef __SSE2__
+	__m128i keys = _mm_loadu_si128((const __m128i *)n->key);
+	__m128i cmp = _mm_cmpeq_epi8(keys, _mm_set1_epi8((char)b));
+	unsigned mask = (unsigned)_mm_movemask_epi8(cmp);
+#else
+	unsigned mask = 0;
+	for (unsigned i = 0; i < 16; ++i) {
+		if (n->key[i] == b)
+			mask |= 1U << i;
+	}
+#endif
+	return mask & (unsigned)bitmap;
+}
+
+/*
+ * node_find -- (internal) returns the child of the node for the byte of
+ * the key and the slot in which it's stored, 0 if there is none
+ */
+static uint64_t
+node_find(struct node *n, uint8_t b, uint64_t **slot)
+{
+	switch (n->path.type) {
+	case NODE4:
+	case NODE16: {
+		struct node16 *n16 = (struct node16 *)n;
+		unsigned mask = node16_match(n16, b);
+		if (mask == 0)
+			return 0;
+		*slot = &n16->child[__builtin_ctz(mask)];
+		break;
+	}
+	case NODE48: {
+		struct node48 *n48 = (struct node48 *)n;
+		unsigned s = __atomic_load_n(&n48->index.slot[b],
+			__ATOMIC_ACQUIRE);
+		if (s == 0 || s > 48)
+			return 0;
+		*slot = &n48->child[s - 1];
+		break;
+	}
+	default:
+		*slot = &((struct node256 *)n)->child[b];
+		break;
+	}
+
+	return __atomic_load_n(*slot, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * node_next -- (internal) returns the child of the node with the lowest
+ * byte of the key which isn't lower than from, 0 if there is none
+ */
+static uint64_t
+node_next(struct node *n, unsigned from, unsigned *byte)
+{
+	switch (n->path.type) {
+	case NODE4:
+	case NODE16: {
+		struct node16 *n16 = (struct node16 *)n;
+		uint64_t bitmap = __atomic_load_n(&n16->bitmap,
+			__ATOMIC_ACQUIRE);
+		unsigned best = 256;
+		unsigned slot = 0;
+		for (; bitmap != 0; bitmap &= bitmap - 1) {
+			unsigned i = (unsigned)__builtin_ctzll(bitmap);
+			if (n16->key[i] >= from && n16->key[i] < best) {
+				best = n16->key[i];
+				slot = i;
+			}
+		}
+		if (best == 256)
+			return 0;
+		*byte = best;
+		return __atomic_load_n(&n16->child[slot], __ATOMIC_ACQUIRE);
+	}
+	case NODE48: {
+		struct node48 *n48 = (struct node48 *)n;
+		for (unsigned b = from; b < 256; ++b) {
+			unsigned s = __atomic_load_n(&n48->index.slot[b],
+				__ATOMIC_ACQUIRE);
+			if (s == 0 || s > 48)
+				continue;
+			uint64_t child = __atomic_load_n(&n48->child[s - 1],
+				__ATOMIC_ACQUIRE);
+			if (child != 0) {
+				*byte = b;
+				return child;
+			}
+		}
+		return 0;
+	}
+	default: {
+		struct node256 *n256 = (struct node256 *)n;
+		for (unsigned b = from; b < 256; ++b) {
+			uint64_t child = __atomic_load_n(&n256->child[b],
+				__ATOMIC_ACQUIRE);
+			if (child != 0) {
+				*byte = b;
+				return child;
+			}
+		}
+		return 0;
+	}
+	}
+}
+
+/*
+ * node_count -- (internal) returns the number of the children of the node
+ */
+static unsigned
+node_count(struct node *n)
+{
+	if (n->path.type == NODE256)
+		return (unsigned)((struct node256 *)n)->count;
+
+	/* the bitmap is at the same place in node16 and node48 */
+	return (unsigned)__builtin_popcountll(((struct node16 *)n)->bitmap);
+}
+
+/*
+ * node_full -- (internal) checks whether there is no free slot in the node
+ */
+static inline int
+node_full(struct node *n)
+{
+	return node_count(n) == node_capacity[n->path.type];
+}
+
+/*
+ * index_word -- (internal) returns the word of the index of the node48 with
+ * the slot of the key replaced
+ */
+static uint64_t
+index_word(const struct node48 *n, uint8_t b, uint8_t slot)
+{
+	union {
+		uint8_t slot[sizeof(uint64_t)];
+		uint64_t word;
+	} w;
+
+	w.word = n->index.word[b / sizeof(uint64_t)];
+	w.slot[b % sizeof(uint64_t)] = slot;
+
+	return w.word;
+}
+
+/*
+ * node_put -- (internal) adds the child to the node which hasn't been
+ * published yet
+ */
+static void
+node_put(struct node *n, uint8_t b, uint64_t child)
+{
+	unsigned i = node_count(n);
+
+	switch (n->path.type) {
+	case NODE4:
+	case NODE16: {
+		struct node16 *n16 = (struct node16 *)n;
+		n16->key[i] = b;
+		n16->child[i] = child;
+		n16->bitmap |= 1ULL << i;
+		break;
+	}
+	case NODE48: {
+		struct node48 *n48 = (struct node48 *)n;
+		n48->child[i] = child;
+		n48->index.slot[b] = (uint8_t)(i + 1);
+		n48->bitmap |= 1ULL << i;
+		break;
+	}
+	default: {
+		struct node256 *n256 = (struct node256 *)n;
+		n256->child[b] = child;
+		n256->count++;
+		break;
+	}
+	}
+}
+
+/*
+ * op_init -- (internal) prepares an empty operation on the map
+ */
+static void
+op_init(struct op *op, PMEMobjpool *pop, struct art_map *map,
+	struct runtime *rt)
+{
+	op->pop = pop;
+	op->map = map;
+	op->rt = rt;
+	op->actv_cnt = 0;
+	op->obj_cnt = 0;
+	op->retired_cnt = 0;
+}
+
+/*
+ * op_reserve -- (internal) reserves a zeroed object published by
+ * the operation
+ */
+static void *
+op_reserve(struct op *op, size_t size, uint64_t type_num, uint64_t flags)
+{
+	assert(op->actv_cnt < ACTIONS_MAX);
+
+	PMEMoid oid = pmemobj_xreserve(op->pop, &op->actv[op->actv_cnt], size,
+		type_num, POBJ_XALLOC_ZERO | flags);
+	if (OID_IS_NULL(oid)) {
+		fprintf(stderr, "art_map alloc failed: %s\n",
+			pmemobj_errormsg());
+		return NULL;
+	}
+	op->actv_cnt++;
+
+	void *ptr = pmemobj_direct(oid);
+	op->obj[op->obj_cnt] = ptr;
+	op->obj_size[op->obj_cnt] = size;
+	op->obj_cnt++;
+
+	return ptr;
+}
+
+/*
+ * op_set -- (internal) sets the word when the operation is published
+ */
+static void
+op_set(struct op *op, uint64_t *ptr, uint64_t value)
+{
+	assert(op->actv_cnt < ACTIONS_MAX);
+
+	pmemobj_set_value(op->pop, &op->actv[op->actv_cnt++], ptr, value);
+}
+
+/*
+ * op_free -- (internal) frees the object when the operation is published
+ */
+static void
+op_free(struct op *op, PMEMoid oid)
+{
+	assert(op->actv_cnt < ACTIONS_MAX);
+
+	pmemobj_defer_free(op->pop, oid, &op->actv[op->actv_cnt++]);
+}
+
+/*
+ * op_retire -- (internal) puts the object unlinked by the operation on
+ * a garbage list when the operation is published
+ */
+static void
+op_retire(struct op *op, struct gc *obj)
+{
+	assert(op->retired_cnt < PATH_MAX_NODES + 1);
+
+	op->retired[op->retired_cnt++] = obj;
+}
+
+/*
+ * op_cancel -- (internal) cancels the reservations of the operation
+ */
+static void
+op_cancel(struct op *op)
+{
+	if (op->actv_cnt != 0)
+		pmemobj_cancel(op->pop, op->actv, op->actv_cnt);
+
+	op->actv_cnt = 0;
+	op->obj_cnt = 0;
+	op->retired_cnt = 0;
+}
+
+/*
+ * op_publish -- (internal) makes the changes of the operation visible and
+ * persistent at once
+ */
+static int
+op_publish(struct op *op)
+{
+	PMEMobjpool *pop = op->pop;
+
+	for (size_t i = 0; i < op->obj_cnt; ++i)
+		pmemobj_persist(pop, op->obj[i], op->obj_size[i]);
+
+	struct shard *s = NULL;
+	if (op->retired_cnt != 0) {
+		s = &op->map->garbage[epoch_index() & (GC_SHARDS - 1)];
+		shard_lock(pop, s);
+
+		/* the unlinked objects are read only by the writers */
+		uint64_t head = s->head;
+		for (unsigned i = 0; i < op->retired_cnt; ++i) {
+			struct gc *g = op->retired[i];
+			g->next = head;
+			pmemobj_persist(pop, &g->next, sizeof(g->next));
+			head = obj_off(pop, g);
+		}
+		op_set(op, &s->head, head);
+	}
+
+	int ret = pmemobj_publish(pop, op->actv, op->actv_cnt);
+
+	if (s != NULL) {
+		if (ret == 0) {
+			/* readers which started before may still see them */
+			uint64_t epoch = epoch_retire();
+			for (unsigned i = 0; i < op->retired_cnt; ++i) {
+				struct gc *g = op->retired[i];
+				g->epoch = epoch;
+				pmemobj_persist(pop, &g->epoch,
+					sizeof(g->epoch));
+			}
+
+			shard_collect(pop, s, 0);
+		}
+		shard_unlock(pop, s);
+	}
+
+	op->actv_cnt = 0;
+	op->obj_cnt = 0;
+	op->retired_cnt = 0;
+
+	return ret;
+}
+
+/*
+ * node_new -- (internal) reserves a node with the prefix
+ */
+static struct node *
+node_new(struct op *op, enum node_type type, const uint8_t *prefix,
+	size_t prefix_len)
+{
+	struct node *n = op_reserve(op, node_size[type], NODE_TYPE_NUM(type),
+		op->rt->node_flags[type]);
+	if (n == NULL)
+		return NULL;
+
+	n->path.type = (uint8_t)type;
+	n->path.prefix_len = (uint8_t)prefix_len;
+	memcpy(n->path.prefix, prefix, prefix_len);
+
+	return n;
+}
+
+/*
+ * node_grow -- (internal) reserves a node of the next bigger type with
+ * the prefix and the children of the full node
+ */
+static struct node *
+node_grow(struct op *op, struct node *n)
+{
+	struct node *g = node_new(op, (enum node_type)(n->path.type + 1),
+		n->path.prefix, n->path.prefix_len);
+	if (g == NULL)
+		return NULL;
+
+	g->leaf = n->leaf;
+
+	unsigned b;
+	uint64_t child;
+	for (unsigned from = 0; (child = node_next(n, from, &b)) != 0;
+			from = b + 1)
+		node_put(g, (uint8_t)b, child);
+
+	return g;
+}
+
+/*
+ * node_add -- (internal) adds the child to the locked node which isn't full
+ *
+ * A free slot is written in place and it's marked in use by the publish.
+ */
+static void
+node_add(struct op *op, struct node *n, uint8_t b, uint64_t child)
+{
+	PMEMobjpool *pop = op->pop;
+
+	switch (n->path.type) {
+	case NODE4:
+	case NODE16: {
+		struct node16 *n16 = (struct node16 *)n;
+		unsigned i = (unsigned)__builtin_ctzll(~n16->bitmap);
+		n16->key[i] = b;
+		n16->child[i] = child;
+		pmemobj_persist(pop, &n16->key[i], sizeof(n16->key[i]));
+		pmemobj_persist(pop, &n16->child[i], sizeof(n16->child[i]));
+		op_set(op, &n16->bitmap, n16->bitmap | (1ULL << i));
+		break;
+	}
+	case NODE48: {
+		struct node48 *n48 = (struct node48 *)n;
+		unsigned i = (unsigned)__builtin_ctzll(~n48->bitmap);
+		n48->child[i] = child;
+		pmemobj_persist(pop, &n48->child[i], sizeof(n48->child[i]));
+		op_set(op, &n48->index.word[b / sizeof(uint64_t)],
+			index_word(n48, b, (uint8_t)(i + 1)));
+		op_set(op, &n48->bitmap, n48->bitmap | (1ULL << i));
+		break;
+	}
+	default: {
+		struct node256 *n256 = (struct node256 *)n;
+		op_set(op, &n256->child[b], child);
+		op_set(op, &n256->count, n256->count + 1);
+		break;
+	}
+	}
+}
+
+/*
+ * node_del -- (internal) removes the child of the locked node
+ */
+static void
+node_del(struct op *op, struct node *n, uint8_t b)
+{
+	switch (n->path.type) {
+	case NODE4:
+	case NODE16: {
+		struct node16 *n16 = (struct node16 *)n;
+		unsigned i = (unsigned)__builtin_ctz(node16_match(n16, b));
+		op_set(op, &n16->bitmap, n16->bitmap & ~(1ULL << i));
+		break;
+	}
+	case NODE48: {
+		struct node48 *n48 = (struct node48 *)n;
+		unsigned i = n48->index.slot[b] - 1U;
+		op_set(op, &n48->index.word[b / sizeof(uint64_t)],
+			index_word(n48, b, 0));
+		op_set(op, &n48->bitmap, n48->bitmap & ~(1ULL << i));
+		break;
+	}
+	default: {
+		struct node256 *n256 = (struct node256 *)n;
+		op_set(op, &n256->child[b], 0);
+		op_set(op, &n256->count, n256->count - 1);
+		break;
+	}
+	}
+}
+
+/*
+ * leaf_new -- (internal) reserves a leaf with the key and the value
+ */
+static struct leaf *
+leaf_new(struct op *op, const uint8_t *key, size_t key_len, PMEMoid value)
+{
+	struct leaf *l = op_reserve(op, sizeof(*l) + key_len, LEAF_TYPE_NUM, 0);
+	if (l == NULL)
+		return NULL;
+
+	l->value = value;
+	l->key_len = key_len;
+	memcpy(l->key, key, key_len);
+
+	return l;
+}
+
+/*
+ * leaf_match -- (internal) checks whether the leaf holds the key
+ */
+static inline int
+leaf_match(const struct leaf *l, const uint8_t *key, size_t key_len)
+{
+	return l->key_len == key_len && memcmp(l->key, key, key_len) == 0;
+}
+
+/*
+ * node_chain -- (internal) reserves the nodes holding two leaves with
+ * the keys equal up to the depth, returns the offset of the topmost one or 0
+ * if the reservation failed
+ */
+static uint64_t
+node_chain(struct op *op, const struct leaf *l1, uint64_t off1,
+	const struct leaf *l2, uint64_t off2, size_t depth)
+{
+	size_t c = 0;
+	while (depth + c < l1->key_len && depth + c < l2->key_len &&
+			l1->key[depth + c] == l2->key[depth + c])
+		++c;
+
+	size_t prefix_len = c > MAX_PREFIX ? MAX_PREFIX : c;
+	struct node *n = node_new(op, NODE4, &l1->key[depth], prefix_len);
+	if (n == NULL)
+		return 0;
+
+	size_t d = depth + prefix_len;
+	if (c > MAX_PREFIX) {
+		/* the keys are still equal at the next byte */
+		uint64_t child = node_chain(op, l1, off1, l2, off2, d + 1);
+		if (child == 0)
+			return 0;
+		node_put(n, l1->key[d], child);
+	} else {
+		const struct leaf *l[2] = {l1, l2};
+		uint64_t off[2] = {off1, off2};
+		for (int i = 0; i < 2; ++i) {
+			if (l[i]->key_len == d)
+				n->leaf = off[i] & ~LEAF_TAG;
+			else
+				node_put(n, l[i]->key[d], off[i]);
+		}
+	}
+
+	return obj_off(op->pop, n);
+}
+
+/*
+ * node_split -- (internal) inserts a node with the part of the prefix of
+ * the locked node matching the key, with the node and the leaf as its
+ * children, the parent of the node has to be locked too
+ */
+static int
+node_split(struct op *op, struct node *n, uint64_t *parent_slot,
+	const struct leaf *l, size_t depth, size_t matched)
+{
+	struct node *m = node_new(op, NODE4, n->path.prefix, matched);
+	if (m == NULL)
+		return -1;
+
+	uint64_t leaf_off = obj_off(op->pop, l);
+	if (l->key_len == depth + matched)
+		m->leaf = leaf_off;
+	else
+		node_put(m, l->key[depth + matched], leaf_off | LEAF_TAG);
+	node_put(m, n->path.prefix[matched], obj_off(op->pop, n));
+
+	/* the rest of the prefix, after the byte of the node in the new one */
+	union node_path path;
+	memset(&path, 0, sizeof(path));
+	path.type = n->path.type;
+	path.prefix_len = (uint8_t)(n->path.prefix_len - matched - 1);
+	memcpy(path.prefix, &n->path.prefix[matched + 1], path.prefix_len);
+
+	for (int i = 0; i < 3; ++i)
+		op_set(op, &n->path.word[i], path.word[i]);
+	op_set(op, parent_slot, obj_off(op->pop, m));
+
+	return op_publish(op);
+}
+
+/*
+ * counter_add -- (internal) adds the value to the number of entries
+ */
+static inline void
+counter_add(struct runtime *rt, int64_t value)
+{
+	__atomic_fetch_add(&rt->count[epoch_index() & (COUNTERS_NUM - 1)].value,
+		value, __ATOMIC_RELAXED);
+}
+
+/*
+ * runtime_count -- (internal) returns the number of entries
+ */
+static size_t
+runtime_count(struct runtime *rt)
+{
+	int64_t count = 0;
+	for (size_t i = 0; i < COUNTERS_NUM; ++i)
+		count += __atomic_load_n(&rt->count[i].value,
+			__ATOMIC_RELAXED);
+
+	/* the counters are not read atomically as a whole */
+	return count < 0 ? 0 : (size_t)count;
+}
+
+/*
+ * node_class_register -- (internal) creates the allocation class of the nodes
+ * of the type, returns the flags of their allocation
+ */
+static uint64_t
+node_class_register(PMEMobjpool *pop, enum node_type type)
+{
+	size_t unit_size = (node_size[type] + CACHELINE_SIZE - 1) &
+		~((size_t)CACHELINE_SIZE - 1);
+
+	struct pobj_alloc_class_desc desc;
+	desc.unit_size = unit_size;
+	desc.alignment = CACHELINE_SIZE;
+	desc.units_per_block = (unsigned)(NODE_BLOCK_SIZE / unit_size);
+	desc.header_type = POBJ_HEADER_NONE;
+
+	/* the nodes are allocated from the default classes if it fails */
+	if (pmemobj_ctl_set(pop, "heap.alloc_class.new.desc", &desc) != 0)
+		return 0;
+
+	return POBJ_CLASS_ID(desc.class_id);
+}
+
+/*
+ * node_leaves -- (internal) returns the number of the leaves under the node
+ */
+static size_t
+node_leaves(PMEMobjpool *pop, struct node *n)
+{
+	size_t count = n->leaf != 0;
+
+	unsigned b;
+	uint64_t child;
+	for (unsigned from = 0; (child = node_next(n, from, &b)) != 0;
+			from = b + 1) {
+		if (child & LEAF_TAG)
+			count++;
+		else
+			count += node_leaves(pop, obj_get(pop, child));
+	}
+
+	return count;
+}
+
+struct runtime_args {
+	PMEMobjpool *pop;
+	struct art_map *map;
+};
+
+/*
+ * runtime_construct -- (internal) recovers the map after the pool is opened,
+ * before any operation is performed on it
+ */
+static int
+runtime_construct(void *ptr, void *arg)
+{
+	struct runtime *rt = ptr;
+	struct runtime_args *args = arg;
+	PMEMobjpool *pop = args->pop;
+	struct art_map *map = args->map;
+
+	memset(rt, 0, sizeof(*rt));
+
+	for (int t = 0; t < MAX_NODE_TYPE; ++t)
+		rt->node_flags[t] = node_class_register(pop, (enum node_type)t);
+
+	/* nobody can see the unlinked objects anymore */
+	for (int i = 0; i < GC_SHARDS; ++i) {
+		while (map->garbage[i].head != 0)
+			shard_collect(pop, &map->garbage[i], 1);
+	}
+
+	rt->count[0].value =
+		(int64_t)node_leaves(pop, obj_get(pop, map->root));
+
+	return 0;
+}
+
+/*
+ * runtime_get -- (internal) returns the volatile state of the map
+ */
+static struct runtime *
+runtime_get(PMEMobjpool *pop, struct art_map *map)
+{
+	struct runtime_args args = {pop, map};
+
+	return pmemobj_volatile(pop, &map->runtime.vlt,
+		&map->runtime.value, sizeof(map->runtime.value),
+		runtime_construct, &args);
+}
+
+/*
+ * tree_insert -- (internal) inserts the leaf reserved by the operation,
+ * returns 1 if the key already exists, the operation is canceled then
+ */
+static int
+tree_insert(struct op *op, const struct leaf *l)
+{
+	PMEMobjpool *pop = op->pop;
+	const uint8_t *key = l->key;
+	size_t key_len = l->key_len;
+	uint64_t leaf_off = obj_off(pop, l);
+	struct node *root = obj_get(pop, op->map->root);
+	int ret;
+
+	epoch_enter();
+
+restart:;
+	uint64_t *pver = NULL;
+	uint64_t pv = 0;
+	uint64_t *parent_slot = NULL;
+
+	struct node *n = root;
+	uint64_t *ver = node_version(pop, n);
+	uint64_t v = node_read_lock(ver);
+	size_t depth = 0;
+
+	for (;;) {
+		size_t prefix_len = node_prefix_len(n);
+		size_t matched = prefix_match(n, prefix_len, key, key_len,
+			depth);
+		if (!node_read_check(ver, v))
+			goto restart;
+
+		if (matched < prefix_len) {
+			/* the root has no prefix, so there is a parent */
+			if (!node_upgrade(pver, pv))
+				goto restart;
+			if (!node_upgrade(ver, v)) {
+				node_unlock(pver);
+				goto restart;
+			}
+
+			ret = node_split(op, n, parent_slot, l, depth,
+				matched);
+
+			node_unlock(ver);
+			node_unlock(pver);
+			break;
+		}
+		depth += prefix_len;
+
+		if (depth == key_len) {
+			if (!node_upgrade(ver, v))
+				goto restart;
+
+			if (n->leaf != 0) {
+				ret = 1;
+			} else {
+				op_set(op, &n->leaf, leaf_off);
+				ret = op_publish(op);
+			}
+
+			node_unlock(ver);
+			break;
+		}
+
+		uint8_t b = key[depth];
+		uint64_t *slot;
+		uint64_t child = node_find(n, b, &slot);
+		int full = node_full(n);
+		if (!node_read_check(ver, v))
+			goto restart;
+
+		if (child == 0 && !full) {
+			if (!node_upgrade(ver, v))
+				goto restart;
+
+			node_add(op, n, b, leaf_off | LEAF_TAG);
+			ret = op_publish(op);
+
+			node_unlock(ver);
+			break;
+		}
+
+		if (child == 0) {
+			/* the root is never full */
+			if (!node_upgrade(pver, pv))
+				goto restart;
+			if (!node_upgrade(ver, v)) {
+				node_unlock(pver);
+				goto restart;
+			}
+
+			ret = -1;
+			struct node *g = node_grow(op, n);
+			if (g != NULL) {
+				node_put(g, b, leaf_off | LEAF_TAG);
+				op_set(op, parent_slot, obj_off(pop, g));
+				op_retire(op, &n->gc);
+				ret = op_publish(op);
+			}
+
+			if (ret == 0)
+				node_unlock_obsolete(ver);
+			else
+				node_unlock(ver);
+			node_unlock(pver);
+			break;
+		}
+
+		if (child & LEAF_TAG) {
+			struct leaf *old = obj_get(pop, child);
+			if (leaf_match(old, key, key_len)) {
+				ret = 1;
+				break;
+			}
+
+			if (!node_upgrade(ver, v))
+				goto restart;
+
+			/* both of the keys go to a new node */
+			ret = -1;
+			uint64_t off = node_chain(op, old, child, l,
+				leaf_off | LEAF_TAG, depth + 1);
+			if (off != 0) {
+				op_set(op, slot, off);
+				ret = op_publish(op);
+			}
+
+			node_unlock(ver);
+			break;
+		}
+
+		pver = ver;
+		pv = v;
+		parent_slot = slot;
+
+		n = obj_get(pop, child);
+		ver = node_version(pop, n);
+		v = node_read_lock(ver);
+		if ((v & VERSION_OBSOLETE) || !node_read_check(pver, pv))
+			goto restart;
+		depth++;
+	}
+
+	if (ret == 0)
+		counter_add(op->rt, 1);
+	else
+		op_cancel(op);
+
+	epoch_exit();
+
+	return ret;
+}
+
+/*
+ * tree_remove -- (internal) removes the key, returns the leaf which held it,
+ * which may be accessed until the end of the epoch, NULL if there was none
+ *
+ * The nodes which would be left empty are unlinked together with the leaf,
+ * they are locked from the top down to the node of the leaf.
+ */
+static struct leaf *
+tree_remove(struct op *op, const uint8_t *key, size_t key_len, int free_value)
+{
+	PMEMobjpool *pop = op->pop;
+	struct node *root = obj_get(pop, op->map->root);
+	struct leaf *ret = NULL;
+
+	/* the node which stays and the nodes with a single child below it */
+	struct level anchor = {NULL, NULL, 0, 0};
+	struct level *run = op->run;
+	unsigned nrun;
+
+restart:
+	nrun = 0;
+
+	struct node *n = root;
+	uint64_t *ver = node_version(pop, n);
+	uint64_t v = node_read_lock(ver);
+	size_t depth = 0;
+
+	for (;;) {
+		size_t prefix_len = node_prefix_len(n);
+		size_t matched = prefix_match(n, prefix_len, key, key_len,
+			depth);
+		if (!node_read_check(ver, v))
+			goto restart;
+		if (matched < prefix_len)
+			break;
+		depth += prefix_len;
+
+		struct leaf *l;
+		uint64_t *slot = NULL;
+		int last;
+		if (depth == key_len) {
+			uint64_t off = __atomic_load_n(&n->leaf,
+				__ATOMIC_ACQUIRE);
+			last = n != root && node_count(n) == 0;
+			if (!node_read_check(ver, v))
+				goto restart;
+			if (off == 0)
+				break;
+			l = obj_get(pop, off);
+		} else {
+			uint8_t b = key[depth];
+			uint64_t child = node_find(n, b, &slot);
+			uint64_t leaf = __atomic_load_n(&n->leaf,
+				__ATOMIC_ACQUIRE);
+			last = n != root && node_count(n) == 1 && leaf == 0;
+			if (!node_read_check(ver, v))
+				goto restart;
+			if (child == 0)
+				break;
+
+			if ((child & LEAF_TAG) == 0) {
+				struct level lv = {n, ver, v, b};
+				if (last) {
+					run[nrun++] = lv;
+				} else {
+					anchor = lv;
+					nrun = 0;
+				}
+
+				struct node *next = obj_get(pop, child);
+				uint64_t *next_ver = node_version(pop, next);
+				uint64_t next_v = node_read_lock(next_ver);
+				if ((next_v & VERSION_OBSOLETE) ||
+						!node_read_check(ver, v))
+					goto restart;
+
+				n = next;
+				ver = next_ver;
+				v = next_v;
+				depth++;
+				continue;
+			}
+
+			l = obj_get(pop, child);
+			if (!leaf_match(l, key, key_len))
+				break;
+		}
+
+		struct level lv = {n, ver, v, 0};
+		if (last)
+			run[nrun++] = lv;
+		else
+			nrun = 0;
+
+		/* the anchor and the nodes to unlink or the node of the leaf */
+		unsigned locked = 0;
+		if (last && !node_upgrade(anchor.ver, anchor.v))
+			goto restart;
+		for (; locked < nrun; ++locked) {
+			if (!node_upgrade(run[locked].ver, run[locked].v))
+				break;
+		}
+		if (!last && !node_upgrade(ver, v))
+			goto restart;
+		if (locked < nrun) {
+			node_unlock(anchor.ver);
+			while (locked-- > 0)
+				node_unlock(run[locked].ver);
+			goto restart;
+		}
+
+		if (last) {
+			node_del(op, anchor.n, anchor.byte);
+			for (unsigned i = 0; i < nrun; ++i)
+				op_retire(op, &run[i].n->gc);
+		} else if (slot == NULL) {
+			op_set(op, &n->leaf, 0);
+		} else {
+			node_del(op, n, key[depth]);
+		}
+		op_retire(op, &l->gc);
+
+		if (free_value && !OID_IS_NULL(l->value))
+			op_free(op, l->value);
+
+		int err = op_publish(op);
+		if (err == 0) {
+			counter_add(op->rt, -1);
+			ret = l;
+		}
+
+		if (last) {
+			for (unsigned i = 0; i < nrun; ++i) {
+				if (err == 0)
+					node_unlock_obsolete(run[i].ver);
+				else
+					node_unlock(run[i].ver);
+			}
+			node_unlock(anchor.ver);
+		} else {
+			node_unlock(ver);
+		}
+		break;
+	}
+
+	op_cancel(op);
+
+	return ret;
+}
+
+/*
+ * tree_find -- (internal) returns the leaf with the key, NULL if there is
+ * none, must be called in an epoch
+ */
+static struct leaf *
+tree_find(PMEMobjpool *pop, struct art_map *map, const uint8_t *key,
+	size_t key_len)
+{
+	struct node *root = obj_get(pop, map->root);
+
+restart:;
+	struct node *n = root;
+	uint64_t *ver = node_version(pop, n);
+	uint64_t v = node_read_lock(ver);
+	size_t depth = 0;
+
+	for (;;) {
+		size_t prefix_len = node_prefix_len(n);
+		size_t matched = prefix_match(n, prefix_len, key, key_len,
+			depth);
+		if (!node_read_check(ver, v))
+			goto restart;
+		if (matched < prefix_len)
+			return NULL;
+		depth += prefix_len;
+
+		if (depth == key_len) {
+			uint64_t off = __atomic_load_n(&n->leaf,
+				__ATOMIC_ACQUIRE);
+			if (!node_read_check(ver, v))
+				goto restart;
+			return off == 0 ? NULL : obj_get(pop, off);
+		}
+
+		uint64_t *slot;
+		uint64_t child = node_find(n, key[depth], &slot);
+		if (!node_read_check(ver, v))
+			goto restart;
+		if (child == 0)
+			return NULL;
+
+		if (child & LEAF_TAG) {
+			struct leaf *l = obj_get(pop, child);
+			return leaf_match(l, key, key_len) ? l : NULL;
+		}
+
+		struct node *next = obj_get(pop, child);
+		uint64_t *next_ver = node_version(pop, next);
+		uint64_t next_v = node_read_lock(next_ver);
+		if ((next_v & VERSION_OBSOLETE) || !node_read_check(ver, v))
+			goto restart;
+
+		n = next;
+		ver = next_ver;
+		v = next_v;
+		depth++;
+	}
+}
+
+/* state of a range scan */
+struct scan {
+	PMEMobjpool *pop;
+	const uint8_t *start;
+	size_t start_len;
+	/* NULL if there is no upper bound */
+	const uint8_t *end;
+	size_t end_len;
+
+	int (*cb)(const void *key, size_t key_len, PMEMoid value, void *arg);
+	void *arg;
+	/* the value returned by the callback which stopped the scan */
+	int ret;
+
+	/* bytes of the keys on the path to the current node */
+	uint8_t path[ART_MAP_MAX_KEY_LEN + MAX_PREFIX];
+};
+
+/*
+ * key_cmp -- (internal) compares two strings of bytes
+ */
+static int
+key_cmp(const uint8_t *k1, size_t len1, const uint8_t *k2, size_t len2)
+{
+	int cmp = memcmp(k1, k2, len1 < len2 ? len1 : len2);
+	if (cmp != 0)
+		return cmp;
+
+	return len1 < len2 ? -1 : len1 > len2;
+}
+
+/*
+ * scan_leaf -- (internal) calls the callback for the leaf within the range,
+ * returns non-zero when the scan is over
+ */
+static int
+scan_leaf(struct scan *s, const struct leaf *l)
+{
+	if (key_cmp(l->key, l->key_len, s->start, s->start_len) < 0)
+		return 0;
+	if (s->end != NULL &&
+			key_cmp(l->key, l->key_len, s->end, s->end_len) > 0)
+		return 1;
+
+	s->ret = s->cb(l->key, l->key_len, l->value, s->arg);
+
+	return s->ret;
+}
+
+/*
+ * scan_node -- (internal) visits the leaves under the node in the order of
+ * their keys, returns non-zero when the scan is over
+ *
+ * The obsolete nodes are not modified anymore, so they are visited too. The
+ * keys inserted or removed in the meantime may or may not be visited.
+ */
+static int
+scan_node(struct scan *s, struct node *n, size_t depth)
+{
+	PMEMobjpool *pop = s->pop;
+	uint64_t *ver = node_version(pop, n);
+	uint64_t v;
+	size_t prefix_len;
+	uint64_t leaf;
+
+	do {
+		v = node_read_lock(ver);
+		prefix_len = node_prefix_len(n);
+		memcpy(&s->path[depth], n->path.prefix, prefix_len);
+		leaf = __atomic_load_n(&n->leaf, __ATOMIC_ACQUIRE);
+	} while (!node_read_check(ver, v));
+
+	depth += prefix_len;
+
+	/* all of the keys under the node are lower than the start key */
+	size_t len = depth < s->start_len ? depth : s->start_len;
+	int cmp = memcmp(s->path, s->start, len);
+	if (cmp < 0)
+		return 0;
+
+	/* ... or higher than the end key */
+	if (s->end != NULL && key_cmp(s->path, depth, s->end, s->end_len) > 0)
+		return 1;
+
+	if (leaf != 0 && scan_leaf(s, obj_get(pop, leaf)))
+		return 1;
+
+	/* the children with lower bytes are skipped */
+	unsigned from = 0;
+	if (cmp == 0 && s->start_len > depth)
+		from = s->start[depth];
+
+	for (;;) {
+		unsigned b;
+		uint64_t child;
+		do {
+			v = node_read_lock(ver);
+			child = node_next(n, from, &b);
+		} while (!node_read_check(ver, v));
+
+		if (child == 0)
+			return 0;
+
+		int ret;
+		if (child & LEAF_TAG) {
+			ret = scan_leaf(s, obj_get(pop, child));
+		} else if (depth < ART_MAP_MAX_KEY_LEN) {
+			s->path[depth] = (uint8_t)b;
+			ret = scan_node(s, obj_get(pop, child), depth + 1);
+		} else {
+			ret = 0;
+		}
+
+		if (ret)
+			return ret;
+		from = b + 1;
+	}
+}
+
+/*
+ * tree_scan -- (internal) calls the callback for the keys from the start key
+ * up to the end key, in their order
+ */
+static int
+tree_scan(PMEMobjpool *pop, struct art_map *map, const uint8_t *start,
+	size_t start_len, const uint8_t *end, size_t end_len,
+	int (*cb)(const void *key, size_t key_len, PMEMoid value, void *arg),
+	void *arg)
+{
+	struct scan *s = malloc(sizeof(*s));
+	if (s == NULL)
+		return -1;
+
+	s->pop = pop;
+	s->start = start != NULL ? start : (const uint8_t *)"";
+	s->start_len = start_len;
+	s->end = end;
+	s->end_len = end_len;
+	s->cb = cb;
+	s->arg = arg;
+	s->ret = 0;
+
+	epoch_enter();
+	scan_node(s, obj_get(pop, map->root), 0);
+	epoch_exit();
+
+	int ret = s->ret;
+	free(s);
+
+	return ret;
+}
+
+/*
+ * node_free -- (internal) frees the node and everything under it, called in
+ * a transaction
+ */
+static void
+node_free(PMEMobjpool *pop, struct node *n)
+{
+	if (n->leaf != 0)
+		pmemobj_tx_free(pmemobj_oid(obj_get(pop, n->leaf)));
+
+	unsigned b;
+	uint64_t child;
+	for (unsigned from = 0; (child = node_next(n, from, &b)) != 0;
+			from = b + 1) {
+		if (child & LEAF_TAG)
+			pmemobj_tx_free(pmemobj_oid(obj_get(pop, child)));
+		else
+			node_free(pop, obj_get(pop, child));
+	}
+
+	pmemobj_tx_free(pmemobj_oid(n));
+}
+
+/*
+ * key_encode -- (internal) stores the integer key as big-endian bytes, which
+ * are sorted in the same order as the keys
+ */
+static inline void
+key_encode(uint64_t key, uint8_t buf[KEY64_LEN])
+{
+	for (int i = 0; i < KEY64_LEN; ++i)
+		buf[i] = (uint8_t)(key >> (8 * (KEY64_LEN - 1 - i)));
+}
+
+/*
+ * key_decode -- (internal) returns the integer key stored as bytes
+ */
+static inline uint64_t
+key_decode(const uint8_t *buf)
+{
+	uint64_t key = 0;
+	for (int i = 0; i < KEY64_LEN; ++i)
+		key = (key << 8) | buf[i];
+
+	return key;
+}
+
+struct key64_cb {
+	int (*cb)(uint64_t key, PMEMoid value, void *arg);
+	void *arg;
+};
+
+/*
+ * key64_call -- (internal) calls the callback of the integer keys
+ */
+static int
+key64_call(const void *key, size_t key_len, PMEMoid value, void *arg)
+{
+	struct key64_cb *c = arg;
+
+	if (key_len != KEY64_LEN)
+		return 0;
+
+	return c->cb(key_decode(key), value, c->arg);
+}
+
+/*
+ * art_map_check -- checks if specified persistent object is an instance of
+ * art map
+ */
+int
+art_map_check(PMEMobjpool *pop, TOID(struct art_map) map)
+{
+	return TOID_IS_NULL(map) || !TOID_VALID(map);
+}
+
+/*
+ * art_map_create -- allocates a new art map instance
+ */
+int
+art_map_create(PMEMobjpool *pop, TOID(struct art_map) *map, void *arg)
+{
+	struct pobj_action actv[4];
+	size_t actv_cnt = 0;
+
+	TOID(struct art_map) m =
+		POBJ_RESERVE_NEW(pop, struct art_map, &actv[actv_cnt]);
+	if (TOID_IS_NULL(m))
+		goto reserve_err;
+	actv_cnt++;
+
+	PMEMoid root = pmemobj_xreserve(pop, &actv[actv_cnt],
+		sizeof(struct node256), NODE_TYPE_NUM(NODE256),
+		POBJ_XALLOC_ZERO);
+	if (OID_IS_NULL(root))
+		goto reserve_err;
+	actv_cnt++;
+
+	struct node *r = pmemobj_direct(root);
+	r->path.type = NODE256;
+	pmemobj_persist(pop, r, sizeof(struct node256));
+
+	struct art_map *a = D_RW(m);
+	memset(a, 0, sizeof(*a));
+	a->root = root.off;
+	pmemobj_persist(pop, a, sizeof(*a));
+
+	pmemobj_set_value(pop, &actv[actv_cnt++], &map->oid.pool_uuid_lo,
+		m.oid.pool_uuid_lo);
+	pmemobj_set_value(pop, &actv[actv_cnt++], &map->oid.off, m.oid.off);
+
+	return pmemobj_publish(pop, actv, actv_cnt);
+
+reserve_err:
+	fprintf(stderr, "art_map alloc failed: %s\n", pmemobj_errormsg());
+	pmemobj_cancel(pop, actv, actv_cnt);
+	return -1;
+}
+
+/*
+ * art_map_destroy -- cleanups and frees art map instance, must not be called
+ * concurrently with the other operations
+ */
+int
+art_map_destroy(PMEMobjpool *pop, TOID(struct art_map) *map)
+{
+	struct art_map *m = D_RW(*map);
+	if (runtime_get(pop, m) == NULL)
+		return 1;
+
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		for (int i = 0; i < GC_SHARDS; ++i) {
+			for (struct gc *g = gc_get(pop, m->garbage[i].head);
+					g != NULL; g = gc_get(pop, g->next))
+				pmemobj_tx_free(pmemobj_oid(g));
+		}
+
+		node_free(pop, obj_get(pop, m->root));
+
+		pmemobj_tx_add_range_direct(map, sizeof(*map));
+		TX_FREE(*map);
+		*map = TOID_NULL(struct art_map);
+	} TX_ONABORT {
+		ret = 1;
+	} TX_END
+
+	return ret;
+}
+
+/*
+ * art_map_init -- recovers the map state, called after pmemobj_open
+ */
+int
+art_map_init(PMEMobjpool *pop, TOID(struct art_map) map)
+{
+	return runtime_get(pop, D_RW(map)) == NULL ? -1 : 0;
+}
+
+/*
+ * art_map_insert_bytes -- inserts a new key-value pair into the map,
+ * returns:
+ * - 0 if successful,
+ * - 1 if the key already existed,
+ * - -1 if something bad happened
+ */
+int
+art_map_insert_bytes(PMEMobjpool *pop, TOID(struct art_map) map,
+	const void *key, size_t key_len, PMEMoid value)
+{
+	if (key_len > ART_MAP_MAX_KEY_LEN) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	struct art_map *m = D_RW(map);
+	struct runtime *rt = runtime_get(pop, m);
+	if (rt == NULL)
+		return -1;
+
+	struct op *op = malloc(sizeof(*op));
+	if (op == NULL)
+		return -1;
+	op_init(op, pop, m, rt);
+
+	int ret = -1;
+	struct leaf *l = leaf_new(op, key, key_len, value);
+	if (l != NULL)
+		ret = tree_insert(op, l);
+
+	free(op);
+
+	return ret;
+}
+
+/*
+ * art_map_insert -- inserts a new key-value pair into the map
+ */
+int
+art_map_insert(PMEMobjpool *pop, TOID(struct art_map) map,
+	uint64_t key, PMEMoid value)
+{
+	uint8_t buf[KEY64_LEN];
+	key_encode(key, buf);
+
+	return art_map_insert_bytes(pop, map, buf, sizeof(buf), value);
+}
+
+/*
+ * art_map_insert_new -- allocates a new object and inserts it into the map,
+ * the object is published together with the key
+ */
+int
+art_map_insert_new(PMEMobjpool *pop, TOID(struct art_map) map,
+		uint64_t key, size_t size, unsigned type_num,
+		void (*constructor)(PMEMobjpool *pop, void *ptr, void *arg),
+		void *arg)
+{
+	struct art_map *m = D_RW(map);
+	struct runtime *rt = runtime_get(pop, m);
+	if (rt == NULL)
+		return -1;
+
+	struct op *op = malloc(sizeof(*op));
+	if (op == NULL)
+		return -1;
+	op_init(op, pop, m, rt);
+
+	uint8_t buf[KEY64_LEN];
+	key_encode(key, buf);
+
+	int ret = -1;
+	void *value = op_reserve(op, size, type_num, 0);
+	if (value != NULL) {
+		constructor(pop, value, arg);
+
+		struct leaf *l = leaf_new(op, buf, sizeof(buf),
+			pmemobj_oid(value));
+		if (l != NULL)
+			ret = tree_insert(op, l);
+	}
+
+	if (ret < 0)
+		op_cancel(op);
+	free(op);
+
+	return ret;
+}
+
+/*
+ * map_remove -- (internal) removes the key from the map, returns its value
+ */
+static PMEMoid
+map_remove(PMEMobjpool *pop, TOID(struct art_map) map, const void *key,
+	size_t key_len, int free_value)
+{
+	struct art_map *m = D_RW(map);
+	struct runtime *rt = runtime_get(pop, m);
+	if (rt == NULL)
+		return OID_NULL;
+
+	struct op *op = malloc(sizeof(*op));
+	if (op == NULL)
+		return OID_NULL;
+	op_init(op, pop, m, rt);
+
+	PMEMoid ret = OID_NULL;
+
+	epoch_enter();
+
+	struct leaf *l = tree_remove(op, key, key_len, free_value);
+	if (l != NULL)
+		ret = l->value;
+
+	epoch_exit();
+
+	free(op);
+
+	return ret;
+}
+
+/*
+ * art_map_remove_bytes -- removes the key from the map,
+ * returns:
+ * - key's value if successful,
+ * - OID_NULL if the key didn't exist or if something bad happened
+ */
+PMEMoid
+art_map_remove_bytes(PMEMobjpool *pop, TOID(struct art_map) map,
+	const void *key, size_t key_len)
+{
+	return map_remove(pop, map, key, key_len, 0);
+}
+
+/*
+ * art_map_remove -- removes the key from the map
+ */
+PMEMoid
+art_map_remove(PMEMobjpool *pop, TOID(struct art_map) map, uint64_t key)
+{
+	uint8_t buf[KEY64_LEN];
+	key_encode(key, buf);
+
+	return map_remove(pop, map, buf, sizeof(buf), 0);
+}
+
+/*
+ * art_map_remove_free -- removes the key from the map and frees its value
+ * by the same publish, the readers must not use the value of a key which may
+ * be removed concurrently
+ */
+int
+art_map_remove_free(PMEMobjpool *pop, TOID(struct art_map) map,
+		uint64_t key)
+{
+	uint8_t buf[KEY64_LEN];
+	key_encode(key, buf);
+
+	map_remove(pop, map, buf, sizeof(buf), 1);
+
+	return 0;
+}
+
+/*
+ * clear_key -- (internal) scan callback removing the key
+ */
+static int
+clear_key(const void *key, size_t key_len, PMEMoid value, void *arg)
+{
+	struct op *op = arg;
+
+	tree_remove(op, key, key_len, 0);
+
+	return 0;
+}
+
+/*
+ * art_map_clear -- removes all of the keys from the map, the keys inserted
+ * in the meantime may or may not be removed
+ */
+int
+art_map_clear(PMEMobjpool *pop, TOID(struct art_map) map)
+{
+	struct art_map *m = D_RW(map);
+	struct runtime *rt = runtime_get(pop, m);
+	if (rt == NULL)
+		return -1;
+
+	struct op *op = malloc(sizeof(*op));
+	if (op == NULL)
+		return -1;
+	op_init(op, pop, m, rt);
+
+	int ret = tree_scan(pop, m, NULL, 0, NULL, 0, clear_key, op);
+
+	free(op);
+
+	return ret;
+}
+
+/*
+ * art_map_get_bytes -- searches for the value of the key
+ */
+PMEMoid
+art_map_get_bytes(PMEMobjpool *pop, TOID(struct art_map) map,
+	const void *key, size_t key_len)
+{
+	PMEMoid ret = OID_NULL;
+
+	epoch_enter();
+
+	struct leaf *l = tree_find(pop, D_RW(map), key, key_len);
+	if (l != NULL)
+		ret = l->value;
+
+	epoch_exit();
+
+	return ret;
+}
+
+/*
+ * art_map_get -- searches for the value of the key
+ */
+PMEMoid
+art_map_get(PMEMobjpool *pop, TOID(struct art_map) map, uint64_t key)
+{
+	uint8_t buf[KEY64_LEN];
+	key_encode(key, buf);
+
+	return art_map_get_bytes(pop, map, buf, sizeof(buf));
+}
+
+/*
+ * art_map_lookup -- searches if the key exists
+ */
+int
+art_map_lookup(PMEMobjpool *pop, TOID(struct art_map) map, uint64_t key)
+{
+	uint8_t buf[KEY64_LEN];
+	key_encode(key, buf);
+
+	epoch_enter();
+
+	int ret = tree_find(pop, D_RW(map), buf, sizeof(buf)) != NULL;
+
+	epoch_exit();
+
+	return ret;
+}
+
+/*
+ * art_map_range_bytes -- calls the callback for the keys from the start key
+ * up to the end key, inclusive, in their order, there is no upper bound if
+ * the end key is NULL, the keys inserted or removed in the meantime may or
+ * may not be visited
+ */
+int
+art_map_range_bytes(PMEMobjpool *pop, TOID(struct art_map) map,
+	const void *start, size_t start_len, const void *end, size_t end_len,
+	int (*cb)(const void *key, size_t key_len, PMEMoid value, void *arg),
+	void *arg)
+{
+	return tree_scan(pop, D_RW(map), start, start_len, end, end_len,
+		cb, arg);
+}
+
+/*
+ * art_map_range -- calls the callback for the keys from the start key up to
+ * the end key, inclusive, in their order
+ */
+int
+art_map_range(PMEMobjpool *pop, TOID(struct art_map) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	uint8_t sbuf[KEY64_LEN];
+	uint8_t ebuf[KEY64_LEN];
+	key_encode(start, sbuf);
+	key_encode(end, ebuf);
+
+	struct key64_cb c = {cb, arg};
+
+	return tree_scan(pop, D_RW(map), sbuf, sizeof(sbuf), ebuf,
+		sizeof(ebuf), key64_call, &c);
+}
+
+/*
+ * art_map_foreach -- calls the callback for all of the keys in their order
+ */
+int
+art_map_foreach(PMEMobjpool *pop, TOID(struct art_map) map,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	struct key64_cb c = {cb, arg};
+
+	return tree_scan(pop, D_RW(map), NULL, 0, NULL, 0, key64_call, &c);
+}
+
+/*
+ * art_map_is_empty -- checks whether the map is empty
+ */
+int
+art_map_is_empty(PMEMobjpool *pop, TOID(struct art_map) map)
+{
+	struct node256 *root = obj_get(pop, D_RO(map)->root);
+
+	return __atomic_load_n(&root->count, __ATOMIC_ACQUIRE) == 0 &&
+		__atomic_load_n(&root->n.leaf, __ATOMIC_ACQUIRE) == 0;
+}
+
+/*
+ * art_map_count -- returns the number of entries
+ */
+size_t
+art_map_count(PMEMobjpool *pop, TOID(struct art_map) map)
+{
+	struct runtime *rt = runtime_get(pop, D_RW(map));
+	if (rt == NULL)
+		return 0;
+
+	return runtime_count(rt);
+}
@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * art_map.h -- TreeMap sorted collection implementation
+ */
+
+#ifndef ART_MAP_H
+#define ART_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <libpmemobj.h>
+
+#ifndef ART_MAP_TYPE_OFFSET
+#define ART_MAP_TYPE_OFFSET 1040
+#endif
+
+/* the maximum length of a key */
+#define ART_MAP_MAX_KEY_LEN 1024
+
+struct art_map;
+TOID_DECLARE(struct art_map, ART_MAP_TYPE_OFFSET + 0);
+
+int art_map_check(PMEMobjpool *pop, TOID(struct art_map) map);
+int art_map_create(PMEMobjpool *pop, TOID(struct art_map) *map, void *arg);
+int art_map_destroy(PMEMobjpool *pop, TOID(struct art_map) *map);
+int art_map_init(PMEMobjpool *pop, TOID(struct art_map) map);
+int art_map_insert(PMEMobjpool *pop, TOID(struct art_map) map,
+	uint64_t key, PMEMoid value);
+int art_map_insert_new(PMEMobjpool *pop, TOID(struct art_map) map,
+		uint64_t key, size_t size, unsigned type_num,
+		void (*constructor)(PMEMobjpool *pop, void *ptr, void *arg),
+		void *arg);
+PMEMoid art_map_remove(PMEMobjpool *pop, TOID(struct art_map) map,
+		uint64_t key);
+int art_map_remove_free(PMEMobjpool *pop, TOID(struct art_map) map,
+		uint64_t key);
+int art_map_clear(PMEMobjpool *pop, TOID(struct art_map) map);
+PMEMoid art_map_get(PMEMobjpool *pop, TOID(struct art_map) map,
+		uint64_t key);
+int art_map_lookup(PMEMobjpool *pop, TOID(struct art_map) map,
+		uint64_t key);
+int art_map_foreach(PMEMobjpool *pop, TOID(struct art_map) map,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
+int art_map_range(PMEMobjpool *pop, TOID(struct art_map) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
+int art_map_is_empty(PMEMobjpool *pop, TOID(struct art_map) map);
+size_t art_map_count(PMEMobjpool *pop, TOID(struct art_map) map);
+
+/*
+ * The keys of the functions above are stored as 8 big-endian bytes, so that
+ * they are sorted by their values. The functions below take the keys as
+ * strings of bytes of any length up to ART_MAP_MAX_KEY_LEN, the two kinds of
+ * keys should not be mixed in one map.
+ */
+int art_map_insert_bytes(PMEMobjpool *pop, TOID(struct art_map) map,
+	const void *key, size_t key_len, PMEMoid value);
+PMEMoid art_map_remove_bytes(PMEMobjpool *pop, TOID(struct art_map) map,
+	const void *key, size_t key_len);
+PMEMoid art_map_get_bytes(PMEMobjpool *pop, TOID(struct art_map) map,
+	const void *key, size_t key_len);
+int art_map_range_bytes(PMEMobjpool *pop, TOID(struct art_map) map,
+	const void *start, size_t start_len, const void *end, size_t end_len,
+	int (*cb)(const void *key, size_t key_len, PMEMoid value, void *arg),
+	void *arg);
+
+#endif /* ART_MAP_H */
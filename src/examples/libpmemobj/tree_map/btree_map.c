@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2019, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * btree_map.c -- textbook implementation of btree /w preemptive splitting
@@ -602,6 +602,50 @@ btree_map_foreach(PMEMobjpool *pop, TOID(struct btree_map) map,
 	return btree_map_foreach_node(D_RO(map)->root, cb, arg);
 }
 
+/*
+ * btree_map_range_node -- (internal) recursively traverses the part of
+ * the tree with keys from the range
+ */
+static int
+btree_map_range_node(const TOID(struct tree_map_node) p,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid, void *arg), void *arg)
+{
+	if (TOID_IS_NULL(p))
+		return 0;
+
+	for (int i = 0; i <= D_RO(p)->n; ++i) {
+		/* the keys in the slot are lower than the item next to it */
+		if (i == D_RO(p)->n || D_RO(p)->items[i].key > start) {
+			if (btree_map_range_node(D_RO(p)->slots[i],
+					start, end, cb, arg) != 0)
+				return 1;
+		}
+
+		if (i == D_RO(p)->n || D_RO(p)->items[i].key > end)
+			break;
+
+		if (D_RO(p)->items[i].key >= start &&
+				D_RO(p)->items[i].key != 0) {
+			if (cb(D_RO(p)->items[i].key, D_RO(p)->items[i].value,
+					arg) != 0)
+				return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * btree_map_range -- traverses the keys from start to end in order
+ */
+int
+btree_map_range(PMEMobjpool *pop, TOID(struct btree_map) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	return btree_map_range_node(D_RO(map)->root, start, end, cb, arg);
+}
+
 /*
  * ctree_map_check -- check if given persistent object is a tree map
  */
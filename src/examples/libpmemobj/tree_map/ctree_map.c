@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2019, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * ctree_map.c -- Crit-bit trie implementation
@@ -350,6 +350,102 @@ ctree_map_foreach(PMEMobjpool *pop, TOID(struct ctree_map) map,
 	return ctree_map_foreach_node(D_RO(map)->root, cb, arg);
 }
 
+/*
+ * ctree_map_range_bit -- (internal) returns the most significant bit in which
+ * the key differs from the best matching one in the tree, -1 if it's there
+ */
+static int
+ctree_map_range_bit(TOID(struct ctree_map) map, uint64_t key)
+{
+	struct tree_map_entry *n = &D_RW(map)->root;
+
+	TOID(struct tree_map_node) node;
+	while (!OID_IS_NULL(n->slot) &&
+			OID_INSTANCEOF(n->slot, struct tree_map_node)) {
+		TOID_ASSIGN(node, n->slot);
+		n = &D_RW(node)->entries[BIT_IS_SET(key, D_RW(node)->diff)];
+	}
+
+	return n->key == key ? -1 : find_crit_bit(n->key, key);
+}
+
+struct ctree_map_range_args {
+	uint64_t start;
+	int start_bit;
+	uint64_t end;
+	int end_bit;
+	int (*cb)(uint64_t key, PMEMoid value, void *arg);
+	void *arg;
+};
+
+/*
+ * ctree_map_range_node -- (internal) recursively traverses the part of
+ * the tree with keys from the range
+ *
+ * The lo and hi flags tell whether the entry is on the path to the best
+ * matching key of the start and the end of the range. The keys of a node on
+ * such a path share all the bits above its critical bit with that key, so
+ * the path splits the tree into the parts before and after the key.
+ */
+static int
+ctree_map_range_node(struct tree_map_entry e,
+	struct ctree_map_range_args *r, int lo, int hi)
+{
+	if (OID_IS_NULL(e.slot) ||
+			!OID_INSTANCEOF(e.slot, struct tree_map_node)) {
+		if ((lo && e.key < r->start) || (hi && e.key > r->end))
+			return 0;
+
+		return r->cb(e.key, e.slot, r->arg);
+	}
+
+	TOID(struct tree_map_node) node;
+	TOID_ASSIGN(node, e.slot);
+	int diff = D_RO(node)->diff;
+
+	/* the subtree branches off the path, all its keys are on one side */
+	if (lo && diff < r->start_bit) {
+		if (BIT_IS_SET(r->start, r->start_bit))
+			return 0;
+		lo = 0;
+	}
+	if (hi && diff < r->end_bit) {
+		if (!BIT_IS_SET(r->end, r->end_bit))
+			return 0;
+		hi = 0;
+	}
+
+	int first = lo ? BIT_IS_SET(r->start, diff) : 0;
+	int last = hi ? BIT_IS_SET(r->end, diff) : 1;
+	for (int i = first; i <= last; ++i) {
+		if (ctree_map_range_node(D_RO(node)->entries[i], r,
+				lo && i == first, hi && i == last) != 0)
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * ctree_map_range -- traverses the keys from start to end in order
+ */
+int
+ctree_map_range(PMEMobjpool *pop, TOID(struct ctree_map) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	if (D_RO(map)->root.key == 0 && OID_IS_NULL(D_RO(map)->root.slot))
+		return 0;
+
+	struct ctree_map_range_args r = {
+		start, ctree_map_range_bit(map, start),
+		end, ctree_map_range_bit(map, end),
+		cb, arg
+	};
+
+	return ctree_map_range_node(D_RO(map)->root, &r, 1, 1);
+}
+
 /*
  * ctree_map_is_empty -- checks whether the tree map is empty
  */
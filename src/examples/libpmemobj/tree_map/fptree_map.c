@@ -0,0 +1,1107 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * fptree_map.c -- B+-tree with fingerprinted leaves
+ *
+ * Only the leaves of the tree are kept in persistent memory. A leaf takes
+ * exactly 256 bytes and it's allocated from an allocation class aligned to
+ * that size, so it never straddles two XPLines. The entries of a leaf are
+ * not sorted, instead a one byte fingerprint of each key is stored in front
+ * of them and a lookup compares all the fingerprints at once, reading only
+ * the keys whose fingerprint matches. The slots in use are marked in a
+ * bitmap, which is updated by a single 8-byte store, so inserting into a leaf
+ * which isn't full and removing from it don't need a transaction. The leaves
+ * are linked in the order of their keys.
+ *
+ * The inner nodes live in DRAM and they are rebuilt from the list of leaves
+ * whenever the pool is opened. Each transaction which changes the list bumps
+ * the version of the tree, which makes the inner nodes rebuilt also after
+ * such a change is rolled back by an outer transaction.
+ *
+ * Only the offsets of the values are stored, so they must be objects from
+ * the same pool as the tree. The inner nodes are not freed when the pool is
+ * closed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "fptree_map.h"
+
+/* number of entries in a leaf */
+#define LEAF_SLOTS 14
+#define LEAF_FULL ((1ULL << LEAF_SLOTS) - 1)
+
+/* number of fingerprints compared at once */
+#define FP_SLOTS 16
+
+/* units per block of the allocation class of the leaves */
+#define LEAF_UNITS_PER_BLOCK 1024
+
+/* maximum number of children of an inner node */
+#define INODE_FANOUT 16
+
+/* maximum number of levels of the inner nodes */
+#define MAX_HEIGHT 32
+
+struct leaf {
+	/* fingerprints of the keys, the last two are not used */
+	uint8_t fp[FP_SLOTS];
+	/* slots in use */
+	uint64_t bitmap;
+	/* offset of the next leaf */
+	uint64_t next;
+
+	struct leaf_entry {
+		uint64_t key;
+		/* offset of the value */
+		uint64_t value;
+	} entry[LEAF_SLOTS];
+};
+
+struct inode {
+	/* number of children */
+	unsigned n;
+	/* child i holds the keys from key[i - 1] up to key[i] */
+	uint64_t key[INODE_FANOUT - 1];
+	/* inner nodes or leaves on the lowest level */
+	void *child[INODE_FANOUT];
+};
+
+struct runtime {
+	/* top inner node or the only leaf, NULL if there are no leaves */
+	void *root;
+	/* number of levels of the inner nodes */
+	unsigned height;
+	/* version of the tree the inner nodes were built for */
+	uint64_t version;
+
+	/* unused inner nodes, linked through the first child */
+	struct inode *spare;
+	unsigned nspare;
+
+	/* flags of the allocation of a leaf */
+	uint64_t leaf_flags;
+};
+
+struct fptree_map {
+	/* offset of the leaf with the lowest keys */
+	uint64_t head;
+	/* bumped by each transaction which changes the list of leaves */
+	uint64_t version;
+
+	PMEMvlt(struct runtime) runtime;
+};
+
+/* position in an inner node on the way to a leaf */
+struct path {
+	struct inode *node;
+	unsigned idx;
+};
+
+/*
+ * leaf_get -- (internal) returns the leaf at the offset
+ */
+static inline struct leaf *
+leaf_get(PMEMobjpool *pop, uint64_t off)
+{
+	return off ? (struct leaf *)((char *)pop + off) : NULL;
+}
+
+/*
+ * leaf_off -- (internal) returns the offset of the leaf
+ */
+static inline uint64_t
+leaf_off(PMEMobjpool *pop, const struct leaf *l)
+{
+	return (uint64_t)((const char *)l - (const char *)pop);
+}
+
+/*
+ * leaf_oid -- (internal) returns the object of the leaf
+ */
+static inline PMEMoid
+leaf_oid(TOID(struct fptree_map) map, PMEMobjpool *pop, const struct leaf *l)
+{
+	PMEMoid oid = {map.oid.pool_uuid_lo, leaf_off(pop, l)};
+	return oid;
+}
+
+/*
+ * value_oid -- (internal) returns the value stored at the offset
+ */
+static inline PMEMoid
+value_oid(TOID(struct fptree_map) map, uint64_t off)
+{
+	if (off == 0)
+		return OID_NULL;
+
+	PMEMoid oid = {map.oid.pool_uuid_lo, off};
+	return oid;
+}
+
+/*
+ * key_fp -- (internal) returns the fingerprint of the key
+ */
+static inline uint8_t
+key_fp(uint64_t key)
+{
+	return (uint8_t)((key * 0x9e3779b97f4a7c15ULL) >> 56);
+}
+
+/*
+ * leaf_match -- (internal) returns the slots in use with matching fingerprint
+ */
+static inline unsigned
+leaf_match(const struct leaf *l, uint8_t fp)
+{
+#ifdef __SSE2__
+	__m128i fps = _mm_loadu_si128((const __m128i *)l->fp);
+	__m128i cmp = _mm_cmpeq_epi8(fps, _mm_set1_epi8((char)fp));
+	unsigned mask = (unsigned)_mm_movemask_epi8(cmp);
+#else
+	unsigned mask = 0;
+	for (unsigned i = 0; i < LEAF_SLOTS; ++i) {
+		if (l->fp[i] == fp)
+			mask |= 1U << i;
+	}
+#endif
+	return mask & (unsigned)l->bitmap;
+}
+
+/*
+ * leaf_find -- (internal) returns the slot of the key, -1 if there is none
+ */
+static int
+leaf_find(const struct leaf *l, uint64_t key)
+{
+	unsigned mask = leaf_match(l, key_fp(key));
+
+	while (mask != 0) {
+		int slot = __builtin_ctz(mask);
+		if (l->entry[slot].key == key)
+			return slot;
+		mask &= mask - 1;
+	}
+
+	return -1;
+}
+
+/*
+ * leaf_sort -- (internal) fills the slots in use in the order of their keys,
+ * returns the number of them
+ */
+static unsigned
+leaf_sort(const struct leaf *l, unsigned slots[LEAF_SLOTS])
+{
+	unsigned n = 0;
+
+	for (uint64_t mask = l->bitmap; mask != 0; mask &= mask - 1) {
+		unsigned slot = (unsigned)__builtin_ctzll(mask);
+		unsigned i = n++;
+		for (; i > 0 && l->entry[slots[i - 1]].key >
+				l->entry[slot].key; --i)
+			slots[i] = slots[i - 1];
+		slots[i] = slot;
+	}
+
+	return n;
+}
+
+/*
+ * leaf_class_register -- (internal) creates the allocation class of
+ * the leaves, returns the flags of their allocation
+ */
+static uint64_t
+leaf_class_register(PMEMobjpool *pop)
+{
+	struct pobj_alloc_class_desc desc;
+	desc.unit_size = sizeof(struct leaf);
+	desc.alignment = sizeof(struct leaf);
+	desc.units_per_block = LEAF_UNITS_PER_BLOCK;
+	desc.header_type = POBJ_HEADER_NONE;
+
+	/* the leaves are allocated from the default classes if it fails */
+	if (pmemobj_ctl_set(pop, "heap.alloc_class.new.desc", &desc) != 0)
+		return 0;
+
+	return POBJ_CLASS_ID(desc.class_id);
+}
+
+/*
+ * inode_reserve -- (internal) makes sure there are at least n spare inner
+ * nodes
+ */
+static int
+inode_reserve(struct runtime *rt, unsigned n)
+{
+	while (rt->nspare < n) {
+		struct inode *in = malloc(sizeof(*in));
+		if (in == NULL)
+			return -1;
+
+		in->child[0] = rt->spare;
+		rt->spare = in;
+		rt->nspare++;
+	}
+
+	return 0;
+}
+
+/*
+ * inode_new -- (internal) takes one of the spare inner nodes
+ */
+static struct inode *
+inode_new(struct runtime *rt)
+{
+	struct inode *in = rt->spare;
+	assert(in != NULL);
+
+	rt->spare = in->child[0];
+	rt->nspare--;
+
+	return in;
+}
+
+/*
+ * inode_put -- (internal) returns the inner node to the spare ones
+ */
+static void
+inode_put(struct runtime *rt, struct inode *in)
+{
+	in->child[0] = rt->spare;
+	rt->spare = in;
+	rt->nspare++;
+}
+
+/*
+ * inode_free -- (internal) frees the inner node and its descendants
+ */
+static void
+inode_free(void *node, unsigned height)
+{
+	if (height == 0)
+		return;
+
+	struct inode *in = node;
+	for (unsigned i = 0; i < in->n; ++i)
+		inode_free(in->child[i], height - 1);
+
+	free(in);
+}
+
+/*
+ * inode_insert_at -- (internal) inserts the child holding the keys from
+ * the given one at the position in the inner node which isn't full
+ */
+static void
+inode_insert_at(struct inode *in, unsigned pos, uint64_t key, void *child)
+{
+	assert(pos > 0 && in->n < INODE_FANOUT);
+
+	memmove(&in->child[pos + 1], &in->child[pos],
+		sizeof(in->child[0]) * (in->n - pos));
+	memmove(&in->key[pos], &in->key[pos - 1],
+		sizeof(in->key[0]) * (in->n - pos));
+
+	in->child[pos] = child;
+	in->key[pos - 1] = key;
+	in->n++;
+}
+
+/*
+ * inode_remove_at -- (internal) removes the child at the position in
+ * the inner node
+ */
+static void
+inode_remove_at(struct inode *in, unsigned pos)
+{
+	assert(in->n > 1);
+
+	/* the first child takes over the keys of the removed one */
+	unsigned kpos = pos > 0 ? pos - 1 : 0;
+
+	memmove(&in->child[pos], &in->child[pos + 1],
+		sizeof(in->child[0]) * (in->n - pos - 1));
+	memmove(&in->key[kpos], &in->key[kpos + 1],
+		sizeof(in->key[0]) * (in->n - kpos - 2));
+	in->n--;
+}
+
+/*
+ * tree_find_leaf -- (internal) returns the leaf for the key and optionally
+ * the path to it
+ */
+static struct leaf *
+tree_find_leaf(struct runtime *rt, uint64_t key, struct path *path)
+{
+	void *node = rt->root;
+
+	for (unsigned h = 0; h < rt->height; ++h) {
+		struct inode *in = node;
+
+		unsigned i = 0;
+		while (i < in->n - 1 && in->key[i] <= key)
+			i++;
+
+		if (path != NULL) {
+			path[h].node = in;
+			path[h].idx = i;
+		}
+		node = in->child[i];
+	}
+
+	return node;
+}
+
+/*
+ * tree_prev_leaf -- (internal) returns the leaf preceding the one at the end
+ * of the path, NULL if it's the first one
+ */
+static struct leaf *
+tree_prev_leaf(struct runtime *rt, struct path *path)
+{
+	int h = (int)rt->height - 1;
+	while (h >= 0 && path[h].idx == 0)
+		h--;
+
+	if (h < 0)
+		return NULL;
+
+	void *node = path[h].node->child[path[h].idx - 1];
+	for (unsigned l = (unsigned)h + 1; l < rt->height; ++l) {
+		struct inode *in = node;
+		node = in->child[in->n - 1];
+	}
+
+	return node;
+}
+
+/*
+ * tree_insert_child -- (internal) inserts the leaf holding the keys from
+ * the given one next to the leaf at the end of the path
+ *
+ * There must be at least height + 1 spare inner nodes.
+ */
+static void
+tree_insert_child(struct runtime *rt, struct path *path, uint64_t key,
+	void *child)
+{
+	for (int h = (int)rt->height - 1; h >= 0; --h) {
+		struct inode *in = path[h].node;
+		unsigned pos = path[h].idx + 1;
+
+		if (in->n < INODE_FANOUT) {
+			inode_insert_at(in, pos, key, child);
+			return;
+		}
+
+		/* lay out all the children, keys[i] is the lowest of i + 1 */
+		uint64_t keys[INODE_FANOUT];
+		void *children[INODE_FANOUT + 1];
+		unsigned n = 0;
+		for (unsigned i = 0; i < in->n; ++i) {
+			if (i == pos) {
+				keys[n - 1] = key;
+				children[n++] = child;
+			}
+			if (i > 0)
+				keys[n - 1] = in->key[i - 1];
+			children[n++] = in->child[i];
+		}
+		if (pos == in->n) {
+			keys[n - 1] = key;
+			children[n++] = child;
+		}
+
+		/* split the node in half, the middle key goes up */
+		struct inode *right = inode_new(rt);
+		unsigned left_n = n / 2;
+
+		in->n = left_n;
+		memcpy(in->child, children, sizeof(children[0]) * left_n);
+		memcpy(in->key, keys, sizeof(keys[0]) * (left_n - 1));
+
+		right->n = n - left_n;
+		memcpy(right->child, &children[left_n],
+			sizeof(children[0]) * right->n);
+		memcpy(right->key, &keys[left_n],
+			sizeof(keys[0]) * (right->n - 1));
+
+		key = keys[left_n - 1];
+		child = right;
+	}
+
+	/* the root was split, the tree grows in height */
+	struct inode *root = inode_new(rt);
+	root->n = 2;
+	root->key[0] = key;
+	root->child[0] = rt->root;
+	root->child[1] = child;
+
+	rt->root = root;
+	rt->height++;
+	assert(rt->height < MAX_HEIGHT);
+}
+
+/*
+ * tree_remove_child -- (internal) removes the leaf at the end of the path,
+ * which must not be the only one
+ */
+static void
+tree_remove_child(struct runtime *rt, struct path *path)
+{
+	for (int h = (int)rt->height - 1; h >= 0; --h) {
+		struct inode *in = path[h].node;
+
+		if (in->n > 1) {
+			inode_remove_at(in, path[h].idx);
+			break;
+		}
+
+		/* the node is left without children, remove it as well */
+		inode_put(rt, in);
+	}
+
+	/* the root with a single child is replaced by the child */
+	while (rt->height > 0 && ((struct inode *)rt->root)->n == 1) {
+		struct inode *root = rt->root;
+		rt->root = root->child[0];
+		rt->height--;
+		inode_put(rt, root);
+	}
+}
+
+/*
+ * tree_rebuild -- (internal) builds the inner nodes from the list of leaves
+ */
+static int
+tree_rebuild(PMEMobjpool *pop, struct fptree_map *map, struct runtime *rt)
+{
+	inode_free(rt->root, rt->height);
+	rt->root = NULL;
+	rt->height = 0;
+
+	if (map->head == 0) {
+		rt->version = map->version;
+		return 0;
+	}
+
+	size_t nleaves = 0;
+	for (struct leaf *l = leaf_get(pop, map->head); l != NULL;
+			l = leaf_get(pop, l->next))
+		nleaves++;
+
+	struct {
+		uint64_t key;
+		void *node;
+	} *level = malloc(sizeof(*level) * nleaves);
+	if (level == NULL)
+		return -1;
+
+	/*
+	 * Empty leaves are removed together with their last entry, so only
+	 * the first leaf can be empty when it's the only one.
+	 */
+	size_t n = 0;
+	for (struct leaf *l = leaf_get(pop, map->head); l != NULL;
+			l = leaf_get(pop, l->next)) {
+		if (l->bitmap == 0)
+			continue;
+
+		unsigned slots[LEAF_SLOTS];
+		leaf_sort(l, slots);
+		level[n].key = l->entry[slots[0]].key;
+		level[n].node = l;
+		n++;
+	}
+	if (n == 0) {
+		level[0].node = leaf_get(pop, map->head);
+		n = 1;
+	}
+
+	/* build the tree bottom-up, with the inner nodes filled completely */
+	while (n > 1) {
+		size_t out = 0;
+		for (size_t i = 0; i < n; i += INODE_FANOUT) {
+			struct inode *in = malloc(sizeof(*in));
+			if (in == NULL) {
+				/* free the inner nodes built so far */
+				for (size_t j = 0; j < out; ++j)
+					inode_free(level[j].node,
+						rt->height + 1);
+				for (size_t j = i; j < n; ++j)
+					inode_free(level[j].node, rt->height);
+
+				rt->height = 0;
+				free(level);
+				return -1;
+			}
+
+			in->n = (unsigned)(n - i < INODE_FANOUT ?
+				n - i : INODE_FANOUT);
+			for (unsigned j = 0; j < in->n; ++j) {
+				in->child[j] = level[i + j].node;
+				if (j > 0)
+					in->key[j - 1] = level[i + j].key;
+			}
+
+			level[out].key = level[i].key;
+			level[out].node = in;
+			out++;
+		}
+
+		n = out;
+		rt->height++;
+	}
+
+	rt->root = level[0].node;
+	rt->version = map->version;
+	free(level);
+
+	return 0;
+}
+
+struct runtime_args {
+	PMEMobjpool *pop;
+	struct fptree_map *map;
+};
+
+/*
+ * runtime_construct -- (internal) builds the inner nodes after the pool is
+ * opened
+ */
+static int
+runtime_construct(void *ptr, void *arg)
+{
+	struct runtime *rt = ptr;
+	struct runtime_args *args = arg;
+
+	memset(rt, 0, sizeof(*rt));
+	rt->leaf_flags = leaf_class_register(args->pop);
+
+	return tree_rebuild(args->pop, args->map, rt);
+}
+
+/*
+ * runtime_get -- (internal) returns the up-to-date inner nodes of the tree
+ */
+static struct runtime *
+runtime_get(PMEMobjpool *pop, struct fptree_map *map)
+{
+	struct runtime_args args = {pop, map};
+
+	struct runtime *rt = pmemobj_volatile(pop, &map->runtime.vlt,
+		&map->runtime.value, sizeof(map->runtime.value),
+		runtime_construct, &args);
+	if (rt == NULL)
+		return NULL;
+
+	/* the list of leaves was changed by an aborted transaction */
+	if (rt->version != map->version && tree_rebuild(pop, map, rt) != 0)
+		return NULL;
+
+	return rt;
+}
+
+/*
+ * tree_first_leaf -- (internal) allocates the first leaf of the tree
+ */
+static int
+tree_first_leaf(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	struct runtime *rt)
+{
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		PMEMoid leaf = pmemobj_tx_xalloc(sizeof(struct leaf), 0,
+			POBJ_XALLOC_ZERO | rt->leaf_flags);
+
+		TX_ADD_FIELD(map, head);
+		TX_ADD_FIELD(map, version);
+		D_RW(map)->head = leaf.off;
+		D_RW(map)->version++;
+	} TX_ONABORT {
+		ret = -1;
+	} TX_END
+
+	if (ret != 0)
+		return ret;
+
+	rt->root = leaf_get(pop, D_RO(map)->head);
+	rt->version = D_RO(map)->version;
+
+	return 0;
+}
+
+/*
+ * leaf_split -- (internal) moves the upper half of the entries of the full
+ * leaf at the end of the path to a new one
+ */
+static int
+leaf_split(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	struct runtime *rt, struct leaf *l, struct path *path)
+{
+	/* the inner nodes can't fail to be allocated after the commit */
+	if (inode_reserve(rt, rt->height + 1) != 0)
+		return -1;
+
+	unsigned slots[LEAF_SLOTS];
+	leaf_sort(l, slots);
+	uint64_t median = l->entry[slots[LEAF_SLOTS / 2]].key;
+
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		PMEMoid oid = pmemobj_tx_xalloc(sizeof(struct leaf), 0,
+			rt->leaf_flags);
+		struct leaf *right = pmemobj_direct(oid);
+
+		uint64_t moved = 0;
+		unsigned n = 0;
+		for (unsigned i = LEAF_SLOTS / 2; i < LEAF_SLOTS; ++i) {
+			right->entry[n] = l->entry[slots[i]];
+			right->fp[n] = l->fp[slots[i]];
+			moved |= 1ULL << slots[i];
+			n++;
+		}
+		right->bitmap = (1ULL << n) - 1;
+		right->next = l->next;
+
+		pmemobj_tx_add_range_direct(&l->bitmap,
+			sizeof(l->bitmap) + sizeof(l->next));
+		l->bitmap &= ~moved;
+		l->next = oid.off;
+
+		TX_ADD_FIELD(map, version);
+		D_RW(map)->version++;
+	} TX_ONABORT {
+		ret = -1;
+	} TX_END
+
+	if (ret != 0)
+		return ret;
+
+	tree_insert_child(rt, path, median, leaf_get(pop, l->next));
+	rt->version = D_RO(map)->version;
+
+	return 0;
+}
+
+/*
+ * leaf_unlink -- (internal) removes the leaf at the end of the path along
+ * with its last entry
+ */
+static int
+leaf_unlink(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	struct runtime *rt, struct leaf *l, struct path *path)
+{
+	struct leaf *prev = tree_prev_leaf(rt, path);
+	assert(prev != NULL ? prev->next == leaf_off(pop, l) :
+		D_RO(map)->head == leaf_off(pop, l));
+
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		if (prev != NULL) {
+			pmemobj_tx_add_range_direct(&prev->next,
+				sizeof(prev->next));
+			prev->next = l->next;
+		} else {
+			TX_ADD_FIELD(map, head);
+			D_RW(map)->head = l->next;
+		}
+
+		TX_ADD_FIELD(map, version);
+		D_RW(map)->version++;
+
+		pmemobj_tx_free(leaf_oid(map, pop, l));
+	} TX_ONABORT {
+		ret = -1;
+	} TX_END
+
+	if (ret != 0)
+		return ret;
+
+	tree_remove_child(rt, path);
+	rt->version = D_RO(map)->version;
+
+	return 0;
+}
+
+/*
+ * leaf_update -- (internal) prepares the leaf to be modified, in
+ * a transaction it's snapshotted as a whole
+ */
+static int
+leaf_update(struct leaf *l)
+{
+	if (pmemobj_tx_stage() != TX_STAGE_WORK)
+		return 0;
+
+	return pmemobj_tx_add_range_direct(l, sizeof(*l));
+}
+
+/*
+ * fptree_map_create -- allocates a new fptree instance
+ */
+int
+fptree_map_create(PMEMobjpool *pop, TOID(struct fptree_map) *map, void *arg)
+{
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		pmemobj_tx_add_range_direct(map, sizeof(*map));
+		*map = TX_ZNEW(struct fptree_map);
+	} TX_ONABORT {
+		ret = 1;
+	} TX_END
+
+	return ret;
+}
+
+/*
+ * fptree_map_clear -- removes all elements from the map
+ */
+int
+fptree_map_clear(PMEMobjpool *pop, TOID(struct fptree_map) map)
+{
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		uint64_t next;
+		for (uint64_t off = D_RO(map)->head; off != 0; off = next) {
+			struct leaf *l = leaf_get(pop, off);
+			next = l->next;
+			pmemobj_tx_free(leaf_oid(map, pop, l));
+		}
+
+		TX_ADD_FIELD(map, head);
+		TX_ADD_FIELD(map, version);
+		D_RW(map)->head = 0;
+		D_RW(map)->version++;
+	} TX_ONABORT {
+		ret = 1;
+	} TX_END
+
+	return ret;
+}
+
+/*
+ * fptree_map_destroy -- cleanups and frees fptree instance
+ */
+int
+fptree_map_destroy(PMEMobjpool *pop, TOID(struct fptree_map) *map)
+{
+	struct runtime *rt = runtime_get(pop, D_RW(*map));
+	if (rt == NULL)
+		return 1;
+
+	/* the inner nodes are gone with the map */
+	struct runtime dram = *rt;
+
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		fptree_map_clear(pop, *map);
+		pmemobj_tx_add_range_direct(map, sizeof(*map));
+		TX_FREE(*map);
+		*map = TOID_NULL(struct fptree_map);
+	} TX_ONABORT {
+		ret = 1;
+	} TX_END
+
+	if (ret == 0) {
+		inode_free(dram.root, dram.height);
+		while (dram.spare != NULL)
+			free(inode_new(&dram));
+	}
+
+	return ret;
+}
+
+/*
+ * fptree_map_init -- builds the inner nodes of the tree
+ */
+int
+fptree_map_init(PMEMobjpool *pop, TOID(struct fptree_map) map)
+{
+	return runtime_get(pop, D_RW(map)) == NULL;
+}
+
+/*
+ * fptree_map_insert -- inserts a new key-value pair into the map, returns 1 if
+ * the key already exists
+ */
+int
+fptree_map_insert(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	uint64_t key, PMEMoid value)
+{
+	if (!OID_IS_NULL(value) &&
+			value.pool_uuid_lo != map.oid.pool_uuid_lo) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	struct runtime *rt = runtime_get(pop, D_RW(map));
+	if (rt == NULL)
+		return -1;
+
+	if (rt->root == NULL && tree_first_leaf(pop, map, rt) != 0)
+		return -1;
+
+	struct path path[MAX_HEIGHT];
+	struct leaf *l;
+	for (;;) {
+		l = tree_find_leaf(rt, key, path);
+		if (leaf_find(l, key) >= 0)
+			return 1;
+
+		if (l->bitmap != LEAF_FULL)
+			break;
+
+		if (leaf_split(pop, map, rt, l, path) != 0)
+			return -1;
+	}
+
+	if (leaf_update(l) != 0)
+		return -1;
+
+	unsigned slot = (unsigned)__builtin_ctzll(~l->bitmap & LEAF_FULL);
+	l->entry[slot].key = key;
+	l->entry[slot].value = value.off;
+	l->fp[slot] = key_fp(key);
+
+	int tx = pmemobj_tx_stage() == TX_STAGE_WORK;
+
+	/* the entry has to be persistent before it's marked as used */
+	if (!tx) {
+		pmemobj_flush(pop, &l->entry[slot], sizeof(l->entry[slot]));
+		pmemobj_flush(pop, &l->fp[slot], sizeof(l->fp[slot]));
+		pmemobj_drain(pop);
+	}
+
+	l->bitmap |= 1ULL << slot;
+	if (!tx)
+		pmemobj_persist(pop, &l->bitmap, sizeof(l->bitmap));
+
+	return 0;
+}
+
+/*
+ * fptree_map_insert_new -- allocates a new object and inserts it into the tree
+ */
+int
+fptree_map_insert_new(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key, size_t size, unsigned type_num,
+		void (*constructor)(PMEMobjpool *pop, void *ptr, void *arg),
+		void *arg)
+{
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		PMEMoid n = pmemobj_tx_alloc(size, type_num);
+		constructor(pop, pmemobj_direct(n), arg);
+		if (fptree_map_insert(pop, map, key, n) != 0)
+			pmemobj_tx_abort(EINVAL);
+	} TX_ONABORT {
+		ret = 1;
+	} TX_END
+
+	return ret;
+}
+
+/*
+ * fptree_map_remove -- removes key-value pair from the map
+ */
+PMEMoid
+fptree_map_remove(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key)
+{
+	struct runtime *rt = runtime_get(pop, D_RW(map));
+	if (rt == NULL || rt->root == NULL)
+		return OID_NULL;
+
+	struct path path[MAX_HEIGHT];
+	struct leaf *l = tree_find_leaf(rt, key, path);
+	int slot = leaf_find(l, key);
+	if (slot < 0)
+		return OID_NULL;
+
+	PMEMoid value = value_oid(map, l->entry[slot].value);
+	uint64_t bitmap = l->bitmap & ~(1ULL << slot);
+
+	/* only the first leaf is kept when it gets empty */
+	if (bitmap == 0 && rt->height > 0) {
+		if (leaf_unlink(pop, map, rt, l, path) != 0)
+			return OID_NULL;
+		return value;
+	}
+
+	if (leaf_update(l) != 0)
+		return OID_NULL;
+
+	l->bitmap = bitmap;
+	if (pmemobj_tx_stage() != TX_STAGE_WORK)
+		pmemobj_persist(pop, &l->bitmap, sizeof(l->bitmap));
+
+	return value;
+}
+
+/*
+ * fptree_map_remove_free -- removes and frees an object from the tree
+ */
+int
+fptree_map_remove_free(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key)
+{
+	int ret = 0;
+
+	TX_BEGIN(pop) {
+		PMEMoid val = fptree_map_remove(pop, map, key);
+		pmemobj_tx_free(val);
+	} TX_ONABORT {
+		ret = 1;
+	} TX_END
+
+	return ret;
+}
+
+/*
+ * fptree_map_get -- searches for a value of the key
+ */
+PMEMoid
+fptree_map_get(PMEMobjpool *pop, TOID(struct fptree_map) map, uint64_t key)
+{
+	struct runtime *rt = runtime_get(pop, D_RW(map));
+	if (rt == NULL || rt->root == NULL)
+		return OID_NULL;
+
+	struct leaf *l = tree_find_leaf(rt, key, NULL);
+	int slot = leaf_find(l, key);
+	if (slot < 0)
+		return OID_NULL;
+
+	return value_oid(map, l->entry[slot].value);
+}
+
+/*
+ * fptree_map_lookup -- searches if key exists
+ */
+int
+fptree_map_lookup(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key)
+{
+	struct runtime *rt = runtime_get(pop, D_RW(map));
+	if (rt == NULL || rt->root == NULL)
+		return 0;
+
+	return leaf_find(tree_find_leaf(rt, key, NULL), key) >= 0;
+}
+
+/*
+ * fptree_map_scan -- (internal) calls the function for the elements from
+ * the range in the order of their keys, starting with the given leaf
+ */
+static int
+fptree_map_scan(PMEMobjpool *pop, TOID(struct fptree_map) map, uint64_t off,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	uint64_t next;
+	for (; off != 0; off = next) {
+		struct leaf *l = leaf_get(pop, off);
+
+		/* the callback may remove the entries, even the whole leaf */
+		struct leaf_entry entries[LEAF_SLOTS];
+		unsigned slots[LEAF_SLOTS];
+		unsigned n = leaf_sort(l, slots);
+		for (unsigned i = 0; i < n; ++i)
+			entries[i] = l->entry[slots[i]];
+		next = l->next;
+
+		for (unsigned i = 0; i < n; ++i) {
+			if (entries[i].key < start)
+				continue;
+			if (entries[i].key > end)
+				return 0;
+
+			if (cb(entries[i].key, value_oid(map, entries[i].value),
+					arg) != 0)
+				return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * fptree_map_foreach -- calls the function for all the elements in the order
+ * of their keys
+ */
+int
+fptree_map_foreach(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	return fptree_map_scan(pop, map, D_RO(map)->head, 0, UINT64_MAX,
+		cb, arg);
+}
+
+/*
+ * fptree_map_range -- traverses the keys from start to end in order
+ */
+int
+fptree_map_range(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	uint64_t off = D_RO(map)->head;
+
+	/* the leaves before the one of the start key are skipped if possible */
+	struct runtime *rt = runtime_get(pop, D_RW(map));
+	if (rt != NULL && rt->root != NULL)
+		off = leaf_off(pop, tree_find_leaf(rt, start, NULL));
+
+	return fptree_map_scan(pop, map, off, start, end, cb, arg);
+}
+
+/*
+ * fptree_map_is_empty -- checks whether the tree map is empty
+ */
+int
+fptree_map_is_empty(PMEMobjpool *pop, TOID(struct fptree_map) map)
+{
+	struct leaf *head = leaf_get(pop, D_RO(map)->head);
+
+	/* there are no empty leaves apart from the only one */
+	return head == NULL || head->bitmap == 0;
+}
+
+/*
+ * fptree_map_count -- returns the number of elements in the map
+ */
+size_t
+fptree_map_count(PMEMobjpool *pop, TOID(struct fptree_map) map)
+{
+	size_t count = 0;
+	for (struct leaf *l = leaf_get(pop, D_RO(map)->head); l != NULL;
+			l = leaf_get(pop, l->next))
+		count += (size_t)__builtin_popcountll(l->bitmap);
+
+	return count;
+}
+
+/*
+ * fptree_map_check -- check if given persistent object is a tree map
+ */
+int
+fptree_map_check(PMEMobjpool *pop, TOID(struct fptree_map) map)
+{
+	return TOID_IS_NULL(map) || !TOID_VALID(map);
+}
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * fptree_map.h -- TreeMap sorted collection implementation
+ */
+
+#ifndef FPTREE_MAP_H
+#define FPTREE_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <libpmemobj.h>
+
+#ifndef FPTREE_MAP_TYPE_OFFSET
+#define FPTREE_MAP_TYPE_OFFSET 1028
+#endif
+
+struct fptree_map;
+TOID_DECLARE(struct fptree_map, FPTREE_MAP_TYPE_OFFSET + 0);
+
+int fptree_map_check(PMEMobjpool *pop, TOID(struct fptree_map) map);
+int fptree_map_create(PMEMobjpool *pop, TOID(struct fptree_map) *map,
+		void *arg);
+int fptree_map_destroy(PMEMobjpool *pop, TOID(struct fptree_map) *map);
+int fptree_map_init(PMEMobjpool *pop, TOID(struct fptree_map) map);
+int fptree_map_insert(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	uint64_t key, PMEMoid value);
+int fptree_map_insert_new(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key, size_t size, unsigned type_num,
+		void (*constructor)(PMEMobjpool *pop, void *ptr, void *arg),
+		void *arg);
+PMEMoid fptree_map_remove(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key);
+int fptree_map_remove_free(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key);
+int fptree_map_clear(PMEMobjpool *pop, TOID(struct fptree_map) map);
+PMEMoid fptree_map_get(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key);
+int fptree_map_lookup(PMEMobjpool *pop, TOID(struct fptree_map) map,
+		uint64_t key);
+int fptree_map_foreach(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
+int fptree_map_range(PMEMobjpool *pop, TOID(struct fptree_map) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
+int fptree_map_is_empty(PMEMobjpool *pop, TOID(struct fptree_map) map);
+size_t fptree_map_count(PMEMobjpool *pop, TOID(struct fptree_map) map);
+
+#endif /* FPTREE_MAP_H */
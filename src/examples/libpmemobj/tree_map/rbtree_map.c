@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2019, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * rbtree.c -- red-black tree implementation /w sentinel nodes
@@ -465,6 +465,44 @@ rbtree_map_foreach(PMEMobjpool *pop, TOID(struct rbtree_map) map,
 	return rbtree_map_foreach_node(map, RB_FIRST(map), cb, arg);
 }
 
+/*
+ * rbtree_map_range_node -- (internal) recursively traverses the part of
+ * the tree with keys from the range
+ */
+static int
+rbtree_map_range_node(TOID(struct rbtree_map) map,
+	TOID(struct tree_map_node) p, uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	if (TOID_EQUALS(p, D_RO(map)->sentinel))
+		return 0;
+
+	if (D_RO(p)->key > start && rbtree_map_range_node(map,
+			D_RO(p)->slots[RB_LEFT], start, end, cb, arg) != 0)
+		return 1;
+
+	if (D_RO(p)->key >= start && D_RO(p)->key <= end &&
+			cb(D_RO(p)->key, D_RO(p)->value, arg) != 0)
+		return 1;
+
+	if (D_RO(p)->key < end)
+		return rbtree_map_range_node(map,
+			D_RO(p)->slots[RB_RIGHT], start, end, cb, arg);
+
+	return 0;
+}
+
+/*
+ * rbtree_map_range -- traverses the keys from start to end in order
+ */
+int
+rbtree_map_range(PMEMobjpool *pop, TOID(struct rbtree_map) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg)
+{
+	return rbtree_map_range_node(map, RB_FIRST(map), start, end, cb, arg);
+}
+
 /*
  * rbtree_map_is_empty -- checks whether the tree map is empty
  */
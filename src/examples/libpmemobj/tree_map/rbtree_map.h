@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2015-2020, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * rbtree_map.h -- TreeMap sorted collection implementation
@@ -38,6 +38,9 @@ int rbtree_map_lookup(PMEMobjpool *pop, TOID(struct rbtree_map) map,
 		uint64_t key);
 int rbtree_map_foreach(PMEMobjpool *pop, TOID(struct rbtree_map) map,
 	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
+int rbtree_map_range(PMEMobjpool *pop, TOID(struct rbtree_map) map,
+	uint64_t start, uint64_t end,
+	int (*cb)(uint64_t key, PMEMoid value, void *arg), void *arg);
 int rbtree_map_is_empty(PMEMobjpool *pop, TOID(struct rbtree_map) map);
 
 #endif /* RBTREE_MAP_H */
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2019-2023, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * libpmem2.h -- definitions of libpmem2 entry points
@@ -58,6 +58,11 @@ extern "C" {
 #define PMEM2_E_FILE_DESCRIPTOR_NOT_SET		(-100035)
 #define PMEM2_E_SOURCE_TYPE_NOT_SUPPORTED	(-100036)
 #define PMEM2_E_IO_FAIL				(-100037)
+#define PMEM2_E_INVALID_STATS_SCOPE		(-100038)
+#define PMEM2_E_INVALID_FLUSH_FILTER_VALUE	(-100039)
+#define PMEM2_E_INVALID_MEM_THREADS		(-100040)
+#define PMEM2_E_INVALID_PREFAULT_VALUE		(-100041)
+#define PMEM2_E_INVALID_STATS_SIZE		(-100042)
 
 /* source setup */
 
@@ -154,6 +159,25 @@ int pmem2_config_set_protection(struct pmem2_config *cfg,
 int pmem2_config_set_vm_reservation(struct pmem2_config *cfg,
 	struct pmem2_vm_reservation *rsv, size_t offset);
 
+enum pmem2_flush_filter {
+    PMEM2_FLUSH_FILTER_DISABLED,
+    PMEM2_FLUSH_FILTER_ENABLED,
+};
+
+int pmem2_config_set_flush_filter(struct pmem2_config *cfg,
+	enum pmem2_flush_filter filter);
+
+int pmem2_config_set_mem_threads(struct pmem2_config *cfg, unsigned nthreads);
+
+enum pmem2_prefault {
+    PMEM2_PREFAULT_NONE,
+    PMEM2_PREFAULT_READ,
+    PMEM2_PREFAULT_WRITE,
+};
+
+int pmem2_config_set_prefault(struct pmem2_config *cfg,
+	enum pmem2_prefault prefault);
+
 /* mapping */
 struct pmem2_map;
 int pmem2_map_from_existing(struct pmem2_map **map,
@@ -217,6 +241,37 @@ pmem2_memcpy_fn pmem2_get_memcpy_fn(struct pmem2_map *map);
 
 pmem2_memset_fn pmem2_get_memset_fn(struct pmem2_map *map);
 
+/* statistics */
+
+#define PMEM2_STATS_MSYNC_HIST_BUCKETS	16
+
+struct pmem2_stats {
+    size_t size; /* set by the caller to sizeof(struct pmem2_stats) */
+    uint64_t memmove_nt_bytes;
+    uint64_t memmove_t_bytes;
+    uint64_t memset_nt_bytes;
+    uint64_t memset_t_bytes;
+    uint64_t flushed_lines;
+    uint64_t elided_lines;
+    uint64_t fences;
+    uint64_t msync_calls;
+    uint64_t msync_nsecs;
+    uint64_t msync_hist[PMEM2_STATS_MSYNC_HIST_BUCKETS];
+};
+
+enum pmem2_stats_scope {
+    PMEM2_STATS_THREAD,
+    PMEM2_STATS_PROCESS,
+};
+
+void pmem2_stats_enable(void);
+
+void pmem2_stats_disable(void);
+
+int pmem2_stats_get(struct pmem2_stats *stats, enum pmem2_stats_scope scope);
+
+int pmem2_stats_reset(enum pmem2_stats_scope scope);
+
 /* RAS */
 
 int pmem2_deep_flush(struct pmem2_map *map, void *ptr, size_t size);
@@ -228,6 +283,34 @@ int pmem2_source_device_usc(const struct pmem2_source *src, uint64_t *usc);
 
 int pmem2_source_numa_node(const struct pmem2_source *src, int *numa_node);
 
+enum pmem2_memory_type {
+    PMEM2_MEMORY_TYPE_UNKNOWN,
+    PMEM2_MEMORY_TYPE_DRAM,
+    PMEM2_MEMORY_TYPE_PMEM,
+    PMEM2_MEMORY_TYPE_CXL,
+};
+
+enum pmem2_persistence_domain {
+    PMEM2_PERSISTENCE_DOMAIN_UNKNOWN,
+    PMEM2_PERSISTENCE_DOMAIN_NONE,
+    PMEM2_PERSISTENCE_DOMAIN_MEMORY_CONTROLLER,
+    PMEM2_PERSISTENCE_DOMAIN_CPU_CACHE,
+};
+
+struct pmem2_memory_tier {
+    enum pmem2_memory_type type;
+    enum pmem2_persistence_domain persistence_domain;
+    int numa_node;
+    int tier;
+    uint64_t read_bandwidth;
+    uint64_t write_bandwidth;
+    uint64_t read_latency;
+    uint64_t write_latency;
+};
+
+int pmem2_source_memory_tier(const struct pmem2_source *src,
+	struct pmem2_memory_tier *tier);
+
 struct pmem2_badblock_context;
 
 struct pmem2_badblock {
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2016-2023, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * libpmempool.h -- definitions of libpmempool entry points
@@ -105,6 +105,15 @@ enum pmempool_check_result pmempool_check_end(PMEMpoolcheck *ppc);
  * do not apply changes, only check if operation is viable
  */
 #define PMEMPOOL_SYNC_DRY_RUN		(1U << 1)
+/*
+ * copy only the data which differs from the data in the healthy replica
+ */
+#define PMEMPOOL_SYNC_DIFFERENTIAL	(1U << 2)
+/*
+ * only recreate the replicas, their data is copied by libpmemobj
+ * in the background once the pool is opened
+ */
+#define PMEMPOOL_SYNC_ONLINE_REBUILD	(1U << 3)
 
 /*
  * LIBPMEMPOOL TRANSFORM
@@ -145,6 +154,7 @@ struct pmempool_check_argsU {
 	const char *backup_path;
 	enum pmempool_pool_type pool_type;
 	unsigned flags;
+	unsigned nthreads; /* threads verifying the heap, 0 for the default */
 };
 
 #define pmempool_check_args pmempool_check_argsU
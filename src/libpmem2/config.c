@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2019-2024, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * config.c -- pmem2_config implementation
@@ -9,6 +9,7 @@
 #include "alloc.h"
 #include "config.h"
 #include "libpmem2.h"
+#include "mem_parallel.h"
 #include "out.h"
 #include "pmem2.h"
 #include "pmem2_utils.h"
@@ -26,6 +27,9 @@ pmem2_config_init(struct pmem2_config *cfg)
 	cfg->protection_flag = PMEM2_PROT_READ | PMEM2_PROT_WRITE;
 	cfg->reserv = NULL;
 	cfg->reserv_offset = 0;
+	cfg->flush_filter = PMEM2_FLUSH_FILTER_DISABLED;
+	cfg->mem_threads = 1;
+	cfg->prefault = PMEM2_PREFAULT_NONE;
 }
 
 /*
@@ -177,6 +181,78 @@ pmem2_config_set_sharing(struct pmem2_config *cfg, enum pmem2_sharing_type type)
 	return 0;
 }
 
+/*
+ * pmem2_config_set_flush_filter -- set whether redundant cache line flushes
+ *                                  should be skipped
+ */
+int
+pmem2_config_set_flush_filter(struct pmem2_config *cfg,
+		enum pmem2_flush_filter filter)
+{
+	PMEM2_ERR_CLR();
+
+	switch (filter) {
+		case PMEM2_FLUSH_FILTER_DISABLED:
+		case PMEM2_FLUSH_FILTER_ENABLED:
+			cfg->flush_filter = filter;
+			break;
+		default:
+			ERR_WO_ERRNO("unknown flush filter value %d", filter);
+			return PMEM2_E_INVALID_FLUSH_FILTER_VALUE;
+	}
+
+	return 0;
+}
+
+/*
+ * pmem2_config_set_mem_threads -- set the number of threads used for writing
+ *                                 large ranges with mem[move|cpy|set]
+ */
+int
+pmem2_config_set_mem_threads(struct pmem2_config *cfg, unsigned nthreads)
+{
+	PMEM2_ERR_CLR();
+
+	if (nthreads == 0) {
+		ERR_WO_ERRNO("number of mem threads cannot be 0");
+		return PMEM2_E_INVALID_MEM_THREADS;
+	}
+
+	if (nthreads > MEM_PARALLEL_MAX_THREADS) {
+		LOG(3, "limiting number of mem threads to %u",
+			MEM_PARALLEL_MAX_THREADS);
+		nthreads = MEM_PARALLEL_MAX_THREADS;
+	}
+
+	cfg->mem_threads = nthreads;
+
+	return 0;
+}
+
+/*
+ * pmem2_config_set_prefault -- set whether pages of the mapping should be
+ *                              populated by pmem2_map_new
+ */
+int
+pmem2_config_set_prefault(struct pmem2_config *cfg,
+		enum pmem2_prefault prefault)
+{
+	PMEM2_ERR_CLR();
+
+	switch (prefault) {
+		case PMEM2_PREFAULT_NONE:
+		case PMEM2_PREFAULT_READ:
+		case PMEM2_PREFAULT_WRITE:
+			cfg->prefault = prefault;
+			break;
+		default:
+			ERR_WO_ERRNO("unknown prefault value %d", prefault);
+			return PMEM2_E_INVALID_PREFAULT_VALUE;
+	}
+
+	return 0;
+}
+
 /*
  * pmem2_config_set_vm_reservation -- set vm_reservation in the
  *                                    pmem2_config structure
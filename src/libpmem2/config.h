@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2019-2023, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * config.h -- internal definitions for pmem2_config
@@ -24,6 +24,9 @@ struct pmem2_config {
 	unsigned protection_flag;
 	struct pmem2_vm_reservation *reserv;
 	size_t reserv_offset;
+	enum pmem2_flush_filter flush_filter; /* skip redundant flushes */
+	unsigned mem_threads; /* threads used for large mem[move|set] */
+	enum pmem2_prefault prefault; /* populate pages of the mapping */
 };
 
 void pmem2_config_init(struct pmem2_config *cfg);
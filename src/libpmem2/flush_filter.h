@@ -0,0 +1,126 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * flush_filter.h -- filter of cache lines flushed since the last drain
+ *
+ * The filter is a small direct-mapped table of cache line addresses which
+ * were already flushed by the current thread and not yet drained. Each entry
+ * is tagged with the drain generation it was recorded in, so a drain empties
+ * the whole table just by bumping the generation.
+ */
+#ifndef PMEM2_FLUSH_FILTER_H
+#define PMEM2_FLUSH_FILTER_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLUSH_FILTER_SIZE 256 /* must be a power of two */
+
+struct flush_filter_entry {
+	uintptr_t line;
+	uint64_t gen;
+};
+
+struct flush_filter {
+	uint64_t gen;
+	struct flush_filter_entry entries[FLUSH_FILTER_SIZE];
+};
+
+/*
+ * flush_filter_entry -- return the slot a cache line maps to
+ */
+static inline struct flush_filter_entry *
+flush_filter_entry(struct flush_filter *f, uintptr_t line)
+{
+	return &f->entries[(line / CACHELINE_SIZE) & (FLUSH_FILTER_SIZE - 1)];
+}
+
+/*
+ * flush_filter_lines -- number of cache lines spanned by a range
+ */
+static inline size_t
+flush_filter_lines(uintptr_t begin, uintptr_t end)
+{
+	return (end - begin) / CACHELINE_SIZE;
+}
+
+/*
+ * flush_filter_test_and_set -- check whether the cache line was already
+ * flushed since the last drain and record it if it was not
+ */
+static inline int
+flush_filter_test_and_set(struct flush_filter *f, uintptr_t line)
+{
+	struct flush_filter_entry *e = flush_filter_entry(f, line);
+	if (e->line == line && e->gen == f->gen)
+		return 1;
+
+	e->line = line;
+	e->gen = f->gen;
+
+	return 0;
+}
+
+/*
+ * flush_filter_reset -- forget all recorded cache lines
+ */
+static inline void
+flush_filter_reset(struct flush_filter *f)
+{
+	f->gen++;
+}
+
+/*
+ * flush_filter_insert -- record all cache lines of a range as flushed
+ */
+static inline void
+flush_filter_insert(struct flush_filter *f, const void *addr, size_t len)
+{
+	uintptr_t begin = ALIGN_DOWN((uintptr_t)addr, CACHELINE_SIZE);
+	uintptr_t end = ALIGN_UP((uintptr_t)addr + len, CACHELINE_SIZE);
+
+	/* only the tail of a long range would survive in the table anyway */
+	if (flush_filter_lines(begin, end) > FLUSH_FILTER_SIZE)
+		begin = end - FLUSH_FILTER_SIZE * CACHELINE_SIZE;
+
+	for (uintptr_t line = begin; line < end; line += CACHELINE_SIZE) {
+		struct flush_filter_entry *e = flush_filter_entry(f, line);
+		e->line = line;
+		e->gen = f->gen;
+	}
+}
+
+/*
+ * flush_filter_invalidate -- forget cache lines of a range which was
+ * modified without being flushed
+ */
+static inline void
+flush_filter_invalidate(struct flush_filter *f, const void *addr, size_t len)
+{
+	uintptr_t begin = ALIGN_DOWN((uintptr_t)addr, CACHELINE_SIZE);
+	uintptr_t end = ALIGN_UP((uintptr_t)addr + len, CACHELINE_SIZE);
+
+	if (flush_filter_lines(begin, end) > FLUSH_FILTER_SIZE) {
+		flush_filter_reset(f);
+		return;
+	}
+
+	for (uintptr_t line = begin; line < end; line += CACHELINE_SIZE) {
+		struct flush_filter_entry *e = flush_filter_entry(f, line);
+		if (e->line == line)
+			e->gen = f->gen - 1;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2019-2020, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * libpmem2.c -- pmem2 library constructor & destructor
@@ -8,9 +8,11 @@
 #include "libpmem2.h"
 
 #include "map.h"
+#include "mem_parallel.h"
 #include "out.h"
 #include "persist.h"
 #include "pmem2.h"
+#include "stats.h"
 #include "util.h"
 
 /*
@@ -29,6 +31,8 @@ libpmem2_init(void)
 	LOG(3, NULL);
 
 	pmem2_map_init();
+	pmem2_stats_init();
+	pmem2_mem_parallel_init();
 	pmem2_persist_init();
 }
 
@@ -43,6 +47,8 @@ libpmem2_fini(void)
 {
 	LOG(3, NULL);
 
+	pmem2_mem_parallel_fini();
+	pmem2_stats_fini();
 	pmem2_map_fini();
 	out_fini();
 }
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2019-2024, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * map.c -- pmem2_map (common)
@@ -158,6 +158,7 @@ mapping_max(void *addr)
 static struct pmem2_state {
 	struct ravl_interval *range_map;
 	os_rwlock_t range_map_lock;
+	uint64_t generation; /* bumped every time a mapping is unregistered */
 } State;
 
 /*
@@ -216,6 +217,8 @@ pmem2_unregister_mapping(struct pmem2_map *map)
 	if (!(node && !ravl_interval_remove(State.range_map, node))) {
 		ERR_WO_ERRNO("Cannot find mapping %p to delete", map);
 		ret = PMEM2_E_MAPPING_NOT_FOUND;
+	} else {
+		util_fetch_and_add64(&State.generation, 1);
 	}
 
 	util_rwlock_unlock(&State.range_map_lock);
@@ -223,6 +226,20 @@ pmem2_unregister_mapping(struct pmem2_map *map)
 	return ret;
 }
 
+/*
+ * pmem2_map_generation -- return the number of mappings unregistered so far;
+ * a mapping found earlier is still valid if this number did not change
+ */
+uint64_t
+pmem2_map_generation(void)
+{
+	uint64_t generation;
+	util_atomic_load_explicit64(&State.generation, &generation,
+		memory_order_acquire);
+
+	return generation;
+}
+
 /*
  * pmem2_map_find -- find the earliest mapping overlapping with
  * (addr, addr+size) range
@@ -266,6 +283,10 @@ pmem2_map_from_existing(struct pmem2_map **map_ptr,
 	map->reserved_length = 0;
 	map->content_length = len;
 	map->effective_granularity = gran;
+	map->flush_filter = PMEM2_FLUSH_FILTER_DISABLED;
+	map->mem_threads = 1;
+	map->numa_node = -1;
+	map->memory_type = PMEM2_MEMORY_TYPE_UNKNOWN;
 	pmem2_set_flush_fns(map);
 	pmem2_set_mem_fns(map);
 	map->source = *src;
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2019-2023, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * map.h -- internal definitions for libpmem2
@@ -27,6 +27,13 @@ struct pmem2_map {
 	size_t content_length; /* length of the mapped content */
 	/* effective persistence granularity */
 	enum pmem2_granularity effective_granularity;
+	/* skip flushes of cache lines already flushed since the last drain */
+	enum pmem2_flush_filter flush_filter;
+	/* number of threads writing large ranges with mem[move|cpy|set] */
+	unsigned mem_threads;
+	int numa_node; /* node of the source, -1 if unknown */
+	/* type of the memory backing the mapping */
+	enum pmem2_memory_type memory_type;
 
 	pmem2_persist_fn persist_fn;
 	pmem2_flush_fn flush_fn;
@@ -44,6 +51,7 @@ struct pmem2_map {
 enum pmem2_granularity get_min_granularity(bool eADR, bool is_pmem,
 					enum pmem2_sharing_type sharing);
 struct pmem2_map *pmem2_map_find(const void *addr, size_t len);
+uint64_t pmem2_map_generation(void);
 int pmem2_register_mapping(struct pmem2_map *map);
 int pmem2_unregister_mapping(struct pmem2_map *map);
 void pmem2_map_init(void);
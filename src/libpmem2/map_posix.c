@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2019-2024, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * map_posix.c -- pmem2_map (POSIX)
@@ -19,6 +19,7 @@
 #include "map.h"
 #include "out.h"
 #include "persist.h"
+#include "prefault.h"
 #include "pmem2_utils.h"
 #include "source.h"
 #include "sys_util.h"
@@ -497,6 +498,17 @@ pmem2_map_new(struct pmem2_map **map_ptr, const struct pmem2_config *cfg,
 		goto err_undo_mapping;
 	}
 
+	if (cfg->prefault != PMEM2_PREFAULT_NONE && proto != PROT_NONE) {
+		/* a read-only mapping cannot be populated for writing */
+		int write = cfg->prefault == PMEM2_PREFAULT_WRITE &&
+			(proto & PROT_WRITE);
+
+		/* prefaulting is only an optimization, errors are not fatal */
+		size_t len = roundup(content_length, Pagesize);
+		if (pmem2_prefault_range(addr, len, write, cfg->mem_threads))
+			LOG(2, "cannot prefault the mapping");
+	}
+
 	/* prepare pmem2_map structure */
 	map = (struct pmem2_map *)pmem2_malloc(sizeof(*map), &ret);
 	if (!map)
@@ -506,6 +518,21 @@ pmem2_map_new(struct pmem2_map **map_ptr, const struct pmem2_config *cfg,
 	map->reserved_length = reserved_length;
 	map->content_length = content_length;
 	map->effective_granularity = available_min_granularity;
+	map->flush_filter = cfg->flush_filter;
+	map->mem_threads = cfg->mem_threads;
+	map->numa_node = -1;
+	if (map->mem_threads > 1 &&
+			pmem2_source_numa_node(src, &map->numa_node) != 0) {
+		LOG(3, "numa node of the source unknown");
+		map->numa_node = -1;
+	}
+	map->memory_type = PMEM2_MEMORY_TYPE_UNKNOWN;
+	if (src->type == PMEM2_SOURCE_FD &&
+			available_min_granularity != PMEM2_GRANULARITY_PAGE) {
+		struct pmem2_memory_tier tier;
+		if (pmem2_source_memory_tier(src, &tier) == 0)
+			map->memory_type = tier.type;
+	}
 	pmem2_set_flush_fns(map);
 	pmem2_set_mem_fns(map);
 	map->reserv = rsv;
@@ -0,0 +1,554 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * mem_parallel.c -- multi-threaded mem[move|cpy|set] of large ranges
+ *
+ * Ranges of at least Mem_parallel_threshold bytes, written through a mapping
+ * configured with more than one mem thread, are split into chunks which
+ * are processed by the calling thread and a pool of worker threads.
+ * The pool is shared by all mappings, created on first use and grown on
+ * demand. Only one range is processed by the pool at a time; concurrent
+ * callers fall back to the single-threaded path.
+ *
+ * Every worker drains its own stores before reporting completion, so that
+ * the caller's final drain covers the whole range.
+ *
+ * The workers do not exist in a child process, so the child starts with
+ * an empty pool, which is filled again on demand.
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "libpmem2.h"
+#include "map.h"
+#include "mem_parallel.h"
+#include "os.h"
+#include "os_thread.h"
+#include "out.h"
+#include "sys_util.h"
+#include "util.h"
+
+#define MEM_PARALLEL_THRESHOLD (32 << 20) /* 32 MiB */
+#define MEM_PARALLEL_MIN_THRESHOLD (2 * Pagesize)
+#define MEM_PARALLEL_CHUNK (4 << 20) /* 4 MiB */
+
+#define MEM_PARALLEL_NODE_ANY (-1) /* workers may run on any cpu */
+#define MEM_PARALLEL_NODE_UNKNOWN (-2) /* affinity of workers is unknown */
+
+#define NODE_CPULIST_PATH "/sys/devices/system/node/node%d/cpulist"
+#define NODE_CPULIST_LEN 1024
+
+size_t Mem_parallel_threshold = MEM_PARALLEL_THRESHOLD;
+
+enum mem_parallel_op {
+	MEM_PARALLEL_MEMMOVE,
+	MEM_PARALLEL_MEMSET,
+};
+
+struct mem_parallel_task {
+	enum mem_parallel_op op;
+	struct pmem2_map *map;
+	char *dest;
+	const char *src;
+	int c;
+	size_t len;
+	unsigned flags;
+
+	uintptr_t base; /* chunk-aligned address below dest */
+	size_t chunk;
+	uint64_t nchunks;
+	uint64_t next; /* index of the next chunk to process */
+
+	/* protected by the pool lock */
+	unsigned max_workers; /* number of workers allowed to join */
+	unsigned joined; /* number of workers which joined */
+	unsigned active; /* number of workers still processing */
+	int closed; /* no more workers may join */
+};
+
+static struct {
+	os_mutex_t submit_lock; /* serializes tasks */
+	os_mutex_t lock;
+	os_cond_t work_cond;
+	os_cond_t done_cond;
+
+	struct mem_parallel_task *task;
+	uint64_t task_gen;
+	int terminate;
+
+	unsigned nthreads;
+	int numa_node; /* node the workers are bound to */
+	os_thread_t threads[MEM_PARALLEL_MAX_THREADS - 1];
+} Pool;
+
+/*
+ * mem_parallel_run -- (internal) process chunks until none are left
+ */
+static void
+mem_parallel_run(struct mem_parallel_task *t)
+{
+	uintptr_t dest = (uintptr_t)t->dest;
+	uintptr_t dest_end = dest + t->len;
+	unsigned flags = t->flags | PMEM2_F_MEM_NODRAIN;
+	uint64_t i;
+
+	while ((i = util_fetch_and_add64(&t->next, 1)) < t->nchunks) {
+		uintptr_t begin = t->base + i * t->chunk;
+		uintptr_t end = begin + t->chunk;
+		if (begin < dest)
+			begin = dest;
+		if (end > dest_end)
+			end = dest_end;
+
+		size_t off = begin - dest;
+		if (t->op == MEM_PARALLEL_MEMMOVE)
+			t->map->memmove_fn(t->dest + off, t->src + off,
+				end - begin, flags);
+		else
+			t->map->memset_fn(t->dest + off, t->c,
+				end - begin, flags);
+	}
+}
+
+/*
+ * mem_parallel_worker -- (internal) worker thread main loop
+ */
+static void *
+mem_parallel_worker(void *arg)
+{
+	SUPPRESS_UNUSED(arg);
+
+	util_mutex_lock(&Pool.lock);
+	uint64_t seen = Pool.task_gen;
+
+	while (1) {
+		while (!Pool.terminate &&
+				(Pool.task == NULL || Pool.task_gen == seen))
+			os_cond_wait(&Pool.work_cond, &Pool.lock);
+
+		if (Pool.terminate)
+			break;
+
+		seen = Pool.task_gen;
+		struct mem_parallel_task *t = Pool.task;
+		if (t->closed || t->joined == t->max_workers)
+			continue;
+
+		t->joined++;
+		t->active++;
+		util_mutex_unlock(&Pool.lock);
+
+		mem_parallel_run(t);
+		if (!(t->flags & PMEM2_F_MEM_NOFLUSH))
+			t->map->drain_fn();
+
+		util_mutex_lock(&Pool.lock);
+		if (--t->active == 0 && t->closed)
+			os_cond_signal(&Pool.done_cond);
+	}
+
+	util_mutex_unlock(&Pool.lock);
+
+	return NULL;
+}
+
+/*
+ * mem_parallel_node_cpus -- (internal) read the set of cpus of a NUMA node
+ */
+static int
+mem_parallel_node_cpus(int node, os_cpu_set_t *set)
+{
+	char path[PATH_MAX];
+	char list[NODE_CPULIST_LEN];
+
+	if (util_snprintf(path, PATH_MAX, NODE_CPULIST_PATH, node) < 0)
+		return -1;
+
+	int fd = os_open(path, O_RDONLY);
+	if (fd < 0) {
+		LOG(3, "cannot open %s", path);
+		return -1;
+	}
+
+	ssize_t len = read(fd, list, NODE_CPULIST_LEN - 1);
+	os_close(fd);
+	if (len <= 0)
+		return -1;
+	list[len] = '\0';
+
+	/* the list looks like "0-3,8-11" */
+	os_cpu_zero(set);
+	int ncpus = 0;
+	char *p = list;
+	while (*p != '\0' && *p != '\n') {
+		char *end;
+		unsigned long first = strtoul(p, &end, 10);
+		if (end == p)
+			return -1;
+
+		unsigned long last = first;
+		if (*end == '-') {
+			p = end + 1;
+			last = strtoul(p, &end, 10);
+			if (end == p || last < first)
+				return -1;
+		}
+
+		for (unsigned long cpu = first; cpu <= last; ++cpu) {
+			if (cpu >= sizeof(os_cpu_set_t) * 8)
+				return -1;
+			os_cpu_set(cpu, set);
+			ncpus++;
+		}
+
+		p = (*end == ',') ? end + 1 : end;
+	}
+
+	return ncpus > 0 ? 0 : -1;
+}
+
+/*
+ * mem_parallel_bind -- (internal) move workers to cpus of the given node,
+ * must be called with the pool lock held
+ */
+static void
+mem_parallel_bind(int node)
+{
+	if (node == Pool.numa_node)
+		return;
+
+	os_cpu_set_t set;
+	if (node == MEM_PARALLEL_NODE_ANY ||
+			mem_parallel_node_cpus(node, &set) != 0) {
+		long ncpus = sysconf(_SC_NPROCESSORS_CONF);
+		if (ncpus <= 0 || (size_t)ncpus > sizeof(set) * 8)
+			ncpus = (long)sizeof(set) * 8;
+
+		os_cpu_zero(&set);
+		for (long cpu = 0; cpu < ncpus; ++cpu)
+			os_cpu_set((size_t)cpu, &set);
+
+		node = MEM_PARALLEL_NODE_ANY;
+	}
+
+	for (unsigned i = 0; i < Pool.nthreads; ++i) {
+		int ret = os_thread_setaffinity_np(&Pool.threads[i],
+			sizeof(set), &set);
+		if (ret != 0)
+			LOG(3, "cannot set affinity of worker %u: %d", i, ret);
+	}
+
+	LOG(3, "workers bound to node %d", node);
+	Pool.numa_node = node;
+}
+
+/*
+ * mem_parallel_grow -- (internal) make sure the pool has enough workers,
+ * must be called with the pool lock held
+ */
+static unsigned
+mem_parallel_grow(unsigned nworkers)
+{
+	if (nworkers > MEM_PARALLEL_MAX_THREADS - 1)
+		nworkers = MEM_PARALLEL_MAX_THREADS - 1;
+
+	while (Pool.nthreads < nworkers) {
+		int ret = os_thread_create(&Pool.threads[Pool.nthreads], NULL,
+			mem_parallel_worker, NULL);
+		if (ret != 0) {
+			LOG(3, "cannot create a worker thread: %d", ret);
+			break;
+		}
+
+		Pool.nthreads++;
+		/* new threads inherit the affinity of the caller */
+		Pool.numa_node = MEM_PARALLEL_NODE_UNKNOWN;
+	}
+
+	return nworkers < Pool.nthreads ? nworkers : Pool.nthreads;
+}
+
+/*
+ * mem_parallel_execute -- (internal) process the task using the calling
+ * thread and the worker pool
+ */
+static int
+mem_parallel_execute(struct mem_parallel_task *t)
+{
+	struct pmem2_map *map = t->map;
+
+	/* the pool is busy with another range, do not wait for it */
+	if (util_mutex_trylock(&Pool.submit_lock) != 0)
+		return 1;
+
+	util_mutex_lock(&Pool.lock);
+
+	t->max_workers = mem_parallel_grow(map->mem_threads - 1);
+	if (t->max_workers == 0) {
+		util_mutex_unlock(&Pool.lock);
+		util_mutex_unlock(&Pool.submit_lock);
+		return 1;
+	}
+
+	mem_parallel_bind(map->numa_node);
+
+	Pool.task = t;
+	Pool.task_gen++;
+	os_cond_broadcast(&Pool.work_cond);
+	util_mutex_unlock(&Pool.lock);
+
+	mem_parallel_run(t);
+
+	util_mutex_lock(&Pool.lock);
+	t->closed = 1;
+	while (t->active > 0)
+		os_cond_wait(&Pool.done_cond, &Pool.lock);
+	Pool.task = NULL;
+	util_mutex_unlock(&Pool.lock);
+
+	util_mutex_unlock(&Pool.submit_lock);
+
+	LOG(15, "range %p len %zu split into %" PRIu64 " chunks, %u workers",
+		t->dest, t->len, t->nchunks, t->joined);
+
+	if ((t->flags & (PMEM2_F_MEM_NODRAIN | PMEM2_F_MEM_NOFLUSH)) == 0)
+		map->drain_fn();
+
+	return 0;
+}
+
+/*
+ * the mapping found by the last mem_parallel_map call of this thread,
+ * saves the lookup under the registry lock when the same mapping
+ * is written again
+ */
+static __thread struct {
+	struct pmem2_map *map;
+	uint64_t generation; /* of the registry when the mapping was found */
+} Last_map;
+
+/*
+ * mem_parallel_contains -- (internal) check if the mapping contains
+ * the whole range
+ */
+static inline int
+mem_parallel_contains(const struct pmem2_map *map, const void *pmemdest,
+		size_t len)
+{
+	uintptr_t begin = (uintptr_t)map->addr;
+	uintptr_t end = begin + map->content_length;
+
+	return (uintptr_t)pmemdest >= begin && (uintptr_t)pmemdest + len <= end;
+}
+
+/*
+ * mem_parallel_map -- (internal) find the mapping which contains the whole
+ * range and allows multi-threaded writes
+ */
+static struct pmem2_map *
+mem_parallel_map(const void *pmemdest, size_t len)
+{
+	/* read before the lookup, so a concurrent unregister is noticed */
+	uint64_t generation = pmem2_map_generation();
+
+	struct pmem2_map *map = Last_map.map;
+	if (map == NULL || Last_map.generation != generation ||
+			!mem_parallel_contains(map, pmemdest, len)) {
+		map = pmem2_map_find(pmemdest, len);
+		if (map == NULL || !mem_parallel_contains(map, pmemdest, len))
+			return NULL;
+
+		Last_map.map = map;
+		Last_map.generation = generation;
+	}
+
+	if (map->mem_threads < 2)
+		return NULL;
+
+	return map;
+}
+
+/*
+ * mem_parallel_task_init -- (internal) split the destination range
+ */
+static void
+mem_parallel_task_init(struct mem_parallel_task *t, struct pmem2_map *map,
+		void *pmemdest, size_t len, unsigned flags)
+{
+	/* chunks have to be smaller than the threshold to avoid recursion */
+	size_t chunk = MEM_PARALLEL_CHUNK;
+	if (chunk >= Mem_parallel_threshold)
+		chunk = ALIGN_DOWN(Mem_parallel_threshold / 2, Pagesize);
+
+	t->map = map;
+	t->dest = pmemdest;
+	t->len = len;
+	t->flags = flags;
+	t->chunk = chunk;
+	t->base = ALIGN_DOWN((uintptr_t)pmemdest, chunk);
+	t->nchunks = (ALIGN_UP((uintptr_t)pmemdest + len, chunk) - t->base) /
+		chunk;
+	t->next = 0;
+	t->max_workers = 0;
+	t->joined = 0;
+	t->active = 0;
+	t->closed = 0;
+}
+
+/*
+ * pmem2_memmove_parallel -- mem[move|cpy] a large range using multiple
+ * threads; returns 0 if the range was written or 1 if the caller should
+ * fall back to the single-threaded path
+ */
+int
+pmem2_memmove_parallel(void *pmemdest, const void *src, size_t len,
+		unsigned flags)
+{
+	/* chunks of overlapping ranges cannot be copied in any order */
+	if ((uintptr_t)src < (uintptr_t)pmemdest + len &&
+			(uintptr_t)pmemdest < (uintptr_t)src + len)
+		return 1;
+
+	struct pmem2_map *map = mem_parallel_map(pmemdest, len);
+	if (map == NULL)
+		return 1;
+
+	struct mem_parallel_task t;
+	mem_parallel_task_init(&t, map, pmemdest, len, flags);
+	t.op = MEM_PARALLEL_MEMMOVE;
+	t.src = src;
+	t.c = 0;
+
+	return mem_parallel_execute(&t);
+}
+
+/*
+ * pmem2_memset_parallel -- memset a large range using multiple threads;
+ * returns 0 if the range was written or 1 if the caller should fall back
+ * to the single-threaded path
+ */
+int
+pmem2_memset_parallel(void *pmemdest, int c, size_t len, unsigned flags)
+{
+	struct pmem2_map *map = mem_parallel_map(pmemdest, len);
+	if (map == NULL)
+		return 1;
+
+	struct mem_parallel_task t;
+	mem_parallel_task_init(&t, map, pmemdest, len, flags);
+	t.op = MEM_PARALLEL_MEMSET;
+	t.src = NULL;
+	t.c = c;
+
+	return mem_parallel_execute(&t);
+}
+
+/*
+ * mem_parallel_pool_init -- (internal) initialize an empty worker pool
+ */
+static void
+mem_parallel_pool_init(void)
+{
+	util_mutex_init(&Pool.submit_lock);
+	util_mutex_init(&Pool.lock);
+	util_cond_init(&Pool.work_cond);
+	util_cond_init(&Pool.done_cond);
+
+	Pool.task = NULL;
+	Pool.task_gen = 0;
+	Pool.terminate = 0;
+	Pool.nthreads = 0;
+	Pool.numa_node = MEM_PARALLEL_NODE_UNKNOWN;
+}
+
+/*
+ * mem_parallel_prefork -- (internal) keep the pool lock over fork, so
+ * the child does not see the pool in the middle of an update
+ */
+static void
+mem_parallel_prefork(void)
+{
+	util_mutex_lock(&Pool.lock);
+}
+
+/*
+ * mem_parallel_postfork_parent -- (internal) release the pool lock after
+ * fork in the parent
+ */
+static void
+mem_parallel_postfork_parent(void)
+{
+	util_mutex_unlock(&Pool.lock);
+}
+
+/*
+ * mem_parallel_postfork_child -- (internal) forget the workers of
+ * the parent, the locks and the condition variables may be in use by its
+ * threads, which do not exist in the child, so they are initialized again
+ */
+static void
+mem_parallel_postfork_child(void)
+{
+	mem_parallel_pool_init();
+}
+
+/*
+ * pmem2_mem_parallel_init -- initialize the worker pool
+ */
+void
+pmem2_mem_parallel_init(void)
+{
+	mem_parallel_pool_init();
+
+	int ret = os_thread_atfork(mem_parallel_prefork,
+		mem_parallel_postfork_parent, mem_parallel_postfork_child);
+	if (ret != 0) {
+		errno = ret;
+		CORE_LOG_FATAL_W_ERRNO("os_thread_atfork");
+	}
+
+	/*
+	 * For testing and platform tuning default threshold can be overridden
+	 * using PMEM2_PARALLEL_THRESHOLD env variable.
+	 */
+	const char *ptr = os_getenv("PMEM2_PARALLEL_THRESHOLD");
+	if (ptr) {
+		long long val = atoll(ptr);
+
+		if (val < (long long)MEM_PARALLEL_MIN_THRESHOLD) {
+			LOG(3, "Invalid PMEM2_PARALLEL_THRESHOLD");
+		} else {
+			LOG(3, "PMEM2_PARALLEL_THRESHOLD set to %zu",
+				(size_t)val);
+			Mem_parallel_threshold = (size_t)val;
+		}
+	}
+}
+
+/*
+ * pmem2_mem_parallel_fini -- stop and join all workers
+ */
+void
+pmem2_mem_parallel_fini(void)
+{
+	util_mutex_lock(&Pool.lock);
+	Pool.terminate = 1;
+	os_cond_broadcast(&Pool.work_cond);
+	util_mutex_unlock(&Pool.lock);
+
+	for (unsigned i = 0; i < Pool.nthreads; ++i)
+		os_thread_join(&Pool.threads[i], NULL);
+	Pool.nthreads = 0;
+
+	util_cond_destroy(&Pool.done_cond);
+	util_cond_destroy(&Pool.work_cond);
+	util_mutex_destroy(&Pool.lock);
+	util_mutex_destroy(&Pool.submit_lock);
+}
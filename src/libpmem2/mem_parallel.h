@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * mem_parallel.h -- internal definitions for multi-threaded mem[move|set]
+ */
+#ifndef PMEM2_MEM_PARALLEL_H
+#define PMEM2_MEM_PARALLEL_H 1
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* maximum number of threads (including the caller) working on one range */
+#define MEM_PARALLEL_MAX_THREADS 64
+
+extern size_t Mem_parallel_threshold;
+
+void pmem2_mem_parallel_init(void);
+void pmem2_mem_parallel_fini(void);
+
+int pmem2_memmove_parallel(void *pmemdest, const void *src, size_t len,
+		unsigned flags);
+int pmem2_memset_parallel(void *pmemdest, int c, size_t len, unsigned flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
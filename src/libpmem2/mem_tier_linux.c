@@ -0,0 +1,383 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * mem_tier_linux.c -- detection of the memory tier backing a source
+ *
+ * The device backing the source (a device dax or the block device of
+ * the file system) is looked up in sysfs and its ancestors are searched for
+ * an nvdimm region and for CXL devices. The NUMA node of the memory is then
+ * used to read the HMAT performance attributes and the kernel memory tier.
+ */
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include "libpmem2.h"
+#include "os.h"
+#include "out.h"
+#include "pmem2_utils.h"
+#include "source.h"
+
+#define SYSFS_PATH "/sys"
+#define DEV_CHAR_FORMAT SYSFS_PATH "/dev/char/%u:%u"
+#define DEV_BLOCK_FORMAT SYSFS_PATH "/dev/block/%u:%u"
+#define NODE_FORMAT SYSFS_PATH "/devices/system/node/node%d"
+#define INITIATORS "access0/initiators"
+#define MEMORY_TIERING_PATH SYSFS_PATH "/devices/virtual/memory_tiering"
+#define MEMORY_TIER_PREFIX "memory_tier"
+
+#define ATTR_VALUE_LEN 1024
+
+/*
+ * mem_tier_read_attr -- (internal) read a sysfs attribute without
+ * the trailing new line
+ */
+static int
+mem_tier_read_attr(const char *dir, const char *name, char *buf, size_t len)
+{
+	char path[PATH_MAX];
+	if (util_snprintf(path, PATH_MAX, "%s/%s", dir, name) < 0)
+		return -1;
+
+	int fd = os_open(path, O_RDONLY);
+	if (fd < 0) {
+		LOG(4, "cannot open %s", path);
+		return -1;
+	}
+
+	ssize_t ret = read(fd, buf, len - 1);
+	os_close(fd);
+	if (ret < 0) {
+		LOG(4, "cannot read %s", path);
+		return -1;
+	}
+
+	buf[ret] = '\0';
+	if (ret > 0 && buf[ret - 1] == '\n')
+		buf[ret - 1] = '\0';
+
+	LOG(15, "%s: \"%s\"", path, buf);
+
+	return 0;
+}
+
+/*
+ * mem_tier_read_long -- (internal) read a numeric sysfs attribute
+ */
+static int
+mem_tier_read_long(const char *dir, const char *name, long long *val)
+{
+	char buf[ATTR_VALUE_LEN];
+	if (mem_tier_read_attr(dir, name, buf, sizeof(buf)))
+		return -1;
+
+	char *end;
+	*val = strtoll(buf, &end, 10);
+	if (end == buf || *end != '\0')
+		return -1;
+
+	return 0;
+}
+
+/*
+ * mem_tier_read_u64 -- (internal) read a non-negative sysfs attribute,
+ * the value is left untouched if the attribute is not available
+ */
+static void
+mem_tier_read_u64(const char *dir, const char *name, uint64_t *val)
+{
+	long long v;
+	if (mem_tier_read_long(dir, name, &v) == 0 && v >= 0)
+		*val = (uint64_t)v;
+}
+
+/*
+ * mem_tier_read_node -- (internal) read an attribute holding a NUMA node,
+ * the node is left untouched if it is not available
+ */
+static void
+mem_tier_read_node(const char *dir, const char *name, int *node)
+{
+	long long v;
+	if (mem_tier_read_long(dir, name, &v) == 0 && v >= 0 && v <= INT_MAX)
+		*node = (int)v;
+}
+
+/*
+ * mem_tier_list_contains -- (internal) check if a list like "0-3,8"
+ * contains the given number
+ */
+static int
+mem_tier_list_contains(const char *list, int n)
+{
+	const char *p = list;
+	while (*p != '\0') {
+		char *end;
+		long first = strtol(p, &end, 10);
+		if (end == p)
+			return 0;
+
+		long last = first;
+		if (*end == '-') {
+			p = end + 1;
+			last = strtol(p, &end, 10);
+			if (end == p)
+				return 0;
+		}
+
+		if (n >= first && n <= last)
+			return 1;
+
+		if (*end != ',')
+			return 0;
+		p = end + 1;
+	}
+
+	return 0;
+}
+
+/*
+ * mem_tier_subsystem -- (internal) get the name of the bus or class
+ * the sysfs device belongs to
+ */
+static int
+mem_tier_subsystem(const char *dir, char *name, size_t len)
+{
+	char path[PATH_MAX];
+	char rpath[PATH_MAX];
+
+	if (util_snprintf(path, PATH_MAX, "%s/subsystem", dir) < 0)
+		return -1;
+
+	if (realpath(path, rpath) == NULL)
+		return -1;
+
+	const char *base = strrchr(rpath, '/');
+	if (base == NULL)
+		return -1;
+
+	if (util_snprintf(name, len, "%s", base + 1) < 0)
+		return -1;
+
+	return 0;
+}
+
+/*
+ * mem_tier_device_path -- (internal) find the sysfs directory of
+ * the device backing the source
+ */
+static int
+mem_tier_device_path(const struct pmem2_source *src, char *path)
+{
+	char dev[PATH_MAX];
+	int ret;
+
+	if (src->value.ftype == PMEM2_FTYPE_DEVDAX) {
+		ret = util_snprintf(dev, PATH_MAX, DEV_CHAR_FORMAT,
+			os_major(src->value.st_rdev),
+			os_minor(src->value.st_rdev));
+	} else {
+		ret = util_snprintf(dev, PATH_MAX, DEV_BLOCK_FORMAT,
+			os_major(src->value.st_dev),
+			os_minor(src->value.st_dev));
+	}
+	if (ret < 0)
+		return -1;
+
+	if (realpath(dev, path) == NULL) {
+		LOG(3, "no sysfs entry for the device: %s", dev);
+		return -1;
+	}
+
+	/* a partition has the same ancestors as the whole disk */
+	char attr[ATTR_VALUE_LEN];
+	if (src->value.ftype != PMEM2_FTYPE_DEVDAX &&
+			mem_tier_read_attr(path, "partition", attr,
+			sizeof(attr)) == 0) {
+		char *base = strrchr(path, '/');
+		if (base == NULL || base == path)
+			return -1;
+		*base = '\0';
+	}
+
+	return 0;
+}
+
+/*
+ * mem_tier_parse_domain -- (internal) parse persistence_domain attribute
+ * of an nvdimm region
+ */
+static enum pmem2_persistence_domain
+mem_tier_parse_domain(const char *domain)
+{
+	if (strcmp(domain, "cpu_cache") == 0)
+		return PMEM2_PERSISTENCE_DOMAIN_CPU_CACHE;
+	if (strcmp(domain, "memory_controller") == 0)
+		return PMEM2_PERSISTENCE_DOMAIN_MEMORY_CONTROLLER;
+
+	return PMEM2_PERSISTENCE_DOMAIN_NONE;
+}
+
+/*
+ * mem_tier_node_tier -- (internal) find the kernel memory tier of the node
+ */
+static int
+mem_tier_node_tier(int node)
+{
+	DIR *dir = opendir(MEMORY_TIERING_PATH);
+	if (dir == NULL) {
+		LOG(4, "memory tiering not available");
+		return -1;
+	}
+
+	char path[PATH_MAX];
+	char list[ATTR_VALUE_LEN];
+	int tier = -1;
+	struct dirent *d;
+
+	while ((d = readdir(dir)) != NULL) {
+		if (strncmp(d->d_name, MEMORY_TIER_PREFIX,
+				strlen(MEMORY_TIER_PREFIX)) != 0)
+			continue;
+
+		if (util_snprintf(path, PATH_MAX, MEMORY_TIERING_PATH "/%s",
+				d->d_name) < 0)
+			continue;
+
+		if (mem_tier_read_attr(path, "nodelist", list, sizeof(list)))
+			continue;
+
+		if (mem_tier_list_contains(list, node)) {
+			tier = atoi(d->d_name + strlen(MEMORY_TIER_PREFIX));
+			break;
+		}
+	}
+
+	closedir(dir);
+
+	return tier;
+}
+
+/*
+ * mem_tier_node_info -- (internal) read performance attributes of the node,
+ * returns 1 if the node has cpus
+ */
+static int
+mem_tier_node_info(int node, struct pmem2_memory_tier *tier)
+{
+	char path[PATH_MAX];
+	char cpulist[ATTR_VALUE_LEN];
+
+	if (util_snprintf(path, PATH_MAX, NODE_FORMAT "/" INITIATORS,
+			node) < 0)
+		return 0;
+
+	mem_tier_read_u64(path, "read_bandwidth", &tier->read_bandwidth);
+	mem_tier_read_u64(path, "write_bandwidth", &tier->write_bandwidth);
+	mem_tier_read_u64(path, "read_latency", &tier->read_latency);
+	mem_tier_read_u64(path, "write_latency", &tier->write_latency);
+
+	tier->tier = mem_tier_node_tier(node);
+
+	if (util_snprintf(path, PATH_MAX, NODE_FORMAT, node) < 0)
+		return 0;
+
+	if (mem_tier_read_attr(path, "cpulist", cpulist, sizeof(cpulist)))
+		return 0;
+
+	return cpulist[0] != '\0';
+}
+
+/*
+ * pmem2_source_memory_tier -- describe the memory backing the source
+ */
+int
+pmem2_source_memory_tier(const struct pmem2_source *src,
+		struct pmem2_memory_tier *tier)
+{
+	PMEM2_ERR_CLR();
+	LOG(3, "src %p tier %p", src, tier);
+
+	if (src->type == PMEM2_SOURCE_ANON) {
+		ERR_WO_ERRNO(
+			"Anonymous sources are not backed by a memory device.");
+		return PMEM2_E_SOURCE_TYPE_NOT_SUPPORTED;
+	}
+
+	ASSERTeq(src->type, PMEM2_SOURCE_FD);
+
+	memset(tier, 0, sizeof(*tier));
+	tier->type = PMEM2_MEMORY_TYPE_UNKNOWN;
+	tier->persistence_domain = PMEM2_PERSISTENCE_DOMAIN_UNKNOWN;
+	tier->numa_node = -1;
+	tier->tier = -1;
+
+	char path[PATH_MAX];
+	if (mem_tier_device_path(src, path))
+		return 0;
+
+	/* device dax reports the node its memory was onlined to */
+	mem_tier_read_node(path, "target_node", &tier->numa_node);
+
+	int cxl = 0;
+	int nd_region = 0;
+	char subsys[NAME_MAX];
+	char domain[ATTR_VALUE_LEN];
+
+	/* walk up the device hierarchy, until the root of the devices tree */
+	char *base;
+	while ((base = strrchr(path, '/')) != NULL && base != path &&
+			strcmp(base + 1, "devices") != 0) {
+		if (mem_tier_subsystem(path, subsys, sizeof(subsys)) == 0) {
+			if (strcmp(subsys, "cxl") == 0) {
+				cxl = 1;
+			} else if (!nd_region && strcmp(subsys, "nd") == 0 &&
+					strncmp(base + 1, "region", 6) == 0) {
+				nd_region = 1;
+
+				if (mem_tier_read_attr(path,
+						"persistence_domain", domain,
+						sizeof(domain)) == 0)
+					tier->persistence_domain =
+						mem_tier_parse_domain(domain);
+
+				if (tier->numa_node < 0)
+					mem_tier_read_node(path, "target_node",
+						&tier->numa_node);
+				if (tier->numa_node < 0)
+					mem_tier_read_node(path, "numa_node",
+						&tier->numa_node);
+			}
+		}
+
+		*base = '\0';
+	}
+
+	int has_cpus = 0;
+	if (tier->numa_node >= 0)
+		has_cpus = mem_tier_node_info(tier->numa_node, tier);
+
+	if (cxl)
+		tier->type = PMEM2_MEMORY_TYPE_CXL;
+	else if (nd_region)
+		tier->type = PMEM2_MEMORY_TYPE_PMEM;
+	else if (has_cpus)
+		tier->type = PMEM2_MEMORY_TYPE_DRAM;
+
+	/* without an nvdimm region the memory is not persistent */
+	if (!nd_region && tier->type != PMEM2_MEMORY_TYPE_UNKNOWN)
+		tier->persistence_domain = PMEM2_PERSISTENCE_DOMAIN_NONE;
+
+	LOG(3, "type %d domain %d node %d tier %d", tier->type,
+		tier->persistence_domain, tier->numa_node, tier->tier);
+
+	return 0;
+}
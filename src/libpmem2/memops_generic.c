@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2018-2022, Intel Corporation */
+/* Copyright 2018-2026, Intel Corporation */
 
 /*
  * memops_generic.c -- architecture-independent memmove & memset fallback
@@ -16,6 +16,7 @@
 
 #include "out.h"
 #include "pmem2_arch.h"
+#include "stats.h"
 #include "util.h"
 
 /*
@@ -143,6 +144,10 @@ memmove_nodrain_generic(void *dst, const void *src, size_t len, unsigned flags,
 	size_t remaining;
 	(void) flags;
 
+	PMEM2_STATS_INC(memmove_t_bytes, len);
+	if (!(flags & PMEM2_F_MEM_NOFLUSH))
+		PMEM2_STATS_FLUSH(dst, len);
+
 	if ((uintptr_t)cdst - (uintptr_t)csrc >= len) {
 		size_t cnt = (uint64_t)cdst & 7;
 		if (cnt > 0) {
@@ -270,6 +275,10 @@ memset_nodrain_generic(void *dst, int c, size_t len, unsigned flags,
 
 	(void) flags;
 
+	PMEM2_STATS_INC(memset_t_bytes, len);
+	if (!(flags & PMEM2_F_MEM_NOFLUSH))
+		PMEM2_STATS_FLUSH(dst, len);
+
 	char *cdst = dst;
 	size_t cnt = (uint64_t)cdst & 7;
 	if (cnt > 0) {
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2019-2024, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * persist.c -- pmem2_get_[persist|flush|drain]_fn
@@ -11,16 +11,30 @@
 #include "libpmem2.h"
 #include "libpmem2/base.h"
 #include "map.h"
+#include "mem_parallel.h"
 #include "out.h"
 #include "os.h"
 #include "persist.h"
 #include "deep_flush.h"
+#include "flush_filter.h"
 #include "pmem2_arch.h"
 #include "pmem2_utils.h"
+#include "stats.h"
 #include "valgrind_internal.h"
 
 static struct pmem2_arch_info Info;
 
+/*
+ * default minimum length of the writes to memory attached through CXL
+ * which use non-temporal stores
+ */
+#define MOVNT_THRESHOLD_FAR CACHELINE_SIZE
+
+static size_t Movnt_threshold_far = MOVNT_THRESHOLD_FAR;
+
+/* cache lines flushed by the current thread since its last drain */
+static __thread struct flush_filter Flush_filter;
+
 /*
  * memmove_nodrain_libc -- (internal) memmove to pmem using libc
  */
@@ -39,9 +53,12 @@ memmove_nodrain_libc(void *pmemdest, const void *src, size_t len,
 	SUPPRESS_UNUSED(memmove_funcs);
 
 	memmove(pmemdest, src, len);
+	PMEM2_STATS_INC(memmove_t_bytes, len);
 
-	if (!(flags & PMEM2_F_MEM_NOFLUSH))
+	if (!(flags & PMEM2_F_MEM_NOFLUSH)) {
 		flush(pmemdest, len);
+		PMEM2_STATS_FLUSH(pmemdest, len);
+	}
 
 	return pmemdest;
 }
@@ -63,9 +80,12 @@ memset_nodrain_libc(void *pmemdest, int c, size_t len, unsigned flags,
 	SUPPRESS_UNUSED(memset_funcs);
 
 	memset(pmemdest, c, len);
+	PMEM2_STATS_INC(memset_t_bytes, len);
 
-	if (!(flags & PMEM2_F_MEM_NOFLUSH))
+	if (!(flags & PMEM2_F_MEM_NOFLUSH)) {
 		flush(pmemdest, len);
+		PMEM2_STATS_FLUSH(pmemdest, len);
+	}
 
 	return pmemdest;
 }
@@ -114,6 +134,18 @@ pmem2_persist_init(void)
 			LOG(3, "using generic memset");
 		}
 	}
+
+	/*
+	 * PMEM_MOVNT_THRESHOLD overrides the threshold for all the memory
+	 * types, the architecture code reads it for the other ones.
+	 */
+	ptr = os_getenv("PMEM_MOVNT_THRESHOLD");
+	if (ptr) {
+		long long val = atoll(ptr);
+
+		if (val >= 0)
+			Movnt_threshold_far = (size_t)val;
+	}
 }
 
 /*
@@ -125,6 +157,8 @@ pmem2_drain(void)
 	LOG(15, NULL);
 
 	Info.fence();
+	flush_filter_reset(&Flush_filter);
+	PMEM2_STATS_INC(fences, 1);
 }
 
 /*
@@ -160,6 +194,46 @@ pmem2_flush_cpu_cache(const void *addr, size_t len)
 	pmem2_log_flush(addr, len);
 
 	Info.flush(addr, len);
+	PMEM2_STATS_FLUSH(addr, len);
+}
+
+/*
+ * pmem2_flush_cpu_cache_filter -- flush processor cache for the given range,
+ * skipping cache lines which were already flushed since the last drain
+ */
+static void
+pmem2_flush_cpu_cache_filter(const void *addr, size_t len)
+{
+	pmem2_log_flush(addr, len);
+
+	uintptr_t begin = ALIGN_DOWN((uintptr_t)addr, CACHELINE_SIZE);
+	uintptr_t end = ALIGN_UP((uintptr_t)addr + len, CACHELINE_SIZE);
+	size_t nlines = flush_filter_lines(begin, end);
+
+	if (nlines > FLUSH_FILTER_SIZE) {
+		/* the filter would only evict its own entries */
+		Info.flush(addr, len);
+		PMEM2_STATS_FLUSH(addr, len);
+		return;
+	}
+
+	size_t elided = 0;
+	uintptr_t pending = begin; /* start of lines waiting to be flushed */
+	for (uintptr_t line = begin; line < end; line += CACHELINE_SIZE) {
+		if (!flush_filter_test_and_set(&Flush_filter, line))
+			continue;
+
+		if (pending < line)
+			Info.flush((const void *)pending, line - pending);
+		pending = line + CACHELINE_SIZE;
+		elided++;
+	}
+
+	if (pending < end)
+		Info.flush((const void *)pending, end - pending);
+
+	PMEM2_STATS_INC(flushed_lines, nlines - elided);
+	PMEM2_STATS_INC(elided_lines, elided);
 }
 
 /*
@@ -182,6 +256,42 @@ pmem2_persist_cpu_cache(const void *addr, size_t len)
 	pmem2_drain();
 }
 
+/*
+ * pmem2_persist_cpu_cache_filter -- make all changes to a range of pmem
+ * persistent, skipping cache lines which were already flushed
+ */
+static void
+pmem2_persist_cpu_cache_filter(const void *addr, size_t len)
+{
+	pmem2_flush_cpu_cache_filter(addr, len);
+	pmem2_drain();
+}
+
+/*
+ * pmem2_flush_file_buffers_timed -- (internal) flush OS caches for the given
+ * range of a single mapping, measuring how long it took if stats are enabled
+ */
+static int
+pmem2_flush_file_buffers_timed(struct pmem2_map *map, const void *addr,
+		size_t len, int autorestart)
+{
+	if (likely(!pmem2_stats_is_enabled()))
+		return pmem2_flush_file_buffers_os(map, addr, len, autorestart);
+
+	struct timespec start;
+	struct timespec end;
+
+	os_clock_gettime(CLOCK_MONOTONIC, &start);
+	int ret = pmem2_flush_file_buffers_os(map, addr, len, autorestart);
+	os_clock_gettime(CLOCK_MONOTONIC, &end);
+
+	int64_t nsecs = (end.tv_sec - start.tv_sec) * 1000000000LL +
+		(end.tv_nsec - start.tv_nsec);
+	pmem2_stats_msync(nsecs > 0 ? (uint64_t)nsecs : 0);
+
+	return ret;
+}
+
 /*
  * pmem2_flush_file_buffers -- flush CPU and OS caches for the given range
  */
@@ -243,7 +353,7 @@ pmem2_flush_file_buffers(const void *addr, size_t len, int autorestart)
 		else
 			flush = len;
 
-		int ret1 = pmem2_flush_file_buffers_os(map, addr, flush,
+		int ret1 = pmem2_flush_file_buffers_timed(map, addr, flush,
 				autorestart);
 		if (ret1 != 0)
 			ret = ret1;
@@ -379,8 +489,13 @@ pmem2_set_flush_fns(struct pmem2_map *map)
 			map->deep_flush_fn = pmem2_deep_flush_page;
 			break;
 		case PMEM2_GRANULARITY_CACHE_LINE:
-			map->persist_fn = pmem2_persist_cpu_cache;
-			map->flush_fn = pmem2_flush_cpu_cache;
+			if (map->flush_filter == PMEM2_FLUSH_FILTER_ENABLED) {
+				map->persist_fn = pmem2_persist_cpu_cache_filter;
+				map->flush_fn = pmem2_flush_cpu_cache_filter;
+			} else {
+				map->persist_fn = pmem2_persist_cpu_cache;
+				map->flush_fn = pmem2_flush_cpu_cache;
+			}
 			map->drain_fn = pmem2_drain;
 			map->deep_flush_fn = pmem2_deep_flush_cache;
 			break;
@@ -429,6 +544,45 @@ pmem2_get_drain_fn(struct pmem2_map *map)
 	return map->drain_fn;
 }
 
+/*
+ * memmove_parallel -- (internal) mem[move|cpy] a large range using
+ * the worker threads, returns 1 if the range was written and 0 if
+ * the caller has to write it
+ */
+static inline int
+memmove_parallel(void *pmemdest, const void *src, size_t len, unsigned flags,
+		int filter)
+{
+	if (likely(len < Mem_parallel_threshold) ||
+			pmem2_memmove_parallel(pmemdest, src, len, flags) != 0)
+		return 0;
+
+	/* the stores of the other threads are not in the filter */
+	if (filter && (flags & PMEM2_F_MEM_NOFLUSH))
+		flush_filter_invalidate(&Flush_filter, pmemdest, len);
+
+	return 1;
+}
+
+/*
+ * memset_parallel -- (internal) memset a large range using the worker
+ * threads, returns 1 if the range was written and 0 if the caller has to
+ * write it
+ */
+static inline int
+memset_parallel(void *pmemdest, int c, size_t len, unsigned flags, int filter)
+{
+	if (likely(len < Mem_parallel_threshold) ||
+			pmem2_memset_parallel(pmemdest, c, len, flags) != 0)
+		return 0;
+
+	/* the stores of the other threads are not in the filter */
+	if (filter && (flags & PMEM2_F_MEM_NOFLUSH))
+		flush_filter_invalidate(&Flush_filter, pmemdest, len);
+
+	return 1;
+}
+
 /*
  * pmem2_memmove_nonpmem -- mem[move|cpy] followed by an msync
  */
@@ -441,6 +595,11 @@ pmem2_memmove_nonpmem(void *pmemdest, const void *src, size_t len,
 		ERR_WO_ERRNO("invalid flags 0x%x", flags);
 #endif
 	PMEM2_API_START("pmem2_memmove");
+	if (memmove_parallel(pmemdest, src, len, flags, 0)) {
+		PMEM2_API_END("pmem2_memmove");
+		return pmemdest;
+	}
+
 	Info.memmove_nodrain(pmemdest, src, len,
 		flags & ~PMEM2_F_MEM_NODRAIN,
 		Info.flush, &Info.memmove_funcs);
@@ -463,6 +622,11 @@ pmem2_memset_nonpmem(void *pmemdest, int c, size_t len, unsigned flags)
 		ERR_WO_ERRNO("invalid flags 0x%x", flags);
 #endif
 	PMEM2_API_START("pmem2_memset");
+	if (memset_parallel(pmemdest, c, len, flags, 0)) {
+		PMEM2_API_END("pmem2_memset");
+		return pmemdest;
+	}
+
 	Info.memset_nodrain(pmemdest, c, len,
 		flags & ~PMEM2_F_MEM_NODRAIN,
 		Info.flush, &Info.memset_funcs);
@@ -486,6 +650,11 @@ pmem2_memmove(void *pmemdest, const void *src, size_t len,
 		ERR_WO_ERRNO("invalid flags 0x%x", flags);
 #endif
 	PMEM2_API_START("pmem2_memmove");
+	if (memmove_parallel(pmemdest, src, len, flags, 0)) {
+		PMEM2_API_END("pmem2_memmove");
+		return pmemdest;
+	}
+
 	Info.memmove_nodrain(pmemdest, src, len, flags, Info.flush,
 			&Info.memmove_funcs);
 	if ((flags & (PMEM2_F_MEM_NODRAIN | PMEM2_F_MEM_NOFLUSH)) == 0)
@@ -506,6 +675,11 @@ pmem2_memset(void *pmemdest, int c, size_t len, unsigned flags)
 		ERR_WO_ERRNO("invalid flags 0x%x", flags);
 #endif
 	PMEM2_API_START("pmem2_memset");
+	if (memset_parallel(pmemdest, c, len, flags, 0)) {
+		PMEM2_API_END("pmem2_memset");
+		return pmemdest;
+	}
+
 	Info.memset_nodrain(pmemdest, c, len, flags, Info.flush,
 			&Info.memset_funcs);
 	if ((flags & (PMEM2_F_MEM_NODRAIN | PMEM2_F_MEM_NOFLUSH)) == 0)
@@ -515,6 +689,67 @@ pmem2_memset(void *pmemdest, int c, size_t len, unsigned flags)
 	return pmemdest;
 }
 
+/*
+ * pmem2_memmove_filter -- mem[move|cpy] to pmem, keeping the flush filter
+ * of the current thread up to date
+ */
+static void *
+pmem2_memmove_filter(void *pmemdest, const void *src, size_t len,
+		unsigned flags)
+{
+#ifdef DEBUG
+	if (flags & ~PMEM2_F_MEM_VALID_FLAGS)
+		ERR_WO_ERRNO("invalid flags 0x%x", flags);
+#endif
+	PMEM2_API_START("pmem2_memmove");
+	if (memmove_parallel(pmemdest, src, len, flags, 1)) {
+		PMEM2_API_END("pmem2_memmove");
+		return pmemdest;
+	}
+
+	Info.memmove_nodrain(pmemdest, src, len, flags, Info.flush,
+			&Info.memmove_funcs);
+	if (flags & PMEM2_F_MEM_NOFLUSH)
+		flush_filter_invalidate(&Flush_filter, pmemdest, len);
+	else if (flags & PMEM2_F_MEM_NODRAIN)
+		flush_filter_insert(&Flush_filter, pmemdest, len);
+	else
+		pmem2_drain();
+
+	PMEM2_API_END("pmem2_memmove");
+	return pmemdest;
+}
+
+/*
+ * pmem2_memset_filter -- memset to pmem, keeping the flush filter
+ * of the current thread up to date
+ */
+static void *
+pmem2_memset_filter(void *pmemdest, int c, size_t len, unsigned flags)
+{
+#ifdef DEBUG
+	if (flags & ~PMEM2_F_MEM_VALID_FLAGS)
+		ERR_WO_ERRNO("invalid flags 0x%x", flags);
+#endif
+	PMEM2_API_START("pmem2_memset");
+	if (memset_parallel(pmemdest, c, len, flags, 1)) {
+		PMEM2_API_END("pmem2_memset");
+		return pmemdest;
+	}
+
+	Info.memset_nodrain(pmemdest, c, len, flags, Info.flush,
+			&Info.memset_funcs);
+	if (flags & PMEM2_F_MEM_NOFLUSH)
+		flush_filter_invalidate(&Flush_filter, pmemdest, len);
+	else if (flags & PMEM2_F_MEM_NODRAIN)
+		flush_filter_insert(&Flush_filter, pmemdest, len);
+	else
+		pmem2_drain();
+
+	PMEM2_API_END("pmem2_memset");
+	return pmemdest;
+}
+
 /*
  * pmem2_memmove_eadr -- mem[move|cpy] to pmem, platform supports eADR
  */
@@ -527,6 +762,11 @@ pmem2_memmove_eadr(void *pmemdest, const void *src, size_t len,
 		ERR_WO_ERRNO("invalid flags 0x%x", flags);
 #endif
 	PMEM2_API_START("pmem2_memmove");
+	if (memmove_parallel(pmemdest, src, len, flags, 0)) {
+		PMEM2_API_END("pmem2_memmove");
+		return pmemdest;
+	}
+
 	Info.memmove_nodrain_eadr(pmemdest, src, len, flags, Info.flush,
 			&Info.memmove_funcs);
 	if ((flags & (PMEM2_F_MEM_NODRAIN | PMEM2_F_MEM_NOFLUSH)) == 0)
@@ -547,6 +787,11 @@ pmem2_memset_eadr(void *pmemdest, int c, size_t len, unsigned flags)
 		ERR_WO_ERRNO("invalid flags 0x%x", flags);
 #endif
 	PMEM2_API_START("pmem2_memset");
+	if (memset_parallel(pmemdest, c, len, flags, 0)) {
+		PMEM2_API_END("pmem2_memset");
+		return pmemdest;
+	}
+
 	Info.memset_nodrain_eadr(pmemdest, c, len, flags, Info.flush,
 			&Info.memset_funcs);
 	if ((flags & (PMEM2_F_MEM_NODRAIN | PMEM2_F_MEM_NOFLUSH)) == 0)
@@ -556,6 +801,91 @@ pmem2_memset_eadr(void *pmemdest, int c, size_t len, unsigned flags)
 	return pmemdest;
 }
 
+/* flags which explicitly select the kind of stores */
+#define PMEM2_F_MEM_STORE_HINTS (PMEM2_F_MEM_NOFLUSH | PMEM2_F_MEM_TEMPORAL |\
+	PMEM2_F_MEM_NONTEMPORAL | PMEM2_F_MEM_WB | PMEM2_F_MEM_WC)
+
+/*
+ * far_memory_flags -- prefer non-temporal stores for memory attached
+ * through CXL, where reading the destination line into the cache before
+ * overwriting it costs a round trip over the link, so the threshold
+ * is lower than for the other memory types
+ */
+static inline unsigned
+far_memory_flags(size_t len, unsigned flags)
+{
+	if (len >= Movnt_threshold_far &&
+			(flags & PMEM2_F_MEM_STORE_HINTS) == 0)
+		flags |= PMEM2_F_MEM_NONTEMPORAL;
+
+	return flags;
+}
+
+/*
+ * pmem2_memmove_far -- mem[move|cpy] to pmem attached through CXL
+ */
+static void *
+pmem2_memmove_far(void *pmemdest, const void *src, size_t len,
+		unsigned flags)
+{
+	return pmem2_memmove(pmemdest, src, len, far_memory_flags(len, flags));
+}
+
+/*
+ * pmem2_memset_far -- memset to pmem attached through CXL
+ */
+static void *
+pmem2_memset_far(void *pmemdest, int c, size_t len, unsigned flags)
+{
+	return pmem2_memset(pmemdest, c, len, far_memory_flags(len, flags));
+}
+
+/*
+ * pmem2_memmove_far_filter -- mem[move|cpy] to pmem attached through CXL,
+ * keeping the flush filter of the current thread up to date
+ */
+static void *
+pmem2_memmove_far_filter(void *pmemdest, const void *src, size_t len,
+		unsigned flags)
+{
+	return pmem2_memmove_filter(pmemdest, src, len,
+		far_memory_flags(len, flags));
+}
+
+/*
+ * pmem2_memset_far_filter -- memset to pmem attached through CXL,
+ * keeping the flush filter of the current thread up to date
+ */
+static void *
+pmem2_memset_far_filter(void *pmemdest, int c, size_t len, unsigned flags)
+{
+	return pmem2_memset_filter(pmemdest, c, len,
+		far_memory_flags(len, flags));
+}
+
+/*
+ * pmem2_memmove_eadr_far -- mem[move|cpy] to pmem attached through CXL,
+ * platform supports eADR
+ */
+static void *
+pmem2_memmove_eadr_far(void *pmemdest, const void *src, size_t len,
+		unsigned flags)
+{
+	return pmem2_memmove_eadr(pmemdest, src, len,
+		far_memory_flags(len, flags));
+}
+
+/*
+ * pmem2_memset_eadr_far -- memset to pmem attached through CXL,
+ * platform supports eADR
+ */
+static void *
+pmem2_memset_eadr_far(void *pmemdest, int c, size_t len, unsigned flags)
+{
+	return pmem2_memset_eadr(pmemdest, c, len,
+		far_memory_flags(len, flags));
+}
+
 /*
  * pmem2_set_mem_fns -- set function pointers related to mem[move|cpy|set]
  */
@@ -569,14 +899,36 @@ pmem2_set_mem_fns(struct pmem2_map *map)
 			map->memset_fn = pmem2_memset_nonpmem;
 			break;
 		case PMEM2_GRANULARITY_CACHE_LINE:
-			map->memmove_fn = pmem2_memmove;
-			map->memcpy_fn = pmem2_memmove;
-			map->memset_fn = pmem2_memset;
+			if (map->flush_filter == PMEM2_FLUSH_FILTER_ENABLED &&
+					map->memory_type == PMEM2_MEMORY_TYPE_CXL) {
+				map->memmove_fn = pmem2_memmove_far_filter;
+				map->memcpy_fn = pmem2_memmove_far_filter;
+				map->memset_fn = pmem2_memset_far_filter;
+			} else if (map->flush_filter ==
+					PMEM2_FLUSH_FILTER_ENABLED) {
+				map->memmove_fn = pmem2_memmove_filter;
+				map->memcpy_fn = pmem2_memmove_filter;
+				map->memset_fn = pmem2_memset_filter;
+			} else if (map->memory_type == PMEM2_MEMORY_TYPE_CXL) {
+				map->memmove_fn = pmem2_memmove_far;
+				map->memcpy_fn = pmem2_memmove_far;
+				map->memset_fn = pmem2_memset_far;
+			} else {
+				map->memmove_fn = pmem2_memmove;
+				map->memcpy_fn = pmem2_memmove;
+				map->memset_fn = pmem2_memset;
+			}
 			break;
 		case PMEM2_GRANULARITY_BYTE:
-			map->memmove_fn = pmem2_memmove_eadr;
-			map->memcpy_fn = pmem2_memmove_eadr;
-			map->memset_fn = pmem2_memset_eadr;
+			if (map->memory_type == PMEM2_MEMORY_TYPE_CXL) {
+				map->memmove_fn = pmem2_memmove_eadr_far;
+				map->memcpy_fn = pmem2_memmove_eadr_far;
+				map->memset_fn = pmem2_memset_eadr_far;
+			} else {
+				map->memmove_fn = pmem2_memmove_eadr;
+				map->memcpy_fn = pmem2_memmove_eadr;
+				map->memset_fn = pmem2_memset_eadr;
+			}
 			break;
 		default:
 			abort();
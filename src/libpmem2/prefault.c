@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * prefault.c -- populating page tables of a mapped range
+ *
+ * The range is populated with madvise(MADV_POPULATE_READ/WRITE) where
+ * the kernel supports it (Linux >= 5.13), otherwise every page is touched.
+ * Large ranges are split between several threads, because populating pages
+ * of a DAX mapping is dominated by the page fault handling in the kernel,
+ * which scales with the number of cpus.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "core_assert.h"
+#include "os.h"
+#include "os_thread.h"
+#include "out.h"
+#include "prefault.h"
+#include "util.h"
+#include "valgrind_internal.h"
+
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+struct prefault_chunk {
+	char *addr;
+	size_t len;
+	int write;
+	int ret;
+};
+
+/*
+ * prefault_touch -- (internal) fault in every page of the range
+ */
+static void
+prefault_touch(char *addr, size_t len, int write)
+{
+	char *end = addr + len;
+
+	for (char *page = addr; page < end; page += Pagesize) {
+		if (write) {
+			/* an atomic no-op does not lose concurrent stores */
+			util_fetch_and_or64((uint64_t *)page, 0);
+			VALGRIND_SET_CLEAN(page, sizeof(uint64_t));
+		} else {
+			(void) *(volatile char *)page;
+		}
+	}
+}
+
+/*
+ * prefault_chunk -- (internal) populate page tables of a part of the range
+ */
+static void *
+prefault_chunk(void *arg)
+{
+	struct prefault_chunk *c = arg;
+
+	int advice = c->write ? MADV_POPULATE_WRITE : MADV_POPULATE_READ;
+	if (madvise(c->addr, c->len, advice) == 0)
+		return NULL;
+
+	if (errno != EINVAL) {
+		/* e.g. a poisoned page, touching it would raise SIGBUS */
+		CORE_LOG_ERROR_W_ERRNO("madvise(%p, %zu, %d)", c->addr, c->len,
+			advice);
+		c->ret = -errno;
+		return NULL;
+	}
+
+	LOG(4, "MADV_POPULATE not supported, touching the pages");
+	prefault_touch(c->addr, c->len, c->write);
+
+	return NULL;
+}
+
+/*
+ * prefault_min_chunk -- (internal) return the smallest part of the range
+ * worth a separate thread
+ */
+static size_t
+prefault_min_chunk(void)
+{
+	/*
+	 * For testing the default can be overridden using
+	 * PMEM2_PREFAULT_MIN_CHUNK env variable.
+	 */
+	const char *ptr = os_getenv("PMEM2_PREFAULT_MIN_CHUNK");
+	if (ptr) {
+		long long val = atoll(ptr);
+
+		if (val >= (long long)Pagesize)
+			return (size_t)val;
+
+		LOG(3, "Invalid PMEM2_PREFAULT_MIN_CHUNK");
+	}
+
+	return PREFAULT_MIN_CHUNK;
+}
+
+/*
+ * pmem2_prefault_range -- populate page tables of the page aligned range
+ * using up to nthreads threads, returns 0 on success or negative errno
+ */
+int
+pmem2_prefault_range(void *addr, size_t len, int write, unsigned nthreads)
+{
+	LOG(3, "addr %p len %zu write %d nthreads %u", addr, len, write,
+		nthreads);
+
+	ASSERTeq((uintptr_t)addr % Pagesize, 0);
+
+	if (len == 0)
+		return 0;
+
+	size_t max_threads = len / prefault_min_chunk();
+	if (nthreads > PREFAULT_MAX_THREADS)
+		nthreads = PREFAULT_MAX_THREADS;
+	if (nthreads > max_threads)
+		nthreads = (unsigned)max_threads;
+	if (nthreads == 0)
+		nthreads = 1;
+
+	size_t chunk = ALIGN_UP((len + nthreads - 1) / nthreads,
+		(size_t)Pagesize);
+
+	struct prefault_chunk chunks[PREFAULT_MAX_THREADS];
+	os_thread_t threads[PREFAULT_MAX_THREADS];
+	int started[PREFAULT_MAX_THREADS];
+	unsigned n = 0;
+
+	for (size_t off = 0; off < len; off += chunk, ++n) {
+		struct prefault_chunk *c = &chunks[n];
+		c->addr = (char *)addr + off;
+		c->len = len - off < chunk ? len - off : chunk;
+		c->write = write;
+		c->ret = 0;
+
+		/* the calling thread takes the first chunk */
+		started[n] = n != 0 && os_thread_create(&threads[n], NULL,
+			prefault_chunk, c) == 0;
+	}
+
+	LOG(4, "range split into %u chunks", n);
+
+	prefault_chunk(&chunks[0]);
+
+	int ret = chunks[0].ret;
+	for (unsigned i = 1; i < n; ++i) {
+		if (started[i])
+			os_thread_join(&threads[i], NULL);
+		else
+			prefault_chunk(&chunks[i]);
+
+		if (chunks[i].ret && !ret)
+			ret = chunks[i].ret;
+	}
+
+	return ret;
+}
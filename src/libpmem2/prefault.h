@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * prefault.h -- internal definitions for populating page tables of a range
+ */
+#ifndef PMEM2_PREFAULT_H
+#define PMEM2_PREFAULT_H 1
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* maximum number of threads populating one range */
+#define PREFAULT_MAX_THREADS 64
+
+/* smallest part of the range worth a separate thread */
+#define PREFAULT_MIN_CHUNK ((size_t)64 << 20) /* 64 MiB */
+
+int pmem2_prefault_range(void *addr, size_t len, int write,
+		unsigned nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
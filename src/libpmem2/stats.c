@@ -0,0 +1,354 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * stats.c -- per-thread persist/flush statistics
+ *
+ * Each thread which touches pmem through libpmem2 while statistics are
+ * enabled gets its own set of counters, so the hot paths never share
+ * a cache line. Counter blocks are linked into a global list, which is
+ * walked when process-wide statistics are requested. When a thread exits,
+ * its counters are folded into the "retired" block.
+ *
+ * The counters are written only by their owning thread. A reset does not
+ * zero them, which would race with the owner, but records their current
+ * values as the base which is subtracted from them when they are read.
+ * The bases and the retired block are accessed only with the lock held.
+ */
+
+#include <string.h>
+
+#include "alloc.h"
+#include "libpmem2.h"
+#include "os.h"
+#include "os_thread.h"
+#include "out.h"
+#include "pmem2_utils.h"
+#include "stats.h"
+#include "sys_util.h"
+
+#define PMEM2_STATS_NCOUNTERS\
+	(sizeof(struct stats_counters) / sizeof(uint64_t))
+
+/* offset of the counters in struct pmem2_stats */
+#define PMEM2_STATS_COUNTERS_OFFSET\
+	offsetof(struct pmem2_stats, memmove_nt_bytes)
+
+/* size of the first version of struct pmem2_stats */
+#define PMEM2_STATS_SIZE_MIN\
+	(offsetof(struct pmem2_stats, msync_hist) +\
+	PMEM2_STATS_MSYNC_HIST_BUCKETS * sizeof(uint64_t))
+
+struct stats_thread {
+	struct stats_counters counters;
+	/* values of the counters at the last reset */
+	struct stats_counters base;
+	struct stats_thread *prev;
+	struct stats_thread *next;
+};
+
+int Pmem2_stats_enabled;
+
+static struct {
+	os_mutex_t lock;
+	os_tls_key_t key;
+	struct stats_thread *threads;
+	struct stats_counters retired;
+} Stats;
+
+static __thread struct stats_thread *Stats_thread;
+
+/* set if the counters of the thread could not be allocated */
+static __thread int Stats_thread_failed;
+
+/*
+ * stats_accumulate -- (internal) add counters of a thread since its last
+ * reset to dst, must be called with the lock held
+ */
+static void
+stats_accumulate(struct stats_counters *dst, struct stats_thread *st)
+{
+	uint64_t *d = (uint64_t *)dst;
+	uint64_t *c = (uint64_t *)&st->counters;
+	uint64_t *b = (uint64_t *)&st->base;
+
+	for (size_t i = 0; i < PMEM2_STATS_NCOUNTERS; ++i) {
+		uint64_t v;
+		util_atomic_load_explicit64(&c[i], &v, memory_order_relaxed);
+		d[i] += v - b[i];
+	}
+}
+
+/*
+ * stats_rebase -- (internal) reset counters of a thread, must be called
+ * with the lock held
+ */
+static void
+stats_rebase(struct stats_thread *st)
+{
+	uint64_t *c = (uint64_t *)&st->counters;
+	uint64_t *b = (uint64_t *)&st->base;
+
+	for (size_t i = 0; i < PMEM2_STATS_NCOUNTERS; ++i)
+		util_atomic_load_explicit64(&c[i], &b[i], memory_order_relaxed);
+}
+
+/*
+ * stats_thread_unlink -- (internal) remove thread counters from the list,
+ * must be called with the lock held
+ */
+static void
+stats_thread_unlink(struct stats_thread *st)
+{
+	if (st->prev)
+		st->prev->next = st->next;
+	else
+		Stats.threads = st->next;
+
+	if (st->next)
+		st->next->prev = st->prev;
+}
+
+/*
+ * stats_thread_destroy -- (internal) destructor for thread counters
+ */
+static void
+stats_thread_destroy(void *arg)
+{
+	struct stats_thread *st = arg;
+
+	util_mutex_lock(&Stats.lock);
+	stats_accumulate(&Stats.retired, st);
+	stats_thread_unlink(st);
+	util_mutex_unlock(&Stats.lock);
+
+	Free(st);
+	Stats_thread = NULL;
+}
+
+/*
+ * pmem2_stats_thread -- return counters of the calling thread, allocating
+ * them on first use, or NULL if they can't be allocated, in which case
+ * the statistics of the thread are not collected
+ */
+struct stats_counters *
+pmem2_stats_thread(void)
+{
+	if (likely(Stats_thread != NULL))
+		return &Stats_thread->counters;
+
+	if (Stats_thread_failed)
+		return NULL;
+
+	struct stats_thread *st = Zalloc(sizeof(*st));
+	if (st == NULL) {
+		CORE_LOG_WARNING_W_ERRNO(
+			"Zalloc, statistics of the thread are disabled");
+		Stats_thread_failed = 1;
+		return NULL;
+	}
+
+	int ret = os_tls_set(Stats.key, st);
+	if (ret != 0) {
+		errno = ret;
+		CORE_LOG_WARNING_W_ERRNO(
+			"os_tls_set, statistics of the thread are disabled");
+		Free(st);
+		Stats_thread_failed = 1;
+		return NULL;
+	}
+
+	util_mutex_lock(&Stats.lock);
+	st->next = Stats.threads;
+	if (Stats.threads)
+		Stats.threads->prev = st;
+	Stats.threads = st;
+	util_mutex_unlock(&Stats.lock);
+
+	Stats_thread = st;
+
+	return &st->counters;
+}
+
+/*
+ * pmem2_stats_msync -- account a single msync call which took nsecs
+ */
+void
+pmem2_stats_msync(uint64_t nsecs)
+{
+	struct stats_counters *stats = pmem2_stats_thread();
+	if (stats == NULL)
+		return;
+
+	/* bucket 0: < 1us, bucket n: [2^(n-1), 2^n) us */
+	uint64_t usecs = nsecs / 1000;
+	unsigned bucket = 0;
+	if (usecs > 0)
+		bucket = util_mssb_index64(usecs) + 1U;
+	if (bucket >= PMEM2_STATS_MSYNC_HIST_BUCKETS)
+		bucket = PMEM2_STATS_MSYNC_HIST_BUCKETS - 1;
+
+	pmem2_stats_add(&stats->msync_calls, 1);
+	pmem2_stats_add(&stats->msync_nsecs, nsecs);
+	pmem2_stats_add(&stats->msync_hist[bucket], 1);
+}
+
+/*
+ * pmem2_stats_init -- initialize the statistics module
+ */
+void
+pmem2_stats_init(void)
+{
+	util_mutex_init(&Stats.lock);
+
+	int ret = os_tls_key_create(&Stats.key, stats_thread_destroy);
+	if (ret != 0) {
+		errno = ret;
+		CORE_LOG_FATAL_W_ERRNO("os_tls_key_create");
+	}
+
+	char *e = os_getenv("PMEM2_STATS");
+	if (e && strcmp(e, "1") == 0) {
+		LOG(3, "PMEM2_STATS enabled statistics");
+		pmem2_stats_enable();
+	}
+}
+
+/*
+ * pmem2_stats_fini -- finalize the statistics module
+ */
+void
+pmem2_stats_fini(void)
+{
+	pmem2_stats_disable();
+
+	(void) os_tls_key_delete(Stats.key);
+
+	util_mutex_lock(&Stats.lock);
+	while (Stats.threads != NULL) {
+		struct stats_thread *st = Stats.threads;
+		stats_thread_unlink(st);
+		Free(st);
+	}
+	util_mutex_unlock(&Stats.lock);
+
+	Stats_thread = NULL;
+
+	util_mutex_destroy(&Stats.lock);
+}
+
+/*
+ * pmem2_stats_enable -- start collecting statistics
+ */
+void
+pmem2_stats_enable(void)
+{
+	util_atomic_store_explicit32(&Pmem2_stats_enabled, 1,
+		memory_order_relaxed);
+}
+
+/*
+ * pmem2_stats_disable -- stop collecting statistics
+ */
+void
+pmem2_stats_disable(void)
+{
+	util_atomic_store_explicit32(&Pmem2_stats_enabled, 0,
+		memory_order_relaxed);
+}
+
+/*
+ * stats_copy -- (internal) copy the counters to the statistics structure
+ * of the caller, which may come from an older or a newer version of
+ * the library, the fields unknown to this version are zeroed
+ */
+static void
+stats_copy(struct pmem2_stats *stats, const struct stats_counters *counters)
+{
+	COMPILE_ERROR_ON(sizeof(struct stats_counters) !=
+		sizeof(struct pmem2_stats) - PMEM2_STATS_COUNTERS_OFFSET);
+
+	size_t known = stats->size < sizeof(struct pmem2_stats) ?
+		stats->size : sizeof(struct pmem2_stats);
+
+	memcpy((char *)stats + PMEM2_STATS_COUNTERS_OFFSET, counters,
+		known - PMEM2_STATS_COUNTERS_OFFSET);
+	memset((char *)stats + known, 0, stats->size - known);
+}
+
+/*
+ * pmem2_stats_get -- retrieve statistics of the calling thread or of
+ * the whole process
+ */
+int
+pmem2_stats_get(struct pmem2_stats *stats, enum pmem2_stats_scope scope)
+{
+	PMEM2_ERR_CLR();
+
+	if (stats->size < PMEM2_STATS_SIZE_MIN) {
+		ERR_WO_ERRNO("invalid size of the stats structure %zu",
+			stats->size);
+		return PMEM2_E_INVALID_STATS_SIZE;
+	}
+
+	struct stats_counters counters;
+
+	switch (scope) {
+		case PMEM2_STATS_THREAD:
+			memset(&counters, 0, sizeof(counters));
+			if (Stats_thread) {
+				util_mutex_lock(&Stats.lock);
+				stats_accumulate(&counters, Stats_thread);
+				util_mutex_unlock(&Stats.lock);
+			}
+			break;
+		case PMEM2_STATS_PROCESS:
+			util_mutex_lock(&Stats.lock);
+			counters = Stats.retired;
+			for (struct stats_thread *st = Stats.threads; st != NULL;
+					st = st->next)
+				stats_accumulate(&counters, st);
+			util_mutex_unlock(&Stats.lock);
+			break;
+		default:
+			ERR_WO_ERRNO("unknown stats scope %d", scope);
+			return PMEM2_E_INVALID_STATS_SCOPE;
+	}
+
+	stats_copy(stats, &counters);
+
+	return 0;
+}
+
+/*
+ * pmem2_stats_reset -- zero statistics of the calling thread or of
+ * the whole process
+ */
+int
+pmem2_stats_reset(enum pmem2_stats_scope scope)
+{
+	PMEM2_ERR_CLR();
+
+	switch (scope) {
+		case PMEM2_STATS_THREAD:
+			if (Stats_thread) {
+				util_mutex_lock(&Stats.lock);
+				stats_rebase(Stats_thread);
+				util_mutex_unlock(&Stats.lock);
+			}
+			break;
+		case PMEM2_STATS_PROCESS:
+			util_mutex_lock(&Stats.lock);
+			memset(&Stats.retired, 0, sizeof(Stats.retired));
+			for (struct stats_thread *st = Stats.threads; st != NULL;
+					st = st->next)
+				stats_rebase(st);
+			util_mutex_unlock(&Stats.lock);
+			break;
+		default:
+			ERR_WO_ERRNO("unknown stats scope %d", scope);
+			return PMEM2_E_INVALID_STATS_SCOPE;
+	}
+
+	return 0;
+}
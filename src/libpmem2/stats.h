@@ -0,0 +1,112 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * stats.h -- internal definitions for libpmem2 persist statistics
+ */
+#ifndef PMEM2_STATS_H
+#define PMEM2_STATS_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libpmem2.h"
+#include "util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int Pmem2_stats_enabled;
+
+/*
+ * stats_counters -- counters of a thread, laid out as the fields of
+ * struct pmem2_stats which follow its size
+ */
+struct stats_counters {
+	uint64_t memmove_nt_bytes;
+	uint64_t memmove_t_bytes;
+	uint64_t memset_nt_bytes;
+	uint64_t memset_t_bytes;
+	uint64_t flushed_lines;
+	uint64_t elided_lines;
+	uint64_t fences;
+	uint64_t msync_calls;
+	uint64_t msync_nsecs;
+	uint64_t msync_hist[PMEM2_STATS_MSYNC_HIST_BUCKETS];
+};
+
+void pmem2_stats_init(void);
+void pmem2_stats_fini(void);
+
+struct stats_counters *pmem2_stats_thread(void);
+void pmem2_stats_msync(uint64_t nsecs);
+
+/*
+ * pmem2_stats_is_enabled -- check whether statistics are collected
+ */
+static inline int
+pmem2_stats_is_enabled(void)
+{
+	int enabled;
+	util_atomic_load_explicit32(&Pmem2_stats_enabled, &enabled,
+		memory_order_relaxed);
+
+	return enabled;
+}
+
+/*
+ * pmem2_stats_add -- bump a per-thread counter
+ *
+ * Counters are only ever written by their owning thread, so a relaxed
+ * load/store pair is enough; it only guarantees that concurrent readers
+ * never observe a torn value.
+ */
+static inline void
+pmem2_stats_add(uint64_t *counter, uint64_t value)
+{
+	uint64_t cur;
+	util_atomic_load_explicit64(counter, &cur, memory_order_relaxed);
+	util_atomic_store_explicit64(counter, cur + value,
+		memory_order_relaxed);
+}
+
+/*
+ * pmem2_stats_cachelines -- number of cache lines spanned by a range
+ */
+static inline uint64_t
+pmem2_stats_cachelines(const void *addr, size_t len)
+{
+	if (len == 0)
+		return 0;
+
+	uintptr_t begin = ALIGN_DOWN((uintptr_t)addr, CACHELINE_SIZE);
+	uintptr_t end = ALIGN_UP((uintptr_t)addr + len, CACHELINE_SIZE);
+
+	return (end - begin) / CACHELINE_SIZE;
+}
+
+#ifdef PMEM2_STATS_DISABLED
+
+#define PMEM2_STATS_INC(name, value) do {} while (0)
+
+#else
+
+#define PMEM2_STATS_INC(name, value) do {\
+	if (unlikely(pmem2_stats_is_enabled())) {\
+		struct stats_counters *_stats = pmem2_stats_thread();\
+		if (_stats != NULL)\
+			pmem2_stats_add(&_stats->name, (value));\
+	}\
+} while (0)
+
+#endif
+
+#define PMEM2_STATS_FLUSH(addr, len)\
+	PMEM2_STATS_INC(flushed_lines, pmem2_stats_cachelines((addr), (len)))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2014-2024, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 
 #include <string.h>
 #include <xmmintrin.h>
@@ -12,6 +12,7 @@
 #include "out.h"
 #include "core_assert.h"
 #include "pmem2_arch.h"
+#include "stats.h"
 #include "valgrind_internal.h"
 
 #define MOVNT_THRESHOLD	256
@@ -74,16 +75,22 @@ pmem2_memmove_nodrain(void *dest, const void *src, size_t len, unsigned flags,
 	if (len == 0 || src == dest)
 		return dest;
 
-	if (flags & PMEM2_F_MEM_NOFLUSH)
+	if (flags & PMEM2_F_MEM_NOFLUSH) {
 		memmove_funcs->t.noflush(dest, src, len);
-	else if (flags & PMEM2_F_MEM_MOVNT)
+		PMEM2_STATS_INC(memmove_t_bytes, len);
+	} else if (flags & PMEM2_F_MEM_MOVNT) {
 		memmove_funcs->nt.flush(dest, src, len);
-	else if (flags & PMEM2_F_MEM_MOV)
+		PMEM2_STATS_INC(memmove_nt_bytes, len);
+		PMEM2_STATS_FLUSH(dest, len);
+	} else if (flags & PMEM2_F_MEM_MOV || len < Movnt_threshold) {
 		memmove_funcs->t.flush(dest, src, len);
-	else if (len < Movnt_threshold)
-		memmove_funcs->t.flush(dest, src, len);
-	else
+		PMEM2_STATS_INC(memmove_t_bytes, len);
+		PMEM2_STATS_FLUSH(dest, len);
+	} else {
 		memmove_funcs->nt.flush(dest, src, len);
+		PMEM2_STATS_INC(memmove_nt_bytes, len);
+		PMEM2_STATS_FLUSH(dest, len);
+	}
 
 	return dest;
 }
@@ -99,12 +106,17 @@ pmem2_memmove_nodrain_eadr(void *dest, const void *src, size_t len,
 	if (len == 0 || src == dest)
 		return dest;
 
-	if (flags & PMEM2_F_MEM_NOFLUSH)
+	if (flags & PMEM2_F_MEM_NOFLUSH) {
 		memmove_funcs->t.noflush(dest, src, len);
-	else if (flags & PMEM2_F_MEM_NONTEMPORAL)
+		PMEM2_STATS_INC(memmove_t_bytes, len);
+	} else if (flags & PMEM2_F_MEM_NONTEMPORAL) {
 		memmove_funcs->nt.empty(dest, src, len);
-	else
+		PMEM2_STATS_INC(memmove_nt_bytes, len);
+		PMEM2_STATS_FLUSH(dest, len);
+	} else {
 		memmove_funcs->t.empty(dest, src, len);
+		PMEM2_STATS_INC(memmove_t_bytes, len);
+	}
 
 	return dest;
 }
@@ -119,16 +131,22 @@ pmem2_memset_nodrain(void *dest, int c, size_t len, unsigned flags,
 	if (len == 0)
 		return dest;
 
-	if (flags & PMEM2_F_MEM_NOFLUSH)
+	if (flags & PMEM2_F_MEM_NOFLUSH) {
 		memset_funcs->t.noflush(dest, c, len);
-	else if (flags & PMEM2_F_MEM_MOVNT)
+		PMEM2_STATS_INC(memset_t_bytes, len);
+	} else if (flags & PMEM2_F_MEM_MOVNT) {
 		memset_funcs->nt.flush(dest, c, len);
-	else if (flags & PMEM2_F_MEM_MOV)
+		PMEM2_STATS_INC(memset_nt_bytes, len);
+		PMEM2_STATS_FLUSH(dest, len);
+	} else if (flags & PMEM2_F_MEM_MOV || len < Movnt_threshold) {
 		memset_funcs->t.flush(dest, c, len);
-	else if (len < Movnt_threshold)
-		memset_funcs->t.flush(dest, c, len);
-	else
+		PMEM2_STATS_INC(memset_t_bytes, len);
+		PMEM2_STATS_FLUSH(dest, len);
+	} else {
 		memset_funcs->nt.flush(dest, c, len);
+		PMEM2_STATS_INC(memset_nt_bytes, len);
+		PMEM2_STATS_FLUSH(dest, len);
+	}
 
 	return dest;
 }
@@ -143,12 +161,17 @@ pmem2_memset_nodrain_eadr(void *dest, int c, size_t len, unsigned flags,
 	if (len == 0)
 		return dest;
 
-	if (flags & PMEM2_F_MEM_NOFLUSH)
+	if (flags & PMEM2_F_MEM_NOFLUSH) {
 		memset_funcs->t.noflush(dest, c, len);
-	else if (flags & PMEM2_F_MEM_NONTEMPORAL)
+		PMEM2_STATS_INC(memset_t_bytes, len);
+	} else if (flags & PMEM2_F_MEM_NONTEMPORAL) {
 		memset_funcs->nt.empty(dest, c, len);
-	else
+		PMEM2_STATS_INC(memset_nt_bytes, len);
+		PMEM2_STATS_FLUSH(dest, len);
+	} else {
 		memset_funcs->t.empty(dest, c, len);
+		PMEM2_STATS_INC(memset_t_bytes, len);
+	}
 
 	return dest;
 }
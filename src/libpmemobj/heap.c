@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2024, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * heap.c -- heap implementation
@@ -780,6 +780,7 @@ heap_reclaim_zone_garbage(struct palloc_heap *heap, struct bucket *bucket,
 	uint32_t zone_id)
 {
 	struct zone *z = ZID_TO_ZONE(heap->layout, zone_id);
+	uint64_t start = stats_time_nsecs();
 
 	for (uint32_t i = 0; i < z->header.size_idx; ) {
 		struct chunk_header *hdr = &z->chunk_headers[i];
@@ -810,6 +811,9 @@ heap_reclaim_zone_garbage(struct palloc_heap *heap, struct bucket *bucket,
 
 		i = m.chunk_id + m.size_idx; /* hdr might have changed */
 	}
+
+	STATS_INC(heap->stats, transient, heap_zone_reclaim_time,
+		stats_time_nsecs() - start);
 }
 
 /*
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2024, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 /* Copyright 2025, Hewlett Packard Enterprise Development LP */
 
 /*
@@ -360,6 +360,7 @@ lane_recover_and_section_boot(PMEMobjpool *pop)
 	int err = 0;
 	uint64_t i; /* lane index */
 	struct lane_layout *layout;
+	uint64_t start = stats_time_nsecs();
 
 	/*
 	 * First we need to recover the internal/external redo logs so that the
@@ -374,9 +375,13 @@ lane_recover_and_section_boot(PMEMobjpool *pop)
 			OBJ_OFF_IS_VALID_FROM_CTX, &pop->p_ops);
 	}
 
+	uint64_t redo_end = stats_time_nsecs();
+
 	if ((err = pmalloc_boot(pop)) != 0)
 		return err;
 
+	uint64_t heap_end = stats_time_nsecs();
+
 	/*
 	 * Undo logs must be processed after the heap is initialized since
 	 * a undo recovery might require deallocation of the next ulogs.
@@ -389,6 +394,15 @@ lane_recover_and_section_boot(PMEMobjpool *pop)
 				ULOG_FREE_AFTER_FIRST);
 	}
 
+	uint64_t undo_end = stats_time_nsecs();
+
+	STATS_SET(pop->stats, transient, boot_redo_recovery_time,
+		redo_end - start);
+	STATS_SET(pop->stats, transient, boot_heap_time,
+		heap_end - redo_end);
+	STATS_SET(pop->stats, transient, boot_undo_recovery_time,
+		undo_end - heap_end);
+
 	return 0;
 }
 
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2014-2024, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 
 /*
  * obj.c -- transactional object store implementation
@@ -13,9 +13,11 @@
 #include "libpmem.h"
 #include "memblock.h"
 #include "critnib.h"
+#include "dirty_map.h"
 #include "list.h"
 #include "mmap.h"
 #include "obj.h"
+#include "rebuild.h"
 #include "ctl_global.h"
 #include "ravl.h"
 
@@ -96,6 +98,7 @@ obj_ctl_init_and_load(PMEMobjpool *pop)
 		pmalloc_ctl_register(pop);
 		stats_ctl_register(pop);
 		debug_ctl_register(pop);
+		rebuild_ctl_register(pop);
 	}
 
 	char *env_config = os_getenv(OBJ_CONFIG_ENV_VARIABLE);
@@ -206,6 +209,7 @@ obj_init(void)
 	 */
 	ctl_global_register();
 	pmalloc_global_ctl_register();
+	rebuild_global_ctl_register();
 
 	if (obj_ctl_init_and_load(NULL))
 		CORE_LOG_FATAL("error: %s", pmemobj_errormsg());
@@ -299,6 +303,32 @@ obj_nopmem_memset(void *dest, int c, size_t len, unsigned flags)
 	return dest;
 }
 
+/*
+ * obj_dirty_mark -- (internal) mark the range of the pool as modified since
+ *	the last backup, if the pool is tracked
+ */
+static inline void
+obj_dirty_mark(PMEMobjpool *pop, const void *addr, size_t len)
+{
+	if (pop->dirty == NULL)
+		return;
+
+	util_dirty_map_mark(pop->dirty, (uintptr_t)addr - (uintptr_t)pop, len);
+}
+
+/*
+ * obj_mark -- (internal) mark the range of the pool which is about to be
+ *	modified, before the new data can reach the pool
+ */
+static void
+obj_mark(void *ctx, const void *addr, size_t len)
+{
+	PMEMobjpool *pop = ctx;
+	LOG(15, "pop %p addr %p len %zu", pop, addr, len);
+
+	obj_dirty_mark(pop, addr, len);
+}
+
 /*
  * XXX - Consider removing obj_norep_*() wrappers to call *_local()
  * functions directly.  Alternatively, always use obj_rep_*(), even
@@ -316,6 +346,8 @@ obj_norep_memcpy(void *ctx, void *dest, const void *src, size_t len,
 	LOG(15, "pop %p dest %p src %p len %zu flags 0x%x", pop, dest, src, len,
 			flags);
 
+	obj_dirty_mark(pop, dest, len);
+
 	return pop->memcpy_local(dest, src, len,
 					flags & PMEM_F_MEM_VALID_FLAGS);
 }
@@ -331,6 +363,8 @@ obj_norep_memmove(void *ctx, void *dest, const void *src, size_t len,
 	LOG(15, "pop %p dest %p src %p len %zu flags 0x%x", pop, dest, src, len,
 			flags);
 
+	obj_dirty_mark(pop, dest, len);
+
 	return pop->memmove_local(dest, src, len,
 					flags & PMEM_F_MEM_VALID_FLAGS);
 }
@@ -345,6 +379,8 @@ obj_norep_memset(void *ctx, void *dest, int c, size_t len, unsigned flags)
 	LOG(15, "pop %p dest %p c 0x%02x len %zu flags 0x%x", pop, dest, c, len,
 			flags);
 
+	obj_dirty_mark(pop, dest, len);
+
 	return pop->memset_local(dest, c, len, flags & PMEM_F_MEM_VALID_FLAGS);
 }
 
@@ -360,6 +396,8 @@ obj_norep_persist(void *ctx, const void *addr, size_t len, unsigned flags)
 	PMEMobjpool *pop = ctx;
 	LOG(15, "pop %p addr %p len %zu", pop, addr, len);
 
+	obj_dirty_mark(pop, addr, len);
+
 	pop->persist_local(addr, len);
 
 	return 0;
@@ -377,6 +415,8 @@ obj_norep_flush(void *ctx, const void *addr, size_t len, unsigned flags)
 	PMEMobjpool *pop = ctx;
 	LOG(15, "pop %p addr %p len %zu", pop, addr, len);
 
+	obj_dirty_mark(pop, addr, len);
+
 	pop->flush_local(addr, len);
 
 	return 0;
@@ -395,6 +435,17 @@ obj_norep_drain(void *ctx)
 }
 
 static void obj_pool_cleanup(PMEMobjpool *pop);
+static void obj_rep_drain(void *ctx);
+
+/*
+ * obj_rep_needs_drain -- (internal) check if a write with given flags has to
+ *	be drained before returning
+ */
+static inline int
+obj_rep_needs_drain(unsigned flags)
+{
+	return !(flags & (PMEM_F_MEM_NODRAIN | PMEM_F_MEM_NOFLUSH));
+}
 
 /*
  * obj_rep_memcpy -- (internal) memcpy with replication
@@ -407,16 +458,25 @@ obj_rep_memcpy(void *ctx, void *dest, const void *src, size_t len,
 	LOG(15, "pop %p dest %p src %p len %zu flags 0x%x", pop, dest, src, len,
 			flags);
 
-	void *ret = pop->memcpy_local(dest, src, len, flags);
+	obj_dirty_mark(pop, dest, len);
+
+	/* flush all the replicas first, then drain them at once */
+	void *ret = pop->memcpy_local(dest, src, len,
+		flags | PMEM_F_MEM_NODRAIN);
 
 	PMEMobjpool *rep = pop->replica;
 	while (rep) {
 		void *rdest = (char *)rep + (uintptr_t)dest - (uintptr_t)pop;
+		int locked = obj_rebuild_lock(rep->rebuild);
 		rep->memcpy_local(rdest, src, len,
-			flags & PMEM_F_MEM_VALID_FLAGS);
+			(flags & PMEM_F_MEM_VALID_FLAGS) | PMEM_F_MEM_NODRAIN);
+		obj_rebuild_unlock(rep->rebuild, locked);
 		rep = rep->replica;
 	}
 
+	if (obj_rep_needs_drain(flags))
+		obj_rep_drain(pop);
+
 	return ret;
 }
 
@@ -431,16 +491,25 @@ obj_rep_memmove(void *ctx, void *dest, const void *src, size_t len,
 	LOG(15, "pop %p dest %p src %p len %zu flags 0x%x", pop, dest, src, len,
 			flags);
 
-	void *ret = pop->memmove_local(dest, src, len, flags);
+	obj_dirty_mark(pop, dest, len);
+
+	/* flush all the replicas first, then drain them at once */
+	void *ret = pop->memmove_local(dest, src, len,
+		flags | PMEM_F_MEM_NODRAIN);
 
 	PMEMobjpool *rep = pop->replica;
 	while (rep) {
 		void *rdest = (char *)rep + (uintptr_t)dest - (uintptr_t)pop;
+		int locked = obj_rebuild_lock(rep->rebuild);
 		rep->memmove_local(rdest, src, len,
-			flags & PMEM_F_MEM_VALID_FLAGS);
+			(flags & PMEM_F_MEM_VALID_FLAGS) | PMEM_F_MEM_NODRAIN);
+		obj_rebuild_unlock(rep->rebuild, locked);
 		rep = rep->replica;
 	}
 
+	if (obj_rep_needs_drain(flags))
+		obj_rep_drain(pop);
+
 	return ret;
 }
 
@@ -454,16 +523,24 @@ obj_rep_memset(void *ctx, void *dest, int c, size_t len, unsigned flags)
 	LOG(15, "pop %p dest %p c 0x%02x len %zu flags 0x%x", pop, dest, c, len,
 			flags);
 
-	void *ret = pop->memset_local(dest, c, len, flags);
+	obj_dirty_mark(pop, dest, len);
+
+	/* flush all the replicas first, then drain them at once */
+	void *ret = pop->memset_local(dest, c, len, flags | PMEM_F_MEM_NODRAIN);
 
 	PMEMobjpool *rep = pop->replica;
 	while (rep) {
 		void *rdest = (char *)rep + (uintptr_t)dest - (uintptr_t)pop;
+		int locked = obj_rebuild_lock(rep->rebuild);
 		rep->memset_local(rdest, c, len,
-			flags & PMEM_F_MEM_VALID_FLAGS);
+			(flags & PMEM_F_MEM_VALID_FLAGS) | PMEM_F_MEM_NODRAIN);
+		obj_rebuild_unlock(rep->rebuild, locked);
 		rep = rep->replica;
 	}
 
+	if (obj_rep_needs_drain(flags))
+		obj_rep_drain(pop);
+
 	return ret;
 }
 
@@ -479,15 +556,22 @@ obj_rep_persist(void *ctx, const void *addr, size_t len, unsigned flags)
 	PMEMobjpool *pop = ctx;
 	LOG(15, "pop %p addr %p len %zu", pop, addr, len);
 
-	pop->persist_local(addr, len);
+	obj_dirty_mark(pop, addr, len);
+
+	/* flush all the replicas first, then drain them at once */
+	pop->flush_local(addr, len);
 
 	PMEMobjpool *rep = pop->replica;
 	while (rep) {
 		void *raddr = (char *)rep + (uintptr_t)addr - (uintptr_t)pop;
-		rep->memcpy_local(raddr, addr, len, 0);
+		int locked = obj_rebuild_lock(rep->rebuild);
+		rep->memcpy_local(raddr, addr, len, PMEM_F_MEM_NODRAIN);
+		obj_rebuild_unlock(rep->rebuild, locked);
 		rep = rep->replica;
 	}
 
+	obj_rep_drain(pop);
+
 	return 0;
 }
 
@@ -503,12 +587,16 @@ obj_rep_flush(void *ctx, const void *addr, size_t len, unsigned flags)
 	PMEMobjpool *pop = ctx;
 	LOG(15, "pop %p addr %p len %zu", pop, addr, len);
 
+	obj_dirty_mark(pop, addr, len);
+
 	pop->flush_local(addr, len);
 
 	PMEMobjpool *rep = pop->replica;
 	while (rep) {
 		void *raddr = (char *)rep + (uintptr_t)addr - (uintptr_t)pop;
+		int locked = obj_rebuild_lock(rep->rebuild);
 		rep->memcpy_local(raddr, addr, len, PMEM_F_MEM_NODRAIN);
+		obj_rebuild_unlock(rep->rebuild, locked);
 		rep = rep->replica;
 	}
 
@@ -524,12 +612,16 @@ obj_rep_drain(void *ctx)
 	PMEMobjpool *pop = ctx;
 	LOG(15, "pop %p", pop);
 
-	pop->drain_local();
-
-	PMEMobjpool *rep = pop->replica;
-	while (rep) {
-		rep->drain_local();
-		rep = rep->replica;
+	/*
+	 * The replicas which are not on pmem are synced by their flush
+	 * functions, and a single drain makes the stores to all the others
+	 * persistent.
+	 */
+	for (PMEMobjpool *rep = pop; rep != NULL; rep = rep->replica) {
+		if (rep->is_pmem) {
+			rep->drain_local();
+			return;
+		}
 	}
 }
 
@@ -863,6 +955,7 @@ obj_replica_init(PMEMobjpool *rep, struct pool_set *set, unsigned repidx)
 			rep->p_ops.memmove = obj_norep_memmove;
 			rep->p_ops.memset = obj_norep_memset;
 		}
+		rep->p_ops.mark = obj_mark;
 		rep->p_ops.base = rep;
 	} else {
 		/* non-master replicas */
@@ -874,6 +967,7 @@ obj_replica_init(PMEMobjpool *rep, struct pool_set *set, unsigned repidx)
 		rep->p_ops.memcpy = NULL;
 		rep->p_ops.memmove = NULL;
 		rep->p_ops.memset = NULL;
+		rep->p_ops.mark = NULL;
 
 		rep->p_ops.base = NULL;
 	}
@@ -1315,6 +1409,11 @@ obj_replicas_check_basic(PMEMobjpool *pop)
 	PMEMobjpool *rep;
 	for (unsigned r = 0; r < pop->set->nreplicas; r++) {
 		rep = pop->set->replica[r]->part[0].addr;
+
+		/* the data of the replica is not complete yet */
+		if (rep->rebuild != NULL)
+			continue;
+
 		if (obj_check_basic(rep, pop->set->poolsize) == 0) {
 			ERR_WO_ERRNO("inconsistent replica #%u", r);
 			return -1;
@@ -1334,6 +1433,52 @@ obj_replicas_check_basic(PMEMobjpool *pop)
 	return 0;
 }
 
+/*
+ * obj_dirty_init -- (internal) start tracking the chunks modified since
+ *	the last backup, if enabled and the pool has a dirty map
+ */
+static int
+obj_dirty_init(PMEMobjpool *pop, unsigned flags)
+{
+	pop->dirty = NULL;
+
+	/* the changes of a copy-on-write mapping never reach the pool */
+	if (!Dirty_map_at_open || (flags & POOL_OPEN_COW))
+		return 0;
+
+	char *path = util_dirty_map_path(pop->set->path);
+	if (path == NULL)
+		return -1;
+
+	int ret = 0;
+	pop->dirty = util_dirty_map_open(path, pop->hdr.poolset_uuid,
+		pop->set->poolsize);
+	if (pop->dirty == NULL) {
+		if (errno == EINVAL)
+			CORE_LOG_WARNING(
+				"%s: dirty map not valid, modified chunks are not tracked",
+				path);
+		else if (errno != ENOENT)
+			ret = -1;
+	}
+
+	Free(path);
+	return ret;
+}
+
+/*
+ * obj_dirty_fini -- (internal) stop tracking the modified chunks
+ */
+static void
+obj_dirty_fini(PMEMobjpool *pop)
+{
+	if (pop->dirty == NULL)
+		return;
+
+	util_dirty_map_close(pop->dirty);
+	pop->dirty = NULL;
+}
+
 /*
  * obj_open_common -- open a transactional memory pool (set)
  *
@@ -1367,9 +1512,17 @@ obj_open_common(const char *path, const char *layout, unsigned flags, int boot)
 	if (obj_replicas_init(set))
 		goto replicas_init;
 
+	if (obj_rebuild_init(set))
+		goto err_rebuild_init;
+
 	for (unsigned r = 0; r < set->nreplicas; r++) {
 		struct pool_replica *repset = set->replica[r];
 		PMEMobjpool *rep = repset->part[0].addr;
+
+		/* the descriptor is copied by the online rebuild */
+		if (rep->rebuild != NULL)
+			continue;
+
 		/* check descriptor */
 		if (obj_descr_check(rep, layout, set->poolsize) != 0) {
 			CORE_LOG_ERROR(
@@ -1380,6 +1533,10 @@ obj_open_common(const char *path, const char *layout, unsigned flags, int boot)
 
 	pop->set = set;
 
+	/* track the changes made by the recovery as well */
+	if (obj_dirty_init(pop, flags))
+		goto err_dirty_init;
+
 	if (boot) {
 		/* check consistency of 'master' replica */
 		if (obj_check_basic(pop, pop->set->poolsize) == 0) {
@@ -1411,6 +1568,10 @@ obj_open_common(const char *path, const char *layout, unsigned flags, int boot)
 		obj_vg_boot(pop);
 #endif
 
+	/* copy the data of the replicas being rebuilt in the background */
+	if (boot && !(flags & POOL_OPEN_COW))
+		obj_rebuild_start(pop);
+
 	util_poolset_fdclose(set);
 	os_mutex_unlock(&pools_mutex);
 
@@ -1421,7 +1582,11 @@ obj_open_common(const char *path, const char *layout, unsigned flags, int boot)
 err_runtime_init:
 err_replicas_check_basic:
 err_check_basic:
+	obj_dirty_fini(pop);
+err_dirty_init:
 err_descr_check:
+	obj_rebuild_fini(set);
+err_rebuild_init:
 	obj_replicas_fini(set);
 replicas_init:
 	obj_pool_close(set);
@@ -1506,6 +1671,8 @@ obj_pool_cleanup(PMEMobjpool *pop)
 {
 	LOG(3, "pop %p", pop);
 
+	obj_rebuild_fini(pop->set);
+
 	ravl_delete(pop->ulog_user_buffers.map);
 	util_mutex_destroy(&pop->ulog_user_buffers.lock);
 
@@ -1518,6 +1685,8 @@ obj_pool_cleanup(PMEMobjpool *pop)
 	lane_section_cleanup(pop);
 	lane_cleanup(pop);
 
+	obj_dirty_fini(pop);
+
 	/* unmap all the replicas */
 	util_poolset_close(pop->set, DO_NOT_DELETE_PARTS);
 }
@@ -1584,6 +1753,8 @@ pmemobj_checkU(const char *path, const char *layout)
 	if (consistent) {
 		obj_pool_cleanup(pop);
 	} else {
+		obj_rebuild_fini(pop->set);
+		obj_dirty_fini(pop);
 		stats_delete(pop, pop->stats);
 		tx_params_delete(pop->tx_params);
 		ctl_delete(pop->ctl);
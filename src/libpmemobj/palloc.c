@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2024, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * palloc.c -- implementation of pmalloc POSIX-like API
@@ -121,6 +121,14 @@ alloc_prep_block(struct palloc_heap *heap, const struct memory_block *m,
 	VALGRIND_DO_MAKE_MEM_UNDEFINED(uptr, usize);
 	VALGRIND_ANNOTATE_NEW_MEMORY(uptr, usize);
 
+	/*
+	 * The header and the constructor may write to the block before it
+	 * gets published, so the whole block has to be marked as modified
+	 * before any of that reaches the pool.
+	 */
+	pmemops_mark(&heap->p_ops, m->m_ops->get_real_data(m),
+		m->m_ops->get_real_size(m));
+
 	m->m_ops->write_header(m, extra_field, object_flags);
 
 	/*
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2016-2022, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 #ifndef LIBPMEMOBJ_PMEMOPS_H
 #define LIBPMEMOBJ_PMEMOPS_H 1
@@ -22,6 +22,7 @@ typedef void *(*memmove_fn)(void *base, void *dest, const void *src, size_t len,
 		unsigned flags);
 typedef void *(*memset_fn)(void *base, void *dest, int c, size_t len,
 		unsigned flags);
+typedef void (*mark_fn)(void *base, const void *, size_t);
 
 struct pmem_ops {
 	/* for 'master' replica: with or without data replication */
@@ -31,6 +32,7 @@ struct pmem_ops {
 	memcpy_fn memcpy; /* persistent memcpy function */
 	memmove_fn memmove; /* persistent memmove function */
 	memset_fn memset; /* persistent memset function */
+	mark_fn mark;	/* marks the range as about to be modified, optional */
 	void *base;
 };
 
@@ -87,6 +89,13 @@ pmemops_memset(const struct pmem_ops *p_ops, void *dest, int c,
 	return p_ops->memset(p_ops->base, dest, c, len, flags);
 }
 
+static force_inline void
+pmemops_mark(const struct pmem_ops *p_ops, const void *d, size_t s)
+{
+	if (p_ops->mark != NULL)
+		p_ops->mark(p_ops->base, d, s);
+}
+
 #ifdef __cplusplus
 }
 #endif
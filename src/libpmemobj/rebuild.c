@@ -0,0 +1,342 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * rebuild.c -- online rebuild of replicas
+ *
+ * A replica recreated by pmempool_sync with PMEMPOOL_SYNC_ONLINE_REBUILD
+ * is marked by a file next to the pool set file. When such a pool is opened,
+ * all writes are mirrored to the replica as usual, while a background thread
+ * copies the rest of the data from the master replica in bounded slices.
+ * The progress is stored in the marker file, so the copy resumes where it
+ * stopped if the pool is closed in the meantime. Once the whole pool is
+ * copied, the marker is removed and the replica is considered healthy.
+ */
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "core_assert.h"
+#include "ctl.h"
+#include "obj.h"
+#include "out.h"
+#include "rebuild.h"
+
+size_t Rebuild_slice_size = OBJ_REBUILD_SLICE_SIZE;
+
+/*
+ * obj_rebuild_init -- find the replicas being rebuilt and allocate
+ *	their runtime state
+ */
+int
+obj_rebuild_init(struct pool_set *set)
+{
+	LOG(3, "set %p", set);
+
+	PMEMobjpool *pop = set->replica[0]->part[0].addr;
+
+	for (unsigned r = 0; r < set->nreplicas; r++) {
+		uint64_t offset;
+		int ret = util_rebuild_get(set, r, &offset);
+		if (ret < 0)
+			goto err;
+		if (ret == 0)
+			continue;
+
+		if (r == 0) {
+			ERR_WO_ERRNO(
+				"the master replica cannot be rebuilt online");
+			errno = EINVAL;
+			goto err;
+		}
+
+		struct obj_rebuild *rb = Zalloc(sizeof(*rb));
+		if (rb == NULL) {
+			ERR_W_ERRNO("Zalloc");
+			goto err;
+		}
+
+		rb->pop = pop;
+		rb->rep = set->replica[r]->part[0].addr;
+		rb->repidx = r;
+		rb->offset = offset < POOL_HDR_SIZE ? POOL_HDR_SIZE : offset;
+		util_rwlock_init(&rb->lock);
+
+		rb->rep->rebuild = rb;
+
+		LOG(3, "replica #%u is being rebuilt from offset %" PRIu64, r,
+			rb->offset);
+	}
+
+	return 0;
+
+err:
+	obj_rebuild_fini(set);
+	return -1;
+}
+
+/*
+ * obj_rebuild_copy -- (internal) copy a range of the pool from the master
+ *	replica, excluding the run-time part of the pool descriptor
+ */
+static uint64_t
+obj_rebuild_copy(struct obj_rebuild *rb, uint64_t offset, uint64_t end)
+{
+	const uint64_t rt_begin = offsetof(struct pmemobjpool, addr);
+	const uint64_t rt_end = sizeof(struct pmemobjpool);
+
+	if (offset >= rt_begin && offset < rt_end)
+		offset = rt_end;
+
+	if (offset >= end)
+		return end;
+
+	size_t len = (size_t)(end - offset);
+	if (len > Rebuild_slice_size)
+		len = Rebuild_slice_size;
+	if (offset < rt_begin && offset + len > rt_begin)
+		len = (size_t)(rt_begin - offset);
+
+	util_rwlock_wrlock(&rb->lock);
+	rb->rep->memcpy_local((char *)rb->rep + offset,
+		(char *)rb->pop + offset, len, 0);
+	util_rwlock_unlock(&rb->lock);
+
+	return offset + len;
+}
+
+/*
+ * obj_rebuild_worker -- (internal) copy the data of the replica in
+ *	the background
+ */
+static void *
+obj_rebuild_worker(void *arg)
+{
+	struct obj_rebuild *rb = arg;
+	struct pool_set *set = rb->pop->set;
+	uint64_t end = set->poolsize;
+	uint64_t checkpoint = rb->offset;
+
+	LOG(3, "replica #%u offset %" PRIu64 " end %" PRIu64, rb->repidx,
+		rb->offset, end);
+
+	while (rb->offset < end) {
+		int stop;
+		util_atomic_load_explicit32(&rb->stop, &stop,
+			memory_order_acquire);
+		if (stop)
+			return NULL;
+
+		rb->offset = obj_rebuild_copy(rb, rb->offset, end);
+
+		if (rb->offset - checkpoint >= OBJ_REBUILD_CHECKPOINT) {
+			if (util_rebuild_set(set, rb->repidx, rb->offset))
+				CORE_LOG_ERROR(
+					"cannot store the rebuild progress of replica #%u",
+					rb->repidx);
+			checkpoint = rb->offset;
+		}
+	}
+
+	util_atomic_store_explicit32(&rb->done, 1, memory_order_release);
+
+	if (util_rebuild_clear(set, rb->repidx))
+		CORE_LOG_ERROR(
+			"cannot remove the rebuild marker of replica #%u",
+			rb->repidx);
+
+	LOG(3, "replica #%u rebuilt", rb->repidx);
+
+	return NULL;
+}
+
+/*
+ * obj_rebuild_start -- start copying the data of the replicas being rebuilt
+ *
+ * A replica whose copy cannot be started is still mirrored, it will be
+ * rebuilt the next time the pool is opened.
+ */
+void
+obj_rebuild_start(PMEMobjpool *pop)
+{
+	LOG(3, "pop %p", pop);
+
+	struct pool_set *set = pop->set;
+
+	for (unsigned r = 1; r < set->nreplicas; r++) {
+		PMEMobjpool *rep = set->replica[r]->part[0].addr;
+		struct obj_rebuild *rb = rep->rebuild;
+		if (rb == NULL)
+			continue;
+
+		int ret = os_thread_create(&rb->thread, NULL,
+			obj_rebuild_worker, rb);
+		if (ret) {
+			errno = ret;
+			CORE_LOG_WARNING_W_ERRNO(
+				"cannot start the rebuild of replica #%u", r);
+			continue;
+		}
+
+		rb->started = 1;
+	}
+}
+
+/*
+ * obj_rebuild_fini -- stop copying the data, store the progress and free
+ *	the runtime state of the replicas being rebuilt
+ */
+void
+obj_rebuild_fini(struct pool_set *set)
+{
+	LOG(3, "set %p", set);
+
+	int oerrno = errno;
+
+	for (unsigned r = 1; r < set->nreplicas; r++) {
+		PMEMobjpool *rep = set->replica[r]->part[0].addr;
+		struct obj_rebuild *rb = rep->rebuild;
+		if (rb == NULL)
+			continue;
+
+		util_atomic_store_explicit32(&rb->stop, 1,
+			memory_order_release);
+
+		if (rb->started)
+			os_thread_join(&rb->thread, NULL);
+
+		if (!rb->done && rb->started) {
+			if (util_rebuild_set(set, r, rb->offset))
+				CORE_LOG_ERROR(
+					"cannot store the rebuild progress of replica #%u",
+					r);
+		}
+
+		util_rwlock_destroy(&rb->lock);
+		rep->rebuild = NULL;
+		Free(rb);
+	}
+
+	errno = oerrno;
+}
+
+/*
+ * obj_rebuild_pending -- return the number of replicas not rebuilt yet
+ */
+unsigned
+obj_rebuild_pending(PMEMobjpool *pop)
+{
+	struct pool_set *set = pop->set;
+	unsigned pending = 0;
+
+	for (unsigned r = 1; r < set->nreplicas; r++) {
+		PMEMobjpool *rep = set->replica[r]->part[0].addr;
+		struct obj_rebuild *rb = rep->rebuild;
+		if (rb == NULL)
+			continue;
+
+		int done;
+		util_atomic_load_explicit32(&rb->done, &done,
+			memory_order_acquire);
+		if (!done)
+			pending++;
+	}
+
+	return pending;
+}
+
+/*
+ * CTL_READ_HANDLER(rebuild_pending) -- returns the number of replicas
+ *	being rebuilt
+ */
+static int
+CTL_READ_HANDLER(rebuild_pending)(void *ctx,
+	enum ctl_query_source source, void *arg, struct ctl_indexes *indexes)
+{
+	/* suppress unused-parameter errors */
+	SUPPRESS_UNUSED(source, indexes);
+
+	PMEMobjpool *pop = ctx;
+	int *arg_out = arg;
+
+	*arg_out = (int)obj_rebuild_pending(pop);
+
+	return 0;
+}
+
+static const struct ctl_node CTL_NODE(replica)[] = {
+	CTL_LEAF_RO(rebuild_pending),
+
+	CTL_NODE_END
+};
+
+/*
+ * rebuild_ctl_register -- registers ctl nodes of the replicas
+ */
+void
+rebuild_ctl_register(PMEMobjpool *pop)
+{
+	CTL_REGISTER_MODULE(pop->ctl, replica);
+}
+
+/*
+ * CTL_READ_HANDLER(rebuild_slice_size) -- returns the size of the range
+ *	copied at once while rebuilding a replica
+ */
+static int
+CTL_READ_HANDLER(rebuild_slice_size)(void *ctx,
+	enum ctl_query_source source, void *arg, struct ctl_indexes *indexes)
+{
+	/* suppress unused-parameter errors */
+	SUPPRESS_UNUSED(ctx, source, indexes);
+
+	ssize_t *arg_out = arg;
+
+	*arg_out = (ssize_t)Rebuild_slice_size;
+
+	return 0;
+}
+
+/*
+ * CTL_WRITE_HANDLER(rebuild_slice_size) -- sets the size of the range
+ *	copied at once while rebuilding a replica
+ */
+static int
+CTL_WRITE_HANDLER(rebuild_slice_size)(void *ctx,
+	enum ctl_query_source source, void *arg, struct ctl_indexes *indexes)
+{
+	/* suppress unused-parameter errors */
+	SUPPRESS_UNUSED(ctx, source, indexes);
+
+	long long arg_in = *(long long *)arg;
+	if (arg_in < (long long)Pagesize) {
+		ERR_WO_ERRNO(
+			"incorrect rebuild slice size, must be at least %llu",
+			Pagesize);
+		errno = EINVAL;
+		return -1;
+	}
+
+	Rebuild_slice_size = (size_t)arg_in;
+
+	return 0;
+}
+
+static const struct ctl_argument CTL_ARG(rebuild_slice_size) =
+	CTL_ARG_LONG_LONG;
+
+static const struct ctl_node CTL_NODE(replica_global)[] = {
+	CTL_LEAF_RW(rebuild_slice_size),
+
+	CTL_NODE_END
+};
+
+/*
+ * rebuild_global_ctl_register -- registers global ctl nodes of the replicas
+ */
+void
+rebuild_global_ctl_register(void)
+{
+	ctl_register_module_node(NULL, "replica",
+		(struct ctl_node *)CTL_NODE(replica_global));
+}
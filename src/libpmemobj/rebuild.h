@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * rebuild.h -- internal definitions for the online rebuild of replicas
+ */
+#ifndef LIBPMEMOBJ_REBUILD_H
+#define LIBPMEMOBJ_REBUILD_H 1
+
+#include <stdint.h>
+
+#include "os_thread.h"
+#include "set.h"
+#include "sys_util.h"
+#include "util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* default size of the range copied at once while rebuilding a replica */
+#define OBJ_REBUILD_SLICE_SIZE ((size_t)4 << 20)
+
+/* the progress of the rebuild is stored each time this much data is copied */
+#define OBJ_REBUILD_CHECKPOINT ((uint64_t)1 << 30)
+
+extern size_t Rebuild_slice_size;
+
+/*
+ * obj_rebuild -- runtime state of the replica being rebuilt online
+ *
+ * The background thread copies the data from the master replica holding
+ * the lock for writing, while the writes mirrored to the replica hold it
+ * for reading, so a slice read from the master can never overwrite newer
+ * data in the replica.
+ */
+struct obj_rebuild {
+	struct pmemobjpool *pop;	/* master replica */
+	struct pmemobjpool *rep;	/* replica being rebuilt */
+	unsigned repidx;
+
+	os_rwlock_t lock;
+	os_thread_t thread;
+	int started;
+
+	uint64_t offset;	/* data below this offset is up to date */
+	int stop;		/* set when the pool is being closed */
+	int done;		/* set when the replica is complete */
+};
+
+int obj_rebuild_init(struct pool_set *set);
+void obj_rebuild_start(struct pmemobjpool *pop);
+void obj_rebuild_fini(struct pool_set *set);
+unsigned obj_rebuild_pending(struct pmemobjpool *pop);
+
+void rebuild_ctl_register(struct pmemobjpool *pop);
+void rebuild_global_ctl_register(void);
+
+/*
+ * obj_rebuild_lock -- acquire the lock for a write mirrored to the replica,
+ *	returns 1 if the lock has been taken
+ */
+static inline int
+obj_rebuild_lock(struct obj_rebuild *rb)
+{
+	if (rb == NULL)
+		return 0;
+
+	int done;
+	util_atomic_load_explicit32(&rb->done, &done, memory_order_acquire);
+	if (done)
+		return 0;
+
+	util_rwlock_rdlock(&rb->lock);
+	return 1;
+}
+
+/*
+ * obj_rebuild_unlock -- release the lock taken by obj_rebuild_lock
+ */
+static inline void
+obj_rebuild_unlock(struct obj_rebuild *rb, int locked)
+{
+	if (locked)
+		util_rwlock_unlock(&rb->lock);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBPMEMOBJ_REBUILD_H */
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2017-2024, Intel Corporation */
+/* Copyright 2017-2026, Intel Corporation */
 
 /*
  * stats.c -- implementation of statistics
@@ -13,11 +13,25 @@ STATS_CTL_HANDLER(persistent, curr_allocated, heap_curr_allocated);
 
 STATS_CTL_HANDLER(transient, run_allocated, heap_run_allocated);
 STATS_CTL_HANDLER(transient, run_active, heap_run_active);
+STATS_CTL_HANDLER(transient, zone_reclaim_time, heap_zone_reclaim_time);
 
 static const struct ctl_node CTL_NODE(heap)[] = {
 	STATS_CTL_LEAF(persistent, curr_allocated),
 	STATS_CTL_LEAF(transient, run_allocated),
 	STATS_CTL_LEAF(transient, run_active),
+	STATS_CTL_LEAF(transient, zone_reclaim_time),
+
+	CTL_NODE_END
+};
+
+STATS_CTL_HANDLER(transient, redo_recovery_time, boot_redo_recovery_time);
+STATS_CTL_HANDLER(transient, heap_time, boot_heap_time);
+STATS_CTL_HANDLER(transient, undo_recovery_time, boot_undo_recovery_time);
+
+static const struct ctl_node CTL_NODE(boot)[] = {
+	STATS_CTL_LEAF(transient, redo_recovery_time),
+	STATS_CTL_LEAF(transient, heap_time),
+	STATS_CTL_LEAF(transient, undo_recovery_time),
 
 	CTL_NODE_END
 };
@@ -108,6 +122,7 @@ static const struct ctl_argument CTL_ARG(enabled) = {
 
 static const struct ctl_node CTL_NODE(stats)[] = {
 	CTL_CHILD(heap),
+	CTL_CHILD(boot),
 	CTL_LEAF_RW(enabled),
 
 	CTL_NODE_END
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2017-2021, Intel Corporation */
+/* Copyright 2017-2026, Intel Corporation */
 
 /*
  * stats.h -- definitions of statistics
@@ -8,8 +8,11 @@
 #ifndef LIBPMEMOBJ_STATS_H
 #define LIBPMEMOBJ_STATS_H 1
 
+#include <time.h>
+
 #include "ctl.h"
 #include "libpmemobj/ctl.h"
+#include "os.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,6 +21,10 @@ extern "C" {
 struct stats_transient {
 	uint64_t heap_run_allocated;
 	uint64_t heap_run_active;
+	uint64_t heap_zone_reclaim_time;
+	uint64_t boot_redo_recovery_time;
+	uint64_t boot_heap_time;
+	uint64_t boot_undo_recovery_time;
 };
 
 struct stats_persistent {
@@ -99,6 +106,17 @@ static int CTL_READ_HANDLER(type##_##name)(void *ctx,\
 	return 0;\
 }
 
+/*
+ * stats_time_nsecs -- monotonic time in nanoseconds, for the time statistics
+ */
+static inline uint64_t
+stats_time_nsecs(void)
+{
+	struct timespec ts;
+	os_clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 void stats_ctl_register(PMEMobjpool *pop);
 
 struct stats *stats_new(PMEMobjpool *pop);
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2024, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * tx.c -- transactions implementation
@@ -1178,6 +1178,9 @@ pmemobj_tx_add_snapshot(struct tx *tx, struct tx_range_def *snapshot)
 
 	VALGRIND_ADD_TO_TX(ptr, snapshot->size);
 
+	/* the range is going to be modified directly by the application */
+	pmemops_mark(&tx->pop->p_ops, ptr, snapshot->size);
+
 	/* do nothing */
 	if (snapshot->flags & POBJ_XADD_NO_SNAPSHOT)
 		return 0;
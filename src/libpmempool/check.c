@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2023, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * check.c -- functions performing checks in proper order
@@ -52,6 +52,11 @@ static const struct step steps[] = {
 		.func		= check_pool_hdr_uuids,
 		.part		= true,
 	},
+	{
+		.type		= POOL_TYPE_OBJ,
+		.func		= check_heap,
+		.part		= false,
+	},
 	{
 		.func		= NULL,
 	},
@@ -114,8 +119,11 @@ status_get(PMEMpoolcheck *ppc)
 
 		/* process answers otherwise */
 		ppc->result = CHECK_RESULT_PROCESS_ANSWERS;
-	} else if (CHECK_RESULT_IS_STOP(ppc->result))
+	} else if (CHECK_RESULT_IS_STOP(ppc->result) &&
+			!check_get_step_data(ppc->data)->in_progress) {
+		/* a step which is in progress may still report the details */
 		check_end(ppc->data);
+	}
 
 	return NULL;
 }
@@ -154,8 +162,12 @@ check_step(PMEMpoolcheck *ppc)
 	/* perform step */
 	step->func(ppc);
 
-	/* move on to next step if no questions were generated */
-	if (ppc->result != CHECK_RESULT_ASK_QUESTIONS)
+	/*
+	 * move on to next step if no questions were generated and the step
+	 * does not need to be continued
+	 */
+	if (ppc->result != CHECK_RESULT_ASK_QUESTIONS &&
+			!check_get_step_data(ppc->data)->in_progress)
 		check_step_inc(ppc->data);
 
 	/* get current status and return */
@@ -170,6 +182,9 @@ check_fini(PMEMpoolcheck *ppc)
 {
 	LOG(3, NULL);
 
+	/* the workers of the heap check use the pool */
+	check_heap_fini(ppc);
+
 	pool_data_free(ppc->pool);
 	check_data_free(ppc->data);
 }
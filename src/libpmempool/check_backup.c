@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2024, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * check_backup.c -- pre-check backup
@@ -220,15 +220,32 @@ err:
 static int
 backup_poolset(PMEMpoolcheck *ppc, location *loc, int overwrite)
 {
-	struct pool_replica *srep = ppc->pool->set_file->poolset->replica[0];
+	struct pool_set *set = ppc->pool->set_file->poolset;
+	struct pool_replica *srep = set->replica[0];
 	struct pool_replica *drep = loc->set->replica[0];
+
+	/* the free chunks of the heap do not have to be copied */
+	struct pool_ranges unused = VEC_INITIALIZER;
+	if (ppc->pool->params.type == POOL_TYPE_OBJ)
+		(void) pool_obj_unused_ranges(srep->part[0].addr,
+			set->poolsize, &unused);
+
+	size_t hdrsize = (set->options & (OPTION_SINGLEHDR | OPTION_NOHDRS)) ?
+		0 : Mmap_align;
+
 	for (unsigned p = 0; p < srep->nparts; p++) {
 		if (overwrite == 0) {
 			CHECK_INFO(ppc, "creating backup file: %s",
 				drep->part[p].path);
 		}
+
+		uint64_t pool_off = (uintptr_t)srep->part[p].addr -
+			(uintptr_t)srep->part[0].addr;
+		uint64_t data_off = p == 0 ? 0 : hdrsize;
+
 		if (pool_set_part_copy(&drep->part[p], &srep->part[p],
-				overwrite)) {
+				overwrite, &unused, data_off, pool_off)) {
+			VEC_DELETE(&unused);
 			location_release(loc);
 			ppc->result = CHECK_RESULT_ERROR;
 			CHECK_INFO(ppc, "unable to create backup file");
@@ -236,6 +253,7 @@ backup_poolset(PMEMpoolcheck *ppc, location *loc, int overwrite)
 		}
 	}
 
+	VEC_DELETE(&unused);
 	return 0;
 }
 
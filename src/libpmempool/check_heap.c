@@ -0,0 +1,784 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * check_heap.c -- obj pool heap and lanes check
+ *
+ * The descriptor, the heap header and the lanes are verified first. Then
+ * the worker threads are started, and each of them verifies the zones whose
+ * indices it takes from a shared counter, until none are left. The step
+ * returns each time the next batch of zones is verified, so the progress
+ * can be reported, and it is called again until the workers are done.
+ *
+ * When all the zones are verified, the error of the first broken zone is
+ * reported, and the step is called once more to report the other broken
+ * zones.
+ */
+
+#include <endian.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "out.h"
+#include "os.h"
+#include "os_thread.h"
+#include "sys_util.h"
+#include "util.h"
+#include "libpmempool.h"
+#include "pmempool.h"
+#include "pool.h"
+#include "obj.h"
+#include "lane.h"
+#include "heap_layout.h"
+#include "check_util.h"
+
+#define HEAP_CHECK_STR	"checking heap"
+#define HEAP_OK_STR	"heap correct"
+
+/* maximum number of threads used to verify the zones */
+#define HEAP_MAX_THREADS 64
+
+/* default number of threads used to verify the zones */
+#define HEAP_DEFAULT_THREADS 8
+
+/* number of zones verified by a single thread between progress reports */
+#define HEAP_ZONES_PER_THREAD 4
+
+#define HEAP_MSG_MAX 128
+
+/*
+ * heap_zone_result -- result of a single zone verification
+ */
+struct heap_zone_result {
+	char msg[HEAP_MSG_MAX];	/* empty if the zone is correct */
+};
+
+/*
+ * heap_check -- state of the heap check, kept between the calls of the step
+ */
+struct heap_check {
+	struct heap_layout *layout;
+	uint64_t heap_size;
+	unsigned nzones;
+
+	unsigned next;		/* index of the next zone to verify */
+	int stop;		/* the check was interrupted */
+	struct heap_zone_result *results;
+
+	os_mutex_t lock;
+	os_cond_t cond;
+	unsigned checked;	/* number of verified zones */
+	unsigned running;	/* number of running workers */
+
+	unsigned reported;	/* number of zones reported as verified */
+	unsigned broken;	/* the first broken zone, nzones if none */
+
+	unsigned nthreads;
+	os_thread_t threads[HEAP_MAX_THREADS];
+};
+
+/*
+ * heap_nthreads -- (internal) number of threads used to verify the zones
+ */
+static unsigned
+heap_nthreads(PMEMpoolcheck *ppc)
+{
+	if (ppc->args.nthreads > 0)
+		return min(ppc->args.nthreads, HEAP_MAX_THREADS);
+
+	long nthreads = HEAP_DEFAULT_THREADS;
+
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (ncpus > 0 && ncpus < nthreads)
+		nthreads = ncpus;
+
+	/*
+	 * For testing and platform tuning the number of threads can be
+	 * overridden using PMEMPOOL_CHECK_THREADS env variable.
+	 */
+	const char *ptr = os_getenv("PMEMPOOL_CHECK_THREADS");
+	if (ptr) {
+		long val = atol(ptr);
+
+		if (val < 1 || val > HEAP_MAX_THREADS) {
+			LOG(3, "Invalid PMEMPOOL_CHECK_THREADS");
+		} else {
+			LOG(3, "PMEMPOOL_CHECK_THREADS set to %ld", val);
+			nthreads = val;
+		}
+	}
+
+	return (unsigned)nthreads;
+}
+
+/*
+ * heap_max_zone -- (internal) calculate how many zones can the heap fit
+ */
+static unsigned
+heap_max_zone(uint64_t size)
+{
+	unsigned max_zone = 0;
+	size -= sizeof(struct heap_header);
+
+	while (size >= ZONE_MIN_SIZE) {
+		max_zone++;
+		size -= size <= ZONE_MAX_SIZE ? size : ZONE_MAX_SIZE;
+	}
+
+	return max_zone;
+}
+
+/*
+ * heap_zone_max_size_idx -- (internal) calculate the number of chunks
+ *	available in the zone
+ */
+static uint32_t
+heap_zone_max_size_idx(const struct heap_check *hc, unsigned zid)
+{
+	if (zid < hc->nzones - 1)
+		return MAX_CHUNK;
+
+	size_t zone_raw_size = hc->heap_size - zid * ZONE_MAX_SIZE -
+		sizeof(struct zone_header) -
+		sizeof(struct chunk_header) * MAX_CHUNK -
+		sizeof(struct heap_header);
+
+	return (uint32_t)(zone_raw_size / CHUNKSIZE);
+}
+
+/*
+ * heap_run_bitmap -- (internal) calculate the number of units and the size
+ *	of the bitmap of a run, the same way libpmemobj does
+ *
+ * Returns the number of chunks the run would be created with.
+ */
+static uint32_t
+heap_run_bitmap(uint32_t size_idx, uint16_t flags, uint64_t unit_size,
+	uint64_t alignment, unsigned *nbits, size_t *bitmap_size)
+{
+	if (flags & CHUNK_FLAG_FLEX_BITMAP) {
+		size_t content_size = RUN_CONTENT_SIZE_BYTES(size_idx);
+		unsigned n = (unsigned)(content_size / unit_size);
+		unsigned nvalues = util_div_ceil(n, RUN_BITS_PER_VALUE);
+
+		nvalues = ALIGN_UP(nvalues + RUN_BASE_METADATA_VALUES,
+			(unsigned)(CACHELINE_SIZE / sizeof(uint64_t)))
+			- RUN_BASE_METADATA_VALUES;
+
+		*bitmap_size = nvalues * sizeof(uint64_t);
+		*nbits = (unsigned)((content_size - *bitmap_size) / unit_size)
+			- (alignment ? 1U : 0U);
+
+		return size_idx;
+	}
+
+	uint64_t n = RUN_DEFAULT_SIZE_BYTES(size_idx) / unit_size;
+	while (n > RUN_DEFAULT_BITMAP_NBITS) {
+		if (size_idx > 1) {
+			size_idx -= 1;
+			n = RUN_DEFAULT_SIZE_BYTES(size_idx) / unit_size;
+		} else {
+			n = RUN_DEFAULT_BITMAP_NBITS;
+		}
+	}
+
+	*bitmap_size = RUN_DEFAULT_BITMAP_SIZE;
+	*nbits = (unsigned)n - (alignment ? 1U : 0U);
+
+	return size_idx;
+}
+
+/*
+ * heap_chunk_header_type -- (internal) get the type of allocation headers
+ *	used in the chunk
+ */
+static enum header_type
+heap_chunk_header_type(const struct pool_obj_chunk *chunk)
+{
+	if (chunk->flags & CHUNK_FLAG_COMPACT_HEADER)
+		return HEADER_COMPACT;
+
+	if (chunk->flags & CHUNK_FLAG_HEADER_NONE)
+		return HEADER_NONE;
+
+	return HEADER_LEGACY;
+}
+
+/*
+ * heap_object_size -- (internal) read the size stored in the allocation
+ *	header of an object
+ */
+static uint64_t
+heap_object_size(const void *real_data, enum header_type type)
+{
+	if (type == HEADER_COMPACT) {
+		const struct allocation_header_compact *hdr = real_data;
+		return le64toh(hdr->size) & ALLOC_HDR_FLAGS_MASK;
+	}
+
+	const struct allocation_header_legacy *hdr = real_data;
+	return le64toh(hdr->size);
+}
+
+/*
+ * heap_run_bit -- (internal) test a bit of the run bitmap
+ */
+static inline int
+heap_run_bit(const uint64_t *values, unsigned n)
+{
+	return (le64toh(values[n / RUN_BITS_PER_VALUE]) >>
+		(n % RUN_BITS_PER_VALUE)) & 1;
+}
+
+/*
+ * heap_check_run -- (internal) verify the run metadata and the headers of
+ *	all objects allocated from the run
+ */
+static int
+heap_check_run(struct zone *zone, unsigned zid, uint32_t c,
+	const struct pool_obj_chunk *hdr, struct heap_zone_result *res)
+{
+	struct chunk_run *run = (struct chunk_run *)&zone->chunks[c];
+
+	for (uint32_t i = 1; i < hdr->size_idx; ++i) {
+		struct pool_obj_chunk data_hdr;
+		pool_obj_chunk_read(zone, c + i, &data_hdr);
+		if (data_hdr.type != CHUNK_TYPE_RUN_DATA ||
+				data_hdr.size_idx != i) {
+			util_snprintf(res->msg, HEAP_MSG_MAX,
+				"zone %u chunk %u: invalid run data chunk %u",
+				zid, c, c + i);
+			return -1;
+		}
+	}
+
+	uint64_t block_size = le64toh(run->hdr.block_size);
+	uint64_t alignment = le64toh(run->hdr.alignment);
+	if (block_size == 0 ||
+			block_size > RUN_CONTENT_SIZE_BYTES(hdr->size_idx)) {
+		util_snprintf(res->msg, HEAP_MSG_MAX,
+			"zone %u chunk %u: invalid run block size %" PRIu64,
+			zid, c, block_size);
+		return -1;
+	}
+
+	if (!(hdr->flags & CHUNK_FLAG_ALIGNED))
+		alignment = 0;
+	else if (alignment == 0 || !util_is_pow2(alignment)) {
+		util_snprintf(res->msg, HEAP_MSG_MAX,
+			"zone %u chunk %u: invalid run alignment %" PRIu64,
+			zid, c, alignment);
+		return -1;
+	}
+
+	unsigned nbits;
+	size_t bitmap_size;
+	if (heap_run_bitmap(hdr->size_idx, hdr->flags, block_size, alignment,
+			&nbits, &bitmap_size) != hdr->size_idx ||
+			nbits == 0 || nbits > bitmap_size * 8) {
+		util_snprintf(res->msg, HEAP_MSG_MAX,
+			"zone %u chunk %u: invalid run size %u",
+			zid, c, hdr->size_idx);
+		return -1;
+	}
+
+	enum header_type htype = heap_chunk_header_type(hdr);
+	if (htype == HEADER_NONE)
+		return 0; /* objects have no headers to compare with */
+
+	const uint64_t *values = (const uint64_t *)run->content;
+	size_t hsize = header_type_to_size[htype];
+	uintptr_t data = (uintptr_t)run->content + bitmap_size;
+	if (alignment)
+		data = ALIGN_UP(data + hsize, alignment) - hsize;
+
+	unsigned u = 0;
+	while (u < nbits) {
+		if (!heap_run_bit(values, u)) {
+			++u;
+			continue;
+		}
+
+		uint64_t size = heap_object_size(
+			(void *)(data + u * block_size), htype);
+		uint64_t units = size / block_size;
+		if (size == 0 || size % block_size != 0 ||
+				units > nbits - u) {
+			util_snprintf(res->msg, HEAP_MSG_MAX,
+				"zone %u chunk %u: invalid size %" PRIu64
+				" of the object at unit %u",
+				zid, c, size, u);
+			return -1;
+		}
+
+		for (unsigned i = 1; i < units; ++i) {
+			if (!heap_run_bit(values, u + i)) {
+				util_snprintf(res->msg, HEAP_MSG_MAX,
+					"zone %u chunk %u: bitmap does not "
+					"match the object at unit %u",
+					zid, c, u);
+				return -1;
+			}
+		}
+
+		u += (unsigned)units;
+	}
+
+	return 0;
+}
+
+/*
+ * heap_check_huge -- (internal) verify the header of an object occupying
+ *	whole chunks
+ */
+static int
+heap_check_huge(struct zone *zone, unsigned zid, uint32_t c,
+	const struct pool_obj_chunk *hdr, struct heap_zone_result *res)
+{
+	enum header_type htype = heap_chunk_header_type(hdr);
+	if (htype == HEADER_NONE)
+		return 0;
+
+	uint64_t size = heap_object_size(zone->chunks[c].data, htype);
+	if (size != (uint64_t)hdr->size_idx * CHUNKSIZE) {
+		util_snprintf(res->msg, HEAP_MSG_MAX,
+			"zone %u chunk %u: invalid size %" PRIu64
+			" of the object", zid, c, size);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * heap_check_zone -- (internal) verify the zone header and all its chunks
+ */
+static int
+heap_check_zone(const struct heap_check *hc, unsigned zid,
+	struct heap_zone_result *res)
+{
+	struct zone *zone = ZID_TO_ZONE(hc->layout, zid);
+
+	uint32_t magic = le32toh(zone->header.magic);
+	if (magic == 0)
+		return 0; /* not initialized, and that is OK */
+
+	if (magic != ZONE_HEADER_MAGIC) {
+		util_snprintf(res->msg, HEAP_MSG_MAX,
+			"zone %u: invalid magic 0x%x", zid, magic);
+		return -1;
+	}
+
+	uint32_t size_idx = le32toh(zone->header.size_idx);
+	if (size_idx == 0 || size_idx > heap_zone_max_size_idx(hc, zid)) {
+		util_snprintf(res->msg, HEAP_MSG_MAX,
+			"zone %u: invalid size %u", zid, size_idx);
+		return -1;
+	}
+
+	for (uint32_t c = 0; c < size_idx; ) {
+		struct pool_obj_chunk hdr;
+		pool_obj_chunk_read(zone, c, &hdr);
+
+		if (hdr.type == CHUNK_TYPE_UNKNOWN ||
+				hdr.type >= MAX_CHUNK_TYPE ||
+				hdr.type == CHUNK_TYPE_RUN_DATA) {
+			util_snprintf(res->msg, HEAP_MSG_MAX,
+				"zone %u chunk %u: invalid type %u",
+				zid, c, hdr.type);
+			return -1;
+		}
+
+		if (hdr.flags & ~CHUNK_FLAGS_ALL_VALID) {
+			util_snprintf(res->msg, HEAP_MSG_MAX,
+				"zone %u chunk %u: invalid flags 0x%x",
+				zid, c, hdr.flags);
+			return -1;
+		}
+
+		if (hdr.size_idx == 0 || hdr.size_idx > size_idx - c) {
+			util_snprintf(res->msg, HEAP_MSG_MAX,
+				"zone %u chunk %u: invalid size %u",
+				zid, c, hdr.size_idx);
+			return -1;
+		}
+
+		if (hdr.type == CHUNK_TYPE_RUN &&
+				heap_check_run(zone, zid, c, &hdr, res))
+			return -1;
+
+		if (hdr.type == CHUNK_TYPE_USED &&
+				heap_check_huge(zone, zid, c, &hdr, res))
+			return -1;
+
+		c += hdr.size_idx;
+	}
+
+	return 0;
+}
+
+/*
+ * heap_check_worker -- (internal) verify zones until there is nothing left
+ */
+static void *
+heap_check_worker(void *arg)
+{
+	struct heap_check *hc = arg;
+
+	for (;;) {
+		int stop;
+		util_atomic_load_explicit32(&hc->stop, &stop,
+			memory_order_acquire);
+		if (stop)
+			break;
+
+		unsigned i = util_fetch_and_add32(&hc->next, 1);
+		if (i >= hc->nzones)
+			break;
+
+		heap_check_zone(hc, i, &hc->results[i]);
+
+		util_mutex_lock(&hc->lock);
+		hc->checked++;
+		os_cond_signal(&hc->cond);
+		util_mutex_unlock(&hc->lock);
+	}
+
+	util_mutex_lock(&hc->lock);
+	hc->running--;
+	os_cond_signal(&hc->cond);
+	util_mutex_unlock(&hc->lock);
+
+	return NULL;
+}
+
+/*
+ * heap_check_start -- (internal) start the workers verifying the zones
+ */
+static struct heap_check *
+heap_check_start(PMEMpoolcheck *ppc, PMEMobjpool *pop,
+	const struct pool_obj_dsc *dsc)
+{
+	struct heap_check *hc = calloc(1, sizeof(*hc));
+	if (hc == NULL)
+		return NULL;
+
+	hc->layout = (struct heap_layout *)((uintptr_t)pop + dsc->heap_offset);
+	hc->heap_size = dsc->heap_size;
+	hc->nzones = heap_max_zone(dsc->heap_size);
+	hc->broken = hc->nzones;
+
+	hc->results = calloc(hc->nzones, sizeof(*hc->results));
+	if (hc->results == NULL) {
+		free(hc);
+		return NULL;
+	}
+
+	util_mutex_init(&hc->lock);
+	util_cond_init(&hc->cond);
+
+	unsigned nthreads = min(heap_nthreads(ppc), hc->nzones);
+	while (hc->nthreads < nthreads) {
+		util_mutex_lock(&hc->lock);
+		hc->running++;
+		util_mutex_unlock(&hc->lock);
+
+		if (os_thread_create(&hc->threads[hc->nthreads], NULL,
+				heap_check_worker, hc)) {
+			LOG(2, "cannot create a checking thread");
+			util_mutex_lock(&hc->lock);
+			hc->running--;
+			util_mutex_unlock(&hc->lock);
+			break;
+		}
+		hc->nthreads++;
+	}
+
+	/* no workers, the calling thread verifies all the zones */
+	if (hc->nthreads == 0) {
+		hc->running = 1;
+		heap_check_worker(hc);
+	}
+
+	return hc;
+}
+
+/*
+ * heap_check_wait -- (internal) wait until the given number of zones is
+ *	verified or all the workers are done
+ */
+static void
+heap_check_wait(struct heap_check *hc, unsigned checked)
+{
+	util_mutex_lock(&hc->lock);
+	while (hc->checked < checked && hc->running > 0)
+		os_cond_wait(&hc->cond, &hc->lock);
+	util_mutex_unlock(&hc->lock);
+}
+
+/*
+ * heap_check_stop -- (internal) stop the workers and release the state of
+ *	the heap check
+ */
+static void
+heap_check_stop(struct heap_check *hc)
+{
+	util_atomic_store_explicit32(&hc->stop, 1, memory_order_release);
+
+	for (unsigned i = 0; i < hc->nthreads; ++i)
+		os_thread_join(&hc->threads[i], NULL);
+
+	util_cond_destroy(&hc->cond);
+	util_mutex_destroy(&hc->lock);
+	free(hc->results);
+	free(hc);
+}
+
+/*
+ * heap_check_ulog -- (internal) verify the ulog and its extensions
+ */
+static int
+heap_check_ulog(PMEMpoolcheck *ppc, PMEMobjpool *pop,
+	const struct pool_obj_dsc *dsc, uint64_t lane, const char *name,
+	struct ulog *ulog, size_t capacity)
+{
+	uint64_t heap_end = dsc->heap_offset + dsc->heap_size;
+	uint64_t max_ulogs = dsc->heap_size / CACHELINE_SIZE;
+
+	/* the capacity stored in the lane might be lower than its size */
+	uint64_t ulog_capacity = le64toh(ulog->capacity);
+	if (ulog_capacity > capacity) {
+		CHECK_ERR(ppc, "lane %" PRIu64 ": invalid %s log capacity %"
+			PRIu64, lane, name, ulog_capacity);
+		return -1;
+	}
+
+	/*
+	 * extensions of the log are allocated from the heap, the log starts
+	 * at the first cacheline of the allocated object
+	 */
+	for (uint64_t n = 0; le64toh(ulog->next) != 0; ++n) {
+		uint64_t off = ALIGN_UP(le64toh(ulog->next), CACHELINE_SIZE);
+		if (n == max_ulogs || off < dsc->heap_offset ||
+				off > heap_end - sizeof(struct ulog)) {
+			CHECK_ERR(ppc, "lane %" PRIu64 ": invalid %s log "
+				"extension offset 0x%" PRIx64, lane, name,
+				off);
+			return -1;
+		}
+
+		ulog = (struct ulog *)((uintptr_t)pop + off);
+		ulog_capacity = le64toh(ulog->capacity);
+		if (ulog_capacity > heap_end - off - sizeof(struct ulog)) {
+			CHECK_ERR(ppc, "lane %" PRIu64 ": invalid %s log "
+				"extension capacity %" PRIu64, lane, name,
+				ulog_capacity);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * heap_check_lanes -- (internal) verify the logs of all lanes
+ */
+static int
+heap_check_lanes(PMEMpoolcheck *ppc, PMEMobjpool *pop,
+	const struct pool_obj_dsc *dsc)
+{
+	struct lane_layout *lanes = (struct lane_layout *)
+		((uintptr_t)pop + dsc->lanes_offset);
+
+	for (uint64_t i = 0; i < dsc->nlanes; ++i) {
+		struct lane_layout *layout = &lanes[i];
+
+		if (heap_check_ulog(ppc, pop, dsc, i, "internal redo",
+				(struct ulog *)&layout->internal,
+				LANE_REDO_INTERNAL_SIZE) ||
+			heap_check_ulog(ppc, pop, dsc, i, "external redo",
+				(struct ulog *)&layout->external,
+				LANE_REDO_EXTERNAL_SIZE) ||
+			heap_check_ulog(ppc, pop, dsc, i, "undo",
+				(struct ulog *)&layout->undo,
+				LANE_UNDO_SIZE))
+			return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * heap_check_descriptor -- (internal) verify the pool descriptor and
+ *	the heap header
+ */
+static int
+heap_check_descriptor(PMEMpoolcheck *ppc, PMEMobjpool *pop,
+	const struct pool_obj_dsc *dsc)
+{
+	uint64_t pool_size = ppc->pool->set_file->size;
+
+	void *dscp = (void *)((uintptr_t)pop + sizeof(struct pool_hdr));
+	if (!util_checksum(dscp, OBJ_DSC_P_SIZE, &pop->checksum, 0, 0)) {
+		CHECK_ERR(ppc, "invalid pool descriptor checksum");
+		return -1;
+	}
+
+	if (dsc->lanes_offset < sizeof(struct pool_hdr) + OBJ_DSC_P_SIZE ||
+			dsc->nlanes == 0 ||
+			dsc->nlanes > pool_size / sizeof(struct lane_layout) ||
+			dsc->heap_offset < dsc->lanes_offset +
+				dsc->nlanes * sizeof(struct lane_layout)) {
+		CHECK_ERR(ppc, "invalid lanes offset 0x%" PRIx64
+			" or number of lanes %" PRIu64,
+			dsc->lanes_offset, dsc->nlanes);
+		return -1;
+	}
+
+	if (dsc->heap_size < HEAP_MIN_SIZE || dsc->heap_offset > pool_size ||
+			dsc->heap_size > pool_size - dsc->heap_offset) {
+		CHECK_ERR(ppc, "invalid heap offset 0x%" PRIx64
+			" or size 0x%" PRIx64,
+			dsc->heap_offset, dsc->heap_size);
+		return -1;
+	}
+
+	struct heap_header *hdr = (struct heap_header *)
+		((uintptr_t)pop + dsc->heap_offset);
+
+	if (memcmp(hdr->signature, HEAP_SIGNATURE, HEAP_SIGNATURE_LEN) != 0) {
+		CHECK_ERR(ppc, "invalid heap signature");
+		return -1;
+	}
+
+	if (!util_checksum(hdr, sizeof(*hdr), &hdr->checksum, 0, 0)) {
+		CHECK_ERR(ppc, "invalid heap header checksum");
+		return -1;
+	}
+
+	if (le64toh(hdr->major) != HEAP_MAJOR ||
+			le64toh(hdr->chunksize) != CHUNKSIZE ||
+			le64toh(hdr->chunks_per_zone) != MAX_CHUNK) {
+		CHECK_ERR(ppc, "unsupported heap version %" PRIu64
+			" or geometry", le64toh(hdr->major));
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * heap_check_report -- (internal) report the other broken zones, after
+ *	the error of the first one was reported
+ */
+static void
+heap_check_report(PMEMpoolcheck *ppc, const struct heap_check *hc)
+{
+	for (unsigned i = hc->broken + 1; i < hc->nzones; ++i) {
+		if (hc->results[i].msg[0] != '\0')
+			CHECK_INFO(ppc, "%s", hc->results[i].msg);
+	}
+}
+
+/*
+ * check_heap -- entry point for heap checks
+ */
+void
+check_heap(PMEMpoolcheck *ppc)
+{
+	LOG(3, NULL);
+
+	/* the data of the first replica might be out of date */
+	if (ppc->sync_required)
+		return;
+
+	location *loc = check_get_step_data(ppc->data);
+	PMEMobjpool *pop = pool_set_file_map(ppc->pool->set_file, 0);
+
+	if (!loc->init_done) {
+		CHECK_INFO(ppc, HEAP_CHECK_STR);
+
+		struct pool_obj_dsc dsc;
+		pool_obj_dsc_read(pop, &dsc);
+
+		if (heap_check_descriptor(ppc, pop, &dsc) ||
+				heap_check_lanes(ppc, pop, &dsc))
+			goto err;
+
+		loc->heap = heap_check_start(ppc, pop, &dsc);
+		if (loc->heap == NULL) {
+			ppc->result = CHECK_RESULT_INTERNAL_ERROR;
+			CHECK_ERR(ppc,
+				"cannot allocate memory for the heap check");
+			return;
+		}
+		loc->init_done = true;
+	}
+
+	struct heap_check *hc = loc->heap;
+
+	/* the error of the first broken zone has already been reported */
+	if (hc->broken < hc->nzones) {
+		heap_check_report(ppc, hc);
+		check_heap_fini(ppc);
+		return;
+	}
+
+	unsigned batch = hc->nthreads ? hc->nthreads : 1;
+	unsigned checked = min(hc->nzones,
+		hc->reported + batch * HEAP_ZONES_PER_THREAD);
+	heap_check_wait(hc, checked);
+
+	if (checked < hc->nzones) {
+		hc->reported = checked;
+		CHECK_INFO(ppc, "heap: checked %u of %u zones",
+			checked, hc->nzones);
+		/* call the step again for the next batch */
+		loc->in_progress = true;
+		return;
+	}
+
+	unsigned broken;
+	for (broken = 0; broken < hc->nzones; ++broken) {
+		if (hc->results[broken].msg[0] != '\0')
+			break;
+	}
+
+	if (broken == hc->nzones) {
+		check_heap_fini(ppc);
+		CHECK_INFO(ppc, HEAP_OK_STR);
+		return;
+	}
+
+	hc->broken = broken;
+	CHECK_ERR(ppc, "%s", hc->results[broken].msg);
+	/* call the step again to report the other broken zones */
+	loc->in_progress = true;
+	ppc->result = CHECK_IS(ppc, REPAIR) ? CHECK_RESULT_CANNOT_REPAIR :
+		CHECK_RESULT_NOT_CONSISTENT;
+	return;
+
+err:
+	loc->in_progress = false;
+	ppc->result = CHECK_IS(ppc, REPAIR) ? CHECK_RESULT_CANNOT_REPAIR :
+		CHECK_RESULT_NOT_CONSISTENT;
+}
+
+/*
+ * check_heap_fini -- stop the heap check, which might have been interrupted
+ */
+void
+check_heap_fini(PMEMpoolcheck *ppc)
+{
+	location *loc = check_get_step_data(ppc->data);
+	if (loc->heap == NULL)
+		return;
+
+	heap_check_stop(loc->heap);
+	loc->heap = NULL;
+	loc->in_progress = false;
+}
@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2016-2023, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * check_util.h -- internal definitions check util
@@ -28,6 +28,7 @@ extern "C" {
 /* check control context */
 struct check_data;
 struct arena;
+struct heap_check;
 
 /* queue of check statuses */
 struct check_status;
@@ -92,6 +93,11 @@ typedef struct {
 	struct list *list_inval;
 	struct list *list_flog_inval;
 	struct list *list_unmap;
+
+	/* state of the heap check */
+	struct heap_check *heap;
+	/* the step has to be called again to continue the check */
+	int in_progress;
 } location;
 
 /* check steps */
@@ -100,6 +106,8 @@ void check_backup(PMEMpoolcheck *ppc);
 void check_pool_hdr(PMEMpoolcheck *ppc);
 void check_pool_hdr_uuids(PMEMpoolcheck *ppc);
 void check_sds(PMEMpoolcheck *ppc);
+void check_heap(PMEMpoolcheck *ppc);
+void check_heap_fini(PMEMpoolcheck *ppc);
 
 struct check_data *check_data_alloc(void);
 void check_data_free(struct check_data *data);
@@ -1,10 +1,11 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2024, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * libpmempool.c -- entry points for libpmempool
  */
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <errno.h>
@@ -127,11 +128,11 @@ pmempool_check_initU(struct pmempool_check_argsU *args, size_t args_size)
 		args->backup_path, args->pool_type, args->flags);
 
 	/*
-	 * Currently one size of args structure is supported. The version of the
-	 * pmempool_check_args structure can be distinguished based on provided
-	 * args_size.
+	 * The version of the pmempool_check_args structure can be distinguished
+	 * based on provided args_size. The structure without the nthreads
+	 * field is still supported.
 	 */
-	if (args_size < sizeof(struct pmempool_check_args)) {
+	if (args_size < offsetof(struct pmempool_check_args, nthreads)) {
 		ERR_WO_ERRNO("provided args_size is not supported");
 		errno = EINVAL;
 		return NULL;
@@ -179,7 +180,7 @@ pmempool_check_initU(struct pmempool_check_argsU *args, size_t args_size)
 	}
 
 	pmempool_ppc_set_default(ppc);
-	memcpy(&ppc->args, args, sizeof(ppc->args));
+	memcpy(&ppc->args, args, MIN(args_size, sizeof(ppc->args)));
 	ppc->path = strdup(args->path);
 	if (!ppc->path) {
 		ERR_W_ERRNO("strdup");
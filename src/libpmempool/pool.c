@@ -1,16 +1,20 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2024, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * pool.c -- pool processing functions
  */
 
+/* for fallocate */
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdint.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <endian.h>
+#include <inttypes.h>
 
 #include <sys/ioctl.h>
 #include <linux/fs.h>
@@ -23,6 +27,7 @@
 #include "pool.h"
 #include "lane.h"
 #include "obj.h"
+#include "heap_layout.h"
 #include "file.h"
 #include "os.h"
 #include "set.h"
@@ -489,8 +494,314 @@ pool_write(struct pool_data *pool, const void *buff, size_t nbytes,
 	return 0;
 }
 
+/* buffer entries, which are never stored in the redo logs */
+#define POOL_ULOG_BUF_ENTRY (1ULL << 63)
+
+/*
+ * pool_obj_dsc_read -- read the fields of the obj pool descriptor
+ */
+void
+pool_obj_dsc_read(const PMEMobjpool *pop, struct pool_obj_dsc *dsc)
+{
+	dsc->lanes_offset = le64toh(pop->lanes_offset);
+	dsc->nlanes = le64toh(pop->nlanes);
+	dsc->heap_offset = le64toh(pop->heap_offset);
+	dsc->heap_size = le64toh(pop->heap_size);
+}
+
+/*
+ * pool_obj_chunk_read -- read the header of the chunk of the zone
+ */
+void
+pool_obj_chunk_read(const struct zone *zone, uint32_t c,
+	struct pool_obj_chunk *chunk)
+{
+	const struct chunk_header *hdr = &zone->chunk_headers[c];
+
+	chunk->type = le16toh(hdr->type);
+	chunk->flags = le16toh(hdr->flags);
+	chunk->size_idx = le32toh(hdr->size_idx);
+}
+
+/*
+ * pool_obj_redo_pending -- (internal) check if the redo log has to be
+ *	recovered, the same way ulog_recovery_needed() does
+ */
+static int
+pool_obj_redo_pending(struct ulog *ulog, size_t capacity)
+{
+	size_t nbytes = 0;
+	capacity = MIN(capacity, le64toh(ulog->capacity));
+
+	while (nbytes + sizeof(struct ulog_entry_val) <= capacity) {
+		struct ulog_entry_base *e =
+			(struct ulog_entry_base *)(ulog->data + nbytes);
+		uint64_t offset = le64toh(e->offset);
+		if (offset == 0)
+			break;
+
+		/* do not guess the size of an unexpected entry */
+		if (offset & POOL_ULOG_BUF_ENTRY)
+			return 1;
+
+		nbytes += sizeof(struct ulog_entry_val);
+	}
+
+	if (nbytes == 0)
+		return 0;
+
+	return util_checksum(ulog, SIZEOF_ULOG(nbytes), &ulog->checksum, 0, 0);
+}
+
+/*
+ * pool_ranges_add -- (internal) append the range, merging it with the last
+ *	one if they are adjacent
+ */
+static int
+pool_ranges_add(struct pool_ranges *ranges, uint64_t off, uint64_t len)
+{
+	if (len == 0)
+		return 0;
+
+	if (VEC_SIZE(ranges) != 0) {
+		struct pool_range *last = &VEC_BACK(ranges);
+		if (last->off + last->len == off) {
+			last->len += len;
+			return 0;
+		}
+	}
+
+	struct pool_range r = {off, len};
+	return VEC_PUSH_BACK(ranges, r);
+}
+
+/*
+ * pool_obj_unused_ranges -- find the ranges of the obj pool which do not hold
+ *	any data: the chunks marked as free and the chunks of the zones which
+ *	have never been initialized
+ *
+ * The zone headers and the chunk headers are never reported. The ranges are
+ * found only if the heap looks consistent and no redo log is waiting for
+ * recovery, as the recovery could turn a free chunk into a used one.
+ * Otherwise the returned vector is empty, and the whole pool has to be copied.
+ */
+int
+pool_obj_unused_ranges(const void *addr, uint64_t size,
+	struct pool_ranges *ranges)
+{
+	LOG(3, "addr %p size %" PRIu64, addr, size);
+
+	VEC_CLEAR(ranges);
+
+	PMEMobjpool *pop = (PMEMobjpool *)addr;
+	void *dscp = (void *)((uintptr_t)pop + sizeof(struct pool_hdr));
+	if (size < sizeof(struct pool_hdr) + OBJ_DSC_P_SIZE ||
+			!util_checksum(dscp, OBJ_DSC_P_SIZE, &pop->checksum,
+			0, 0))
+		return 0;
+
+	struct pool_obj_dsc dsc;
+	pool_obj_dsc_read(pop, &dsc);
+
+	if (dsc.lanes_offset < sizeof(struct pool_hdr) + OBJ_DSC_P_SIZE ||
+			dsc.nlanes == 0 ||
+			dsc.nlanes > size / sizeof(struct lane_layout) ||
+			dsc.heap_offset < dsc.lanes_offset +
+				dsc.nlanes * sizeof(struct lane_layout) ||
+			dsc.heap_size < HEAP_MIN_SIZE ||
+			dsc.heap_offset > size ||
+			dsc.heap_size > size - dsc.heap_offset)
+		return 0;
+
+	struct lane_layout *lanes = (struct lane_layout *)
+		((uintptr_t)pop + dsc.lanes_offset);
+	for (uint64_t i = 0; i < dsc.nlanes; ++i) {
+		if (pool_obj_redo_pending((struct ulog *)&lanes[i].internal,
+				LANE_REDO_INTERNAL_SIZE) ||
+			pool_obj_redo_pending(
+				(struct ulog *)&lanes[i].external,
+				LANE_REDO_EXTERNAL_SIZE))
+			return 0;
+	}
+
+	struct heap_layout *layout = (struct heap_layout *)
+		((uintptr_t)pop + dsc.heap_offset);
+	struct heap_header *hdr = &layout->header;
+	if (memcmp(hdr->signature, HEAP_SIGNATURE, HEAP_SIGNATURE_LEN) != 0 ||
+			!util_checksum(hdr, sizeof(*hdr), &hdr->checksum,
+			0, 0) ||
+			le64toh(hdr->major) != HEAP_MAJOR ||
+			le64toh(hdr->chunksize) != CHUNKSIZE ||
+			le64toh(hdr->chunks_per_zone) != MAX_CHUNK)
+		return 0;
+
+	uint64_t heap_end = dsc.heap_offset + dsc.heap_size;
+	for (size_t zid = 0; ; ++zid) {
+		struct zone *zone = ZID_TO_ZONE(layout, zid);
+		uint64_t zone_off = (uintptr_t)zone - (uintptr_t)pop;
+		if (zone_off >= heap_end || heap_end - zone_off < ZONE_MIN_SIZE)
+			break;
+
+		uint64_t zone_end = MIN(heap_end, zone_off + ZONE_MAX_SIZE);
+		uint64_t chunks_off = (uintptr_t)zone->chunks - (uintptr_t)pop;
+		uint32_t max_size_idx =
+			(uint32_t)((zone_end - chunks_off) / CHUNKSIZE);
+
+		uint32_t magic = le32toh(zone->header.magic);
+		if (magic == 0) {
+			if (pool_ranges_add(ranges, chunks_off,
+					(uint64_t)max_size_idx * CHUNKSIZE))
+				goto err;
+			continue;
+		}
+
+		uint32_t size_idx = le32toh(zone->header.size_idx);
+		if (magic != ZONE_HEADER_MAGIC ||
+				size_idx == 0 || size_idx > max_size_idx)
+			goto inconsistent;
+
+		for (uint32_t c = 0; c < size_idx; ) {
+			struct pool_obj_chunk chdr;
+			pool_obj_chunk_read(zone, c, &chdr);
+			if (chdr.size_idx == 0 ||
+					chdr.size_idx > size_idx - c)
+				goto inconsistent;
+
+			switch (chdr.type) {
+			case CHUNK_TYPE_FREE:
+				if (pool_ranges_add(ranges,
+						chunks_off +
+						(uint64_t)c * CHUNKSIZE,
+						(uint64_t)chdr.size_idx *
+						CHUNKSIZE))
+					goto err;
+				break;
+			case CHUNK_TYPE_USED:
+			case CHUNK_TYPE_RUN:
+				break;
+			default:
+				goto inconsistent;
+			}
+
+			c += chdr.size_idx;
+		}
+	}
+
+	return 0;
+
+inconsistent:
+	VEC_CLEAR(ranges);
+	return 0;
+
+err:
+	ERR_W_ERRNO("cannot allocate the unused ranges");
+	VEC_CLEAR(ranges);
+	return -1;
+}
+
+/*
+ * pool_ranges_contain -- check if the range is within one of the ranges
+ */
+int
+pool_ranges_contain(const struct pool_ranges *ranges, uint64_t off,
+	uint64_t len)
+{
+	size_t lo = 0;
+	size_t hi = VEC_SIZE(ranges);
+
+	/* find the last range which starts at or before the offset */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (VEC_GET(ranges, mid)->off <= off)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == 0)
+		return 0;
+
+	const struct pool_range *r = VEC_GET(ranges, lo - 1);
+	return off + len <= r->off + r->len;
+}
+
+/*
+ * pool_punch_hole -- (internal) deallocate the pages within the range of
+ *	the file, the range reads as zeros afterwards
+ *
+ * It is only an optimization, so the errors are ignored.
+ */
+static void
+pool_punch_hole(int fd, uint64_t off, uint64_t len)
+{
+	uint64_t start = ALIGN_UP(off, Pagesize);
+	uint64_t end = ALIGN_DOWN(off + len, Pagesize);
+	if (start >= end)
+		return;
+
+	if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+			(os_off_t)start, (os_off_t)(end - start)))
+		LOG(4, "cannot punch a hole in the file: %s", strerror(errno));
+}
+
+/*
+ * pool_memcpy -- (internal) copy the data, persisting it if it is pmem
+ */
+static void
+pool_memcpy(int is_pmem, void *dst, const void *src, size_t len)
+{
+	if (is_pmem)
+		pmem_memcpy_persist(dst, src, len);
+	else
+		memcpy(dst, src, len);
+}
+
+/*
+ * pool_copy_data -- (internal) copy the data of the pool skipping the unused
+ *	ranges
+ *
+ * The source and the destination start at the 'off' offset of the pool.
+ * If 'dfd' is a valid descriptor, the holes are punched in the unused ranges
+ * of the destination file, starting at its 'doff' offset.
+ */
+static void
+pool_copy_data(void *daddr, const void *saddr, size_t len, uint64_t off,
+	const struct pool_ranges *unused, int is_pmem, int dfd, uint64_t doff)
+{
+	uint64_t end = off + len;
+	uint64_t pos = off;
+
+	const struct pool_range *r;
+	VEC_FOREACH_BY_PTR(r, unused) {
+		uint64_t rstart = MAX(r->off, off);
+		uint64_t rend = MIN(r->off + r->len, end);
+		if (rstart >= rend)
+			continue;
+
+		if (rstart > pos) {
+			pool_memcpy(is_pmem,
+				ADDR_SUM(daddr, pos - off),
+				ADDR_SUM(saddr, pos - off), rstart - pos);
+		}
+
+		if (dfd >= 0)
+			pool_punch_hole(dfd, doff + rstart - off,
+				rend - rstart);
+
+		pos = rend;
+	}
+
+	if (end > pos) {
+		pool_memcpy(is_pmem, ADDR_SUM(daddr, pos - off),
+			ADDR_SUM(saddr, pos - off), end - pos);
+	}
+}
+
 /*
  * pool_copy -- make a copy of the pool
+ *
+ * The unused ranges of an obj pool are not copied and the holes are punched
+ * in the destination file instead.
  */
 int
 pool_copy(struct pool_data *pool, const char *dst_path, int overwrite)
@@ -534,7 +845,13 @@ pool_copy(struct pool_data *pool, const char *dst_path, int overwrite)
 	}
 
 	void *saddr = pool_set_file_map(file, 0);
-	memcpy(daddr, saddr, file->size);
+
+	struct pool_ranges unused = VEC_INITIALIZER;
+	if (pool->params.type == POOL_TYPE_OBJ)
+		(void) pool_obj_unused_ranges(saddr, file->size, &unused);
+
+	pool_copy_data(daddr, saddr, file->size, 0, &unused, 0, dfd, 0);
+	VEC_DELETE(&unused);
 	munmap(daddr, file->size);
 
 out_close:
@@ -544,12 +861,19 @@ out_close:
 
 /*
  * pool_set_part_copy -- make a copy of the poolset part
+ *
+ * The data of the part starts at its 'data_off' offset and it holds the pool
+ * from its 'pool_off' offset. The unused ranges of the pool, if any, are not
+ * copied.
  */
 int
 pool_set_part_copy(struct pool_set_part *dpart, struct pool_set_part *spart,
-	int overwrite)
+	int overwrite, const struct pool_ranges *unused, uint64_t data_off,
+	uint64_t pool_off)
 {
-	LOG(3, "dpart %p spart %p", dpart, spart);
+	LOG(3, "dpart %p spart %p unused %p data_off %" PRIu64
+		" pool_off %" PRIu64, dpart, spart, unused, data_off,
+		pool_off);
 
 	int result = 0;
 
@@ -604,13 +928,23 @@ pool_set_part_copy(struct pool_set_part *dpart, struct pool_set_part *spart,
 	}
 #endif
 
-	if (is_pmem) {
-		pmem_memcpy_persist(daddr, saddr, smapped);
+	if (unused == NULL || VEC_SIZE(unused) == 0 || data_off > smapped) {
+		pool_memcpy(is_pmem, daddr, saddr, smapped);
 	} else {
-		memcpy(daddr, saddr, smapped);
-		pmem_msync(daddr, smapped);
+		int dfd = is_pmem ? -1 : os_open(dpart->path, O_RDWR);
+
+		pool_memcpy(is_pmem, daddr, saddr, data_off);
+		pool_copy_data(ADDR_SUM(daddr, data_off),
+			ADDR_SUM(saddr, data_off), smapped - data_off,
+			pool_off, unused, is_pmem, dfd, data_off);
+
+		if (dfd >= 0)
+			(void) os_close(dfd);
 	}
 
+	if (!is_pmem)
+		pmem_msync(daddr, smapped);
+
 	pmem_unmap(daddr, dmapped);
 out_sunmap:
 	pmem_unmap(saddr, smapped);
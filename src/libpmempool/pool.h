@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2016-2023, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * pool.h -- internal definitions for pool processing functions
@@ -15,6 +15,7 @@
 
 #include "queue.h"
 #include "set.h"
+#include "vec.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -73,6 +74,32 @@ struct pool_data {
 	struct pool_hdr hdr_pool;
 };
 
+/* range of the pool, in bytes from the beginning of the pool */
+struct pool_range {
+	uint64_t off;
+	uint64_t len;
+};
+
+/* sorted, non-overlapping ranges of the pool */
+VEC(pool_ranges, struct pool_range);
+
+struct zone;
+
+/* fields of the obj pool descriptor, in the host byte order */
+struct pool_obj_dsc {
+	uint64_t lanes_offset;
+	uint64_t nlanes;
+	uint64_t heap_offset;
+	uint64_t heap_size;
+};
+
+/* chunk header of the obj pool heap, in the host byte order */
+struct pool_obj_chunk {
+	uint16_t type;
+	uint16_t flags;
+	uint32_t size_idx;
+};
+
 struct pool_data *pool_data_alloc(PMEMpoolcheck *ppc);
 void pool_data_free(struct pool_data *pool);
 void pool_params_from_header(struct pool_params *params,
@@ -86,7 +113,16 @@ int pool_write(struct pool_data *pool, const void *buff, size_t nbytes,
 	uint64_t off);
 int pool_copy(struct pool_data *pool, const char *dst_path, int overwrite);
 int pool_set_part_copy(struct pool_set_part *dpart,
-	struct pool_set_part *spart, int overwrite);
+	struct pool_set_part *spart, int overwrite,
+	const struct pool_ranges *unused, uint64_t data_off, uint64_t pool_off);
+
+void pool_obj_dsc_read(const PMEMobjpool *pop, struct pool_obj_dsc *dsc);
+void pool_obj_chunk_read(const struct zone *zone, uint32_t c,
+	struct pool_obj_chunk *chunk);
+int pool_obj_unused_ranges(const void *addr, uint64_t size,
+	struct pool_ranges *ranges);
+int pool_ranges_contain(const struct pool_ranges *ranges, uint64_t off,
+	uint64_t len);
 
 unsigned pool_set_files_count(struct pool_set_file *file);
 int pool_set_file_map_headers(struct pool_set_file *file, int rdonly, int prv);
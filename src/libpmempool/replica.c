@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2024, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * replica.c -- groups all commands for replica manipulation
@@ -13,6 +13,7 @@
 #include <fcntl.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <string.h>
 #include <unistd.h>
 #include <libgen.h>
@@ -36,7 +37,8 @@
 static int
 check_flags_sync(unsigned flags)
 {
-	flags &= ~(PMEMPOOL_SYNC_DRY_RUN | PMEMPOOL_SYNC_FIX_BAD_BLOCKS);
+	flags &= ~(PMEMPOOL_SYNC_DRY_RUN | PMEMPOOL_SYNC_FIX_BAD_BLOCKS |
+		PMEMPOOL_SYNC_DIFFERENTIAL | PMEMPOOL_SYNC_ONLINE_REBUILD);
 	return flags > 0;
 }
 
@@ -1888,6 +1890,32 @@ replica_read_features(struct pool_set *set,
 	return -1;
 }
 
+/*
+ * check_rebuild_markers -- (internal) mark replicas which are still being
+ *                          rebuilt online as inconsistent
+ */
+static int
+check_rebuild_markers(struct pool_set *set,
+		struct poolset_health_status *set_hs)
+{
+	LOG(3, "set %p, set_hs %p", set, set_hs);
+
+	for (unsigned r = 0; r < set->nreplicas; ++r) {
+		uint64_t offset;
+		int ret = util_rebuild_get(set, r, &offset);
+		if (ret < 0)
+			return -1;
+
+		if (ret == 1) {
+			LOG(2, "replica %u is being rebuilt, offset %" PRIu64,
+				r, offset);
+			REP_HEALTH(set_hs, r)->flags |= IS_INCONSISTENT;
+		}
+	}
+
+	return 0;
+}
+
 /*
  * replica_check_poolset_health -- check if a given poolset can be considered as
  *                         healthy, and store the status in a helping structure
@@ -2008,6 +2036,12 @@ replica_check_poolset_health(struct pool_set *set,
 		goto err;
 	}
 
+	/* check if any replica has not been fully rebuilt yet */
+	if (check_rebuild_markers(set, set_hs)) {
+		CORE_LOG_ERROR("replica rebuild markers check failed");
+		goto err;
+	}
+
 	unmap_all_headers(set);
 	util_poolset_fdclose_always(set);
 	return 0;
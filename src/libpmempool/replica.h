@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2016-2024, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * replica.h -- module for synchronizing and transforming poolset
@@ -154,6 +154,26 @@ fix_bad_blocks(unsigned flags)
 	return flags & PMEMPOOL_SYNC_FIX_BAD_BLOCKS;
 }
 
+/*
+ * is_differential -- (internal) check whether only the divergent data
+ *                    should be copied
+ */
+static inline bool
+is_differential(unsigned flags)
+{
+	return flags & PMEMPOOL_SYNC_DIFFERENTIAL;
+}
+
+/*
+ * is_online_rebuild -- (internal) check whether the data should be copied
+ *                      by libpmemobj after the pool is opened
+ */
+static inline bool
+is_online_rebuild(unsigned flags)
+{
+	return flags & PMEMPOOL_SYNC_ONLINE_REBUILD;
+}
+
 int replica_remove_all_recovery_files(struct poolset_health_status *set_hs);
 int replica_remove_part(struct pool_set *set, unsigned repn, unsigned partn,
 		int fix_bad_blocks);
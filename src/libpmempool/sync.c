@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2024, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * sync.c -- a module for poolset synchronizing
@@ -12,13 +12,17 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <inttypes.h>
+#include <stdlib.h>
 
 #include "libpmem.h"
 #include "replica.h"
 #include "out.h"
 #include "os.h"
+#include "os_thread.h"
 #include "util_pmem.h"
 #include "util.h"
+#include "ravl_interval.h"
 
 #define BB_DATA_STR "offset 0x%zx, length 0x%zx, nhealthy %i"
 
@@ -61,26 +65,190 @@ err:
 	return -1;
 }
 
+/* size of a range copied by a thread at a time */
+#define SYNC_CHUNK_SIZE ((size_t)16 << 20)
+
+/* granularity of the comparison in the differential mode */
+#define SYNC_EXTENT_SIZE ((size_t)64 << 10)
+
+/* maximum number of threads used to copy the data */
+#define SYNC_MAX_THREADS 64
+
+/* default number of threads used to copy the data */
+#define SYNC_DEFAULT_THREADS 8
+
+/*
+ * sync_copy_ctx -- a range copied by many threads
+ */
+struct sync_copy_ctx {
+	char *src;
+	char *dst;
+	size_t len;
+	int is_pmem;
+	int differential;
+
+	uint64_t next;		/* offset of the next chunk to copy */
+	uint64_t copied;	/* number of bytes actually written */
+};
+
+/*
+ * sync_nthreads -- (internal) number of threads used to copy the data
+ */
+static unsigned
+sync_nthreads(void)
+{
+	long nthreads = SYNC_DEFAULT_THREADS;
+
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (ncpus > 0 && ncpus < nthreads)
+		nthreads = ncpus;
+
+	/*
+	 * For testing and platform tuning the number of threads can be
+	 * overridden using PMEMPOOL_SYNC_THREADS env variable.
+	 */
+	const char *ptr = os_getenv("PMEMPOOL_SYNC_THREADS");
+	if (ptr) {
+		long val = atol(ptr);
+
+		if (val < 1 || val > SYNC_MAX_THREADS) {
+			LOG(3, "Invalid PMEMPOOL_SYNC_THREADS");
+		} else {
+			LOG(3, "PMEMPOOL_SYNC_THREADS set to %ld", val);
+			nthreads = val;
+		}
+	}
+
+	return (unsigned)nthreads;
+}
+
+/*
+ * sync_copy_extent -- (internal) copy an extent and flush it to persistence
+ */
+static void
+sync_copy_extent(struct sync_copy_ctx *ctx, size_t off, size_t len)
+{
+	char *src = ctx->src + off;
+	char *dst = ctx->dst + off;
+
+	if (ctx->is_pmem) {
+		/* the data is not read back, do not pollute the caches */
+		pmem_memcpy(dst, src, len,
+			PMEM_F_MEM_NONTEMPORAL | PMEM_F_MEM_NODRAIN);
+	} else {
+		memcpy(dst, src, len);
+		util_persist(0, dst, len);
+	}
+
+	util_fetch_and_add64(&ctx->copied, len);
+}
+
+/*
+ * sync_copy_chunk -- (internal) copy a chunk of the range, in the
+ *                    differential mode only the divergent extents are copied
+ */
+static void
+sync_copy_chunk(struct sync_copy_ctx *ctx, size_t off, size_t len)
+{
+	if (!ctx->differential) {
+		sync_copy_extent(ctx, off, len);
+		return;
+	}
+
+	size_t end = off + len;
+	while (off < end) {
+		size_t n = end - off < SYNC_EXTENT_SIZE ?
+			end - off : SYNC_EXTENT_SIZE;
+
+		if (memcmp(ctx->dst + off, ctx->src + off, n) != 0)
+			sync_copy_extent(ctx, off, n);
+
+		off += n;
+	}
+}
+
+/*
+ * sync_copy_worker -- (internal) copy chunks of the range until
+ *                     there is nothing left
+ */
+static void *
+sync_copy_worker(void *arg)
+{
+	struct sync_copy_ctx *ctx = arg;
+
+	for (;;) {
+		size_t off = util_fetch_and_add64(&ctx->next, SYNC_CHUNK_SIZE);
+		if (off >= ctx->len)
+			break;
+
+		size_t len = ctx->len - off < SYNC_CHUNK_SIZE ?
+			ctx->len - off : SYNC_CHUNK_SIZE;
+
+		sync_copy_chunk(ctx, off, len);
+	}
+
+	if (ctx->is_pmem)
+		pmem_drain();
+
+	return NULL;
+}
+
 /*
  * sync_copy_data -- (internal) copy data from the healthy replica
  *                   to the broken one
+ *
+ * Large ranges are divided into chunks copied concurrently by several
+ * threads. In the differential mode extents of the broken replica which
+ * already contain the right data are not written.
  */
 static int
 sync_copy_data(void *src_addr, void *dst_addr, size_t off, size_t len,
 		struct pool_replica *rep_h,
-		struct pool_replica *rep, const struct pool_set_part *part)
+		struct pool_replica *rep, const struct pool_set_part *part,
+		unsigned flags)
 {
 	LOG(3, "src_addr %p dst_addr %p off %zu len %zu "
-		"rep_h %p rep %p part %p",
-		src_addr, dst_addr, off, len, rep_h, rep, part);
+		"rep_h %p rep %p part %p flags %u",
+		src_addr, dst_addr, off, len, rep_h, rep, part, flags);
 
 	LOG(10,
 		"copying data (offset 0x%zx length 0x%zx) from local replica -- '%s'",
 		off, len, rep_h->part[0].path);
 
-	/* copy all data */
-	memcpy(dst_addr, src_addr, len);
-	util_persist(part->is_dev_dax, dst_addr, len);
+	struct sync_copy_ctx ctx = {
+		.src = src_addr,
+		.dst = dst_addr,
+		.len = len,
+		.is_pmem = rep->is_pmem || part->is_dev_dax,
+		.differential = is_differential(flags),
+		.next = 0,
+		.copied = 0,
+	};
+
+	unsigned nthreads = sync_nthreads();
+	size_t nchunks = (len + SYNC_CHUNK_SIZE - 1) / SYNC_CHUNK_SIZE;
+	if (nthreads > nchunks)
+		nthreads = (unsigned)nchunks;
+
+	/* the calling thread is one of the workers */
+	os_thread_t threads[SYNC_MAX_THREADS];
+	unsigned started = 0;
+	while (started + 1 < nthreads) {
+		if (os_thread_create(&threads[started], NULL,
+				sync_copy_worker, &ctx)) {
+			LOG(2, "cannot create a copying thread");
+			break;
+		}
+		started++;
+	}
+
+	sync_copy_worker(&ctx);
+
+	for (unsigned i = 0; i < started; ++i)
+		os_thread_join(&threads[i], NULL);
+
+	LOG(10, "copied 0x%" PRIx64 " of 0x%zx bytes using %u threads",
+		ctx.copied, len, started + 1);
 
 	return 0;
 }
@@ -232,360 +400,212 @@ sync_recalc_badblocks(struct pool_set *set,
 }
 
 /*
- * sync_badblocks_find_healthy_replica -- (internal) look for a healthy replica
- *                                                   for each bad block
- *
- * This function looks for a healthy replica for each bad block. Bad blocks
- * can overlap across replicas, so each bad block may have to be divided
- * into smaller parts which can be fixed using different healthy replica.
- *
- * Key variables:
- * - bbv_all[] - array containing all (possibly divided) bad blocks
- *               from all previous replicas.
- * - bbv_aux[] - array containing all (possibly divided) bad blocks
- *               from all previous parts of the current replica merged with
- *               these bad blocks from bbv_all[] that have offsets less or equal
- *               the greatest bad block's offset in the previous part.
- *
- * This function merges bad blocks from bbv_all[] with bad blocks
- * from the current part and writes the outcome bad blocks to bbv_aux[].
- * Only bad blocks with offsets less or equal the greatest bad block's offset
- * in the current part will be moved from bbv_all[] to bbv_aux[].
- * The rest of them has to be moved at the end by sync_badblocks_move_vec().
- *
- * bbv_aux[] becomes new bbv_all[] and bbv_aux[] is zeroed
- * before checking the next replica (bbv_all = bbv_aux; bbv_aux = 0).
+ * sync_bb_index -- interval index of all bad blocks of a replica,
+ *                  keyed by the pool offset
  *
- * For example (all replicas have only one part):
- * - bbv_all with rep#0: |__----___________----__|
- * - merged with  rep#1: |____----_______----____|
- * - gives such bbv_aux: |__11--00_______00--11__|
- * - merged with  rep#2: |__________---__________|
- * - gives such bbv_aux: |__112200__000__002211__| (all bad blocks can be fixed)
- *
- * where:
- *   '_' stands for a healthy block (no bad block)
- *   '-' stands for a bad block with nhealthy == NO_HEALTHY_REPLICA
- *   'N' stands for a bad block with nhealthy == N (can be fixed using rep#N)
+ * The tree points to the copies of the bad blocks in the vector, so that
+ * the bad blocks of the parts can be replaced while the index is in use.
  */
-static int
-sync_badblocks_find_healthy_replica(struct part_health_status *phs,
-					int rep,
-					struct bb_vec *pbbv_all,
-					struct bb_vec *pbbv_aux,
-					unsigned *i_all)
+struct sync_bb_index {
+	struct bb_vec bbv;
+	struct ravl_interval *tree;
+};
+
+/*
+ * sync_bb_min -- (internal) return the beginning of the bad block
+ */
+static size_t
+sync_bb_min(void *addr)
 {
-	LOG(3, "phs %p rep %i pbbv_all %p pbbv_aux %p i_all %i",
-		phs, rep, pbbv_all, pbbv_aux, *i_all);
+	struct bad_block *bb = (struct bad_block *)addr;
+	return bb->offset;
+}
 
-	struct bad_block bb_add;	/* the element which is being added  */
-	struct bad_block bb_new;	/* a new element */
-	struct bad_block *pbb_all;	/* current element of bbv_all[] */
+/*
+ * sync_bb_max -- (internal) return the end of the bad block
+ */
+static size_t
+sync_bb_max(void *addr)
+{
+	struct bad_block *bb = (struct bad_block *)addr;
+	return bb->offset + bb->length;
+}
 
-	unsigned long long beg_prev;
-	unsigned long long end_prev;
-	unsigned long long beg_new;
-	unsigned long long end_new;
-	size_t len_prev;
-	size_t len_new;
+/*
+ * sync_badblocks_index_delete -- (internal) free the bad block index
+ */
+static void
+sync_badblocks_index_delete(struct pool_set *set, struct sync_bb_index *index)
+{
+	for (unsigned r = 0; r < set->nreplicas; ++r) {
+		if (index[r].tree)
+			ravl_interval_delete(index[r].tree);
+		VEC_DELETE(&index[r].bbv);
+	}
 
-	size_t size_all = VEC_SIZE(pbbv_all);
+	Free(index);
+}
 
-	if (size_all == 0) {
-		/* there were no bad blocks so far, so fill up bbv_aux[] */
-		for (unsigned i = 0; i < phs->bbs.bb_cnt; i++) {
-			bb_add = phs->bbs.bbv[i];
+/*
+ * sync_badblocks_index_new -- (internal) build the interval index of bad blocks
+ *                             for each replica
+ */
+static struct sync_bb_index *
+sync_badblocks_index_new(struct pool_set *set,
+			struct poolset_health_status *set_hs)
+{
+	LOG(3, "set %p set_hs %p", set, set_hs);
 
-			if (rep > 0)
-				/* bad block can be fixed with replica #0 */
-				bb_add.nhealthy = 0;
+	struct sync_bb_index *index = Zalloc(set->nreplicas * sizeof(*index));
+	if (index == NULL) {
+		ERR_W_ERRNO("Zalloc");
+		return NULL;
+	}
 
-			if (VEC_PUSH_BACK(pbbv_aux, bb_add))
-				return -1;
+	for (unsigned r = 0; r < set->nreplicas; ++r) {
+		struct pool_replica *rep = REP(set, r);
+		struct replica_health_status *rep_hs = set_hs->replica[r];
 
-			LOG(10,
-				"added bad block (prev-empty): " BB_DATA_STR,
-				bb_add.offset, bb_add.length, bb_add.nhealthy);
-		}
-	} else {
-		if (*i_all < size_all) {
-			pbb_all = VEC_GET(pbbv_all, (*i_all)++);
-		} else {
-			pbb_all = NULL;
+		index[r].tree = ravl_interval_new(sync_bb_min, sync_bb_max);
+		if (index[r].tree == NULL) {
+			ERR_W_ERRNO("ravl_interval_new");
+			goto err;
 		}
 
-		for (unsigned i = 0; i < phs->bbs.bb_cnt; i++) {
-			bb_new = phs->bbs.bbv[i];
+		if (!replica_has_bad_blocks(r, set_hs)) {
+			/* skip replicas with no bad blocks */
+			continue;
+		}
 
-			LOG(10,
-				" * (%u) inserting new bad block: " BB_DATA_STR,
-				i + 1,
-				bb_new.offset, bb_new.length, bb_new.nhealthy);
+		for (unsigned p = 0; p < rep->nparts; ++p) {
+			struct part_health_status *phs = &rep_hs->part[p];
 
-			if (pbb_all == NULL || pbb_all->length == 0) {
-				if (*i_all < size_all)
-					pbb_all = VEC_GET(pbbv_all, (*i_all)++);
-				else
-					pbb_all = NULL;
+			if (!replica_part_has_bad_blocks(phs)) {
+				/* skip parts with no bad blocks */
+				continue;
 			}
 
-			/* all from bbv_all before the bb_new */
-			while (pbb_all != NULL && pbb_all->offset
-							+ pbb_all->length - 1
-							< bb_new.offset) {
-				if (pbb_all->nhealthy == NO_HEALTHY_REPLICA)
-					/* can be fixed with this replica */
-					pbb_all->nhealthy = rep;
+			LOG(10, "Replica %u part %u HAS %u bad blocks",
+				r, p, phs->bbs.bb_cnt);
 
-				if (VEC_PUSH_BACK(pbbv_aux, *pbb_all))
-					return -1;
+			for (unsigned i = 0; i < phs->bbs.bb_cnt; i++) {
+				if (phs->bbs.bbv[i].length == 0)
+					continue;
 
-				LOG(10,
-					"added bad block (prev-before): "
-					BB_DATA_STR,
-					pbb_all->offset, pbb_all->length,
-					pbb_all->nhealthy);
-
-				if (*i_all < size_all) {
-					pbb_all = VEC_GET(pbbv_all, (*i_all)++);
-				} else {
-					pbb_all = NULL;
-					break;
-				}
+				if (VEC_PUSH_BACK(&index[r].bbv,
+						phs->bbs.bbv[i]))
+					goto err;
 			}
+		}
 
-			beg_new = bb_new.offset;
-			len_new = bb_new.length;
-			end_new = beg_new + len_new - 1;
-
-			/* all pbb_all overlapping with the bb_new */
-			while (len_new > 0 && pbb_all != NULL) {
-
-				beg_prev = pbb_all->offset;
-				len_prev = pbb_all->length;
-				end_prev = beg_prev + len_prev - 1;
-
-				/* check if new overlaps with prev */
-				if (end_prev < beg_new || end_new < beg_prev)
-					break;
-
-				/*
-				 * 1st part: non-overlapping part
-				 * of pbb_all or bb_new
-				 */
-				if (beg_prev < beg_new) {
-					/* non-overlapping part of pbb_all */
-					bb_add.offset = beg_prev;
-					bb_add.length = (unsigned)
-							(beg_new - beg_prev);
-
-					if (pbb_all->nhealthy !=
-							NO_HEALTHY_REPLICA) {
-						bb_add.nhealthy =
-							pbb_all->nhealthy;
-					} else {
-						/*
-						 * It can be fixed with
-						 * this replica.
-						 */
-						bb_add.nhealthy = rep;
-					}
-
-					if (VEC_PUSH_BACK(pbbv_aux, bb_add))
-						return -1;
-
-					LOG(10,
-						"added bad block (prev-only): "
-						BB_DATA_STR,
-						bb_add.offset, bb_add.length,
-						bb_add.nhealthy);
-
-					beg_prev += bb_add.length;
-					len_prev -= bb_add.length;
-
-				} else if (beg_new < beg_prev) {
-					/* non-overlapping part of bb_new */
-					bb_add.offset = beg_new;
-					bb_add.length = (unsigned)
-							(beg_prev - beg_new);
-
-					if (rep == 0) {
-						bb_add.nhealthy =
-							NO_HEALTHY_REPLICA;
-					} else {
-						/*
-						 * It can be fixed with any
-						 * previous replica, so let's
-						 * choose replia #0.
-						 */
-						bb_add.nhealthy = 0;
-					}
-
-					if (VEC_PUSH_BACK(pbbv_aux, bb_add))
-						return -1;
-
-					LOG(10,
-						"added bad block (new-only): "
-						BB_DATA_STR,
-						bb_add.offset, bb_add.length,
-						bb_add.nhealthy);
-
-					beg_new += bb_add.length;
-					len_new -= bb_add.length;
-				}
-
-				/*
-				 * 2nd part: overlapping part
-				 * of pbb_all and bb_new
-				 */
-				if (len_prev <= len_new) {
-					bb_add.offset = beg_prev;
-					bb_add.length = len_prev;
-
-					beg_new += len_prev;
-					len_new -= len_prev;
-
-					/* whole pbb_all was added */
-					len_prev = 0;
-				} else {
-					bb_add.offset = beg_new;
-					bb_add.length = len_new;
-
-					beg_prev += len_new;
-					len_prev -= len_new;
-
-					/* whole bb_new was added */
-					len_new = 0;
-				}
-
-				bb_add.nhealthy = pbb_all->nhealthy;
-
-				if (VEC_PUSH_BACK(pbbv_aux, bb_add))
-					return -1;
-
-				LOG(10,
-					"added bad block (common): "
-					BB_DATA_STR,
-					bb_add.offset, bb_add.length,
-					bb_add.nhealthy);
-
-				/* update pbb_all */
-				pbb_all->offset = beg_prev;
-				pbb_all->length = len_prev;
-
-				if (len_prev == 0) {
-					if (*i_all < size_all)
-						pbb_all = VEC_GET(pbbv_all,
-								(*i_all)++);
-					else
-						pbb_all = NULL;
-				}
+		/* the vector does not grow anymore */
+		struct bad_block *bb;
+		VEC_FOREACH_BY_PTR(bb, &index[r].bbv) {
+			int ret = ravl_interval_insert(index[r].tree, bb);
+			if (ret == -EEXIST) {
+				ERR_WO_ERRNO(
+					"overlapping bad blocks in replica %u: offset 0x%zx, length 0x%zx",
+					r, bb->offset, bb->length);
+				errno = EINVAL;
+				goto err;
 			}
+			if (ret) {
+				ERR_W_ERRNO("ravl_interval_insert");
+				goto err;
+			}
+		}
+	}
 
-			/* the rest of the bb_new */
-			if (len_new > 0) {
-				bb_add.offset = beg_new;
-				bb_add.length = len_new;
-
-				if (rep > 0)
-					/* it can be fixed with replica #0 */
-					bb_add.nhealthy = 0;
-				else
-					bb_add.nhealthy = NO_HEALTHY_REPLICA;
+	return index;
 
-				if (VEC_PUSH_BACK(pbbv_aux, bb_add))
-					return -1;
+err:
+	sync_badblocks_index_delete(set, index);
+	return NULL;
+}
 
-				LOG(10,
-					"added bad block (new-rest): "
-					BB_DATA_STR,
-					bb_add.offset, bb_add.length,
-					bb_add.nhealthy);
-			}
-		}
+/*
+ * sync_badblocks_healthy_end -- (internal) return the end of the healthy range
+ *                               of the replica starting at the given offset,
+ *                               not greater than 'end'
+ */
+static size_t
+sync_badblocks_healthy_end(struct sync_bb_index *index, size_t off, size_t end)
+{
+	struct bad_block range = {off, end - off, NO_HEALTHY_REPLICA};
 
-		if (pbb_all != NULL && pbb_all->length > 0 && *i_all > 0)
-			/* this pbb_all will be used again in the next part */
-			(*i_all)--;
-	}
+	/* the first bad block overlapping the range */
+	struct ravl_interval_node *node =
+		ravl_interval_find(index->tree, &range);
+	if (node == NULL)
+		return end;
 
-	return 0;
+	struct bad_block *bb = ravl_interval_data(node);
+	return bb->offset > off ? bb->offset : off;
 }
 
 /*
  * sync_badblocks_assign_healthy_replica -- (internal) assign healthy replica
- *                                                   for each bad block
+ *                                          for each bad block of the part
+ *
+ * Bad blocks can overlap across replicas, so each bad block may have to be
+ * divided into smaller parts which can be fixed using different healthy
+ * replicas. At each offset the replica which stays healthy for the longest
+ * range is chosen, so a bad block is divided only where it has to be.
+ *
+ * Returns 1 if a part of the bad block is bad in all replicas.
  */
 static int
-sync_badblocks_assign_healthy_replica(struct part_health_status *phs,
-					int rep,
-					struct bb_vec *pbbv_all,
-					unsigned *i_all)
+sync_badblocks_assign_healthy_replica(struct pool_set *set,
+					struct sync_bb_index *index,
+					unsigned r,
+					struct part_health_status *phs)
 {
-	LOG(3, "phs %p rep %i pbbv_all %p i_all %i",
-		phs, rep, pbbv_all, *i_all);
-
-	struct bad_block bb_new;	/* a new element */
-	struct bad_block bb_old;	/* an old element */
-	struct bad_block *pbb_all;	/* current element of bbv_all[] */
-
-	size_t length_left;
+	LOG(3, "set %p index %p r %u phs %p", set, index, r, phs);
 
 	struct bb_vec bbv_new = VEC_INITIALIZER;
 
-#ifdef DEBUG /* variables required for ASSERTs below */
-	size_t size_all = VEC_SIZE(pbbv_all);
-#endif
-	pbb_all = VEC_GET(pbbv_all, *i_all);
-
 	for (unsigned i = 0; i < phs->bbs.bb_cnt; i++) {
-		bb_old = phs->bbs.bbv[i];
-
-		LOG(10,
-			"assigning old bad block: " BB_DATA_STR,
-			bb_old.offset, bb_old.length, bb_old.nhealthy);
-
-		/*
-		 * Skip all bad blocks from bbv_all with offsets
-		 * less than the offset of the current bb_old.
-		 */
-		while (pbb_all->offset < bb_old.offset) {
-			/* (*i_all) has to be less than (size_all - 1) */
-			ASSERT(*i_all < size_all - 1);
-			pbb_all = VEC_GET(pbbv_all, ++(*i_all));
-		}
+		size_t off = phs->bbs.bbv[i].offset;
+		size_t end = off + phs->bbs.bbv[i].length;
 
-		bb_new.offset = bb_old.offset;
-		length_left = bb_old.length;
+		while (off < end) {
+			struct bad_block bb_new = {off, 0, NO_HEALTHY_REPLICA};
+			size_t healthy_end = off;
 
-		while (length_left > 0) {
-			LOG(10,
-				"checking saved bad block: " BB_DATA_STR,
-				pbb_all->offset, pbb_all->length,
-				pbb_all->nhealthy);
+			for (unsigned h = 0; h < set->nreplicas; ++h) {
+				if (h == r)
+					continue;
 
-			ASSERTeq(pbb_all->offset, bb_new.offset);
-			ASSERT(pbb_all->length <= length_left);
+				size_t e = sync_badblocks_healthy_end(
+						&index[h], off, end);
+				if (e > healthy_end) {
+					healthy_end = e;
+					bb_new.nhealthy = (int)h;
+					if (e == end)
+						break;
+				}
+			}
 
-			bb_new.length = pbb_all->length;
-			bb_new.nhealthy = pbb_all->nhealthy;
+			if (bb_new.nhealthy == NO_HEALTHY_REPLICA) {
+				CORE_LOG_ERROR(
+					"uncorrectable bad block found: offset 0x%zx, length 0x%zx",
+					off, end - off);
+				VEC_DELETE(&bbv_new);
+				return 1;
+			}
+
+			bb_new.length = healthy_end - off;
 
-			if (VEC_PUSH_BACK(&bbv_new, bb_new))
-				goto error_exit;
+			if (VEC_PUSH_BACK(&bbv_new, bb_new)) {
+				VEC_DELETE(&bbv_new);
+				return -1;
+			}
 
 			LOG(10,
 				"added new bad block: " BB_DATA_STR,
 				bb_new.offset, bb_new.length, bb_new.nhealthy);
 
-			bb_new.offset += bb_new.length;
-			length_left -= bb_new.length;
-
-			if (length_left == 0)
-				continue;
-
-			/* (*i_all) has to be less than (size_all - 1) */
-			ASSERT(*i_all < size_all - 1);
-			pbb_all = VEC_GET(pbbv_all, ++(*i_all));
+			off = healthy_end;
 		}
 	}
 
@@ -595,55 +615,17 @@ sync_badblocks_assign_healthy_replica(struct part_health_status *phs,
 
 	LOG(10, "added %u new bad blocks", phs->bbs.bb_cnt);
 
-	return 0;
-
-error_exit:
-	VEC_DELETE(&bbv_new);
-	return -1;
-}
-
-/*
- * sync_badblocks_move_vec -- (internal) move bad blocks from vector pbbv_all
- *                                       to vector pbbv_aux
- */
-static int
-sync_badblocks_move_vec(struct bb_vec *pbbv_all,
-			struct bb_vec *pbbv_aux,
-			unsigned i_all,
-			unsigned rep)
-{
-	LOG(3, "pbbv_all %p pbbv_aux %p i_all %u rep  %u",
-		pbbv_all, pbbv_aux, i_all, rep);
-
-	size_t size_all = VEC_SIZE(pbbv_all);
-	struct bad_block *pbb_all;
-
-	while (i_all < size_all) {
-		pbb_all = VEC_GET(pbbv_all, i_all++);
-
-		if (pbb_all->length == 0)
-			continue;
-
-		if (pbb_all->nhealthy == NO_HEALTHY_REPLICA && rep > 0)
-			/* it can be fixed using the last replica */
-			pbb_all->nhealthy = (int)rep;
-
-		if (VEC_PUSH_BACK(pbbv_aux, *pbb_all))
-			return -1;
-
-		LOG(10,
-			"added bad block (prev-after): " BB_DATA_STR,
-			pbb_all->offset, pbb_all->length,
-			pbb_all->nhealthy);
-	}
-
 	return 0;
 }
 
 /*
  * sync_check_bad_blocks_overlap -- (internal) check if there are uncorrectable
  *                                  bad blocks (bad blocks overlapping
- *                                  in all replicas)
+ *                                  in all replicas) and assign healthy
+ *                                  replica for each bad block
+ *
+ * The bad blocks of each replica are kept in an interval tree, so looking
+ * for a healthy replica takes O(log n) time per replica and bad block.
  */
 static int
 sync_check_bad_blocks_overlap(struct pool_set *set,
@@ -651,81 +633,12 @@ sync_check_bad_blocks_overlap(struct pool_set *set,
 {
 	LOG(3, "set %p set_hs %p", set, set_hs);
 
-	struct bb_vec bbv_all = VEC_INITIALIZER;
-	struct bb_vec bbv_aux = VEC_INITIALIZER;
-
-	int ret = -1;
-
-	for (unsigned r = 0; r < set->nreplicas; ++r) {
-		struct pool_replica *rep = REP(set, r);
-		struct replica_health_status *rep_hs = set_hs->replica[r];
-
-		unsigned i_all = 0;	/* index in bbv_all */
-
-		for (unsigned p = 0; p < rep->nparts; ++p) {
-			struct part_health_status *phs = &rep_hs->part[p];
-
-			if (!replica_part_has_bad_blocks(phs)) {
-				/* skip parts with no bad blocks */
-				continue;
-			}
-
-			ASSERTne(phs->bbs.bb_cnt, 0);
-			ASSERTne(phs->bbs.bbv, NULL);
-
-			LOG(10, "Replica %u part %u HAS %u bad blocks",
-				r, p, phs->bbs.bb_cnt);
-
-			/*
-			 * This function merges bad blocks from bbv_all
-			 * with bad blocks from the current part
-			 * and writes the outcome bad blocks to bbv_aux.
-			 * Only bad blocks with offsets less or equal
-			 * the greatest bad block's offset in the current part
-			 * will be moved from bbv_all to bbv_aux.
-			 * The rest of them has to be moved at the end
-			 * by sync_badblocks_move_vec() below.
-			 */
-			if (sync_badblocks_find_healthy_replica(phs, (int)r,
-							&bbv_all, &bbv_aux,
-							&i_all))
-				goto exit;
-		}
-
-		/*
-		 * Move the rest of bad blocks from bbv_all to bbv_aux
-		 * (for more details see the comment above).
-		 * All these bad blocks can be fixed using the last replica 'r'.
-		 */
-		if (sync_badblocks_move_vec(&bbv_all, &bbv_aux, i_all, r))
-			return -1;
-
-		/* bbv_aux becomes a new bbv_all */
-		VEC_MOVE(&bbv_all, &bbv_aux);
-		i_all = 0;
-	}
-
-	ret = 0;
-
-	/* check if there is an uncorrectable bad block */
-	size_t size_all = VEC_SIZE(&bbv_all);
-	for (unsigned i = 0; i < size_all; i++) {
-		struct bad_block *pbb_all = VEC_GET(&bbv_all, i);
-		if (pbb_all->nhealthy == NO_HEALTHY_REPLICA) {
-			ret = 1; /* this bad block cannot be fixed */
-
-			CORE_LOG_ERROR(
-				"uncorrectable bad block found: offset 0x%zx, length 0x%zx",
-				pbb_all->offset, pbb_all->length);
+	struct sync_bb_index *index = sync_badblocks_index_new(set, set_hs);
+	if (index == NULL)
+		return -1;
 
-			goto exit;
-		}
-	}
+	int ret = 0;
 
-	/*
-	 * All bad blocks can be fixed,
-	 * so assign healthy replica for each of them.
-	 */
 	for (unsigned r = 0; r < set->nreplicas; ++r) {
 		struct pool_replica *rep = REP(set, r);
 		struct replica_health_status *rep_hs = set_hs->replica[r];
@@ -735,8 +648,6 @@ sync_check_bad_blocks_overlap(struct pool_set *set,
 			continue;
 		}
 
-		unsigned i_all = 0;	/* index in bbv_all */
-
 		for (unsigned p = 0; p < rep->nparts; ++p) {
 			struct part_health_status *phs = &rep_hs->part[p];
 
@@ -745,16 +656,18 @@ sync_check_bad_blocks_overlap(struct pool_set *set,
 				continue;
 			}
 
-			if (sync_badblocks_assign_healthy_replica(phs, (int)r,
-								&bbv_all,
-								&i_all))
+			ASSERTne(phs->bbs.bb_cnt, 0);
+			ASSERTne(phs->bbs.bbv, NULL);
+
+			ret = sync_badblocks_assign_healthy_replica(set, index,
+								r, phs);
+			if (ret)
 				goto exit;
 		}
 	}
 
 exit:
-	VEC_DELETE(&bbv_aux);
-	VEC_DELETE(&bbv_all);
+	sync_badblocks_index_delete(set, index);
 
 	return ret;
 }
@@ -803,7 +716,7 @@ sync_badblocks_data(struct pool_set *set, struct poolset_health_status *set_hs)
 
 				if (sync_copy_data(src_addr, dst_addr,
 							part_off + off, len,
-							rep_h, rep, part))
+							rep_h, rep, part, 0))
 					return -1;
 			}
 
@@ -1091,13 +1004,55 @@ copy_data_to_broken_parts(struct pool_set *set, unsigned healthy_replica,
 			void *dst_addr = ADDR_SUM(part->addr, fpoff);
 
 			if (sync_copy_data(src_addr, dst_addr, off, len,
-						rep_h, rep, part))
+						rep_h, rep, part, flags))
 				return -1;
 		}
 	}
 	return 0;
 }
 
+/*
+ * mark_rebuilt_replicas -- (internal) mark all unhealthy replicas to be
+ *                          rebuilt online, starting from the beginning
+ */
+static int
+mark_rebuilt_replicas(struct pool_set *set,
+		struct poolset_health_status *set_hs)
+{
+	LOG(3, "set %p, set_hs %p", set, set_hs);
+
+	for (unsigned r = 0; r < set_hs->nreplicas; ++r) {
+		if (replica_is_replica_healthy(r, set_hs))
+			continue;
+
+		if (util_rebuild_set(set, r, 0))
+			return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * clear_rebuilt_replicas -- (internal) remove markers of an online rebuild
+ *                           from the replicas which have been synced
+ */
+static int
+clear_rebuilt_replicas(struct pool_set *set,
+		struct poolset_health_status *set_hs)
+{
+	LOG(3, "set %p, set_hs %p", set, set_hs);
+
+	for (unsigned r = 0; r < set_hs->nreplicas; ++r) {
+		if (replica_is_replica_healthy(r, set_hs))
+			continue;
+
+		if (util_rebuild_clear(set, r))
+			return -1;
+	}
+
+	return 0;
+}
+
 /*
  * grant_created_parts_perm -- (internal) set RW permission rights to all
  *                            the parts created in place of the broken ones
@@ -1333,6 +1288,16 @@ replica_sync(struct pool_set *set, struct poolset_health_status *s_hs,
 		set_hs = s_hs;
 	}
 
+	/* the master replica is the source of data for the online rebuild */
+	if (is_online_rebuild(flags) &&
+			!replica_is_replica_healthy(0, set_hs)) {
+		ERR_WO_ERRNO(
+			"the first replica has to be healthy for the online rebuild");
+		errno = EINVAL;
+		ret = -1;
+		goto out;
+	}
+
 	/* find a replica with healthy header; it will be the source of data */
 	unsigned healthy_replica = replica_find_healthy_replica(set_hs);
 	unsigned healthy_header = healthy_replica;
@@ -1435,12 +1400,28 @@ replica_sync(struct pool_set *set, struct poolset_health_status *s_hs,
 		goto out;
 	}
 
-	/* check and copy data if possible */
-	if (copy_data_to_broken_parts(set, healthy_replica,
-			flags, set_hs)) {
-		ERR_WO_ERRNO("copying data to broken parts failed");
-		ret = -1;
-		goto out;
+	if (is_online_rebuild(flags)) {
+		/* leave copying the data to libpmemobj */
+		if (mark_rebuilt_replicas(set, set_hs)) {
+			ERR_WO_ERRNO("marking replicas to be rebuilt failed");
+			ret = -1;
+			goto out;
+		}
+	} else {
+		/* check and copy data if possible */
+		if (copy_data_to_broken_parts(set, healthy_replica,
+				flags, set_hs)) {
+			ERR_WO_ERRNO("copying data to broken parts failed");
+			ret = -1;
+			goto out;
+		}
+
+		/* the data is complete, an online rebuild is not needed */
+		if (clear_rebuilt_replicas(set, set_hs)) {
+			ERR_WO_ERRNO("clearing replica rebuild markers failed");
+			ret = -1;
+			goto out;
+		}
 	}
 
 	/* update uuids of replicas and parts */
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2024, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * transform.c -- a module for poolset transforming
@@ -493,6 +493,23 @@ delete_replicas(struct pool_set *set, struct poolset_compare_status *set_s)
 	return 0;
 }
 
+/*
+ * replica_unused_ranges -- (internal) find the ranges of the pool which do
+ *                          not have to be copied
+ */
+static void
+replica_unused_ranges(struct pool_set *set, unsigned repn, size_t pool_size,
+		struct pool_ranges *unused)
+{
+	if (pool_hdr_get_type(HDR(REP(set, repn), 0)) != POOL_TYPE_OBJ)
+		return;
+
+	if (pool_obj_unused_ranges(PART(REP(set, repn), 0)->addr, pool_size,
+			unused))
+		CORE_LOG_WARNING("finding unused ranges of replica %u failed",
+			repn);
+}
+
 /*
  * copy_replica_data_fw -- (internal) copy data between replicas of two
  *                         poolsets, starting from the beginning of the
@@ -510,16 +527,25 @@ copy_replica_data_fw(struct pool_set *set_dst, struct pool_set *set_src,
 		pool_size = (ssize_t)set_src->poolsize;
 	}
 
+	struct pool_ranges unused = VEC_INITIALIZER;
+	replica_unused_ranges(set_src, repn, (size_t)pool_size, &unused);
+
 	size_t len = (size_t)pool_size - POOL_HDR_SIZE -
 			replica_get_part_data_len(set_src, repn, 0);
 	void *src = PART(REP(set_src, repn), 1)->addr;
 	void *dst = PART(REP(set_dst, repn), 1)->addr;
+	uint64_t off = (uintptr_t)src -
+		(uintptr_t)PART(REP(set_src, repn), 0)->addr;
 	size_t count = len / POOL_HDR_SIZE;
 	while (count-- > 0) {
-		pmem_memcpy_persist(dst, src, POOL_HDR_SIZE);
+		if (!pool_ranges_contain(&unused, off, POOL_HDR_SIZE))
+			pmem_memcpy_persist(dst, src, POOL_HDR_SIZE);
 		src = ADDR_SUM(src, POOL_HDR_SIZE);
 		dst = ADDR_SUM(dst, POOL_HDR_SIZE);
+		off += POOL_HDR_SIZE;
 	}
+
+	VEC_DELETE(&unused);
 }
 
 /*
@@ -538,16 +564,25 @@ copy_replica_data_bw(struct pool_set *set_dst, struct pool_set *set_src,
 		pool_size = (ssize_t)set_src->poolsize;
 	}
 
+	struct pool_ranges unused = VEC_INITIALIZER;
+	replica_unused_ranges(set_src, repn, (size_t)pool_size, &unused);
+
 	size_t len = (size_t)pool_size - POOL_HDR_SIZE -
 			replica_get_part_data_len(set_src, repn, 0);
 	size_t count = len / POOL_HDR_SIZE;
 	void *src = ADDR_SUM(PART(REP(set_src, repn), 1)->addr, len);
 	void *dst = ADDR_SUM(PART(REP(set_dst, repn), 1)->addr, len);
+	uint64_t off = (uintptr_t)src -
+		(uintptr_t)PART(REP(set_src, repn), 0)->addr;
 	while (count-- > 0) {
 		src = ADDR_SUM(src, -(ssize_t)POOL_HDR_SIZE);
 		dst = ADDR_SUM(dst, -(ssize_t)POOL_HDR_SIZE);
-		pmem_memcpy_persist(dst, src, POOL_HDR_SIZE);
+		off -= POOL_HDR_SIZE;
+		if (!pool_ranges_contain(&unused, off, POOL_HDR_SIZE))
+			pmem_memcpy_persist(dst, src, POOL_HDR_SIZE);
 	}
+
+	VEC_DELETE(&unused);
 }
 
 /*
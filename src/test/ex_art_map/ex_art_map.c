@@ -0,0 +1,566 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * ex_art_map.c -- test of the adaptive radix tree example
+ *
+ * usage: ex_art_map file op:
+ *	b - checks the interface of the keys of any length
+ *	t nthreads nops - inserts, removes and looks up the keys concurrently
+ *	c nkeys - creates the map with the keys [0, nkeys)
+ *	i nkeys nth b|a - inserts the keys [0, nkeys) and exits at nth publish,
+ *		before or after it
+ *	r nkeys nth b|a - removes the keys [0, nkeys) and exits at nth publish
+ *	v nkeys i|r - verifies the map after the interrupted inserts or removes
+ *		and completes them
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "art_map.h"
+#include "os_thread.h"
+#include "unittest.h"
+#include "ut_map.h"
+
+#define LAYOUT_NAME "ex_art_map"
+
+/* the type number of the leaves of art_map */
+#define LEAF_TYPE_NUM (ART_MAP_TYPE_OFFSET + 5)
+
+/* longer than a prefix stored in a single node */
+#define KEY_PREFIX "the/common/part/of/all/of/the/keys/"
+#define KEY_LEN_MAX 64
+
+#define MAX_THREADS 64
+
+/* number of the keys used by the threads */
+#define THREAD_KEYS 2000
+
+struct root {
+	TOID(struct art_map) map;
+};
+
+/*
+ * key_get -- writes the key of the index to the buffer, returns its length,
+ * the key of 1 is a prefix of the key of 10
+ */
+static size_t
+key_get(uint64_t i, char *buf)
+{
+	return (size_t)sprintf(buf, "%s%" PRIu64, KEY_PREFIX, i);
+}
+
+/*
+ * map_open -- opens the pool with the map, without recovering it
+ */
+static PMEMobjpool *
+map_open(const char *path, TOID(struct art_map) *map)
+{
+	struct root *r;
+	PMEMobjpool *pop = ut_map_pool_open(path, LAYOUT_NAME, sizeof(*r),
+		(void **)&r);
+
+	*map = r->map;
+	UT_ASSERTeq(art_map_check(pop, *map), 0);
+
+	return pop;
+}
+
+/*
+ * map_create -- creates the pool with the map
+ */
+static PMEMobjpool *
+map_create(const char *path, TOID(struct art_map) *map)
+{
+	struct root *r;
+	PMEMobjpool *pop = ut_map_pool_create(path, LAYOUT_NAME, sizeof(*r),
+		(void **)&r);
+
+	UT_ASSERTeq(art_map_create(pop, &r->map, NULL), 0);
+	*map = r->map;
+
+	return pop;
+}
+
+/*
+ * leaves_count -- returns the number of the leaves allocated in the pool,
+ * including the removed ones which have not been freed yet
+ */
+static size_t
+leaves_count(PMEMobjpool *pop)
+{
+	size_t n = 0;
+
+	for (PMEMoid oid = pmemobj_first(pop); !OID_IS_NULL(oid);
+			oid = pmemobj_next(oid)) {
+		if (pmemobj_type_num(oid) == LEAF_TYPE_NUM)
+			n++;
+	}
+
+	return n;
+}
+
+/*
+ * key_cmp -- compares two strings of bytes, a prefix is lower
+ */
+static int
+key_cmp(const void *k1, size_t len1, const void *k2, size_t len2)
+{
+	int cmp = memcmp(k1, k2, len1 < len2 ? len1 : len2);
+	if (cmp != 0)
+		return cmp;
+
+	return len1 < len2 ? -1 : len1 > len2;
+}
+
+struct order_check {
+	uint8_t prev[ART_MAP_MAX_KEY_LEN];
+	size_t prev_len;
+	size_t n;
+};
+
+/*
+ * order_cb -- range callback checking the keys are visited in their order
+ */
+static int
+order_cb(const void *key, size_t key_len, PMEMoid value, void *arg)
+{
+	struct order_check *c = arg;
+
+	UT_ASSERT(key_len <= ART_MAP_MAX_KEY_LEN);
+	if (c->n != 0)
+		UT_ASSERT(key_cmp(c->prev, c->prev_len, key, key_len) < 0);
+
+	memcpy(c->prev, key, key_len);
+	c->prev_len = key_len;
+	c->n++;
+
+	return 0;
+}
+
+/*
+ * keys_ordered -- returns the number of the keys, checking their order
+ */
+static size_t
+keys_ordered(PMEMobjpool *pop, TOID(struct art_map) map)
+{
+	struct order_check *c = MALLOC(sizeof(*c));
+	c->n = 0;
+
+	UT_ASSERTeq(art_map_range_bytes(pop, map, NULL, 0, NULL, 0,
+		order_cb, c), 0);
+
+	size_t n = c->n;
+	FREE(c);
+
+	return n;
+}
+
+/*
+ * key_print -- prints the key, the bytes which are not letters are printed
+ * as hexadecimal numbers and the long keys are shortened
+ */
+static void
+key_print(char *out, const void *key, size_t key_len)
+{
+	const uint8_t *k = key;
+	size_t len = key_len > 8 ? 4 : key_len;
+
+	out += sprintf(out, "\"");
+	for (size_t i = 0; i < len; ++i) {
+		if (k[i] >= 'a' && k[i] <= 'z')
+			out += sprintf(out, "%c", k[i]);
+		else
+			out += sprintf(out, "\\x%02x", k[i]);
+	}
+	if (len < key_len)
+		out += sprintf(out, "...");
+	sprintf(out, "\" (%zu)", key_len);
+}
+
+/*
+ * print_cb -- range callback printing the keys and their values
+ */
+static int
+print_cb(const void *key, size_t key_len, PMEMoid value, void *arg)
+{
+	char buf[64];
+	key_print(buf, key, key_len);
+	UT_OUT("%s: %" PRIu64, buf, value.off);
+
+	return 0;
+}
+
+/*
+ * print_range -- prints the keys of the range
+ */
+static void
+print_range(PMEMobjpool *pop, TOID(struct art_map) map, const char *name,
+	const void *start, size_t start_len, const void *end, size_t end_len)
+{
+	UT_OUT("%s:", name);
+	UT_ASSERTeq(art_map_range_bytes(pop, map, start, start_len,
+		end, end_len, print_cb, NULL), 0);
+}
+
+struct bytes_key {
+	const char *key;
+	size_t len;
+};
+
+/*
+ * do_bytes -- checks the interface of the keys of any length
+ */
+static void
+do_bytes(const char *path)
+{
+	TOID(struct art_map) map;
+	PMEMobjpool *pop = map_create(path, &map);
+
+	static char longest[ART_MAP_MAX_KEY_LEN + 1];
+	memset(longest, 'x', sizeof(longest));
+
+	/* the prefixes of each other, the lowest and the highest bytes */
+	struct bytes_key keys[] = {
+		{"", 0},
+		{"a", 1},
+		{"ab", 2},
+		{"abc", 3},
+		{"\0", 1},
+		{"\0\0", 2},
+		{"\xff", 1},
+		{"\xff\xff", 2},
+		{"abcdefghijklmnopqrstuvwxyz", 26},
+		{longest, ART_MAP_MAX_KEY_LEN - 1},
+		{longest, ART_MAP_MAX_KEY_LEN},
+	};
+	size_t nkeys = ARRAY_SIZE(keys);
+
+	for (size_t i = 0; i < nkeys; ++i) {
+		UT_ASSERTeq(art_map_insert_bytes(pop, map, keys[i].key,
+			keys[i].len, ut_map_value(i)), 0);
+	}
+	for (size_t i = 0; i < nkeys; ++i) {
+		UT_ASSERTeq(art_map_insert_bytes(pop, map, keys[i].key,
+			keys[i].len, ut_map_value(i + 100)), 1);
+		UT_ASSERTeq(art_map_get_bytes(pop, map, keys[i].key,
+			keys[i].len).off, ut_map_value(i).off);
+	}
+
+	/* too long */
+	errno = 0;
+	UT_ASSERTeq(art_map_insert_bytes(pop, map, longest,
+		ART_MAP_MAX_KEY_LEN + 1, ut_map_value(0)), -1);
+	UT_ASSERTeq(errno, EINVAL);
+
+	/* not inserted, but share a part with the inserted keys */
+	UT_ASSERT(OID_IS_NULL(art_map_get_bytes(pop, map, "abcd", 4)));
+	UT_ASSERT(OID_IS_NULL(art_map_get_bytes(pop, map, "b", 1)));
+	UT_ASSERT(OID_IS_NULL(art_map_get_bytes(pop, map, "\0\0\0", 3)));
+	UT_ASSERT(OID_IS_NULL(art_map_get_bytes(pop, map, longest,
+		ART_MAP_MAX_KEY_LEN - 2)));
+	UT_ASSERT(OID_IS_NULL(art_map_get_bytes(pop, map,
+		"abcdefghijklmnopqrstuvwxyy", 26)));
+
+	UT_ASSERTeq(art_map_count(pop, map), nkeys);
+
+	print_range(pop, map, "all", NULL, 0, NULL, 0);
+	print_range(pop, map, "[a, abc]", "a", 1, "abc", 3);
+	print_range(pop, map, "[\\x00\\x00, b]", "\0\0", 2, "b", 1);
+	print_range(pop, map, "[y, \\xff]", "y", 1, "\xff", 1);
+
+	/* the key is a prefix of the others and has a prefix */
+	UT_ASSERTeq(art_map_remove_bytes(pop, map, "ab", 2).off,
+		ut_map_value(2).off);
+	UT_ASSERT(OID_IS_NULL(art_map_remove_bytes(pop, map, "ab", 2)));
+	UT_ASSERTeq(art_map_get_bytes(pop, map, "a", 1).off,
+		ut_map_value(1).off);
+	UT_ASSERTeq(art_map_get_bytes(pop, map, "abc", 3).off,
+		ut_map_value(3).off);
+	UT_ASSERTeq(art_map_remove_bytes(pop, map, longest,
+		ART_MAP_MAX_KEY_LEN).off, ut_map_value(nkeys - 1).off);
+	UT_ASSERTeq(art_map_remove_bytes(pop, map, "", 0).off,
+		ut_map_value(0).off);
+
+	UT_ASSERTeq(art_map_count(pop, map), nkeys - 3);
+	print_range(pop, map, "removed", NULL, 0, NULL, 0);
+
+	for (size_t i = 0; i < nkeys; ++i)
+		art_map_remove_bytes(pop, map, keys[i].key, keys[i].len);
+	UT_ASSERTeq(art_map_count(pop, map), 0);
+	UT_ASSERTeq(art_map_is_empty(pop, map), 1);
+
+	pmemobj_close(pop);
+}
+
+struct thread_args {
+	PMEMobjpool *pop;
+	TOID(struct art_map) map;
+	unsigned seed;
+	unsigned nops;
+};
+
+/*
+ * rnd -- returns the next pseudo-random number
+ */
+static uint64_t
+rnd(uint64_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+/*
+ * writer -- inserts, removes and looks up the random keys
+ */
+static void *
+writer(void *arg)
+{
+	struct thread_args *a = arg;
+	uint64_t state = a->seed * 2654435761U + 1;
+	char key[KEY_LEN_MAX];
+
+	for (unsigned i = 0; i < a->nops; ++i) {
+		uint64_t k = rnd(&state) % THREAD_KEYS;
+		size_t len = key_get(k, key);
+
+		switch (rnd(&state) % 3) {
+		case 0:
+			UT_ASSERT(art_map_insert_bytes(a->pop, a->map, key,
+				len, ut_map_value(k)) >= 0);
+			break;
+		case 1: {
+			PMEMoid v = art_map_remove_bytes(a->pop, a->map, key,
+				len);
+			UT_ASSERT(OID_IS_NULL(v) ||
+				v.off == ut_map_value(k).off);
+			break;
+		}
+		default: {
+			PMEMoid v = art_map_get_bytes(a->pop, a->map, key,
+				len);
+			UT_ASSERT(OID_IS_NULL(v) ||
+				v.off == ut_map_value(k).off);
+		}
+		}
+	}
+
+	return NULL;
+}
+
+static int Writers_done;
+
+/*
+ * scanner -- checks the order of the keys until the writers are done
+ */
+static void *
+scanner(void *arg)
+{
+	struct thread_args *a = arg;
+
+	while (!__atomic_load_n(&Writers_done, __ATOMIC_ACQUIRE))
+		keys_ordered(a->pop, a->map);
+
+	return NULL;
+}
+
+/*
+ * do_threads -- modifies the map from a number of threads while another one
+ * scans it
+ */
+static void
+do_threads(const char *path, unsigned nthreads, unsigned nops)
+{
+	UT_ASSERT(nthreads > 0 && nthreads <= MAX_THREADS);
+
+	TOID(struct art_map) map;
+	PMEMobjpool *pop = map_create(path, &map);
+
+	os_thread_t threads[MAX_THREADS + 1];
+	struct thread_args args[MAX_THREADS + 1];
+
+	for (unsigned i = 0; i <= nthreads; ++i) {
+		args[i].pop = pop;
+		args[i].map = map;
+		args[i].seed = i;
+		args[i].nops = nops;
+	}
+
+	THREAD_CREATE(&threads[nthreads], NULL, scanner, &args[nthreads]);
+	for (unsigned i = 0; i < nthreads; ++i)
+		THREAD_CREATE(&threads[i], NULL, writer, &args[i]);
+	for (unsigned i = 0; i < nthreads; ++i)
+		THREAD_JOIN(&threads[i], NULL);
+	__atomic_store_n(&Writers_done, 1, __ATOMIC_RELEASE);
+	THREAD_JOIN(&threads[nthreads], NULL);
+
+	size_t n = 0;
+	char key[KEY_LEN_MAX];
+	for (uint64_t k = 0; k < THREAD_KEYS; ++k) {
+		PMEMoid v = art_map_get_bytes(pop, map, key, key_get(k, key));
+		UT_ASSERT(OID_IS_NULL(v) || v.off == ut_map_value(k).off);
+		n += !OID_IS_NULL(v);
+	}
+
+	UT_ASSERTeq(keys_ordered(pop, map), n);
+	UT_ASSERTeq(art_map_count(pop, map), n);
+
+	/* the map can be emptied after all */
+	UT_ASSERTeq(art_map_clear(pop, map), 0);
+	UT_ASSERTeq(art_map_count(pop, map), 0);
+	UT_ASSERTeq(art_map_is_empty(pop, map), 1);
+
+	pmemobj_close(pop);
+
+	UT_OUT("%u threads", nthreads);
+}
+
+/*
+ * do_create -- creates the map with the keys [0, nkeys)
+ */
+static void
+do_create(const char *path, uint64_t nkeys)
+{
+	TOID(struct art_map) map;
+	PMEMobjpool *pop = map_create(path, &map);
+	char key[KEY_LEN_MAX];
+
+	for (uint64_t k = 0; k < nkeys; ++k) {
+		UT_ASSERTeq(art_map_insert_bytes(pop, map, key,
+			key_get(k, key), ut_map_value(k)), 0);
+	}
+
+	pmemobj_close(pop);
+}
+
+/*
+ * do_interrupt -- inserts or removes the keys [0, nkeys) in order and exits
+ * at nth publish
+ */
+static void
+do_interrupt(const char *path, uint64_t nkeys, int insert, unsigned nth,
+	int after)
+{
+	TOID(struct art_map) map;
+	PMEMobjpool *pop = map_open(path, &map);
+	UT_ASSERTeq(art_map_init(pop, map), 0);
+	char key[KEY_LEN_MAX];
+
+	ut_map_interrupt(nth, after);
+
+	for (uint64_t k = 0; k < nkeys; ++k) {
+		size_t len = key_get(k, key);
+		if (insert) {
+			UT_ASSERTeq(art_map_insert_bytes(pop, map, key, len,
+				ut_map_value(k)), 0);
+		} else {
+			UT_ASSERTeq(art_map_remove_bytes(pop, map, key,
+				len).off, ut_map_value(k).off);
+		}
+	}
+
+	UT_FATAL("the operations were not interrupted");
+}
+
+/*
+ * do_verify -- checks the interrupted inserts or removes were done in order,
+ * none of the leaves is leaked, and completes them
+ */
+static void
+do_verify(const char *path, uint64_t nkeys, int insert)
+{
+	TOID(struct art_map) map;
+	PMEMobjpool *pop = map_open(path, &map);
+	char key[KEY_LEN_MAX];
+
+	/* the readers do not need the map to be recovered */
+	uint64_t first = nkeys;
+	uint64_t n = 0;
+	for (uint64_t k = 0; k < nkeys; ++k) {
+		PMEMoid v = art_map_get_bytes(pop, map, key, key_get(k, key));
+		if (OID_IS_NULL(v))
+			continue;
+		UT_ASSERTeq(v.off, ut_map_value(k).off);
+		if (n++ == 0)
+			first = k;
+	}
+
+	/* the keys are a prefix of the inserted ones or a suffix */
+	UT_ASSERT(n > 0 && n < nkeys);
+	UT_ASSERTeq(first, insert ? 0 : nkeys - n);
+	UT_ASSERTeq(keys_ordered(pop, map), n);
+
+	/* the unlinked leaves are freed when the map is recovered */
+	UT_ASSERTeq(art_map_count(pop, map), n);
+	UT_ASSERTeq(leaves_count(pop), n);
+
+	for (uint64_t k = 0; k < nkeys; ++k) {
+		size_t len = key_get(k, key);
+		if (insert && k >= n) {
+			UT_ASSERTeq(art_map_insert_bytes(pop, map, key, len,
+				ut_map_value(k)), 0);
+		} else if (!insert && k < first) {
+			UT_ASSERT(OID_IS_NULL(art_map_remove_bytes(pop, map,
+				key, len)));
+		} else if (!insert) {
+			UT_ASSERTeq(art_map_remove_bytes(pop, map, key,
+				len).off, ut_map_value(k).off);
+		}
+	}
+
+	n = insert ? nkeys : 0;
+	UT_ASSERTeq(keys_ordered(pop, map), n);
+	UT_ASSERTeq(art_map_count(pop, map), n);
+
+	pmemobj_close(pop);
+
+	UT_OUT("%" PRIu64 " keys", n);
+}
+
+int
+main(int argc, char *argv[])
+{
+	START(argc, argv, "ex_art_map");
+
+	if (argc < 3)
+		UT_FATAL("usage: %s file b|t|c|i|r|v args...", argv[0]);
+
+	const char *path = argv[1];
+
+	switch (argv[2][0]) {
+	case 'b':
+		do_bytes(path);
+		break;
+	case 't':
+		if (argc < 5)
+			UT_FATAL("usage: %s file t nthreads nops", argv[0]);
+		do_threads(path, ATOU(argv[3]), ATOU(argv[4]));
+		break;
+	case 'c':
+		if (argc < 4)
+			UT_FATAL("usage: %s file c nkeys", argv[0]);
+		do_create(path, ATOULL(argv[3]));
+		break;
+	case 'i':
+	case 'r':
+		if (argc < 6)
+			UT_FATAL("usage: %s file i|r nkeys nth b|a", argv[0]);
+		do_interrupt(path, ATOULL(argv[3]), argv[2][0] == 'i',
+			ATOU(argv[4]), argv[5][0] == 'a');
+		break;
+	case 'v':
+		if (argc < 5)
+			UT_FATAL("usage: %s file v nkeys i|r", argv[0]);
+		do_verify(path, ATOULL(argv[3]), argv[4][0] == 'i');
+		break;
+	default:
+		UT_FATAL("unknown op %s", argv[2]);
+	}
+
+	DONE(NULL);
+}
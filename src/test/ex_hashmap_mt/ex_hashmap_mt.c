@@ -0,0 +1,352 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * ex_hashmap_mt.c -- test of the concurrent hashmap example
+ *
+ * usage: ex_hashmap_mt file op:
+ *	c nkeys - creates the hashmap with the keys [0, nkeys)
+ *	t nthreads nkeys - inserts and removes the keys concurrently
+ *	r nth b|a - interrupts the resize at nth publish, before or after it
+ *	g nkeys - interrupts the process with a lot of removed entries
+ *	v nkeys - verifies the hashmap has exactly the keys [0, nkeys)
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "hashmap_mt.h"
+#include "os_thread.h"
+#include "unittest.h"
+#include "ut_map.h"
+
+#define LAYOUT_NAME "ex_hashmap_mt"
+
+/* the seed is fixed for the interrupted resize to be reproducible */
+#define SEED 1234
+
+#define MAX_THREADS 64
+
+struct root {
+	TOID(struct hashmap_mt) map;
+};
+
+/*
+ * map_open -- opens the pool with the hashmap, without recovering it
+ */
+static PMEMobjpool *
+map_open(const char *path, TOID(struct hashmap_mt) *map)
+{
+	struct root *r;
+	PMEMobjpool *pop = ut_map_pool_open(path, LAYOUT_NAME, sizeof(*r),
+		(void **)&r);
+
+	*map = r->map;
+	UT_ASSERTeq(hm_mt_check(pop, *map), 0);
+
+	return pop;
+}
+
+/*
+ * map_create -- creates the pool with the hashmap
+ */
+static PMEMobjpool *
+map_create(const char *path, TOID(struct hashmap_mt) *map)
+{
+	struct root *r;
+	PMEMobjpool *pop = ut_map_pool_create(path, LAYOUT_NAME, sizeof(*r),
+		(void **)&r);
+	struct hashmap_args args = {SEED};
+
+	UT_ASSERTeq(hm_mt_create(pop, &r->map, &args), 0);
+	pmemobj_persist(pop, &r->map, sizeof(r->map));
+	*map = r->map;
+
+	return pop;
+}
+
+/*
+ * count_cb -- foreach callback counting the entries
+ */
+static int
+count_cb(uint64_t key, PMEMoid value, void *arg)
+{
+	UT_ASSERTeq(value.off, ut_map_value(key).off);
+	(*(size_t *)arg)++;
+
+	return 0;
+}
+
+/*
+ * entries_count -- returns the number of the entries allocated in the pool,
+ * including the removed ones which have not been freed yet
+ */
+static size_t
+entries_count(PMEMobjpool *pop)
+{
+	/* the type number of the entries of hashmap_mt */
+	uint64_t type = HASHMAP_MT_TYPE_OFFSET + 2;
+	size_t n = 0;
+
+	for (PMEMoid oid = pmemobj_first(pop); !OID_IS_NULL(oid);
+			oid = pmemobj_next(oid)) {
+		if (pmemobj_type_num(oid) == type)
+			n++;
+	}
+
+	return n;
+}
+
+/*
+ * do_create -- creates the hashmap with nkeys keys, which is not being
+ * resized when the pool is closed
+ */
+static void
+do_create(const char *path, uint64_t nkeys)
+{
+	TOID(struct hashmap_mt) map;
+	PMEMobjpool *pop = map_create(path, &map);
+
+	for (uint64_t k = 0; k < nkeys; ++k)
+		UT_ASSERTeq(hm_mt_insert(pop, map, k, ut_map_value(k)), 0);
+
+	/* finishes the resize in progress or performs a whole one */
+	UT_ASSERTeq(hm_mt_cmd(pop, map, HASHMAP_CMD_REBUILD, 0), 0);
+	UT_ASSERTeq(hm_mt_count(pop, map), nkeys);
+
+	pmemobj_close(pop);
+}
+
+/*
+ * do_verify -- checks the hashmap consists of the keys [0, nkeys) right
+ * after the pool is opened, without calling hm_mt_init first
+ */
+static void
+do_verify(const char *path, uint64_t nkeys)
+{
+	TOID(struct hashmap_mt) map;
+	PMEMobjpool *pop = map_open(path, &map);
+
+	for (uint64_t k = 0; k < nkeys; ++k) {
+		PMEMoid v = hm_mt_get(pop, map, k);
+		UT_ASSERTeq(v.off, ut_map_value(k).off);
+	}
+	for (uint64_t k = nkeys; k < 2 * nkeys; ++k)
+		UT_ASSERTeq(hm_mt_lookup(pop, map, k), 0);
+
+	/* the removed entries are freed when the hashmap is recovered */
+	UT_ASSERTeq(entries_count(pop), nkeys);
+
+	size_t n = 0;
+	UT_ASSERTeq(hm_mt_foreach(pop, map, count_cb, &n), 0);
+	UT_ASSERTeq(n, nkeys);
+	UT_ASSERTeq(hm_mt_count(pop, map), nkeys);
+
+	/* the interrupted resize can be finished */
+	UT_ASSERTeq(hm_mt_cmd(pop, map, HASHMAP_CMD_REBUILD, 0), 0);
+	for (uint64_t k = 0; k < nkeys; ++k)
+		UT_ASSERTeq(hm_mt_lookup(pop, map, k), 1);
+	UT_ASSERTeq(hm_mt_count(pop, map), nkeys);
+
+	pmemobj_close(pop);
+
+	UT_OUT("%" PRIu64 " keys", nkeys);
+}
+
+/*
+ * do_interrupt_resize -- starts the resize of the hashmap and exits in the
+ * middle of it
+ */
+static void
+do_interrupt_resize(const char *path, unsigned nth, int after)
+{
+	TOID(struct hashmap_mt) map;
+	PMEMobjpool *pop = map_open(path, &map);
+
+	/* the runtime state may be recovered with a publish */
+	UT_ASSERTeq(hm_mt_init(pop, map), 0);
+
+	ut_map_interrupt(nth, after);
+	hm_mt_cmd(pop, map, HASHMAP_CMD_REBUILD, 0);
+
+	UT_FATAL("the resize was not interrupted");
+}
+
+static int Foreach_started;
+
+/*
+ * block_cb -- foreach callback which never returns, so that the epoch of the
+ * thread is not advanced and no removed entry can be freed
+ */
+static int
+block_cb(uint64_t key, PMEMoid value, void *arg)
+{
+	__atomic_store_n(&Foreach_started, 1, __ATOMIC_RELEASE);
+	for (;;)
+		pause();
+
+	return 0;
+}
+
+/*
+ * foreach_worker -- blocks in hm_mt_foreach
+ */
+static void *
+foreach_worker(void *arg)
+{
+	PMEMobjpool *pop = arg;
+	PMEMoid root = pmemobj_root(pop, sizeof(struct root));
+
+	hm_mt_foreach(pop, ((struct root *)pmemobj_direct(root))->map,
+		block_cb, NULL);
+
+	return NULL;
+}
+
+/*
+ * do_interrupt_garbage -- inserts and removes a lot of keys which cannot be
+ * freed and exits, the keys [0, nkeys) are left intact
+ */
+static void
+do_interrupt_garbage(const char *path, uint64_t nkeys)
+{
+	TOID(struct hashmap_mt) map;
+	PMEMobjpool *pop = map_open(path, &map);
+	UT_ASSERTeq(hm_mt_init(pop, map), 0);
+
+	os_thread_t t;
+	THREAD_CREATE(&t, NULL, foreach_worker, pop);
+	while (!__atomic_load_n(&Foreach_started, __ATOMIC_ACQUIRE))
+		usleep(1000);
+
+	/* the resize waits for the foreach, the buckets get long */
+	uint64_t n = 64 * (nkeys + 64);
+	for (uint64_t k = nkeys; k < nkeys + n; ++k)
+		UT_ASSERTeq(hm_mt_insert(pop, map, k, ut_map_value(k)), 0);
+	for (uint64_t k = nkeys; k < nkeys + n; ++k)
+		UT_ASSERTeq(hm_mt_remove(pop, map, k).off, ut_map_value(k).off);
+
+	UT_ASSERTeq(entries_count(pop), nkeys + n);
+
+	_exit(0);
+}
+
+struct worker_args {
+	PMEMobjpool *pop;
+	TOID(struct hashmap_mt) map;
+	uint64_t first;
+	uint64_t step;
+	uint64_t nkeys;
+};
+
+/*
+ * worker -- inserts its keys and removes the odd ones, looking up the keys
+ * of all of the workers in the meantime
+ */
+static void *
+worker(void *arg)
+{
+	struct worker_args *a = arg;
+
+	for (uint64_t k = a->first; k < a->nkeys; k += a->step) {
+		UT_ASSERTeq(hm_mt_insert(a->pop, a->map, k,
+			ut_map_value(k)), 0);
+		UT_ASSERTeq(hm_mt_insert(a->pop, a->map, k,
+			ut_map_value(k)), 1);
+		UT_ASSERTeq(hm_mt_get(a->pop, a->map, k).off,
+			ut_map_value(k).off);
+
+		/* the key of another worker, may not be inserted yet */
+		uint64_t other = (k * 7) % a->nkeys;
+		PMEMoid v = hm_mt_get(a->pop, a->map, other);
+		UT_ASSERT(OID_IS_NULL(v) || v.off == ut_map_value(other).off);
+	}
+
+	for (uint64_t k = a->first; k < a->nkeys; k += a->step) {
+		if (k % 2 == 0)
+			continue;
+		UT_ASSERTeq(hm_mt_remove(a->pop, a->map, k).off,
+			ut_map_value(k).off);
+		UT_ASSERT(OID_IS_NULL(hm_mt_remove(a->pop, a->map, k)));
+		UT_ASSERTeq(hm_mt_lookup(a->pop, a->map, k), 0);
+	}
+
+	return NULL;
+}
+
+/*
+ * do_threads -- inserts and removes the keys from a number of threads
+ */
+static void
+do_threads(const char *path, unsigned nthreads, uint64_t nkeys)
+{
+	UT_ASSERT(nthreads > 0 && nthreads <= MAX_THREADS);
+
+	TOID(struct hashmap_mt) map;
+	PMEMobjpool *pop = map_create(path, &map);
+
+	os_thread_t threads[MAX_THREADS];
+	struct worker_args args[MAX_THREADS];
+
+	for (unsigned i = 0; i < nthreads; ++i) {
+		args[i].pop = pop;
+		args[i].map = map;
+		args[i].first = i;
+		args[i].step = nthreads;
+		args[i].nkeys = nkeys;
+		THREAD_CREATE(&threads[i], NULL, worker, &args[i]);
+	}
+	for (unsigned i = 0; i < nthreads; ++i)
+		THREAD_JOIN(&threads[i], NULL);
+
+	uint64_t expected = (nkeys + 1) / 2;
+	for (uint64_t k = 0; k < nkeys; ++k)
+		UT_ASSERTeq(hm_mt_lookup(pop, map, k), k % 2 == 0);
+
+	size_t n = 0;
+	UT_ASSERTeq(hm_mt_foreach(pop, map, count_cb, &n), 0);
+	UT_ASSERTeq(n, expected);
+	UT_ASSERTeq(hm_mt_count(pop, map), expected);
+
+	pmemobj_close(pop);
+
+	UT_OUT("%" PRIu64 " keys", expected);
+}
+
+int
+main(int argc, char *argv[])
+{
+	START(argc, argv, "ex_hashmap_mt");
+
+	if (argc < 4)
+		UT_FATAL("usage: %s file c|t|r|g|v args...", argv[0]);
+
+	const char *path = argv[1];
+
+	switch (argv[2][0]) {
+	case 'c':
+		do_create(path, ATOULL(argv[3]));
+		break;
+	case 't':
+		if (argc < 5)
+			UT_FATAL("usage: %s file t nthreads nkeys", argv[0]);
+		do_threads(path, ATOU(argv[3]), ATOULL(argv[4]));
+		break;
+	case 'r':
+		if (argc < 5)
+			UT_FATAL("usage: %s file r nth b|a", argv[0]);
+		do_interrupt_resize(path, ATOU(argv[3]), argv[4][0] == 'a');
+		break;
+	case 'g':
+		do_interrupt_garbage(path, ATOULL(argv[3]));
+		break;
+	case 'v':
+		do_verify(path, ATOULL(argv[3]));
+		break;
+	default:
+		UT_FATAL("unknown op %s", argv[2]);
+	}
+
+	DONE(NULL);
+}
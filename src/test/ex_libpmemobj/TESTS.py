@@ -1,13 +1,13 @@
 #!../env.py
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2021-2023, Intel Corporation
+# Copyright 2021-2026, Intel Corporation
 #
 import os
 import testframework as t
 import futils
 
-TEST_PARAMS = ['hashmap_tx', 'hashmap_atomic', 'hashmap_rp',
-               'ctree', 'btree', 'rtree',
+TEST_PARAMS = ['hashmap_tx', 'hashmap_atomic', 'hashmap_rp', 'hashmap_mt',
+               'ctree', 'btree', 'fptree', 'art', 'rtree',
                'rbtree', 'skiplist']
 
 
@@ -53,8 +53,11 @@ class TEST27(EX_LIBPMEMOBJ):
         arg_fun_dict = {'hashmap_tx': 'create_hashmap',
                         'hashmap_atomic': "create_hashmap",
                         'hashmap_rp': "hashmap_create",
+                        'hashmap_mt': "hashmap_create",
                         'ctree': 'ctree_map_create',
                         'btree': 'btree_map_create',
+                        'fptree': 'fptree_map_create',
+                        'art': 'art_map_create',
                         'rtree': 'rtree_map_create',
                         'rbtree': 'rbtree_map_create',
                         'skiplist': 'skiplist_map_create'}
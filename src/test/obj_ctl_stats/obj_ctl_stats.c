@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2017-2023, Intel Corporation */
+/* Copyright 2017-2026, Intel Corporation */
 
 /*
  * obj_ctl_stats.c -- tests for the libpmemobj statistics module
@@ -116,9 +116,34 @@ main(int argc, char *argv[])
 	UT_ASSERTeq(ret, 0);
 	UT_ASSERTeq(tmp, 0);
 
+	/* the heap was booted, but none of its zones reclaimed yet */
+	uint64_t boot_time = 0;
+	ret = pmemobj_ctl_get(pop, "stats.boot.heap_time", &boot_time);
+	UT_ASSERTeq(ret, 0);
+	UT_ASSERTne(boot_time, 0);
+
+	ret = pmemobj_ctl_get(pop, "stats.boot.redo_recovery_time",
+		&boot_time);
+	UT_ASSERTeq(ret, 0);
+
+	ret = pmemobj_ctl_get(pop, "stats.boot.undo_recovery_time",
+		&boot_time);
+	UT_ASSERTeq(ret, 0);
+
+	uint64_t reclaim_time = 0;
+	ret = pmemobj_ctl_get(pop, "stats.heap.zone_reclaim_time",
+		&reclaim_time);
+	UT_ASSERTeq(ret, 0);
+	UT_ASSERTeq(reclaim_time, 0);
+
 	ret = pmemobj_alloc(pop, NULL, 1, 0, NULL, NULL);
 	UT_ASSERTeq(ret, 0);
 
+	ret = pmemobj_ctl_get(pop, "stats.heap.zone_reclaim_time",
+		&reclaim_time);
+	UT_ASSERTeq(ret, 0);
+	UT_ASSERTne(reclaim_time, 0);
+
 	/* after first alloc, the previously allocated object will be found */
 	tmp = 0;
 	ret = pmemobj_ctl_get(pop, "stats.heap.run_allocated", &tmp);
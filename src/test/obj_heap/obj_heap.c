@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2015-2021, Intel Corporation */
+/* Copyright 2015-2026, Intel Corporation */
 
 /*
  * obj_heap.c -- unit test for heap
@@ -412,12 +412,15 @@ test_heap_with_size()
 	struct palloc_heap *heap = &pop->heap;
 	struct pmem_ops *p_ops = &pop->p_ops;
 
+	struct stats *stats = stats_new(pop);
+	UT_ASSERTne(stats, NULL);
+
 	UT_ASSERT(heap_check(heap_start, heap_size) != 0);
 	UT_ASSERT(heap_init(heap_start, heap_size,
 		&pop->heap_size, p_ops) == 0);
 	UT_ASSERT(heap_boot(heap, heap_start, heap_size,
 		&pop->heap_size,
-		pop, p_ops, NULL, pop->set) == 0);
+		pop, p_ops, stats, pop->set) == 0);
 	UT_ASSERT(heap_buckets_init(heap) == 0);
 	UT_ASSERT(pop->heap.rt != NULL);
 
@@ -442,6 +445,7 @@ test_heap_with_size()
 	heap_bucket_release(b_def);
 
 	UT_ASSERT(heap_check(heap_start, heap_size) == 0);
+	stats_delete(pop, stats);
 	heap_cleanup(heap);
 	UT_ASSERT(heap->rt == NULL);
 
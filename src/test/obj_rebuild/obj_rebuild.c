@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * obj_rebuild.c -- unit test for the online rebuild of replicas
+ *
+ * usage: obj_rebuild poolset c|o|v
+ *
+ * c - create the pool and fill the first half of the root object
+ * o - open the pool, fill the second half of the root object while
+ *     the replicas are being rebuilt and wait until they are complete
+ * v - verify the contents of the root object
+ */
+
+#include "unittest.h"
+
+#define LAYOUT_NAME "obj_rebuild"
+#define ROOT_SIZE ((size_t)8 << 20)
+#define CHUNK_SIZE ((size_t)4096)
+
+/*
+ * fill -- fill the range of the root object, chunk by chunk
+ */
+static void
+fill(PMEMobjpool *pop, char *root, size_t off, size_t len)
+{
+	for (size_t i = off; i < off + len; i += CHUNK_SIZE)
+		pmemobj_memset_persist(pop, root + i,
+			(int)((i / CHUNK_SIZE) % 251 + 1), CHUNK_SIZE);
+}
+
+/*
+ * verify -- check the range of the root object
+ */
+static void
+verify(const char *root, size_t off, size_t len)
+{
+	for (size_t i = off; i < off + len; ++i) {
+		char c = (char)((i / CHUNK_SIZE) % 251 + 1);
+		if (root[i] != c)
+			UT_FATAL("byte %zu is 0x%x, expected 0x%x", i,
+				(unsigned char)root[i], (unsigned char)c);
+	}
+}
+
+/*
+ * rebuild_pending -- number of replicas still being rebuilt
+ */
+static int
+rebuild_pending(PMEMobjpool *pop)
+{
+	int pending;
+	int ret = pmemobj_ctl_get(pop, "replica.rebuild_pending", &pending);
+	UT_ASSERTeq(ret, 0);
+
+	return pending;
+}
+
+int
+main(int argc, char *argv[])
+{
+	START(argc, argv, "obj_rebuild");
+
+	if (argc != 3 || strchr("cov", argv[2][0]) == NULL)
+		UT_FATAL("usage: %s poolset c|o|v", argv[0]);
+
+	const char *path = argv[1];
+	PMEMobjpool *pop;
+
+	if (argv[2][0] == 'c') {
+		pop = pmemobj_create(path, LAYOUT_NAME, 0, S_IWUSR | S_IRUSR);
+		if (pop == NULL)
+			UT_FATAL("!pmemobj_create: %s", path);
+
+		char *root = pmemobj_direct(pmemobj_root(pop, ROOT_SIZE));
+		fill(pop, root, 0, ROOT_SIZE / 2);
+		UT_ASSERTeq(rebuild_pending(pop), 0);
+
+		pmemobj_close(pop);
+		DONE(NULL);
+	}
+
+	pop = pmemobj_open(path, LAYOUT_NAME);
+	if (pop == NULL)
+		UT_FATAL("!pmemobj_open: %s", path);
+
+	char *root = pmemobj_direct(pmemobj_root(pop, ROOT_SIZE));
+
+	if (argv[2][0] == 'o') {
+		fill(pop, root, ROOT_SIZE / 2, ROOT_SIZE / 2);
+
+		while (rebuild_pending(pop) != 0)
+			usleep(10 * 1000);
+	} else {
+		UT_ASSERTeq(rebuild_pending(pop), 0);
+	}
+
+	verify(root, 0, ROOT_SIZE);
+
+	pmemobj_close(pop);
+
+	DONE(NULL);
+}
@@ -1,6 +1,6 @@
 #!../env.py
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2019-2023, Intel Corporation
+# Copyright 2019-2026, Intel Corporation
 #
 
 
@@ -93,3 +93,23 @@ class TEST12(Pmem2ConfigNoDir):
     setting a invalid protection flags
     """
     test_case = "test_set_invalid_prot_flag"
+
+
+class TEST13(Pmem2ConfigNoDir):
+    """setting a valid flush filter"""
+    test_case = "test_set_flush_filter_valid"
+
+
+class TEST14(Pmem2ConfigNoDir):
+    """setting an invalid flush filter"""
+    test_case = "test_set_flush_filter_invalid"
+
+
+class TEST15(Pmem2ConfigNoDir):
+    """setting the number of mem threads"""
+    test_case = "test_set_mem_threads"
+
+
+class TEST16(Pmem2ConfigNoDir):
+    """setting the prefault mode"""
+    test_case = "test_set_prefault"
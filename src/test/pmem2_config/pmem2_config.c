@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2019-2020, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * pmem_config.c -- pmem2_config unittests
@@ -8,6 +8,7 @@
 #include "unittest.h"
 #include "ut_pmem2.h"
 #include "config.h"
+#include "mem_parallel.h"
 #include "out.h"
 #include "source.h"
 
@@ -263,6 +264,105 @@ test_set_invalid_prot_flag(const struct test_case *tc, int argc,
 	return 0;
 }
 
+/*
+ * test_set_flush_filter_valid -- enable and disable the flush filter
+ */
+static int
+test_set_flush_filter_valid(const struct test_case *tc, int argc,
+		char *argv[])
+{
+	struct pmem2_config cfg;
+	pmem2_config_init(&cfg);
+
+	/* check flush filter default value */
+	UT_ASSERTeq(cfg.flush_filter, PMEM2_FLUSH_FILTER_DISABLED);
+
+	int ret = pmem2_config_set_flush_filter(&cfg,
+		PMEM2_FLUSH_FILTER_ENABLED);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTeq(cfg.flush_filter, PMEM2_FLUSH_FILTER_ENABLED);
+
+	ret = pmem2_config_set_flush_filter(&cfg, PMEM2_FLUSH_FILTER_DISABLED);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTeq(cfg.flush_filter, PMEM2_FLUSH_FILTER_DISABLED);
+
+	return 0;
+}
+
+/*
+ * test_set_flush_filter_invalid -- setting invalid flush filter value
+ */
+static int
+test_set_flush_filter_invalid(const struct test_case *tc, int argc,
+		char *argv[])
+{
+	struct pmem2_config cfg;
+	pmem2_config_init(&cfg);
+
+	unsigned invalid_filter = 777;
+	int ret = pmem2_config_set_flush_filter(&cfg, invalid_filter);
+	UT_PMEM2_EXPECT_RETURN(ret, PMEM2_E_INVALID_FLUSH_FILTER_VALUE);
+	UT_ASSERTeq(cfg.flush_filter, PMEM2_FLUSH_FILTER_DISABLED);
+
+	return 0;
+}
+
+/*
+ * test_set_mem_threads -- set the number of mem threads
+ */
+static int
+test_set_mem_threads(const struct test_case *tc, int argc, char *argv[])
+{
+	struct pmem2_config cfg;
+	pmem2_config_init(&cfg);
+
+	/* check mem threads default value */
+	UT_ASSERTeq(cfg.mem_threads, 1);
+
+	int ret = pmem2_config_set_mem_threads(&cfg, 8);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTeq(cfg.mem_threads, 8);
+
+	/* too many threads are silently limited */
+	ret = pmem2_config_set_mem_threads(&cfg, 100000);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTeq(cfg.mem_threads, MEM_PARALLEL_MAX_THREADS);
+
+	ret = pmem2_config_set_mem_threads(&cfg, 0);
+	UT_PMEM2_EXPECT_RETURN(ret, PMEM2_E_INVALID_MEM_THREADS);
+	UT_ASSERTeq(cfg.mem_threads, MEM_PARALLEL_MAX_THREADS);
+
+	return 0;
+}
+
+/*
+ * test_set_prefault -- set the prefault mode
+ */
+static int
+test_set_prefault(const struct test_case *tc, int argc, char *argv[])
+{
+	struct pmem2_config cfg;
+	pmem2_config_init(&cfg);
+
+	/* prefaulting is disabled by default */
+	UT_ASSERTeq(cfg.prefault, PMEM2_PREFAULT_NONE);
+
+	int ret = pmem2_config_set_prefault(&cfg, PMEM2_PREFAULT_WRITE);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTeq(cfg.prefault, PMEM2_PREFAULT_WRITE);
+
+	ret = pmem2_config_set_prefault(&cfg, PMEM2_PREFAULT_READ);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTeq(cfg.prefault, PMEM2_PREFAULT_READ);
+
+	unsigned invalid_prefault = 777;
+	ret = pmem2_config_set_prefault(&cfg, invalid_prefault);
+	UT_PMEM2_EXPECT_RETURN(ret, PMEM2_E_INVALID_PREFAULT_VALUE);
+	UT_ASSERTeq(cfg.prefault, PMEM2_PREFAULT_READ);
+
+	return 0;
+}
+
 /*
  * test_cases -- available test cases
  */
@@ -280,6 +380,10 @@ static struct test_case test_cases[] = {
 	TEST_CASE(test_set_sharing_invalid),
 	TEST_CASE(test_set_valid_prot_flag),
 	TEST_CASE(test_set_invalid_prot_flag),
+	TEST_CASE(test_set_flush_filter_valid),
+	TEST_CASE(test_set_flush_filter_invalid),
+	TEST_CASE(test_set_mem_threads),
+	TEST_CASE(test_set_prefault),
 };
 
 #define NTESTS (sizeof(test_cases) / sizeof(test_cases[0]))
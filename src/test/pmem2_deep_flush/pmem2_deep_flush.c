@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2020-2023, Intel Corporation */
+/* Copyright 2020-2026, Intel Corporation */
 
 /*
  * pmem2_deep_flush.c -- unit test for pmem_deep_flush()
@@ -179,6 +179,16 @@ pmem2_map_find(const void *addr, size_t len)
 	return NULL;
 }
 
+/*
+ * pmem2_map_generation -- redefine libpmem2 function, redefinition is
+ * needed for a proper compilation of the test
+ */
+uint64_t
+pmem2_map_generation(void)
+{
+	return 0;
+}
+
 /*
  * pmem2_flush_file_buffers_os -- redefine libpmem2 function
  */
@@ -203,6 +213,8 @@ map_init(struct pmem2_map *map)
 	 * validate behavior with address beyond mapping.
 	 */
 	map->addr = MALLOC(2 * length);
+	map->flush_filter = PMEM2_FLUSH_FILTER_DISABLED;
+	map->memory_type = PMEM2_MEMORY_TYPE_UNKNOWN;
 	map->source.type = PMEM2_SOURCE_FD;
 	/* mocked device ID for device DAX */
 	map->source.value.st_rdev = MOCK_DEV_ID;
@@ -0,0 +1,57 @@
+#!../env.py
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2026, Intel Corporation
+#
+
+
+import testframework as t
+from testframework import granularity as g
+
+
+@g.require_granularity(g.CACHELINE)
+class PMEM2_FLUSH_FILTER(t.Test):
+    test_type = t.Short
+    test_case = None
+
+    def run(self, ctx):
+        filepath = ctx.create_holey_file(1 * t.MiB, 'testfile')
+        ctx.exec('pmem2_flush_filter', self.test_case, filepath)
+
+
+class TEST0(PMEM2_FLUSH_FILTER):
+    """repeated flushes of the same cache lines are elided"""
+    test_case = "test_filter_flush"
+
+
+class TEST1(PMEM2_FLUSH_FILTER):
+    """lines flushed by memcpy are not flushed again by persist"""
+    test_case = "test_filter_memcpy"
+
+
+class TEST2(PMEM2_FLUSH_FILTER):
+    """lines modified with NOFLUSH are flushed again"""
+    test_case = "test_filter_noflush"
+
+
+class TEST3(PMEM2_FLUSH_FILTER):
+    """nothing is elided when the filter is disabled"""
+    test_case = "test_filter_disabled"
+
+
+class TEST4(PMEM2_FLUSH_FILTER):
+    """the filter is private to each thread"""
+    test_case = "test_filter_threads"
+
+
+class TEST5(PMEM2_FLUSH_FILTER):
+    """ranges longer than the filter are flushed as a whole"""
+    test_case = "test_filter_long_range"
+
+
+class TEST6(PMEM2_FLUSH_FILTER):
+    """lines stored by the parallel mem functions are flushed again"""
+    test_case = "test_filter_parallel"
+
+    def run(self, ctx):
+        ctx.env['PMEM2_PARALLEL_THRESHOLD'] = str(8 * t.KiB)
+        super().run(ctx)
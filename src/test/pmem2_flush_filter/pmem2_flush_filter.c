@@ -0,0 +1,372 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * pmem2_flush_filter.c -- pmem2_config_set_flush_filter unittests
+ */
+
+#include "unittest.h"
+#include "ut_pmem2_utils.h"
+
+/*
+ * test_ctx -- essential parameters used by test
+ */
+struct test_ctx {
+	int fd;
+	struct pmem2_map *map;
+	char *addr;
+	pmem2_flush_fn flush_fn;
+	pmem2_drain_fn drain_fn;
+	pmem2_persist_fn persist_fn;
+	pmem2_memcpy_fn memcpy_fn;
+	pmem2_memset_fn memset_fn;
+	unsigned mem_threads;
+};
+
+/*
+ * test_init -- prepare resources required for testing
+ */
+static int
+test_init(const struct test_case *tc, int argc, char *argv[],
+		struct test_ctx *ctx, enum pmem2_flush_filter filter)
+{
+	if (argc < 1)
+		UT_FATAL("usage: %s <file>", tc->name);
+
+	char *file = argv[0];
+	ctx->fd = OPEN(file, O_RDWR);
+
+	struct pmem2_source *src;
+	int ret = pmem2_source_from_fd(&src, ctx->fd);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	struct pmem2_config *cfg;
+	ret = pmem2_config_new(&cfg);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_config_set_required_store_granularity(
+		cfg, PMEM2_GRANULARITY_PAGE);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_config_set_flush_filter(cfg, filter);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	if (ctx->mem_threads) {
+		ret = pmem2_config_set_mem_threads(cfg, ctx->mem_threads);
+		UT_PMEM2_EXPECT_RETURN(ret, 0);
+	}
+
+	ret = pmem2_map_new(&ctx->map, cfg, src);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTne(ctx->map, NULL);
+	UT_ASSERTeq(pmem2_map_get_store_granularity(ctx->map),
+		PMEM2_GRANULARITY_CACHE_LINE);
+
+	pmem2_config_delete(&cfg);
+	pmem2_source_delete(&src);
+
+	ctx->addr = pmem2_map_get_address(ctx->map);
+	ctx->flush_fn = pmem2_get_flush_fn(ctx->map);
+	ctx->drain_fn = pmem2_get_drain_fn(ctx->map);
+	ctx->persist_fn = pmem2_get_persist_fn(ctx->map);
+	ctx->memcpy_fn = pmem2_get_memcpy_fn(ctx->map);
+	ctx->memset_fn = pmem2_get_memset_fn(ctx->map);
+
+	pmem2_stats_enable();
+
+	/* the function returns the number of consumed arguments */
+	return 1;
+}
+
+/*
+ * test_fini -- cleanup the test resources
+ */
+static void
+test_fini(struct test_ctx *ctx)
+{
+	pmem2_stats_disable();
+	pmem2_map_delete(&ctx->map);
+	CLOSE(ctx->fd);
+}
+
+/*
+ * check_and_reset -- verify flushed/elided cache line counters
+ * of the calling thread
+ */
+static void
+check_and_reset(uint64_t flushed, uint64_t elided)
+{
+	struct pmem2_stats stats;
+	stats.size = sizeof(stats);
+	int ret = pmem2_stats_get(&stats, PMEM2_STATS_THREAD);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	UT_ASSERTeq(stats.flushed_lines, flushed);
+	UT_ASSERTeq(stats.elided_lines, elided);
+
+	ret = pmem2_stats_reset(PMEM2_STATS_THREAD);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+}
+
+/*
+ * test_filter_flush -- repeated flushes of the same cache lines are elided
+ */
+static int
+test_filter_flush(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx, PMEM2_FLUSH_FILTER_ENABLED);
+
+	/* drain so that lines flushed by earlier test cases are forgotten */
+	ctx.drain_fn();
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.flush_fn(ctx.addr, 128);
+	check_and_reset(2, 0);
+
+	/* the first line was already flushed, the second was not */
+	ctx.flush_fn(ctx.addr + 64, 128);
+	check_and_reset(1, 1);
+
+	/* everything is flushed again after a drain */
+	ctx.drain_fn();
+	ctx.flush_fn(ctx.addr, 192);
+	check_and_reset(3, 0);
+
+	/* a gap between elided lines is still flushed */
+	ctx.drain_fn();
+	ctx.flush_fn(ctx.addr, 64);
+	ctx.flush_fn(ctx.addr + 128, 64);
+	check_and_reset(2, 0);
+	ctx.flush_fn(ctx.addr, 192);
+	check_and_reset(1, 2);
+
+	ctx.persist_fn(ctx.addr, 192);
+	check_and_reset(0, 3);
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_filter_memcpy -- lines flushed by memcpy are not flushed again
+ */
+static int
+test_filter_memcpy(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx, PMEM2_FLUSH_FILTER_ENABLED);
+
+	char src[256];
+	memset(src, 0xab, sizeof(src));
+
+	ctx.drain_fn();
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.memcpy_fn(ctx.addr, src, sizeof(src), PMEM2_F_MEM_NODRAIN);
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.persist_fn(ctx.addr, sizeof(src));
+	check_and_reset(0, 4);
+
+	/* memcpy with an implicit drain leaves nothing behind */
+	ctx.memcpy_fn(ctx.addr, src, sizeof(src), 0);
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.persist_fn(ctx.addr, sizeof(src));
+	check_and_reset(4, 0);
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_filter_noflush -- lines modified with NOFLUSH are flushed again
+ */
+static int
+test_filter_noflush(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx, PMEM2_FLUSH_FILTER_ENABLED);
+
+	char src[64];
+	memset(src, 0xcd, sizeof(src));
+
+	ctx.drain_fn();
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.flush_fn(ctx.addr, 128);
+	check_and_reset(2, 0);
+
+	ctx.memcpy_fn(ctx.addr + 64, src, sizeof(src), PMEM2_F_MEM_NOFLUSH |
+		PMEM2_F_MEM_TEMPORAL);
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.flush_fn(ctx.addr, 128);
+	check_and_reset(1, 1);
+
+	ctx.drain_fn();
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_filter_disabled -- nothing is elided when the filter is disabled
+ */
+static int
+test_filter_disabled(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx, PMEM2_FLUSH_FILTER_DISABLED);
+
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.flush_fn(ctx.addr, 128);
+	ctx.flush_fn(ctx.addr, 128);
+	check_and_reset(4, 0);
+
+	ctx.drain_fn();
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * worker_flush -- (internal) flush a cache line from a separate thread
+ */
+static void *
+worker_flush(void *arg)
+{
+	struct test_ctx *ctx = arg;
+
+	ctx->flush_fn(ctx->addr, 64);
+	check_and_reset(1, 0);
+
+	ctx->drain_fn();
+
+	return NULL;
+}
+
+/*
+ * test_filter_threads -- the filter is private to each thread
+ */
+static int
+test_filter_threads(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx, PMEM2_FLUSH_FILTER_ENABLED);
+
+	ctx.drain_fn();
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.flush_fn(ctx.addr, 64);
+	check_and_reset(1, 0);
+
+	/* a drain in another thread does not affect this one */
+	os_thread_t thread;
+	THREAD_CREATE(&thread, NULL, worker_flush, &ctx);
+	THREAD_JOIN(&thread, NULL);
+
+	ctx.flush_fn(ctx.addr, 64);
+	check_and_reset(0, 1);
+
+	ctx.drain_fn();
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_filter_long_range -- ranges longer than the filter are flushed
+ * as a whole
+ */
+static int
+test_filter_long_range(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx, PMEM2_FLUSH_FILTER_ENABLED);
+
+	const size_t len = 512 * 1024;
+	const uint64_t nlines = len / 64;
+
+	ctx.drain_fn();
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.flush_fn(ctx.addr, len);
+	check_and_reset(nlines, 0);
+
+	ctx.flush_fn(ctx.addr, len);
+	check_and_reset(nlines, 0);
+
+	ctx.drain_fn();
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_filter_parallel -- lines modified by the worker threads of
+ * a parallel NOFLUSH memset are flushed again
+ */
+static int
+test_filter_parallel(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	ctx.mem_threads = 2;
+	int ret = test_init(tc, argc, argv, &ctx, PMEM2_FLUSH_FILTER_ENABLED);
+
+	/*
+	 * PMEM2_PARALLEL_THRESHOLD is lowered by the test script, so the range
+	 * is split into chunks and still fits in the filter
+	 */
+	size_t len = 16 * 1024;
+	size_t nlines = len / 64;
+
+	ctx.drain_fn();
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.flush_fn(ctx.addr, len);
+	check_and_reset(nlines, 0);
+
+	ctx.memset_fn(ctx.addr, 0xab, len, PMEM2_F_MEM_NOFLUSH);
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+
+	ctx.flush_fn(ctx.addr, len);
+	check_and_reset(nlines, 0);
+
+	ctx.drain_fn();
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_cases -- available test cases
+ */
+static struct test_case test_cases[] = {
+	TEST_CASE(test_filter_flush),
+	TEST_CASE(test_filter_memcpy),
+	TEST_CASE(test_filter_noflush),
+	TEST_CASE(test_filter_disabled),
+	TEST_CASE(test_filter_threads),
+	TEST_CASE(test_filter_long_range),
+	TEST_CASE(test_filter_parallel),
+};
+
+#define NTESTS (sizeof(test_cases) / sizeof(test_cases[0]))
+
+int
+main(int argc, char *argv[])
+{
+	START(argc, argv, "pmem2_flush_filter");
+	TEST_CASE_PROCESS(argc, argv, test_cases, NTESTS);
+	DONE(NULL);
+}
@@ -0,0 +1,55 @@
+#!../env.py
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2026, Intel Corporation
+#
+
+
+import testframework as t
+from testframework import granularity as g
+
+
+@g.require_granularity(g.ANY)
+class PMEM2_MEM_PARALLEL(t.Test):
+    test_type = t.Short
+    test_case = None
+
+    def run(self, ctx):
+        # split ranges of 64 KiB and more, so that the test stays short
+        ctx.env['PMEM2_PARALLEL_THRESHOLD'] = str(64 * t.KiB)
+        filepath = ctx.create_holey_file(8 * t.MiB, 'testfile')
+        ctx.exec('pmem2_mem_parallel', self.test_case, filepath)
+
+
+class TEST0(PMEM2_MEM_PARALLEL):
+    """multi-threaded memcpy of an unaligned range"""
+    test_case = "test_memcpy_parallel"
+
+
+class TEST1(PMEM2_MEM_PARALLEL):
+    """multi-threaded memset of an unaligned range"""
+    test_case = "test_memset_parallel"
+
+
+class TEST2(PMEM2_MEM_PARALLEL):
+    """overlapping memmove falls back to a single thread"""
+    test_case = "test_memmove_overlap"
+
+
+class TEST3(PMEM2_MEM_PARALLEL):
+    """multi-threaded writes with NODRAIN and NOFLUSH flags"""
+    test_case = "test_parallel_flags"
+
+
+class TEST4(PMEM2_MEM_PARALLEL):
+    """concurrent large writes from many threads"""
+    test_case = "test_parallel_mt"
+
+
+class TEST5(PMEM2_MEM_PARALLEL):
+    """large writes to a mapping created in place of a deleted one"""
+    test_case = "test_map_remap"
+
+
+class TEST6(PMEM2_MEM_PARALLEL):
+    """large writes in children forked while the worker pool is in use"""
+    test_case = "test_parallel_fork"
@@ -0,0 +1,424 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * pmem2_mem_parallel.c -- pmem2_config_set_mem_threads unittests
+ */
+
+#include <sys/wait.h>
+
+#include "unittest.h"
+#include "ut_pmem2_utils.h"
+
+#define MEGABYTE ((size_t)1 << 20)
+
+#define MEM_THREADS 4
+#define WORKERS 4
+#define FORKS 8
+
+/*
+ * test_ctx -- essential parameters used by test
+ */
+struct test_ctx {
+	int fd;
+	struct pmem2_map *map;
+	char *addr;
+	size_t size;
+	pmem2_memmove_fn memmove_fn;
+	pmem2_memcpy_fn memcpy_fn;
+	pmem2_memset_fn memset_fn;
+	pmem2_persist_fn persist_fn;
+	pmem2_drain_fn drain_fn;
+};
+
+/*
+ * test_init -- prepare resources required for testing
+ */
+static int
+test_init(const struct test_case *tc, int argc, char *argv[],
+		struct test_ctx *ctx)
+{
+	if (argc < 1)
+		UT_FATAL("usage: %s <file>", tc->name);
+
+	char *file = argv[0];
+	ctx->fd = OPEN(file, O_RDWR);
+
+	struct pmem2_source *src;
+	int ret = pmem2_source_from_fd(&src, ctx->fd);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	struct pmem2_config *cfg;
+	ret = pmem2_config_new(&cfg);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_config_set_required_store_granularity(
+		cfg, PMEM2_GRANULARITY_PAGE);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_config_set_mem_threads(cfg, MEM_THREADS);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_map_new(&ctx->map, cfg, src);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTne(ctx->map, NULL);
+
+	pmem2_config_delete(&cfg);
+	pmem2_source_delete(&src);
+
+	ctx->addr = pmem2_map_get_address(ctx->map);
+	ctx->size = pmem2_map_get_size(ctx->map);
+	ctx->memmove_fn = pmem2_get_memmove_fn(ctx->map);
+	ctx->memcpy_fn = pmem2_get_memcpy_fn(ctx->map);
+	ctx->memset_fn = pmem2_get_memset_fn(ctx->map);
+	ctx->persist_fn = pmem2_get_persist_fn(ctx->map);
+	ctx->drain_fn = pmem2_get_drain_fn(ctx->map);
+
+	/* the function returns the number of consumed arguments */
+	return 1;
+}
+
+/*
+ * test_fini -- cleanup the test resources
+ */
+static void
+test_fini(struct test_ctx *ctx)
+{
+	pmem2_map_delete(&ctx->map);
+	CLOSE(ctx->fd);
+}
+
+/*
+ * fill_pattern -- fill the buffer with a position-dependent pattern
+ */
+static void
+fill_pattern(char *buf, size_t len, unsigned seed)
+{
+	for (size_t i = 0; i < len; ++i)
+		buf[i] = (char)((i * 7 + seed) % 251);
+}
+
+/*
+ * check_byte -- verify that the range is filled with a single byte value
+ */
+static void
+check_byte(const char *buf, int c, size_t len)
+{
+	for (size_t i = 0; i < len; ++i) {
+		if (buf[i] != (char)c)
+			UT_FATAL("byte %zu is 0x%x, expected 0x%x", i,
+				(unsigned char)buf[i], (unsigned char)c);
+	}
+}
+
+/*
+ * process_stats -- retrieve process-wide statistics
+ */
+static void
+process_stats(struct pmem2_stats *stats)
+{
+	stats->size = sizeof(*stats);
+	int ret = pmem2_stats_get(stats, PMEM2_STATS_PROCESS);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+}
+
+/*
+ * test_memcpy_parallel -- multi-threaded memcpy of an unaligned range
+ */
+static int
+test_memcpy_parallel(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	size_t len = 3 * MEGABYTE + 77;
+	char *src = MALLOC(len);
+	fill_pattern(src, len, 1);
+
+	pmem2_stats_enable();
+	pmem2_stats_reset(PMEM2_STATS_PROCESS);
+
+	ctx.memcpy_fn(ctx.addr + 123, src, len, 0);
+
+	struct pmem2_stats stats;
+	process_stats(&stats);
+	/* every byte is written exactly once, regardless of the thread */
+	UT_ASSERTeq(stats.memmove_nt_bytes + stats.memmove_t_bytes, len);
+	pmem2_stats_disable();
+
+	UT_ASSERTeq(memcmp(ctx.addr + 123, src, len), 0);
+
+	FREE(src);
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_memset_parallel -- multi-threaded memset of an unaligned range
+ */
+static int
+test_memset_parallel(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	size_t len = ctx.size - 4096 - 1;
+
+	ctx.memset_fn(ctx.addr, 0x11, ctx.size, 0);
+
+	pmem2_stats_enable();
+	pmem2_stats_reset(PMEM2_STATS_PROCESS);
+
+	ctx.memset_fn(ctx.addr + 4096 - 1, 0xab, len, 0);
+
+	struct pmem2_stats stats;
+	process_stats(&stats);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, len);
+	pmem2_stats_disable();
+
+	check_byte(ctx.addr, 0x11, 4096 - 1);
+	check_byte(ctx.addr + 4096 - 1, 0xab, len);
+	check_byte(ctx.addr + ctx.size - 2, 0x11, 2);
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_memmove_overlap -- overlapping memmove falls back to a single thread
+ */
+static int
+test_memmove_overlap(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	size_t len = 2 * MEGABYTE;
+	size_t shift = 4096 + 3;
+	char *expected = MALLOC(len);
+
+	fill_pattern(ctx.addr, len, 2);
+	memcpy(expected, ctx.addr, len);
+	ctx.persist_fn(ctx.addr, len);
+
+	/* forward overlap */
+	ctx.memmove_fn(ctx.addr + shift, ctx.addr, len, 0);
+	UT_ASSERTeq(memcmp(ctx.addr + shift, expected, len), 0);
+
+	/* backward overlap */
+	ctx.memmove_fn(ctx.addr, ctx.addr + shift, len, 0);
+	UT_ASSERTeq(memcmp(ctx.addr, expected, len), 0);
+
+	FREE(expected);
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_parallel_flags -- multi-threaded writes with NODRAIN and NOFLUSH
+ */
+static int
+test_parallel_flags(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	size_t len = MEGABYTE;
+	char *src = MALLOC(len);
+	fill_pattern(src, len, 3);
+
+	ctx.memcpy_fn(ctx.addr, src, len, PMEM2_F_MEM_NODRAIN);
+	ctx.drain_fn();
+	UT_ASSERTeq(memcmp(ctx.addr, src, len), 0);
+
+	ctx.memset_fn(ctx.addr + len, 0x5a, len,
+		PMEM2_F_MEM_NOFLUSH | PMEM2_F_MEM_NONTEMPORAL);
+	ctx.persist_fn(ctx.addr + len, len);
+	check_byte(ctx.addr + len, 0x5a, len);
+
+	ctx.memcpy_fn(ctx.addr + 2 * len, src, len,
+		PMEM2_F_MEM_TEMPORAL | PMEM2_F_MEM_WB);
+	UT_ASSERTeq(memcmp(ctx.addr + 2 * len, src, len), 0);
+
+	FREE(src);
+	test_fini(&ctx);
+
+	return ret;
+}
+
+struct worker_args {
+	struct test_ctx *ctx;
+	char *src;
+	size_t len;
+	unsigned idx;
+};
+
+/*
+ * worker_memcpy -- (internal) copy a large range from a separate thread
+ */
+static void *
+worker_memcpy(void *arg)
+{
+	struct worker_args *args = arg;
+	char *dest = args->ctx->addr + args->idx * args->len;
+
+	for (int i = 0; i < 4; ++i) {
+		args->ctx->memcpy_fn(dest, args->src, args->len, 0);
+		UT_ASSERTeq(memcmp(dest, args->src, args->len), 0);
+	}
+
+	return NULL;
+}
+
+/*
+ * test_parallel_mt -- concurrent large writes from many threads
+ */
+static int
+test_parallel_mt(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	size_t len = ctx.size / WORKERS;
+	char *src = MALLOC(len);
+	fill_pattern(src, len, 4);
+
+	os_thread_t threads[WORKERS];
+	struct worker_args args[WORKERS];
+	for (unsigned i = 0; i < WORKERS; ++i) {
+		args[i].ctx = &ctx;
+		args[i].src = src;
+		args[i].len = len;
+		args[i].idx = i;
+		THREAD_CREATE(&threads[i], NULL, worker_memcpy, &args[i]);
+	}
+
+	for (unsigned i = 0; i < WORKERS; ++i)
+		THREAD_JOIN(&threads[i], NULL);
+
+	FREE(src);
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_map_remap -- large writes to a mapping created in place of a deleted
+ * one, which the library may still remember
+ */
+static int
+test_map_remap(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = 0;
+
+	for (int i = 0; i < 4; ++i) {
+		ret = test_init(tc, argc, argv, &ctx);
+
+		ctx.memset_fn(ctx.addr, 0x20 + i, ctx.size, 0);
+		check_byte(ctx.addr, 0x20 + i, ctx.size);
+
+		test_fini(&ctx);
+	}
+
+	return ret;
+}
+
+struct loop_args {
+	struct test_ctx *ctx;
+	size_t len;
+	int stop;
+};
+
+/*
+ * worker_memset_loop -- (internal) keep the worker pool busy until stopped
+ */
+static void *
+worker_memset_loop(void *arg)
+{
+	struct loop_args *args = arg;
+
+	for (int i = 0; !__atomic_load_n(&args->stop, __ATOMIC_ACQUIRE); ++i)
+		args->ctx->memset_fn(args->ctx->addr, i, args->len, 0);
+
+	return NULL;
+}
+
+/*
+ * test_parallel_fork -- large writes in children forked while the worker
+ * pool of the parent is in use
+ */
+static int
+test_parallel_fork(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	size_t half = ctx.size / 2;
+	char *second = ctx.addr + half;
+
+	struct loop_args args = {&ctx, half, 0};
+	os_thread_t thread;
+	THREAD_CREATE(&thread, NULL, worker_memset_loop, &args);
+
+	for (int i = 0; i < FORKS; ++i) {
+		pid_t pid = fork();
+		if (pid < 0)
+			UT_FATAL("!fork");
+
+		if (pid == 0) {
+			/* none of the workers of the parent exists here */
+			ctx.memset_fn(second, 0x40 + i, half, 0);
+			check_byte(second, 0x40 + i, half);
+
+			/* the destructor of the library stops the workers */
+			exit(0);
+		}
+
+		int status;
+		if (waitpid(pid, &status, 0) != pid)
+			UT_FATAL("!waitpid");
+		UT_ASSERT(WIFEXITED(status));
+		UT_ASSERTeq(WEXITSTATUS(status), 0);
+
+		/* the mapping is shared with the child */
+		check_byte(second, 0x40 + i, half);
+	}
+
+	__atomic_store_n(&args.stop, 1, __ATOMIC_RELEASE);
+	THREAD_JOIN(&thread, NULL);
+
+	/* the pool of the parent still works */
+	ctx.memset_fn(ctx.addr, 0x5e, ctx.size, 0);
+	check_byte(ctx.addr, 0x5e, ctx.size);
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_cases -- available test cases
+ */
+static struct test_case test_cases[] = {
+	TEST_CASE(test_memcpy_parallel),
+	TEST_CASE(test_memset_parallel),
+	TEST_CASE(test_memmove_overlap),
+	TEST_CASE(test_parallel_flags),
+	TEST_CASE(test_parallel_mt),
+	TEST_CASE(test_map_remap),
+	TEST_CASE(test_parallel_fork),
+};
+
+#define NTESTS (sizeof(test_cases) / sizeof(test_cases[0]))
+
+int
+main(int argc, char *argv[])
+{
+	START(argc, argv, "pmem2_mem_parallel");
+	TEST_CASE_PROCESS(argc, argv, test_cases, NTESTS);
+	DONE(NULL);
+}
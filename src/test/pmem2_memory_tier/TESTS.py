@@ -0,0 +1,115 @@
+#!../env.py
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2026, Intel Corporation
+#
+
+
+import os
+
+import testframework as t
+from testframework import granularity as g
+
+
+# values of enum pmem2_memory_type
+UNKNOWN = 0
+DRAM = 1
+PMEM = 2
+CXL = 3
+
+# values of enum pmem2_persistence_domain
+DOMAIN_UNKNOWN = 0
+DOMAIN_NONE = 1
+DOMAIN_MEMORY_CONTROLLER = 2
+DOMAIN_CPU_CACHE = 3
+
+
+class PMEM2_MEMORY_TIER_BASE(t.Test):
+    test_type = t.Short
+
+    def setup(self, ctx):
+        super().setup(ctx)
+        ctx.env['SYSFS_PATH'] = os.path.join(self.cwd, 'linux_sysfs', 'sys')
+
+
+@g.require_granularity(g.ANY)
+class PMEM2_MEMORY_TIER(PMEM2_MEMORY_TIER_BASE):
+    devdax = 0
+    device = None
+    expected = None
+
+    def run(self, ctx):
+        filepath = ctx.create_holey_file(1 * t.MiB, 'testfile')
+        ctx.exec('pmem2_memory_tier', 'test_memory_tier', filepath,
+                 self.devdax, *self.device, *self.expected)
+
+
+class TEST0(PMEM2_MEMORY_TIER):
+    """CXL memory exposed as device dax"""
+    devdax = 1
+    device = (250, 0)
+    expected = (CXL, DOMAIN_NONE, 2, 22, 30000, 250)
+
+
+class TEST1(PMEM2_MEMORY_TIER):
+    """file system on CXL persistent memory"""
+    device = (259, 2)
+    expected = (CXL, DOMAIN_CPU_CACHE, 4, 22, 20000, 400)
+
+
+class TEST2(PMEM2_MEMORY_TIER):
+    """file system on a partition of an nvdimm namespace"""
+    device = (259, 1)
+    expected = (PMEM, DOMAIN_MEMORY_CONTROLLER, 3, 25, 10000, 300)
+
+
+class TEST3(PMEM2_MEMORY_TIER):
+    """device dax on a node with cpus"""
+    devdax = 1
+    device = (250, 1)
+    expected = (DRAM, DOMAIN_NONE, 0, 4, 100000, 80)
+
+
+class TEST4(PMEM2_MEMORY_TIER):
+    """device without sysfs entry"""
+    device = (8, 0)
+    expected = (UNKNOWN, DOMAIN_UNKNOWN, -1, -1, 0, 0)
+
+
+@g.require_granularity(g.ANY)
+class TEST5(PMEM2_MEMORY_TIER_BASE):
+    """anonymous source"""
+
+    def run(self, ctx):
+        ctx.exec('pmem2_memory_tier', 'test_memory_tier_anon')
+
+
+@t.require_architectures('x86_64')
+@g.require_granularity(g.CACHELINE)
+class PMEM2_FAR_MEMORY(PMEM2_MEMORY_TIER_BASE):
+    device = None
+    expected = ()
+
+    def run(self, ctx):
+        filepath = ctx.create_holey_file(1 * t.MiB, 'testfile')
+        ctx.exec('pmem2_memory_tier', 'test_far_memory', filepath,
+                 *self.device, *self.expected)
+
+
+class TEST6(PMEM2_FAR_MEMORY):
+    """CXL memory is written with non-temporal stores"""
+    device = (259, 2)
+
+
+class TEST7(PMEM2_FAR_MEMORY):
+    """other memory keeps the default stores"""
+    device = (8, 0)
+
+
+class TEST8(PMEM2_FAR_MEMORY):
+    """PMEM_MOVNT_THRESHOLD applies to CXL memory too"""
+    device = (259, 2)
+    expected = (0,)
+
+    def run(self, ctx):
+        ctx.env['PMEM_MOVNT_THRESHOLD'] = '512'
+        super().run(ctx)
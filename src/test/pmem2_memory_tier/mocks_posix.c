@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * mocks_posix.c -- mocked functions used in mem_tier_linux.c
+ */
+#include <dirent.h>
+#include "unittest.h"
+
+#define SYSFS_PATH "/sys/"
+
+/*
+ * sysfs_path -- redirect a sysfs path to the directory given
+ * by SYSFS_PATH environment variable
+ */
+static const char *
+sysfs_path(const char *path, char *buf)
+{
+	const char *prefix = os_getenv("SYSFS_PATH");
+	if (prefix == NULL || strncmp(path, SYSFS_PATH,
+			strlen(SYSFS_PATH)) != 0)
+		return path;
+
+	SNPRINTF(buf, PATH_MAX, "%s/%s", prefix, path + strlen(SYSFS_PATH));
+	return buf;
+}
+
+/*
+ * open -- open mock
+ */
+FUNC_MOCK(open, int, const char *path, int flags, ...)
+FUNC_MOCK_RUN_DEFAULT {
+	va_list ap;
+	va_start(ap, flags);
+	int mode = va_arg(ap, int);
+	va_end(ap);
+
+	char buf[PATH_MAX];
+	return _FUNC_REAL(open)(sysfs_path(path, buf), flags, mode);
+}
+FUNC_MOCK_END
+
+/*
+ * realpath -- realpath mock
+ */
+FUNC_MOCK(realpath, char *, const char *path, char *resolved_path)
+FUNC_MOCK_RUN_DEFAULT {
+	char buf[PATH_MAX];
+	return _FUNC_REAL(realpath)(sysfs_path(path, buf), resolved_path);
+}
+FUNC_MOCK_END
+
+/*
+ * opendir -- opendir mock
+ */
+FUNC_MOCK(opendir, DIR *, const char *path)
+FUNC_MOCK_RUN_DEFAULT {
+	char buf[PATH_MAX];
+	return _FUNC_REAL(opendir)(sysfs_path(path, buf));
+}
+FUNC_MOCK_END
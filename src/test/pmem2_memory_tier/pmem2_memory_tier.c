@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * pmem2_memory_tier.c -- pmem2_source_memory_tier unittests
+ *
+ * The sysfs hierarchy is emulated by the tree in linux_sysfs directory,
+ * see mocks_posix.c.
+ */
+
+#include <sys/sysmacros.h>
+
+#include "source.h"
+#include "unittest.h"
+#include "ut_pmem2_utils.h"
+
+/*
+ * source_new -- create a source which pretends to be backed by
+ * the given device
+ */
+static struct pmem2_source *
+source_new(int fd, int devdax, unsigned major, unsigned minor)
+{
+	struct pmem2_source *src;
+	int ret = pmem2_source_from_fd(&src, fd);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	if (devdax) {
+		src->value.ftype = PMEM2_FTYPE_DEVDAX;
+		src->value.st_rdev = makedev(major, minor);
+	} else {
+		src->value.st_dev = makedev(major, minor);
+	}
+
+	return src;
+}
+
+/*
+ * test_memory_tier -- check the memory tier of a source backed by
+ * an emulated device
+ */
+static int
+test_memory_tier(const struct test_case *tc, int argc, char *argv[])
+{
+	if (argc < 10)
+		UT_FATAL("usage: %s <file> <devdax> <major> <minor> <type> "
+			"<domain> <node> <tier> <read_bandwidth> "
+			"<read_latency>", tc->name);
+
+	int fd = OPEN(argv[0], O_RDWR);
+	struct pmem2_source *src = source_new(fd, atoi(argv[1]),
+		ATOU(argv[2]), ATOU(argv[3]));
+
+	struct pmem2_memory_tier tier;
+	int ret = pmem2_source_memory_tier(src, &tier);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	UT_ASSERTeq(tier.type, (enum pmem2_memory_type)atoi(argv[4]));
+	UT_ASSERTeq(tier.persistence_domain,
+		(enum pmem2_persistence_domain)atoi(argv[5]));
+	UT_ASSERTeq(tier.numa_node, atoi(argv[6]));
+	UT_ASSERTeq(tier.tier, atoi(argv[7]));
+	UT_ASSERTeq(tier.read_bandwidth, ATOULL(argv[8]));
+	UT_ASSERTeq(tier.read_latency, ATOULL(argv[9]));
+
+	pmem2_source_delete(&src);
+	CLOSE(fd);
+
+	return 10;
+}
+
+/*
+ * test_memory_tier_anon -- anonymous sources are not supported
+ */
+static int
+test_memory_tier_anon(const struct test_case *tc, int argc, char *argv[])
+{
+	struct pmem2_source *src;
+	int ret = pmem2_source_from_anon(&src, 4096);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	struct pmem2_memory_tier tier;
+	ret = pmem2_source_memory_tier(src, &tier);
+	UT_PMEM2_EXPECT_RETURN(ret, PMEM2_E_SOURCE_TYPE_NOT_SUPPORTED);
+
+	pmem2_source_delete(&src);
+
+	return 0;
+}
+
+/*
+ * copy_stats -- perform a memcpy and memset of the given length and check
+ * how many bytes were written using non-temporal stores
+ */
+static void
+copy_stats(struct pmem2_map *map, size_t len, unsigned flags,
+		uint64_t nt_bytes)
+{
+	pmem2_memcpy_fn memcpy_fn = pmem2_get_memcpy_fn(map);
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(map);
+	char *addr = pmem2_map_get_address(map);
+	char buf[1024];
+
+	UT_ASSERT(len <= sizeof(buf));
+	memset(buf, 0xc5, len);
+
+	pmem2_stats_reset(PMEM2_STATS_THREAD);
+	memcpy_fn(addr, buf, len, flags);
+	memset_fn(addr + len, 0x5c, len, flags);
+
+	struct pmem2_stats stats;
+	stats.size = sizeof(stats);
+	int ret = pmem2_stats_get(&stats, PMEM2_STATS_THREAD);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	UT_ASSERTeq(stats.memmove_nt_bytes, nt_bytes);
+	UT_ASSERTeq(stats.memset_nt_bytes, nt_bytes);
+	UT_ASSERTeq(memcmp(addr, buf, len), 0);
+}
+
+/*
+ * test_far_memory -- memory attached through CXL is written with
+ * non-temporal stores unless the caller asks otherwise
+ */
+static int
+test_far_memory(const struct test_case *tc, int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s <file> <major> <minor> [default_nt]",
+			tc->name);
+
+	int fd = OPEN(argv[0], O_RDWR);
+	struct pmem2_source *src = source_new(fd, 0, ATOU(argv[1]),
+		ATOU(argv[2]));
+
+	struct pmem2_memory_tier tier;
+	int ret = pmem2_source_memory_tier(src, &tier);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	int far = tier.type == PMEM2_MEMORY_TYPE_CXL;
+
+	/* non-temporal bytes of a 128-byte copy without flags */
+	size_t default_nt = far ? 128 : 0;
+	if (argc > 3)
+		default_nt = ATOU(argv[3]);
+
+	struct pmem2_config *cfg;
+	ret = pmem2_config_new(&cfg);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	ret = pmem2_config_set_required_store_granularity(cfg,
+		PMEM2_GRANULARITY_PAGE);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	struct pmem2_map *map;
+	ret = pmem2_map_new(&map, cfg, src);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTne(pmem2_map_get_store_granularity(map),
+		PMEM2_GRANULARITY_PAGE);
+
+	pmem2_stats_enable();
+
+	copy_stats(map, 128, 0, default_nt);
+	copy_stats(map, 128, PMEM2_F_MEM_TEMPORAL, 0);
+	copy_stats(map, 128, PMEM2_F_MEM_NONTEMPORAL, 128);
+	copy_stats(map, 32, 0, 0);
+
+	pmem2_stats_disable();
+
+	pmem2_map_delete(&map);
+	pmem2_config_delete(&cfg);
+	pmem2_source_delete(&src);
+	CLOSE(fd);
+
+	return argc > 3 ? 4 : 3;
+}
+
+/*
+ * test_cases -- available test cases
+ */
+static struct test_case test_cases[] = {
+	TEST_CASE(test_memory_tier),
+	TEST_CASE(test_memory_tier_anon),
+	TEST_CASE(test_far_memory),
+};
+
+#define NTESTS (sizeof(test_cases) / sizeof(test_cases[0]))
+
+int
+main(int argc, char *argv[])
+{
+	START(argc, argv, "pmem2_memory_tier");
+	TEST_CASE_PROCESS(argc, argv, test_cases, NTESTS);
+	DONE(NULL);
+}
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2019-2020, Intel Corporation */
+/* Copyright 2019-2026, Intel Corporation */
 
 /*
  * pmem2_persist.c -- pmem2_get_[flush|drain|persist]_fn unittests
@@ -60,6 +60,15 @@ pmem2_map_find(const void *addr, size_t len)
 	return &cur;
 }
 
+/*
+ * pmem2_map_generation -- redefine libpmem2 function
+ */
+uint64_t
+pmem2_map_generation(void)
+{
+	return 0;
+}
+
 /*
  * pmem2_flush_file_buffers_os -- redefine libpmem2 function
  */
@@ -83,6 +92,8 @@ prepare_map(struct pmem2_map *map)
 	const size_t length = 20 * MEGABYTE + 5 * KILOBYTE;
 	map->content_length = length;
 	map->addr = MALLOC(length);
+	map->flush_filter = PMEM2_FLUSH_FILTER_DISABLED;
+	map->memory_type = PMEM2_MEMORY_TYPE_UNKNOWN;
 }
 
 /*
@@ -0,0 +1,45 @@
+#!../env.py
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2026, Intel Corporation
+#
+
+
+import testframework as t
+from testframework import granularity as g
+
+
+@g.require_granularity(g.ANY)
+class PMEM2_PREFAULT(t.Test):
+    test_type = t.Short
+    file_size = 16 * t.MiB
+    prefault = None
+    threads = 1
+
+    def run(self, ctx):
+        filepath = ctx.create_holey_file(self.file_size, 'testfile')
+        ctx.exec('pmem2_prefault', 'test_prefault', filepath,
+                 self.prefault, self.threads)
+
+
+class TEST0(PMEM2_PREFAULT):
+    """populate the mapping for reading"""
+    prefault = 'read'
+
+
+class TEST1(PMEM2_PREFAULT):
+    """populate the mapping for writing"""
+    prefault = 'write'
+
+
+class TEST2(PMEM2_PREFAULT):
+    """populate a large mapping for writing using many threads"""
+    file_size = 256 * t.MiB
+    prefault = 'write'
+    threads = 4
+
+
+class TEST3(PMEM2_PREFAULT):
+    """populate a large mapping for reading using many threads"""
+    file_size = 256 * t.MiB
+    prefault = 'read'
+    threads = 4
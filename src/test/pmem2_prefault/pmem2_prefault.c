@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * pmem2_prefault.c -- pmem2_config_set_prefault unittests
+ */
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "unittest.h"
+#include "ut_pmem2_utils.h"
+
+typedef unsigned char vec_t;
+
+/*
+ * count_resident_pages -- count pages of the range which are in memory
+ */
+static size_t
+count_resident_pages(void *addr, size_t length)
+{
+	size_t arr_len = (length + Ut_pagesize - 1) / Ut_pagesize;
+	vec_t *vec = MALLOC(sizeof(*vec) * arr_len);
+
+	int ret = mincore(addr, length, vec);
+	UT_ASSERTeq(ret, 0);
+
+	size_t resident_pages = 0;
+	for (size_t i = 0; i < arr_len; ++i)
+		resident_pages += vec[i] & 0x1;
+
+	FREE(vec);
+
+	return resident_pages;
+}
+
+/*
+ * minor_faults -- number of minor page faults taken by the process
+ */
+static long
+minor_faults(void)
+{
+	struct rusage usage;
+	int ret = getrusage(RUSAGE_SELF, &usage);
+	UT_ASSERTeq(ret, 0);
+
+	return usage.ru_minflt;
+}
+
+/*
+ * parse_prefault -- convert the name of the prefault mode
+ */
+static enum pmem2_prefault
+parse_prefault(const char *name)
+{
+	if (strcmp(name, "none") == 0)
+		return PMEM2_PREFAULT_NONE;
+	if (strcmp(name, "read") == 0)
+		return PMEM2_PREFAULT_READ;
+	if (strcmp(name, "write") == 0)
+		return PMEM2_PREFAULT_WRITE;
+
+	UT_FATAL("unknown prefault mode: %s", name);
+}
+
+/*
+ * test_prefault -- map the file with the given prefault mode and check
+ * that every page is accessed without taking a page fault
+ */
+static int
+test_prefault(const struct test_case *tc, int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s <file> <none|read|write> <threads>",
+			tc->name);
+
+	char *file = argv[0];
+	enum pmem2_prefault prefault = parse_prefault(argv[1]);
+	unsigned threads = ATOU(argv[2]);
+
+	int fd = OPEN(file, O_RDWR);
+
+	struct pmem2_source *src;
+	int ret = pmem2_source_from_fd(&src, fd);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	struct pmem2_config *cfg;
+	ret = pmem2_config_new(&cfg);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_config_set_required_store_granularity(cfg,
+		PMEM2_GRANULARITY_PAGE);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_config_set_prefault(cfg, prefault);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_config_set_mem_threads(cfg, threads);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	struct pmem2_map *map;
+	ret = pmem2_map_new(&map, cfg, src);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	volatile char *addr = pmem2_map_get_address(map);
+	size_t size = pmem2_map_get_size(map);
+	size_t npages = size / Ut_pagesize;
+
+	UT_ASSERTeq(count_resident_pages((void *)addr, size), npages);
+
+	/* accessing the populated pages should not fault */
+	long faults = minor_faults();
+	for (size_t off = 0; off < size; off += Ut_pagesize) {
+		if (prefault == PMEM2_PREFAULT_WRITE)
+			addr[off] = 1;
+		else
+			(void) addr[off];
+	}
+	faults = minor_faults() - faults;
+
+	UT_ASSERT((size_t)faults < npages / 4);
+
+	pmem2_map_delete(&map);
+	pmem2_config_delete(&cfg);
+	pmem2_source_delete(&src);
+	CLOSE(fd);
+
+	return 3;
+}
+
+/*
+ * test_cases -- available test cases
+ */
+static struct test_case test_cases[] = {
+	TEST_CASE(test_prefault),
+};
+
+#define NTESTS (sizeof(test_cases) / sizeof(test_cases[0]))
+
+int
+main(int argc, char *argv[])
+{
+	START(argc, argv, "pmem2_prefault");
+	TEST_CASE_PROCESS(argc, argv, test_cases, NTESTS);
+	DONE(NULL);
+}
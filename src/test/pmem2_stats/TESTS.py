@@ -0,0 +1,69 @@
+#!../env.py
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2026, Intel Corporation
+#
+
+
+import testframework as t
+from testframework import granularity as g
+
+
+class PMEM2_STATS(t.Test):
+    test_type = t.Short
+    test_case = None
+
+    def run(self, ctx):
+        filepath = ctx.create_holey_file(1 * t.MiB, 'testfile')
+        ctx.exec('pmem2_stats', self.test_case, filepath)
+
+
+@g.require_granularity(g.ANY)
+class TEST0(PMEM2_STATS):
+    """memcpy/memset byte counters"""
+    test_case = "test_stats_mem"
+
+
+@g.require_granularity(g.CACHELINE)
+class TEST1(PMEM2_STATS):
+    """flushed cache lines and fences"""
+    test_case = "test_stats_flush"
+
+
+@g.require_granularity(g.PAGE)
+class TEST2(PMEM2_STATS):
+    """msync calls and latency histogram"""
+    test_case = "test_stats_msync"
+
+
+@g.require_granularity(g.ANY)
+class TEST3(PMEM2_STATS):
+    """thread and process scope, counters of exited threads"""
+    test_case = "test_stats_threads"
+
+
+@g.require_granularity(g.ANY)
+class TEST4(PMEM2_STATS):
+    """statistics are not collected while disabled"""
+    test_case = "test_stats_disabled"
+
+
+@g.require_granularity(g.ANY)
+class TEST5(PMEM2_STATS):
+    """PMEM2_STATS environment variable enables statistics"""
+    test_case = "test_stats_env"
+
+    def run(self, ctx):
+        ctx.env['PMEM2_STATS'] = '1'
+        super().run(ctx)
+
+
+@g.require_granularity(g.ANY)
+class TEST6(PMEM2_STATS):
+    """process scope reset during concurrent updates"""
+    test_case = "test_stats_reset_concurrent"
+
+
+@g.require_granularity(g.ANY)
+class TEST7(PMEM2_STATS):
+    """size of the statistics structure set by the caller"""
+    test_case = "test_stats_size"
@@ -0,0 +1,468 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * pmem2_stats.c -- pmem2_stats_* unittests
+ */
+
+#include "unittest.h"
+#include "ut_pmem2_utils.h"
+
+/*
+ * test_ctx -- essential parameters used by test
+ */
+struct test_ctx {
+	int fd;
+	struct pmem2_map *map;
+};
+
+/*
+ * test_init -- prepare resources required for testing
+ */
+static int
+test_init(const struct test_case *tc, int argc, char *argv[],
+		struct test_ctx *ctx)
+{
+	if (argc < 1)
+		UT_FATAL("usage: %s <file>", tc->name);
+
+	char *file = argv[0];
+	ctx->fd = OPEN(file, O_RDWR);
+
+	struct pmem2_source *src;
+	int ret = pmem2_source_from_fd(&src, ctx->fd);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	struct pmem2_config *cfg;
+	ret = pmem2_config_new(&cfg);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_config_set_required_store_granularity(
+		cfg, PMEM2_GRANULARITY_PAGE);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+
+	ret = pmem2_map_new(&ctx->map, cfg, src);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+	UT_ASSERTne(ctx->map, NULL);
+
+	pmem2_config_delete(&cfg);
+	pmem2_source_delete(&src);
+
+	/* the function returns the number of consumed arguments */
+	return 1;
+}
+
+/*
+ * test_fini -- cleanup the test resources
+ */
+static void
+test_fini(struct test_ctx *ctx)
+{
+	pmem2_map_delete(&ctx->map);
+	CLOSE(ctx->fd);
+}
+
+/*
+ * stats_get -- retrieve statistics in a given scope
+ */
+static void
+stats_get(struct pmem2_stats *stats, enum pmem2_stats_scope scope)
+{
+	stats->size = sizeof(*stats);
+	int ret = pmem2_stats_get(stats, scope);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+}
+
+/*
+ * stats_reset -- zero statistics in a given scope
+ */
+static void
+stats_reset(enum pmem2_stats_scope scope)
+{
+	int ret = pmem2_stats_reset(scope);
+	UT_PMEM2_EXPECT_RETURN(ret, 0);
+}
+
+/*
+ * test_stats_mem -- count bytes written by memcpy/memset
+ */
+static int
+test_stats_mem(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	char *addr = pmem2_map_get_address(ctx.map);
+	pmem2_memcpy_fn memcpy_fn = pmem2_get_memcpy_fn(ctx.map);
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(ctx.map);
+
+	char src[4096];
+	memset(src, 0xab, sizeof(src));
+
+	pmem2_stats_enable();
+	stats_reset(PMEM2_STATS_THREAD);
+
+	memcpy_fn(addr, src, 4096, PMEM2_F_MEM_NONTEMPORAL);
+	memcpy_fn(addr + 8192, src, 64, PMEM2_F_MEM_TEMPORAL);
+	memset_fn(addr, 0, 4096, PMEM2_F_MEM_NONTEMPORAL);
+	memset_fn(addr + 8192, 0, 100, PMEM2_F_MEM_TEMPORAL);
+
+	struct pmem2_stats stats;
+	stats_get(&stats, PMEM2_STATS_THREAD);
+
+	UT_ASSERTeq(stats.memmove_nt_bytes + stats.memmove_t_bytes, 4096 + 64);
+	UT_ASSERT(stats.memmove_t_bytes >= 64);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, 4096 + 100);
+	UT_ASSERT(stats.memset_t_bytes >= 100);
+
+	stats_reset(PMEM2_STATS_THREAD);
+	stats_get(&stats, PMEM2_STATS_THREAD);
+	UT_ASSERTeq(stats.memmove_nt_bytes + stats.memmove_t_bytes, 0);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, 0);
+
+	pmem2_stats_disable();
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_stats_flush -- count flushed cache lines and fences
+ */
+static int
+test_stats_flush(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	UT_ASSERTeq(pmem2_map_get_store_granularity(ctx.map),
+		PMEM2_GRANULARITY_CACHE_LINE);
+
+	char *addr = pmem2_map_get_address(ctx.map);
+	pmem2_flush_fn flush_fn = pmem2_get_flush_fn(ctx.map);
+	pmem2_drain_fn drain_fn = pmem2_get_drain_fn(ctx.map);
+	pmem2_persist_fn persist_fn = pmem2_get_persist_fn(ctx.map);
+
+	pmem2_stats_enable();
+	stats_reset(PMEM2_STATS_THREAD);
+
+	/* two full cache lines */
+	flush_fn(addr, 128);
+	/* 8 bytes crossing a cache line boundary */
+	flush_fn(addr + 60, 8);
+	drain_fn();
+	/* one cache line, followed by a fence */
+	persist_fn(addr + 4096, 1);
+
+	struct pmem2_stats stats;
+	stats_get(&stats, PMEM2_STATS_THREAD);
+
+	UT_ASSERTeq(stats.flushed_lines, 5);
+	UT_ASSERTeq(stats.fences, 2);
+	UT_ASSERTeq(stats.msync_calls, 0);
+
+	/* non-temporal stores write the whole cache lines to memory */
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(ctx.map);
+	stats_reset(PMEM2_STATS_THREAD);
+	memset_fn(addr, 0, 4096, PMEM2_F_MEM_NONTEMPORAL);
+
+	stats_get(&stats, PMEM2_STATS_THREAD);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, 4096);
+	UT_ASSERTeq(stats.flushed_lines, 4096 / 64);
+
+	pmem2_stats_disable();
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_stats_msync -- count msync calls and their latency
+ */
+static int
+test_stats_msync(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	UT_ASSERTeq(pmem2_map_get_store_granularity(ctx.map),
+		PMEM2_GRANULARITY_PAGE);
+
+	char *addr = pmem2_map_get_address(ctx.map);
+	pmem2_persist_fn persist_fn = pmem2_get_persist_fn(ctx.map);
+
+	pmem2_stats_enable();
+	stats_reset(PMEM2_STATS_THREAD);
+
+	addr[0] = 1;
+	persist_fn(addr, 1);
+	addr[8192] = 1;
+	persist_fn(addr + 8192, 1);
+
+	struct pmem2_stats stats;
+	stats_get(&stats, PMEM2_STATS_THREAD);
+
+	UT_ASSERTeq(stats.msync_calls, 2);
+
+	uint64_t hist_total = 0;
+	for (unsigned i = 0; i < PMEM2_STATS_MSYNC_HIST_BUCKETS; ++i)
+		hist_total += stats.msync_hist[i];
+	UT_ASSERTeq(hist_total, 2);
+
+	pmem2_stats_disable();
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * worker_memset -- (internal) write to pmem from a separate thread
+ */
+static void *
+worker_memset(void *arg)
+{
+	struct pmem2_map *map = arg;
+	char *addr = pmem2_map_get_address(map);
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(map);
+
+	memset_fn(addr + 4096, 0xcd, 1000, 0);
+
+	struct pmem2_stats stats;
+	stats_get(&stats, PMEM2_STATS_THREAD);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, 1000);
+
+	return NULL;
+}
+
+/*
+ * test_stats_threads -- thread and process scope statistics
+ */
+static int
+test_stats_threads(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	char *addr = pmem2_map_get_address(ctx.map);
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(ctx.map);
+
+	pmem2_stats_enable();
+	stats_reset(PMEM2_STATS_PROCESS);
+
+	memset_fn(addr, 0xcd, 500, 0);
+
+	os_thread_t thread;
+	THREAD_CREATE(&thread, NULL, worker_memset, ctx.map);
+	THREAD_JOIN(&thread, NULL);
+
+	struct pmem2_stats stats;
+	stats_get(&stats, PMEM2_STATS_THREAD);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, 500);
+
+	/* counters of the exited thread are still included */
+	stats_get(&stats, PMEM2_STATS_PROCESS);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, 1500);
+
+	stats_reset(PMEM2_STATS_PROCESS);
+	stats_get(&stats, PMEM2_STATS_PROCESS);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, 0);
+
+	pmem2_stats_disable();
+	test_fini(&ctx);
+
+	return ret;
+}
+
+#define RESET_ITERS 1000000
+
+/*
+ * worker_memset_loop -- (internal) write to pmem many times without flushing
+ */
+static void *
+worker_memset_loop(void *arg)
+{
+	struct pmem2_map *map = arg;
+	char *addr = pmem2_map_get_address(map);
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(map);
+
+	for (unsigned i = 0; i < RESET_ITERS; ++i)
+		memset_fn(addr + 8192, (int)i, 1, PMEM2_F_MEM_NOFLUSH);
+
+	return NULL;
+}
+
+/*
+ * test_stats_reset_concurrent -- a reset of the process statistics is not
+ * lost when another thread updates its counters at the same time
+ */
+static int
+test_stats_reset_concurrent(const struct test_case *tc, int argc,
+		char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	pmem2_stats_enable();
+	stats_reset(PMEM2_STATS_PROCESS);
+
+	os_thread_t thread;
+	THREAD_CREATE(&thread, NULL, worker_memset_loop, ctx.map);
+
+	/* reset while the worker is in the middle of its writes */
+	struct pmem2_stats stats;
+	do {
+		stats_get(&stats, PMEM2_STATS_PROCESS);
+	} while (stats.memset_t_bytes < RESET_ITERS / 2);
+	stats_reset(PMEM2_STATS_PROCESS);
+
+	THREAD_JOIN(&thread, NULL);
+
+	stats_get(&stats, PMEM2_STATS_PROCESS);
+	UT_ASSERT(stats.memset_t_bytes <= RESET_ITERS / 2);
+
+	pmem2_stats_disable();
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_stats_disabled -- nothing is counted while statistics are disabled
+ */
+static int
+test_stats_disabled(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int consumed = test_init(tc, argc, argv, &ctx);
+
+	char *addr = pmem2_map_get_address(ctx.map);
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(ctx.map);
+	pmem2_persist_fn persist_fn = pmem2_get_persist_fn(ctx.map);
+
+	pmem2_stats_enable();
+	stats_reset(PMEM2_STATS_PROCESS);
+	pmem2_stats_disable();
+
+	memset_fn(addr, 0, 4096, 0);
+	persist_fn(addr, 4096);
+
+	struct pmem2_stats stats;
+	stats_get(&stats, PMEM2_STATS_PROCESS);
+
+	struct pmem2_stats zero;
+	memset(&zero, 0, sizeof(zero));
+	zero.size = sizeof(zero);
+	UT_ASSERTeq(memcmp(&stats, &zero, sizeof(stats)), 0);
+
+	int ret = pmem2_stats_get(&stats, (enum pmem2_stats_scope)-1);
+	UT_PMEM2_EXPECT_RETURN(ret, PMEM2_E_INVALID_STATS_SCOPE);
+
+	ret = pmem2_stats_reset((enum pmem2_stats_scope)-1);
+	UT_PMEM2_EXPECT_RETURN(ret, PMEM2_E_INVALID_STATS_SCOPE);
+
+	test_fini(&ctx);
+
+	return consumed;
+}
+
+/*
+ * test_stats_env -- statistics enabled by the PMEM2_STATS variable
+ */
+static int
+test_stats_env(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	char *addr = pmem2_map_get_address(ctx.map);
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(ctx.map);
+
+	memset_fn(addr, 0, 4096, 0);
+
+	struct pmem2_stats stats;
+	stats_get(&stats, PMEM2_STATS_PROCESS);
+	UT_ASSERTeq(stats.memset_nt_bytes + stats.memset_t_bytes, 4096);
+
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * stats_ext -- statistics structure of a newer version of the library
+ */
+struct stats_ext {
+	struct pmem2_stats stats;
+	uint64_t unknown[4];
+};
+
+/*
+ * test_stats_size -- the size of the structure set by the caller is obeyed
+ */
+static int
+test_stats_size(const struct test_case *tc, int argc, char *argv[])
+{
+	struct test_ctx ctx = {0};
+	int ret = test_init(tc, argc, argv, &ctx);
+
+	char *addr = pmem2_map_get_address(ctx.map);
+	pmem2_memset_fn memset_fn = pmem2_get_memset_fn(ctx.map);
+
+	pmem2_stats_enable();
+	stats_reset(PMEM2_STATS_THREAD);
+
+	memset_fn(addr, 0, 4096, 0);
+
+	/* the fields unknown to the library are zeroed */
+	struct stats_ext ext;
+	memset(&ext, 0xff, sizeof(ext));
+	ext.stats.size = sizeof(ext);
+	int r = pmem2_stats_get(&ext.stats, PMEM2_STATS_THREAD);
+	UT_PMEM2_EXPECT_RETURN(r, 0);
+	UT_ASSERTeq(ext.stats.size, sizeof(ext));
+	UT_ASSERTeq(ext.stats.memset_nt_bytes + ext.stats.memset_t_bytes,
+		4096);
+	for (unsigned i = 0; i < ARRAY_SIZE(ext.unknown); ++i)
+		UT_ASSERTeq(ext.unknown[i], 0);
+
+	/* smaller than the first version of the structure */
+	struct pmem2_stats stats;
+	memset(&stats, 0xff, sizeof(stats));
+	stats.size = offsetof(struct pmem2_stats, msync_hist);
+	r = pmem2_stats_get(&stats, PMEM2_STATS_THREAD);
+	UT_PMEM2_EXPECT_RETURN(r, PMEM2_E_INVALID_STATS_SIZE);
+	UT_ASSERTeq(stats.memset_t_bytes, UINT64_MAX);
+
+	stats.size = 0;
+	r = pmem2_stats_get(&stats, PMEM2_STATS_THREAD);
+	UT_PMEM2_EXPECT_RETURN(r, PMEM2_E_INVALID_STATS_SIZE);
+
+	pmem2_stats_disable();
+	test_fini(&ctx);
+
+	return ret;
+}
+
+/*
+ * test_cases -- available test cases
+ */
+static struct test_case test_cases[] = {
+	TEST_CASE(test_stats_mem),
+	TEST_CASE(test_stats_flush),
+	TEST_CASE(test_stats_msync),
+	TEST_CASE(test_stats_threads),
+	TEST_CASE(test_stats_disabled),
+	TEST_CASE(test_stats_env),
+	TEST_CASE(test_stats_reset_concurrent),
+	TEST_CASE(test_stats_size),
+};
+
+#define NTESTS (sizeof(test_cases) / sizeof(test_cases[0]))
+
+int
+main(int argc, char *argv[])
+{
+	START(argc, argv, "pmem2_stats");
+	TEST_CASE_PROCESS(argc, argv, test_cases, NTESTS);
+	DONE(NULL);
+}
@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2026, Intel Corporation
+#
+#
+# pmreorder_parallel/common.sh -- functions for pmreorder_parallel unittest
+#
+
+# the address the file is registered at in the store logs
+BASE=0x10000000
+
+#
+# create_store_log -- write the store log of the three_field struct writes
+#	and create the zeroed file to be checked
+#	usage: create_store_log g|b
+#	g - the fields are persisted before the flag is written
+#	b - all the fields and the flag are persisted at once
+#
+function create_store_log() {
+	local fields="STORE;0x10000000;0x1;0x4|STORE;0x10000004;0x1;0x4"
+	fields="$fields|STORE;0x10000008;0x1;0x4"
+	local flag="STORE;0x1000000c;0x1;0x4"
+	local barrier="FLUSH;0x10000000;0x40|FENCE"
+	local ops
+
+	case "$1" in
+	g)
+		ops="$fields|$barrier|$flag|$barrier"
+		;;
+	b)
+		ops="$flag|$fields|$barrier"
+		;;
+	esac
+
+	rm -f $DIR/testfile
+	truncate -s 4K $DIR/testfile
+
+	echo -n "START|REGISTER_FILE;$DIR/testfile;$BASE;0x1000;0x0|$ops|STOP|" \
+		> store_log$UNITTEST_NUM.log
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * pmreorder_parallel.c -- consistency checker for the binary trace and
+ *	the parallel replay tests of pmreorder
+ *
+ * usage: pmreorder_parallel file
+ *
+ * The checker is run concurrently on the copies of the checked file, so it
+ * does not use the unittest logs. See README file for more details.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "os.h"
+
+/*
+ * The struct three_field is inconsistent if flag is set and the fields have
+ * different values.
+ */
+struct three_field {
+	int first_field;
+	int second_field;
+	int third_field;
+	int flag;
+};
+
+int
+main(int argc, char *argv[])
+{
+	if (argc != 2) {
+		fprintf(stderr, "usage: %s file\n", argv[0]);
+		return 2;
+	}
+
+	int fd = os_open(argv[1], O_RDONLY);
+	if (fd < 0) {
+		perror(argv[1]);
+		return 2;
+	}
+
+	struct three_field s;
+	if (pread(fd, &s, sizeof(s), 0) != sizeof(s)) {
+		perror(argv[1]);
+		close(fd);
+		return 2;
+	}
+	close(fd);
+
+	if (s.flag)
+		return (s.first_field != s.second_field) ||
+			(s.first_field != s.third_field);
+
+	return 0;
+}
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2014-2023, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 
 /*
  * pmemmalloc.c -- simple tool for allocating objects from pmemobj
@@ -112,6 +112,14 @@ main(int argc, char *argv[])
 			ret = 1;
 			goto end;
 		}
+
+		if (do_set && !size) {
+			TX_BEGIN(pop) {
+				pmemobj_tx_add_range(oid, 0, root_size);
+				if (exit_at == 's')
+					exit(1);
+			} TX_END
+		}
 	}
 
 	if (alloc_class_size) {
@@ -1,6 +1,6 @@
 #
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2014-2024, Intel Corporation
+# Copyright 2014-2026, Intel Corporation
 #
 # Copyright (c) 2016, Microsoft Corporation. All rights reserved.
 #
@@ -2313,6 +2313,7 @@ function require_pmreorder()
 # 3 - the path to the checker binary/library and  remaining parameters which
 #     will be passed to the consistency checker binary.
 #     If you are using a library checker, prepend '-n funcname'
+# 4 - optional, additional options of pmreorder, e.g. '-j 4'
 #
 function pmreorder_run_tool()
 {
@@ -2323,7 +2324,8 @@ function pmreorder_run_tool()
 		-o pmreorder$UNITTEST_NUM.log \
 		-r $1 \
 		-x $2 \
-		-p "$3"
+		-p "$3" \
+		$4
 	ret=$?
 	restore_exit_on_error
 	echo $ret
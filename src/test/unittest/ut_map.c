@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * ut_map.c -- helper functions for tests of libpmemobj map examples
+ *
+ * The test linking this file has to wrap pmemobj_publish, see
+ * extract_funcs in Makefile.inc.
+ */
+
+#include <unistd.h>
+
+#include "unittest.h"
+#include "ut_map.h"
+
+/* number of publishes after which the process is interrupted, 0 if never */
+static unsigned Interrupt_publish;
+/* the process is interrupted after the publish instead of before it */
+static int Interrupt_after;
+
+FUNC_MOCK(pmemobj_publish, int, PMEMobjpool *pop, struct pobj_action *actv,
+	size_t actvcnt)
+	FUNC_MOCK_RUN_DEFAULT {
+		if (Interrupt_publish == 0 || --Interrupt_publish != 0)
+			return _FUNC_REAL(pmemobj_publish)(pop, actv, actvcnt);
+
+		if (Interrupt_after)
+			_FUNC_REAL(pmemobj_publish)(pop, actv, actvcnt);
+		_exit(0);
+	}
+FUNC_MOCK_END
+
+/*
+ * ut_map_interrupt -- makes the process exit at nth publish from now on,
+ *	before or after it
+ */
+void
+ut_map_interrupt(unsigned nth, int after)
+{
+	Interrupt_publish = nth;
+	Interrupt_after = after;
+}
+
+/*
+ * ut_map_value -- returns the value stored for the key
+ */
+PMEMoid
+ut_map_value(uint64_t key)
+{
+	PMEMoid oid = {0, key + 1};
+
+	return oid;
+}
+
+/*
+ * ut_map_pool_create -- creates the pool and returns its root object
+ */
+PMEMobjpool *
+ut_map_pool_create(const char *path, const char *layout, size_t root_size,
+	void **root)
+{
+	PMEMobjpool *pop = pmemobj_create(path, layout, 0, S_IWUSR | S_IRUSR);
+	if (pop == NULL)
+		UT_FATAL("!pmemobj_create: %s", path);
+
+	*root = pmemobj_direct(pmemobj_root(pop, root_size));
+
+	return pop;
+}
+
+/*
+ * ut_map_pool_open -- opens the pool and returns its root object
+ */
+PMEMobjpool *
+ut_map_pool_open(const char *path, const char *layout, size_t root_size,
+	void **root)
+{
+	PMEMobjpool *pop = pmemobj_open(path, layout);
+	if (pop == NULL)
+		UT_FATAL("!pmemobj_open: %s", path);
+
+	*root = pmemobj_direct(pmemobj_root(pop, root_size));
+
+	return pop;
+}
@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * ut_map.h -- helper functions for tests of libpmemobj map examples
+ */
+
+#ifndef UT_MAP_H
+#define UT_MAP_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libpmemobj.h>
+
+void ut_map_interrupt(unsigned nth, int after);
+PMEMoid ut_map_value(uint64_t key);
+PMEMobjpool *ut_map_pool_create(const char *path, const char *layout,
+	size_t root_size, void **root);
+PMEMobjpool *ut_map_pool_open(const char *path, const char *layout,
+	size_t root_size, void **root);
+
+#endif /* UT_MAP_H */
@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2026, Intel Corporation
+
+#
+# src/test/unittest/ut_map.sh -- common part of unit tests for libpmemobj
+# map examples, which interrupt the operations on the map
+#
+
+#
+# map_interrupt_test -- creates the map, runs the operations which make
+#	the process exit in the middle of them and verifies the map
+#
+# usage: map_interrupt_test binary create-args interrupt-args verify-args
+#
+function map_interrupt_test() {
+	# exits with locked mutexes
+	configure_valgrind helgrind force-disable
+	configure_valgrind drd force-disable
+
+	setup
+
+	# exits in the middle of the operations, so pool cannot be closed
+	export MEMCHECK_DONT_CHECK_LEAKS=1
+
+	create_holey_file 16M $DIR/testfile
+
+	expect_normal_exit $1 $DIR/testfile $2
+	expect_normal_exit $1 $DIR/testfile $3
+	expect_normal_exit $1 $DIR/testfile $4
+}
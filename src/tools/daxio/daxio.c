@@ -1,11 +1,14 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2018-2024, Intel Corporation */
+/* Copyright 2018-2026, Intel Corporation */
 
 /*
  * daxio.c -- simple app for reading and writing data from/to
  *            Device DAX device using mmap instead of file I/O API
  */
 
+/* for O_DIRECT */
+#define _GNU_SOURCE
+
 #include <assert.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -19,6 +22,7 @@
 #include <sys/sysmacros.h>
 #include <limits.h>
 #include <string.h>
+#include <time.h>
 
 #include <ndctl/libndctl.h>
 #include <daxctl/libdaxctl.h>
@@ -26,11 +30,21 @@
 
 #include "util.h"
 #include "os.h"
+#include "os_thread.h"
 #include "bad_blocks.h"
 
 #define ALIGN_UP(size, align) (((size) + (align) - 1) & ~((align) - 1))
 #define ALIGN_DOWN(size, align) ((size) & ~((align) - 1))
 
+#define DAXIO_DEFAULT_THREADS 4
+#define DAXIO_MAX_THREADS 64
+#define DAXIO_DEFAULT_BLOCK_SIZE ((size_t)2 << 20)
+#define DAXIO_DIRECT_ALIGN ((size_t)4096)
+#define DAXIO_MEM_FLAGS (PMEM_F_MEM_NONTEMPORAL | PMEM_F_MEM_NODRAIN)
+#define DAXIO_PROGRESS_INTERVAL_MS 100
+#define DAXIO_PROGRESS_PERIOD_MS 1000
+#define MEGABYTE ((size_t)1 << 20)
+
 #define ERR(fmt, ...)\
 do {\
 	fprintf(stderr, "daxio: " fmt, ##__VA_ARGS__);\
@@ -52,6 +66,11 @@ do {\
 "   -l, --len=BYTES                 - total length to perform the I/O\n"\
 "   -b, --clear-bad-blocks=<yes|no> - clear bad blocks (default: yes)\n"\
 "   -z, --zero                      - zeroing the device\n"\
+"   -t, --threads=NUM               - number of threads (default 4)\n"\
+"   -B, --block-size=BYTES          - size of a single I/O (default 2M)\n"\
+"   -d, --direct=<yes|no>           - bypass page cache of the file\n"\
+"                                     (default: yes)\n"\
+"   -p, --progress                  - report progress and throughput\n"\
 "   -h. --help                      - print this help\n"\
 "   -V, --version                   - display version of daxio\n"
 
@@ -71,6 +90,10 @@ struct daxio_device {
 	unsigned minor;
 	struct ndctl_ctx *ndctl_ctx;
 	struct ndctl_region *region;	/* parent region */
+
+	/* regular file or block device only */
+	int seekable;		/* supports positional I/O */
+	int dfd;		/* opened with O_DIRECT, -1 if not used */
 };
 
 /*
@@ -82,6 +105,10 @@ struct daxio_context {
 	int clear_bad_blocks;
 	struct daxio_device src;
 	struct daxio_device dst;
+	unsigned nthreads;
+	size_t block_size;
+	int direct;
+	int progress;
 };
 
 /*
@@ -91,8 +118,12 @@ static struct daxio_context Ctx = {
 	SIZE_MAX,	/* len */
 	0,		/* zero */
 	1,		/* clear_bad_blocks */
-	{ NULL, -1, SIZE_MAX, 0, 0, NULL, 0, 0, 0, 0, NULL, NULL },
-	{ NULL, -1, SIZE_MAX, 0, 0, NULL, 0, 0, 0, 0, NULL, NULL },
+	{ NULL, -1, SIZE_MAX, 0, 0, NULL, 0, 0, 0, 0, NULL, NULL, 0, -1 },
+	{ NULL, -1, SIZE_MAX, 0, 0, NULL, 0, 0, 0, 0, NULL, NULL, 0, -1 },
+	0,				/* nthreads */
+	DAXIO_DEFAULT_BLOCK_SIZE,	/* block_size */
+	1,				/* direct */
+	0,				/* progress */
 };
 
 /*
@@ -124,6 +155,10 @@ static const struct option long_options[] = {
 	{"len",				required_argument,	NULL,	'l'},
 	{"clear-bad-blocks",		required_argument,	NULL,	'b'},
 	{"zero",			no_argument,		NULL,	'z'},
+	{"threads",			required_argument,	NULL,	't'},
+	{"block-size",			required_argument,	NULL,	'B'},
+	{"direct",			required_argument,	NULL,	'd'},
+	{"progress",			no_argument,		NULL,	'p'},
 	{"help",			no_argument,		NULL,	'h'},
 	{"version",			no_argument,		NULL,	'V'},
 	{NULL,				0,			NULL,	 0 },
@@ -138,8 +173,10 @@ parse_args(struct daxio_context *ctx, int argc, char * const argv[])
 	int opt;
 	size_t offset;
 	size_t len;
+	char *end;
+	unsigned long nthreads;
 
-	while ((opt = getopt_long(argc, argv, "i:o:k:s:l:b:zhV",
+	while ((opt = getopt_long(argc, argv, "i:o:k:s:l:b:zt:B:d:phV",
 			long_options, NULL)) != -1) {
 		switch (opt) {
 		case 'i':
@@ -172,6 +209,40 @@ parse_args(struct daxio_context *ctx, int argc, char * const argv[])
 		case 'z':
 			ctx->zero = 1;
 			break;
+		case 't':
+			errno = 0;
+			nthreads = strtoul(optarg, &end, 10);
+			if (errno || *end != '\0' || nthreads == 0 ||
+					nthreads > DAXIO_MAX_THREADS) {
+				ERR("'%s' -- invalid number of threads\n",
+					optarg);
+				return -1;
+			}
+			ctx->nthreads = (unsigned)nthreads;
+			break;
+		case 'B':
+			if (util_parse_size(optarg, &len) || len == 0 ||
+					len % DAXIO_DIRECT_ALIGN) {
+				ERR("'%s' -- invalid block size\n", optarg);
+				return -1;
+			}
+			ctx->block_size = len;
+			break;
+		case 'd':
+			if (strcmp(optarg, "no") == 0) {
+				ctx->direct = 0;
+			} else if (strcmp(optarg, "yes") == 0) {
+				ctx->direct = 1;
+			} else {
+				ERR(
+					"'%s' -- invalid argument of the '--direct' option\n",
+					optarg);
+				return -1;
+			}
+			break;
+		case 'p':
+			ctx->progress = 1;
+			break;
 		case 'b':
 			if (strcmp(optarg, "no") == 0) {
 				ctx->clear_bad_blocks = 0;
@@ -307,12 +378,50 @@ end:
 	return ret;
 }
 
+/*
+ * emulate_dev_dax -- (internal) handle a regular file as Device DAX
+ *
+ * For testing, the regular file named by the DAXIO_EMULATE_DEVDAX
+ * environment variable is mapped just like Device DAX, so the transfers
+ * can be tested without one.
+ */
+static int
+emulate_dev_dax(struct daxio_device *dev, const struct stat *stbuf)
+{
+	const char *path = os_getenv("DAXIO_EMULATE_DEVDAX");
+	if (path == NULL || strcmp(path, dev->path) != 0)
+		return 0;
+
+	dev->is_devdax = 1;
+	dev->size = (size_t)stbuf->st_size;
+	dev->align = (size_t)sysconf(_SC_PAGESIZE);
+	return 1;
+}
+
+/*
+ * open_direct -- (internal) open the file/device once again, bypassing
+ *                the page cache
+ *
+ * If the file system does not support direct I/O the buffered descriptor
+ * is used for all the transfers.
+ */
+static void
+open_direct(struct daxio_device *dev, int is_dst)
+{
+	int flags = (is_dst ? O_WRONLY : O_RDONLY) | O_DIRECT;
+
+	dev->dfd = os_open(dev->path, flags);
+	if (dev->dfd == -1 && errno != EINVAL)
+		ERR("cannot open '%s' for direct I/O: %s, using page cache\n",
+			dev->path, strerror(errno));
+}
+
 /*
  * setup_device -- (internal) open/mmap file/device
  */
 static int
 setup_device(struct ndctl_ctx *ndctl_ctx, struct daxio_device *dev, int is_dst,
-		int clear_bad_blocks)
+		int clear_bad_blocks, int direct)
 {
 	int ret;
 	int flags = O_RDWR;
@@ -336,6 +445,9 @@ setup_device(struct ndctl_ctx *ndctl_ctx, struct daxio_device *dev, int is_dst,
 				FAIL("open");
 				return -1;
 			}
+			dev->seekable = 1;
+			if (direct)
+				open_direct(dev, is_dst);
 			return 0;
 		} else {
 			ERR("failed to open '%s': %s\n", dev->path,
@@ -370,9 +482,16 @@ setup_device(struct ndctl_ctx *ndctl_ctx, struct daxio_device *dev, int is_dst,
 	/* check if this is Device DAX */
 	if (S_ISCHR(stbuf.st_mode))
 		find_dev_dax(ndctl_ctx, dev);
-
-	if (!dev->is_devdax)
+	else if (S_ISREG(stbuf.st_mode))
+		emulate_dev_dax(dev, &stbuf);
+
+	if (!dev->is_devdax) {
+		dev->seekable = S_ISREG(stbuf.st_mode) ||
+			S_ISBLK(stbuf.st_mode);
+		if (dev->seekable && direct)
+			open_direct(dev, is_dst);
 		return 0;
+	}
 
 	if (is_dst && clear_bad_blocks) {
 		/* XXX - clear only badblocks in range bound by offset/len */
@@ -426,9 +545,11 @@ static int
 setup_devices(struct ndctl_ctx *ndctl_ctx, struct daxio_context *ctx)
 {
 	if (!ctx->zero &&
-	    setup_device(ndctl_ctx, &ctx->src, 0, ctx->clear_bad_blocks))
+	    setup_device(ndctl_ctx, &ctx->src, 0, ctx->clear_bad_blocks,
+			ctx->direct))
 		return -1;
-	return setup_device(ndctl_ctx, &ctx->dst, 1, ctx->clear_bad_blocks);
+	return setup_device(ndctl_ctx, &ctx->dst, 1, ctx->clear_bad_blocks,
+			ctx->direct);
 }
 
 /*
@@ -469,6 +590,8 @@ cleanup_device(struct daxio_device *dev)
 		(void) munmap(dev->addr, dev->maplen);
 	if (dev->path && dev->fd != -1)
 		(void) close(dev->fd);
+	if (dev->dfd != -1)
+		(void) close(dev->dfd);
 }
 
 /*
@@ -482,6 +605,343 @@ cleanup_devices(struct daxio_context *ctx)
 		cleanup_device(&ctx->src);
 }
 
+/*
+ * daxio_transfer -- state of the transfer shared by all the worker threads
+ */
+struct daxio_transfer {
+	struct daxio_context *ctx;
+	struct daxio_device *file;	/* file/block device, if any */
+	int direct;			/* use O_DIRECT descriptor */
+	uint64_t nblocks;
+	uint64_t next;			/* next block to transfer */
+	uint64_t copied;		/* bytes transferred so far */
+	uint64_t eof;			/* end of the source file */
+	uint64_t running;		/* number of running workers */
+	int error;			/* set by any worker which failed */
+};
+
+/*
+ * transfer_fail -- (internal) stop all the workers after an error
+ */
+static void
+transfer_fail(struct daxio_transfer *t)
+{
+	util_atomic_store32(&t->error, 1);
+}
+
+/*
+ * transfer_failed -- (internal) check if any of the workers failed
+ */
+static int
+transfer_failed(struct daxio_transfer *t)
+{
+	int error;
+	util_atomic_load32(&t->error, &error);
+	return error;
+}
+
+/*
+ * pread_full -- (internal) read up to len bytes, stops only at end of file
+ *
+ * With direct I/O the read can be continued only at an aligned offset. A
+ * short read which does not end at such an offset can only end at the end
+ * of the file.
+ */
+static ssize_t
+pread_full(int fd, char *buf, size_t len, size_t off, int direct)
+{
+	size_t cnt = 0;
+
+	while (cnt < len) {
+		ssize_t rcnt = pread(fd, buf + cnt, len - cnt,
+				(off_t)(off + cnt));
+		if (rcnt == -1) {
+			if (errno == EINTR)
+				continue;
+			FAIL("pread");
+			return -1;
+		}
+		/* end of file */
+		if (rcnt == 0)
+			break;
+		cnt += (size_t)rcnt;
+		if (direct && cnt % DAXIO_DIRECT_ALIGN)
+			break;
+	}
+
+	return (ssize_t)cnt;
+}
+
+/*
+ * pwrite_full -- (internal) write the whole buffer
+ */
+static int
+pwrite_full(int fd, const char *buf, size_t len, size_t off)
+{
+	size_t cnt = 0;
+
+	while (cnt < len) {
+		ssize_t wcnt = pwrite(fd, buf + cnt, len - cnt,
+				(off_t)(off + cnt));
+		if (wcnt == -1) {
+			if (errno == EINTR)
+				continue;
+			FAIL("pwrite");
+			return -1;
+		}
+		cnt += (size_t)wcnt;
+	}
+
+	return 0;
+}
+
+/*
+ * transfer_set_eof -- (internal) remember where the source file ends, so
+ *                     the blocks past its end are not read at all
+ */
+static void
+transfer_set_eof(struct daxio_transfer *t, uint64_t off)
+{
+	uint64_t eof;
+
+	do {
+		util_atomic_load64(&t->eof, &eof);
+		if (eof <= off)
+			return;
+	} while (!util_bool_compare_and_swap64(&t->eof, eof, off));
+}
+
+/*
+ * transfer_block -- (internal) transfer a single block, returns number of
+ *                   bytes transferred or -1 on error
+ *
+ * Device DAX is written using non-temporal stores without draining, each
+ * worker drains its stores once all its blocks are done. The file side
+ * goes through the aligned bounce buffer when direct I/O is used.
+ */
+static ssize_t
+transfer_block(struct daxio_transfer *t, char *buf, size_t off, size_t len)
+{
+	struct daxio_context *ctx = t->ctx;
+	char *dst_addr = ctx->dst.addr + ctx->dst.offset + off;
+	char *src_addr = ctx->src.addr + ctx->src.offset + off;
+
+	if (ctx->zero) {
+		pmem_memset(dst_addr, 0, len, DAXIO_MEM_FLAGS);
+		return (ssize_t)len;
+	}
+
+	if (ctx->src.is_devdax && ctx->dst.is_devdax) {
+		pmem_memcpy(dst_addr, src_addr, len, DAXIO_MEM_FLAGS);
+		return (ssize_t)len;
+	}
+
+	size_t file_off = t->file->offset + off;
+
+	if (ctx->src.is_devdax) {
+		/* the unaligned tail of the file is written through cache */
+		if (t->direct && len % DAXIO_DIRECT_ALIGN == 0) {
+			memcpy(buf, src_addr, len);
+			if (pwrite_full(t->file->dfd, buf, len, file_off))
+				return -1;
+		} else {
+			if (pwrite_full(t->file->fd, src_addr, len, file_off))
+				return -1;
+		}
+		return (ssize_t)len;
+	}
+
+	ssize_t cnt;
+	if (t->direct) {
+		/* reading past the end of the file is not a problem */
+		cnt = pread_full(t->file->dfd, buf,
+				ALIGN_UP(len, DAXIO_DIRECT_ALIGN), file_off, 1);
+		if (cnt > (ssize_t)len)
+			cnt = (ssize_t)len;
+		if (cnt > 0)
+			pmem_memcpy(dst_addr, buf, (size_t)cnt,
+				DAXIO_MEM_FLAGS);
+	} else {
+		cnt = pread_full(t->file->fd, dst_addr, len, file_off, 0);
+		if (cnt > 0)
+			pmem_flush(dst_addr, (size_t)cnt);
+	}
+
+	if (cnt >= 0 && (size_t)cnt < len)
+		transfer_set_eof(t, off + (size_t)cnt);
+
+	return cnt;
+}
+
+/*
+ * transfer_worker -- (internal) transfer blocks until there are none left
+ */
+static void *
+transfer_worker(void *arg)
+{
+	struct daxio_transfer *t = arg;
+	size_t block_size = t->ctx->block_size;
+	void *buf = NULL;
+
+	if (t->direct) {
+		errno = posix_memalign(&buf, DAXIO_DIRECT_ALIGN, block_size);
+		if (errno) {
+			FAIL("posix_memalign");
+			transfer_fail(t);
+			goto out;
+		}
+	}
+
+	while (!transfer_failed(t)) {
+		uint64_t blk = util_fetch_and_add64(&t->next, 1);
+		if (blk >= t->nblocks)
+			break;
+
+		size_t off = (size_t)blk * block_size;
+		uint64_t eof;
+		util_atomic_load64(&t->eof, &eof);
+		if (off >= eof)
+			break;
+
+		size_t len = t->ctx->len - off;
+		if (len > block_size)
+			len = block_size;
+
+		ssize_t cnt = transfer_block(t, buf, off, len);
+		if (cnt < 0) {
+			transfer_fail(t);
+			break;
+		}
+		util_fetch_and_add64(&t->copied, (uint64_t)cnt);
+	}
+
+	if (t->ctx->dst.is_devdax)
+		pmem_drain();
+
+	free(buf);
+out:
+	util_fetch_and_sub64(&t->running, 1);
+	return NULL;
+}
+
+/*
+ * elapsed_sec -- (internal) number of seconds since the given time
+ */
+static double
+elapsed_sec(const struct timespec *start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)(now.tv_sec - start->tv_sec) +
+		(double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * transfer_progress -- (internal) report progress until all workers are done
+ */
+static void
+transfer_progress(struct daxio_transfer *t, const struct timespec *start)
+{
+	uint64_t running;
+	unsigned ticks = 0;
+	struct timespec interval = {0, DAXIO_PROGRESS_INTERVAL_MS * 1000000};
+
+	util_atomic_load64(&t->running, &running);
+	while (running) {
+		nanosleep(&interval, NULL);
+		util_atomic_load64(&t->running, &running);
+
+		if (++ticks % (DAXIO_PROGRESS_PERIOD_MS /
+				DAXIO_PROGRESS_INTERVAL_MS) || !running)
+			continue;
+
+		uint64_t copied;
+		util_atomic_load64(&t->copied, &copied);
+		double sec = elapsed_sec(start);
+		ERR("%" PRIu64 " of %zu MiB copied (%.1f MiB/s)\n",
+			copied / MEGABYTE, t->ctx->len / MEGABYTE,
+			(double)copied / MEGABYTE / sec);
+	}
+}
+
+/*
+ * transfer_parallel -- (internal) split the transfer into blocks and copy
+ *                      them using multiple threads
+ *
+ * Each thread keeps a single I/O in flight, so the number of threads is
+ * also the queue depth seen by the file/block device.
+ */
+static int
+transfer_parallel(struct daxio_context *ctx, ssize_t *cnt)
+{
+	struct daxio_transfer t;
+	memset(&t, 0, sizeof(t));
+	t.ctx = ctx;
+	t.eof = UINT64_MAX;
+	t.nblocks = (ctx->len + ctx->block_size - 1) / ctx->block_size;
+
+	if (!ctx->src.is_devdax)
+		t.file = &ctx->src;
+	else if (!ctx->zero && !ctx->dst.is_devdax)
+		t.file = &ctx->dst;
+
+	/* direct I/O requires offsets aligned to the logical block size */
+	t.direct = t.file != NULL && t.file->dfd != -1 &&
+		t.file->offset % DAXIO_DIRECT_ALIGN == 0;
+
+	unsigned nthreads = ctx->nthreads;
+	if (nthreads == 0) {
+		long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = ncpus > 0 && ncpus < DAXIO_DEFAULT_THREADS ?
+			(unsigned)ncpus : DAXIO_DEFAULT_THREADS;
+	}
+	if (nthreads > t.nblocks)
+		nthreads = t.nblocks ? (unsigned)t.nblocks : 1;
+
+	os_thread_t threads[DAXIO_MAX_THREADS];
+	unsigned started;
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	t.running = nthreads;
+	for (started = 0; started < nthreads; ++started) {
+		errno = os_thread_create(&threads[started], NULL,
+				transfer_worker, &t);
+		if (errno) {
+			FAIL("os_thread_create");
+			transfer_fail(&t);
+			util_fetch_and_sub64(&t.running, nthreads - started);
+			break;
+		}
+	}
+
+	if (ctx->progress)
+		transfer_progress(&t, &start);
+
+	for (unsigned i = 0; i < started; ++i)
+		os_thread_join(&threads[i], NULL);
+
+	if (!t.error && t.file == &ctx->dst && fsync(ctx->dst.fd)) {
+		FAIL("fsync");
+		t.error = 1;
+	}
+
+	if (t.error)
+		return -1;
+
+	*cnt = (ssize_t)t.copied;
+
+	if (ctx->progress) {
+		double sec = elapsed_sec(&start);
+		ERR("%" PRIu64 " bytes in %.3f s (%.1f MiB/s, %u threads%s)\n",
+			t.copied, sec, (double)t.copied / MEGABYTE / sec,
+			nthreads, t.direct ? ", direct I/O" : "");
+	}
+
+	return 0;
+}
+
 /*
  * do_io -- (internal) write data to device/file
  */
@@ -501,18 +961,18 @@ do_io(struct ndctl_ctx *ndctl_ctx, struct daxio_context *ctx)
 			ERR("output offset beyond device size");
 			return -1;
 		}
+	}
 
-		char *dst_addr = ctx->dst.addr + ctx->dst.offset;
-		pmem_memset_persist(dst_addr, 0, ctx->len);
-		cnt = (ssize_t)ctx->len;
-	} else if (ctx->src.is_devdax && ctx->dst.is_devdax) {
-		/* memcpy between src and dst */
-		char *src_addr = ctx->src.addr + ctx->src.offset;
-		char *dst_addr = ctx->dst.addr + ctx->dst.offset;
-		pmem_memcpy_persist(dst_addr, src_addr, ctx->len);
-		cnt = (ssize_t)ctx->len;
+	if (ctx->zero || (ctx->src.is_devdax && ctx->dst.is_devdax) ||
+	    (ctx->src.is_devdax ? ctx->dst.seekable : ctx->src.seekable)) {
+		if (transfer_parallel(ctx, &cnt))
+			goto err;
+
+		if (!ctx->src.is_devdax && (size_t)cnt != ctx->len)
+			ERR("requested size %zu larger than source\n",
+					ctx->len);
 	} else if (ctx->src.is_devdax) {
-		/* write to file directly from mmap'ed src */
+		/* write to stdout/pipe directly from mmap'ed src */
 		char *src_addr = ctx->src.addr + ctx->src.offset;
 		if (ctx->dst.offset) {
 			if (lseek(ctx->dst.fd, (off_t)ctx->dst.offset,
@@ -531,7 +991,7 @@ do_io(struct ndctl_ctx *ndctl_ctx, struct daxio_context *ctx)
 			cnt += wcnt;
 		} while ((size_t)cnt < ctx->len);
 	} else if (ctx->dst.is_devdax) {
-		/* read from file directly to mmap'ed dst */
+		/* read from stdin/pipe directly to mmap'ed dst */
 		char *dst_addr = ctx->dst.addr + ctx->dst.offset;
 		if (ctx->src.offset) {
 			if (lseek(ctx->src.fd, (off_t)ctx->src.offset,
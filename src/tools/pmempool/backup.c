@@ -0,0 +1,740 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * backup.c -- pmempool backup and restore commands source file
+ *
+ * A full backup copies the whole pool and starts a new generation of the
+ * dirty map maintained by libpmemobj next to the pool. An incremental backup
+ * writes only the chunks marked in the map to a delta file, which can be
+ * applied by the restore command to the backup of the previous generation.
+ *
+ * The delta file layout:
+ *	header (4 KiB)
+ *	bitmap of the chunks stored in the file
+ *	data of the stored chunks, in the order of their offsets
+ *
+ * Like the dirty map, the header and the bitmap are stored in little-endian
+ * byte order.
+ */
+#include <endian.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "backup.h"
+#include "dirty_map.h"
+#include "file.h"
+#include "os.h"
+#include "output.h"
+
+#define DELTA_SIG "PMEMDELTA"
+#define DELTA_MAJOR 1
+#define DELTA_HDR_SIZE 4096
+
+/*
+ * delta_hdr -- header of the delta file
+ */
+struct delta_hdr {
+	char signature[DIRTY_MAP_SIG_LEN];
+	uint32_t major;
+	uint32_t reserved;
+	uuid_t poolset_uuid;
+	uint64_t pool_size;
+	uint64_t chunk_size;
+	uint64_t base_generation;	/* generation the delta applies to */
+	uint64_t generation;		/* generation after applying it */
+	uint64_t nchanged;		/* number of the stored chunks */
+	unsigned char unused[DELTA_HDR_SIZE - 88];
+	uint64_t checksum;
+};
+
+/*
+ * delta_hdr_convert2le -- convert the header of the delta file
+ *	to little-endian byte order
+ */
+static void
+delta_hdr_convert2le(struct delta_hdr *dhdr)
+{
+	dhdr->major = htole32(dhdr->major);
+	dhdr->pool_size = htole64(dhdr->pool_size);
+	dhdr->chunk_size = htole64(dhdr->chunk_size);
+	dhdr->base_generation = htole64(dhdr->base_generation);
+	dhdr->generation = htole64(dhdr->generation);
+	dhdr->nchanged = htole64(dhdr->nchanged);
+}
+
+/*
+ * delta_hdr_convert2h -- convert the header of the delta file
+ *	to host byte order
+ */
+static void
+delta_hdr_convert2h(struct delta_hdr *dhdr)
+{
+	dhdr->major = le32toh(dhdr->major);
+	dhdr->pool_size = le64toh(dhdr->pool_size);
+	dhdr->chunk_size = le64toh(dhdr->chunk_size);
+	dhdr->base_generation = le64toh(dhdr->base_generation);
+	dhdr->generation = le64toh(dhdr->generation);
+	dhdr->nchanged = le64toh(dhdr->nchanged);
+}
+
+/*
+ * backup_ctx -- context and arguments for backup and restore commands
+ */
+struct backup_ctx {
+	int verbose;
+	int incremental;
+	const char *src;
+	const char *dst;
+};
+
+/*
+ * pmempool_backup_default -- default arguments for backup command
+ */
+static const struct backup_ctx pmempool_backup_default = {
+	.verbose	= 1,
+	.incremental	= 0,
+	.src		= NULL,
+	.dst		= NULL,
+};
+
+/*
+ * help_str -- string for help message
+ */
+static const char * const help_str =
+"Create a full or incremental backup of a pool\n"
+"\n"
+"Available options:\n"
+"  -i, --incremental  store only chunks modified since the last backup\n"
+"  -v, --verbose      increase verbosity level\n"
+"  -h, --help         display this help and exit\n"
+"\n"
+"For complete documentation see %s-backup(1) manual page.\n"
+;
+
+/*
+ * help_restore_str -- string for help message of restore command
+ */
+static const char * const help_restore_str =
+"Apply an incremental backup to the backup of the previous generation\n"
+"\n"
+"Available options:\n"
+"  -v, --verbose      increase verbosity level\n"
+"  -h, --help         display this help and exit\n"
+"\n"
+"For complete documentation see %s-backup(1) manual page.\n"
+;
+
+/*
+ * long_options -- command line options
+ */
+static const struct option long_options[] = {
+	{"incremental",	no_argument,	NULL,	'i'},
+	{"verbose",	no_argument,	NULL,	'v'},
+	{"help",	no_argument,	NULL,	'h'},
+	{NULL,		0,		NULL,	 0 },
+};
+
+/*
+ * long_restore_options -- command line options of restore command
+ */
+static const struct option long_restore_options[] = {
+	{"verbose",	no_argument,	NULL,	'v'},
+	{"help",	no_argument,	NULL,	'h'},
+	{NULL,		0,		NULL,	 0 },
+};
+
+/*
+ * print_usage -- print short description of application's usage
+ */
+static void
+print_usage(const char *appname)
+{
+	printf("Usage: %s backup [<args>] <pool> <backup|delta>\n", appname);
+}
+
+/*
+ * print_restore_usage -- print short description of restore command usage
+ */
+static void
+print_restore_usage(const char *appname)
+{
+	printf("Usage: %s restore [<args>] <delta> <backup>\n", appname);
+}
+
+/*
+ * print_version -- print version string
+ */
+static void
+print_version(const char *appname)
+{
+	printf("%s %s\n", appname, SRCVERSION);
+}
+
+/*
+ * pmempool_backup_help -- print help message for backup command
+ */
+void
+pmempool_backup_help(const char *appname)
+{
+	print_usage(appname);
+	print_version(appname);
+	printf(help_str, appname);
+}
+
+/*
+ * pmempool_restore_help -- print help message for restore command
+ */
+void
+pmempool_restore_help(const char *appname)
+{
+	print_restore_usage(appname);
+	print_version(appname);
+	printf(help_restore_str, appname);
+}
+
+/*
+ * backup_nchunks -- number of chunks of the pool
+ */
+static uint64_t
+backup_nchunks(uint64_t pool_size)
+{
+	return (pool_size + DIRTY_MAP_CHUNK_SIZE - 1) / DIRTY_MAP_CHUNK_SIZE;
+}
+
+/*
+ * backup_chunk_len -- length of the chunk, the last one may be partial
+ */
+static size_t
+backup_chunk_len(uint64_t pool_size, uint64_t chunk)
+{
+	uint64_t off = chunk * DIRTY_MAP_CHUNK_SIZE;
+	uint64_t left = pool_size - off;
+
+	return (size_t)(left < DIRTY_MAP_CHUNK_SIZE ?
+		left : DIRTY_MAP_CHUNK_SIZE);
+}
+
+/*
+ * backup_write -- write the whole buffer to the file
+ */
+static int
+backup_write(int fd, const void *buf, size_t len, uint64_t off)
+{
+	const char *ptr = buf;
+	while (len > 0) {
+		ssize_t ret = pwrite(fd, ptr, len, (os_off_t)off);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		ptr += ret;
+		off += (uint64_t)ret;
+		len -= (size_t)ret;
+	}
+
+	return 0;
+}
+
+/*
+ * backup_read -- read the whole buffer from the file
+ */
+static int
+backup_read(int fd, void *buf, size_t len, uint64_t off)
+{
+	char *ptr = buf;
+	while (len > 0) {
+		ssize_t ret = pread(fd, ptr, len, (os_off_t)off);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		if (ret == 0) {
+			errno = EINVAL;
+			return -1;
+		}
+
+		ptr += ret;
+		off += (uint64_t)ret;
+		len -= (size_t)ret;
+	}
+
+	return 0;
+}
+
+/*
+ * backup_pool_open -- open a single file obj pool, the pool stays locked
+ *	until it is closed
+ */
+static struct pool_set_file *
+backup_pool_open(const char *path, int rdonly)
+{
+	struct pmem_pool_params params;
+	if (pmem_pool_parse_params(path, &params, 1)) {
+		outv_err("%s: cannot read pool parameters\n", path);
+		return NULL;
+	}
+
+	if (params.type != PMEM_POOL_TYPE_OBJ) {
+		outv_err("%s: only obj pools are supported\n", path);
+		return NULL;
+	}
+
+	if (params.is_poolset) {
+		outv_err("%s: pool sets are not supported\n", path);
+		return NULL;
+	}
+
+	struct pool_set_file *file = pool_set_file_open(path, rdonly, 0);
+	if (file == NULL) {
+		outv_err("!%s: cannot open pool", path);
+		return NULL;
+	}
+
+	if (file->fileio) {
+		outv_err("%s: block devices are not supported\n", path);
+		pool_set_file_close(file);
+		return NULL;
+	}
+
+	return file;
+}
+
+/*
+ * backup_map_path -- allocate the path of the dirty map of the file
+ */
+static char *
+backup_map_path(const char *path)
+{
+	char *map_path = util_dirty_map_path(path);
+	if (map_path == NULL)
+		outv_err("!util_dirty_map_path");
+
+	return map_path;
+}
+
+/*
+ * backup_full -- copy the whole pool and start a new generation
+ */
+static int
+backup_full(struct backup_ctx *ctx, struct pool_set_file *pool)
+{
+	struct pool_hdr *hdr = pool->addr;
+	int ret = -1;
+
+	char *map_path = backup_map_path(ctx->src);
+	if (map_path == NULL)
+		return -1;
+
+	char *dst_map_path = backup_map_path(ctx->dst);
+	if (dst_map_path == NULL)
+		goto out_map_path;
+
+	uint64_t generation = 1;
+	struct dirty_map *map = util_dirty_map_open(map_path,
+		hdr->poolset_uuid, pool->size);
+	if (map != NULL)
+		generation = map->generation + 1;
+
+	int fd = os_open(ctx->dst, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0) {
+		outv_err("!%s", ctx->dst);
+		goto out_map;
+	}
+
+	for (uint64_t c = 0; c < backup_nchunks(pool->size); ++c) {
+		uint64_t off = c * DIRTY_MAP_CHUNK_SIZE;
+		if (backup_write(fd, (char *)pool->addr + off,
+				backup_chunk_len(pool->size, c), off)) {
+			outv_err("!%s: write", ctx->dst);
+			goto out_unlink;
+		}
+	}
+
+	if (os_fsync(fd)) {
+		outv_err("!%s: fsync", ctx->dst);
+		goto out_unlink;
+	}
+
+	/* from now on the changes are tracked in a new generation */
+	if (map != NULL) {
+		util_dirty_map_reset(map, generation);
+	} else {
+		map = util_dirty_map_create(map_path, hdr->poolset_uuid,
+			pool->size, generation);
+		if (map == NULL) {
+			outv_err("!%s: cannot create dirty map", map_path);
+			goto out_unlink;
+		}
+	}
+
+	struct dirty_map *dst_map = util_dirty_map_create(dst_map_path,
+		hdr->poolset_uuid, pool->size, generation);
+	if (dst_map == NULL) {
+		outv_err("!%s: cannot create dirty map", dst_map_path);
+		goto out_unlink;
+	}
+	util_dirty_map_close(dst_map);
+
+	outv(1, "%s: full backup, generation %" PRIu64 "\n", ctx->dst,
+		generation);
+
+	ret = 0;
+	goto out_close;
+
+out_unlink:
+	os_unlink(ctx->dst);
+out_close:
+	os_close(fd);
+out_map:
+	if (map != NULL)
+		util_dirty_map_close(map);
+	Free(dst_map_path);
+out_map_path:
+	Free(map_path);
+	return ret;
+}
+
+/*
+ * backup_incremental -- store the chunks modified since the last backup
+ *	in a delta file and start a new generation
+ */
+static int
+backup_incremental(struct backup_ctx *ctx, struct pool_set_file *pool)
+{
+	struct pool_hdr *hdr = pool->addr;
+	int ret = -1;
+
+	char *map_path = backup_map_path(ctx->src);
+	if (map_path == NULL)
+		return -1;
+
+	struct dirty_map *map = util_dirty_map_open(map_path,
+		hdr->poolset_uuid, pool->size);
+	if (map == NULL) {
+		outv_err("!%s: no valid dirty map, "
+			"a full backup is required", map_path);
+		goto out_map_path;
+	}
+
+	uint64_t nchunks = map->nchunks;
+	size_t bitmap_len = (size_t)(nchunks + 63) / 64 * sizeof(uint64_t);
+	uint64_t *bits = malloc(bitmap_len);
+	if (bits == NULL) {
+		outv_err("!malloc");
+		goto out_map;
+	}
+	memcpy(bits, map->bits, bitmap_len);
+
+	/* the pool header is updated on open without going through the map */
+	bits[0] |= htole64(1);
+
+	struct delta_hdr dhdr;
+	memset(&dhdr, 0, sizeof(dhdr));
+	memcpy(dhdr.signature, DELTA_SIG, sizeof(DELTA_SIG));
+	dhdr.major = DELTA_MAJOR;
+	memcpy(dhdr.poolset_uuid, hdr->poolset_uuid, POOL_HDR_UUID_LEN);
+	dhdr.pool_size = pool->size;
+	dhdr.chunk_size = DIRTY_MAP_CHUNK_SIZE;
+	dhdr.base_generation = map->generation;
+	dhdr.generation = map->generation + 1;
+	for (uint64_t w = 0; w < bitmap_len / sizeof(uint64_t); ++w)
+		dhdr.nchanged += (uint64_t)__builtin_popcountll(bits[w]);
+
+	struct delta_hdr dhdr_le = dhdr;
+	delta_hdr_convert2le(&dhdr_le);
+	util_checksum(&dhdr_le, sizeof(dhdr_le), &dhdr_le.checksum, 1, 0);
+
+	int fd = os_open(ctx->dst, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0) {
+		outv_err("!%s", ctx->dst);
+		goto out_bits;
+	}
+
+	if (backup_write(fd, &dhdr_le, sizeof(dhdr_le), 0) ||
+			backup_write(fd, bits, bitmap_len, sizeof(dhdr))) {
+		outv_err("!%s: write", ctx->dst);
+		goto out_unlink;
+	}
+
+	uint64_t off = sizeof(dhdr) + bitmap_len;
+
+	for (uint64_t c = 0; c < nchunks; ++c) {
+		if (!(le64toh(bits[c / 64]) & (1ULL << (c % 64))))
+			continue;
+
+		size_t len = backup_chunk_len(pool->size, c);
+		if (backup_write(fd, (char *)pool->addr +
+				c * DIRTY_MAP_CHUNK_SIZE, len, off)) {
+			outv_err("!%s: write", ctx->dst);
+			goto out_unlink;
+		}
+		off += len;
+	}
+
+	if (os_fsync(fd)) {
+		outv_err("!%s: fsync", ctx->dst);
+		goto out_unlink;
+	}
+
+	util_dirty_map_reset(map, dhdr.generation);
+
+	outv(1, "%s: %" PRIu64 " of %" PRIu64 " chunks changed, "
+		"generation %" PRIu64 "\n", ctx->dst, dhdr.nchanged, nchunks,
+		dhdr.generation);
+
+	ret = 0;
+	goto out_close;
+
+out_unlink:
+	os_unlink(ctx->dst);
+out_close:
+	os_close(fd);
+out_bits:
+	free(bits);
+out_map:
+	util_dirty_map_close(map);
+out_map_path:
+	Free(map_path);
+	return ret;
+}
+
+/*
+ * backup_delta_read_hdr -- read and verify the header of the delta file
+ */
+static int
+backup_delta_read_hdr(int fd, const char *path, struct delta_hdr *dhdr)
+{
+	COMPILE_ERROR_ON(sizeof(struct delta_hdr) != DELTA_HDR_SIZE);
+
+	if (backup_read(fd, dhdr, sizeof(*dhdr), 0)) {
+		outv_err("!%s: read", path);
+		return -1;
+	}
+
+	if (memcmp(dhdr->signature, DELTA_SIG, sizeof(DELTA_SIG)) ||
+			!util_checksum(dhdr, sizeof(*dhdr), &dhdr->checksum,
+			0, 0)) {
+		outv_err("%s: not a valid delta file\n", path);
+		return -1;
+	}
+
+	delta_hdr_convert2h(dhdr);
+
+	if (dhdr->major != DELTA_MAJOR ||
+			dhdr->chunk_size != DIRTY_MAP_CHUNK_SIZE) {
+		outv_err("%s: unsupported delta file version\n", path);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * backup_restore -- apply the delta file to the backup
+ */
+static int
+backup_restore(struct backup_ctx *ctx)
+{
+	int ret = -1;
+
+	int fd = os_open(ctx->src, O_RDONLY);
+	if (fd < 0) {
+		outv_err("!%s", ctx->src);
+		return -1;
+	}
+
+	struct delta_hdr dhdr;
+	if (backup_delta_read_hdr(fd, ctx->src, &dhdr))
+		goto out_fd;
+
+	struct pool_set_file *pool = backup_pool_open(ctx->dst, 0);
+	if (pool == NULL)
+		goto out_fd;
+
+	struct pool_hdr *hdr = pool->addr;
+	if (memcmp(hdr->poolset_uuid, dhdr.poolset_uuid, POOL_HDR_UUID_LEN) ||
+			pool->size != dhdr.pool_size) {
+		outv_err("%s: delta of a different pool\n", ctx->src);
+		goto out_pool;
+	}
+
+	char *map_path = backup_map_path(ctx->dst);
+	if (map_path == NULL)
+		goto out_pool;
+
+	struct dirty_map *map = util_dirty_map_open(map_path,
+		dhdr.poolset_uuid, dhdr.pool_size);
+	if (map == NULL) {
+		outv_err("!%s: no valid dirty map of the backup", map_path);
+		goto out_map_path;
+	}
+
+	if (map->generation != dhdr.base_generation) {
+		outv_err("%s: backup generation is %" PRIu64 ", the delta "
+			"applies to generation %" PRIu64 "\n", ctx->dst,
+			map->generation, dhdr.base_generation);
+		goto out_map;
+	}
+
+	if (util_dirty_map_count(map) != 0) {
+		outv_err("%s: backup has been modified since it was taken\n",
+			ctx->dst);
+		goto out_map;
+	}
+
+	uint64_t nchunks = map->nchunks;
+	size_t bitmap_len = (size_t)(nchunks + 63) / 64 * sizeof(uint64_t);
+	uint64_t *bits = malloc(bitmap_len);
+	if (bits == NULL) {
+		outv_err("!malloc");
+		goto out_map;
+	}
+
+	if (backup_read(fd, bits, bitmap_len, sizeof(dhdr))) {
+		outv_err("!%s: read", ctx->src);
+		goto out_bits;
+	}
+
+	/*
+	 * Applying the delta again after an interruption is safe, as
+	 * the generation of the backup is changed only at the very end.
+	 */
+	uint64_t off = sizeof(dhdr) + bitmap_len;
+	for (uint64_t c = 0; c < nchunks; ++c) {
+		if (!(le64toh(bits[c / 64]) & (1ULL << (c % 64))))
+			continue;
+
+		size_t len = backup_chunk_len(pool->size, c);
+		char *dst = (char *)pool->addr + c * DIRTY_MAP_CHUNK_SIZE;
+		if (backup_read(fd, dst, len, off)) {
+			outv_err("!%s: read", ctx->src);
+			goto out_bits;
+		}
+		pool_set_file_persist(pool, dst, len);
+		off += len;
+	}
+
+	util_dirty_map_reset(map, dhdr.generation);
+
+	outv(1, "%s: %" PRIu64 " chunks restored, generation %" PRIu64 "\n",
+		ctx->dst, dhdr.nchanged, dhdr.generation);
+
+	ret = 0;
+
+out_bits:
+	free(bits);
+out_map:
+	util_dirty_map_close(map);
+out_map_path:
+	Free(map_path);
+out_pool:
+	pool_set_file_close(pool);
+out_fd:
+	os_close(fd);
+	return ret;
+}
+
+/*
+ * parse_args -- parse command line arguments
+ */
+static int
+parse_args(struct backup_ctx *ctx, const char *appname, int argc,
+		char *argv[], int restore)
+{
+	const char *optstr = restore ? "vh" : "ivh";
+	const struct option *opts = restore ?
+		long_restore_options : long_options;
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, optstr, opts, NULL)) != -1) {
+		switch (opt) {
+		case 'i':
+			ctx->incremental = 1;
+			break;
+		case 'v':
+			ctx->verbose = 2;
+			break;
+		case 'h':
+			if (restore)
+				pmempool_restore_help(appname);
+			else
+				pmempool_backup_help(appname);
+			exit(EXIT_SUCCESS);
+		default:
+			if (restore)
+				print_restore_usage(appname);
+			else
+				print_usage(appname);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (optind + 1 >= argc) {
+		if (restore)
+			print_restore_usage(appname);
+		else
+			print_usage(appname);
+		exit(EXIT_FAILURE);
+	}
+
+	ctx->src = argv[optind];
+	ctx->dst = argv[optind + 1];
+
+	return 0;
+}
+
+/*
+ * pmempool_backup_func -- main function for backup command
+ */
+int
+pmempool_backup_func(const char *appname, int argc, char *argv[])
+{
+	struct backup_ctx ctx = pmempool_backup_default;
+
+	int ret = parse_args(&ctx, appname, argc, argv, 0);
+	if (ret)
+		return ret;
+
+	out_set_vlevel(ctx.verbose);
+
+	struct pool_set_file *pool = backup_pool_open(ctx.src, 1);
+	if (pool == NULL)
+		return -1;
+
+	if (ctx.incremental)
+		ret = backup_incremental(&ctx, pool);
+	else
+		ret = backup_full(&ctx, pool);
+
+	pool_set_file_close(pool);
+
+	return ret;
+}
+
+/*
+ * pmempool_restore_func -- main function for restore command
+ */
+int
+pmempool_restore_func(const char *appname, int argc, char *argv[])
+{
+	struct backup_ctx ctx = pmempool_backup_default;
+
+	int ret = parse_args(&ctx, appname, argc, argv, 1);
+	if (ret)
+		return ret;
+
+	out_set_vlevel(ctx.verbose);
+
+	return backup_restore(&ctx);
+}
@@ -0,0 +1,11 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * backup.h -- pmempool backup and restore commands header file
+ */
+
+int pmempool_backup_func(const char *appname, int argc, char *argv[]);
+void pmempool_backup_help(const char *appname);
+int pmempool_restore_func(const char *appname, int argc, char *argv[]);
+void pmempool_restore_help(const char *appname);
@@ -1,10 +1,11 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2014-2019, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 
 /*
  * check.c -- pmempool check command source file
  */
 #include <getopt.h>
+#include <errno.h>
 #include <stdlib.h>
 
 #include "common.h"
@@ -15,6 +16,9 @@
 
 #include "libpmempool.h"
 
+/* maximum number of threads verifying the heap */
+#define CHECK_MAX_JOBS 64
+
 typedef enum
 {
 	CHECK_RESULT_CONSISTENT,
@@ -38,6 +42,7 @@ struct pmempool_check_context {
 	char *backup_fname;	/* backup file name */
 	bool exec;		/* do execute */
 	char ans;		/* default answer on all questions or '?' */
+	unsigned jobs;		/* threads verifying the heap, 0 for default */
 };
 
 /*
@@ -52,6 +57,7 @@ static const struct pmempool_check_context pmempool_check_default = {
 	.advanced	= false,
 	.exec		= true,
 	.ans		= '?',
+	.jobs		= 0,
 };
 
 /*
@@ -68,6 +74,7 @@ static const char * const help_str =
 "  -a, --advanced       perform advanced repairs\n"
 "  -q, --quiet          be quiet and don't print any messages\n"
 "  -v, --verbose        increase verbosity level\n"
+"  -j, --jobs <num>     number of threads verifying the heap\n"
 "  -h, --help           display this help and exit\n"
 "\n"
 "For complete documentation see %s-check(1) manual page.\n"
@@ -85,6 +92,7 @@ static const struct option long_options[] = {
 	{"advanced",	no_argument,		NULL,	'a'},
 	{"quiet",	no_argument,		NULL,	'q'},
 	{"verbose",	no_argument,		NULL,	'v'},
+	{"jobs",	required_argument,	NULL,	'j'},
 	{"help",	no_argument,		NULL,	'h'},
 	{NULL,		0,			NULL,	 0 },
 };
@@ -126,7 +134,7 @@ pmempool_check_parse_args(struct pmempool_check_context *pcp,
 		const char *appname, int argc, char *argv[])
 {
 	int opt;
-	while ((opt = getopt_long(argc, argv, "ahvrdNb:qy",
+	while ((opt = getopt_long(argc, argv, "ahvrdNb:qyj:",
 			long_options, NULL)) != -1) {
 		switch (opt) {
 		case 'r':
@@ -152,6 +160,20 @@ pmempool_check_parse_args(struct pmempool_check_context *pcp,
 		case 'v':
 			pcp->verbose = 2;
 			break;
+		case 'j':
+		{
+			char *endptr;
+			errno = 0;
+			unsigned long jobs = strtoul(optarg, &endptr, 10);
+			if ((endptr && *endptr != '\0') || errno ||
+					jobs == 0 || jobs > CHECK_MAX_JOBS) {
+				outv_err("'%s' -- invalid number of jobs\n",
+						optarg);
+				exit(EXIT_FAILURE);
+			}
+			pcp->jobs = (unsigned)jobs;
+			break;
+		}
 		case 'h':
 			pmempool_check_help(appname);
 			exit(EXIT_SUCCESS);
@@ -213,7 +235,8 @@ pmempool_check_perform(struct pmempool_check_context *pc)
 		.path	= pc->fname,
 		.backup_path	= pc->backup_fname,
 		.pool_type	= PMEMPOOL_POOL_TYPE_DETECT,
-		.flags		= PMEMPOOL_CHECK_FORMAT_STR
+		.flags		= PMEMPOOL_CHECK_FORMAT_STR,
+		.nthreads	= pc->jobs,
 	};
 
 	if (pc->repair)
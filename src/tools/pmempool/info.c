@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2014-2024, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 
 /*
  * info.c -- pmempool info command main source file
@@ -71,6 +71,8 @@ static const struct pmempool_info_args pmempool_info_args_default = {
 		.ignore_empty_obj = false,
 		.chunk_types	= DEFAULT_CHUNK_TYPES,
 		.replica	= 0,
+		.sample		= 100.0,
+		.jobs		= 0,
 	},
 };
 
@@ -103,6 +105,9 @@ static const struct option long_options[] = {
 	{"chunk-type",	required_argument,	NULL, 'T' | OPT_OBJ},
 	{"bitmap",	no_argument,		NULL, 'b' | OPT_OBJ},
 	{"replica",	required_argument,	NULL, 'p' | OPT_OBJ},
+	{"sample",	required_argument,	NULL, 'P' | OPT_OBJ},
+	{"jobs",	required_argument,	NULL, 'j' | OPT_OBJ},
+	{"json",	no_argument,		NULL, 'J' | OPT_OBJ},
 	{NULL,		0,			NULL,  0 },
 };
 
@@ -173,6 +178,16 @@ static const struct option_requirement option_requirements[] = {
 		.type	= PMEM_POOL_TYPE_OBJ,
 		.req	= OPT_REQ0('O') | OPT_REQ1('o'),
 	},
+	{
+		.opt	= 'P',
+		.type	= PMEM_POOL_TYPE_OBJ,
+		.req	= OPT_REQ0('s') | OPT_REQ1('J'),
+	},
+	{
+		.opt	= 'j',
+		.type	= PMEM_POOL_TYPE_OBJ,
+		.req	= OPT_REQ0('s') | OPT_REQ1('J'),
+	},
 	{ 0,  0, 0}
 };
 
@@ -218,6 +233,10 @@ static const char * const help_str =
 "  -b, --bitmap                    Print chunk run's bitmap in graphical\n"
 "                                  format. [requires --chunks|-C]\n"
 "  -p, --replica <num>             Print info from specified replica\n"
+"  -P, --sample <percent>          Estimate statistics from the specified\n"
+"                                  percentage of zones.\n"
+"  -j, --jobs <num>                Number of threads collecting statistics.\n"
+"  -J, --json                      Print only statistics, in JSON format.\n"
 "For complete documentation see %s-info(1) manual page.\n"
 ;
 
@@ -272,7 +291,7 @@ parse_args(const char *appname, int argc, char *argv[],
 
 	struct ranges *rangesp = &argsp->ranges;
 	while ((opt = util_options_getopt(argc, argv,
-			"vhnf:ezuF:L:c:dmxVw:gBsr:lRS:OECZHT:bot:aAp:k:",
+			"vhnf:ezuF:L:c:dmxVw:gBsr:lRS:OECZHT:bot:aAp:k:P:j:J",
 			opts)) != -1) {
 
 		switch (opt) {
@@ -400,6 +419,37 @@ parse_args(const char *appname, int argc, char *argv[],
 			argsp->obj.replica = (size_t)ll;
 			break;
 		}
+		case 'P':
+		{
+			char *endptr;
+			errno = 0;
+			double perc = strtod(optarg, &endptr);
+			if ((endptr && *endptr != '\0') || errno ||
+					!(perc > 0.0 && perc <= 100.0)) {
+				outv_err("'%s' -- invalid percentage of zones",
+						optarg);
+				return -1;
+			}
+			argsp->obj.sample = perc;
+			break;
+		}
+		case 'j':
+		{
+			char *endptr;
+			errno = 0;
+			unsigned long jobs = strtoul(optarg, &endptr, 10);
+			if ((endptr && *endptr != '\0') || errno ||
+					jobs == 0 || jobs > INFO_MAX_JOBS) {
+				outv_err("'%s' -- invalid number of jobs",
+						optarg);
+				return -1;
+			}
+			argsp->obj.jobs = (unsigned)jobs;
+			break;
+		}
+		case 'J':
+			argsp->json = true;
+			break;
 		default:
 			print_usage(appname);
 			return -1;
@@ -413,6 +463,14 @@ parse_args(const char *appname, int argc, char *argv[],
 		return -1;
 	}
 
+	/* objects and chunks can be printed only when all zones are scanned */
+	if (argsp->obj.sample < 100.0 && !argsp->json &&
+			(argsp->obj.vobjects || argsp->obj.vheap)) {
+		outv_err("'--sample' cannot be used with '--object-store' "
+			"or '--heap'\n");
+		return -1;
+	}
+
 	if (!argsp->use_range)
 		util_ranges_add(&argsp->ranges, ENTIRE_UINT64);
 
@@ -886,11 +944,14 @@ static void
 pmempool_info_free(struct pmem_info *pip)
 {
 	if (pip->obj.stats.zone_stats) {
-		for (uint64_t i = 0; i < pip->obj.stats.n_zones; ++i)
+		for (uint64_t i = 0; i < pip->obj.stats.n_zones; ++i) {
 			VEC_DELETE(&pip->obj.stats.zone_stats[i].class_stats);
+			VEC_DELETE(&pip->obj.stats.zone_stats[i].type_stats);
+		}
 
 		free(pip->obj.stats.zone_stats);
 	}
+	free(pip->obj.stats.zones_sampled);
 	util_options_free(pip->opts);
 	util_ranges_clear(&pip->args.ranges);
 	util_ranges_clear(&pip->args.obj.type_ranges);
@@ -918,7 +979,8 @@ pmempool_info_func(const char *appname, int argc, char *argv[])
 	if ((ret = parse_args(appname, argc, argv, &pip->args,
 					pip->opts)) == 0) {
 		/* set some output format values */
-		out_set_vlevel(pip->args.vlevel);
+		out_set_vlevel(pip->args.json ? VERBOSE_SILENT :
+				pip->args.vlevel);
 		out_set_col_width(pip->args.col_width);
 
 		ret = pmempool_info_file(pip, pip->args.file);
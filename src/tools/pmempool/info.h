@@ -1,5 +1,5 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
-/* Copyright 2014-2023, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 
 /*
  * info.h -- pmempool info command header file
@@ -28,6 +28,9 @@
 #define VERBOSE_DEFAULT	1
 #define VERBOSE_MAX	2
 
+/* maximum number of threads collecting statistics */
+#define INFO_MAX_JOBS	64
+
 /*
  * print_bb_e -- printing bad blocks options
  */
@@ -55,6 +58,7 @@ struct pmempool_info_args {
 	int vdata;		/* verbosity level for data dump */
 	int vhdrdump;		/* verbosity level for headers hexdump */
 	int vstats;		/* verbosity level for statistics */
+	bool json;		/* print statistics in JSON format */
 	struct {
 		int vlanes;		/* verbosity level for lanes */
 		int vroot;
@@ -69,6 +73,8 @@ struct pmempool_info_args {
 		bool ignore_empty_obj;
 		uint64_t chunk_types;
 		size_t replica;
+		double sample;	/* percentage of zones used for statistics */
+		unsigned jobs;	/* number of threads collecting statistics */
 		struct ranges lane_ranges;
 		struct ranges type_ranges;
 		struct ranges zone_ranges;
@@ -85,12 +91,21 @@ struct pmem_obj_class_stats {
 	uint16_t flags;
 };
 
+struct pmem_obj_zone_type_stats {
+	uint64_t type_num;
+	uint64_t n_objects;
+	uint64_t n_bytes;
+};
+
 struct pmem_obj_zone_stats {
+	uint64_t n_objects;
+	uint64_t n_bytes;
 	uint64_t n_chunks;
 	uint64_t n_chunks_type[MAX_CHUNK_TYPE];
 	uint64_t size_chunks;
 	uint64_t size_chunks_type[MAX_CHUNK_TYPE];
 	VEC(, struct pmem_obj_class_stats) class_stats;
+	VEC(, struct pmem_obj_zone_type_stats) type_stats;
 };
 
 struct pmem_obj_type_stats {
@@ -105,6 +120,8 @@ struct pmem_obj_stats {
 	uint64_t n_total_bytes;
 	uint64_t n_zones;
 	uint64_t n_zones_used;
+	uint64_t n_zones_sampled;
+	size_t *zones_sampled;	/* zones the statistics are collected from */
 	struct pmem_obj_zone_stats *zone_stats;
 	PMDK_TAILQ_HEAD(obj_type_stats_head, pmem_obj_type_stats) type_stats;
 };
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2014-2023, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 
 /*
  * info_obj.c -- pmempool info command source file for obj pool
@@ -12,8 +12,11 @@
 #include <sys/mman.h>
 #include <assert.h>
 #include <inttypes.h>
+#include <math.h>
+#include <unistd.h>
 
 #include "alloc_class.h"
+#include "os_thread.h"
 
 #include "set.h"
 #include "common.h"
@@ -27,6 +30,23 @@
 
 #define PTR_TO_OFF(pop, ptr) ((uintptr_t)(ptr) - (uintptr_t)(pop))
 
+/* default number of threads collecting the statistics */
+#define INFO_OBJ_DEFAULT_JOBS 8
+
+/* z-score of the 95% confidence interval of the estimated statistics */
+#define INFO_OBJ_Z95 1.96
+
+#define INFO_OBJ_ESTIMATE_STR_MAX 64
+
+/*
+ * info_obj_scan -- context of scanning chunks of a single zone
+ */
+struct info_obj_scan {
+	struct pmem_info *pip;
+	struct pmem_obj_zone_stats *stats;
+	uint64_t *objid;	/* id of the next object */
+};
+
 /*
  * lane_need_recovery -- return 1 if lane section needs recovery
  */
@@ -91,6 +111,28 @@ pmem_obj_stats_get_type(struct pmem_obj_stats *stats, uint64_t type_num)
 	return type;
 }
 
+/*
+ * pmem_obj_zone_stats_get_type -- get zone's stats for specified type number
+ */
+static struct pmem_obj_zone_type_stats *
+pmem_obj_zone_stats_get_type(struct pmem_obj_zone_stats *stats,
+	uint64_t type_num)
+{
+	struct pmem_obj_zone_type_stats *type;
+	VEC_FOREACH_BY_PTR(type, &stats->type_stats) {
+		if (type->type_num == type_num)
+			return type;
+	}
+
+	struct pmem_obj_zone_type_stats s = {type_num, 0, 0};
+	if (VEC_PUSH_BACK(&stats->type_stats, s) != 0) {
+		outv_err("cannot allocate memory for type stats\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return &VEC_BACK(&stats->type_stats);
+}
+
 struct info_obj_redo_args {
 	int v;
 	size_t i;
@@ -304,9 +346,11 @@ info_obj_zone_hdr(struct pmem_info *pip, int v, struct zone_header *zone)
  * info_obj_object -- print information about object
  */
 static void
-info_obj_object(struct pmem_info *pip, const struct memory_block *m,
-	uint64_t objid)
+info_obj_object(struct info_obj_scan *scan, const struct memory_block *m)
 {
+	struct pmem_info *pip = scan->pip;
+	uint64_t objid = (*scan->objid)++;
+
 	if (!util_ranges_contain(&pip->args.ranges, objid))
 		return;
 
@@ -316,11 +360,11 @@ info_obj_object(struct pmem_info *pip, const struct memory_block *m,
 		return;
 
 	uint64_t real_size = m->m_ops->get_real_size(m);
-	pip->obj.stats.n_total_objects++;
-	pip->obj.stats.n_total_bytes += real_size;
+	scan->stats->n_objects++;
+	scan->stats->n_bytes += real_size;
 
-	struct pmem_obj_type_stats *type_stats =
-		pmem_obj_stats_get_type(&pip->obj.stats, type_num);
+	struct pmem_obj_zone_type_stats *type_stats =
+		pmem_obj_zone_stats_get_type(scan->stats, type_num);
 
 	type_stats->n_objects++;
 	type_stats->n_bytes += real_size;
@@ -328,6 +372,10 @@ info_obj_object(struct pmem_info *pip, const struct memory_block *m,
 	int vid = pip->args.obj.vobjects;
 	int v = pip->args.obj.vobjects;
 
+	/* the zones might be scanned by many threads, only counting is safe */
+	if (!outv_check(v))
+		return;
+
 	outv_indent(v, 1);
 	info_obj_object_hdr(pip, v, vid, m, objid);
 	outv_indent(v, -1);
@@ -372,12 +420,12 @@ info_obj_memblock_is_root(struct pmem_info *pip, const struct memory_block *m)
 static int
 info_obj_run_cb(const struct memory_block *m, void *arg)
 {
-	struct pmem_info *pip = arg;
+	struct info_obj_scan *scan = arg;
 
-	if (info_obj_memblock_is_root(pip, m))
+	if (info_obj_memblock_is_root(scan->pip, m))
 		return 0;
 
-	info_obj_object(pip, m, pip->obj.objid++);
+	info_obj_object(scan, m);
 
 	return 0;
 }
@@ -409,10 +457,11 @@ info_obj_class_stats_get_or_insert(struct pmem_obj_zone_stats *stats,
  * info_obj_chunk -- print chunk info
  */
 static void
-info_obj_chunk(struct pmem_info *pip, uint64_t c, uint64_t z,
-	struct chunk_header *chunk_hdr, struct chunk *chunk,
-	struct pmem_obj_zone_stats *stats)
+info_obj_chunk(struct info_obj_scan *scan, uint64_t c, uint64_t z,
+	struct chunk_header *chunk_hdr, struct chunk *chunk)
 {
+	struct pmem_info *pip = scan->pip;
+	struct pmem_obj_zone_stats *stats = scan->stats;
 	int v = pip->args.obj.vchunkhdr;
 	outv(v, "\n");
 	outv_field(v, "Chunk", "%lu", c);
@@ -444,7 +493,7 @@ info_obj_chunk(struct pmem_info *pip, uint64_t c, uint64_t z,
 
 			/* skip root object */
 			if (!info_obj_memblock_is_root(pip, &m)) {
-				info_obj_object(pip, &m, pip->obj.objid++);
+				info_obj_object(scan, &m);
 			}
 		}
 	} else if (chunk_hdr->type == CHUNK_TYPE_RUN) {
@@ -467,7 +516,8 @@ info_obj_chunk(struct pmem_info *pip, uint64_t c, uint64_t z,
 			return;
 		}
 
-		outv_field(v, "Block size", "%s",
+		if (outv_check(v))
+			outv_field(v, "Block size", "%s",
 				out_get_size_str(run->hdr.block_size,
 					pip->args.human));
 
@@ -484,7 +534,7 @@ info_obj_chunk(struct pmem_info *pip, uint64_t c, uint64_t z,
 
 		info_obj_run_bitmap(v && pip->args.obj.vbitmap, &bitmap);
 
-		m.m_ops->iterate_used(&m, info_obj_run_cb, pip);
+		m.m_ops->iterate_used(&m, info_obj_run_cb, scan);
 	}
 }
 
@@ -492,10 +542,13 @@ info_obj_chunk(struct pmem_info *pip, uint64_t c, uint64_t z,
  * info_obj_zone_chunks -- print chunk headers from specified zone
  */
 static void
-info_obj_zone_chunks(struct pmem_info *pip, struct zone *zone, uint64_t z,
-	struct pmem_obj_zone_stats *stats)
+info_obj_zone_chunks(struct info_obj_scan *scan, struct zone *zone, uint64_t z)
 {
+	struct pmem_info *pip = scan->pip;
+	struct pmem_obj_zone_stats *stats = scan->stats;
+
 	VEC_INIT(&stats->class_stats);
+	VEC_INIT(&stats->type_stats);
 
 	struct pmem_obj_class_stats default_class_stats = {0, 0,
 		CHUNKSIZE, 0, 0, 0};
@@ -513,9 +566,9 @@ info_obj_zone_chunks(struct pmem_info *pip, struct zone *zone, uint64_t z,
 				stats->size_chunks += size_idx;
 				stats->size_chunks_type[type] += size_idx;
 
-				info_obj_chunk(pip, c, z,
+				info_obj_chunk(scan, c, z,
 					&zone->chunk_headers[c],
-					&zone->chunks[c], stats);
+					&zone->chunks[c]);
 
 			}
 
@@ -523,9 +576,9 @@ info_obj_zone_chunks(struct pmem_info *pip, struct zone *zone, uint64_t z,
 				pip->args.obj.chunk_types &
 				(1 << CHUNK_TYPE_FOOTER)) {
 				size_t f = c + size_idx - 1;
-				info_obj_chunk(pip, f, z,
+				info_obj_chunk(scan, f, z,
 					&zone->chunk_headers[f],
-					&zone->chunks[f], stats);
+					&zone->chunks[f]);
 			}
 		}
 
@@ -560,6 +613,141 @@ info_obj_root_obj(struct pmem_info *pip)
 	info_obj_object_hdr(pip, v, VERBOSE_SILENT, &m, 0);
 }
 
+/*
+ * info_obj_stats_ctx -- zones scanned by many threads to collect statistics
+ */
+struct info_obj_stats_ctx {
+	struct pmem_info *pip;
+	struct heap_layout *layout;
+	uint64_t next;		/* index of the next zone to scan */
+};
+
+/*
+ * info_obj_stats_worker -- scan zones until there are none left
+ */
+static void *
+info_obj_stats_worker(void *arg)
+{
+	struct info_obj_stats_ctx *ctx = arg;
+	struct pmem_obj_stats *stats = &ctx->pip->obj.stats;
+
+	/* object ids are not printed, so they do not have to be unique */
+	uint64_t objid = 0;
+
+	uint64_t i;
+	while ((i = util_fetch_and_add64(&ctx->next, 1)) <
+			stats->n_zones_sampled) {
+		size_t z = stats->zones_sampled[i];
+		struct info_obj_scan scan = {ctx->pip,
+			&stats->zone_stats[z], &objid};
+
+		info_obj_zone_chunks(&scan, ZID_TO_ZONE(ctx->layout, z), z);
+	}
+
+	return NULL;
+}
+
+/*
+ * info_obj_sample_zones -- select zones the statistics are collected from
+ *
+ * The zones are picked at even intervals from all the used zones, so
+ * the sample is spread across the whole heap.
+ */
+static void
+info_obj_sample_zones(struct pmem_info *pip, struct heap_layout *layout)
+{
+	struct pmem_obj_stats *stats = &pip->obj.stats;
+
+	size_t *used = malloc(stats->n_zones * sizeof(*used));
+	if (!used)
+		err(1, "Cannot allocate memory for zone stats");
+
+	for (size_t i = 0; i < stats->n_zones; i++) {
+		struct zone *zone = ZID_TO_ZONE(layout, i);
+
+		if (util_ranges_contain(&pip->args.obj.zone_ranges, i) &&
+				zone->header.magic == ZONE_HEADER_MAGIC)
+			used[stats->n_zones_used++] = i;
+	}
+
+	uint64_t nused = stats->n_zones_used;
+	double exact = (double)nused * pip->args.obj.sample / 100.0;
+	uint64_t n = (uint64_t)exact;
+	if ((double)n < exact)
+		n++;
+	if (n > nused)
+		n = nused;
+
+	for (uint64_t k = 0; k < n; k++)
+		used[k] = used[(2 * k + 1) * nused / (2 * n)];
+
+	stats->n_zones_sampled = n;
+	stats->zones_sampled = used;
+}
+
+/*
+ * info_obj_zones_stats -- collect statistics from the sampled zones using
+ *	many threads
+ */
+static void
+info_obj_zones_stats(struct pmem_info *pip, struct heap_layout *layout)
+{
+	info_obj_sample_zones(pip, layout);
+
+	struct info_obj_stats_ctx ctx = {pip, layout, 0};
+
+	unsigned nthreads = pip->args.obj.jobs;
+	if (nthreads == 0) {
+		nthreads = INFO_OBJ_DEFAULT_JOBS;
+		long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+		if (ncpus > 0 && ncpus < nthreads)
+			nthreads = (unsigned)ncpus;
+	}
+	if (nthreads > pip->obj.stats.n_zones_sampled)
+		nthreads = (unsigned)pip->obj.stats.n_zones_sampled;
+
+	/* the calling thread is one of the workers */
+	os_thread_t threads[INFO_MAX_JOBS];
+	unsigned started = 0;
+	while (started + 1 < nthreads) {
+		if (os_thread_create(&threads[started], NULL,
+				info_obj_stats_worker, &ctx))
+			break;
+		started++;
+	}
+
+	info_obj_stats_worker(&ctx);
+
+	for (unsigned i = 0; i < started; ++i)
+		os_thread_join(&threads[i], NULL);
+}
+
+/*
+ * info_obj_stats_merge -- sum up objects' statistics of all zones
+ */
+static void
+info_obj_stats_merge(struct pmem_info *pip)
+{
+	struct pmem_obj_stats *stats = &pip->obj.stats;
+
+	for (size_t i = 0; i < stats->n_zones; i++) {
+		struct pmem_obj_zone_stats *zstats = &stats->zone_stats[i];
+
+		stats->n_total_objects += zstats->n_objects;
+		stats->n_total_bytes += zstats->n_bytes;
+
+		struct pmem_obj_zone_type_stats *ztype;
+		VEC_FOREACH_BY_PTR(ztype, &zstats->type_stats) {
+			struct pmem_obj_type_stats *type =
+				pmem_obj_stats_get_type(stats,
+					ztype->type_num);
+
+			type->n_objects += ztype->n_objects;
+			type->n_bytes += ztype->n_bytes;
+		}
+	}
+}
+
 /*
  * info_obj_zones -- print zones and chunks
  */
@@ -568,7 +756,8 @@ info_obj_zones_chunks(struct pmem_info *pip)
 {
 	if (!outv_check(pip->args.obj.vheap) &&
 		!outv_check(pip->args.vstats) &&
-		!outv_check(pip->args.obj.vobjects))
+		!outv_check(pip->args.obj.vobjects) &&
+		!pip->args.json)
 		return;
 
 	struct pmemobjpool *pop = pip->obj.pop;
@@ -580,6 +769,14 @@ info_obj_zones_chunks(struct pmem_info *pip)
 	if (!pip->obj.stats.zone_stats)
 		err(1, "Cannot allocate memory for zone stats");
 
+	/* nothing is printed while scanning zones for statistics only */
+	if (!outv_check(pip->args.obj.vheap) &&
+		!outv_check(pip->args.obj.vobjects)) {
+		info_obj_zones_stats(pip, layout);
+		info_obj_stats_merge(pip);
+		return;
+	}
+
 	for (size_t i = 0; i < maxzone; i++) {
 		struct zone *zone = ZID_TO_ZONE(layout, i);
 
@@ -597,12 +794,19 @@ info_obj_zones_chunks(struct pmem_info *pip)
 					pip->args.obj.vzonehdr,
 					&zone->header);
 
+			struct info_obj_scan scan = {pip,
+				&pip->obj.stats.zone_stats[i],
+				&pip->obj.objid};
+
 			outv_indent(vvv, 1);
-			info_obj_zone_chunks(pip, zone, i,
-					&pip->obj.stats.zone_stats[i]);
+			info_obj_zone_chunks(&scan, zone, i);
 			outv_indent(vvv, -1);
 		}
 	}
+
+	/* all the zones have been scanned */
+	pip->obj.stats.n_zones_sampled = pip->obj.stats.n_zones_used;
+	info_obj_stats_merge(pip);
 }
 
 /*
@@ -849,6 +1053,509 @@ info_obj_stats_zones(struct pmem_info *pip, int v, struct pmem_obj_stats *stats,
 	outv_indent(v, -1);
 }
 
+/*
+ * info_obj_estimate -- statistic extrapolated from the sampled zones to all
+ *	the used zones
+ */
+struct info_obj_estimate {
+	double value;
+	double error;	/* half-width of the 95% confidence interval */
+	int known;	/* the error can be estimated */
+};
+
+typedef double (*info_obj_zone_value_fn)(
+	const struct pmem_obj_zone_stats *zstats, const void *arg);
+
+/*
+ * info_obj_estimate -- extrapolate the sum of a value over all the used zones
+ *
+ * The sum is estimated from the mean value of the sampled zones, the error
+ * bound takes into account that the sample is drawn from a finite number
+ * of zones, so it is zero if all the zones have been scanned.
+ */
+static struct info_obj_estimate
+info_obj_estimate(const struct pmem_obj_stats *stats,
+	info_obj_zone_value_fn fn, const void *arg)
+{
+	struct info_obj_estimate e = {0.0, 0.0, 1};
+	uint64_t n = stats->n_zones_sampled;
+	uint64_t nused = stats->n_zones_used;
+
+	if (n == 0)
+		return e;
+
+	double sum = 0.0;
+	double sum_sq = 0.0;
+	for (uint64_t i = 0; i < n; i++) {
+		double x = fn(&stats->zone_stats[stats->zones_sampled[i]],
+				arg);
+		sum += x;
+		sum_sq += x * x;
+	}
+
+	double mean = sum / (double)n;
+	e.value = mean * (double)nused;
+
+	if (n == nused)
+		return e;
+
+	if (n < 2) {
+		e.known = 0;
+		return e;
+	}
+
+	double var = (sum_sq - sum * mean) / (double)(n - 1);
+	if (var < 0.0)
+		var = 0.0;
+
+	double fpc = 1.0 - (double)n / (double)nused;
+	e.error = INFO_OBJ_Z95 * (double)nused * sqrt(fpc * var / (double)n);
+
+	return e;
+}
+
+/*
+ * info_obj_zone_objects -- number of objects in the zone
+ */
+static double
+info_obj_zone_objects(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	return (double)zstats->n_objects;
+}
+
+/*
+ * info_obj_zone_bytes -- number of bytes of objects in the zone
+ */
+static double
+info_obj_zone_bytes(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	return (double)zstats->n_bytes;
+}
+
+/*
+ * info_obj_zone_type -- (internal) zone's stats of the given type number
+ */
+static const struct pmem_obj_zone_type_stats *
+info_obj_zone_type(const struct pmem_obj_zone_stats *zstats,
+	uint64_t type_num)
+{
+	const struct pmem_obj_zone_type_stats *type;
+	VEC_FOREACH_BY_PTR(type, &zstats->type_stats) {
+		if (type->type_num == type_num)
+			return type;
+	}
+
+	return NULL;
+}
+
+/*
+ * info_obj_zone_type_objects -- number of objects of the type in the zone
+ */
+static double
+info_obj_zone_type_objects(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	const struct pmem_obj_zone_type_stats *type =
+		info_obj_zone_type(zstats, *(const uint64_t *)arg);
+
+	return type ? (double)type->n_objects : 0.0;
+}
+
+/*
+ * info_obj_zone_type_bytes -- number of bytes of the type in the zone
+ */
+static double
+info_obj_zone_type_bytes(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	const struct pmem_obj_zone_type_stats *type =
+		info_obj_zone_type(zstats, *(const uint64_t *)arg);
+
+	return type ? (double)type->n_bytes : 0.0;
+}
+
+/*
+ * info_obj_zone_chunks_type -- number of chunks of the type in the zone,
+ *	all the chunks if the type is MAX_CHUNK_TYPE
+ */
+static double
+info_obj_zone_chunks_type(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	unsigned type = *(const unsigned *)arg;
+
+	return type == MAX_CHUNK_TYPE ? (double)zstats->n_chunks :
+		(double)zstats->n_chunks_type[type];
+}
+
+/*
+ * info_obj_zone_size_type -- size of the chunks of the type in the zone,
+ *	of all the chunks if the type is MAX_CHUNK_TYPE
+ */
+static double
+info_obj_zone_size_type(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	unsigned type = *(const unsigned *)arg;
+
+	return type == MAX_CHUNK_TYPE ? (double)zstats->size_chunks :
+		(double)zstats->size_chunks_type[type];
+}
+
+/*
+ * info_obj_zone_class -- (internal) zone's stats of the allocation class
+ */
+static const struct pmem_obj_class_stats *
+info_obj_zone_class(const struct pmem_obj_zone_stats *zstats,
+	const struct pmem_obj_class_stats *c)
+{
+	const struct pmem_obj_class_stats *cstats;
+	VEC_FOREACH_BY_PTR(cstats, &zstats->class_stats) {
+		if (cstats->alignment == c->alignment &&
+		    cstats->flags == c->flags &&
+		    cstats->nallocs == c->nallocs &&
+		    cstats->unit_size == c->unit_size)
+			return cstats;
+	}
+
+	return NULL;
+}
+
+/*
+ * info_obj_zone_class_units -- number of units of the class in the zone
+ */
+static double
+info_obj_zone_class_units(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	const struct pmem_obj_class_stats *cstats =
+		info_obj_zone_class(zstats, arg);
+
+	return cstats ? (double)cstats->n_units : 0.0;
+}
+
+/*
+ * info_obj_zone_class_used -- number of used units of the class in the zone
+ */
+static double
+info_obj_zone_class_used(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	const struct pmem_obj_class_stats *cstats =
+		info_obj_zone_class(zstats, arg);
+
+	return cstats ? (double)cstats->n_used : 0.0;
+}
+
+/*
+ * info_obj_zone_heap_bytes -- bytes of all the allocation classes' units
+ *	in the zone, only used ones if arg is not NULL
+ */
+static double
+info_obj_zone_heap_bytes(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	double bytes = 0.0;
+
+	const struct pmem_obj_class_stats *cstats;
+	VEC_FOREACH_BY_PTR(cstats, &zstats->class_stats) {
+		bytes += (double)cstats->unit_size *
+			(double)(arg ? cstats->n_used : cstats->n_units);
+	}
+
+	return bytes;
+}
+
+/*
+ * info_obj_zone_run_free_bytes -- bytes of free units of runs in the zone
+ */
+static double
+info_obj_zone_run_free_bytes(const struct pmem_obj_zone_stats *zstats,
+	const void *arg)
+{
+	double bytes = 0.0;
+
+	/* chunks not divided into runs have no number of allocations */
+	const struct pmem_obj_class_stats *cstats;
+	VEC_FOREACH_BY_PTR(cstats, &zstats->class_stats) {
+		if (cstats->nallocs != 0)
+			bytes += (double)cstats->unit_size *
+				(double)(cstats->n_units - cstats->n_used);
+	}
+
+	return bytes;
+}
+
+/*
+ * info_obj_stats_sampled_classes -- sum up allocation classes of the sampled
+ *	zones, to get the list of all the classes
+ */
+static void
+info_obj_stats_sampled_classes(struct pmem_obj_stats *stats,
+	struct pmem_obj_zone_stats *total)
+{
+	for (uint64_t i = 0; i < stats->n_zones_sampled; i++)
+		info_obj_add_zone_stats(total,
+			&stats->zone_stats[stats->zones_sampled[i]]);
+}
+
+/*
+ * info_obj_heap_ratios -- estimate utilization of the heap and its
+ *	fragmentation, i.e. the part of the free space which is held by runs
+ *	and cannot be used for allocations of other sizes
+ */
+static void
+info_obj_heap_ratios(struct pmem_obj_stats *stats, double *utilization,
+	double *fragmentation)
+{
+	static const int used = 1;
+
+	double total = info_obj_estimate(stats, info_obj_zone_heap_bytes,
+			NULL).value;
+	double used_bytes = info_obj_estimate(stats,
+			info_obj_zone_heap_bytes, &used).value;
+	double run_free = info_obj_estimate(stats,
+			info_obj_zone_run_free_bytes, NULL).value;
+
+	double free_bytes = total - used_bytes;
+
+	*utilization = total > 0.0 ? used_bytes / total : 0.0;
+	*fragmentation = free_bytes > 0.0 ? run_free / free_bytes : 0.0;
+}
+
+/*
+ * info_obj_estimate_str -- string representation of the estimate
+ */
+static const char *
+info_obj_estimate_str(struct info_obj_estimate e)
+{
+	static char str_buff[INFO_OBJ_ESTIMATE_STR_MAX];
+
+	int ret;
+	if (e.known)
+		ret = util_snprintf(str_buff, sizeof(str_buff),
+			"%.0f +/- %.0f", e.value, e.error);
+	else
+		ret = util_snprintf(str_buff, sizeof(str_buff),
+			"%.0f +/- ?", e.value);
+
+	if (ret < 0)
+		return "";
+
+	return str_buff;
+}
+
+/*
+ * info_obj_stats_estimated -- print statistics estimated from the sample
+ *	of zones
+ */
+static void
+info_obj_stats_estimated(struct pmem_info *pip, int v)
+{
+	struct pmem_obj_stats *stats = &pip->obj.stats;
+
+	outv_title(v, "Statistics (estimated)");
+
+	double sampled_perc = 100.0 * (double)stats->n_zones_sampled /
+		(double)stats->n_zones_used;
+	outv_field(v, "Sampled zones", "%" PRIu64 " of %" PRIu64 " [%s]",
+		stats->n_zones_sampled, stats->n_zones_used,
+		out_get_percentage(sampled_perc));
+	outv_field(v, "Confidence level", "95%%");
+
+	outv_title(v, "Objects");
+	outv_field(v, "Number of objects", "%s", info_obj_estimate_str(
+		info_obj_estimate(stats, info_obj_zone_objects, NULL)));
+	outv_field(v, "Number of bytes", "%s", info_obj_estimate_str(
+		info_obj_estimate(stats, info_obj_zone_bytes, NULL)));
+
+	outv_title(v, "Objects by type");
+
+	outv_indent(v, 1);
+	struct pmem_obj_type_stats *type_stats;
+	PMDK_TAILQ_FOREACH(type_stats, &stats->type_stats, next) {
+		if (!type_stats->n_objects)
+			continue;
+
+		const uint64_t *type_num = &type_stats->type_num;
+
+		outv_nl(v);
+		outv_field(v, "Type number", "%lu", *type_num);
+		outv_field(v, "Number of objects", "%s",
+			info_obj_estimate_str(info_obj_estimate(stats,
+				info_obj_zone_type_objects, type_num)));
+		outv_field(v, "Number of bytes", "%s",
+			info_obj_estimate_str(info_obj_estimate(stats,
+				info_obj_zone_type_bytes, type_num)));
+	}
+	outv_indent(v, -1);
+
+	outv_title(v, "Chunks statistics");
+	unsigned all = MAX_CHUNK_TYPE;
+	outv_field(v, "Number of chunks", "%s", info_obj_estimate_str(
+		info_obj_estimate(stats, info_obj_zone_chunks_type, &all)));
+
+	outv_indent(v, 1);
+	for (unsigned type = 0; type < MAX_CHUNK_TYPE; type++) {
+		struct info_obj_estimate e = info_obj_estimate(stats,
+			info_obj_zone_chunks_type, &type);
+		if (e.value > 0.0)
+			outv_field(v, out_get_chunk_type_str(type), "%s",
+				info_obj_estimate_str(e));
+	}
+	outv_indent(v, -1);
+
+	outv_title(v, "Allocation classes");
+
+	struct pmem_obj_zone_stats total;
+	memset(&total, 0, sizeof(total));
+	info_obj_stats_sampled_classes(stats, &total);
+
+	outv_indent(v, 1);
+	struct pmem_obj_class_stats *cstats;
+	VEC_FOREACH_BY_PTR(cstats, &total.class_stats) {
+		if (cstats->n_units == 0)
+			continue;
+
+		outv_nl(v);
+		outv_field(v, "Unit size", "%s", out_get_size_str(
+					cstats->unit_size, pip->args.human));
+		outv_field(v, "Units", "%s", info_obj_estimate_str(
+			info_obj_estimate(stats, info_obj_zone_class_units,
+				cstats)));
+		outv_field(v, "Used units", "%s", info_obj_estimate_str(
+			info_obj_estimate(stats, info_obj_zone_class_used,
+				cstats)));
+	}
+	outv_indent(v, -1);
+	VEC_DELETE(&total.class_stats);
+
+	double utilization;
+	double fragmentation;
+	info_obj_heap_ratios(stats, &utilization, &fragmentation);
+
+	outv_nl(v);
+	outv_field(v, "Utilization", "%s",
+		out_get_percentage(100.0 * utilization));
+	outv_field(v, "Fragmentation", "%s",
+		out_get_percentage(100.0 * fragmentation));
+}
+
+/*
+ * info_obj_json_estimate -- print the estimate as a JSON object
+ */
+static void
+info_obj_json_estimate(const char *name, struct info_obj_estimate e,
+	const char *sep)
+{
+	if (e.known)
+		printf("\"%s\": {\"value\": %.0f, \"error\": %.0f}%s", name,
+			e.value, e.error, sep);
+	else
+		printf("\"%s\": {\"value\": %.0f, \"error\": null}%s", name,
+			e.value, sep);
+}
+
+/*
+ * info_obj_stats_json -- print statistics in JSON format
+ *
+ * Every value is printed along with the half-width of its 95% confidence
+ * interval, which is zero unless the statistics are collected from
+ * a sample of zones.
+ */
+static void
+info_obj_stats_json(struct pmem_info *pip)
+{
+	struct pmem_obj_stats *stats = &pip->obj.stats;
+
+	printf("{\n");
+	printf("  \"zones\": %" PRIu64 ",\n", stats->n_zones);
+	printf("  \"used_zones\": %" PRIu64 ",\n", stats->n_zones_used);
+	printf("  \"sampled_zones\": %" PRIu64 ",\n", stats->n_zones_sampled);
+	printf("  \"confidence_level\": 0.95,\n");
+
+	printf("  \"objects\": {");
+	info_obj_json_estimate("count", info_obj_estimate(stats,
+		info_obj_zone_objects, NULL), ", ");
+	info_obj_json_estimate("bytes", info_obj_estimate(stats,
+		info_obj_zone_bytes, NULL), "},\n");
+
+	printf("  \"types\": [");
+	const char *sep = "\n";
+	struct pmem_obj_type_stats *type_stats;
+	PMDK_TAILQ_FOREACH(type_stats, &stats->type_stats, next) {
+		if (!type_stats->n_objects)
+			continue;
+
+		const uint64_t *type_num = &type_stats->type_num;
+		printf("%s    {\"type_num\": %" PRIu64 ", ", sep, *type_num);
+		info_obj_json_estimate("count", info_obj_estimate(stats,
+			info_obj_zone_type_objects, type_num), ", ");
+		info_obj_json_estimate("bytes", info_obj_estimate(stats,
+			info_obj_zone_type_bytes, type_num), "}");
+		sep = ",\n";
+	}
+	printf("%s],\n", sep[0] == ',' ? "\n  " : "");
+
+	unsigned all = MAX_CHUNK_TYPE;
+	printf("  \"chunks\": {\n    ");
+	info_obj_json_estimate("count", info_obj_estimate(stats,
+		info_obj_zone_chunks_type, &all), ",\n    ");
+	info_obj_json_estimate("size", info_obj_estimate(stats,
+		info_obj_zone_size_type, &all), "");
+	for (unsigned type = 0; type < MAX_CHUNK_TYPE; type++) {
+		/* there are no chunks of these types */
+		if (type == CHUNK_TYPE_UNKNOWN || type == CHUNK_TYPE_RUN_DATA)
+			continue;
+
+		printf(",\n    \"%s\": {", out_get_chunk_type_str(type));
+		info_obj_json_estimate("count", info_obj_estimate(stats,
+			info_obj_zone_chunks_type, &type), ", ");
+		info_obj_json_estimate("size", info_obj_estimate(stats,
+			info_obj_zone_size_type, &type), "}");
+	}
+	printf("\n  },\n");
+
+	struct pmem_obj_zone_stats total;
+	memset(&total, 0, sizeof(total));
+	info_obj_stats_sampled_classes(stats, &total);
+
+	printf("  \"alloc_classes\": [");
+	sep = "\n";
+	struct pmem_obj_class_stats *cstats;
+	VEC_FOREACH_BY_PTR(cstats, &total.class_stats) {
+		if (cstats->n_units == 0)
+			continue;
+
+		printf("%s    {\"unit_size\": %" PRIu64
+			", \"alignment\": %" PRIu64 ", ", sep,
+			cstats->unit_size, cstats->alignment);
+		info_obj_json_estimate("units", info_obj_estimate(stats,
+			info_obj_zone_class_units, cstats), ", ");
+		info_obj_json_estimate("used_units", info_obj_estimate(stats,
+			info_obj_zone_class_used, cstats), "}");
+		sep = ",\n";
+	}
+	printf("%s],\n", sep[0] == ',' ? "\n  " : "");
+	VEC_DELETE(&total.class_stats);
+
+	static const int used = 1;
+	printf("  ");
+	info_obj_json_estimate("heap_bytes", info_obj_estimate(stats,
+		info_obj_zone_heap_bytes, NULL), ",\n  ");
+	info_obj_json_estimate("heap_used_bytes", info_obj_estimate(stats,
+		info_obj_zone_heap_bytes, &used), ",\n");
+
+	double utilization;
+	double fragmentation;
+	info_obj_heap_ratios(stats, &utilization, &fragmentation);
+	printf("  \"utilization\": %.4f,\n", utilization);
+	printf("  \"fragmentation\": %.4f\n", fragmentation);
+	printf("}\n");
+}
+
 /*
  * info_obj_stats -- print statistics
  */
@@ -857,10 +1564,20 @@ info_obj_stats(struct pmem_info *pip)
 {
 	int v = pip->args.vstats;
 
+	if (pip->args.json) {
+		info_obj_stats_json(pip);
+		return;
+	}
+
 	if (!outv_check(v))
 		return;
 
 	struct pmem_obj_stats *stats = &pip->obj.stats;
+	if (stats->n_zones_sampled < stats->n_zones_used) {
+		info_obj_stats_estimated(pip, v);
+		return;
+	}
+
 	struct pmem_obj_zone_stats total;
 	memset(&total, 0, sizeof(total));
 
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2014-2023, Intel Corporation */
+/* Copyright 2014-2026, Intel Corporation */
 
 /*
  * pmempool.c -- pmempool main source file
@@ -23,6 +23,7 @@
 #include "synchronize.h"
 #include "transform.h"
 #include "feature.h"
+#include "backup.h"
 #include "set.h"
 #include "pmemcommon.h"
 
@@ -144,6 +145,18 @@ static const struct command commands[] = {
 		.func = pmempool_feature_func,
 		.help = pmempool_feature_help,
 	},
+	{
+		.name = "backup",
+		.brief = "create a full or incremental backup of a pool",
+		.func = pmempool_backup_func,
+		.help = pmempool_backup_help,
+	},
+	{
+		.name = "restore",
+		.brief = "apply an incremental backup to a backup",
+		.func = pmempool_restore_func,
+		.help = pmempool_restore_help,
+	},
 	{
 		.name = "help",
 		.brief = "print help text about a command",
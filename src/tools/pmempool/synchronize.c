@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2016-2018, Intel Corporation */
+/* Copyright 2016-2026, Intel Corporation */
 
 /*
  * synchronize.c -- pmempool sync command source file
@@ -45,6 +45,8 @@ static const char * const help_str =
 "Common options:\n"
 "  -b, --bad-blocks     fix bad blocks - it requires creating or reading special recovery files\n"
 "  -d, --dry-run        do not apply changes, only check for viability of synchronization\n"
+"  -D, --differential   copy only the data which differs between the replicas\n"
+"  -o, --online         only recreate the replicas, the data is copied once the pool is opened\n"
 "  -v, --verbose        increase verbosity level\n"
 "  -h, --help           display this help and exit\n"
 "\n"
@@ -57,7 +59,9 @@ static const char * const help_str =
 static const struct option long_options[] = {
 	{"bad-blocks",	no_argument,		NULL,	'b'},
 	{"dry-run",	no_argument,		NULL,	'd'},
+	{"differential", no_argument,		NULL,	'D'},
 	{"help",	no_argument,		NULL,	'h'},
+	{"online",	no_argument,		NULL,	'o'},
 	{"verbose",	no_argument,		NULL,	'v'},
 	{NULL,		0,			NULL,	 0 },
 };
@@ -99,7 +103,7 @@ pmempool_sync_parse_args(struct pmempool_sync_context *ctx, const char *appname,
 		int argc, char *argv[])
 {
 	int opt;
-	while ((opt = getopt_long(argc, argv, "bdhv",
+	while ((opt = getopt_long(argc, argv, "bdDhov",
 			long_options, NULL)) != -1) {
 		switch (opt) {
 		case 'd':
@@ -108,6 +112,12 @@ pmempool_sync_parse_args(struct pmempool_sync_context *ctx, const char *appname,
 		case 'b':
 			ctx->flags |= PMEMPOOL_SYNC_FIX_BAD_BLOCKS;
 			break;
+		case 'D':
+			ctx->flags |= PMEMPOOL_SYNC_DIFFERENTIAL;
+			break;
+		case 'o':
+			ctx->flags |= PMEMPOOL_SYNC_ONLINE_REBUILD;
+			break;
 		case 'h':
 			pmempool_sync_help(appname);
 			exit(EXIT_SUCCESS);
@@ -1,6 +1,7 @@
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2018-2021, Intel Corporation
+# Copyright 2018-2026, Intel Corporation
 
+from binarytrace import NativeReplay
 from loggingfacility import LoggingBase
 from reorderexceptions import InconsistentFileException
 from sys import byteorder
@@ -17,9 +18,13 @@ class BinaryOutputHandler:
 
     :ivar _files: A list of registered files, most recent last.
     :type _files: list
+    :ivar _jobs: Number of threads of the native replay, None if disabled.
+    :type _jobs: int
+    :ivar _native: The native replay of the checked file.
+    :type _native: :class:`binarytrace.NativeReplay`
     """
 
-    def __init__(self, checker, logger=None):
+    def __init__(self, checker, logger=None, jobs=None):
         """
         Binary handler constructor.
 
@@ -27,10 +32,15 @@ class BinaryOutputHandler:
         :type checker: ConsistencyCheckerBase
         :param logger: logger handle, default: empty logger (LoggingBase)
         :type logger: subclass of :class:`LoggingBase`
+        :param jobs: number of threads of the native replay, default: None
+        :type jobs: int
         """
         self._files = []
         self._checker = checker
         self._logger = logger or LoggingBase()
+        self._jobs = jobs
+        self._native = None
+        self._native_file = None
 
     def add_file(self, file, map_base, size):
         """
@@ -106,6 +116,43 @@ class BinaryOutputHandler:
                 "No suitable file found for store {}".format(store_op)
             )
 
+    def replay(self, stores, sequences):
+        """
+        Checks the sequences of stores in parallel using the native engine.
+
+        The native replay is possible only if exactly one file is
+        registered, otherwise the sequences have to be replayed using
+        :func:`do_store`, :func:`check_consistency` and :func:`do_revert`.
+
+        :param stores: The stores the sequences consist of.
+        :type stores: list of :class:`memoryoperations.Store`
+        :param sequences: The sequences to be checked.
+        :type sequences: iterable of tuples of stores
+        :return: Iterable of sequences with the consistency error or None,
+            None if the native replay is not possible.
+        :rtype: iterable
+        """
+        if self._jobs is None:
+            return None
+
+        if len(self._files) != 1:
+            self._logger.warning(
+                "Parallel replay requires exactly one registered file, "
+                "replaying sequentially"
+            )
+            self._jobs = None
+            return None
+
+        bf = self._files[0]
+        if self._native_file is not bf:
+            self._native = NativeReplay(bf._file_name, bf.get_base_address(),
+                                        self._jobs, self._checker)
+            self._native_file = bf
+
+        error = InconsistentFileException("File {} inconsistent".format(bf))
+        return ((seq, None if consistent else error) for seq, consistent in
+                self._native.replay(stores, sequences))
+
     def check_consistency(self):
         """
         Checks consistency of each registered file.
@@ -0,0 +1,259 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2026, Intel Corporation
+
+from ctypes import CDLL, c_char_p, c_int, c_uint, c_void_p, c_size_t
+from ctypes import get_errno, POINTER, c_uint32, c_uint64
+from itertools import islice
+import memoryoperations as memops
+import mmap
+import os
+import struct
+
+TRACE_SIG = b"PMRTRACE"
+TRACE_MAJOR = 1
+
+# see struct trace_hdr and struct trace_record in pmreorder.h
+HDR_FORMAT = struct.Struct("<8sIIQQQQ16x")
+RECORD_FORMAT = struct.Struct("<HHIQQQ")
+STORE_FORMAT = struct.Struct("<QQQ")
+
+TRACE_STORE = 1
+TRACE_FLUSH = 2
+TRACE_FENCE = 3
+TRACE_STRING = 4
+TRACE_F_STACK = 1
+
+LIBRARY_NAME = "libpmreorder.so"
+
+_library = None
+
+
+def native_library():
+    """
+    Loads the native part of pmreorder, which is installed next to
+    the python files.
+
+    :return: The library handle or None if it is not available.
+    :rtype: ctypes.CDLL
+    """
+    global _library
+    if _library is not None:
+        return _library
+
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        LIBRARY_NAME)
+    try:
+        lib = CDLL(path, use_errno=True)
+    except OSError:
+        return None
+
+    lib.pmreorder_trace_convert.argtypes = [c_char_p, c_char_p]
+    lib.pmreorder_trace_convert.restype = c_int
+    lib.pmreorder_replay_new.argtypes = [c_char_p, c_uint, c_char_p,
+                                         c_char_p, c_char_p]
+    lib.pmreorder_replay_new.restype = c_void_p
+    lib.pmreorder_replay_run.argtypes = [c_void_p, c_char_p, c_char_p,
+                                         POINTER(c_uint32),
+                                         POINTER(c_uint64), c_size_t,
+                                         POINTER(c_int)]
+    lib.pmreorder_replay_run.restype = c_int
+    lib.pmreorder_replay_delete.argtypes = [c_void_p]
+    lib.pmreorder_replay_delete.restype = None
+    _library = lib
+    return lib
+
+
+def is_binary_trace(path):
+    """
+    Checks if the file is a binary trace.
+
+    :param path: Path of the log file.
+    :type path: str
+    :return: True if the file starts with the binary trace signature.
+    :rtype: bool
+    """
+    with open(path, "rb") as f:
+        return f.read(len(TRACE_SIG)) == TRACE_SIG
+
+
+def convert(log_file, trace_file):
+    """
+    Converts the pmemcheck store log to the binary trace, unless
+    the trace is already newer than the log.
+
+    :param log_file: Path of the pmemcheck store log.
+    :type log_file: str
+    :param trace_file: Path of the binary trace.
+    :type trace_file: str
+    :return: None
+    :raises: OSError if the conversion fails.
+    """
+    if os.path.exists(trace_file) and is_binary_trace(trace_file) and \
+            os.path.getmtime(trace_file) >= os.path.getmtime(log_file):
+        return
+
+    lib = native_library()
+    if lib is None:
+        raise OSError("{} not found, cannot create the binary trace"
+                      .format(LIBRARY_NAME))
+
+    if lib.pmreorder_trace_convert(log_file.encode(),
+                                   trace_file.encode()) != 0:
+        errno = get_errno()
+        raise OSError(errno, "cannot convert {} to {}".format(
+            log_file, trace_file))
+
+
+class BinaryTrace:
+    """
+    Reads the operations from the memory mapped binary trace.
+
+    Every token of the store log has its record in the trace, stores,
+    flushes and fences are decoded, all the other tokens are kept as
+    strings and are handled by :class:`operationfactory.OperationFactory`.
+
+    :ivar _map: The mapped trace file.
+    :type _map: mmap.mmap
+    """
+
+    def __init__(self, trace_file):
+        """
+        Maps the trace file and validates its header.
+
+        :param trace_file: Path of the binary trace.
+        :type trace_file: str
+        :return: None
+        """
+        with open(trace_file, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        (sig, major, record_size, self._nrecords, self._records_off,
+         self._data_off, self._data_size) = HDR_FORMAT.unpack_from(self._map)
+        if sig != TRACE_SIG or major != TRACE_MAJOR or \
+                record_size != RECORD_FORMAT.size:
+            raise ValueError("{} is not a supported binary trace"
+                             .format(trace_file))
+
+    def operations(self):
+        """
+        Returns all the tokens of the trace.
+
+        :return: Store, Flush and Fence objects for the decoded operations
+            and strings for the rest of the tokens.
+        :rtype: list
+        """
+        data = memoryview(self._map)
+        records = data[self._records_off:
+                       self._records_off +
+                       self._nrecords * RECORD_FORMAT.size]
+        ops = []
+        fence = memops.Fence()
+        for (type_, flags, length, addr, size, off) in \
+                RECORD_FORMAT.iter_unpack(records):
+            if type_ == TRACE_STORE:
+                value = bytes(data[off:off + size])
+                trace = None
+                if flags & TRACE_F_STACK:
+                    trace = bytes(data[off + size:off + size + length]) \
+                        .decode().split(";")
+                ops.append(memops.Store.from_values(addr, value, trace))
+            elif type_ == TRACE_FLUSH:
+                ops.append(memops.Flush.from_values(addr, size))
+            elif type_ == TRACE_FENCE:
+                ops.append(fence)
+            else:
+                ops.append(bytes(data[off:off + length]).decode())
+
+        return ops
+
+
+class NativeReplay:
+    """
+    Replays the reordered sequences of stores using the native engine.
+
+    Every sequence is written to a copy-on-write image of the file and
+    checked there, the sequences are checked by a pool of threads.
+
+    :ivar _handle: The native replay handle.
+    :ivar _base: Base address of the mapped file.
+    :type _base: int
+    :ivar _batch: Number of sequences passed to the engine at once.
+    :type _batch: int
+    """
+
+    def __init__(self, file_name, map_base, jobs, checker):
+        """
+        Prepares the replay of the stores to the file.
+
+        :param file_name: Full path of the checked file.
+        :type file_name: str
+        :param map_base: Base address of the mapped file.
+        :type map_base: int
+        :param jobs: Number of the worker threads.
+        :type jobs: int
+        :param checker: consistency checker object
+        :type checker: ConsistencyCheckerBase
+        :return: None
+        """
+        self._lib = native_library()
+        prog, lib, func = checker.native_args()
+        self._handle = self._lib.pmreorder_replay_new(
+            file_name.encode(), jobs, prog and prog.encode(),
+            lib and lib.encode(), func and func.encode())
+        if not self._handle:
+            raise OSError(get_errno(), "cannot prepare the replay of {}"
+                          .format(file_name))
+        self._base = map_base
+        self._batch = 64 * jobs
+
+    def __del__(self):
+        if getattr(self, "_handle", None):
+            self._lib.pmreorder_replay_delete(self._handle)
+            self._handle = None
+
+    def replay(self, stores, sequences):
+        """
+        Checks the consistency of the file after each of the sequences.
+
+        :param stores: The stores the sequences consist of.
+        :type stores: list of :class:`memoryoperations.Store`
+        :param sequences: The sequences to be checked.
+        :type sequences: iterable of tuples of stores
+        :return: Yields each sequence with the result of the check,
+            True if the file is consistent.
+        :rtype: iterable
+        """
+        index = {}
+        table = bytearray()
+        values = bytearray()
+        for i, st in enumerate(stores):
+            index[id(st)] = i
+            table += STORE_FORMAT.pack(st.address - self._base, st.size,
+                                       len(values))
+            values += st.new_value
+        table = bytes(table)
+        values = bytes(values)
+
+        sequences = iter(sequences)
+        while True:
+            batch = list(islice(sequences, self._batch))
+            if not batch:
+                break
+
+            seqs = [index[id(op)] for seq in batch for op in seq]
+            ends = []
+            end = 0
+            for seq in batch:
+                end += len(seq)
+                ends.append(end)
+
+            results = (c_int * len(batch))()
+            ret = self._lib.pmreorder_replay_run(
+                self._handle, table, values,
+                (c_uint32 * max(len(seqs), 1))(*seqs),
+                (c_uint64 * len(ends))(*ends), len(batch), results)
+            if ret != 0:
+                raise OSError(get_errno(), "replay of the stores failed")
+
+            for seq, result in zip(batch, results):
+                yield seq, result == 0
@@ -1,5 +1,5 @@
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2018-2022, Intel Corporation
+# Copyright 2018-2026, Intel Corporation
 
 import subprocess  # nosec
 from ctypes import cdll, c_char_p, c_int
@@ -19,6 +19,15 @@ class ConsistencyCheckerBase:
     def check_consistency(self, filename):
         pass
 
+    def native_args(self):
+        """
+        Returns the description of the checker for the native replay.
+
+        :return: The checker command, the library and the function name.
+        :rtype: tuple
+        """
+        raise NotImplementedError
+
 
 class LibChecker(ConsistencyCheckerBase):
     """
@@ -78,6 +87,15 @@ class LibChecker(ConsistencyCheckerBase):
         )
         return self._lib_func(filename)
 
+    def native_args(self):
+        """
+        Override from :class:`ConsistencyCheckerBase`.
+
+        The native replay calls the function in a child process forked
+        for each check, so it does not have to be thread-safe.
+        """
+        return (None, self._lib_name, self._lib_func_name)
+
 
 class ProgChecker(ConsistencyCheckerBase):
     """
@@ -130,6 +148,12 @@ class ProgChecker(ConsistencyCheckerBase):
         """
         return subprocess.call(cmd, shell=True)  # nosec
 
+    def native_args(self):
+        """
+        Override from :class:`ConsistencyCheckerBase`.
+        """
+        return ("{0} {1}".format(self._bin_path, self._bin_cmd), None, None)
+
 
 def get_checker(checker_type, checker_path_args, func_name, logger=None):
     """
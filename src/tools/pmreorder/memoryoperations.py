@@ -1,5 +1,5 @@
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2018-2021, Intel Corporation
+# Copyright 2018-2026, Intel Corporation
 
 from utils import Rangeable
 from utils import range_cmp
@@ -69,13 +69,19 @@ class Store(BaseOperation, Rangeable):
         """
         params = values.split(";")
         # calculate the offset given the registered file mapping
-        self.address = int(params[1], 16)
-        self.size = int(params[3], 16)
-        self.new_value = int(params[2], 16).to_bytes(
-            self.size, byteorder=byteorder
+        size = int(params[3], 16)
+        self._init(
+            int(params[1], 16),
+            int(params[2], 16).to_bytes(size, byteorder=byteorder),
+            params[4:] if len(params) > 4 else None,
         )
-        if len(params) > 4:
-            self.trace = StackTrace(params[4:])
+
+    def _init(self, address, new_value, trace):
+        self.address = address
+        self.size = len(new_value)
+        self.new_value = new_value
+        if trace is not None:
+            self.trace = StackTrace(trace)
         else:
             self.trace = StackTrace(
                 [
@@ -85,6 +91,24 @@ class Store(BaseOperation, Rangeable):
         self.old_value = None
         self.flushed = False
 
+    @classmethod
+    def from_values(cls, address, new_value, trace):
+        """
+        Creates the store from the already decoded values.
+
+        :param address: The virtual address of the store.
+        :type address: int
+        :param new_value: The value to be written.
+        :type new_value: bytes
+        :param trace: The stack trace frames or None if not available.
+        :type trace: list of str
+        :return: New Store object.
+        :rtype: Store
+        """
+        store = cls.__new__(cls)
+        store._init(address, new_value, trace)
+        return store
+
     def __str__(self):
         return (
             "Store: addr: {0}, size: {1}, val: {2}, stack trace: {3}".format(
@@ -170,6 +194,23 @@ class Flush(FlushBase):
         self._address = int(params[1], 16)
         self._size = int(params[2], 16)
 
+    @classmethod
+    def from_values(cls, address, size):
+        """
+        Creates the flush from the already decoded values.
+
+        :param address: Virtual address of the flush.
+        :type address: int
+        :param size: The size of the flush in bytes.
+        :type size: int
+        :return: New Flush object.
+        :rtype: Flush
+        """
+        flush = cls.__new__(cls)
+        flush._address = address
+        flush._size = size
+        return flush
+
     def __str__(self):
         return "Flush: addr: {0} size: {1}".format(
             hex(self._address), hex(self._size)
@@ -1,8 +1,9 @@
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2018-2022, Intel Corporation
+# Copyright 2018-2026, Intel Corporation
 
 from operationfactory import OperationFactory
 from binaryoutputhandler import BinaryOutputHandler
+import binarytrace
 import reorderengines
 import memoryoperations
 from itertools import repeat
@@ -25,24 +26,38 @@ class OpsContext:
     :ivar file_handler: The file handler used.
     """
 
-    def __init__(self, log_file, checker, logger, arg_engine, markers):
+    def __init__(self, log_file, checker, logger, arg_engine, markers,
+                 trace_file=None, jobs=None):
         """
         Splits the operations in the log file and sets the instance variables
         to default values.
 
-        :param log_file: The full name of the log file.
+        :param log_file: The full name of the log file or the binary trace.
         :type log_file: str
+        :param trace_file: The binary trace to be created from the log
+            file (or reused, if it is up to date) and processed instead.
+        :type trace_file: str
+        :param jobs: Number of threads of the native replay.
+        :type jobs: int
         :return: None
         """
-        # TODO reading the whole file at once is rather naive
-        # change in the future
-        self._operations = open(log_file).read().split("|")
+        if trace_file is not None:
+            binarytrace.convert(log_file, trace_file)
+            log_file = trace_file
+
+        if binarytrace.is_binary_trace(log_file):
+            self._operations = \
+                binarytrace.BinaryTrace(log_file).operations()
+        else:
+            # TODO reading the whole file at once is rather naive
+            # change in the future
+            self._operations = open(log_file).read().split("|")
         engine = reorderengines.get_engine(arg_engine)
         self.reorder_engine = engine
         self.test_on_barrier = engine.test_on_barrier
         self.default_engine = self.reorder_engine
         self.default_barrier = self.default_engine.test_on_barrier
-        self.file_handler = BinaryOutputHandler(checker, logger)
+        self.file_handler = BinaryOutputHandler(checker, logger, jobs)
         self.checker = checker
         self.logger = logger
         self.markers = markers
@@ -57,17 +72,19 @@ class OpsContext:
         :return: list of subclasses of :class:`memoryoperations.BaseOperation`
         """
         enumerated_ops = list(enumerate(self._operations))
+        # operations decoded from the binary trace are already objects
+        enumerated_strs = [e for e in enumerated_ops if isinstance(e[1], str)]
         markers = list(
             filter(
                 lambda e: e[1].endswith(".BEGIN") or e[1].endswith(".END"),
-                enumerated_ops,
+                enumerated_strs,
             )
         )
         operation_ids = list(enumerated_ops)
 
         stop_index = start_index = 0
 
-        for i, elem in enumerated_ops:
+        for i, elem in enumerated_strs:
             if "START" in elem:
                 start_index = i
             elif "STOP" in elem:
@@ -75,7 +92,7 @@ class OpsContext:
 
         operations = list(
             map(
-                OperationFactory.create_operation,
+                self._create_operation,
                 self._operations[start_index + 1: stop_index],
                 repeat(self.markers),
                 repeat(self.stack_engines),
@@ -83,3 +100,13 @@ class OpsContext:
         )
 
         return (operations, operation_ids, markers)
+
+    @staticmethod
+    def _create_operation(operation, markers, stack):
+        """
+        Creates the operation object, unless it is already decoded.
+        """
+        if isinstance(operation, str):
+            return OperationFactory.create_operation(operation, markers,
+                                                     stack)
+        return operation
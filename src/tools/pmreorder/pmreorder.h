@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * pmreorder.h -- native part of pmreorder: binary store traces and
+ *	the parallel replay engine, used from python through ctypes
+ */
+
+#ifndef PMREORDER_H
+#define PMREORDER_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "the binary trace format is little-endian"
+#endif
+
+#define TRACE_SIG "PMRTRACE"
+#define TRACE_SIG_LEN 8
+#define TRACE_MAJOR 1
+
+/*
+ * The binary trace holds one record for each '|' separated token of
+ * the pmemcheck store log, so the positions of the operations are the same
+ * in both formats. Stores, flushes and fences are decoded, every other
+ * token (markers, file registrations, START/STOP) is kept as a string
+ * and interpreted by the python code.
+ *
+ * Layout: header | data area | records (aligned to 8 bytes)
+ */
+enum trace_type {
+	TRACE_STORE = 1,
+	TRACE_FLUSH = 2,
+	TRACE_FENCE = 3,
+	TRACE_STRING = 4,
+};
+
+/* the store record has the stack trace after the value */
+#define TRACE_F_STACK (1 << 0)
+
+struct trace_hdr {
+	char signature[TRACE_SIG_LEN];
+	uint32_t major;
+	uint32_t record_size;
+	uint64_t nrecords;
+	uint64_t records_off;
+	uint64_t data_off;
+	uint64_t data_size;
+	uint64_t unused[2];
+};
+
+struct trace_record {
+	uint16_t type;
+	uint16_t flags;
+	uint32_t len;	/* length of the string or of the stack trace */
+	uint64_t addr;
+	uint64_t size;
+	uint64_t data;	/* offset of the value and the string in data area */
+};
+
+/*
+ * pmreorder_store -- a store to be replayed, at the offset of the checked
+ *	file, its value is at value_off in the values buffer
+ */
+struct pmreorder_store {
+	uint64_t off;
+	uint64_t size;
+	uint64_t value_off;
+};
+
+struct pmreorder_replay;
+
+int pmreorder_trace_convert(const char *log_path, const char *trace_path);
+
+struct pmreorder_replay *pmreorder_replay_new(const char *path,
+	unsigned nthreads, const char *prog_cmd, const char *lib_path,
+	const char *lib_func);
+int pmreorder_replay_run(struct pmreorder_replay *r,
+	const struct pmreorder_store *stores, const void *values,
+	const uint32_t *seqs, const uint64_t *seq_ends, size_t nseqs,
+	int *results);
+void pmreorder_replay_delete(struct pmreorder_replay *r);
+
+#endif
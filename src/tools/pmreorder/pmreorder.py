@@ -1,7 +1,8 @@
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2018-2023, Intel Corporation
+# Copyright 2018-2026, Intel Corporation
 
 import argparse
+import binarytrace
 import statemachine
 import opscontext
 import consistencycheckwrap
@@ -36,7 +37,20 @@ def main():
         "-l",
         "--logfile",
         required=True,
-        help="the pmemcheck log file to process",
+        help="the pmemcheck log file or the binary trace to process",
+    )
+    parser.add_argument(
+        "-t",
+        "--trace",
+        help="convert the log file to the binary trace (or reuse it, "
+        + "if it is up to date) and process the trace",
+    )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        type=int,
+        help="replay the reordered stores in parallel, on copies of "
+        + "the checked file, using the given number of threads",
     )
     parser.add_argument(
         "-c",
@@ -88,6 +102,12 @@ def main():
         default=engines_keys[0],
     )
     args = parser.parse_args()
+    if args.jobs is not None:
+        if args.jobs < 1:
+            parser.error("the number of jobs has to be positive")
+        if binarytrace.native_library() is None:
+            parser.error("parallel replay requires "
+                         + binarytrace.LIBRARY_NAME)
     logger = loggingfacility.get_logger(args.output, args.output_level)
     checker = consistencycheckwrap.get_checker(
         args.checker, " ".join(args.path), args.name, logger
@@ -97,7 +117,8 @@ def main():
 
     # create the script context
     context = opscontext.OpsContext(
-        args.logfile, checker, logger, args.default_engine, markers
+        args.logfile, checker, logger, args.default_engine, markers,
+        args.trace, args.jobs
     )
     logger.debug("Input parameters: {}".format(context.__dict__))
 
@@ -0,0 +1,396 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * replay.c -- parallel replay of the reordered store sequences
+ *
+ * Every worker thread owns an image file next to the checked file. For each
+ * sequence the image is made a copy of the checked file - a reflink if the
+ * file system supports it, a plain copy otherwise - the stores of the
+ * sequence are written to it and the consistency checker is run on it.
+ * This way the sequences of a barrier are checked independently of each
+ * other and nothing has to be reverted.
+ *
+ * The checker function of the 'lib' checker is called in a child process
+ * forked for each check, so it does not have to be thread-safe and it
+ * cannot corrupt the state of pmreorder.
+ */
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/fs.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "os.h"
+#include "os_thread.h"
+#include "pmreorder.h"
+
+extern char **environ;
+
+typedef int (*checker_func)(const char *path);
+
+/*
+ * worker -- the image file of a single worker thread
+ */
+struct worker {
+	struct pmreorder_replay *r;
+	os_thread_t thread;
+	char *path;
+	char *cmd;	/* the checker command line for the 'prog' checker */
+	int fd;
+};
+
+struct pmreorder_replay {
+	int fd;		/* the checked file */
+	unsigned nthreads;
+	struct worker *workers;
+
+	void *lib;
+	checker_func lib_func;
+
+	int no_clone;	/* reflinks are not supported */
+
+	/* the batch of sequences being replayed */
+	const struct pmreorder_store *stores;
+	const char *values;
+	const uint32_t *seqs;
+	const uint64_t *seq_ends;
+	size_t nseqs;
+	int *results;
+	uint64_t size;
+	uint64_t next;
+	int error;
+};
+
+/*
+ * copy_range -- (internal) copy the file contents with read and write
+ */
+static int
+copy_range(int dst, int src, uint64_t off, uint64_t size)
+{
+	char buf[1 << 16];
+	while (off < size) {
+		ssize_t n = pread(src, buf, sizeof(buf), (off_t)off);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return -1;
+
+		for (ssize_t w = 0; w < n; ) {
+			ssize_t m = pwrite(dst, buf + w, (size_t)(n - w),
+				(off_t)off + w);
+			if (m < 0 && errno == EINTR)
+				continue;
+			if (m < 0)
+				return -1;
+			w += m;
+		}
+		off += (uint64_t)n;
+	}
+
+	return 0;
+}
+
+/*
+ * image_reset -- (internal) make the image of the worker a copy of
+ *	the checked file
+ */
+static int
+image_reset(struct worker *w)
+{
+	struct pmreorder_replay *r = w->r;
+
+	if (!__atomic_load_n(&r->no_clone, __ATOMIC_RELAXED)) {
+		if (ioctl(w->fd, FICLONE, r->fd) == 0)
+			return 0;
+		if (errno != EOPNOTSUPP && errno != EXDEV &&
+				errno != EINVAL && errno != ENOTTY)
+			return -1;
+		__atomic_store_n(&r->no_clone, 1, __ATOMIC_RELAXED);
+	}
+
+	loff_t off_in = 0;
+	loff_t off_out = 0;
+	while ((uint64_t)off_in < r->size) {
+		ssize_t n = copy_file_range(r->fd, &off_in, w->fd, &off_out,
+			(size_t)(r->size - (uint64_t)off_in), 0);
+		if (n > 0)
+			continue;
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && errno != ENOSYS && errno != EXDEV &&
+				errno != EINVAL && errno != EOPNOTSUPP)
+			return -1;
+
+		/* short file or no kernel support, finish with a plain copy */
+		if (copy_range(w->fd, r->fd, (uint64_t)off_in, r->size))
+			return -1;
+		break;
+	}
+
+	return os_ftruncate(w->fd, (os_off_t)r->size);
+}
+
+/*
+ * image_check -- (internal) run the consistency checker on the image,
+ *	returns 0 if it is consistent, 1 if not and -1 on error
+ */
+static int
+image_check(struct worker *w)
+{
+	struct pmreorder_replay *r = w->r;
+	pid_t pid;
+
+	if (r->lib_func != NULL) {
+		pid = fork();
+		if (pid < 0)
+			return -1;
+		if (pid == 0)
+			_exit(r->lib_func(w->path) != 0);
+	} else {
+		char *argv[] = {"sh", "-c", w->cmd, NULL};
+		int ret = posix_spawn(&pid, "/bin/sh", NULL, NULL, argv,
+			environ);
+		if (ret) {
+			errno = ret;
+			return -1;
+		}
+	}
+
+	int status;
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR)
+			return -1;
+	}
+
+	return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+}
+
+/*
+ * replay_seq -- (internal) replay the sequence on the image of the worker
+ */
+static int
+replay_seq(struct worker *w, size_t i)
+{
+	struct pmreorder_replay *r = w->r;
+
+	if (image_reset(w))
+		return -1;
+
+	for (uint64_t s = i ? r->seq_ends[i - 1] : 0; s < r->seq_ends[i]; ++s) {
+		const struct pmreorder_store *st = &r->stores[r->seqs[s]];
+		if (st->off + st->size > r->size) {
+			errno = EINVAL;
+			return -1;
+		}
+
+		ssize_t n = pwrite(w->fd, r->values + st->value_off, st->size,
+			(off_t)st->off);
+		if (n != (ssize_t)st->size) {
+			if (n >= 0)
+				errno = EIO;
+			return -1;
+		}
+	}
+
+	int ret = image_check(w);
+	if (ret < 0)
+		return -1;
+
+	r->results[i] = ret;
+	return 0;
+}
+
+/*
+ * worker_run -- (internal) replay the sequences until all are done
+ */
+static void *
+worker_run(void *arg)
+{
+	struct worker *w = arg;
+	struct pmreorder_replay *r = w->r;
+
+	while (!__atomic_load_n(&r->error, __ATOMIC_RELAXED)) {
+		uint64_t i = __atomic_fetch_add(&r->next, 1, __ATOMIC_RELAXED);
+		if (i >= r->nseqs)
+			break;
+
+		if (replay_seq(w, i)) {
+			int err = errno ? errno : EIO;
+			int expected = 0;
+			__atomic_compare_exchange_n(&r->error, &expected, err,
+				0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * pmreorder_replay_run -- replay the batch of sequences, the i-th sequence
+ *	consists of the stores seqs[seq_ends[i - 1]] .. seqs[seq_ends[i] - 1],
+ *	its result (0 if consistent, 1 otherwise) is saved in results[i]
+ */
+int
+pmreorder_replay_run(struct pmreorder_replay *r,
+	const struct pmreorder_store *stores, const void *values,
+	const uint32_t *seqs, const uint64_t *seq_ends, size_t nseqs,
+	int *results)
+{
+	os_stat_t st;
+	if (os_fstat(r->fd, &st))
+		return -1;
+
+	r->stores = stores;
+	r->values = values;
+	r->seqs = seqs;
+	r->seq_ends = seq_ends;
+	r->nseqs = nseqs;
+	r->results = results;
+	r->size = (uint64_t)st.st_size;
+	r->next = 0;
+	r->error = 0;
+
+	unsigned n = r->nthreads;
+	if (n > nseqs)
+		n = (unsigned)nseqs;
+
+	unsigned started;
+	for (started = 0; started < n; ++started) {
+		struct worker *w = &r->workers[started];
+		int ret = os_thread_create(&w->thread, NULL, worker_run, w);
+		if (ret) {
+			__atomic_store_n(&r->error, ret, __ATOMIC_RELAXED);
+			break;
+		}
+	}
+
+	for (unsigned i = 0; i < started; ++i)
+		os_thread_join(&r->workers[i].thread, NULL);
+
+	if (r->error) {
+		errno = r->error;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * pmreorder_replay_new -- prepare the replay of the stores to the file,
+ *	either the checker program command or the checker library and
+ *	the name of the function has to be given
+ */
+struct pmreorder_replay *
+pmreorder_replay_new(const char *path, unsigned nthreads,
+	const char *prog_cmd, const char *lib_path, const char *lib_func)
+{
+	if (nthreads == 0 || (prog_cmd == NULL && lib_path == NULL)) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	struct pmreorder_replay *r = calloc(1, sizeof(*r));
+	if (r == NULL)
+		return NULL;
+
+	r->fd = -1;
+	r->workers = calloc(nthreads, sizeof(*r->workers));
+	if (r->workers == NULL)
+		goto err;
+
+	for (unsigned i = 0; i < nthreads; ++i)
+		r->workers[i].fd = -1;
+
+	r->fd = os_open(path, O_RDONLY);
+	if (r->fd < 0)
+		goto err;
+
+	os_stat_t st;
+	if (os_fstat(r->fd, &st))
+		goto err;
+
+	if (lib_path != NULL) {
+		r->lib = dlopen(lib_path, RTLD_NOW);
+		if (r->lib == NULL) {
+			errno = ENOENT;
+			goto err;
+		}
+		r->lib_func = (checker_func)dlsym(r->lib, lib_func);
+		if (r->lib_func == NULL) {
+			errno = ENOENT;
+			goto err;
+		}
+	}
+
+	r->nthreads = nthreads;
+	for (unsigned i = 0; i < nthreads; ++i) {
+		struct worker *w = &r->workers[i];
+		w->r = r;
+
+		/* next to the checked file, so it can be reflinked */
+		size_t len = strlen(path) + sizeof(".pmreorder.") + 10;
+		w->path = malloc(len);
+		if (w->path == NULL)
+			goto err;
+		snprintf(w->path, len, "%s.pmreorder.%u", path, i);
+
+		if (prog_cmd != NULL) {
+			len = strlen(prog_cmd) + strlen(w->path) + 2;
+			w->cmd = malloc(len);
+			if (w->cmd == NULL)
+				goto err;
+			snprintf(w->cmd, len, "%s %s", prog_cmd, w->path);
+		}
+
+		w->fd = os_open(w->path, O_RDWR | O_CREAT | O_TRUNC,
+			st.st_mode & 0777);
+		if (w->fd < 0)
+			goto err;
+	}
+
+	return r;
+
+err:
+	pmreorder_replay_delete(r);
+	return NULL;
+}
+
+/*
+ * pmreorder_replay_delete -- remove the images and free the replay
+ */
+void
+pmreorder_replay_delete(struct pmreorder_replay *r)
+{
+	int oerrno = errno;
+
+	if (r->workers != NULL) {
+		for (unsigned i = 0; i < r->nthreads; ++i) {
+			struct worker *w = &r->workers[i];
+			if (w->fd >= 0) {
+				close(w->fd);
+				(void) os_unlink(w->path);
+			}
+			free(w->path);
+			free(w->cmd);
+		}
+		free(r->workers);
+	}
+
+	if (r->lib != NULL)
+		dlclose(r->lib);
+	if (r->fd >= 0)
+		close(r->fd);
+	free(r);
+
+	errno = oerrno;
+}
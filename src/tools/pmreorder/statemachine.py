@@ -1,5 +1,5 @@
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2018-2022, Intel Corporation
+# Copyright 2018-2026, Intel Corporation
 
 import memoryoperations as memops
 import reorderengines
@@ -311,40 +311,63 @@ class ReplayingState(State):
         if self._context.test_on_barrier:
             self._context.logger.debug("Current reorder engine: {}"
                                        .format(self._context.reorder_engine))
-            for i, seq in enumerate(
-                self._context.reorder_engine.generate_sequence(flushed_stores)
-            ):
-                self._context.logger.debug(
-                    "NEXT Sequence (no. {0}) with length: \
-                        {1}".format(i, len(seq))
-                )
-                for j, op in enumerate(seq):
-                    self._context.logger.debug(
-                        "NEXT Operation (no. {0}): {1}".format(j, op)
-                    )
-                    # do stores
-                    self._context.file_handler.do_store(op)
-                # check consistency of all files
-                try:
-                    self._context.file_handler.check_consistency()
-                except InconsistentFileException as e:
-                    consistency = False
-                    self._context.logger.warning(e)
-                    stacktrace = "Call trace:\n"
-                    for num, op in enumerate(seq):
-                        stacktrace += "Store [{}]:\n".format(num)
-                        stacktrace += str(op.trace)
-                    self._context.logger.warning(stacktrace)
-
-                for op in reversed(seq):
-                    # revert the changes
-                    self._context.file_handler.do_revert(op)
+            sequences = self._context.reorder_engine.generate_sequence(
+                flushed_stores)
+            results = self._context.file_handler.replay(flushed_stores,
+                                                         sequences)
+            if results is None:
+                results = self.replay_sequences(sequences)
+
+            for seq, error in results:
+                if error is None:
+                    continue
+                consistency = False
+                self._context.logger.warning(error)
+                stacktrace = "Call trace:\n"
+                for num, op in enumerate(seq):
+                    stacktrace += "Store [{}]:\n".format(num)
+                    stacktrace += str(op.trace)
+                self._context.logger.warning(stacktrace)
         # write all flushed stores
         for op in flushed_stores:
             self._context.file_handler.do_store(op)
 
         return consistency
 
+    def replay_sequences(self, sequences):
+        """
+        Replays the sequences of stores one by one on the registered
+        files and checks their consistency.
+
+        :param sequences: The sequences of stores to be checked.
+        :type sequences: iterable of tuples of :class:`memoryoperations.Store`
+        :return: Yields each sequence with the consistency error or None.
+        :rtype: iterable
+        """
+        for i, seq in enumerate(sequences):
+            self._context.logger.debug(
+                "NEXT Sequence (no. {0}) with length: \
+                    {1}".format(i, len(seq))
+            )
+            for j, op in enumerate(seq):
+                self._context.logger.debug(
+                    "NEXT Operation (no. {0}): {1}".format(j, op)
+                )
+                # do stores
+                self._context.file_handler.do_store(op)
+            # check consistency of all files
+            error = None
+            try:
+                self._context.file_handler.check_consistency()
+            except InconsistentFileException as e:
+                error = e
+
+            for op in reversed(seq):
+                # revert the changes
+                self._context.file_handler.do_revert(op)
+
+            yield seq, error
+
 
 class StateMachine:
     """
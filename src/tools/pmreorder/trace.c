@@ -0,0 +1,448 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2026, Intel Corporation */
+
+/*
+ * trace.c -- conversion of the pmemcheck store log to the binary trace
+ *
+ * The text log is parsed once and the result is saved in a format which
+ * python maps and reads without any string processing, so the trace can
+ * be replayed many times (e.g. with different engines) at a low cost.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "os.h"
+#include "pmreorder.h"
+
+#define OBUF_SIZE (1 << 16)
+
+/*
+ * obuf -- buffered sequential writer of the trace file
+ */
+struct obuf {
+	int fd;
+	size_t len;
+	uint64_t off;	/* offset of the end of the written data */
+	char buf[OBUF_SIZE];
+};
+
+/*
+ * write_all -- (internal) write the whole buffer at the given offset
+ */
+static int
+write_all(int fd, const void *buf, size_t len, uint64_t off)
+{
+	const char *p = buf;
+	while (len > 0) {
+		ssize_t n = pwrite(fd, p, len, (off_t)off);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		p += n;
+		len -= (size_t)n;
+		off += (uint64_t)n;
+	}
+
+	return 0;
+}
+
+/*
+ * obuf_flush -- (internal) write out the buffered data
+ */
+static int
+obuf_flush(struct obuf *ob)
+{
+	if (write_all(ob->fd, ob->buf, ob->len, ob->off - ob->len))
+		return -1;
+	ob->len = 0;
+	return 0;
+}
+
+/*
+ * obuf_append -- (internal) append the data to the trace file
+ */
+static int
+obuf_append(struct obuf *ob, const void *data, size_t len)
+{
+	const char *p = data;
+	while (len > 0) {
+		if (ob->len == OBUF_SIZE && obuf_flush(ob))
+			return -1;
+
+		size_t n = OBUF_SIZE - ob->len;
+		if (n > len)
+			n = len;
+		memcpy(ob->buf + ob->len, p, n);
+		ob->len += n;
+		ob->off += n;
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+/*
+ * field -- a fragment of the token
+ */
+struct field {
+	const char *s;
+	size_t len;
+};
+
+/*
+ * next_field -- (internal) split off the next ';' separated field,
+ *	returns 0 if there are no more fields
+ */
+static int
+next_field(struct field *rest, struct field *f)
+{
+	if (rest->s == NULL)
+		return 0;
+
+	const char *sep = memchr(rest->s, ';', rest->len);
+	f->s = rest->s;
+	if (sep == NULL) {
+		f->len = rest->len;
+		rest->s = NULL;
+		rest->len = 0;
+	} else {
+		f->len = (size_t)(sep - rest->s);
+		rest->len -= f->len + 1;
+		rest->s = sep + 1;
+	}
+
+	return 1;
+}
+
+/*
+ * hex_digit -- (internal) value of the hex digit or -1
+ */
+static int
+hex_digit(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+/*
+ * hex_trim -- (internal) strip the whitespace and the 0x prefix off
+ *	the number, the way python's int(s, 16) accepts it
+ */
+static int
+hex_trim(struct field *f)
+{
+	while (f->len > 0 && strchr(" \t\n\r\v\f", f->s[0]) != NULL) {
+		f->s++;
+		f->len--;
+	}
+	while (f->len > 0 && strchr(" \t\n\r\v\f", f->s[f->len - 1]) != NULL)
+		f->len--;
+
+	if (f->len > 2 && f->s[0] == '0' &&
+			(f->s[1] == 'x' || f->s[1] == 'X')) {
+		f->s += 2;
+		f->len -= 2;
+	}
+
+	if (f->len == 0)
+		return -1;
+
+	for (size_t i = 0; i < f->len; ++i) {
+		if (hex_digit(f->s[i]) < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * parse_u64 -- (internal) parse the hex number which fits in 64 bits
+ */
+static int
+parse_u64(struct field f, uint64_t *val)
+{
+	if (hex_trim(&f))
+		return -1;
+
+	uint64_t v = 0;
+	for (size_t i = 0; i < f.len; ++i) {
+		if (v >> 60)
+			return -1;
+		v = (v << 4) | (uint64_t)hex_digit(f.s[i]);
+	}
+
+	*val = v;
+	return 0;
+}
+
+/*
+ * parse_value -- (internal) convert the hex value of the store to
+ *	the little-endian bytes of the given size
+ */
+static int
+parse_value(struct field f, unsigned char *buf, uint64_t size)
+{
+	if (hex_trim(&f))
+		return -1;
+
+	memset(buf, 0, size);
+	for (size_t i = 0; i < f.len; ++i) {
+		unsigned d = (unsigned)hex_digit(f.s[f.len - 1 - i]);
+		if (d == 0)
+			continue;
+		/* the value does not fit in the store */
+		if (i / 2 >= size)
+			return -1;
+		buf[i / 2] |= (unsigned char)(i % 2 ? d << 4 : d);
+	}
+
+	return 0;
+}
+
+/*
+ * records -- growing array of the trace records
+ */
+struct records {
+	struct trace_record *rec;
+	uint64_t n;
+	uint64_t cap;
+};
+
+/*
+ * records_push -- (internal) append the record
+ */
+static int
+records_push(struct records *r, const struct trace_record *rec)
+{
+	if (r->n == r->cap) {
+		uint64_t cap = r->cap ? r->cap * 2 : 4096;
+		void *p = realloc(r->rec, cap * sizeof(*rec));
+		if (p == NULL)
+			return -1;
+		r->rec = p;
+		r->cap = cap;
+	}
+
+	r->rec[r->n++] = *rec;
+	return 0;
+}
+
+/*
+ * is_op -- (internal) check the name of the operation, the python
+ *	factory matches the names case-insensitively
+ */
+static int
+is_op(struct field id, const char *name)
+{
+	return id.len == strlen(name) && strncasecmp(id.s, name, id.len) == 0;
+}
+
+/*
+ * convert_store -- (internal) decode the STORE;addr;value;size[;trace]
+ *	token, returns 1 if it has to be kept as a string
+ */
+static int
+convert_store(struct obuf *ob, struct field rest, struct trace_record *rec)
+{
+	struct field addr, val, size;
+	if (!next_field(&rest, &addr) || !next_field(&rest, &val) ||
+			!next_field(&rest, &size))
+		return 1;
+
+	if (parse_u64(addr, &rec->addr) || parse_u64(size, &rec->size))
+		return 1;
+
+	/* the stack trace is stored as is, including the separators */
+	if (rest.s != NULL) {
+		if (rest.len > UINT32_MAX)
+			return 1;
+		rec->flags = TRACE_F_STACK;
+		rec->len = (uint32_t)rest.len;
+	}
+
+	unsigned char small[64];
+	unsigned char *value = small;
+	if (rec->size > sizeof(small)) {
+		value = malloc(rec->size);
+		if (value == NULL)
+			return -1;
+	}
+
+	int ret = 1;
+	if (parse_value(val, value, rec->size))
+		goto out;
+
+	rec->type = TRACE_STORE;
+	rec->data = ob->off;
+
+	ret = -1;
+	if (obuf_append(ob, value, rec->size) ||
+			obuf_append(ob, rest.s, rest.len))
+		goto out;
+
+	ret = 0;
+out:
+	if (value != small)
+		free(value);
+	return ret;
+}
+
+/*
+ * convert_token -- (internal) convert a single token of the log
+ */
+static int
+convert_token(struct obuf *ob, struct records *r, const char *s, size_t len)
+{
+	struct trace_record rec;
+	memset(&rec, 0, sizeof(rec));
+
+	struct field rest = {s, len};
+	struct field id = {NULL, 0};
+	next_field(&rest, &id);
+
+	int ret = 1;
+	if (is_op(id, "STORE")) {
+		ret = convert_store(ob, rest, &rec);
+	} else if (is_op(id, "FLUSH")) {
+		struct field addr, size;
+		if (next_field(&rest, &addr) && next_field(&rest, &size) &&
+				!parse_u64(addr, &rec.addr) &&
+				!parse_u64(size, &rec.size)) {
+			rec.type = TRACE_FLUSH;
+			ret = 0;
+		}
+	} else if (is_op(id, "FENCE")) {
+		rec.type = TRACE_FENCE;
+		ret = 0;
+	}
+
+	if (ret < 0)
+		return -1;
+
+	if (ret > 0) {
+		if (len > UINT32_MAX) {
+			errno = EFBIG;
+			return -1;
+		}
+
+		memset(&rec, 0, sizeof(rec));
+		rec.type = TRACE_STRING;
+		rec.len = (uint32_t)len;
+		rec.data = ob->off;
+		if (obuf_append(ob, s, len))
+			return -1;
+	}
+
+	return records_push(r, &rec);
+}
+
+/*
+ * pmreorder_trace_convert -- convert the pmemcheck store log to
+ *	the binary trace
+ */
+int
+pmreorder_trace_convert(const char *log_path, const char *trace_path)
+{
+	int ret = -1;
+	int oerrno;
+	const char *log = NULL;
+	size_t log_size = 0;
+	struct records r = {NULL, 0, 0};
+
+	struct obuf *ob = malloc(sizeof(*ob));
+	if (ob == NULL)
+		return -1;
+
+	int lfd = os_open(log_path, O_RDONLY);
+	if (lfd < 0)
+		goto err_free;
+
+	os_stat_t st;
+	if (os_fstat(lfd, &st))
+		goto err_close;
+
+	log_size = (size_t)st.st_size;
+	if (log_size > 0) {
+		log = mmap(NULL, log_size, PROT_READ, MAP_PRIVATE, lfd, 0);
+		if (log == MAP_FAILED)
+			goto err_close;
+		(void) madvise((void *)log, log_size, MADV_SEQUENTIAL);
+	}
+
+	ob->fd = os_open(trace_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (ob->fd < 0)
+		goto err_unmap;
+
+	ob->len = 0;
+	ob->off = sizeof(struct trace_hdr);
+
+	/* the same tokens as python's split("|") gives */
+	const char *s = log;
+	const char *end = log + log_size;
+	for (;;) {
+		const char *sep = s == end ? NULL :
+			memchr(s, '|', (size_t)(end - s));
+		const char *tend = sep ? sep : end;
+		if (convert_token(ob, &r, s, (size_t)(tend - s)))
+			goto err_trace;
+		if (sep == NULL)
+			break;
+		s = sep + 1;
+	}
+
+	struct trace_hdr hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.signature, TRACE_SIG, TRACE_SIG_LEN);
+	hdr.major = TRACE_MAJOR;
+	hdr.record_size = sizeof(struct trace_record);
+	hdr.nrecords = r.n;
+	hdr.data_off = sizeof(hdr);
+	hdr.data_size = ob->off - hdr.data_off;
+
+	static const char zeros[8];
+	if (obuf_append(ob, zeros, (8 - ob->off % 8) % 8))
+		goto err_trace;
+	hdr.records_off = ob->off;
+
+	if (obuf_append(ob, r.rec, r.n * sizeof(*r.rec)) || obuf_flush(ob))
+		goto err_trace;
+
+	if (write_all(ob->fd, &hdr, sizeof(hdr), 0))
+		goto err_trace;
+
+	ret = 0;
+
+err_trace:
+	oerrno = errno;
+	close(ob->fd);
+	if (ret)
+		(void) os_unlink(trace_path);
+	errno = oerrno;
+err_unmap:
+	oerrno = errno;
+	if (log_size > 0)
+		munmap((void *)log, log_size);
+	errno = oerrno;
+err_close:
+	oerrno = errno;
+	close(lfd);
+	errno = oerrno;
+err_free:
+	free(r.rec);
+	free(ob);
+	return ret;
+}
@@ -1,6 +1,6 @@
 #!/usr/bin/env bash
 # SPDX-License-Identifier: BSD-3-Clause
-# Copyright 2014-2024, Intel Corporation
+# Copyright 2014-2026, Intel Corporation
 
 #
 # build-dpkg.sh - Script for building deb packages
@@ -577,6 +577,7 @@ EOF
 cat << EOF > debian/pmreorder.install
 usr/bin/pmreorder
 usr/share/pmreorder/*.py
+usr/share/pmreorder/libpmreorder.so
 $MAN1_DIR/pmreorder.1
 EOF
 